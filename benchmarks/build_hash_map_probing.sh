@@ -0,0 +1,47 @@
+#!/bin/sh
+#
+# Generate the hash maps for benchmarks/hash_map_probing.c, build it with
+# optimizations, and run it.
+#
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+ROOT_DIR="$(cd "$SCRIPT_DIR/.." && pwd)"
+BIN_DIR="$SCRIPT_DIR/bin"
+MAP_DIR="$SCRIPT_DIR/hash_maps"
+CC="${CC:-cc}"
+CFLAGS="${CFLAGS:--O2 -march=native}"
+
+mkdir -p "$BIN_DIR" "$MAP_DIR"
+
+"$CC" -O2 -std=c11 -D_GNU_SOURCE -I"$ROOT_DIR/src" \
+    -o "$BIN_DIR/generate_hash_map" "$ROOT_DIR/tools/generate_hash_map/generate_hash_map.c"
+
+# generate_map NAME PREFIX [EXTRA FLAGS...]
+generate_map() {
+    name="$1"
+    prefix="$2"
+    shift 2
+
+    "$BIN_DIR/generate_hash_map" --name "$name" --function-prefix "$prefix" \
+        --key-type uint64_t --value-type uint64_t --fixed --header "$@" > "$MAP_DIR/$prefix.h"
+    "$BIN_DIR/generate_hash_map" --name "$name" --function-prefix "$prefix" \
+        --key-type uint64_t --value-type uint64_t --fixed --source --add-header "$prefix.h" "$@" > "$MAP_DIR/$prefix.c"
+}
+
+generate_map LinearMap linear_map
+generate_map RobinHoodMap robin_hood_map --robin-hood
+generate_map ControlMap control_map --control-bytes
+
+# shellcheck disable=SC2086
+"$CC" $CFLAGS -std=c11 -D_GNU_SOURCE -D_XOPEN_SOURCE=700 -I"$ROOT_DIR/src" -I"$SCRIPT_DIR" \
+    -o "$BIN_DIR/hash_map_probing" \
+    "$SCRIPT_DIR/hash_map_probing.c" \
+    "$MAP_DIR/linear_map.c" \
+    "$MAP_DIR/robin_hood_map.c" \
+    "$MAP_DIR/control_map.c" \
+    "$ROOT_DIR/src/jsl/everything.c" \
+    -lm
+
+"$BIN_DIR/hash_map_probing"
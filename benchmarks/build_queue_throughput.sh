@@ -0,0 +1,45 @@
+#!/bin/sh
+#
+# Generate the queues for benchmarks/queue_throughput.c, build it with
+# optimizations, and run it.
+#
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
+ROOT_DIR="$(cd "$SCRIPT_DIR/.." && pwd)"
+BIN_DIR="$SCRIPT_DIR/bin"
+QUEUE_DIR="$SCRIPT_DIR/queues"
+CC="${CC:-cc}"
+CFLAGS="${CFLAGS:--O2 -march=native}"
+
+mkdir -p "$BIN_DIR" "$QUEUE_DIR"
+
+"$CC" -O2 -std=c11 -D_GNU_SOURCE -I"$ROOT_DIR/src" \
+    -o "$BIN_DIR/generate_array" "$ROOT_DIR/tools/generate_array/generate_array.c"
+
+# generate_queue NAME PREFIX [EXTRA FLAGS...]
+generate_queue() {
+    name="$1"
+    prefix="$2"
+    shift 2
+
+    "$BIN_DIR/generate_array" --name "$name" --function-prefix "$prefix" \
+        --value-type uint64_t --fixed --header "$@" > "$QUEUE_DIR/$prefix.h"
+    "$BIN_DIR/generate_array" --name "$name" --function-prefix "$prefix" \
+        --value-type uint64_t --fixed --source --add-header "$prefix.h" "$@" > "$QUEUE_DIR/$prefix.c"
+}
+
+generate_queue SpscQueue spsc_queue --spsc
+generate_queue MpmcQueue mpmc_queue --mpmc
+
+# shellcheck disable=SC2086
+"$CC" $CFLAGS -std=c11 -D_GNU_SOURCE -D_XOPEN_SOURCE=700 -I"$ROOT_DIR/src" -I"$SCRIPT_DIR" \
+    -o "$BIN_DIR/queue_throughput" \
+    "$SCRIPT_DIR/queue_throughput.c" \
+    "$QUEUE_DIR/spsc_queue.c" \
+    "$QUEUE_DIR/mpmc_queue.c" \
+    "$ROOT_DIR/src/jsl/everything.c" \
+    -lm -lpthread
+
+"$BIN_DIR/queue_throughput"
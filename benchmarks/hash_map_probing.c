@@ -0,0 +1,196 @@
+/**
+ * # Hash Map Probing Benchmark
+ *
+ * Compares the plain linear probing of the generated fixed hash map against
+ * the `--robin-hood` and `--control-bytes` variants at several load factors.
+ * For each load factor every map is filled to the same number of items in a
+ * table of the same size, then timed on inserts, lookups of keys which are
+ * present, lookups of keys which are not, and deletes. The average and
+ * longest probe distance of the stored items is also printed, which is where
+ * Robin Hood ordering makes the biggest difference.
+ *
+ * Build and run it with `benchmarks/build_hash_map_probing.sh`.
+ *
+ * ## License
+ *
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "jsl/core.h"
+#include "jsl/allocator.h"
+#include "jsl/allocator_infinite_arena.h"
+
+#include "hash_maps/linear_map.h"
+#include "hash_maps/robin_hood_map.h"
+#include "hash_maps/control_map.h"
+
+#if JSL_IS_WINDOWS
+    #include <windows.h>
+#endif
+
+#define TABLE_SIZE ((int64_t) 1 << 20)
+
+static double now_seconds(void)
+{
+#if JSL_IS_WINDOWS
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double) counter.QuadPart / (double) frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+#endif
+}
+
+// splitmix64 is a bijection, so distinct inputs give distinct keys
+static uint64_t key_for(uint64_t i)
+{
+    uint64_t z = i + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+typedef struct Results {
+    double insert_ns;
+    double hit_ns;
+    double miss_ns;
+    double delete_ns;
+    double mean_distance;
+    int64_t max_distance;
+} Results;
+
+// All the generated maps have the same function signatures, so the benchmark
+// body is stamped out once per map. The probe distance of each key is found
+// from where its value ended up, the control byte map takes the ideal slot
+// from the hash bits above the seven used for the tag.
+#define DEFINE_RUN(run_name, MapType, prefix, slot_shift) \
+    static Results run_name(JSLAllocatorInterface allocator, int64_t item_count) \
+    { \
+        Results results = {0}; \
+        MapType map; \
+        /* 0.7 of the table size gives the same table for every load factor target */ \
+        prefix##_init(&map, allocator, (TABLE_SIZE * 7) / 10, 0); \
+        JSL_ASSERT(map.arrays_length == TABLE_SIZE); \
+        map.max_item_count = item_count; \
+        \
+        uint64_t checksum = 0; \
+        \
+        double start = now_seconds(); \
+        for (int64_t i = 0; i < item_count; ++i) \
+            prefix##_insert(&map, key_for((uint64_t) i), (uint64_t) i); \
+        results.insert_ns = (now_seconds() - start) * 1e9 / (double) item_count; \
+        \
+        start = now_seconds(); \
+        for (int64_t i = 0; i < item_count; ++i) \
+        { \
+            uint64_t* value = prefix##_get(&map, key_for((uint64_t) i)); \
+            checksum += value != NULL ? *value : 0; \
+        } \
+        results.hit_ns = (now_seconds() - start) * 1e9 / (double) item_count; \
+        \
+        uint64_t slot_mask = (uint64_t) map.arrays_length - 1u; \
+        int64_t total_distance = 0; \
+        for (int64_t i = 0; i < item_count; ++i) \
+        { \
+            uint64_t key = key_for((uint64_t) i); \
+            uint64_t slot = (uint64_t) (prefix##_get(&map, key) - map.values_array); \
+            uint64_t ideal_slot = (jsl__murmur3_fmix_u64(key, 0) >> slot_shift) & slot_mask; \
+            int64_t distance = (int64_t) ((slot - ideal_slot) & slot_mask); \
+            total_distance += distance; \
+            results.max_distance = JSL_MAX(results.max_distance, distance); \
+        } \
+        results.mean_distance = (double) total_distance / (double) item_count; \
+        \
+        start = now_seconds(); \
+        for (int64_t i = 0; i < item_count; ++i) \
+        { \
+            uint64_t* value = prefix##_get(&map, key_for((uint64_t) i + ((uint64_t) 1 << 40))); \
+            checksum += value != NULL ? *value : 1; \
+        } \
+        results.miss_ns = (now_seconds() - start) * 1e9 / (double) item_count; \
+        \
+        start = now_seconds(); \
+        for (int64_t i = 0; i < item_count; ++i) \
+            prefix##_delete(&map, key_for((uint64_t) i)); \
+        results.delete_ns = (now_seconds() - start) * 1e9 / (double) item_count; \
+        \
+        JSL_ASSERT(map.item_count == 0); \
+        JSL_ASSERT(checksum == (uint64_t) item_count * (uint64_t) (item_count + 1) / 2); \
+        return results; \
+    }
+
+DEFINE_RUN(run_linear, LinearMap, linear_map, 0)
+DEFINE_RUN(run_robin_hood, RobinHoodMap, robin_hood_map, 0)
+DEFINE_RUN(run_control, ControlMap, control_map, 7)
+
+static void print_row(const char* name, double load_factor, Results results)
+{
+    printf(
+        "%-12s %5.2f %10.1f %10.1f %10.1f %10.1f %10.2f %8lld\n",
+        name,
+        load_factor,
+        results.insert_ns,
+        results.hit_ns,
+        results.miss_ns,
+        results.delete_ns,
+        results.mean_distance,
+        (long long) results.max_distance
+    );
+}
+
+int main(void)
+{
+    JSLInfiniteArena arena;
+    jsl_infinite_arena_init(&arena);
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &arena);
+
+    double load_factors[] = { 0.5, 0.75, 0.85, 0.9, 0.95 };
+
+    printf("table size %lld slots, times in ns per operation\n\n", (long long) TABLE_SIZE);
+    printf(
+        "%-12s %5s %10s %10s %10s %10s %10s %8s\n",
+        "probing", "load", "insert", "hit", "miss", "delete", "mean dist", "max dist"
+    );
+
+    for (size_t i = 0; i < sizeof(load_factors) / sizeof(load_factors[0]); ++i)
+    {
+        int64_t item_count = (int64_t) (load_factors[i] * (double) TABLE_SIZE);
+
+        print_row("linear", load_factors[i], run_linear(allocator, item_count));
+        jsl_allocator_interface_free_all(allocator);
+
+        print_row("robin hood", load_factors[i], run_robin_hood(allocator, item_count));
+        jsl_allocator_interface_free_all(allocator);
+
+        print_row("control", load_factors[i], run_control(allocator, item_count));
+        jsl_allocator_interface_free_all(allocator);
+    }
+
+    return EXIT_SUCCESS;
+}
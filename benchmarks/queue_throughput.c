@@ -0,0 +1,322 @@
+/**
+ * # Queue Throughput Benchmark
+ *
+ * Measures how many values per second the generated `--spsc` and `--mpmc`
+ * queues pass between threads. The SPSC queue runs with one producer and one
+ * consumer, the MPMC queue with an equal number of producers and consumers
+ * from 2 up to 32 threads in total. Every configuration runs once moving
+ * single values with `try_push` and `try_pop`, and once moving batches with
+ * `push_many` and `pop_many`, so the cost of the shared counters per value
+ * can be compared directly.
+ *
+ * Threads yield when the queue is full or empty, so running more threads
+ * than there are cores measures scheduling as much as the queue.
+ *
+ * Build and run it with `benchmarks/build_queue_throughput.sh`.
+ *
+ * ## License
+ *
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "jsl/core.h"
+#include "jsl/allocator.h"
+#include "jsl/allocator_infinite_arena.h"
+#include "jsl/atomic_common.h"
+
+#include "queues/spsc_queue.h"
+#include "queues/mpmc_queue.h"
+
+#if JSL_IS_WINDOWS
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+#define VALUE_COUNT ((int64_t) 1 << 22)
+#define QUEUE_CAPACITY 1024
+#define BATCH_LENGTH 16
+#define MAX_THREADS 32
+
+static double now_seconds(void)
+{
+#if JSL_IS_WINDOWS
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double) counter.QuadPart / (double) frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+#endif
+}
+
+static void yield_thread(void)
+{
+#if JSL_IS_WINDOWS
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+typedef struct Worker {
+    SpscQueue* spsc;
+    MpmcQueue* mpmc;
+    /// @brief set to non zero once every thread is created
+    uint64_t* start;
+    /// @brief values popped by all consumers so far
+    uint64_t* consumed_total;
+    int64_t first_value;
+    int64_t value_count;
+    int64_t batch_length;
+    uint64_t checksum;
+} Worker;
+
+static void wait_for_start(Worker* worker)
+{
+    while (jsl__atomic_load_u64(worker->start) == 0)
+        yield_thread();
+}
+
+// The SPSC and MPMC queues have the same function signatures, so the
+// producer and consumer loops are stamped out once per queue
+#define DEFINE_WORKERS(QueueType, prefix, member) \
+    static void prefix##_produce(Worker* worker) \
+    { \
+        uint64_t batch[BATCH_LENGTH]; \
+        int64_t next = worker->first_value; \
+        int64_t end = worker->first_value + worker->value_count; \
+        wait_for_start(worker); \
+        while (next < end) \
+        { \
+            int64_t pushed = 0; \
+            if (worker->batch_length == 1) \
+            { \
+                pushed = prefix##_try_push(worker->member, (uint64_t) next) ? 1 : 0; \
+            } \
+            else \
+            { \
+                int64_t length = JSL_MIN(worker->batch_length, end - next); \
+                for (int64_t i = 0; i < length; ++i) \
+                    batch[i] = (uint64_t) (next + i); \
+                pushed = prefix##_push_many(worker->member, batch, length); \
+            } \
+            next += pushed; \
+            if (pushed == 0) \
+                yield_thread(); \
+        } \
+    } \
+    \
+    static void prefix##_consume(Worker* worker) \
+    { \
+        uint64_t batch[BATCH_LENGTH]; \
+        wait_for_start(worker); \
+        while (jsl__atomic_load_u64(worker->consumed_total) < (uint64_t) VALUE_COUNT) \
+        { \
+            int64_t popped = 0; \
+            if (worker->batch_length == 1) \
+                popped = prefix##_try_pop(worker->member, batch) ? 1 : 0; \
+            else \
+                popped = prefix##_pop_many(worker->member, batch, worker->batch_length); \
+            for (int64_t i = 0; i < popped; ++i) \
+                worker->checksum += batch[i]; \
+            if (popped > 0) \
+                jsl__atomic_fetch_add_u64(worker->consumed_total, (uint64_t) popped); \
+            else \
+                yield_thread(); \
+        } \
+    }
+
+DEFINE_WORKERS(SpscQueue, spsc_queue, spsc)
+DEFINE_WORKERS(MpmcQueue, mpmc_queue, mpmc)
+
+typedef enum WorkerRole {
+    ROLE_SPSC_PRODUCER,
+    ROLE_SPSC_CONSUMER,
+    ROLE_MPMC_PRODUCER,
+    ROLE_MPMC_CONSUMER
+} WorkerRole;
+
+typedef struct Thread {
+    Worker* worker;
+    WorkerRole role;
+} Thread;
+
+static void run_worker(Thread* thread)
+{
+    switch (thread->role)
+    {
+        case ROLE_SPSC_PRODUCER: spsc_queue_produce(thread->worker); break;
+        case ROLE_SPSC_CONSUMER: spsc_queue_consume(thread->worker); break;
+        case ROLE_MPMC_PRODUCER: mpmc_queue_produce(thread->worker); break;
+        case ROLE_MPMC_CONSUMER: mpmc_queue_consume(thread->worker); break;
+    }
+}
+
+#if JSL_IS_WINDOWS
+    static DWORD WINAPI worker_entry(LPVOID arg)
+    {
+        run_worker((Thread*) arg);
+        return 0;
+    }
+#else
+    static void* worker_entry(void* arg)
+    {
+        run_worker((Thread*) arg);
+        return NULL;
+    }
+#endif
+
+/**
+ * Move VALUE_COUNT values through the queue with `pair_count` producers and
+ * `pair_count` consumers.
+ *
+ * @returns Millions of values per second
+ */
+static double run(
+    JSLAllocatorInterface allocator,
+    bool use_mpmc,
+    int32_t pair_count,
+    int64_t batch_length
+)
+{
+    SpscQueue spsc;
+    MpmcQueue mpmc;
+    if (use_mpmc)
+        mpmc_queue_init(&mpmc, allocator, QUEUE_CAPACITY);
+    else
+        spsc_queue_init(&spsc, allocator, QUEUE_CAPACITY);
+
+    uint64_t start = 0;
+    uint64_t consumed_total = 0;
+    Worker workers[MAX_THREADS];
+    Thread threads[MAX_THREADS];
+    int32_t thread_count = pair_count * 2;
+
+    #if JSL_IS_WINDOWS
+        HANDLE handles[MAX_THREADS];
+    #else
+        pthread_t handles[MAX_THREADS];
+    #endif
+
+    int64_t per_producer = VALUE_COUNT / pair_count;
+    for (int32_t i = 0; i < thread_count; ++i)
+    {
+        bool is_producer = i < pair_count;
+        workers[i] = (Worker) {
+            .spsc = &spsc,
+            .mpmc = &mpmc,
+            .start = &start,
+            .consumed_total = &consumed_total,
+            .first_value = is_producer ? per_producer * i : 0,
+            .value_count = is_producer ? per_producer : 0,
+            .batch_length = batch_length
+        };
+        // the last producer picks up the remainder
+        if (i == pair_count - 1)
+            workers[i].value_count = VALUE_COUNT - per_producer * i;
+
+        threads[i] = (Thread) {
+            .worker = &workers[i],
+            .role = use_mpmc
+                ? (is_producer ? ROLE_MPMC_PRODUCER : ROLE_MPMC_CONSUMER)
+                : (is_producer ? ROLE_SPSC_PRODUCER : ROLE_SPSC_CONSUMER)
+        };
+
+        #if JSL_IS_WINDOWS
+            handles[i] = CreateThread(NULL, 0, worker_entry, &threads[i], 0, NULL);
+        #else
+            pthread_create(&handles[i], NULL, worker_entry, &threads[i]);
+        #endif
+    }
+
+    double start_time = now_seconds();
+    jsl__atomic_store_u64(&start, 1);
+
+    uint64_t checksum = 0;
+    for (int32_t i = 0; i < thread_count; ++i)
+    {
+        #if JSL_IS_WINDOWS
+            WaitForSingleObject(handles[i], INFINITE);
+            CloseHandle(handles[i]);
+        #else
+            pthread_join(handles[i], NULL);
+        #endif
+        checksum += workers[i].checksum;
+    }
+
+    double seconds = now_seconds() - start_time;
+
+    JSL_ASSERT(checksum == (uint64_t) VALUE_COUNT * (uint64_t) (VALUE_COUNT - 1) / 2);
+
+    if (use_mpmc)
+        mpmc_queue_free(&mpmc);
+    else
+        spsc_queue_free(&spsc);
+
+    return (double) VALUE_COUNT / seconds / 1e6;
+}
+
+int main(void)
+{
+    JSLInfiniteArena arena;
+    jsl_infinite_arena_init(&arena);
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &arena);
+
+    printf(
+        "%lld values of uint64_t, queue capacity %d, throughput in millions of values per second\n\n",
+        (long long) VALUE_COUNT,
+        QUEUE_CAPACITY
+    );
+    printf("%-6s %8s %12s %12s\n", "queue", "threads", "single", "batch of 16");
+
+    printf(
+        "%-6s %8d %12.1f %12.1f\n",
+        "spsc",
+        2,
+        run(allocator, false, 1, 1),
+        run(allocator, false, 1, BATCH_LENGTH)
+    );
+    jsl_allocator_interface_free_all(allocator);
+
+    for (int32_t thread_count = 2; thread_count <= MAX_THREADS; thread_count *= 2)
+    {
+        printf(
+            "%-6s %8d %12.1f %12.1f\n",
+            "mpmc",
+            thread_count,
+            run(allocator, true, thread_count / 2, 1),
+            run(allocator, true, thread_count / 2, BATCH_LENGTH)
+        );
+        jsl_allocator_interface_free_all(allocator);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -48,6 +48,62 @@
     --ignore "jsl__*" \
     src/jsl/cmd_line.h > docs/jsl_cmd_line.md &
 
+~/Documents/code/c_doc_gen/doc_gen \
+    --ignore "ASAN*" \
+    --ignore "bool" \
+    --ignore "int64_t" \
+    --ignore "JSL__*" \
+    --ignore "jsl__*" \
+    src/jsl/frozen_str_map.h > docs/jsl_frozen_str_map.md &
+
+~/Documents/code/c_doc_gen/doc_gen \
+    --ignore "ASAN*" \
+    --ignore "bool" \
+    --ignore "int64_t" \
+    --ignore "JSL__*" \
+    --ignore "jsl__*" \
+    src/jsl/frozen_str_map_file.h > docs/jsl_frozen_str_map_file.md &
+
+~/Documents/code/c_doc_gen/doc_gen \
+    --ignore "ASAN*" \
+    --ignore "bool" \
+    --ignore "int64_t" \
+    --ignore "JSL__*" \
+    --ignore "jsl__*" \
+    src/jsl/concurrent_str_map.h > docs/jsl_concurrent_str_map.md &
+
+~/Documents/code/c_doc_gen/doc_gen \
+    --ignore "ASAN*" \
+    --ignore "bool" \
+    --ignore "int64_t" \
+    --ignore "JSL__*" \
+    --ignore "jsl__*" \
+    src/jsl/str_sort.h > docs/jsl_str_sort.md &
+
+~/Documents/code/c_doc_gen/doc_gen \
+    --ignore "ASAN*" \
+    --ignore "bool" \
+    --ignore "int64_t" \
+    --ignore "JSL__*" \
+    --ignore "jsl__*" \
+    src/jsl/rope.h > docs/jsl_rope.md &
+
+~/Documents/code/c_doc_gen/doc_gen \
+    --ignore "ASAN*" \
+    --ignore "bool" \
+    --ignore "int64_t" \
+    --ignore "JSL__*" \
+    --ignore "jsl__*" \
+    src/jsl/thread_pool.h > docs/jsl_thread_pool.md &
+
+~/Documents/code/c_doc_gen/doc_gen \
+    --ignore "ASAN*" \
+    --ignore "bool" \
+    --ignore "int64_t" \
+    --ignore "JSL__*" \
+    --ignore "jsl__*" \
+    src/jsl/hash.h > docs/jsl_hash.md &
+
 ~/Documents/code/c_doc_gen/doc_gen \
     --ignore "ASAN*" \
     --ignore "bool" \
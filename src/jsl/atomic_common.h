@@ -0,0 +1,188 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "core.h"
+
+/*
+ * Minimal set of atomic operations shared by the concurrent containers.
+ *
+ * These wrap the compiler intrinsics directly rather than `<stdatomic.h>`
+ * because MSVC only ships C11 atomics behind an experimental flag, and
+ * because the containers keep plain `uint64_t` and pointer members in
+ * structs that are also touched by non-atomic code during init and free.
+ *
+ * Loads are acquire, stores are release, and every read-modify-write is
+ * sequentially consistent.
+ */
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+    #if defined(_M_X64) || defined(_M_IX86)
+        #include <emmintrin.h>
+    #endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+
+    static inline uint64_t jsl__atomic_load_u64(const volatile uint64_t* ptr)
+    {
+        return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+    }
+
+    static inline void jsl__atomic_store_u64(volatile uint64_t* ptr, uint64_t value)
+    {
+        __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+    }
+
+    static inline uint64_t jsl__atomic_fetch_add_u64(volatile uint64_t* ptr, uint64_t value)
+    {
+        return __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST);
+    }
+
+    static inline uint64_t jsl__atomic_exchange_u64(volatile uint64_t* ptr, uint64_t value)
+    {
+        return __atomic_exchange_n(ptr, value, __ATOMIC_SEQ_CST);
+    }
+
+    static inline bool jsl__atomic_compare_exchange_u64(
+        volatile uint64_t* ptr,
+        uint64_t expected,
+        uint64_t desired
+    )
+    {
+        return __atomic_compare_exchange_n(
+            ptr, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST
+        );
+    }
+
+    static inline void* jsl__atomic_load_ptr(void* const volatile* ptr)
+    {
+        return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+    }
+
+    static inline void jsl__atomic_store_ptr(void* volatile* ptr, void* value)
+    {
+        __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+    }
+
+    static inline void* jsl__atomic_exchange_ptr(void* volatile* ptr, void* value)
+    {
+        return __atomic_exchange_n(ptr, value, __ATOMIC_SEQ_CST);
+    }
+
+    static inline void jsl__atomic_thread_fence(void)
+    {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+
+    static inline void jsl__cpu_relax(void)
+    {
+        #if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+        #elif defined(__aarch64__)
+            __asm__ __volatile__("yield");
+        #endif
+    }
+
+#elif defined(_MSC_VER)
+
+    // On x86 and x64 MSVC, plain volatile accesses already have acquire and
+    // release semantics, a compiler barrier only stops reordering. ARM64
+    // needs the real thing.
+    static inline uint64_t jsl__atomic_load_u64(const volatile uint64_t* ptr)
+    {
+        #if defined(_M_X64)
+            uint64_t value = *ptr;
+            _ReadWriteBarrier();
+            return value;
+        #else
+            return (uint64_t) _InterlockedOr64((volatile __int64*) ptr, 0);
+        #endif
+    }
+
+    static inline void jsl__atomic_store_u64(volatile uint64_t* ptr, uint64_t value)
+    {
+        #if defined(_M_X64)
+            _ReadWriteBarrier();
+            *ptr = value;
+        #else
+            _InterlockedExchange64((volatile __int64*) ptr, (__int64) value);
+        #endif
+    }
+
+    static inline uint64_t jsl__atomic_fetch_add_u64(volatile uint64_t* ptr, uint64_t value)
+    {
+        return (uint64_t) _InterlockedExchangeAdd64((volatile __int64*) ptr, (__int64) value);
+    }
+
+    static inline uint64_t jsl__atomic_exchange_u64(volatile uint64_t* ptr, uint64_t value)
+    {
+        return (uint64_t) _InterlockedExchange64((volatile __int64*) ptr, (__int64) value);
+    }
+
+    static inline bool jsl__atomic_compare_exchange_u64(
+        volatile uint64_t* ptr,
+        uint64_t expected,
+        uint64_t desired
+    )
+    {
+        __int64 previous = _InterlockedCompareExchange64(
+            (volatile __int64*) ptr, (__int64) desired, (__int64) expected
+        );
+        return (uint64_t) previous == expected;
+    }
+
+    static inline void* jsl__atomic_load_ptr(void* const volatile* ptr)
+    {
+        #if defined(_M_X64) || defined(_M_IX86)
+            void* value = *ptr;
+            _ReadWriteBarrier();
+            return value;
+        #else
+            return _InterlockedCompareExchangePointer((void* volatile*) ptr, NULL, NULL);
+        #endif
+    }
+
+    static inline void jsl__atomic_store_ptr(void* volatile* ptr, void* value)
+    {
+        #if defined(_M_X64) || defined(_M_IX86)
+            _ReadWriteBarrier();
+            *ptr = value;
+        #else
+            _InterlockedExchangePointer(ptr, value);
+        #endif
+    }
+
+    static inline void* jsl__atomic_exchange_ptr(void* volatile* ptr, void* value)
+    {
+        return _InterlockedExchangePointer(ptr, value);
+    }
+
+    static inline void jsl__atomic_thread_fence(void)
+    {
+        #if defined(_M_X64) || defined(_M_IX86)
+            _mm_mfence();
+        #else
+            __dmb(_ARM64_BARRIER_ISH);
+        #endif
+    }
+
+    static inline void jsl__cpu_relax(void)
+    {
+        #if defined(_M_X64) || defined(_M_IX86)
+            _mm_pause();
+        #else
+            __yield();
+        #endif
+    }
+
+#else
+    #error "atomic_common.h: unsupported compiler, only GCC, clang, and MSVC are supported"
+#endif
+
+/*
+ * Padding unit used to keep data written by different threads out of
+ * the same cache line.
+ */
+#define JSL__CACHE_LINE_SIZE 64
@@ -0,0 +1,396 @@
+/**
+ * # JSL Concurrent String Map
+ *
+ * This file implements a string to string map for read mostly workloads
+ * that are shared between many reader threads and a single writer thread.
+ * This file is part of the Jack's Standard Library project.
+ *
+ * ## Documentation
+ *
+ * See `docs/jsl_concurrent_str_map.md` for a formatted documentation page.
+ *
+ * ## License
+ *
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L
+    #include <stdbool.h>
+#endif
+
+#include "core.h"
+#include "atomic_common.h"
+#include "allocator.h"
+#include "str_to_str_map.h"
+#include "frozen_str_map.h"
+#include "concurrent_str_map.h"
+
+#define JSL__CONCURRENT_MAP_PRIVATE_SENTINEL 6120468930514782917U
+#define JSL__CONCURRENT_MAP_READER_PRIVATE_SENTINEL 15335914426318402079U
+
+static struct JSL__ConcurrentStrMapVersion* jsl__concurrent_str_map_make_version(
+    JSLConcurrentStrMap* map
+)
+{
+    struct JSL__ConcurrentStrMapVersion* version = jsl_allocator_interface_alloc(
+        map->allocator,
+        sizeof(struct JSL__ConcurrentStrMapVersion),
+        JSL_DEFAULT_ALLOCATION_ALIGNMENT,
+        true
+    );
+
+    bool frozen = version != NULL
+        && jsl_str_to_str_map_freeze(&map->staging, map->allocator, &version->frozen);
+
+    if (version != NULL && !frozen)
+    {
+        jsl_allocator_interface_free(map->allocator, version);
+        version = NULL;
+    }
+
+    return version;
+}
+
+static void jsl__concurrent_str_map_free_version(
+    JSLConcurrentStrMap* map,
+    struct JSL__ConcurrentStrMapVersion* version
+)
+{
+    jsl_frozen_str_map_free(&version->frozen);
+    jsl_allocator_interface_free(map->allocator, version);
+}
+
+/**
+ * Find the oldest epoch any reader could still be using. Returns
+ * UINT64_MAX when no reader is inside a read section.
+ */
+static uint64_t jsl__concurrent_str_map_min_active_epoch(JSLConcurrentStrMap* map)
+{
+    // Pairs with the fence in read_begin. Either the reader's epoch store is
+    // visible here, or the reader is guaranteed to load the new version.
+    jsl__atomic_thread_fence();
+
+    uint64_t min_epoch = UINT64_MAX;
+
+    for (int64_t i = 0; i < map->max_readers; ++i)
+    {
+        uint64_t epoch = jsl__atomic_load_u64(&map->reader_slots[i].epoch);
+        if (epoch != 0 && epoch < min_epoch)
+            min_epoch = epoch;
+    }
+
+    return min_epoch;
+}
+
+static void jsl__concurrent_str_map_reclaim(JSLConcurrentStrMap* map)
+{
+    uint64_t min_epoch = jsl__concurrent_str_map_min_active_epoch(map);
+
+    // A version retired in epoch E was replaced before the global epoch
+    // became E, so any reader which started in E or later can only see
+    // newer versions.
+    struct JSL__ConcurrentStrMapVersion** link = &map->retired;
+    while (*link != NULL)
+    {
+        struct JSL__ConcurrentStrMapVersion* version = *link;
+
+        if (version->retire_epoch <= min_epoch)
+        {
+            *link = version->next_retired;
+            jsl__concurrent_str_map_free_version(map, version);
+            --map->retired_count;
+        }
+        else
+        {
+            link = &version->next_retired;
+        }
+    }
+}
+
+JSL_CONCURRENT_STR_MAP_DEF bool jsl_concurrent_str_map_init(
+    JSLConcurrentStrMap* map,
+    JSLAllocatorInterface allocator,
+    uint64_t seed,
+    int64_t max_readers
+)
+{
+    bool res = true;
+
+    bool params_valid = map != NULL && max_readers > 0;
+
+    if (params_valid)
+    {
+        JSL_MEMSET(map, 0, sizeof(JSLConcurrentStrMap));
+        map->allocator = allocator;
+        map->max_readers = max_readers;
+        map->global_epoch = 1;
+    }
+    else
+    {
+        res = false;
+    }
+
+    bool staging_ready = res && jsl_str_to_str_map_init(&map->staging, allocator, seed);
+    if (!staging_ready)
+    {
+        res = false;
+    }
+
+    if (res)
+    {
+        map->reader_slots = jsl_allocator_interface_alloc(
+            allocator,
+            (int64_t) sizeof(struct JSL__ConcurrentStrMapReaderSlot) * max_readers,
+            JSL__CACHE_LINE_SIZE,
+            true
+        );
+        res = map->reader_slots != NULL;
+    }
+
+    if (res)
+    {
+        map->current = jsl__concurrent_str_map_make_version(map);
+        res = map->current != NULL;
+    }
+
+    if (res)
+    {
+        map->sentinel = JSL__CONCURRENT_MAP_PRIVATE_SENTINEL;
+    }
+    else if (staging_ready)
+    {
+        jsl_allocator_interface_free(allocator, map->reader_slots);
+        jsl_str_to_str_map_free(&map->staging);
+    }
+
+    return res;
+}
+
+JSL_CONCURRENT_STR_MAP_DEF bool jsl_concurrent_str_map_insert(
+    JSLConcurrentStrMap* map,
+    JSLImmutableMemory key,
+    JSLStringLifeTime key_lifetime,
+    JSLImmutableMemory value,
+    JSLStringLifeTime value_lifetime
+)
+{
+    bool res = false;
+
+    if (map != NULL && map->sentinel == JSL__CONCURRENT_MAP_PRIVATE_SENTINEL)
+    {
+        res = jsl_str_to_str_map_insert(&map->staging, key, key_lifetime, value, value_lifetime);
+    }
+
+    return res;
+}
+
+JSL_CONCURRENT_STR_MAP_DEF bool jsl_concurrent_str_map_delete(
+    JSLConcurrentStrMap* map,
+    JSLImmutableMemory key
+)
+{
+    bool res = false;
+
+    if (map != NULL && map->sentinel == JSL__CONCURRENT_MAP_PRIVATE_SENTINEL)
+    {
+        res = jsl_str_to_str_map_delete(&map->staging, key);
+    }
+
+    return res;
+}
+
+JSL_CONCURRENT_STR_MAP_DEF void jsl_concurrent_str_map_clear(
+    JSLConcurrentStrMap* map
+)
+{
+    if (map != NULL && map->sentinel == JSL__CONCURRENT_MAP_PRIVATE_SENTINEL)
+    {
+        jsl_str_to_str_map_clear(&map->staging);
+    }
+}
+
+JSL_CONCURRENT_STR_MAP_DEF bool jsl_concurrent_str_map_publish(
+    JSLConcurrentStrMap* map
+)
+{
+    bool res = false;
+
+    struct JSL__ConcurrentStrMapVersion* version = NULL;
+    if (map != NULL && map->sentinel == JSL__CONCURRENT_MAP_PRIVATE_SENTINEL)
+    {
+        version = jsl__concurrent_str_map_make_version(map);
+    }
+
+    if (version != NULL)
+    {
+        struct JSL__ConcurrentStrMapVersion* previous = jsl__atomic_exchange_ptr(
+            (void* volatile*) &map->current,
+            version
+        );
+
+        // Advancing the epoch after the swap means every read section
+        // which begins in the new epoch loads the new version
+        previous->retire_epoch = jsl__atomic_fetch_add_u64(&map->global_epoch, 1) + 1;
+        previous->next_retired = map->retired;
+        map->retired = previous;
+        ++map->retired_count;
+
+        jsl__concurrent_str_map_reclaim(map);
+        res = true;
+    }
+
+    return res;
+}
+
+JSL_CONCURRENT_STR_MAP_DEF int64_t jsl_concurrent_str_map_reclaim(
+    JSLConcurrentStrMap* map
+)
+{
+    int64_t res = -1;
+
+    if (map != NULL && map->sentinel == JSL__CONCURRENT_MAP_PRIVATE_SENTINEL)
+    {
+        jsl__concurrent_str_map_reclaim(map);
+        res = map->retired_count;
+    }
+
+    return res;
+}
+
+JSL_CONCURRENT_STR_MAP_DEF bool jsl_concurrent_str_map_reader_register(
+    JSLConcurrentStrMap* map,
+    JSLConcurrentStrMapReader* out_reader
+)
+{
+    bool res = false;
+
+    bool params_valid = (
+        map != NULL
+        && out_reader != NULL
+        && map->sentinel == JSL__CONCURRENT_MAP_PRIVATE_SENTINEL
+    );
+
+    for (int64_t i = 0; params_valid && !res && i < map->max_readers; ++i)
+    {
+        struct JSL__ConcurrentStrMapReaderSlot* slot = &map->reader_slots[i];
+
+        if (jsl__atomic_load_u64(&slot->in_use) == 0
+            && jsl__atomic_compare_exchange_u64(&slot->in_use, 0, 1))
+        {
+            out_reader->map = map;
+            out_reader->slot = slot;
+            out_reader->sentinel = JSL__CONCURRENT_MAP_READER_PRIVATE_SENTINEL;
+            res = true;
+        }
+    }
+
+    return res;
+}
+
+JSL_CONCURRENT_STR_MAP_DEF void jsl_concurrent_str_map_reader_unregister(
+    JSLConcurrentStrMapReader* reader
+)
+{
+    if (reader != NULL && reader->sentinel == JSL__CONCURRENT_MAP_READER_PRIVATE_SENTINEL)
+    {
+        jsl__atomic_store_u64(&reader->slot->epoch, 0);
+        jsl__atomic_store_u64(&reader->slot->in_use, 0);
+        JSL_MEMSET(reader, 0, sizeof(JSLConcurrentStrMapReader));
+    }
+}
+
+JSL_CONCURRENT_STR_MAP_DEF const JSLFrozenStrMap* jsl_concurrent_str_map_read_begin(
+    JSLConcurrentStrMapReader* reader
+)
+{
+    const JSLFrozenStrMap* res = NULL;
+
+    if (reader != NULL && reader->sentinel == JSL__CONCURRENT_MAP_READER_PRIVATE_SENTINEL)
+    {
+        JSLConcurrentStrMap* map = reader->map;
+
+        uint64_t epoch = jsl__atomic_load_u64(&map->global_epoch);
+        jsl__atomic_store_u64(&reader->slot->epoch, epoch);
+
+        // The epoch store must be visible to the writer before the version
+        // is loaded, otherwise the writer could free it out from under us
+        jsl__atomic_thread_fence();
+
+        struct JSL__ConcurrentStrMapVersion* version = jsl__atomic_load_ptr(
+            (void* const volatile*) &map->current
+        );
+        res = &version->frozen;
+    }
+
+    return res;
+}
+
+JSL_CONCURRENT_STR_MAP_DEF void jsl_concurrent_str_map_read_end(
+    JSLConcurrentStrMapReader* reader
+)
+{
+    if (reader != NULL && reader->sentinel == JSL__CONCURRENT_MAP_READER_PRIVATE_SENTINEL)
+    {
+        jsl__atomic_store_u64(&reader->slot->epoch, 0);
+    }
+}
+
+JSL_CONCURRENT_STR_MAP_DEF bool jsl_concurrent_str_map_has_key(
+    JSLConcurrentStrMapReader* reader,
+    JSLImmutableMemory key
+)
+{
+    bool res = false;
+
+    const JSLFrozenStrMap* snapshot = jsl_concurrent_str_map_read_begin(reader);
+    if (snapshot != NULL)
+    {
+        res = jsl_frozen_str_map_has_key(snapshot, key);
+        jsl_concurrent_str_map_read_end(reader);
+    }
+
+    return res;
+}
+
+JSL_CONCURRENT_STR_MAP_DEF void jsl_concurrent_str_map_free(
+    JSLConcurrentStrMap* map
+)
+{
+    if (map != NULL && map->sentinel == JSL__CONCURRENT_MAP_PRIVATE_SENTINEL)
+    {
+        while (map->retired != NULL)
+        {
+            struct JSL__ConcurrentStrMapVersion* next = map->retired->next_retired;
+            jsl__concurrent_str_map_free_version(map, map->retired);
+            map->retired = next;
+        }
+
+        jsl__concurrent_str_map_free_version(map, map->current);
+        jsl_str_to_str_map_free(&map->staging);
+        jsl_allocator_interface_free(map->allocator, map->reader_slots);
+
+        JSL_MEMSET(map, 0, sizeof(JSLConcurrentStrMap));
+    }
+}
+
+#undef JSL__CONCURRENT_MAP_PRIVATE_SENTINEL
+#undef JSL__CONCURRENT_MAP_READER_PRIVATE_SENTINEL
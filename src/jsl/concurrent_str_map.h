@@ -0,0 +1,369 @@
+/**
+ * # JSL Concurrent String Map
+ *
+ * This file implements a string to string map for read mostly workloads
+ * that are shared between many reader threads and a single writer thread.
+ * This file is part of the Jack's Standard Library project.
+ *
+ * ## Documentation
+ *
+ * See `docs/jsl_concurrent_str_map.md` for a formatted documentation page.
+ *
+ * ## Design
+ *
+ * The map is split into two halves, similar to read-copy-update in the
+ * Linux kernel.
+ *
+ * The writer owns a private `JSLStrToStrMap` which all inserts and deletes
+ * are applied to. Changes become visible to readers when the writer calls
+ * `jsl_concurrent_str_map_publish`, which freezes the private map into a
+ * new `JSLFrozenStrMap` and atomically swaps it in as the current version.
+ *
+ * Readers never take a lock and never write to memory shared with other
+ * readers. Entering a read section is one store to the reader's own cache
+ * line plus a fence, and lookups are plain frozen map lookups, so reader
+ * throughput scales with the number of cores.
+ *
+ * Old versions cannot be freed as soon as they are replaced because a reader
+ * may still be looking at them. Instead they are reclaimed with epoch based
+ * reclamation: every read section records the global epoch it started in,
+ * each publish advances the global epoch, and a retired version is freed
+ * once every active reader started after it was retired.
+ *
+ * ## Caveats
+ *
+ * * Only one thread may call the writer functions (insert, delete, clear,
+ *   publish, reclaim) at a time.
+ * * Each publish rebuilds the whole frozen table, so batch writes and
+ *   publish once per batch.
+ * * A reader which stays inside a read section forever prevents every
+ *   version published after it from being freed.
+ *
+ * ## License
+ *
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L
+    #include <stdbool.h>
+#endif
+
+#include "core.h"
+#include "allocator.h"
+#include "str_to_str_map.h"
+#include "frozen_str_map.h"
+
+/* Versioning to catch mismatches across deps */
+#ifndef JSL_CONCURRENT_STR_MAP_VERSION
+    #define JSL_CONCURRENT_STR_MAP_VERSION 0x010000  /* 1.0.0 */
+#else
+    #if JSL_CONCURRENT_STR_MAP_VERSION != 0x010000
+        #error "concurrent_str_map.h version mismatch across includes"
+    #endif
+#endif
+
+#ifndef JSL_CONCURRENT_STR_MAP_DEF
+    #define JSL_CONCURRENT_STR_MAP_DEF
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct JSL__ConcurrentStrMapVersion
+{
+    JSLFrozenStrMap frozen;
+    struct JSL__ConcurrentStrMapVersion* next_retired;
+    uint64_t retire_epoch;
+};
+
+/**
+ * One per registered reader. Padded out to a full cache line so that
+ * readers entering and leaving read sections never contend with each other.
+ */
+struct JSL__ConcurrentStrMapReaderSlot
+{
+    /// @brief global epoch when the current read section began, zero when idle
+    uint64_t epoch;
+    /// @brief non zero when claimed by a reader
+    uint64_t in_use;
+    uint8_t padding[48];
+};
+
+struct JSL__ConcurrentStrMap
+{
+    // putting the sentinel first means it's much more likely to get
+    // corrupted from accidental overwrites, therefore making it
+    // more likely that memory bugs are caught.
+    uint64_t sentinel;
+
+    JSLAllocatorInterface allocator;
+
+    /// @brief writer private map, copied into a new version on publish
+    JSLStrToStrMap staging;
+
+    /// @brief the version new read sections see, only changed by publish
+    struct JSL__ConcurrentStrMapVersion* current;
+
+    /// @brief replaced versions that may still be in use, newest first
+    struct JSL__ConcurrentStrMapVersion* retired;
+
+    struct JSL__ConcurrentStrMapReaderSlot* reader_slots;
+    int64_t max_readers;
+
+    uint64_t global_epoch;
+    int64_t retired_count;
+};
+
+struct JSL__ConcurrentStrMapReader
+{
+    uint64_t sentinel;
+    struct JSL__ConcurrentStrMap* map;
+    struct JSL__ConcurrentStrMapReaderSlot* slot;
+};
+
+/**
+ * A string to string map which many threads can read from while one thread
+ * writes to it.
+ *
+ * Example:
+ *
+ * ```
+ * // writer thread
+ * JSLConcurrentStrMap map;
+ * jsl_concurrent_str_map_init(&map, allocator, seed, 32);
+ * jsl_concurrent_str_map_insert(&map, key, JSL_STRING_LIFETIME_SHORTER, value, JSL_STRING_LIFETIME_SHORTER);
+ * jsl_concurrent_str_map_publish(&map);
+ *
+ * // each reader thread
+ * JSLConcurrentStrMapReader reader;
+ * jsl_concurrent_str_map_reader_register(&map, &reader);
+ *
+ * const JSLFrozenStrMap* snapshot = jsl_concurrent_str_map_read_begin(&reader);
+ * JSLImmutableMemory value;
+ * if (jsl_frozen_str_map_get(snapshot, key, &value))
+ * {
+ *     // value is valid until read_end
+ * }
+ * jsl_concurrent_str_map_read_end(&reader);
+ * ```
+ *
+ * ## Functions
+ *
+ *  * jsl_concurrent_str_map_init
+ *  * jsl_concurrent_str_map_insert
+ *  * jsl_concurrent_str_map_delete
+ *  * jsl_concurrent_str_map_clear
+ *  * jsl_concurrent_str_map_publish
+ *  * jsl_concurrent_str_map_reclaim
+ *  * jsl_concurrent_str_map_reader_register
+ *  * jsl_concurrent_str_map_reader_unregister
+ *  * jsl_concurrent_str_map_read_begin
+ *  * jsl_concurrent_str_map_read_end
+ *  * jsl_concurrent_str_map_has_key
+ *  * jsl_concurrent_str_map_free
+ */
+typedef struct JSL__ConcurrentStrMap JSLConcurrentStrMap;
+
+/**
+ * Per thread handle used to read from a `JSLConcurrentStrMap`. A reader
+ * must only be used by one thread at a time.
+ *
+ * ## Functions
+ *
+ *  * jsl_concurrent_str_map_reader_register
+ *  * jsl_concurrent_str_map_reader_unregister
+ *  * jsl_concurrent_str_map_read_begin
+ *  * jsl_concurrent_str_map_read_end
+ *  * jsl_concurrent_str_map_has_key
+ */
+typedef struct JSL__ConcurrentStrMapReader JSLConcurrentStrMapReader;
+
+/**
+ * Initialize an empty concurrent map. An empty version is published
+ * immediately so readers can start before the first publish.
+ *
+ * `allocator` is only used from the writer thread and during
+ * `jsl_concurrent_str_map_free`, so it does not need to be thread safe.
+ *
+ * @param map Pointer to the map to initialize.
+ * @param allocator Allocator used for all allocations.
+ * @param seed Arbitrary seed value for hashing.
+ * @param max_readers Maximum number of readers registered at the same time.
+ * @return `true` on success, `false` if any parameter is invalid or out of memory.
+ */
+JSL_CONCURRENT_STR_MAP_DEF bool jsl_concurrent_str_map_init(
+    JSLConcurrentStrMap* map,
+    JSLAllocatorInterface allocator,
+    uint64_t seed,
+    int64_t max_readers
+);
+
+/**
+ * Insert a key/value pair into the writer's pending changes. Readers do not
+ * see the change until the next `jsl_concurrent_str_map_publish`.
+ *
+ * @param map Map to mutate.
+ * @param key Key to insert.
+ * @param key_lifetime Lifetime semantics for the key data.
+ * @param value Value to insert.
+ * @param value_lifetime Lifetime semantics for the value data.
+ * @return `true` on success, `false` on invalid parameters or OOM.
+ */
+JSL_CONCURRENT_STR_MAP_DEF bool jsl_concurrent_str_map_insert(
+    JSLConcurrentStrMap* map,
+    JSLImmutableMemory key,
+    JSLStringLifeTime key_lifetime,
+    JSLImmutableMemory value,
+    JSLStringLifeTime value_lifetime
+);
+
+/**
+ * Remove a key from the writer's pending changes. Readers do not see the
+ * change until the next `jsl_concurrent_str_map_publish`.
+ *
+ * @param map Map to mutate.
+ * @param key Key to remove.
+ * @return `true` if the key existed and was removed, `false` otherwise.
+ */
+JSL_CONCURRENT_STR_MAP_DEF bool jsl_concurrent_str_map_delete(
+    JSLConcurrentStrMap* map,
+    JSLImmutableMemory key
+);
+
+/**
+ * Remove every key from the writer's pending changes. Readers do not see
+ * the change until the next `jsl_concurrent_str_map_publish`.
+ *
+ * @param map Map to clear.
+ */
+JSL_CONCURRENT_STR_MAP_DEF void jsl_concurrent_str_map_clear(
+    JSLConcurrentStrMap* map
+);
+
+/**
+ * Make all pending changes visible to readers.
+ *
+ * The pending changes are frozen into a new version, which is swapped in
+ * as the current version. Read sections that begin after this returns see
+ * the new version. The replaced version is retired and then every retired
+ * version that no reader can still see is freed.
+ *
+ * @param map Map to publish.
+ * @return `true` on success, `false` on invalid parameters or OOM. On
+ * failure readers continue to see the previous version.
+ */
+JSL_CONCURRENT_STR_MAP_DEF bool jsl_concurrent_str_map_publish(
+    JSLConcurrentStrMap* map
+);
+
+/**
+ * Free every retired version that no reader can still see. Publish already
+ * does this, so this only needs to be called to release memory when
+ * publishes are infrequent.
+ *
+ * @param map Map to reclaim from.
+ * @return Number of retired versions which are still in use and could not
+ * be freed, or `-1` on error.
+ */
+JSL_CONCURRENT_STR_MAP_DEF int64_t jsl_concurrent_str_map_reclaim(
+    JSLConcurrentStrMap* map
+);
+
+/**
+ * Claim a reader slot. This may be called from any thread.
+ *
+ * @param map Map to read from.
+ * @param out_reader Reader handle to initialize.
+ * @return `true` on success, `false` on invalid parameters or if `max_readers`
+ * readers are already registered.
+ */
+JSL_CONCURRENT_STR_MAP_DEF bool jsl_concurrent_str_map_reader_register(
+    JSLConcurrentStrMap* map,
+    JSLConcurrentStrMapReader* out_reader
+);
+
+/**
+ * Release a reader slot so it can be claimed by another reader. The reader
+ * must not be inside a read section.
+ *
+ * @param reader Reader to release.
+ */
+JSL_CONCURRENT_STR_MAP_DEF void jsl_concurrent_str_map_reader_unregister(
+    JSLConcurrentStrMapReader* reader
+);
+
+/**
+ * Begin a read section and get the current version of the map.
+ *
+ * The returned frozen map, and every key and value read out of it, stays
+ * valid until `jsl_concurrent_str_map_read_end` is called with the same
+ * reader, no matter how many times the writer publishes in the meantime.
+ * Read sections cannot be nested.
+ *
+ * This function never blocks.
+ *
+ * @param reader Registered reader.
+ * @return The current version, or `NULL` on invalid parameters.
+ */
+JSL_CONCURRENT_STR_MAP_DEF const JSLFrozenStrMap* jsl_concurrent_str_map_read_begin(
+    JSLConcurrentStrMapReader* reader
+);
+
+/**
+ * End the read section started by `jsl_concurrent_str_map_read_begin`.
+ * Everything read during the section must not be used afterwards.
+ *
+ * @param reader Registered reader.
+ */
+JSL_CONCURRENT_STR_MAP_DEF void jsl_concurrent_str_map_read_end(
+    JSLConcurrentStrMapReader* reader
+);
+
+/**
+ * Does the current version of the map have the given key. This begins and
+ * ends its own read section, so the reader must not already be in one.
+ *
+ * @param reader Registered reader.
+ * @param key Key to search for.
+ * @return `true` if yes, `false` if no or error
+ */
+JSL_CONCURRENT_STR_MAP_DEF bool jsl_concurrent_str_map_has_key(
+    JSLConcurrentStrMapReader* reader,
+    JSLImmutableMemory key
+);
+
+/**
+ * Free all memory owned by the map, including every retired version. No
+ * reader may be registered when this is called.
+ *
+ * @param map Map to free.
+ */
+JSL_CONCURRENT_STR_MAP_DEF void jsl_concurrent_str_map_free(
+    JSLConcurrentStrMap* map
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -30,8 +30,15 @@
 #include "allocator_libc.c"
 #include "allocator_pool.c"
 #include "os.c"
+#include "thread_pool.c"
+#include "hash.c"
 #include "str_set.c"
 #include "str_to_str_map.c"
 #include "str_to_str_multimap.c"
+#include "frozen_str_map.c"
+#include "frozen_str_map_file.c"
+#include "concurrent_str_map.c"
+#include "str_sort.c"
+#include "rope.c"
 #include "string_builder.c"
 #include "cmd_line.c"
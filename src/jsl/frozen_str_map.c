@@ -0,0 +1,1005 @@
+/**
+ * # JSL Frozen String Map and Set
+ *
+ * This file implements read only versions of `JSLStrToStrMap` and `JSLStrSet`
+ * which are built once from a populated container and then only queried.
+ * This file is part of the Jack's Standard Library project.
+ *
+ * ## Documentation
+ *
+ * See `docs/jsl_frozen_str_map.md` for a formatted documentation page.
+ *
+ * ## License
+ *
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L
+    #include <stdbool.h>
+#endif
+
+#include "core.h"
+#include "hash_map_common.h"
+#include "allocator.h"
+#include "str_to_str_map.h"
+#include "str_set.h"
+#include "frozen_str_map.h"
+
+#define JSL__FROZEN_MAP_PRIVATE_SENTINEL 2795019415186637581U
+#define JSL__FROZEN_SET_PRIVATE_SENTINEL 11462071537180437303U
+
+// Average number of keys per bucket. Larger buckets mean fewer pilots to
+// store but a longer search for each one.
+#define JSL__FROZEN_KEYS_PER_BUCKET 4
+
+// Upper bound on the pilot search for a single bucket before the build
+// is retried with a different seed.
+#define JSL__FROZEN_MAX_PILOT (1u << 28)
+#define JSL__FROZEN_MAX_SEED_ATTEMPTS 8
+
+#define JSL__FROZEN_ALIGN_UP_8(x) (((x) + 7) & ~((int64_t) 7))
+
+// "JSLFROZN" when read as little endian bytes. Reading the magic with the
+// wrong byte order fails the check so foreign endian images are rejected.
+#define JSL__FROZEN_IMAGE_MAGIC 0x4E5A4F52464C534AULL
+#define JSL__FROZEN_IMAGE_VERSION 1u
+#define JSL__FROZEN_IMAGE_KIND_MAP 1u
+#define JSL__FROZEN_IMAGE_KIND_SET 2u
+#define JSL__FROZEN_CHECKSUM_SEED 0x6A09E667F3BCC909ULL
+
+/**
+ * The one place where a key's slot is computed, so that the builder and
+ * the lookup can never disagree.
+ */
+static JSL__FORCE_INLINE int64_t jsl__frozen_str_slot_index(
+    uint64_t hash,
+    uint32_t pilot,
+    int64_t item_count
+)
+{
+    uint64_t mixed = jsl__murmur3_fmix_u64(hash, (uint64_t) pilot * 0x9E3779B97F4A7C15ULL);
+    return (int64_t) (mixed % (uint64_t) item_count);
+}
+
+static JSL__FORCE_INLINE int64_t jsl__frozen_str_bucket_index(
+    uint64_t hash,
+    int64_t bucket_count
+)
+{
+    return (int64_t) ((hash >> 32) % (uint64_t) bucket_count);
+}
+
+/**
+ * Covers the header up to the checksum member and then everything after
+ * the header, so both corrupted bookkeeping and corrupted data are caught.
+ */
+static uint64_t jsl__frozen_str_checksum(const uint8_t* blob, int64_t blob_length)
+{
+    size_t header_prefix = offsetof(struct JSL__FrozenStrHeader, checksum);
+    size_t header_size = sizeof(struct JSL__FrozenStrHeader);
+
+    uint64_t res = jsl__rapidhash_withSeed(blob, header_prefix, JSL__FROZEN_CHECKSUM_SEED);
+    res = jsl__rapidhash_withSeed(
+        blob + header_size,
+        (size_t) blob_length - header_size,
+        res
+    );
+
+    return res;
+}
+
+static bool jsl__frozen_str_table_from_blob(
+    struct JSL__FrozenStrTable* table,
+    JSLAllocatorInterface allocator,
+    const uint8_t* blob,
+    uint64_t sentinel
+)
+{
+    const struct JSL__FrozenStrHeader* header = (const struct JSL__FrozenStrHeader*) blob;
+
+    JSL_MEMSET(table, 0, sizeof(struct JSL__FrozenStrTable));
+    table->allocator = allocator;
+    table->blob = blob;
+    table->pilots = (const uint32_t*) (blob + header->pilots_offset);
+    table->slots = (const struct JSL__FrozenStrSlot*) (blob + header->slots_offset);
+    table->strings = blob + header->strings_offset;
+    table->hash_seed = header->hash_seed;
+    table->item_count = header->item_count;
+    table->bucket_count = header->bucket_count;
+    table->blob_length = header->blob_length;
+    table->owns_blob = true;
+    table->sentinel = sentinel;
+
+    return true;
+}
+
+static bool jsl__frozen_str_table_from_image(
+    struct JSL__FrozenStrTable* table,
+    JSLImmutableMemory image,
+    uint32_t kind,
+    uint64_t sentinel
+)
+{
+    const int64_t header_size = (int64_t) sizeof(struct JSL__FrozenStrHeader);
+    const int64_t slot_size = (int64_t) sizeof(struct JSL__FrozenStrSlot);
+
+    bool res = (
+        table != NULL
+        && image.data != NULL
+        && image.length >= header_size
+        && ((uintptr_t) image.data & (_Alignof(struct JSL__FrozenStrHeader) - 1)) == 0
+    );
+
+    const struct JSL__FrozenStrHeader* header = res
+        ? (const struct JSL__FrozenStrHeader*) image.data
+        : NULL;
+
+    res = res
+        && header->magic == JSL__FROZEN_IMAGE_MAGIC
+        && header->version == JSL__FROZEN_IMAGE_VERSION
+        && header->kind == kind
+        && header->blob_length == image.length;
+
+    // Validate the layout with overflow safe comparisons before trusting
+    // any offset. Lookups never bounds check, so this is the only guard.
+    res = res
+        && header->item_count >= 0
+        && header->bucket_count >= 1
+        && header->bucket_count <= (image.length / (int64_t) sizeof(uint32_t))
+        && header->item_count <= (image.length / slot_size)
+        && header->pilots_offset == JSL__FROZEN_ALIGN_UP_8(header_size)
+        && header->slots_offset == JSL__FROZEN_ALIGN_UP_8(
+            header->pilots_offset + (int64_t) sizeof(uint32_t) * header->bucket_count
+        )
+        && header->strings_offset == header->slots_offset + slot_size * header->item_count
+        && header->strings_length >= 0
+        && header->strings_offset <= image.length
+        && header->strings_length == image.length - header->strings_offset;
+
+    res = res && jsl__frozen_str_checksum(image.data, image.length) == header->checksum;
+
+    const struct JSL__FrozenStrSlot* slots = res
+        ? (const struct JSL__FrozenStrSlot*) (image.data + header->slots_offset)
+        : NULL;
+
+    for (int64_t i = 0; res && i < header->item_count; ++i)
+    {
+        bool offset_valid = slots[i].string_offset >= 0
+            && slots[i].string_offset <= header->strings_length;
+        int64_t remaining = offset_valid ? header->strings_length - slots[i].string_offset : 0;
+
+        res = offset_valid
+            && slots[i].key_length >= 0
+            && slots[i].value_length >= 0
+            && slots[i].key_length <= remaining
+            && slots[i].value_length <= remaining - slots[i].key_length;
+    }
+
+    if (res)
+    {
+        jsl__frozen_str_table_from_blob(table, (JSLAllocatorInterface) {0}, image.data, sentinel);
+        table->owns_blob = false;
+    }
+
+    return res;
+}
+
+/**
+ * Search for a pilot for every bucket, largest buckets first. On success
+ * `key_slots[i]` holds the final slot of key `i`.
+ */
+static bool jsl__frozen_str_find_pilots(
+    JSLAllocatorInterface allocator,
+    const uint64_t* hashes,
+    int64_t item_count,
+    int64_t bucket_count,
+    uint32_t* out_pilots,
+    int64_t* key_slots
+)
+{
+    bool res = true;
+
+    int64_t* bucket_starts = (int64_t*) jsl_allocator_interface_alloc(
+        allocator,
+        (int64_t) sizeof(int64_t) * (bucket_count + 1),
+        _Alignof(int64_t),
+        true
+    );
+    int64_t* bucket_cursor = (int64_t*) jsl_allocator_interface_alloc(
+        allocator,
+        (int64_t) sizeof(int64_t) * bucket_count,
+        _Alignof(int64_t),
+        true
+    );
+    int64_t* keys_by_bucket = (int64_t*) jsl_allocator_interface_alloc(
+        allocator,
+        (int64_t) sizeof(int64_t) * item_count,
+        _Alignof(int64_t),
+        false
+    );
+    int64_t* bucket_order = (int64_t*) jsl_allocator_interface_alloc(
+        allocator,
+        (int64_t) sizeof(int64_t) * bucket_count,
+        _Alignof(int64_t),
+        false
+    );
+    int64_t taken_words = (item_count + 63) / 64;
+    uint64_t* taken = (uint64_t*) jsl_allocator_interface_alloc(
+        allocator,
+        (int64_t) sizeof(uint64_t) * taken_words,
+        _Alignof(uint64_t),
+        true
+    );
+
+    res = bucket_starts != NULL
+        && bucket_cursor != NULL
+        && keys_by_bucket != NULL
+        && bucket_order != NULL
+        && taken != NULL;
+
+    // Group the keys by bucket with a counting sort
+    for (int64_t i = 0; res && i < item_count; ++i)
+    {
+        ++bucket_starts[jsl__frozen_str_bucket_index(hashes[i], bucket_count) + 1];
+    }
+
+    int64_t max_bucket_size = 0;
+    for (int64_t b = 0; res && b < bucket_count; ++b)
+    {
+        max_bucket_size = JSL_MAX(max_bucket_size, bucket_starts[b + 1]);
+        bucket_starts[b + 1] += bucket_starts[b];
+        bucket_cursor[b] = bucket_starts[b];
+    }
+
+    for (int64_t i = 0; res && i < item_count; ++i)
+    {
+        int64_t bucket = jsl__frozen_str_bucket_index(hashes[i], bucket_count);
+        keys_by_bucket[bucket_cursor[bucket]++] = i;
+    }
+
+    // Order the buckets largest first with a second counting sort over the
+    // bucket sizes. The cursor array is reused for the size histogram.
+    int64_t* size_starts = NULL;
+    int64_t* positions = NULL;
+    if (res)
+    {
+        size_starts = (int64_t*) jsl_allocator_interface_alloc(
+            allocator,
+            (int64_t) sizeof(int64_t) * (max_bucket_size + 2),
+            _Alignof(int64_t),
+            true
+        );
+        positions = (int64_t*) jsl_allocator_interface_alloc(
+            allocator,
+            (int64_t) sizeof(int64_t) * JSL_MAX(max_bucket_size, 1),
+            _Alignof(int64_t),
+            false
+        );
+        res = size_starts != NULL && positions != NULL;
+    }
+
+    for (int64_t b = 0; res && b < bucket_count; ++b)
+    {
+        int64_t size = bucket_starts[b + 1] - bucket_starts[b];
+        ++size_starts[max_bucket_size - size + 1];
+    }
+
+    for (int64_t s = 0; res && s <= max_bucket_size; ++s)
+    {
+        size_starts[s + 1] += size_starts[s];
+    }
+
+    for (int64_t b = 0; res && b < bucket_count; ++b)
+    {
+        int64_t size = bucket_starts[b + 1] - bucket_starts[b];
+        bucket_order[size_starts[max_bucket_size - size]++] = b;
+    }
+
+    for (int64_t order_index = 0; res && order_index < bucket_count; ++order_index)
+    {
+        int64_t bucket = bucket_order[order_index];
+        int64_t start = bucket_starts[bucket];
+        int64_t size = bucket_starts[bucket + 1] - start;
+
+        out_pilots[bucket] = 0;
+
+        // Buckets are sorted so the rest are empty
+        if (size == 0)
+            break;
+
+        // Two keys with the exact same hash can never be separated by
+        // any pilot, so bail out early and let the caller reseed.
+        for (int64_t a = 0; res && a < size; ++a)
+        {
+            for (int64_t c = a + 1; c < size; ++c)
+            {
+                if (hashes[keys_by_bucket[start + a]] == hashes[keys_by_bucket[start + c]])
+                    res = false;
+            }
+        }
+
+        bool placed = false;
+        uint32_t pilot = 0;
+        while (res && !placed && pilot < JSL__FROZEN_MAX_PILOT)
+        {
+            bool collision = false;
+            int64_t k = 0;
+            for (; k < size; ++k)
+            {
+                int64_t slot = jsl__frozen_str_slot_index(
+                    hashes[keys_by_bucket[start + k]],
+                    pilot,
+                    item_count
+                );
+                collision = (taken[slot >> 6] >> (slot & 63)) & 1u;
+
+                for (int64_t prev = 0; !collision && prev < k; ++prev)
+                {
+                    collision = positions[prev] == slot;
+                }
+
+                if (collision)
+                    break;
+
+                positions[k] = slot;
+            }
+
+            placed = !collision;
+            if (!placed)
+                ++pilot;
+        }
+
+        if (placed)
+        {
+            out_pilots[bucket] = pilot;
+            for (int64_t k = 0; k < size; ++k)
+            {
+                int64_t slot = positions[k];
+                taken[slot >> 6] |= (uint64_t) 1u << (slot & 63);
+                key_slots[keys_by_bucket[start + k]] = slot;
+            }
+        }
+        else
+        {
+            res = false;
+        }
+    }
+
+    jsl_allocator_interface_free(allocator, positions);
+    jsl_allocator_interface_free(allocator, size_starts);
+    jsl_allocator_interface_free(allocator, taken);
+    jsl_allocator_interface_free(allocator, bucket_order);
+    jsl_allocator_interface_free(allocator, keys_by_bucket);
+    jsl_allocator_interface_free(allocator, bucket_cursor);
+    jsl_allocator_interface_free(allocator, bucket_starts);
+
+    return res;
+}
+
+/**
+ * Shared builder for the frozen map and set. `values` is NULL for sets.
+ */
+static bool jsl__frozen_str_build(
+    struct JSL__FrozenStrTable* table,
+    JSLAllocatorInterface allocator,
+    uint64_t seed,
+    const JSLImmutableMemory* keys,
+    const JSLImmutableMemory* values,
+    int64_t item_count,
+    uint64_t sentinel
+)
+{
+    bool res = true;
+
+    int64_t strings_length = 0;
+    for (int64_t i = 0; res && i < item_count; ++i)
+    {
+        int64_t value_length = values != NULL ? values[i].length : 0;
+        res = keys[i].length <= INT64_MAX - strings_length - value_length;
+        strings_length += res ? keys[i].length + value_length : 0;
+    }
+
+    int64_t bucket_count = JSL_MAX(
+        (int64_t) 1,
+        (item_count + JSL__FROZEN_KEYS_PER_BUCKET - 1) / JSL__FROZEN_KEYS_PER_BUCKET
+    );
+
+    int64_t pilots_offset = JSL__FROZEN_ALIGN_UP_8((int64_t) sizeof(struct JSL__FrozenStrHeader));
+    int64_t slots_offset = JSL__FROZEN_ALIGN_UP_8(pilots_offset + (int64_t) sizeof(uint32_t) * bucket_count);
+    int64_t strings_offset = slots_offset + (int64_t) sizeof(struct JSL__FrozenStrSlot) * item_count;
+    bool length_valid = res && strings_length <= INT64_MAX - strings_offset;
+    int64_t blob_length = length_valid ? strings_offset + strings_length : 0;
+
+    uint8_t* blob = NULL;
+    uint64_t* hashes = NULL;
+    int64_t* key_slots = NULL;
+    if (length_valid)
+    {
+        blob = (uint8_t*) jsl_allocator_interface_alloc(
+            allocator,
+            blob_length,
+            _Alignof(struct JSL__FrozenStrHeader),
+            true
+        );
+        hashes = (uint64_t*) jsl_allocator_interface_alloc(
+            allocator,
+            (int64_t) sizeof(uint64_t) * JSL_MAX(item_count, (int64_t) 1),
+            _Alignof(uint64_t),
+            false
+        );
+        key_slots = (int64_t*) jsl_allocator_interface_alloc(
+            allocator,
+            (int64_t) sizeof(int64_t) * JSL_MAX(item_count, (int64_t) 1),
+            _Alignof(int64_t),
+            false
+        );
+    }
+
+    res = blob != NULL && hashes != NULL && key_slots != NULL;
+
+    uint32_t* pilots = res ? (uint32_t*) (blob + pilots_offset) : NULL;
+    bool built = res && item_count == 0;
+    int32_t attempt = 0;
+
+    while (res && !built && attempt < JSL__FROZEN_MAX_SEED_ATTEMPTS)
+    {
+        for (int64_t i = 0; i < item_count; ++i)
+        {
+            hashes[i] = jsl__rapidhash_withSeed(keys[i].data, (size_t) keys[i].length, seed);
+        }
+
+        built = jsl__frozen_str_find_pilots(
+            allocator,
+            hashes,
+            item_count,
+            bucket_count,
+            pilots,
+            key_slots
+        );
+
+        if (!built)
+        {
+            seed = jsl__murmur3_fmix_u64(seed + 1u, 0x9E3779B97F4A7C15ULL);
+            ++attempt;
+        }
+    }
+
+    res = res && built;
+
+    if (res)
+    {
+        struct JSL__FrozenStrHeader* header = (struct JSL__FrozenStrHeader*) blob;
+        header->magic = JSL__FROZEN_IMAGE_MAGIC;
+        header->version = JSL__FROZEN_IMAGE_VERSION;
+        header->kind = sentinel == JSL__FROZEN_MAP_PRIVATE_SENTINEL
+            ? JSL__FROZEN_IMAGE_KIND_MAP
+            : JSL__FROZEN_IMAGE_KIND_SET;
+        header->hash_seed = seed;
+        header->item_count = item_count;
+        header->bucket_count = bucket_count;
+        header->pilots_offset = pilots_offset;
+        header->slots_offset = slots_offset;
+        header->strings_offset = strings_offset;
+        header->strings_length = strings_length;
+        header->blob_length = blob_length;
+
+        struct JSL__FrozenStrSlot* slots = (struct JSL__FrozenStrSlot*) (blob + slots_offset);
+        uint8_t* strings = blob + strings_offset;
+        int64_t string_cursor = 0;
+
+        for (int64_t i = 0; i < item_count; ++i)
+        {
+            struct JSL__FrozenStrSlot* slot = &slots[key_slots[i]];
+            int64_t value_length = values != NULL ? values[i].length : 0;
+
+            slot->hash = hashes[i];
+            slot->string_offset = string_cursor;
+            slot->key_length = keys[i].length;
+            slot->value_length = value_length;
+
+            if (keys[i].length > 0)
+                JSL_MEMCPY(strings + string_cursor, keys[i].data, (size_t) keys[i].length);
+            string_cursor += keys[i].length;
+
+            if (value_length > 0)
+                JSL_MEMCPY(strings + string_cursor, values[i].data, (size_t) value_length);
+            string_cursor += value_length;
+        }
+
+        header->checksum = jsl__frozen_str_checksum(blob, blob_length);
+
+        jsl__frozen_str_table_from_blob(table, allocator, blob, sentinel);
+    }
+
+    bool failed = !res;
+    if (failed)
+    {
+        jsl_allocator_interface_free(allocator, blob);
+    }
+
+    jsl_allocator_interface_free(allocator, key_slots);
+    jsl_allocator_interface_free(allocator, hashes);
+
+    return res;
+}
+
+static JSL__FORCE_INLINE const struct JSL__FrozenStrSlot* jsl__frozen_str_find(
+    const struct JSL__FrozenStrTable* table,
+    JSLImmutableMemory key
+)
+{
+    const struct JSL__FrozenStrSlot* res = NULL;
+
+    if (table->item_count > 0)
+    {
+        uint64_t hash = jsl__rapidhash_withSeed(key.data, (size_t) key.length, table->hash_seed);
+        uint32_t pilot = table->pilots[jsl__frozen_str_bucket_index(hash, table->bucket_count)];
+        const struct JSL__FrozenStrSlot* slot =
+            &table->slots[jsl__frozen_str_slot_index(hash, pilot, table->item_count)];
+
+        bool matches = slot->hash == hash
+            && slot->key_length == key.length
+            && JSL_MEMCMP(table->strings + slot->string_offset, key.data, (size_t) key.length) == 0;
+
+        res = matches ? slot : NULL;
+    }
+
+    return res;
+}
+
+static bool jsl__frozen_str_iterator_next(
+    JSLFrozenStrIter* iterator,
+    uint64_t sentinel,
+    JSLImmutableMemory* out_key,
+    JSLImmutableMemory* out_value
+)
+{
+    bool found = false;
+
+    bool params_valid = (
+        iterator != NULL
+        && out_key != NULL
+        && iterator->sentinel == sentinel
+        && iterator->table != NULL
+        && iterator->table->sentinel == sentinel
+    );
+
+    if (params_valid && iterator->current_slot < iterator->table->item_count)
+    {
+        const struct JSL__FrozenStrSlot* slot = &iterator->table->slots[iterator->current_slot];
+        const uint8_t* key_data = iterator->table->strings + slot->string_offset;
+
+        out_key->data = key_data;
+        out_key->length = slot->key_length;
+
+        if (out_value != NULL)
+        {
+            out_value->data = key_data + slot->key_length;
+            out_value->length = slot->value_length;
+        }
+
+        ++iterator->current_slot;
+        found = true;
+    }
+
+    return found;
+}
+
+JSL_FROZEN_STR_MAP_DEF bool jsl_str_to_str_map_freeze(
+    JSLStrToStrMap* map,
+    JSLAllocatorInterface allocator,
+    JSLFrozenStrMap* out_frozen
+)
+{
+    bool res = false;
+
+    int64_t item_count = jsl_str_to_str_map_item_count(map);
+    bool params_valid = item_count > -1 && out_frozen != NULL;
+
+    JSLImmutableMemory* keys = NULL;
+    JSLImmutableMemory* values = NULL;
+    if (params_valid)
+    {
+        keys = (JSLImmutableMemory*) jsl_allocator_interface_alloc(
+            allocator,
+            (int64_t) sizeof(JSLImmutableMemory) * JSL_MAX(item_count, (int64_t) 1),
+            _Alignof(JSLImmutableMemory),
+            false
+        );
+        values = (JSLImmutableMemory*) jsl_allocator_interface_alloc(
+            allocator,
+            (int64_t) sizeof(JSLImmutableMemory) * JSL_MAX(item_count, (int64_t) 1),
+            _Alignof(JSLImmutableMemory),
+            false
+        );
+    }
+
+    JSLStrToStrMapKeyValueIter iter;
+    bool gathered = keys != NULL
+        && values != NULL
+        && jsl_str_to_str_map_key_value_iterator_init(map, &iter);
+
+    int64_t index = 0;
+    while (gathered && index < item_count)
+    {
+        gathered = jsl_str_to_str_map_key_value_iterator_next(&iter, &keys[index], &values[index]);
+        ++index;
+    }
+
+    if (gathered)
+    {
+        res = jsl__frozen_str_build(
+            &out_frozen->table,
+            allocator,
+            map->hash_seed,
+            keys,
+            values,
+            item_count,
+            JSL__FROZEN_MAP_PRIVATE_SENTINEL
+        );
+    }
+
+    if (params_valid)
+    {
+        jsl_allocator_interface_free(allocator, values);
+        jsl_allocator_interface_free(allocator, keys);
+    }
+
+    return res;
+}
+
+JSL_FROZEN_STR_MAP_DEF int64_t jsl_frozen_str_map_item_count(
+    const JSLFrozenStrMap* frozen
+)
+{
+    int64_t res = -1;
+
+    if (
+        frozen != NULL
+        && frozen->table.sentinel == JSL__FROZEN_MAP_PRIVATE_SENTINEL
+    )
+    {
+        res = frozen->table.item_count;
+    }
+
+    return res;
+}
+
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_map_has_key(
+    const JSLFrozenStrMap* frozen,
+    JSLImmutableMemory key
+)
+{
+    bool res = false;
+
+    if (
+        frozen != NULL
+        && frozen->table.sentinel == JSL__FROZEN_MAP_PRIVATE_SENTINEL
+        && key.data != NULL
+        && key.length > -1
+    )
+    {
+        res = jsl__frozen_str_find(&frozen->table, key) != NULL;
+    }
+
+    return res;
+}
+
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_map_get(
+    const JSLFrozenStrMap* frozen,
+    JSLImmutableMemory key,
+    JSLImmutableMemory* out_value
+)
+{
+    bool params_valid = (
+        frozen != NULL
+        && frozen->table.sentinel == JSL__FROZEN_MAP_PRIVATE_SENTINEL
+        && out_value != NULL
+        && key.data != NULL
+        && key.length > -1
+    );
+
+    const struct JSL__FrozenStrSlot* slot = params_valid
+        ? jsl__frozen_str_find(&frozen->table, key)
+        : NULL;
+
+    if (slot != NULL)
+    {
+        out_value->data = frozen->table.strings + slot->string_offset + slot->key_length;
+        out_value->length = slot->value_length;
+    }
+    else if (out_value != NULL)
+    {
+        *out_value = (JSLImmutableMemory) {0};
+    }
+
+    return slot != NULL;
+}
+
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_map_key_value_iterator_init(
+    const JSLFrozenStrMap* frozen,
+    JSLFrozenStrIter* iterator
+)
+{
+    bool res = false;
+
+    if (
+        frozen != NULL
+        && frozen->table.sentinel == JSL__FROZEN_MAP_PRIVATE_SENTINEL
+        && iterator != NULL
+    )
+    {
+        iterator->table = &frozen->table;
+        iterator->current_slot = 0;
+        iterator->sentinel = JSL__FROZEN_MAP_PRIVATE_SENTINEL;
+        res = true;
+    }
+
+    return res;
+}
+
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_map_key_value_iterator_next(
+    JSLFrozenStrIter* iterator,
+    JSLImmutableMemory* out_key,
+    JSLImmutableMemory* out_value
+)
+{
+    return out_value != NULL && jsl__frozen_str_iterator_next(
+        iterator,
+        JSL__FROZEN_MAP_PRIVATE_SENTINEL,
+        out_key,
+        out_value
+    );
+}
+
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_map_get_image(
+    const JSLFrozenStrMap* frozen,
+    JSLImmutableMemory* out_image
+)
+{
+    bool res = (
+        frozen != NULL
+        && frozen->table.sentinel == JSL__FROZEN_MAP_PRIVATE_SENTINEL
+        && out_image != NULL
+    );
+
+    if (res)
+    {
+        out_image->data = frozen->table.blob;
+        out_image->length = frozen->table.blob_length;
+    }
+
+    return res;
+}
+
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_map_init_from_image(
+    JSLFrozenStrMap* frozen,
+    JSLImmutableMemory image
+)
+{
+    return frozen != NULL && jsl__frozen_str_table_from_image(
+        &frozen->table,
+        image,
+        JSL__FROZEN_IMAGE_KIND_MAP,
+        JSL__FROZEN_MAP_PRIVATE_SENTINEL
+    );
+}
+
+JSL_FROZEN_STR_MAP_DEF void jsl_frozen_str_map_free(
+    JSLFrozenStrMap* frozen
+)
+{
+    if (
+        frozen != NULL
+        && frozen->table.sentinel == JSL__FROZEN_MAP_PRIVATE_SENTINEL
+    )
+    {
+        if (frozen->table.owns_blob)
+            jsl_allocator_interface_free(frozen->table.allocator, frozen->table.blob);
+        JSL_MEMSET(frozen, 0, sizeof(JSLFrozenStrMap));
+    }
+}
+
+JSL_FROZEN_STR_MAP_DEF bool jsl_str_set_freeze(
+    JSLStrSet* set,
+    JSLAllocatorInterface allocator,
+    JSLFrozenStrSet* out_frozen
+)
+{
+    bool res = false;
+
+    int64_t item_count = jsl_str_set_item_count(set);
+    bool params_valid = item_count > -1 && out_frozen != NULL;
+
+    JSLImmutableMemory* values = NULL;
+    if (params_valid)
+    {
+        values = (JSLImmutableMemory*) jsl_allocator_interface_alloc(
+            allocator,
+            (int64_t) sizeof(JSLImmutableMemory) * JSL_MAX(item_count, (int64_t) 1),
+            _Alignof(JSLImmutableMemory),
+            false
+        );
+    }
+
+    JSLStrSetKeyValueIter iter;
+    bool gathered = values != NULL && jsl_str_set_iterator_init(set, &iter);
+
+    int64_t index = 0;
+    while (gathered && index < item_count)
+    {
+        gathered = jsl_str_set_iterator_next(&iter, &values[index]);
+        ++index;
+    }
+
+    if (gathered)
+    {
+        res = jsl__frozen_str_build(
+            &out_frozen->table,
+            allocator,
+            set->hash_seed,
+            values,
+            NULL,
+            item_count,
+            JSL__FROZEN_SET_PRIVATE_SENTINEL
+        );
+    }
+
+    if (params_valid)
+    {
+        jsl_allocator_interface_free(allocator, values);
+    }
+
+    return res;
+}
+
+JSL_FROZEN_STR_MAP_DEF int64_t jsl_frozen_str_set_item_count(
+    const JSLFrozenStrSet* frozen
+)
+{
+    int64_t res = -1;
+
+    if (
+        frozen != NULL
+        && frozen->table.sentinel == JSL__FROZEN_SET_PRIVATE_SENTINEL
+    )
+    {
+        res = frozen->table.item_count;
+    }
+
+    return res;
+}
+
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_set_has(
+    const JSLFrozenStrSet* frozen,
+    JSLImmutableMemory value
+)
+{
+    bool res = false;
+
+    if (
+        frozen != NULL
+        && frozen->table.sentinel == JSL__FROZEN_SET_PRIVATE_SENTINEL
+        && value.data != NULL
+        && value.length > -1
+    )
+    {
+        res = jsl__frozen_str_find(&frozen->table, value) != NULL;
+    }
+
+    return res;
+}
+
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_set_iterator_init(
+    const JSLFrozenStrSet* frozen,
+    JSLFrozenStrIter* iterator
+)
+{
+    bool res = false;
+
+    if (
+        frozen != NULL
+        && frozen->table.sentinel == JSL__FROZEN_SET_PRIVATE_SENTINEL
+        && iterator != NULL
+    )
+    {
+        iterator->table = &frozen->table;
+        iterator->current_slot = 0;
+        iterator->sentinel = JSL__FROZEN_SET_PRIVATE_SENTINEL;
+        res = true;
+    }
+
+    return res;
+}
+
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_set_iterator_next(
+    JSLFrozenStrIter* iterator,
+    JSLImmutableMemory* out_value
+)
+{
+    return jsl__frozen_str_iterator_next(
+        iterator,
+        JSL__FROZEN_SET_PRIVATE_SENTINEL,
+        out_value,
+        NULL
+    );
+}
+
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_set_get_image(
+    const JSLFrozenStrSet* frozen,
+    JSLImmutableMemory* out_image
+)
+{
+    bool res = (
+        frozen != NULL
+        && frozen->table.sentinel == JSL__FROZEN_SET_PRIVATE_SENTINEL
+        && out_image != NULL
+    );
+
+    if (res)
+    {
+        out_image->data = frozen->table.blob;
+        out_image->length = frozen->table.blob_length;
+    }
+
+    return res;
+}
+
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_set_init_from_image(
+    JSLFrozenStrSet* frozen,
+    JSLImmutableMemory image
+)
+{
+    return frozen != NULL && jsl__frozen_str_table_from_image(
+        &frozen->table,
+        image,
+        JSL__FROZEN_IMAGE_KIND_SET,
+        JSL__FROZEN_SET_PRIVATE_SENTINEL
+    );
+}
+
+JSL_FROZEN_STR_MAP_DEF void jsl_frozen_str_set_free(
+    JSLFrozenStrSet* frozen
+)
+{
+    if (
+        frozen != NULL
+        && frozen->table.sentinel == JSL__FROZEN_SET_PRIVATE_SENTINEL
+    )
+    {
+        if (frozen->table.owns_blob)
+            jsl_allocator_interface_free(frozen->table.allocator, frozen->table.blob);
+        JSL_MEMSET(frozen, 0, sizeof(JSLFrozenStrSet));
+    }
+}
+
+#undef JSL__FROZEN_MAP_PRIVATE_SENTINEL
+#undef JSL__FROZEN_SET_PRIVATE_SENTINEL
+#undef JSL__FROZEN_KEYS_PER_BUCKET
+#undef JSL__FROZEN_MAX_PILOT
+#undef JSL__FROZEN_MAX_SEED_ATTEMPTS
+#undef JSL__FROZEN_ALIGN_UP_8
+#undef JSL__FROZEN_IMAGE_MAGIC
+#undef JSL__FROZEN_IMAGE_VERSION
+#undef JSL__FROZEN_IMAGE_KIND_MAP
+#undef JSL__FROZEN_IMAGE_KIND_SET
+#undef JSL__FROZEN_CHECKSUM_SEED
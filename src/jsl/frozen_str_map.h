@@ -0,0 +1,449 @@
+/**
+ * # JSL Frozen String Map and Set
+ *
+ * This file implements read only versions of `JSLStrToStrMap` and `JSLStrSet`
+ * which are built once from a populated container and then only queried.
+ * This file is part of the Jack's Standard Library project.
+ *
+ * ## Documentation
+ *
+ * See `docs/jsl_frozen_str_map.md` for a formatted documentation page.
+ *
+ * ## Design
+ *
+ * Freezing a container builds a minimal perfect hash function over its keys
+ * using the "hash and displace" scheme from CHD and PTHash. Keys are first
+ * split into small buckets. Then, starting with the largest bucket, a 32 bit
+ * "pilot" value is searched for each bucket which sends every key in that
+ * bucket to a free slot. The result is a table with exactly one slot per key,
+ * which means
+ *
+ * * every lookup is one hash, one pilot read, and one slot read
+ * * there are no tombstones, empty slots, or load factor slack
+ * * there is no generational ID because the container cannot change
+ *
+ * All of the bookkeeping, the slots, and the key and value bytes are stored
+ * in one contiguous allocation that uses offsets rather than pointers. Since
+ * nothing is ever written after the freeze, the frozen containers can be
+ * shared across threads without any synchronization.
+ *
+ * ## Caveats
+ *
+ * Building the perfect hash is several times slower than inserting the same
+ * keys into a `JSLStrToStrMap`. Freezing only makes sense for containers
+ * which are read many more times than they are built.
+ *
+ * ## License
+ *
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L
+    #include <stdbool.h>
+#endif
+
+#include "core.h"
+#include "hash_map_common.h"
+#include "allocator.h"
+#include "str_to_str_map.h"
+#include "str_set.h"
+
+/* Versioning to catch mismatches across deps */
+#ifndef JSL_FROZEN_STR_MAP_VERSION
+    #define JSL_FROZEN_STR_MAP_VERSION 0x010000  /* 1.0.0 */
+#else
+    #if JSL_FROZEN_STR_MAP_VERSION != 0x010000
+        #error "frozen_str_map.h version mismatch across includes"
+    #endif
+#endif
+
+#ifndef JSL_FROZEN_STR_MAP_DEF
+    #define JSL_FROZEN_STR_MAP_DEF
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Stored at the very start of the frozen blob. Every offset is relative
+ * to the start of the blob so the blob can be copied or mapped at any
+ * address. The checksum must stay the last member, it covers every byte
+ * of the blob before and after it.
+ */
+struct JSL__FrozenStrHeader
+{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t kind;
+    uint64_t hash_seed;
+    int64_t item_count;
+    int64_t bucket_count;
+    int64_t pilots_offset;
+    int64_t slots_offset;
+    int64_t strings_offset;
+    int64_t strings_length;
+    int64_t blob_length;
+    uint64_t checksum;
+};
+
+/**
+ * One slot per key. The value bytes, if any, directly follow the key bytes
+ * in the strings section.
+ */
+struct JSL__FrozenStrSlot
+{
+    uint64_t hash;
+    int64_t string_offset;
+    int64_t key_length;
+    int64_t value_length;
+};
+
+struct JSL__FrozenStrTable
+{
+    // putting the sentinel first means it's much more likely to get
+    // corrupted from accidental overwrites, therefore making it
+    // more likely that memory bugs are caught.
+    uint64_t sentinel;
+
+    JSLAllocatorInterface allocator;
+
+    const uint8_t* blob;
+    const uint32_t* pilots;
+    const struct JSL__FrozenStrSlot* slots;
+    const uint8_t* strings;
+
+    uint64_t hash_seed;
+    int64_t item_count;
+    int64_t bucket_count;
+    int64_t blob_length;
+
+    /// @brief false when the blob is borrowed from a loaded image
+    bool owns_blob;
+};
+
+struct JSL__FrozenStrMap {
+    struct JSL__FrozenStrTable table;
+};
+
+struct JSL__FrozenStrSet {
+    struct JSL__FrozenStrTable table;
+};
+
+struct JSL__FrozenStrIter {
+    uint64_t sentinel;
+    const struct JSL__FrozenStrTable* table;
+    int64_t current_slot;
+};
+
+/**
+ * A read only string to string map created by `jsl_str_to_str_map_freeze`.
+ *
+ * Lookups go through a minimal perfect hash so every key is found with a
+ * single slot read. The map owns a copy of every key and value, so the
+ * source `JSLStrToStrMap` can be freed or mutated after the freeze.
+ *
+ * Example:
+ *
+ * ```
+ * JSLFrozenStrMap frozen;
+ * if (jsl_str_to_str_map_freeze(&map, allocator, &frozen))
+ * {
+ *     JSLImmutableMemory value;
+ *     jsl_frozen_str_map_get(&frozen, JSL_CSTR_EXPRESSION("key"), &value);
+ * }
+ * ```
+ *
+ * ## Functions
+ *
+ *  * jsl_str_to_str_map_freeze
+ *  * jsl_frozen_str_map_item_count
+ *  * jsl_frozen_str_map_has_key
+ *  * jsl_frozen_str_map_get
+ *  * jsl_frozen_str_map_key_value_iterator_init
+ *  * jsl_frozen_str_map_key_value_iterator_next
+ *  * jsl_frozen_str_map_get_image
+ *  * jsl_frozen_str_map_init_from_image
+ *  * jsl_frozen_str_map_free
+ */
+typedef struct JSL__FrozenStrMap JSLFrozenStrMap;
+
+/**
+ * A read only string set created by `jsl_str_set_freeze`.
+ *
+ * ## Functions
+ *
+ *  * jsl_str_set_freeze
+ *  * jsl_frozen_str_set_item_count
+ *  * jsl_frozen_str_set_has
+ *  * jsl_frozen_str_set_iterator_init
+ *  * jsl_frozen_str_set_iterator_next
+ *  * jsl_frozen_str_set_get_image
+ *  * jsl_frozen_str_set_init_from_image
+ *  * jsl_frozen_str_set_free
+ */
+typedef struct JSL__FrozenStrSet JSLFrozenStrSet;
+
+/**
+ * State tracking struct for iterating over a frozen map or set. Since the
+ * frozen containers cannot change, the iterator is never invalidated until
+ * the container is freed.
+ */
+typedef struct JSL__FrozenStrIter JSLFrozenStrIter;
+
+/**
+ * Build a read only copy of `map`.
+ *
+ * All keys and values are copied into a single allocation from `allocator`.
+ * Temporary memory used while building the perfect hash is also taken from
+ * `allocator` and freed before returning. The frozen map uses the same hash
+ * seed as the source map unless the build needs to retry with a new one.
+ *
+ * @param map Populated map to copy from.
+ * @param allocator Allocator used for the frozen map.
+ * @param out_frozen Frozen map to initialize.
+ * @return `true` on success, `false` if any parameter is invalid or out of memory.
+ */
+JSL_FROZEN_STR_MAP_DEF bool jsl_str_to_str_map_freeze(
+    JSLStrToStrMap* map,
+    JSLAllocatorInterface allocator,
+    JSLFrozenStrMap* out_frozen
+);
+
+/**
+ * Get the number of items stored.
+ *
+ * @param frozen Pointer to the frozen map.
+ * @return Key count, or `-1` on error
+ */
+JSL_FROZEN_STR_MAP_DEF int64_t jsl_frozen_str_map_item_count(
+    const JSLFrozenStrMap* frozen
+);
+
+/**
+ * Does the frozen map have the given key.
+ *
+ * @param frozen Pointer to the frozen map.
+ * @param key Key to search for.
+ * @return `true` if yes, `false` if no or error
+ */
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_map_has_key(
+    const JSLFrozenStrMap* frozen,
+    JSLImmutableMemory key
+);
+
+/**
+ * Get the value of the key. The returned value points into the frozen
+ * map's storage and lives as long as the frozen map.
+ *
+ * @param frozen Frozen map to search.
+ * @param key Key to search for.
+ * @param out_value Output parameter that will be filled with the value if successful
+ * @returns A bool indicating success or failure
+ */
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_map_get(
+    const JSLFrozenStrMap* frozen,
+    JSLImmutableMemory key,
+    JSLImmutableMemory* out_value
+);
+
+/**
+ * Initialize an iterator that visits every key/value pair in the frozen map.
+ * Traversal order is undefined.
+ *
+ * @param frozen Frozen map to iterate over.
+ * @param iterator Iterator instance to initialize.
+ * @return `true` on success, `false` if parameters are invalid.
+ */
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_map_key_value_iterator_init(
+    const JSLFrozenStrMap* frozen,
+    JSLFrozenStrIter* iterator
+);
+
+/**
+ * Advance the key/value iterator.
+ *
+ * @param iterator Iterator to advance.
+ * @param out_key Output for the current key.
+ * @param out_value Output for the current value.
+ * @return `true` if a pair was produced, `false` if exhausted or invalid.
+ */
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_map_key_value_iterator_next(
+    JSLFrozenStrIter* iterator,
+    JSLImmutableMemory* out_key,
+    JSLImmutableMemory* out_value
+);
+
+/**
+ * Get the serialized image of the frozen map.
+ *
+ * The frozen map is already stored as a single position independent blob
+ * with a versioned header and a checksum, so this is a view of the map's
+ * own storage and no copy is made. The bytes can be written to disk or
+ * sent elsewhere and later loaded with `jsl_frozen_str_map_init_from_image`.
+ *
+ * The image uses the native byte order and is only loadable on machines
+ * with the same endianness.
+ *
+ * @param frozen Frozen map to serialize.
+ * @param out_image Output for the image bytes, valid as long as the frozen map.
+ * @return `true` on success, `false` if any parameter is invalid.
+ */
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_map_get_image(
+    const JSLFrozenStrMap* frozen,
+    JSLImmutableMemory* out_image
+);
+
+/**
+ * Initialize a frozen map which serves lookups directly out of `image`,
+ * which was previously produced by `jsl_frozen_str_map_get_image`.
+ *
+ * The header, the version, the layout, and the checksum are all verified
+ * before the map is usable. Nothing is copied, so `image` must outlive
+ * the frozen map and must be aligned to at least eight bytes. Memory from
+ * `jsl_map_file` satisfies both. Calling `jsl_frozen_str_map_free` on a map
+ * initialized this way does not free the image.
+ *
+ * @param frozen Frozen map to initialize.
+ * @param image Image bytes.
+ * @return `true` on success, `false` if the image is invalid or corrupted.
+ */
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_map_init_from_image(
+    JSLFrozenStrMap* frozen,
+    JSLImmutableMemory image
+);
+
+/**
+ * Free the frozen map's storage. The frozen map is then put into an invalid
+ * state and every key and value previously returned from it is dangling.
+ *
+ * @param frozen Frozen map to free.
+ */
+JSL_FROZEN_STR_MAP_DEF void jsl_frozen_str_map_free(
+    JSLFrozenStrMap* frozen
+);
+
+/**
+ * Build a read only copy of `set`.
+ *
+ * All values are copied into a single allocation from `allocator`.
+ * Temporary memory used while building the perfect hash is also taken from
+ * `allocator` and freed before returning.
+ *
+ * @param set Populated set to copy from.
+ * @param allocator Allocator used for the frozen set.
+ * @param out_frozen Frozen set to initialize.
+ * @return `true` on success, `false` if any parameter is invalid or out of memory.
+ */
+JSL_FROZEN_STR_MAP_DEF bool jsl_str_set_freeze(
+    JSLStrSet* set,
+    JSLAllocatorInterface allocator,
+    JSLFrozenStrSet* out_frozen
+);
+
+/**
+ * Get the number of items stored.
+ *
+ * @param frozen Pointer to the frozen set.
+ * @return Value count, or `-1` on error
+ */
+JSL_FROZEN_STR_MAP_DEF int64_t jsl_frozen_str_set_item_count(
+    const JSLFrozenStrSet* frozen
+);
+
+/**
+ * Does the frozen set contain the given value.
+ *
+ * @param frozen Pointer to the frozen set.
+ * @param value Value to search for.
+ * @return `true` if yes, `false` if no or error
+ */
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_set_has(
+    const JSLFrozenStrSet* frozen,
+    JSLImmutableMemory value
+);
+
+/**
+ * Initialize an iterator that visits every value in the frozen set.
+ * Traversal order is undefined.
+ *
+ * @param frozen Frozen set to iterate over.
+ * @param iterator Iterator instance to initialize.
+ * @return `true` on success, `false` if parameters are invalid.
+ */
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_set_iterator_init(
+    const JSLFrozenStrSet* frozen,
+    JSLFrozenStrIter* iterator
+);
+
+/**
+ * Advance the set iterator.
+ *
+ * @param iterator Iterator to advance.
+ * @param out_value Output for the current value.
+ * @return `true` if a value was produced, `false` if exhausted or invalid.
+ */
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_set_iterator_next(
+    JSLFrozenStrIter* iterator,
+    JSLImmutableMemory* out_value
+);
+
+/**
+ * Get the serialized image of the frozen set. See `jsl_frozen_str_map_get_image`.
+ *
+ * @param frozen Frozen set to serialize.
+ * @param out_image Output for the image bytes, valid as long as the frozen set.
+ * @return `true` on success, `false` if any parameter is invalid.
+ */
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_set_get_image(
+    const JSLFrozenStrSet* frozen,
+    JSLImmutableMemory* out_image
+);
+
+/**
+ * Initialize a frozen set which serves lookups directly out of `image`.
+ * See `jsl_frozen_str_map_init_from_image`.
+ *
+ * @param frozen Frozen set to initialize.
+ * @param image Image bytes.
+ * @return `true` on success, `false` if the image is invalid or corrupted.
+ */
+JSL_FROZEN_STR_MAP_DEF bool jsl_frozen_str_set_init_from_image(
+    JSLFrozenStrSet* frozen,
+    JSLImmutableMemory image
+);
+
+/**
+ * Free the frozen set's storage. The frozen set is then put into an invalid
+ * state and every value previously returned from it is dangling.
+ *
+ * @param frozen Frozen set to free.
+ */
+JSL_FROZEN_STR_MAP_DEF void jsl_frozen_str_set_free(
+    JSLFrozenStrSet* frozen
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,168 @@
+/**
+ * # JSL Frozen String Map and Set Files
+ *
+ * This file implements saving frozen string maps and sets to disk and
+ * loading them back by memory mapping the file. This file is part of
+ * the Jack's Standard Library project.
+ *
+ * ## Documentation
+ *
+ * See `docs/jsl_frozen_str_map_file.md` for a formatted documentation page.
+ *
+ * ## License
+ *
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L
+    #include <stdbool.h>
+#endif
+
+#include "core.h"
+#include "allocator.h"
+#include "os.h"
+#include "frozen_str_map.h"
+#include "frozen_str_map_file.h"
+
+static JSLFrozenImageFileResultEnum jsl__frozen_image_write_file(
+    bool image_valid,
+    JSLImmutableMemory image,
+    JSLImmutableMemory path,
+    int32_t* out_errno
+)
+{
+    JSLFrozenImageFileResultEnum res = image_valid
+        ? JSL_FROZEN_IMAGE_FILE_SUCCESS
+        : JSL_FROZEN_IMAGE_FILE_BAD_PARAMETERS;
+
+    int64_t bytes_written = 0;
+    JSLWriteFileResultEnum write_res = JSL_FILE_WRITE_BAD_PARAMETERS;
+    if (res == JSL_FROZEN_IMAGE_FILE_SUCCESS)
+    {
+        write_res = jsl_write_file_contents(image, path, &bytes_written, out_errno);
+    }
+
+    bool could_not_open = res == JSL_FROZEN_IMAGE_FILE_SUCCESS
+        && (write_res == JSL_FILE_WRITE_COULD_NOT_OPEN || write_res == JSL_FILE_WRITE_BAD_PARAMETERS);
+    bool short_write = res == JSL_FROZEN_IMAGE_FILE_SUCCESS
+        && !could_not_open
+        && (write_res != JSL_FILE_WRITE_SUCCESS || bytes_written != image.length);
+
+    if (could_not_open)
+        res = JSL_FROZEN_IMAGE_FILE_COULD_NOT_OPEN;
+    if (short_write)
+        res = JSL_FROZEN_IMAGE_FILE_COULD_NOT_WRITE;
+
+    return res;
+}
+
+static JSLFrozenImageFileResultEnum jsl__frozen_image_map_file(
+    JSLImmutableMemory path,
+    JSLMappedFile* out_mapping,
+    int32_t* out_errno
+)
+{
+    JSLFrozenImageFileResultEnum res = JSL_FROZEN_IMAGE_FILE_BAD_PARAMETERS;
+
+    JSLMapFileResultEnum map_res = jsl_map_file(path, out_mapping, out_errno);
+
+    if (map_res == JSL_MAP_FILE_SUCCESS)
+        res = JSL_FROZEN_IMAGE_FILE_SUCCESS;
+    else if (map_res != JSL_MAP_FILE_BAD_PARAMETERS)
+        res = JSL_FROZEN_IMAGE_FILE_COULD_NOT_OPEN;
+
+    return res;
+}
+
+JSL_FROZEN_STR_MAP_FILE_DEF JSLFrozenImageFileResultEnum jsl_frozen_str_map_write_file(
+    const JSLFrozenStrMap* frozen,
+    JSLImmutableMemory path,
+    int32_t* out_errno
+)
+{
+    JSLImmutableMemory image = {0};
+    bool image_valid = jsl_frozen_str_map_get_image(frozen, &image);
+    return jsl__frozen_image_write_file(image_valid, image, path, out_errno);
+}
+
+JSL_FROZEN_STR_MAP_FILE_DEF JSLFrozenImageFileResultEnum jsl_frozen_str_map_open_file(
+    JSLImmutableMemory path,
+    JSLFrozenStrMap* out_frozen,
+    JSLMappedFile* out_mapping,
+    int32_t* out_errno
+)
+{
+    JSLFrozenImageFileResultEnum res = JSL_FROZEN_IMAGE_FILE_BAD_PARAMETERS;
+
+    if (out_frozen != NULL && out_mapping != NULL)
+    {
+        res = jsl__frozen_image_map_file(path, out_mapping, out_errno);
+    }
+
+    bool loaded = res == JSL_FROZEN_IMAGE_FILE_SUCCESS
+        && jsl_frozen_str_map_init_from_image(out_frozen, out_mapping->contents);
+
+    if (res == JSL_FROZEN_IMAGE_FILE_SUCCESS && !loaded)
+    {
+        jsl_unmap_file(out_mapping);
+        res = JSL_FROZEN_IMAGE_FILE_INVALID_IMAGE;
+    }
+
+    return res;
+}
+
+JSL_FROZEN_STR_MAP_FILE_DEF JSLFrozenImageFileResultEnum jsl_frozen_str_set_write_file(
+    const JSLFrozenStrSet* frozen,
+    JSLImmutableMemory path,
+    int32_t* out_errno
+)
+{
+    JSLImmutableMemory image = {0};
+    bool image_valid = jsl_frozen_str_set_get_image(frozen, &image);
+    return jsl__frozen_image_write_file(image_valid, image, path, out_errno);
+}
+
+JSL_FROZEN_STR_MAP_FILE_DEF JSLFrozenImageFileResultEnum jsl_frozen_str_set_open_file(
+    JSLImmutableMemory path,
+    JSLFrozenStrSet* out_frozen,
+    JSLMappedFile* out_mapping,
+    int32_t* out_errno
+)
+{
+    JSLFrozenImageFileResultEnum res = JSL_FROZEN_IMAGE_FILE_BAD_PARAMETERS;
+
+    if (out_frozen != NULL && out_mapping != NULL)
+    {
+        res = jsl__frozen_image_map_file(path, out_mapping, out_errno);
+    }
+
+    bool loaded = res == JSL_FROZEN_IMAGE_FILE_SUCCESS
+        && jsl_frozen_str_set_init_from_image(out_frozen, out_mapping->contents);
+
+    if (res == JSL_FROZEN_IMAGE_FILE_SUCCESS && !loaded)
+    {
+        jsl_unmap_file(out_mapping);
+        res = JSL_FROZEN_IMAGE_FILE_INVALID_IMAGE;
+    }
+
+    return res;
+}
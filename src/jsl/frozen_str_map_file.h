@@ -0,0 +1,193 @@
+/**
+ * # JSL Frozen String Map and Set Files
+ *
+ * This file implements saving frozen string maps and sets to disk and
+ * loading them back by memory mapping the file, so that a program can
+ * start with a fully populated lookup table without rebuilding it. This
+ * file is part of the Jack's Standard Library project.
+ *
+ * ## Documentation
+ *
+ * See `docs/jsl_frozen_str_map_file.md` for a formatted documentation page.
+ *
+ * ## Design
+ *
+ * The on disk format is exactly the image described in `frozen_str_map.h`:
+ * a header with a magic number, format version, hash seed and checksum,
+ * followed by the pilots, slots and string bytes, all addressed by offsets.
+ * Loading maps the file read only with `jsl_map_file`, verifies the header
+ * and checksum, and then serves lookups directly out of the mapping. Only
+ * the pages touched by lookups are ever read from disk after the checksum
+ * pass.
+ *
+ * ## License
+ *
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L
+    #include <stdbool.h>
+#endif
+
+#include "core.h"
+#include "allocator.h"
+#include "os.h"
+#include "frozen_str_map.h"
+
+/* Versioning to catch mismatches across deps */
+#ifndef JSL_FROZEN_STR_MAP_FILE_VERSION
+    #define JSL_FROZEN_STR_MAP_FILE_VERSION 0x010000  /* 1.0.0 */
+#else
+    #if JSL_FROZEN_STR_MAP_FILE_VERSION != 0x010000
+        #error "frozen_str_map_file.h version mismatch across includes"
+    #endif
+#endif
+
+#ifndef JSL_FROZEN_STR_MAP_FILE_DEF
+    #define JSL_FROZEN_STR_MAP_FILE_DEF
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Result codes for the frozen image file functions.
+ */
+typedef enum
+{
+    /// @brief arguments are invalid
+    JSL_FROZEN_IMAGE_FILE_BAD_PARAMETERS = 0,
+    /// @brief the image was written or loaded
+    JSL_FROZEN_IMAGE_FILE_SUCCESS,
+    /// @brief the file could not be opened or mapped
+    JSL_FROZEN_IMAGE_FILE_COULD_NOT_OPEN,
+    /// @brief the file could not be fully written
+    JSL_FROZEN_IMAGE_FILE_COULD_NOT_WRITE,
+    /// @brief the file is not an image of the requested kind, is from an
+    /// incompatible version, or failed the checksum
+    JSL_FROZEN_IMAGE_FILE_INVALID_IMAGE,
+
+    JSL_FROZEN_IMAGE_FILE_ENUM_COUNT
+} JSLFrozenImageFileResultEnum;
+
+/**
+ * Write the image of `frozen` to the file at `path`, replacing any
+ * existing file.
+ *
+ * Example:
+ *
+ * ```
+ * JSLFrozenStrMap frozen;
+ * jsl_str_to_str_map_freeze(&map, allocator, &frozen);
+ * jsl_frozen_str_map_write_file(&frozen, JSL_CSTR_EXPRESSION("words.img"), NULL);
+ * ```
+ *
+ * @param frozen Frozen map to write.
+ * @param path File system path to write to.
+ * @param out_errno Optional pointer that receives the system error code on failure
+ * @returns A result enum describing the outcome
+ */
+JSL_FROZEN_STR_MAP_FILE_DEF JSLFrozenImageFileResultEnum jsl_frozen_str_map_write_file(
+    const JSLFrozenStrMap* frozen,
+    JSLImmutableMemory path,
+    int32_t* out_errno
+);
+
+/**
+ * Memory map the image file at `path` and initialize `out_frozen` to serve
+ * lookups from the mapping.
+ *
+ * The frozen map borrows the mapping, so `out_mapping` must be kept alive
+ * until the frozen map is no longer used and then released with
+ * `jsl_unmap_file`.
+ *
+ * Example:
+ *
+ * ```
+ * JSLFrozenStrMap frozen;
+ * JSLMappedFile mapping;
+ * JSLFrozenImageFileResultEnum res = jsl_frozen_str_map_open_file(
+ *     JSL_CSTR_EXPRESSION("words.img"),
+ *     &frozen,
+ *     &mapping,
+ *     NULL
+ * );
+ *
+ * if (res == JSL_FROZEN_IMAGE_FILE_SUCCESS)
+ * {
+ *     ...
+ *     jsl_frozen_str_map_free(&frozen);
+ *     jsl_unmap_file(&mapping);
+ * }
+ * ```
+ *
+ * @param path File system path of the image.
+ * @param out_frozen Frozen map to initialize.
+ * @param out_mapping Mapping which backs the frozen map on success.
+ * @param out_errno Optional pointer that receives the system error code on failure
+ * @returns A result enum describing the outcome
+ */
+JSL_FROZEN_STR_MAP_FILE_DEF JSLFrozenImageFileResultEnum jsl_frozen_str_map_open_file(
+    JSLImmutableMemory path,
+    JSLFrozenStrMap* out_frozen,
+    JSLMappedFile* out_mapping,
+    int32_t* out_errno
+);
+
+/**
+ * Write the image of `frozen` to the file at `path`, replacing any
+ * existing file. See `jsl_frozen_str_map_write_file`.
+ *
+ * @param frozen Frozen set to write.
+ * @param path File system path to write to.
+ * @param out_errno Optional pointer that receives the system error code on failure
+ * @returns A result enum describing the outcome
+ */
+JSL_FROZEN_STR_MAP_FILE_DEF JSLFrozenImageFileResultEnum jsl_frozen_str_set_write_file(
+    const JSLFrozenStrSet* frozen,
+    JSLImmutableMemory path,
+    int32_t* out_errno
+);
+
+/**
+ * Memory map the image file at `path` and initialize `out_frozen` to serve
+ * lookups from the mapping. See `jsl_frozen_str_map_open_file`.
+ *
+ * @param path File system path of the image.
+ * @param out_frozen Frozen set to initialize.
+ * @param out_mapping Mapping which backs the frozen set on success.
+ * @param out_errno Optional pointer that receives the system error code on failure
+ * @returns A result enum describing the outcome
+ */
+JSL_FROZEN_STR_MAP_FILE_DEF JSLFrozenImageFileResultEnum jsl_frozen_str_set_open_file(
+    JSLImmutableMemory path,
+    JSLFrozenStrSet* out_frozen,
+    JSLMappedFile* out_mapping,
+    int32_t* out_errno
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,521 @@
+/**
+ * # JSL Hashing
+ *
+ * This file implements the public hashing API. This file is part of the
+ * Jack's Standard Library project.
+ *
+ * ## Documentation
+ *
+ * See `docs/jsl_hash.md` for a formatted documentation page.
+ *
+ * ## License
+ *
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L
+    #include <stdbool.h>
+#endif
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define JSL__HASH_AVX2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define JSL__HASH_NEON 1
+#endif
+
+#include "core.h"
+#include "hash_map_common.h"
+#include "hash.h"
+
+#define JSL__HASH_STREAM_PRIVATE_SENTINEL 9237416622915021913UL
+
+/**
+ * rapidhash for inputs of 16 bytes or less, with the seed already mixed by
+ * `jsl__hash_mix_seed`. Must match the short input path of
+ * `jsl__rapidhash_internal` exactly.
+ */
+static JSL__FORCE_INLINE uint64_t jsl__hash_short(
+    const uint8_t* p,
+    size_t len,
+    uint64_t mixed_seed
+)
+{
+    uint64_t seed = mixed_seed;
+    uint64_t a = 0;
+    uint64_t b = 0;
+
+    if (len >= 8)
+    {
+        seed ^= len;
+        a = jsl__rapid_read64(p);
+        b = jsl__rapid_read64(p + len - 8);
+    }
+    else if (len >= 4)
+    {
+        seed ^= len;
+        a = jsl__rapid_read32(p);
+        b = jsl__rapid_read32(p + len - 4);
+    }
+    else if (len > 0)
+    {
+        a = (((uint64_t) p[0]) << 45) | p[len - 1];
+        b = p[len >> 1];
+    }
+
+    a ^= jsl__rapid_secret[1];
+    b ^= seed;
+    jsl__rapid_mum(&a, &b);
+    return jsl__rapid_mix(a ^ jsl__rapid_secret[7], b ^ jsl__rapid_secret[1] ^ len);
+}
+
+static JSL__FORCE_INLINE uint64_t jsl__hash_mix_seed(uint64_t seed)
+{
+    return seed ^ jsl__rapid_mix(seed ^ jsl__rapid_secret[2], jsl__rapid_secret[1]);
+}
+
+JSL_HASH_DEF uint64_t jsl_hash_bytes(
+    JSLImmutableMemory data,
+    uint64_t seed
+)
+{
+    size_t length = data.data != NULL && data.length > 0 ? (size_t) data.length : 0;
+    return jsl__rapidhash_withSeed(data.data, length, seed);
+}
+
+JSL_HASH_DEF uint64_t jsl_hash_u64(
+    uint64_t value,
+    uint64_t seed
+)
+{
+    return jsl__murmur3_fmix_u64(value, seed);
+}
+
+JSL_HASH_DEF uint64_t jsl_hash_crc32c_u64(
+    uint64_t value,
+    uint64_t seed
+)
+{
+    return jsl__crc32c_u64(value, seed);
+}
+
+JSL_HASH_DEF uint64_t jsl_hash_crc32c_bytes(
+    JSLImmutableMemory data,
+    uint64_t seed
+)
+{
+    size_t length = data.data != NULL && data.length > 0 ? (size_t) data.length : 0;
+    return jsl__crc32c_bytes(data.data, length, seed);
+}
+
+JSL_HASH_DEF uint64_t jsl_hash_aes_u64(
+    uint64_t value,
+    uint64_t seed
+)
+{
+    return jsl__aes_u64(value, seed);
+}
+
+JSL_HASH_DEF uint64_t jsl_hash_aes_bytes(
+    JSLImmutableMemory data,
+    uint64_t seed
+)
+{
+    size_t length = data.data != NULL && data.length > 0 ? (size_t) data.length : 0;
+    return jsl__aes_bytes(data.data, length, seed);
+}
+
+JSL_HASH_DEF bool jsl_hash_many(
+    const JSLImmutableMemory* keys,
+    int64_t count,
+    uint64_t seed,
+    uint64_t* out_hashes
+)
+{
+    bool res = count == 0 || (keys != NULL && out_hashes != NULL && count > 0);
+
+    uint64_t mixed_seed = jsl__hash_mix_seed(seed);
+
+    for (int64_t i = 0; res && i < count; ++i)
+    {
+        size_t length = keys[i].data != NULL && keys[i].length > 0
+            ? (size_t) keys[i].length
+            : 0;
+
+        out_hashes[i] = JSL__LIKELY(length <= 16)
+            ? jsl__hash_short(keys[i].data, length, mixed_seed)
+            : jsl__rapidhash_withSeed(keys[i].data, length, seed);
+    }
+
+    return res;
+}
+
+JSL_HASH_DEF bool jsl_hash_many_fixed(
+    const void* keys,
+    int64_t key_size,
+    int64_t count,
+    uint64_t seed,
+    uint64_t* out_hashes
+)
+{
+    bool res = key_size > 0
+        && (count == 0 || (keys != NULL && out_hashes != NULL && count > 0))
+        && (count == 0 || key_size <= INT64_MAX / count);
+
+    const uint8_t* key = (const uint8_t*) keys;
+    size_t length = res ? (size_t) key_size : 0;
+
+    if (res && length <= 16)
+    {
+        uint64_t mixed_seed = jsl__hash_mix_seed(seed);
+
+        for (int64_t i = 0; i < count; ++i)
+        {
+            out_hashes[i] = jsl__hash_short(key, length, mixed_seed);
+            key += length;
+        }
+    }
+    else if (res)
+    {
+        for (int64_t i = 0; i < count; ++i)
+        {
+            out_hashes[i] = jsl__rapidhash_withSeed(key, length, seed);
+            key += length;
+        }
+    }
+
+    return res;
+}
+
+#if defined(JSL__HASH_AVX2)
+
+    /**
+     * Low 64 bits of a 64 by 64 bit multiply in each lane. AVX2 only has a
+     * 32 by 32 bit multiply so this is built out of three of them.
+     */
+    static JSL__FORCE_INLINE __m256i jsl__hash_mullo_u64x4(__m256i a, __m256i b, __m256i b_hi)
+    {
+        __m256i a_hi = _mm256_srli_epi64(a, 32);
+        __m256i low = _mm256_mul_epu32(a, b);
+        __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(a_hi, b), _mm256_mul_epu32(a, b_hi));
+        return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+    }
+
+    static int64_t jsl__hash_many_u64_lanes(
+        const uint64_t* keys,
+        int64_t count,
+        uint64_t seed,
+        uint64_t* out_hashes
+    )
+    {
+        const __m256i seed_lanes = _mm256_set1_epi64x((long long) seed);
+        const __m256i c1 = _mm256_set1_epi64x((long long) 0xff51afd7ed558ccdULL);
+        const __m256i c1_hi = _mm256_srli_epi64(c1, 32);
+        const __m256i c2 = _mm256_set1_epi64x((long long) 0xc4ceb9fe1a85ec53ULL);
+        const __m256i c2_hi = _mm256_srli_epi64(c2, 32);
+
+        int64_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m256i z = _mm256_loadu_si256((const __m256i*) (keys + i));
+            z = _mm256_xor_si256(z, seed_lanes);
+            z = _mm256_xor_si256(z, _mm256_srli_epi64(z, 33));
+            z = jsl__hash_mullo_u64x4(z, c1, c1_hi);
+            z = _mm256_xor_si256(z, _mm256_srli_epi64(z, 33));
+            z = jsl__hash_mullo_u64x4(z, c2, c2_hi);
+            z = _mm256_xor_si256(z, _mm256_srli_epi64(z, 33));
+            _mm256_storeu_si256((__m256i*) (out_hashes + i), z);
+        }
+
+        return i;
+    }
+
+#elif defined(JSL__HASH_NEON)
+
+    /**
+     * Low 64 bits of a 64 by 64 bit multiply in each lane. NEON has no 64
+     * bit lane multiply so this is built out of widening 32 bit ones.
+     */
+    static JSL__FORCE_INLINE uint64x2_t jsl__hash_mullo_u64x2(uint64x2_t a, uint32x2_t b_lo, uint32x2_t b_hi)
+    {
+        uint32x2_t a_lo = vmovn_u64(a);
+        uint32x2_t a_hi = vshrn_n_u64(a, 32);
+        uint64x2_t low = vmull_u32(a_lo, b_lo);
+        uint64x2_t cross = vmlal_u32(vmull_u32(a_hi, b_lo), a_lo, b_hi);
+        return vaddq_u64(low, vshlq_n_u64(cross, 32));
+    }
+
+    static int64_t jsl__hash_many_u64_lanes(
+        const uint64_t* keys,
+        int64_t count,
+        uint64_t seed,
+        uint64_t* out_hashes
+    )
+    {
+        const uint64x2_t seed_lanes = vdupq_n_u64(seed);
+        const uint32x2_t c1_lo = vdup_n_u32((uint32_t) 0xed558ccdU);
+        const uint32x2_t c1_hi = vdup_n_u32((uint32_t) 0xff51afd7U);
+        const uint32x2_t c2_lo = vdup_n_u32((uint32_t) 0x1a85ec53U);
+        const uint32x2_t c2_hi = vdup_n_u32((uint32_t) 0xc4ceb9feU);
+
+        int64_t i = 0;
+        for (; i + 2 <= count; i += 2)
+        {
+            uint64x2_t z = vld1q_u64(keys + i);
+            z = veorq_u64(z, seed_lanes);
+            z = veorq_u64(z, vshrq_n_u64(z, 33));
+            z = jsl__hash_mullo_u64x2(z, c1_lo, c1_hi);
+            z = veorq_u64(z, vshrq_n_u64(z, 33));
+            z = jsl__hash_mullo_u64x2(z, c2_lo, c2_hi);
+            z = veorq_u64(z, vshrq_n_u64(z, 33));
+            vst1q_u64(out_hashes + i, z);
+        }
+
+        return i;
+    }
+
+#else
+
+    static int64_t jsl__hash_many_u64_lanes(
+        const uint64_t* keys,
+        int64_t count,
+        uint64_t seed,
+        uint64_t* out_hashes
+    )
+    {
+        (void) keys;
+        (void) count;
+        (void) seed;
+        (void) out_hashes;
+        return 0;
+    }
+
+#endif
+
+JSL_HASH_DEF bool jsl_hash_many_u64(
+    const uint64_t* keys,
+    int64_t count,
+    uint64_t seed,
+    uint64_t* out_hashes
+)
+{
+    bool res = count == 0 || (keys != NULL && out_hashes != NULL && count > 0);
+
+    int64_t done = res && count > 0
+        ? jsl__hash_many_u64_lanes(keys, count, seed, out_hashes)
+        : 0;
+
+    for (int64_t i = done; res && i < count; ++i)
+    {
+        out_hashes[i] = jsl__murmur3_fmix_u64(keys[i], seed);
+    }
+
+    return res;
+}
+
+/**
+ * One step of the long input loop of `jsl__rapidhash_internal`.
+ */
+static void jsl__hash_stream_block(
+    uint64_t* lanes,
+    const uint8_t* p
+)
+{
+    const uint64_t* secret = jsl__rapid_secret;
+
+    lanes[0] = jsl__rapid_mix(jsl__rapid_read64(p) ^ secret[0], jsl__rapid_read64(p + 8) ^ lanes[0]);
+    lanes[1] = jsl__rapid_mix(jsl__rapid_read64(p + 16) ^ secret[1], jsl__rapid_read64(p + 24) ^ lanes[1]);
+    lanes[2] = jsl__rapid_mix(jsl__rapid_read64(p + 32) ^ secret[2], jsl__rapid_read64(p + 40) ^ lanes[2]);
+    lanes[3] = jsl__rapid_mix(jsl__rapid_read64(p + 48) ^ secret[3], jsl__rapid_read64(p + 56) ^ lanes[3]);
+    lanes[4] = jsl__rapid_mix(jsl__rapid_read64(p + 64) ^ secret[4], jsl__rapid_read64(p + 72) ^ lanes[4]);
+    lanes[5] = jsl__rapid_mix(jsl__rapid_read64(p + 80) ^ secret[5], jsl__rapid_read64(p + 88) ^ lanes[5]);
+    lanes[6] = jsl__rapid_mix(jsl__rapid_read64(p + 96) ^ secret[6], jsl__rapid_read64(p + 104) ^ lanes[6]);
+}
+
+JSL_HASH_DEF bool jsl_hash_stream_init(
+    JSLHashStream* stream,
+    uint64_t seed
+)
+{
+    bool res = stream != NULL;
+
+    if (res)
+    {
+        JSL_MEMSET(stream, 0, sizeof(JSLHashStream));
+        stream->seed = seed;
+
+        uint64_t mixed_seed = jsl__hash_mix_seed(seed);
+        for (int32_t i = 0; i < 7; ++i)
+        {
+            stream->lanes[i] = mixed_seed;
+        }
+
+        stream->sentinel = JSL__HASH_STREAM_PRIVATE_SENTINEL;
+    }
+
+    return res;
+}
+
+JSL_HASH_DEF bool jsl_hash_stream_update(
+    JSLHashStream* stream,
+    JSLImmutableMemory data
+)
+{
+    bool res = (
+        stream != NULL
+        && stream->sentinel == JSL__HASH_STREAM_PRIVATE_SENTINEL
+        && (data.length == 0 || (data.data != NULL && data.length > 0))
+    );
+
+    const uint8_t* p = data.data;
+    int64_t remaining = res ? data.length : 0;
+
+    if (res)
+    {
+        stream->total_length += remaining;
+    }
+
+    while (remaining > 0)
+    {
+        // A full block is only hashed once it's known that more input
+        // follows, the final block goes through the tail code in finish
+        if (stream->buffered == JSL__HASH_STREAM_BLOCK_SIZE)
+        {
+            uint8_t* block = stream->buffer + JSL__HASH_STREAM_HISTORY_SIZE;
+            jsl__hash_stream_block(stream->lanes, block);
+
+            JSL_MEMCPY(
+                stream->buffer,
+                block + JSL__HASH_STREAM_BLOCK_SIZE - JSL__HASH_STREAM_HISTORY_SIZE,
+                JSL__HASH_STREAM_HISTORY_SIZE
+            );
+            stream->buffered = 0;
+        }
+
+        int64_t space = JSL__HASH_STREAM_BLOCK_SIZE - stream->buffered;
+        int64_t take = JSL_MIN(space, remaining);
+
+        JSL_MEMCPY(
+            stream->buffer + JSL__HASH_STREAM_HISTORY_SIZE + stream->buffered,
+            p,
+            (size_t) take
+        );
+
+        stream->buffered += take;
+        p += take;
+        remaining -= take;
+    }
+
+    return res;
+}
+
+JSL_HASH_DEF uint64_t jsl_hash_stream_finish(
+    const JSLHashStream* stream
+)
+{
+    bool params_valid = (
+        stream != NULL
+        && stream->sentinel == JSL__HASH_STREAM_PRIVATE_SENTINEL
+    );
+
+    if (!params_valid)
+        return 0;
+
+    const uint8_t* p = stream->buffer + JSL__HASH_STREAM_HISTORY_SIZE;
+
+    // No block was hashed yet so everything is still in the buffer
+    if (stream->total_length <= JSL__HASH_STREAM_BLOCK_SIZE)
+        return jsl__rapidhash_withSeed(p, (size_t) stream->buffered, stream->seed);
+
+    const uint64_t* secret = jsl__rapid_secret;
+    uint64_t seed = stream->lanes[0];
+    uint64_t see2 = stream->lanes[2];
+    uint64_t see4 = stream->lanes[4];
+
+    seed ^= stream->lanes[1];
+    see2 ^= stream->lanes[3];
+    see4 ^= stream->lanes[5];
+    seed ^= stream->lanes[6];
+    see2 ^= see4;
+    seed ^= see2;
+
+    // From here on this is the tail of jsl__rapidhash_internal. The last
+    // 16 byte read may reach back into the history bytes.
+    size_t i = (size_t) stream->buffered;
+
+    if (i > 16)
+    {
+        seed = jsl__rapid_mix(jsl__rapid_read64(p) ^ secret[2], jsl__rapid_read64(p + 8) ^ seed);
+        if (i > 32)
+        {
+            seed = jsl__rapid_mix(jsl__rapid_read64(p + 16) ^ secret[2], jsl__rapid_read64(p + 24) ^ seed);
+            if (i > 48)
+            {
+                seed = jsl__rapid_mix(jsl__rapid_read64(p + 32) ^ secret[1], jsl__rapid_read64(p + 40) ^ seed);
+                if (i > 64)
+                {
+                    seed = jsl__rapid_mix(jsl__rapid_read64(p + 48) ^ secret[1], jsl__rapid_read64(p + 56) ^ seed);
+                    if (i > 80)
+                    {
+                        seed = jsl__rapid_mix(jsl__rapid_read64(p + 64) ^ secret[2], jsl__rapid_read64(p + 72) ^ seed);
+                        if (i > 96)
+                        {
+                            seed = jsl__rapid_mix(jsl__rapid_read64(p + 80) ^ secret[1], jsl__rapid_read64(p + 88) ^ seed);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    uint64_t a = jsl__rapid_read64(p + i - 16) ^ i;
+    uint64_t b = jsl__rapid_read64(p + i - 8);
+
+    a ^= secret[1];
+    b ^= seed;
+    jsl__rapid_mum(&a, &b);
+    return jsl__rapid_mix(a ^ secret[7], b ^ secret[1] ^ i);
+}
+
+static void jsl__hash_stream_output_sink_write(void* user, JSLImmutableMemory data)
+{
+    jsl_hash_stream_update((JSLHashStream*) user, data);
+}
+
+JSL_HASH_DEF JSLOutputSink jsl_hash_stream_output_sink(
+    JSLHashStream* stream
+)
+{
+    JSLOutputSink sink;
+    sink.write_fp = jsl__hash_stream_output_sink_write;
+    sink.user_data = stream;
+    return sink;
+}
+
+#undef JSL__HASH_STREAM_PRIVATE_SENTINEL
+#ifdef JSL__HASH_AVX2
+    #undef JSL__HASH_AVX2
+#endif
+#ifdef JSL__HASH_NEON
+    #undef JSL__HASH_NEON
+#endif
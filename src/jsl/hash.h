@@ -0,0 +1,340 @@
+/**
+ * # JSL Hashing
+ *
+ * This file exposes the hash functions used by the containers in this
+ * library as a public API, including batched versions for hashing many
+ * keys at once and a streaming hasher for data which arrives in pieces.
+ * This file is part of the Jack's Standard Library project.
+ *
+ * ## Documentation
+ *
+ * See `docs/jsl_hash.md` for a formatted documentation page.
+ *
+ * ## Design
+ *
+ * Byte strings are hashed with rapidhash and 64 bit integers with the
+ * MurmurHash3 finalizer. These are the same functions with the same seeding
+ * as the string containers and the generated hash maps, so a hash computed
+ * here matches the hash the container computes for the same key and seed.
+ *
+ * The batch functions produce exactly the same results as calling the single
+ * key functions in a loop. `jsl_hash_many` and `jsl_hash_many_fixed` mix the
+ * seed once for the whole batch instead of once per key, which is a third
+ * of the work for keys of 16 bytes or less. `jsl_hash_many_u64` hashes four
+ * keys per instruction when compiled with AVX2, or two with NEON.
+ *
+ * The streaming hasher gives the same result as `jsl_hash_bytes` over the
+ * concatenation of every chunk, no matter how the data was split up.
+ *
+ * The CRC32C and AES functions are much cheaper than rapidhash for short
+ * keys. They use the `crc32` and `aesenc` instructions on x86 and ARM when
+ * the compiler targets them, and a table driven version otherwise which
+ * gives the same results. These are the hashes generated hash maps use when
+ * created with `--hash=crc32c` or `--hash=aes`.
+ *
+ * ## Caveats
+ *
+ * None of these functions are suitable for cryptographic use.
+ *
+ * The vectorized integer path is selected at compile time, pass `-mavx2`,
+ * `-march=native`, or `/arch:AVX2` to get it on x86.
+ *
+ * The CRC32C and AES hashes are linear or close to it, so someone who
+ * controls the keys can easily make them collide. Only use them for keys
+ * you trust. The instructions are also selected at compile time, pass
+ * `-msse4.2 -maes` or `-march=native` on x86 and `-march=armv8-a+crc+crypto`
+ * on ARM, the fallbacks are several times slower than rapidhash.
+ *
+ * ## License
+ *
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L
+    #include <stdbool.h>
+#endif
+
+#include "core.h"
+
+/* Versioning to catch mismatches across deps */
+#ifndef JSL_HASH_VERSION
+    #define JSL_HASH_VERSION 0x010000  /* 1.0.0 */
+#else
+    #if JSL_HASH_VERSION != 0x010000
+        #error "hash.h version mismatch across includes"
+    #endif
+#endif
+
+#ifndef JSL_HASH_DEF
+    #define JSL_HASH_DEF
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// @brief Bytes consumed by each step of the long input loop of rapidhash
+#define JSL__HASH_STREAM_BLOCK_SIZE 112
+/// @brief Bytes of already hashed input the final step may read back into
+#define JSL__HASH_STREAM_HISTORY_SIZE 16
+
+struct JSL__HashStream
+{
+    // putting the sentinel first means it's much more likely to get
+    // corrupted from accidental overwrites, therefore making it
+    // more likely that memory bugs are caught.
+    uint64_t sentinel;
+
+    uint64_t seed;
+    /// @brief the seven accumulators of the long input loop
+    uint64_t lanes[7];
+
+    int64_t total_length;
+    /// @brief bytes waiting in `buffer` after the history bytes
+    int64_t buffered;
+
+    /// @brief the last 16 bytes of the previous block followed by up to one block of pending input
+    uint8_t buffer[JSL__HASH_STREAM_HISTORY_SIZE + JSL__HASH_STREAM_BLOCK_SIZE];
+};
+
+/**
+ * Incrementally hashes data which arrives in chunks, such as file reads or
+ * formatted output. Only one block of input is buffered at a time, so the
+ * whole input never has to be in memory.
+ *
+ * Example:
+ *
+ * ```
+ * JSLHashStream stream;
+ * jsl_hash_stream_init(&stream, 0);
+ *
+ * jsl_hash_stream_update(&stream, JSL_CSTR_EXPRESSION("hello "));
+ * jsl_hash_stream_update(&stream, JSL_CSTR_EXPRESSION("world"));
+ *
+ * // same as jsl_hash_bytes(JSL_CSTR_EXPRESSION("hello world"), 0)
+ * uint64_t hash = jsl_hash_stream_finish(&stream);
+ * ```
+ *
+ * ## Functions
+ *
+ * * jsl_hash_stream_init
+ * * jsl_hash_stream_update
+ * * jsl_hash_stream_finish
+ * * jsl_hash_stream_output_sink
+ */
+typedef struct JSL__HashStream JSLHashStream;
+
+/**
+ * Hash a buffer of bytes. This is the hash the string containers use for
+ * their keys, so the result is equal to the container's own hash when given
+ * the same seed.
+ *
+ * @param data Bytes to hash, a negative length is treated as empty.
+ * @param seed Arbitrary seed value.
+ * @return The 64 bit hash.
+ */
+JSL_HASH_DEF uint64_t jsl_hash_bytes(
+    JSLImmutableMemory data,
+    uint64_t seed
+);
+
+/**
+ * Hash a 64 bit integer. This is the hash the generated hash maps use for
+ * integer keys.
+ *
+ * @param value Integer to hash.
+ * @param seed Arbitrary seed value.
+ * @return The 64 bit hash.
+ */
+JSL_HASH_DEF uint64_t jsl_hash_u64(
+    uint64_t value,
+    uint64_t seed
+);
+
+/**
+ * Hash a 64 bit integer with the CRC32C instruction. For a given seed
+ * distinct integers always give distinct hashes.
+ *
+ * @param value Integer to hash.
+ * @param seed Arbitrary seed value.
+ * @return The 64 bit hash.
+ */
+JSL_HASH_DEF uint64_t jsl_hash_crc32c_u64(
+    uint64_t value,
+    uint64_t seed
+);
+
+/**
+ * Hash a buffer of bytes with the CRC32C instruction.
+ *
+ * @param data Bytes to hash, a negative length is treated as empty.
+ * @param seed Arbitrary seed value.
+ * @return The 64 bit hash.
+ */
+JSL_HASH_DEF uint64_t jsl_hash_crc32c_bytes(
+    JSLImmutableMemory data,
+    uint64_t seed
+);
+
+/**
+ * Hash a 64 bit integer with two AES rounds.
+ *
+ * @param value Integer to hash.
+ * @param seed Arbitrary seed value.
+ * @return The 64 bit hash.
+ */
+JSL_HASH_DEF uint64_t jsl_hash_aes_u64(
+    uint64_t value,
+    uint64_t seed
+);
+
+/**
+ * Hash a buffer of bytes with one AES round per 16 bytes of input plus two
+ * to finish.
+ *
+ * @param data Bytes to hash, a negative length is treated as empty.
+ * @param seed Arbitrary seed value.
+ * @return The 64 bit hash.
+ */
+JSL_HASH_DEF uint64_t jsl_hash_aes_bytes(
+    JSLImmutableMemory data,
+    uint64_t seed
+);
+
+/**
+ * Hash every buffer in an array of fat pointers. `out_hashes[i]` is set to
+ * `jsl_hash_bytes(keys[i], seed)`.
+ *
+ * @param keys Buffers to hash, every one must have non-NULL data or zero length.
+ * @param count Number of keys.
+ * @param seed Arbitrary seed value.
+ * @param out_hashes Output array with room for `count` hashes.
+ * @return `true` on success, `false` on invalid parameters.
+ */
+JSL_HASH_DEF bool jsl_hash_many(
+    const JSLImmutableMemory* keys,
+    int64_t count,
+    uint64_t seed,
+    uint64_t* out_hashes
+);
+
+/**
+ * Hash every element of an array of fixed width keys, such as an array of
+ * structs. `out_hashes[i]` is set to the hash of the `key_size` bytes at
+ * `keys + i * key_size`. This is the hash the generated hash maps use for
+ * non integer keys.
+ *
+ * @param keys Start of the key array.
+ * @param key_size Size of each key in bytes.
+ * @param count Number of keys.
+ * @param seed Arbitrary seed value.
+ * @param out_hashes Output array with room for `count` hashes.
+ * @return `true` on success, `false` on invalid parameters.
+ */
+JSL_HASH_DEF bool jsl_hash_many_fixed(
+    const void* keys,
+    int64_t key_size,
+    int64_t count,
+    uint64_t seed,
+    uint64_t* out_hashes
+);
+
+/**
+ * Hash every integer in an array. `out_hashes[i]` is set to
+ * `jsl_hash_u64(keys[i], seed)`. Uses vector lanes when compiled with AVX2
+ * or NEON support.
+ *
+ * @param keys Integers to hash.
+ * @param count Number of keys.
+ * @param seed Arbitrary seed value.
+ * @param out_hashes Output array with room for `count` hashes, may be the same as `keys`.
+ * @return `true` on success, `false` on invalid parameters.
+ */
+JSL_HASH_DEF bool jsl_hash_many_u64(
+    const uint64_t* keys,
+    int64_t count,
+    uint64_t seed,
+    uint64_t* out_hashes
+);
+
+/**
+ * Start a new streaming hash.
+ *
+ * @param stream Stream to initialize.
+ * @param seed Arbitrary seed value.
+ * @return `true` on success, `false` if `stream` is NULL.
+ */
+JSL_HASH_DEF bool jsl_hash_stream_init(
+    JSLHashStream* stream,
+    uint64_t seed
+);
+
+/**
+ * Feed the next chunk of data into the stream.
+ *
+ * @param stream Initialized stream.
+ * @param data Next chunk, may be empty.
+ * @return `true` on success, `false` on invalid parameters.
+ */
+JSL_HASH_DEF bool jsl_hash_stream_update(
+    JSLHashStream* stream,
+    JSLImmutableMemory data
+);
+
+/**
+ * Get the hash of everything fed into the stream so far. The stream is not
+ * modified, so more data can still be added afterwards.
+ *
+ * @param stream Initialized stream.
+ * @return The same hash `jsl_hash_bytes` gives for all the data at once,
+ * or zero on invalid parameters.
+ */
+JSL_HASH_DEF uint64_t jsl_hash_stream_finish(
+    const JSLHashStream* stream
+);
+
+/**
+ * Get an output sink which feeds everything written to it into the stream.
+ * Use this to hash formatted output without building it in memory first.
+ *
+ * Example:
+ *
+ * ```
+ * JSLHashStream stream;
+ * jsl_hash_stream_init(&stream, 0);
+ *
+ * jsl_format_sink(jsl_hash_stream_output_sink(&stream), JSL_CSTR_EXPRESSION("%d-%d"), a, b);
+ * uint64_t hash = jsl_hash_stream_finish(&stream);
+ * ```
+ *
+ * @param stream Initialized stream, must outlive the sink.
+ * @return The sink.
+ */
+JSL_HASH_DEF JSLOutputSink jsl_hash_stream_output_sink(
+    JSLHashStream* stream
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -294,9 +294,436 @@ RAPIDHASH_INLINE_CONSTEXPR uint64_t jsl__rapidhash_withSeed(
     return jsl__rapidhash_internal(key, len, seed, jsl__rapid_secret);
 }
 
+/*
+*  Hardware accelerated hashes for trusted keys.
+*
+*  These give up the flood resistance of rapidhash in exchange for a handful
+*  of cycles per key using the CRC32C and AES instructions. Each one has a
+*  portable version which gives bit identical results, so a hash computed on
+*  a machine without the instructions matches one computed with them.
+*/
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__SSE4_2__) || (defined(_MSC_VER) && defined(__AVX__)))
+    #include <nmmintrin.h>
+    #define JSL__CRC32C_X86 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+    #include <arm_acle.h>
+    #define JSL__CRC32C_ARM 1
+#endif
+
+#if (defined(__x86_64__) || defined(_M_X64)) && defined(__AES__)
+    #include <wmmintrin.h>
+    #define JSL__AES_X86 1
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO))
+    #include <arm_neon.h>
+    #define JSL__AES_ARM 1
+#endif
+
+#if !defined(JSL__CRC32C_X86) && !defined(JSL__CRC32C_ARM)
+// Reflected Castagnoli polynomial 0x82F63B78, one entry per input byte
+static const uint32_t jsl__crc32c_table[256] = {
+    0x00000000U, 0xf26b8303U, 0xe13b70f7U, 0x1350f3f4U, 0xc79a971fU, 0x35f1141cU,
+    0x26a1e7e8U, 0xd4ca64ebU, 0x8ad958cfU, 0x78b2dbccU, 0x6be22838U, 0x9989ab3bU,
+    0x4d43cfd0U, 0xbf284cd3U, 0xac78bf27U, 0x5e133c24U, 0x105ec76fU, 0xe235446cU,
+    0xf165b798U, 0x030e349bU, 0xd7c45070U, 0x25afd373U, 0x36ff2087U, 0xc494a384U,
+    0x9a879fa0U, 0x68ec1ca3U, 0x7bbcef57U, 0x89d76c54U, 0x5d1d08bfU, 0xaf768bbcU,
+    0xbc267848U, 0x4e4dfb4bU, 0x20bd8edeU, 0xd2d60dddU, 0xc186fe29U, 0x33ed7d2aU,
+    0xe72719c1U, 0x154c9ac2U, 0x061c6936U, 0xf477ea35U, 0xaa64d611U, 0x580f5512U,
+    0x4b5fa6e6U, 0xb93425e5U, 0x6dfe410eU, 0x9f95c20dU, 0x8cc531f9U, 0x7eaeb2faU,
+    0x30e349b1U, 0xc288cab2U, 0xd1d83946U, 0x23b3ba45U, 0xf779deaeU, 0x05125dadU,
+    0x1642ae59U, 0xe4292d5aU, 0xba3a117eU, 0x4851927dU, 0x5b016189U, 0xa96ae28aU,
+    0x7da08661U, 0x8fcb0562U, 0x9c9bf696U, 0x6ef07595U, 0x417b1dbcU, 0xb3109ebfU,
+    0xa0406d4bU, 0x522bee48U, 0x86e18aa3U, 0x748a09a0U, 0x67dafa54U, 0x95b17957U,
+    0xcba24573U, 0x39c9c670U, 0x2a993584U, 0xd8f2b687U, 0x0c38d26cU, 0xfe53516fU,
+    0xed03a29bU, 0x1f682198U, 0x5125dad3U, 0xa34e59d0U, 0xb01eaa24U, 0x42752927U,
+    0x96bf4dccU, 0x64d4cecfU, 0x77843d3bU, 0x85efbe38U, 0xdbfc821cU, 0x2997011fU,
+    0x3ac7f2ebU, 0xc8ac71e8U, 0x1c661503U, 0xee0d9600U, 0xfd5d65f4U, 0x0f36e6f7U,
+    0x61c69362U, 0x93ad1061U, 0x80fde395U, 0x72966096U, 0xa65c047dU, 0x5437877eU,
+    0x4767748aU, 0xb50cf789U, 0xeb1fcbadU, 0x197448aeU, 0x0a24bb5aU, 0xf84f3859U,
+    0x2c855cb2U, 0xdeeedfb1U, 0xcdbe2c45U, 0x3fd5af46U, 0x7198540dU, 0x83f3d70eU,
+    0x90a324faU, 0x62c8a7f9U, 0xb602c312U, 0x44694011U, 0x5739b3e5U, 0xa55230e6U,
+    0xfb410cc2U, 0x092a8fc1U, 0x1a7a7c35U, 0xe811ff36U, 0x3cdb9bddU, 0xceb018deU,
+    0xdde0eb2aU, 0x2f8b6829U, 0x82f63b78U, 0x709db87bU, 0x63cd4b8fU, 0x91a6c88cU,
+    0x456cac67U, 0xb7072f64U, 0xa457dc90U, 0x563c5f93U, 0x082f63b7U, 0xfa44e0b4U,
+    0xe9141340U, 0x1b7f9043U, 0xcfb5f4a8U, 0x3dde77abU, 0x2e8e845fU, 0xdce5075cU,
+    0x92a8fc17U, 0x60c37f14U, 0x73938ce0U, 0x81f80fe3U, 0x55326b08U, 0xa759e80bU,
+    0xb4091bffU, 0x466298fcU, 0x1871a4d8U, 0xea1a27dbU, 0xf94ad42fU, 0x0b21572cU,
+    0xdfeb33c7U, 0x2d80b0c4U, 0x3ed04330U, 0xccbbc033U, 0xa24bb5a6U, 0x502036a5U,
+    0x4370c551U, 0xb11b4652U, 0x65d122b9U, 0x97baa1baU, 0x84ea524eU, 0x7681d14dU,
+    0x2892ed69U, 0xdaf96e6aU, 0xc9a99d9eU, 0x3bc21e9dU, 0xef087a76U, 0x1d63f975U,
+    0x0e330a81U, 0xfc588982U, 0xb21572c9U, 0x407ef1caU, 0x532e023eU, 0xa145813dU,
+    0x758fe5d6U, 0x87e466d5U, 0x94b49521U, 0x66df1622U, 0x38cc2a06U, 0xcaa7a905U,
+    0xd9f75af1U, 0x2b9cd9f2U, 0xff56bd19U, 0x0d3d3e1aU, 0x1e6dcdeeU, 0xec064eedU,
+    0xc38d26c4U, 0x31e6a5c7U, 0x22b65633U, 0xd0ddd530U, 0x0417b1dbU, 0xf67c32d8U,
+    0xe52cc12cU, 0x1747422fU, 0x49547e0bU, 0xbb3ffd08U, 0xa86f0efcU, 0x5a048dffU,
+    0x8ecee914U, 0x7ca56a17U, 0x6ff599e3U, 0x9d9e1ae0U, 0xd3d3e1abU, 0x21b862a8U,
+    0x32e8915cU, 0xc083125fU, 0x144976b4U, 0xe622f5b7U, 0xf5720643U, 0x07198540U,
+    0x590ab964U, 0xab613a67U, 0xb831c993U, 0x4a5a4a90U, 0x9e902e7bU, 0x6cfbad78U,
+    0x7fab5e8cU, 0x8dc0dd8fU, 0xe330a81aU, 0x115b2b19U, 0x020bd8edU, 0xf0605beeU,
+    0x24aa3f05U, 0xd6c1bc06U, 0xc5914ff2U, 0x37faccf1U, 0x69e9f0d5U, 0x9b8273d6U,
+    0x88d28022U, 0x7ab90321U, 0xae7367caU, 0x5c18e4c9U, 0x4f48173dU, 0xbd23943eU,
+    0xf36e6f75U, 0x0105ec76U, 0x12551f82U, 0xe03e9c81U, 0x34f4f86aU, 0xc69f7b69U,
+    0xd5cf889dU, 0x27a40b9eU, 0x79b737baU, 0x8bdcb4b9U, 0x988c474dU, 0x6ae7c44eU,
+    0xbe2da0a5U, 0x4c4623a6U, 0x5f16d052U, 0xad7d5351U,
+};
+#endif
+
+/*
+*  Update a CRC32C with the eight little endian bytes of value. There's no
+*  pre or post inversion, this matches the raw crc32 instruction.
+*/
+static inline uint32_t jsl__crc32c_step(uint32_t crc, uint64_t value)
+{
+    #if defined(JSL__CRC32C_X86)
+        return (uint32_t) _mm_crc32_u64(crc, value);
+    #elif defined(JSL__CRC32C_ARM)
+        return __crc32cd(crc, value);
+    #else
+        for (int32_t i = 0; i < 8; ++i)
+        {
+            crc = jsl__crc32c_table[(crc ^ (uint32_t) value) & 0xFFU] ^ (crc >> 8);
+            value >>= 8;
+        }
+        return crc;
+    #endif
+}
+
+/*
+*  Hash a 64 bit integer with two CRC32C steps. The low half covers the
+*  whole integer and the high half only its upper word, which together make
+*  the hash a bijection for a given seed, so distinct keys never collide.
+*/
+static inline uint64_t jsl__crc32c_u64(uint64_t x, uint64_t seed)
+{
+    uint32_t lo = jsl__crc32c_step((uint32_t) seed, x);
+    uint32_t hi = jsl__crc32c_step((uint32_t) (seed >> 32), x >> 32);
+    return ((uint64_t) hi << 32) | lo;
+}
+
+static inline uint64_t jsl__crc32c_bytes(const void* key, size_t len, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*) key;
+    uint64_t start = seed ^ (uint64_t) len;
+    uint32_t lo = (uint32_t) start;
+    uint32_t hi = (uint32_t) (start >> 32);
+
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8)
+    {
+        uint64_t word = jsl__rapid_read64(p + i);
+        lo = jsl__crc32c_step(lo, word);
+        hi = jsl__crc32c_step(hi, (word >> 32) | (word << 32));
+    }
+
+    if (i < len)
+    {
+        uint8_t tail[8] = {0};
+        JSL_MEMCPY(tail, p + i, len - i);
+        uint64_t word = jsl__rapid_read64(tail);
+        lo = jsl__crc32c_step(lo, word);
+        hi = jsl__crc32c_step(hi, (word >> 32) | (word << 32));
+    }
+
+    return ((uint64_t) hi << 32) | lo;
+}
+
+/*
+*  One AES encryption round (ShiftRows, SubBytes, MixColumns, xor round key),
+*  the same as x86's aesenc. Two rounds are enough for every output byte to
+*  depend on every input byte.
+*/
+#if defined(JSL__AES_X86)
+
+typedef __m128i JSL__AesBlock;
+
+static inline JSL__AesBlock jsl__aes_load(uint64_t lo, uint64_t hi)
+{
+    return _mm_set_epi64x((long long) hi, (long long) lo);
+}
+
+static inline JSL__AesBlock jsl__aes_xor(JSL__AesBlock a, JSL__AesBlock b)
+{
+    return _mm_xor_si128(a, b);
+}
+
+static inline JSL__AesBlock jsl__aes_round(JSL__AesBlock state, JSL__AesBlock key)
+{
+    return _mm_aesenc_si128(state, key);
+}
+
+static inline uint64_t jsl__aes_fold(JSL__AesBlock state)
+{
+    return (uint64_t) _mm_cvtsi128_si64(state)
+        ^ (uint64_t) _mm_cvtsi128_si64(_mm_unpackhi_epi64(state, state));
+}
+
+#elif defined(JSL__AES_ARM)
+
+typedef uint8x16_t JSL__AesBlock;
+
+static inline JSL__AesBlock jsl__aes_load(uint64_t lo, uint64_t hi)
+{
+    return vreinterpretq_u8_u64(vcombine_u64(vcreate_u64(lo), vcreate_u64(hi)));
+}
+
+static inline JSL__AesBlock jsl__aes_xor(JSL__AesBlock a, JSL__AesBlock b)
+{
+    return veorq_u8(a, b);
+}
+
+static inline JSL__AesBlock jsl__aes_round(JSL__AesBlock state, JSL__AesBlock key)
+{
+    // aese xors the key before the substitution, so give it zero and xor after
+    return veorq_u8(vaesmcq_u8(vaeseq_u8(state, vdupq_n_u8(0))), key);
+}
+
+static inline uint64_t jsl__aes_fold(JSL__AesBlock state)
+{
+    uint64x2_t lanes = vreinterpretq_u64_u8(state);
+    return vgetq_lane_u64(lanes, 0) ^ vgetq_lane_u64(lanes, 1);
+}
+
+#else
+
+typedef struct { uint8_t bytes[16]; } JSL__AesBlock;
+
+static const uint8_t jsl__aes_sbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+
+static inline JSL__AesBlock jsl__aes_load(uint64_t lo, uint64_t hi)
+{
+    JSL__AesBlock block;
+    for (int32_t i = 0; i < 8; ++i)
+    {
+        block.bytes[i] = (uint8_t) (lo >> (8 * i));
+        block.bytes[i + 8] = (uint8_t) (hi >> (8 * i));
+    }
+    return block;
+}
+
+static inline JSL__AesBlock jsl__aes_xor(JSL__AesBlock a, JSL__AesBlock b)
+{
+    for (int32_t i = 0; i < 16; ++i)
+        a.bytes[i] ^= b.bytes[i];
+    return a;
+}
+
+static inline uint8_t jsl__aes_xtime(uint8_t x)
+{
+    return (uint8_t) ((x << 1) ^ ((x >> 7) * 0x1B));
+}
+
+static inline JSL__AesBlock jsl__aes_round(JSL__AesBlock state, JSL__AesBlock key)
+{
+    JSL__AesBlock out;
+
+    // The state is column major, row r of column c is byte r + 4c
+    for (int32_t c = 0; c < 4; ++c)
+    {
+        uint8_t a0 = jsl__aes_sbox[state.bytes[0 + 4 * c]];
+        uint8_t a1 = jsl__aes_sbox[state.bytes[1 + 4 * ((c + 1) & 3)]];
+        uint8_t a2 = jsl__aes_sbox[state.bytes[2 + 4 * ((c + 2) & 3)]];
+        uint8_t a3 = jsl__aes_sbox[state.bytes[3 + 4 * ((c + 3) & 3)]];
+        uint8_t all = (uint8_t) (a0 ^ a1 ^ a2 ^ a3);
+
+        out.bytes[0 + 4 * c] = (uint8_t) (a0 ^ all ^ jsl__aes_xtime((uint8_t) (a0 ^ a1)) ^ key.bytes[0 + 4 * c]);
+        out.bytes[1 + 4 * c] = (uint8_t) (a1 ^ all ^ jsl__aes_xtime((uint8_t) (a1 ^ a2)) ^ key.bytes[1 + 4 * c]);
+        out.bytes[2 + 4 * c] = (uint8_t) (a2 ^ all ^ jsl__aes_xtime((uint8_t) (a2 ^ a3)) ^ key.bytes[2 + 4 * c]);
+        out.bytes[3 + 4 * c] = (uint8_t) (a3 ^ all ^ jsl__aes_xtime((uint8_t) (a3 ^ a0)) ^ key.bytes[3 + 4 * c]);
+    }
+
+    return out;
+}
+
+static inline uint64_t jsl__aes_fold(JSL__AesBlock state)
+{
+    uint64_t folded = 0;
+    for (int32_t i = 0; i < 8; ++i)
+        folded |= (uint64_t) (state.bytes[i] ^ state.bytes[i + 8]) << (8 * i);
+    return folded;
+}
+
+#endif
+
+static inline uint64_t jsl__aes_u64(uint64_t x, uint64_t seed)
+{
+    JSL__AesBlock key0 = jsl__aes_load(seed ^ jsl__rapid_secret[0], jsl__rapid_secret[1]);
+    JSL__AesBlock key1 = jsl__aes_load(jsl__rapid_secret[2], seed ^ jsl__rapid_secret[3]);
+
+    JSL__AesBlock state = jsl__aes_load(x, seed);
+    state = jsl__aes_round(state, key0);
+    state = jsl__aes_round(state, key1);
+    return jsl__aes_fold(state);
+}
+
+static inline uint64_t jsl__aes_bytes(const void* key, size_t len, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*) key;
+    JSL__AesBlock key0 = jsl__aes_load(seed ^ jsl__rapid_secret[0], jsl__rapid_secret[1]);
+    JSL__AesBlock key1 = jsl__aes_load(jsl__rapid_secret[2], seed ^ jsl__rapid_secret[3]);
+
+    JSL__AesBlock state = jsl__aes_load(seed ^ (uint64_t) len, seed);
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        JSL__AesBlock block = jsl__aes_load(jsl__rapid_read64(p + i), jsl__rapid_read64(p + i + 8));
+        state = jsl__aes_round(jsl__aes_xor(state, block), key0);
+    }
+
+    if (i < len)
+    {
+        uint8_t tail[16] = {0};
+        JSL_MEMCPY(tail, p + i, len - i);
+        JSL__AesBlock block = jsl__aes_load(jsl__rapid_read64(tail), jsl__rapid_read64(tail + 8));
+        state = jsl__aes_round(jsl__aes_xor(state, block), key0);
+    }
+
+    state = jsl__aes_round(state, key1);
+    state = jsl__aes_round(state, key0);
+    return jsl__aes_fold(state);
+}
+
+#ifdef JSL__CRC32C_X86
+    #undef JSL__CRC32C_X86
+#endif
+#ifdef JSL__CRC32C_ARM
+    #undef JSL__CRC32C_ARM
+#endif
+#ifdef JSL__AES_X86
+    #undef JSL__AES_X86
+#endif
+#ifdef JSL__AES_ARM
+    #undef JSL__AES_ARM
+#endif
+
 enum JSL__ProbeState
 {
     JSL__HASHMAP_EMPTY = 0,
     JSL__HASHMAP_TOMBSTONE = 1,
     JSL__HASHMAP_VALUE_OK
 };
+
+/*
+*  Control bytes for generated maps built with --control-bytes.
+*
+*  Each slot has one byte which is either JSL__HASHMAP_CONTROL_EMPTY or the
+*  low seven bits of the slot's hash. A whole group of these is compared
+*  against the tag of the key being searched for in a couple of instructions,
+*  so most lookups only ever touch one key. The group functions return a mask
+*  with one set bit per matching slot, `jsl__hash_map_group_lane` turns the
+*  lowest set bit back into an offset from the start of the group.
+*
+*  The group is 32 bytes with AVX2, 16 with SSE2, NEON, or wasm SIMD, and
+*  8 bytes packed into a uint64_t everywhere else.
+*/
+
+#define JSL__HASHMAP_CONTROL_EMPTY 0x80
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define JSL__GROUP_AVX2 1
+    #define JSL__HASHMAP_GROUP_WIDTH 32
+    #define JSL__HASHMAP_GROUP_LANE_SHIFT 0
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define JSL__GROUP_SSE2 1
+    #define JSL__HASHMAP_GROUP_WIDTH 16
+    #define JSL__HASHMAP_GROUP_LANE_SHIFT 0
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define JSL__GROUP_NEON 1
+    #define JSL__HASHMAP_GROUP_WIDTH 16
+    // NEON has no movemask, narrowing the compare gives four bits per lane
+    #define JSL__HASHMAP_GROUP_LANE_SHIFT 2
+#elif defined(__wasm_simd128__)
+    #include <wasm_simd128.h>
+    #define JSL__GROUP_WASM 1
+    #define JSL__HASHMAP_GROUP_WIDTH 16
+    #define JSL__HASHMAP_GROUP_LANE_SHIFT 0
+#else
+    #define JSL__HASHMAP_GROUP_WIDTH 8
+    #define JSL__HASHMAP_GROUP_LANE_SHIFT 3
+#endif
+
+/*
+*  Slots in the group starting at `control` whose control byte equals `tag`.
+*  The portable version may also report a slot right after a real match,
+*  which is harmless as every candidate's key gets compared anyway.
+*/
+static inline uint64_t jsl__hash_map_group_match(const uint8_t* control, uint8_t tag)
+{
+    #if defined(JSL__GROUP_AVX2)
+        __m256i group = _mm256_loadu_si256((const __m256i*) control);
+        __m256i equal = _mm256_cmpeq_epi8(group, _mm256_set1_epi8((char) tag));
+        return (uint32_t) _mm256_movemask_epi8(equal);
+    #elif defined(JSL__GROUP_SSE2)
+        __m128i group = _mm_loadu_si128((const __m128i*) control);
+        __m128i equal = _mm_cmpeq_epi8(group, _mm_set1_epi8((char) tag));
+        return (uint32_t) _mm_movemask_epi8(equal);
+    #elif defined(JSL__GROUP_NEON)
+        uint8x16_t equal = vceqq_u8(vld1q_u8(control), vdupq_n_u8(tag));
+        uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(equal), 4);
+        return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ULL;
+    #elif defined(JSL__GROUP_WASM)
+        v128_t equal = wasm_i8x16_eq(wasm_v128_load(control), wasm_i8x16_splat((int8_t) tag));
+        return (uint32_t) wasm_i8x16_bitmask(equal);
+    #else
+        uint64_t x = jsl__rapid_read64(control) ^ (0x0101010101010101ULL * tag);
+        return (x - 0x0101010101010101ULL) & ~x & 0x8080808080808080ULL;
+    #endif
+}
+
+/*
+*  Slots in the group starting at `control` which are empty.
+*/
+static inline uint64_t jsl__hash_map_group_match_empty(const uint8_t* control)
+{
+    #if defined(JSL__GROUP_AVX2)
+        return (uint32_t) _mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*) control));
+    #elif defined(JSL__GROUP_SSE2)
+        return (uint32_t) _mm_movemask_epi8(_mm_loadu_si128((const __m128i*) control));
+    #elif defined(JSL__GROUP_NEON)
+        uint8x16_t empty = vtstq_u8(vld1q_u8(control), vdupq_n_u8(JSL__HASHMAP_CONTROL_EMPTY));
+        uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(empty), 4);
+        return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ULL;
+    #elif defined(JSL__GROUP_WASM)
+        return (uint32_t) wasm_i8x16_bitmask(wasm_v128_load(control));
+    #else
+        return jsl__rapid_read64(control) & 0x8080808080808080ULL;
+    #endif
+}
+
+static inline int64_t jsl__hash_map_group_lane(uint64_t mask)
+{
+    return (int64_t) (JSL_PLATFORM_COUNT_TRAILING_ZEROS64(mask) >> JSL__HASHMAP_GROUP_LANE_SHIFT);
+}
+
+#ifdef JSL__GROUP_AVX2
+    #undef JSL__GROUP_AVX2
+#endif
+#ifdef JSL__GROUP_SSE2
+    #undef JSL__GROUP_SSE2
+#endif
+#ifdef JSL__GROUP_NEON
+    #undef JSL__GROUP_NEON
+#endif
+#ifdef JSL__GROUP_WASM
+    #undef JSL__GROUP_WASM
+#endif
@@ -66,6 +66,13 @@ extern char** environ;
 #endif
 
 #define JSL__DIR_ITERATOR_PRIVATE_SENTINEL 9523783263672821879U
+#define JSL__MAPPED_FILE_PRIVATE_SENTINEL 4471127835911049347U
+#define JSL__FILE_WRITER_PRIVATE_SENTINEL 13266394105539261411U
+
+// Every POSIX system we support allows at least this many iovecs per
+// writev, the standard only promises 16 but Linux, macOS, and the BSDs
+// all allow 1024
+#define JSL__WRITE_VECTOR_BATCH 64
 
 JSLGetFileSizeResultEnum jsl_get_file_size(
     JSLImmutableMemory path,
@@ -547,6 +554,597 @@ JSLWriteFileResultEnum jsl_write_file_contents(
     return res;
 }
 
+/**
+ * Write all of `parts` to the file descriptor, continuing after short writes.
+ * Returns the number of bytes written, or -1 with errno set on failure.
+ */
+static int64_t jsl__write_parts(
+    int32_t file_descriptor,
+    const JSLImmutableMemory* parts,
+    int64_t part_count
+)
+{
+    int64_t total_written = 0;
+    int64_t part_index = 0;
+    // bytes of parts[part_index] which have already been written
+    int64_t part_offset = 0;
+
+    while (part_index < part_count)
+    {
+        #if JSL_IS_WINDOWS
+
+            int64_t remaining = parts[part_index].length - part_offset;
+            int32_t written = 0;
+            if (remaining > 0)
+            {
+                written = _write(
+                    file_descriptor,
+                    parts[part_index].data + part_offset,
+                    (unsigned int) JSL_MIN(remaining, (int64_t) INT32_MAX)
+                );
+                if (written <= 0)
+                    return -1;
+            }
+
+        #elif JSL_IS_POSIX
+
+            struct iovec vectors[JSL__WRITE_VECTOR_BATCH];
+            int32_t vector_count = 0;
+            for (
+                int64_t i = part_index;
+                i < part_count && vector_count < JSL__WRITE_VECTOR_BATCH;
+                ++i
+            )
+            {
+                int64_t offset = i == part_index ? part_offset : 0;
+                if (parts[i].length - offset <= 0)
+                    continue;
+
+                vectors[vector_count].iov_base = (void*) (parts[i].data + offset);
+                vectors[vector_count].iov_len = (size_t) (parts[i].length - offset);
+                ++vector_count;
+            }
+
+            // Only empty parts are left
+            if (vector_count == 0)
+                break;
+
+            ssize_t written = writev(file_descriptor, vectors, vector_count);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                return -1;
+
+        #else
+            #error "Unsupported platform"
+        #endif
+
+        total_written += (int64_t) written;
+
+        // Skip past the parts that were completely written, including empty ones
+        int64_t unaccounted = (int64_t) written;
+        while (part_index < part_count)
+        {
+            int64_t remaining = parts[part_index].length - part_offset;
+            if (unaccounted < remaining)
+            {
+                part_offset += unaccounted;
+                break;
+            }
+            unaccounted -= remaining;
+            ++part_index;
+            part_offset = 0;
+        }
+    }
+
+    return total_written;
+}
+
+JSLWriteFileResultEnum jsl_write_file_contents_vectored(
+    const JSLImmutableMemory* parts,
+    int64_t part_count,
+    JSLImmutableMemory path,
+    int64_t* out_bytes_written,
+    int32_t* out_errno
+)
+{
+    char path_buffer[FILENAME_MAX + 1];
+    JSLWriteFileResultEnum res = JSL_FILE_WRITE_BAD_PARAMETERS;
+
+    bool params_valid = (path.data != NULL
+        && path.length > 0
+        && path.length < FILENAME_MAX
+        && part_count >= 0
+        && (parts != NULL || part_count == 0));
+
+    for (int64_t i = 0; params_valid && i < part_count; ++i)
+    {
+        params_valid = parts[i].length >= 0
+            && (parts[i].data != NULL || parts[i].length == 0);
+    }
+
+    bool got_path = false;
+    if (params_valid)
+    {
+        JSL_MEMCPY(path_buffer, path.data, (size_t) path.length);
+        path_buffer[path.length] = '\0';
+        got_path = true;
+    }
+
+    int32_t file_descriptor = -1;
+    bool opened_file = false;
+    if (got_path)
+    {
+        #if JSL_IS_WINDOWS
+            errno_t open_err = _sopen_s(
+                &file_descriptor,
+                path_buffer,
+                _O_CREAT | _O_WRONLY | _O_TRUNC,
+                _SH_DENYNO,
+                _S_IREAD | _S_IWRITE
+            );
+            opened_file = (open_err == 0);
+        #elif JSL_IS_POSIX
+            file_descriptor = open(path_buffer, O_CREAT | O_WRONLY | O_TRUNC, S_IRUSR | S_IWUSR);
+            opened_file = file_descriptor > -1;
+        #endif
+
+        if (!opened_file)
+        {
+            res = JSL_FILE_WRITE_COULD_NOT_OPEN;
+            if (out_errno != NULL)
+                *out_errno = errno;
+        }
+    }
+
+    if (opened_file)
+    {
+        int64_t write_res = jsl__write_parts(file_descriptor, parts, part_count);
+        if (write_res > -1)
+        {
+            res = JSL_FILE_WRITE_SUCCESS;
+            if (out_bytes_written != NULL)
+                *out_bytes_written = write_res;
+        }
+        else
+        {
+            res = JSL_FILE_WRITE_COULD_NOT_WRITE;
+            if (out_errno != NULL)
+                *out_errno = errno;
+        }
+    }
+
+    if (opened_file)
+    {
+        #if JSL_IS_WINDOWS
+            int32_t close_res = _close(file_descriptor);
+        #elif JSL_IS_POSIX
+            int32_t close_res = close(file_descriptor);
+        #endif
+
+        if (close_res < 0 && res == JSL_FILE_WRITE_SUCCESS)
+        {
+            res = JSL_FILE_WRITE_COULD_NOT_CLOSE;
+            if (out_errno != NULL)
+                *out_errno = errno;
+        }
+    }
+
+    return res;
+}
+
+bool jsl_file_writer_init(
+    JSLFileWriter* writer,
+    int32_t file_descriptor,
+    JSLMutableMemory staging
+)
+{
+    bool res = (
+        writer != NULL
+        && file_descriptor > -1
+        && staging.length >= 0
+        && (staging.data != NULL || staging.length == 0)
+    );
+
+    if (res)
+    {
+        JSL_MEMSET(writer, 0, sizeof(JSLFileWriter));
+        writer->file_descriptor = file_descriptor;
+        writer->staging = staging;
+        writer->sentinel = JSL__FILE_WRITER_PRIVATE_SENTINEL;
+    }
+
+    return res;
+}
+
+bool jsl_file_writer_flush(
+    JSLFileWriter* writer,
+    int32_t* out_errno
+)
+{
+    bool res = (
+        writer != NULL
+        && writer->sentinel == JSL__FILE_WRITER_PRIVATE_SENTINEL
+    );
+
+    if (res && writer->error == 0 && writer->part_count > 0)
+    {
+        int64_t written = jsl__write_parts(
+            writer->file_descriptor,
+            writer->parts,
+            writer->part_count
+        );
+        // A failure that didn't set errno still has to be remembered
+        if (written < 0)
+            writer->error = errno != 0 ? errno : EIO;
+    }
+
+    if (res)
+    {
+        writer->part_count = 0;
+        writer->staging_used = 0;
+        res = writer->error == 0;
+        if (!res && out_errno != NULL)
+            *out_errno = writer->error;
+    }
+
+    return res;
+}
+
+bool jsl_file_writer_queue(
+    JSLFileWriter* writer,
+    JSLImmutableMemory data
+)
+{
+    bool res = (
+        writer != NULL
+        && writer->sentinel == JSL__FILE_WRITER_PRIVATE_SENTINEL
+        && data.length >= 0
+        && (data.data != NULL || data.length == 0)
+    );
+
+    if (res && writer->part_count == JSL_FILE_WRITER_MAX_PARTS)
+        res = jsl_file_writer_flush(writer, NULL);
+
+    if (res && data.length > 0)
+    {
+        writer->parts[writer->part_count] = data;
+        ++writer->part_count;
+    }
+
+    return res && writer->error == 0;
+}
+
+bool jsl_file_writer_write(
+    JSLFileWriter* writer,
+    JSLImmutableMemory data
+)
+{
+    bool res = (
+        writer != NULL
+        && writer->sentinel == JSL__FILE_WRITER_PRIVATE_SENTINEL
+        && data.length >= 0
+        && (data.data != NULL || data.length == 0)
+    );
+
+    bool fits = res && data.length <= writer->staging.length - writer->staging_used;
+
+    // Too big to ever copy, write it along with what's queued while the
+    // caller's memory is still valid
+    if (res && !fits && data.length > writer->staging.length)
+    {
+        res = jsl_file_writer_queue(writer, data)
+            && jsl_file_writer_flush(writer, NULL);
+        return res;
+    }
+
+    // Flush before copying when the copy can't be queued, otherwise the
+    // flush inside queue would free the staging space the copy is in
+    if (res && (!fits || writer->part_count == JSL_FILE_WRITER_MAX_PARTS))
+        res = jsl_file_writer_flush(writer, NULL);
+
+    if (res && data.length > 0)
+    {
+        uint8_t* copy = writer->staging.data + writer->staging_used;
+        JSL_MEMCPY(copy, data.data, (size_t) data.length);
+        writer->staging_used += data.length;
+
+        // Extend the last part when it's the previous copy
+        JSLImmutableMemory* last = writer->part_count > 0
+            ? &writer->parts[writer->part_count - 1]
+            : NULL;
+        if (last != NULL && last->data + last->length == copy)
+            last->length += data.length;
+        else
+            res = jsl_file_writer_queue(writer, jsl_immutable_memory(copy, data.length));
+    }
+
+    return res && writer->error == 0;
+}
+
+static void jsl__file_writer_sink_out(void* user, JSLImmutableMemory data)
+{
+    jsl_file_writer_write((JSLFileWriter*) user, data);
+}
+
+JSLOutputSink jsl_file_writer_output_sink(JSLFileWriter* writer)
+{
+    JSLOutputSink sink;
+    sink.write_fp = jsl__file_writer_sink_out;
+    sink.user_data = writer;
+    return sink;
+}
+
+JSLMapFileResultEnum jsl_map_file(
+    JSLImmutableMemory path,
+    JSLMappedFile* out_mapping,
+    int32_t* out_errno
+)
+{
+    char path_buffer[FILENAME_MAX + 1];
+
+    bool proceed = (path.data != NULL
+        && path.length > 0
+        && path.length < FILENAME_MAX
+        && out_mapping != NULL);
+    JSLMapFileResultEnum res = proceed ? JSL_MAP_FILE_SUCCESS : JSL_MAP_FILE_BAD_PARAMETERS;
+
+    if (proceed)
+    {
+        // File system APIs require a null terminated string
+        JSL_MEMCPY(path_buffer, path.data, (size_t) path.length);
+        path_buffer[path.length] = '\0';
+        JSL_MEMSET(out_mapping, 0, sizeof(JSLMappedFile));
+    }
+
+    #if JSL_IS_WINDOWS
+
+        HANDLE file_handle = INVALID_HANDLE_VALUE;
+        if (proceed)
+        {
+            file_handle = CreateFileA(
+                path_buffer,
+                GENERIC_READ,
+                FILE_SHARE_READ,
+                NULL,
+                OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL,
+                NULL
+            );
+            proceed = file_handle != INVALID_HANDLE_VALUE;
+            res = proceed ? JSL_MAP_FILE_SUCCESS : JSL_MAP_FILE_COULD_NOT_OPEN;
+            if (!proceed && out_errno != NULL)
+                *out_errno = (int32_t) GetLastError();
+        }
+
+        LARGE_INTEGER file_size = {0};
+        if (proceed)
+        {
+            proceed = GetFileSizeEx(file_handle, &file_size) != FALSE;
+            res = proceed ? JSL_MAP_FILE_SUCCESS : JSL_MAP_FILE_COULD_NOT_GET_FILE_SIZE;
+            if (!proceed && out_errno != NULL)
+                *out_errno = (int32_t) GetLastError();
+        }
+
+        // Windows refuses to create a mapping of an empty file
+        bool needs_mapping = proceed && file_size.QuadPart > 0;
+
+        HANDLE mapping_handle = NULL;
+        if (needs_mapping)
+        {
+            mapping_handle = CreateFileMappingA(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+            proceed = mapping_handle != NULL;
+        }
+
+        void* view = NULL;
+        if (needs_mapping && proceed)
+        {
+            view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+            proceed = view != NULL;
+        }
+
+        if (needs_mapping && !proceed)
+        {
+            res = JSL_MAP_FILE_COULD_NOT_MAP;
+            if (out_errno != NULL)
+                *out_errno = (int32_t) GetLastError();
+        }
+
+        // The view keeps the mapping object alive on its own
+        if (mapping_handle != NULL)
+            CloseHandle(mapping_handle);
+        if (file_handle != INVALID_HANDLE_VALUE)
+            CloseHandle(file_handle);
+
+        if (proceed)
+        {
+            out_mapping->contents.data = (const uint8_t*) view;
+            out_mapping->contents.length = (int64_t) file_size.QuadPart;
+            out_mapping->sentinel = JSL__MAPPED_FILE_PRIVATE_SENTINEL;
+        }
+
+    #elif JSL_IS_POSIX
+
+        int32_t file_descriptor = -1;
+        if (proceed)
+        {
+            file_descriptor = open(path_buffer, O_RDONLY);
+            proceed = file_descriptor > -1;
+            res = proceed ? JSL_MAP_FILE_SUCCESS : JSL_MAP_FILE_COULD_NOT_OPEN;
+            if (!proceed && out_errno != NULL)
+                *out_errno = errno;
+        }
+
+        int64_t file_size = -1;
+        if (proceed)
+        {
+            file_size = jsl__get_file_size_from_fileno(file_descriptor);
+            proceed = file_size > -1;
+            res = proceed ? JSL_MAP_FILE_SUCCESS : JSL_MAP_FILE_COULD_NOT_GET_FILE_SIZE;
+            if (!proceed && out_errno != NULL)
+                *out_errno = errno;
+        }
+
+        // mmap rejects zero length mappings
+        bool needs_mapping = proceed && file_size > 0;
+
+        void* view = NULL;
+        if (needs_mapping)
+        {
+            view = mmap(NULL, (size_t) file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+            proceed = view != MAP_FAILED;
+            res = proceed ? JSL_MAP_FILE_SUCCESS : JSL_MAP_FILE_COULD_NOT_MAP;
+            if (!proceed && out_errno != NULL)
+                *out_errno = errno;
+        }
+
+        // The mapping holds its own reference to the file
+        if (file_descriptor > -1)
+            close(file_descriptor);
+
+        if (proceed)
+        {
+            out_mapping->contents.data = needs_mapping ? (const uint8_t*) view : NULL;
+            out_mapping->contents.length = file_size;
+            out_mapping->sentinel = JSL__MAPPED_FILE_PRIVATE_SENTINEL;
+        }
+
+    #else
+        #error "Unsupported platform"
+    #endif
+
+    return res;
+}
+
+JSLMapFileResultEnum jsl_map_file_or_load(
+    JSLAllocatorInterface allocator,
+    JSLImmutableMemory path,
+    JSLMappedFile* out_mapping,
+    int32_t* out_errno
+)
+{
+    JSLMapFileResultEnum res = jsl_map_file(path, out_mapping, out_errno);
+
+    if (res == JSL_MAP_FILE_COULD_NOT_MAP)
+    {
+        JSLImmutableMemory contents = {0};
+        JSLLoadFileResultEnum load_res = jsl_load_file_contents(
+            allocator,
+            path,
+            &contents,
+            out_errno
+        );
+
+        if (load_res == JSL_FILE_LOAD_SUCCESS)
+        {
+            out_mapping->contents = contents;
+            out_mapping->is_loaded = true;
+            out_mapping->allocator = allocator;
+            out_mapping->sentinel = JSL__MAPPED_FILE_PRIVATE_SENTINEL;
+            res = JSL_MAP_FILE_SUCCESS;
+        }
+        else if (load_res == JSL_FILE_LOAD_COULD_NOT_OPEN)
+        {
+            res = JSL_MAP_FILE_COULD_NOT_OPEN;
+        }
+        else if (load_res == JSL_FILE_LOAD_COULD_NOT_GET_MEMORY)
+        {
+            res = JSL_MAP_FILE_COULD_NOT_GET_MEMORY;
+        }
+    }
+
+    return res;
+}
+
+bool jsl_map_file_advise(
+    JSLMappedFile* mapping,
+    uint32_t hints
+)
+{
+    bool res = (
+        mapping != NULL
+        && mapping->sentinel == JSL__MAPPED_FILE_PRIVATE_SENTINEL
+    );
+
+    bool has_view = res
+        && !mapping->is_loaded
+        && mapping->contents.data != NULL
+        && mapping->contents.length > 0;
+
+    #if JSL_IS_WINDOWS
+
+        // Windows has no read ahead or huge page advice for mapped views
+        (void) has_view;
+        (void) hints;
+
+        #if defined(_WIN32_WINNT) && _WIN32_WINNT >= 0x0602
+            if (has_view && (hints & JSL_MAP_FILE_HINT_WILL_NEED) != 0)
+            {
+                WIN32_MEMORY_RANGE_ENTRY range;
+                range.VirtualAddress = (PVOID) mapping->contents.data;
+                range.NumberOfBytes = (SIZE_T) mapping->contents.length;
+                res = PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0) != FALSE;
+            }
+        #endif
+
+    #elif JSL_IS_POSIX
+
+        void* address = has_view ? (void*) mapping->contents.data : NULL;
+        size_t length = has_view ? (size_t) mapping->contents.length : 0;
+
+        // posix_madvise returns the error number instead of setting errno
+        if (has_view && (hints & JSL_MAP_FILE_HINT_SEQUENTIAL) != 0)
+            res = posix_madvise(address, length, POSIX_MADV_SEQUENTIAL) == 0 && res;
+
+        if (has_view && (hints & JSL_MAP_FILE_HINT_WILL_NEED) != 0)
+            res = posix_madvise(address, length, POSIX_MADV_WILLNEED) == 0 && res;
+
+        // madvise and MADV_HUGEPAGE are only declared when the host program's
+        // feature test macros ask for them
+        #if defined(MADV_HUGEPAGE)
+            if (has_view && (hints & JSL_MAP_FILE_HINT_HUGE_PAGES) != 0)
+                res = madvise(address, length, MADV_HUGEPAGE) == 0 && res;
+        #endif
+
+    #else
+        #error "Unsupported platform"
+    #endif
+
+    return res;
+}
+
+bool jsl_unmap_file(JSLMappedFile* mapping)
+{
+    bool res = (
+        mapping != NULL
+        && mapping->sentinel == JSL__MAPPED_FILE_PRIVATE_SENTINEL
+    );
+
+    bool has_view = res && mapping->contents.data != NULL && mapping->contents.length > 0;
+
+    if (has_view && mapping->is_loaded)
+    {
+        res = jsl_allocator_interface_free(mapping->allocator, mapping->contents.data);
+    }
+    else if (has_view)
+    {
+        #if JSL_IS_WINDOWS
+            res = UnmapViewOfFile(mapping->contents.data) != FALSE;
+        #elif JSL_IS_POSIX
+            res = munmap((void*) mapping->contents.data, (size_t) mapping->contents.length) == 0;
+        #else
+            #error "Unsupported platform"
+        #endif
+    }
+
+    if (mapping != NULL && mapping->sentinel == JSL__MAPPED_FILE_PRIVATE_SENTINEL)
+    {
+        JSL_MEMSET(mapping, 0, sizeof(JSLMappedFile));
+    }
+
+    return res;
+}
+
 JSLMakeDirectoryResultEnum jsl_make_directory(
     JSLImmutableMemory path,
     int32_t* out_errno
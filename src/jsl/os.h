@@ -98,6 +98,8 @@ extern "C" {
     #include <unistd.h>
     #include <sys/types.h>
     #include <sys/stat.h>
+    #include <sys/mman.h>
+    #include <sys/uio.h>
 
 #else
 
@@ -168,6 +170,93 @@ typedef enum
     JSL_FILE_WRITE_ENUM_COUNT
 } JSLWriteFileResultEnum;
 
+/**
+ * Result codes for `jsl_map_file` and `jsl_map_file_or_load`.
+ */
+typedef enum
+{
+    /// @brief arguments are invalid
+    JSL_MAP_FILE_BAD_PARAMETERS = 0,
+    /// @brief the file is mapped and readable through the mapping
+    JSL_MAP_FILE_SUCCESS,
+    /// @brief the file could not be opened (missing, permission denied, etc.)
+    JSL_MAP_FILE_COULD_NOT_OPEN,
+    /// @brief stat'ing the file failed
+    JSL_MAP_FILE_COULD_NOT_GET_FILE_SIZE,
+    /// @brief the OS refused to create the mapping
+    JSL_MAP_FILE_COULD_NOT_MAP,
+    /// @brief the fallback read in `jsl_map_file_or_load` could not allocate
+    JSL_MAP_FILE_COULD_NOT_GET_MEMORY,
+
+    JSL_MAP_FILE_ENUM_COUNT
+} JSLMapFileResultEnum;
+
+/**
+ * Hints for `jsl_map_file_advise` about how a mapping will be read. Combine
+ * them with bitwise or.
+ */
+typedef enum
+{
+    /// @brief the mapping is read front to back, so the OS reads further ahead
+    /// and drops pages behind the reader sooner
+    JSL_MAP_FILE_HINT_SEQUENTIAL = 1 << 0,
+    /// @brief the whole mapping is needed soon, so the OS starts reading it in now
+    JSL_MAP_FILE_HINT_WILL_NEED = 1 << 1,
+    /// @brief back the mapping with huge pages when the OS supports it for
+    /// files, which cuts TLB misses when scanning very large files
+    JSL_MAP_FILE_HINT_HUGE_PAGES = 1 << 2
+} JSLMapFileHintEnum;
+
+/**
+ * A read only view of a file's contents created by `jsl_map_file` or
+ * `jsl_map_file_or_load`.
+ *
+ * The contents are valid until `jsl_unmap_file` is called. Writing to the
+ * mapped memory is undefined behavior.
+ */
+typedef struct JSLMappedFile
+{
+    /// @brief The mapped bytes of the file, empty for zero length files
+    JSLImmutableMemory contents;
+    uint64_t sentinel;
+
+    /// @brief true when the contents were read into memory from `allocator`
+    /// instead of being mapped
+    bool is_loaded;
+    JSLAllocatorInterface allocator;
+} JSLMappedFile;
+
+/**
+ * The most writes a `JSLFileWriter` queues before it has to flush.
+ */
+#define JSL_FILE_WRITER_MAX_PARTS 64
+
+/**
+ * Collects many small writes to a file descriptor and sends them to the OS
+ * together, with one `writev` call on POSIX. Created with `jsl_file_writer_init`.
+ *
+ * Memory given to `jsl_file_writer_queue` is not copied, it's written from
+ * where it is when the writer flushes. Memory given to `jsl_file_writer_write`,
+ * or to the writer's output sink, is copied into the staging buffer given to
+ * init, since the caller may reuse it right after the call returns.
+ *
+ * All fields are private.
+ */
+typedef struct JSLFileWriter
+{
+    uint64_t sentinel;
+    int32_t file_descriptor;
+    /// @brief errno of the first failed write, zero when nothing failed
+    int32_t error;
+
+    JSLImmutableMemory parts[JSL_FILE_WRITER_MAX_PARTS];
+    int64_t part_count;
+
+    /// @brief copies of written memory which haven't been flushed yet
+    JSLMutableMemory staging;
+    int64_t staging_used;
+} JSLFileWriter;
+
 /**
  * Result codes for `jsl_make_directory`.
  */
@@ -440,6 +529,184 @@ JSL_DEF JSLWriteFileResultEnum jsl_write_file_contents(
     int32_t* out_errno
 );
 
+/**
+* Write every buffer in `parts`, one after the other, to the file located
+* at `path`.
+*
+* The same as `jsl_write_file_contents` with all of the parts joined
+* together, except nothing is joined. On POSIX the parts are handed to the
+* OS in batches with `writev`, so writing a response made of dozens of
+* fragments costs one system call instead of one per fragment or a copy
+* into a string builder. Short writes are continued until everything is
+* written or an error occurs.
+*
+* On Windows the parts are written one at a time, since `WriteFileGather`
+* only accepts page aligned, page sized buffers.
+*
+* @param parts Data to be written to disk, in order. Empty parts are allowed.
+* @param part_count The number of elements in `parts`
+* @param path File system path to write to
+* @param out_bytes_written Optional pointer that receives the bytes written on success
+* @param out_errno Optional pointer that receives the system errno on failure
+* @returns A result enum describing the write outcome
+*/
+JSL_DEF JSLWriteFileResultEnum jsl_write_file_contents_vectored(
+    const JSLImmutableMemory* parts,
+    int64_t part_count,
+    JSLImmutableMemory path,
+    int64_t* out_bytes_written,
+    int32_t* out_errno
+);
+
+/**
+* Initialize a writer for an already open file descriptor. The writer does
+* not take ownership of the descriptor, close it yourself after the last
+* `jsl_file_writer_flush`.
+*
+* @param writer The writer to initialize
+* @param file_descriptor A descriptor open for writing, e.g. from `open` or `fileno`
+* @param staging Space for copies of memory given to `jsl_file_writer_write`
+* and the output sink. Can be empty, in which case every copied write flushes
+* right away. Must stay valid for as long as the writer is used.
+* @returns false on invalid parameters
+*/
+JSL_DEF bool jsl_file_writer_init(
+    JSLFileWriter* writer,
+    int32_t file_descriptor,
+    JSLMutableMemory staging
+);
+
+/**
+* Queue `data` to be written without copying it. The memory must stay
+* valid and unchanged until the next call to `jsl_file_writer_flush`.
+*
+* When the queue is already full this flushes first.
+*
+* @param writer The writer
+* @param data The bytes to write
+* @returns false on invalid parameters or if an earlier write failed
+*/
+JSL_DEF bool jsl_file_writer_queue(
+    JSLFileWriter* writer,
+    JSLImmutableMemory data
+);
+
+/**
+* Copy `data` into the staging buffer and queue it. Consecutive copies are
+* queued as a single part. Data that doesn't fit in the staging buffer is
+* written immediately along with everything queued before it.
+*
+* @param writer The writer
+* @param data The bytes to write, can be reused as soon as this returns
+* @returns false on invalid parameters or if a write failed
+*/
+JSL_DEF bool jsl_file_writer_write(
+    JSLFileWriter* writer,
+    JSLImmutableMemory data
+);
+
+/**
+* Write everything that's queued to the file descriptor. Once a write fails
+* the writer drops everything queued afterwards and every flush returns the
+* same error.
+*
+* @param writer The writer
+* @param out_errno Optional pointer that receives the system errno on failure
+* @returns false on invalid parameters or if a write failed
+*/
+JSL_DEF bool jsl_file_writer_flush(
+    JSLFileWriter* writer,
+    int32_t* out_errno
+);
+
+/**
+* Build a `JSLOutputSink` that copies everything written to it into the
+* writer with `jsl_file_writer_write`. Output sinks can't report errors, so
+* check the result of the final `jsl_file_writer_flush`.
+*
+* @param writer The writer, which must outlive the sink
+* @returns A configured output sink
+*/
+JSL_DEF JSLOutputSink jsl_file_writer_output_sink(JSLFileWriter* writer);
+
+/**
+* Map the file at `path` into memory as read only.
+*
+* Instead of copying the file into an allocation like `jsl_load_file_contents`,
+* the OS pages the file in on demand and the pages are shared with the page
+* cache. This makes opening large files that are only partially read nearly
+* free. Uses `mmap` on POSIX and `CreateFileMapping`/`MapViewOfFile` on Windows.
+* The file handle is closed before returning, only the mapping remains.
+*
+* Modifying the file on disk while it's mapped is visible through the
+* mapping and truncating it can crash the process, so only map files which
+* are not changed while in use.
+*
+* @param path The file system path
+* @param out_mapping Mapping to initialize, must not be null
+* @param out_errno Optional pointer that receives the system error code on failure
+* @returns A result enum describing the outcome
+*/
+JSL_DEF JSLMapFileResultEnum jsl_map_file(
+    JSLImmutableMemory path,
+    JSLMappedFile* out_mapping,
+    int32_t* out_errno
+);
+
+/**
+* Map the file at `path` like `jsl_map_file`, and if the OS can't map it,
+* read it into memory from `allocator` instead.
+*
+* Some file systems, like sysfs or some network and FUSE mounts, don't
+* support mapping. Use this instead of `jsl_map_file` when the path comes
+* from the user and should work anywhere a plain read would. Check
+* `is_loaded` on the result to see which happened.
+*
+* @param allocator Used only by the fallback read, and by `jsl_unmap_file`
+* to free it
+* @param path The file system path
+* @param out_mapping Mapping to initialize, must not be null
+* @param out_errno Optional pointer that receives the system error code on failure
+* @returns A result enum describing the outcome
+*/
+JSL_DEF JSLMapFileResultEnum jsl_map_file_or_load(
+    JSLAllocatorInterface allocator,
+    JSLImmutableMemory path,
+    JSLMappedFile* out_mapping,
+    int32_t* out_errno
+);
+
+/**
+* Tell the OS how the mapping will be read. This never changes the contents,
+* only how and when pages are read from disk. Uses `posix_madvise`, plus
+* `madvise` for huge pages on Linux, and `PrefetchVirtualMemory` for
+* `JSL_MAP_FILE_HINT_WILL_NEED` on Windows 8 and later. Hints the platform
+* has no equivalent for are ignored, as is any hint on a mapping that was
+* loaded instead of mapped.
+*
+* Huge pages for file mappings need kernel support on Linux
+* (`CONFIG_READ_ONLY_THP_FOR_FS`), otherwise the hint is accepted and has
+* no effect.
+*
+* @param mapping A mapping from `jsl_map_file` or `jsl_map_file_or_load`
+* @param hints `JSLMapFileHintEnum` values combined with bitwise or
+* @returns false on invalid parameters or if the OS rejected a hint, the
+* mapping is still usable either way
+*/
+JSL_DEF bool jsl_map_file_advise(
+    JSLMappedFile* mapping,
+    uint32_t hints
+);
+
+/**
+* Release a mapping created by `jsl_map_file` or `jsl_map_file_or_load`. Any
+* memory previously read from the mapping is invalid after this call.
+*
+* @param mapping Mapping to release
+* @returns `true` on success, `false` on invalid parameters or OS failure
+*/
+JSL_DEF bool jsl_unmap_file(JSLMappedFile* mapping);
+
 /**
 * Write the contents of a fat pointer to a `FILE*`.
 *
@@ -0,0 +1,588 @@
+/**
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L
+    #include <stdbool.h>
+#endif
+
+#include "core.h"
+#include "allocator.h"
+#include "rope.h"
+
+#define JSL__ROPE_PRIVATE_SENTINEL 1529417732886151173U
+#define JSL__ROPE_ITERATOR_PRIVATE_SENTINEL 9270461388610553961U
+
+// An edit splits at most two pieces, so this many free nodes are set aside
+// before any edit starts and the tree is never left half changed
+#define JSL__ROPE_NODES_PER_EDIT 2
+
+/**
+ * One piece of the document. The tree is a treap: in order it gives the
+ * pieces in document order, and every node's priority is at least that of
+ * its children, which keeps the depth logarithmic.
+ */
+struct JSL__RopeNode
+{
+    struct JSL__RopeNode* left;
+    struct JSL__RopeNode* right;
+    const uint8_t* data;
+    int64_t length;
+    /// @brief bytes in this node's piece plus all of its descendants' pieces
+    int64_t subtree_length;
+    uint64_t priority;
+};
+
+// Header at the start of every chunk of text
+struct JSL__RopeChunk
+{
+    struct JSL__RopeChunk* next;
+};
+
+static inline int64_t jsl__rope_subtree_length(struct JSL__RopeNode* node)
+{
+    return node != NULL ? node->subtree_length : 0;
+}
+
+static inline void jsl__rope_update(struct JSL__RopeNode* node)
+{
+    node->subtree_length = (
+        jsl__rope_subtree_length(node->left)
+        + node->length
+        + jsl__rope_subtree_length(node->right)
+    );
+}
+
+static uint64_t jsl__rope_random(JSLRope* rope)
+{
+    uint64_t x = rope->random_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    rope->random_state = x;
+    return x;
+}
+
+static bool jsl__rope_reserve_nodes(JSLRope* rope, int32_t count)
+{
+    int32_t available = 0;
+    struct JSL__RopeNode* node = rope->free_nodes;
+    while (node != NULL && available < count)
+    {
+        ++available;
+        node = node->left;
+    }
+
+    bool res = true;
+    for (int32_t i = available; i < count && res; ++i)
+    {
+        struct JSL__RopeNode* new_node = JSL_TYPED_ALLOCATE(struct JSL__RopeNode, rope->allocator);
+        res = new_node != NULL;
+
+        if (res)
+        {
+            new_node->left = rope->free_nodes;
+            rope->free_nodes = new_node;
+        }
+    }
+
+    return res;
+}
+
+// Only call after jsl__rope_reserve_nodes made sure there is one
+static struct JSL__RopeNode* jsl__rope_take_node(JSLRope* rope)
+{
+    struct JSL__RopeNode* node = rope->free_nodes;
+    rope->free_nodes = node->left;
+    JSL_MEMSET(node, 0, sizeof(struct JSL__RopeNode));
+    ++rope->piece_count;
+    return node;
+}
+
+static void jsl__rope_release_tree(JSLRope* rope, struct JSL__RopeNode* node)
+{
+    if (node == NULL)
+        return;
+
+    jsl__rope_release_tree(rope, node->left);
+    jsl__rope_release_tree(rope, node->right);
+
+    node->left = rope->free_nodes;
+    rope->free_nodes = node;
+    --rope->piece_count;
+}
+
+/**
+ * Split the tree so that `out_left` holds exactly the first `offset` bytes
+ * and `out_right` the rest. When the offset falls inside a piece, the piece
+ * is cut in two with a node taken from the free list.
+ */
+static void jsl__rope_split(
+    JSLRope* rope,
+    struct JSL__RopeNode* node,
+    int64_t offset,
+    struct JSL__RopeNode** out_left,
+    struct JSL__RopeNode** out_right
+)
+{
+    if (node == NULL)
+    {
+        *out_left = NULL;
+        *out_right = NULL;
+        return;
+    }
+
+    int64_t left_length = jsl__rope_subtree_length(node->left);
+
+    if (offset <= left_length)
+    {
+        jsl__rope_split(rope, node->left, offset, out_left, &node->left);
+        jsl__rope_update(node);
+        *out_right = node;
+    }
+    else if (offset >= left_length + node->length)
+    {
+        jsl__rope_split(rope, node->right, offset - left_length - node->length, &node->right, out_right);
+        jsl__rope_update(node);
+        *out_left = node;
+    }
+    else
+    {
+        int64_t cut = offset - left_length;
+
+        // The second half takes over the right subtree. Sharing the
+        // original's priority keeps the heap order intact.
+        struct JSL__RopeNode* tail = jsl__rope_take_node(rope);
+        tail->data = node->data + cut;
+        tail->length = node->length - cut;
+        tail->priority = node->priority;
+        tail->right = node->right;
+        jsl__rope_update(tail);
+
+        node->length = cut;
+        node->right = NULL;
+        jsl__rope_update(node);
+
+        *out_left = node;
+        *out_right = tail;
+    }
+}
+
+// Join two trees where every byte of `left` comes before every byte of `right`
+static struct JSL__RopeNode* jsl__rope_merge(struct JSL__RopeNode* left, struct JSL__RopeNode* right)
+{
+    if (left == NULL)
+        return right;
+    if (right == NULL)
+        return left;
+
+    if (left->priority >= right->priority)
+    {
+        left->right = jsl__rope_merge(left->right, right);
+        jsl__rope_update(left);
+        return left;
+    }
+    else
+    {
+        right->left = jsl__rope_merge(left, right->left);
+        jsl__rope_update(right);
+        return right;
+    }
+}
+
+/**
+ * Find the piece holding the byte at `offset`, which must be less than the
+ * length.
+ *
+ * @param out_piece_start Where the offset of the first byte of the piece is written
+ */
+static struct JSL__RopeNode* jsl__rope_find(
+    struct JSL__RopeNode* node,
+    int64_t offset,
+    int64_t* out_piece_start
+)
+{
+    int64_t piece_start = 0;
+
+    while (node != NULL)
+    {
+        int64_t left_length = jsl__rope_subtree_length(node->left);
+
+        if (offset < left_length)
+        {
+            node = node->left;
+        }
+        else if (offset < left_length + node->length)
+        {
+            piece_start += left_length;
+            break;
+        }
+        else
+        {
+            offset -= left_length + node->length;
+            piece_start += left_length + node->length;
+            node = node->right;
+        }
+    }
+
+    *out_piece_start = piece_start;
+    return node;
+}
+
+/**
+ * Grow the piece which ends exactly at `offset` by `length` bytes, when the
+ * piece ends at the chunk cursor and the chunk has room. This is what keeps
+ * appending and typing from making a new piece per call.
+ */
+static bool jsl__rope_try_extend(JSLRope* rope, int64_t offset, JSLImmutableMemory str)
+{
+    if (offset == 0 || rope->chunk_cursor == NULL || rope->chunk_end - rope->chunk_cursor < str.length)
+        return false;
+
+    int64_t piece_start = 0;
+    struct JSL__RopeNode* piece = jsl__rope_find(rope->root, offset - 1, &piece_start);
+    if (
+        piece_start + piece->length != offset
+        || piece->data + piece->length != rope->chunk_cursor
+    )
+        return false;
+
+    JSL_MEMCPY(rope->chunk_cursor, str.data, (size_t) str.length);
+    rope->chunk_cursor += str.length;
+
+    // Walk the same path again, adding the new bytes to every subtree on it
+    struct JSL__RopeNode* node = rope->root;
+    int64_t remaining = offset - 1;
+    while (node != piece)
+    {
+        node->subtree_length += str.length;
+
+        int64_t left_length = jsl__rope_subtree_length(node->left);
+        if (remaining < left_length)
+        {
+            node = node->left;
+        }
+        else
+        {
+            remaining -= left_length + node->length;
+            node = node->right;
+        }
+    }
+
+    piece->length += str.length;
+    piece->subtree_length += str.length;
+    return true;
+}
+
+// Copy `str` into chunk memory, starting a new chunk when it doesn't fit
+static const uint8_t* jsl__rope_store(JSLRope* rope, JSLImmutableMemory str)
+{
+    if (rope->chunk_cursor == NULL || rope->chunk_end - rope->chunk_cursor < str.length)
+    {
+        // Text bigger than a chunk gets a chunk of its own, which leaves the
+        // current chunk's free space for later edits
+        bool dedicated = str.length > rope->chunk_bytes;
+        int64_t text_bytes = dedicated ? str.length : rope->chunk_bytes;
+
+        struct JSL__RopeChunk* chunk = (struct JSL__RopeChunk*) jsl_allocator_interface_alloc(
+            rope->allocator,
+            (int64_t) sizeof(struct JSL__RopeChunk) + text_bytes,
+            _Alignof(struct JSL__RopeChunk),
+            false
+        );
+        if (chunk == NULL)
+            return NULL;
+
+        chunk->next = rope->chunks;
+        rope->chunks = chunk;
+
+        uint8_t* text = (uint8_t*) (chunk + 1);
+        JSL_MEMCPY(text, str.data, (size_t) str.length);
+
+        if (!dedicated)
+        {
+            rope->chunk_cursor = text + str.length;
+            rope->chunk_end = text + text_bytes;
+        }
+
+        return text;
+    }
+
+    uint8_t* text = rope->chunk_cursor;
+    JSL_MEMCPY(text, str.data, (size_t) str.length);
+    rope->chunk_cursor += str.length;
+    return text;
+}
+
+static void jsl__rope_free_all(JSLRope* rope)
+{
+    jsl__rope_release_tree(rope, rope->root);
+    rope->root = NULL;
+
+    struct JSL__RopeNode* node = rope->free_nodes;
+    while (node != NULL)
+    {
+        struct JSL__RopeNode* next = node->left;
+        jsl_allocator_interface_free(rope->allocator, node);
+        node = next;
+    }
+    rope->free_nodes = NULL;
+
+    struct JSL__RopeChunk* chunk = rope->chunks;
+    while (chunk != NULL)
+    {
+        struct JSL__RopeChunk* next = chunk->next;
+        jsl_allocator_interface_free(rope->allocator, chunk);
+        chunk = next;
+    }
+    rope->chunks = NULL;
+    rope->chunk_cursor = NULL;
+    rope->chunk_end = NULL;
+    rope->piece_count = 0;
+}
+
+JSL_ROPE_DEF bool jsl_rope_init(
+    JSLRope* rope,
+    JSLAllocatorInterface allocator,
+    int64_t chunk_bytes
+)
+{
+    bool res = rope != NULL && chunk_bytes > -1;
+
+    if (res)
+    {
+        JSL_MEMSET(rope, 0, sizeof(JSLRope));
+        rope->allocator = allocator;
+        rope->chunk_bytes = chunk_bytes > 0 ? chunk_bytes : JSL_ROPE_DEFAULT_CHUNK_BYTES;
+        rope->random_state = 0x9E3779B97F4A7C15U;
+        rope->sentinel = JSL__ROPE_PRIVATE_SENTINEL;
+    }
+
+    return res;
+}
+
+JSL_ROPE_DEF bool jsl_rope_insert(
+    JSLRope* rope,
+    int64_t offset,
+    JSLImmutableMemory str
+)
+{
+    bool res = (
+        rope != NULL
+        && rope->sentinel == JSL__ROPE_PRIVATE_SENTINEL
+        && offset > -1
+        && offset <= jsl__rope_subtree_length(rope->root)
+        && str.length > -1
+        && (str.data != NULL || str.length == 0)
+        && str.length <= INT64_MAX - jsl__rope_subtree_length(rope->root)
+    );
+
+    if (!res || str.length == 0 || jsl__rope_try_extend(rope, offset, str))
+        return res;
+
+    res = jsl__rope_reserve_nodes(rope, JSL__ROPE_NODES_PER_EDIT);
+
+    const uint8_t* text = NULL;
+    if (res)
+    {
+        text = jsl__rope_store(rope, str);
+        res = text != NULL;
+    }
+
+    if (res)
+    {
+        struct JSL__RopeNode* left = NULL;
+        struct JSL__RopeNode* right = NULL;
+        jsl__rope_split(rope, rope->root, offset, &left, &right);
+
+        struct JSL__RopeNode* piece = jsl__rope_take_node(rope);
+        piece->data = text;
+        piece->length = str.length;
+        piece->priority = jsl__rope_random(rope);
+        jsl__rope_update(piece);
+
+        rope->root = jsl__rope_merge(jsl__rope_merge(left, piece), right);
+    }
+
+    return res;
+}
+
+JSL_ROPE_DEF bool jsl_rope_append(
+    JSLRope* rope,
+    JSLImmutableMemory str
+)
+{
+    if (rope == NULL || rope->sentinel != JSL__ROPE_PRIVATE_SENTINEL)
+        return false;
+
+    return jsl_rope_insert(rope, jsl__rope_subtree_length(rope->root), str);
+}
+
+JSL_ROPE_DEF bool jsl_rope_delete(
+    JSLRope* rope,
+    int64_t offset,
+    int64_t count
+)
+{
+    bool res = (
+        rope != NULL
+        && rope->sentinel == JSL__ROPE_PRIVATE_SENTINEL
+        && offset > -1
+        && count > -1
+        && count <= jsl__rope_subtree_length(rope->root) - offset
+        && jsl__rope_reserve_nodes(rope, JSL__ROPE_NODES_PER_EDIT)
+    );
+
+    if (res && count > 0)
+    {
+        struct JSL__RopeNode* left = NULL;
+        struct JSL__RopeNode* rest = NULL;
+        struct JSL__RopeNode* middle = NULL;
+        struct JSL__RopeNode* right = NULL;
+
+        jsl__rope_split(rope, rope->root, offset, &left, &rest);
+        jsl__rope_split(rope, rest, count, &middle, &right);
+        jsl__rope_release_tree(rope, middle);
+
+        rope->root = jsl__rope_merge(left, right);
+    }
+
+    return res;
+}
+
+JSL_ROPE_DEF int64_t jsl_rope_length(JSLRope* rope)
+{
+    if (rope == NULL || rope->sentinel != JSL__ROPE_PRIVATE_SENTINEL)
+        return -1;
+
+    return jsl__rope_subtree_length(rope->root);
+}
+
+JSL_ROPE_DEF int64_t jsl_rope_piece_count(JSLRope* rope)
+{
+    if (rope == NULL || rope->sentinel != JSL__ROPE_PRIVATE_SENTINEL)
+        return -1;
+
+    return rope->piece_count;
+}
+
+JSL_ROPE_DEF bool jsl_rope_iterator_init(
+    JSLRopeIterator* iterator,
+    JSLRope* rope
+)
+{
+    bool res = (
+        iterator != NULL
+        && rope != NULL
+        && rope->sentinel == JSL__ROPE_PRIVATE_SENTINEL
+    );
+
+    if (res)
+    {
+        iterator->rope = rope;
+        iterator->offset = 0;
+        iterator->sentinel = JSL__ROPE_ITERATOR_PRIVATE_SENTINEL;
+    }
+
+    return res;
+}
+
+JSL_ROPE_DEF bool jsl_rope_iterator_next(
+    JSLRopeIterator* iterator,
+    JSLImmutableMemory* out_piece
+)
+{
+    bool res = (
+        iterator != NULL
+        && iterator->sentinel == JSL__ROPE_ITERATOR_PRIVATE_SENTINEL
+        && out_piece != NULL
+        && iterator->rope->sentinel == JSL__ROPE_PRIVATE_SENTINEL
+        && iterator->offset < jsl__rope_subtree_length(iterator->rope->root)
+    );
+
+    if (res)
+    {
+        // Each step is a fresh descent rather than a stack of parents, so the
+        // iterator stays a fixed size however deep the tree gets
+        int64_t piece_start = 0;
+        struct JSL__RopeNode* piece = jsl__rope_find(
+            iterator->rope->root,
+            iterator->offset,
+            &piece_start
+        );
+
+        int64_t skip = iterator->offset - piece_start;
+        out_piece->data = piece->data + skip;
+        out_piece->length = piece->length - skip;
+        iterator->offset += out_piece->length;
+    }
+
+    return res;
+}
+
+JSL_ROPE_DEF bool jsl_rope_write_to_sink(
+    JSLRope* rope,
+    JSLOutputSink sink
+)
+{
+    JSLRopeIterator iterator;
+    bool res = jsl_rope_iterator_init(&iterator, rope);
+
+    JSLImmutableMemory piece;
+    while (res && jsl_rope_iterator_next(&iterator, &piece))
+    {
+        jsl_output_sink_write(sink, piece);
+    }
+
+    return res;
+}
+
+static void jsl__rope_sink_write(
+    void* user_data, JSLImmutableMemory data
+)
+{
+    JSLRope* rope = user_data;
+    jsl_rope_append(rope, data);
+}
+
+JSL_ROPE_DEF JSLOutputSink jsl_rope_output_sink(JSLRope* rope)
+{
+    JSLOutputSink res;
+    res.write_fp = jsl__rope_sink_write;
+    res.user_data = rope;
+    return res;
+}
+
+JSL_ROPE_DEF void jsl_rope_clear(JSLRope* rope)
+{
+    if (rope != NULL && rope->sentinel == JSL__ROPE_PRIVATE_SENTINEL)
+        jsl__rope_free_all(rope);
+}
+
+JSL_ROPE_DEF void jsl_rope_free(JSLRope* rope)
+{
+    if (rope != NULL && rope->sentinel == JSL__ROPE_PRIVATE_SENTINEL)
+    {
+        jsl__rope_free_all(rope);
+        rope->sentinel = 0;
+    }
+}
@@ -0,0 +1,295 @@
+/**
+ * # JSL Rope
+ *
+ * This file implements a rope, a string builder for very large documents
+ * and for editing in the middle of them. This file is part of the Jack's
+ * Standard Library project.
+ *
+ * ## Documentation
+ *
+ * See `docs/jsl_rope.md` for a formatted documentation page.
+ *
+ * ## Design
+ *
+ * `JSLStringBuilder` keeps its contents in one contiguous buffer. Growing
+ * it copies everything, and editing in the middle moves everything after
+ * the edit. That's the right trade when the result is small or needs to be
+ * contiguous, but not for building hundreds of megabytes of output or for
+ * editor style workloads.
+ *
+ * `JSLRope` is a piece table. Inserted bytes are copied once into large
+ * chunks from the allocator and never move again. The document is a
+ * sequence of pieces, each a pointer and length into those chunks, stored
+ * in a treap ordered by position where every node also knows the total
+ * length of its subtree. Finding a byte offset, inserting, and deleting are
+ * all O(log n) in the number of pieces, no matter how large the document is.
+ *
+ * Appending, or inserting right after the last inserted text, grows the
+ * last piece in place when its chunk has room, so typing or building output
+ * in order creates very few pieces.
+ *
+ * There's no single buffer to hand out, so the contents are read one piece
+ * at a time with `JSLRopeIterator`, and `jsl_rope_write_to_sink` passes
+ * each piece straight to an output sink without flattening the document
+ * first.
+ *
+ * ## Caveats
+ *
+ * * Deleted bytes stay in their chunk until `jsl_rope_clear` or
+ *   `jsl_rope_free`. The rope is meant to be used with an arena, and to be
+ *   cleared or thrown away as a whole.
+ * * Pieces are never merged back together, so many scattered edits leave
+ *   many short pieces.
+ * * Any change to the rope invalidates its iterators.
+ *
+ * ## License
+ *
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L
+    #include <stdbool.h>
+#endif
+
+#include "core.h"
+#include "allocator.h"
+
+/* Versioning to catch mismatches across deps */
+#ifndef JSL_ROPE_VERSION
+    #define JSL_ROPE_VERSION 0x010000  /* 1.0.0 */
+#else
+    #if JSL_ROPE_VERSION != 0x010000
+        #error "rope.h version mismatch across includes"
+    #endif
+#endif
+
+#ifndef JSL_ROPE_DEF
+    #define JSL_ROPE_DEF
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Chunk size used when `jsl_rope_init` is given zero.
+ */
+#define JSL_ROPE_DEFAULT_CHUNK_BYTES (64 * 1024)
+
+/**
+ * A string stored as a sequence of pieces. See the top of this file.
+ *
+ * All fields are private.
+ *
+ * ## Functions
+ *
+ *  * jsl_rope_init
+ *  * jsl_rope_append
+ *  * jsl_rope_insert
+ *  * jsl_rope_delete
+ *  * jsl_rope_length
+ *  * jsl_rope_piece_count
+ *  * jsl_rope_iterator_init
+ *  * jsl_rope_iterator_next
+ *  * jsl_rope_write_to_sink
+ *  * jsl_rope_output_sink
+ *  * jsl_rope_clear
+ *  * jsl_rope_free
+ */
+typedef struct JSLRope
+{
+    uint64_t sentinel;
+    JSLAllocatorInterface allocator;
+
+    /// @brief treap of pieces in document order
+    struct JSL__RopeNode* root;
+    /// @brief unused nodes, linked through their left pointer
+    struct JSL__RopeNode* free_nodes;
+    int64_t piece_count;
+
+    /// @brief every chunk of text allocated so far, newest first
+    struct JSL__RopeChunk* chunks;
+    /// @brief unused space at the end of the newest chunk
+    uint8_t* chunk_cursor;
+    uint8_t* chunk_end;
+    int64_t chunk_bytes;
+
+    uint64_t random_state;
+} JSLRope;
+
+/**
+ * Reads a rope one piece at a time, from start to end.
+ *
+ * All fields are private.
+ */
+typedef struct JSLRopeIterator
+{
+    uint64_t sentinel;
+    JSLRope* rope;
+    int64_t offset;
+} JSLRopeIterator;
+
+/**
+ * Initialize an empty rope.
+ *
+ * @param rope The rope to initialize
+ * @param allocator Used for the text chunks and the tree nodes, ideally an arena
+ * @param chunk_bytes Size of each chunk of text. Larger chunks mean fewer
+ * allocations and longer pieces. Zero means `JSL_ROPE_DEFAULT_CHUNK_BYTES`.
+ * @returns false on invalid parameters
+ */
+JSL_ROPE_DEF bool jsl_rope_init(
+    JSLRope* rope,
+    JSLAllocatorInterface allocator,
+    int64_t chunk_bytes
+);
+
+/**
+ * Add a copy of `str` to the end of the rope.
+ *
+ * @param rope The rope
+ * @param str The bytes to add
+ * @returns false on invalid parameters or if an allocation failed, in which
+ * case the rope is unchanged
+ */
+JSL_ROPE_DEF bool jsl_rope_append(
+    JSLRope* rope,
+    JSLImmutableMemory str
+);
+
+/**
+ * Insert a copy of `str` so that it starts at byte `offset`. Everything at
+ * or after `offset` moves back by the length of `str`.
+ *
+ * @param rope The rope
+ * @param offset Where to insert, from zero up to and including the length
+ * @param str The bytes to insert
+ * @returns false on invalid parameters or if an allocation failed, in which
+ * case the rope is unchanged
+ */
+JSL_ROPE_DEF bool jsl_rope_insert(
+    JSLRope* rope,
+    int64_t offset,
+    JSLImmutableMemory str
+);
+
+/**
+ * Remove `count` bytes starting at byte `offset`.
+ *
+ * @param rope The rope
+ * @param offset First byte to remove
+ * @param count The number of bytes to remove
+ * @returns false on invalid parameters, if the range runs past the end, or
+ * if an allocation failed, in which case the rope is unchanged
+ */
+JSL_ROPE_DEF bool jsl_rope_delete(
+    JSLRope* rope,
+    int64_t offset,
+    int64_t count
+);
+
+/**
+ * Get the number of bytes in the rope.
+ *
+ * @param rope The rope
+ * @returns The length, or -1 on invalid parameters
+ */
+JSL_ROPE_DEF int64_t jsl_rope_length(JSLRope* rope);
+
+/**
+ * Get the number of pieces the contents are split into, which is how many
+ * times `jsl_rope_iterator_next` returns true.
+ *
+ * @param rope The rope
+ * @returns The piece count, or -1 on invalid parameters
+ */
+JSL_ROPE_DEF int64_t jsl_rope_piece_count(JSLRope* rope);
+
+/**
+ * Start reading a rope from the beginning.
+ *
+ * @param iterator The iterator to initialize
+ * @param rope The rope, which must not change while the iterator is used
+ * @returns false on invalid parameters
+ */
+JSL_ROPE_DEF bool jsl_rope_iterator_init(
+    JSLRopeIterator* iterator,
+    JSLRope* rope
+);
+
+/**
+ * Get the next piece of the rope. The memory points into the rope and stays
+ * valid until the rope is next changed.
+ *
+ * @param iterator The iterator
+ * @param out_piece Where the piece is written
+ * @returns false when there are no more pieces or on invalid parameters
+ */
+JSL_ROPE_DEF bool jsl_rope_iterator_next(
+    JSLRopeIterator* iterator,
+    JSLImmutableMemory* out_piece
+);
+
+/**
+ * Write the whole rope to `sink`, one write per piece, without copying it
+ * into a single buffer first.
+ *
+ * @param rope The rope
+ * @param sink Where to write
+ * @returns false on invalid parameters
+ */
+JSL_ROPE_DEF bool jsl_rope_write_to_sink(
+    JSLRope* rope,
+    JSLOutputSink sink
+);
+
+/**
+ * Get an output sink which appends everything written to it to the rope,
+ * e.g. for formatting directly into the rope.
+ *
+ * @param rope The rope
+ * @returns The sink
+ */
+JSL_ROPE_DEF JSLOutputSink jsl_rope_output_sink(JSLRope* rope);
+
+/**
+ * Remove everything from the rope and give all of its memory back to the
+ * allocator. The rope can be used again right away.
+ *
+ * @param rope The rope
+ */
+JSL_ROPE_DEF void jsl_rope_clear(JSLRope* rope);
+
+/**
+ * Give all of the rope's memory back to the allocator. This sets the rope
+ * into an invalid state. You will have to call init again if you wish to
+ * use this rope instance.
+ *
+ * @param rope The rope
+ */
+JSL_ROPE_DEF void jsl_rope_free(JSLRope* rope);
+
+#ifdef __cplusplus
+}
+#endif
@@ -131,8 +131,9 @@ static JSL__FORCE_INLINE JSLImmutableMemory jsl__get_entry_value(
     return res;
 }
 
-static bool jsl__str_set_rehash(
-    JSLStrSet* set
+static bool jsl__str_set_rehash_to_length(
+    JSLStrSet* set,
+    int64_t new_length
 )
 {
     bool res = false;
@@ -145,8 +146,10 @@ static bool jsl__str_set_rehash(
     uintptr_t* old_table = params_valid ? set->entry_lookup_table : NULL;
     int64_t old_length = params_valid ? set->entry_lookup_table_length : 0;
 
-    int64_t new_length = params_valid ? jsl_next_power_of_two_i64(old_length + 1) : 0;
-    bool length_valid = params_valid && new_length > old_length && new_length > 0;
+    bool length_valid = params_valid
+        && new_length != old_length
+        && new_length > set->item_count
+        && new_length > 0;
 
     bool bytes_possible = length_valid
         && new_length <= (INT64_MAX / (int64_t) sizeof(uintptr_t));
@@ -225,7 +228,6 @@ static bool jsl__str_set_rehash(
         uintptr_t* old_table_to_free = set->entry_lookup_table;
         set->entry_lookup_table = new_table;
         set->entry_lookup_table_length = new_length;
-        set->tombstone_count = 0;
         ++set->generational_id;
         res = true;
 
@@ -242,58 +244,232 @@ static bool jsl__str_set_rehash(
     return res;
 }
 
-static inline void jsl__str_set_probe(
+static bool jsl__str_set_rehash(
+    JSLStrSet* set
+)
+{
+    return jsl__str_set_rehash_to_length(
+        set,
+        jsl_next_power_of_two_i64(set->entry_lookup_table_length + 1)
+    );
+}
+
+/**
+ * Put an entry which is known not to be in the current table into its
+ * first free slot.
+ */
+static void jsl__str_set_place_entry(
+    JSLStrSet* set,
+    struct JSL__StrSetEntry* entry
+)
+{
+    int64_t lut_length = set->entry_lookup_table_length;
+    uint64_t lut_mask = (uint64_t) lut_length - 1u;
+    int64_t probe_index = (int64_t) (entry->hash & lut_mask);
+
+    for (int64_t probes = 0; probes < lut_length; ++probes)
+    {
+        uintptr_t probe_res = set->entry_lookup_table[probe_index];
+
+        if (probe_res == JSL__HASHMAP_EMPTY)
+        {
+            set->entry_lookup_table[probe_index] = (uintptr_t) entry;
+            break;
+        }
+
+        probe_index = (int64_t) (((uint64_t) probe_index + 1u) & lut_mask);
+    }
+}
+
+/**
+ * Move up to `slot_budget` slots of the old table into the current table,
+ * freeing the old table once it has been fully drained. Either one changes
+ * what an iterator walks, so both invalidate iterators even when the caller
+ * (e.g. deleting a missing key) doesn't change anything else.
+ */
+static void jsl__str_set_migrate(
+    JSLStrSet* set,
+    int64_t slot_budget
+)
+{
+    uintptr_t* old_table = set->old_entry_lookup_table;
+    int64_t remaining = old_table != NULL
+        ? set->old_entry_lookup_table_length - set->rehash_migrate_index
+        : 0;
+    int64_t slot_count = JSL_MIN(remaining, slot_budget);
+
+    bool moved = false;
+    for (int64_t i = 0; i < slot_count; ++i)
+    {
+        int64_t old_index = set->rehash_migrate_index + i;
+        uintptr_t lut_res = old_table[old_index];
+
+        if (lut_res != JSL__HASHMAP_EMPTY && lut_res != JSL__HASHMAP_TOMBSTONE)
+        {
+            jsl__str_set_place_entry(set, (struct JSL__StrSetEntry*) lut_res);
+            moved = true;
+
+            // Leave a tombstone so that lookups of values which are still
+            // in the old table keep probing past this slot
+            old_table[old_index] = JSL__HASHMAP_TOMBSTONE;
+        }
+    }
+
+    set->rehash_migrate_index += slot_count;
+
+    bool drained = old_table != NULL
+        && set->rehash_migrate_index >= set->old_entry_lookup_table_length;
+
+    if (drained)
+    {
+        jsl_allocator_interface_free(set->allocator, old_table);
+        set->old_entry_lookup_table = NULL;
+        set->old_entry_lookup_table_length = 0;
+        set->rehash_migrate_index = 0;
+    }
+
+    if (moved || drained)
+        ++set->generational_id;
+}
+
+/**
+ * Swap in a table twice the size and keep the current table around as the
+ * old table. Entries are moved over by `jsl__str_set_migrate`.
+ */
+static bool jsl__str_set_begin_incremental_rehash(
+    JSLStrSet* set
+)
+{
+    int64_t old_length = set->entry_lookup_table_length;
+    int64_t new_length = jsl_next_power_of_two_i64(old_length + 1);
+
+    bool length_valid = new_length > old_length
+        && new_length <= (INT64_MAX / (int64_t) sizeof(uintptr_t));
+
+    uintptr_t* new_table = NULL;
+    if (length_valid)
+    {
+        new_table = (uintptr_t*) jsl_allocator_interface_alloc(
+            set->allocator,
+            (int64_t) sizeof(uintptr_t) * new_length,
+            _Alignof(uintptr_t),
+            true
+        );
+    }
+
+    if (new_table != NULL)
+    {
+        set->old_entry_lookup_table = set->entry_lookup_table;
+        set->old_entry_lookup_table_length = old_length;
+        set->rehash_migrate_index = 0;
+
+        set->entry_lookup_table = new_table;
+        set->entry_lookup_table_length = new_length;
+        ++set->generational_id;
+    }
+
+    return new_table != NULL;
+}
+
+static bool jsl__str_set_grow(
+    JSLStrSet* set
+)
+{
+    // A previous rehash is still in progress, so the current table filled
+    // up before the old one was drained. Finish it before growing again.
+    jsl__str_set_migrate(set, INT64_MAX);
+
+    bool res = false;
+
+    if (set->rehash_step > 0)
+    {
+        res = jsl__str_set_begin_incremental_rehash(set);
+    }
+    else
+    {
+        res = jsl__str_set_rehash(set);
+    }
+
+    return res;
+}
+
+/**
+ * Look for `value` in the old table of an in progress incremental rehash.
+ * Read only, nothing is moved.
+ *
+ * @returns The old table index of the value, or -1
+ */
+static int64_t jsl__str_set_find_in_old_table(
+    JSLStrSet* set,
+    JSLImmutableMemory value,
+    uint64_t hash
+)
+{
+    int64_t res = -1;
+
+    uintptr_t* old_table = set->old_entry_lookup_table;
+    int64_t lut_length = old_table != NULL ? set->old_entry_lookup_table_length : 0;
+    uint64_t lut_mask = (uint64_t) lut_length - 1u;
+    int64_t lut_index = (int64_t) (hash & lut_mask);
+
+    for (int64_t probes = 0; res == -1 && probes < lut_length; ++probes)
+    {
+        uintptr_t lut_res = old_table[lut_index];
+
+        if (lut_res == JSL__HASHMAP_EMPTY)
+            break;
+
+        if (lut_res != JSL__HASHMAP_TOMBSTONE)
+        {
+            struct JSL__StrSetEntry* entry = (struct JSL__StrSetEntry*) lut_res;
+            bool matches = entry->hash == hash
+                && jsl_memory_compare(value, jsl__get_entry_value(entry));
+
+            if (matches)
+                res = lut_index;
+        }
+
+        lut_index = (int64_t) (((uint64_t) lut_index + 1u) & lut_mask);
+    }
+
+    return res;
+}
+
+static inline void jsl__str_set_probe_hashed(
     JSLStrSet* set,
     JSLImmutableMemory value,
+    uint64_t hash,
     int64_t* out_lut_index,
-    uint64_t* out_hash,
     bool* out_found
 )
 {
     *out_lut_index = -1;
     *out_found = false;
 
-    int64_t first_tombstone = -1;
-    bool tombstone_seen = false;
-    bool searching = true;
-
-    *out_hash = jsl__rapidhash_withSeed(value.data, (size_t) value.length, set->hash_seed);
-
     int64_t lut_length = set->entry_lookup_table_length;
     uint64_t lut_mask = (uint64_t) lut_length - 1u;
-    int64_t lut_index = (int64_t) (*out_hash & lut_mask);
+    int64_t lut_index = (int64_t) (hash & lut_mask);
     int64_t num_probes = 0;
 
+    // Deletes shift entries back instead of leaving tombstones, so the
+    // first empty slot always ends the probe sequence
     while (num_probes < lut_length)
     {
         uintptr_t lut_res = set->entry_lookup_table[lut_index];
 
-        bool is_empty = lut_res == JSL__HASHMAP_EMPTY;
-        bool is_tombstone = lut_res == JSL__HASHMAP_TOMBSTONE;
-
-        if (is_empty)
+        if (lut_res == JSL__HASHMAP_EMPTY)
         {
-            *out_lut_index = tombstone_seen ? first_tombstone : lut_index;
+            *out_lut_index = lut_index;
             break;
         }
 
-        if (is_tombstone && !tombstone_seen)
-        {
-            first_tombstone = lut_index;
-            tombstone_seen = true;
-        }
-
-        bool slot_has_entry = !is_empty && !is_tombstone;
-        struct JSL__StrSetEntry* entry = slot_has_entry
-            ? (struct JSL__StrSetEntry*) lut_res
-            : NULL;
+        struct JSL__StrSetEntry* entry = (struct JSL__StrSetEntry*) lut_res;
 
         JSLImmutableMemory entry_value = jsl__get_entry_value(entry);
-        uint8_t status = entry != NULL ? entry->status : 0;
+        uint8_t status = entry->status;
 
-        bool matches = entry != NULL
-            && (status == JSL__STATE_VALUE_IS_SET || status == JSL__STATE_SSO_IS_SET)
-            && *out_hash == entry->hash
+        bool matches = (status == JSL__STATE_VALUE_IS_SET || status == JSL__STATE_SSO_IS_SET)
+            && hash == entry->hash
             && jsl_memory_compare(value, entry_value);
 
         if (matches)
@@ -303,51 +479,109 @@ static inline void jsl__str_set_probe(
             break;
         }
 
-        if (entry == NULL)
-        {
-            set->entry_lookup_table[lut_index] = JSL__HASHMAP_TOMBSTONE;
-            ++set->tombstone_count;
-        }
+        lut_index = (int64_t) (((uint64_t) lut_index + 1u) & lut_mask);
+        ++num_probes;
+    }
+}
 
-        if (entry == NULL && !tombstone_seen)
-        {
-            first_tombstone = lut_index;
-            tombstone_seen = true;
-        }
+static inline void jsl__str_set_probe(
+    JSLStrSet* set,
+    JSLImmutableMemory value,
+    int64_t* out_lut_index,
+    uint64_t* out_hash,
+    bool* out_found
+)
+{
+    *out_hash = jsl__rapidhash_withSeed(value.data, (size_t) value.length, set->hash_seed);
+    jsl__str_set_probe_hashed(set, value, *out_hash, out_lut_index, out_found);
+}
+
+/**
+ * Backward shift deletion: empty `start_slot` and pull later entries of
+ * the same probe run back into the hole, so lookups never have to skip
+ * over tombstones.
+ */
+static inline void jsl__str_set_backshift(
+    JSLStrSet* set,
+    int64_t start_slot
+)
+{
+    uint64_t lut_mask = (uint64_t) set->entry_lookup_table_length - 1u;
+
+    int64_t hole = start_slot;
+    int64_t current = (int64_t) (((uint64_t) start_slot + 1u) & lut_mask);
+
+    int64_t loop_check = 0;
+    while (loop_check < set->entry_lookup_table_length)
+    {
+        uintptr_t lut_res = set->entry_lookup_table[current];
+
+        if (lut_res == JSL__HASHMAP_EMPTY)
+            break;
+
+        struct JSL__StrSetEntry* entry = (struct JSL__StrSetEntry*) lut_res;
+        int64_t ideal_slot = (int64_t) (entry->hash & lut_mask);
 
-        if (searching)
+        bool should_move = (current > hole)
+            ? (ideal_slot <= hole || ideal_slot > current)
+            : (ideal_slot <= hole && ideal_slot > current);
+
+        if (should_move)
         {
-            lut_index = (int64_t) (((uint64_t) lut_index + 1u) & lut_mask);
-            ++num_probes;
+            set->entry_lookup_table[hole] = lut_res;
+            hole = current;
         }
-    }
 
-    if (num_probes >= lut_length)
-    {
-        *out_lut_index = tombstone_seen ? first_tombstone : -1;
+        current = (int64_t) (((uint64_t) current + 1u) & lut_mask);
+
+        ++loop_check;
     }
+
+    set->entry_lookup_table[hole] = JSL__HASHMAP_EMPTY;
 }
 
-JSL_STR_SET_DEF bool jsl_str_set_has(
+/**
+ * Membership test with an already computed hash, checks the old table of
+ * an in progress incremental rehash as well. Read only.
+ */
+static bool jsl__str_set_has_hashed(
     JSLStrSet* set,
-    JSLImmutableMemory value
+    JSLImmutableMemory value,
+    uint64_t hash
 )
 {
-    uint64_t hash = 0;
     int64_t lut_index = -1;
     bool existing_found = false;
+    jsl__str_set_probe_hashed(set, value, hash, &lut_index, &existing_found);
 
-    if (
+    bool found_in_new = lut_index > -1 && existing_found;
+    bool found_in_old = !found_in_new
+        && set->old_entry_lookup_table != NULL
+        && jsl__str_set_find_in_old_table(set, value, hash) > -1;
+
+    return found_in_new || found_in_old;
+}
+
+JSL_STR_SET_DEF bool jsl_str_set_has(
+    JSLStrSet* set,
+    JSLImmutableMemory value
+)
+{
+    bool params_valid = (
         set != NULL
         && set->sentinel == JSL__SET_PRIVATE_SENTINEL
         && value.data != NULL
         && value.length > -1
-    )
+    );
+
+    bool res = false;
+    if (params_valid)
     {
-        jsl__str_set_probe(set, value, &lut_index, &hash, &existing_found);
+        uint64_t hash = jsl__rapidhash_withSeed(value.data, (size_t) value.length, set->hash_seed);
+        res = jsl__str_set_has_hashed(set, value, hash);
     }
 
-    return lut_index > -1 && existing_found;
+    return res;
 }
 
 static JSL__FORCE_INLINE bool jsl__str_set_add(
@@ -359,7 +593,6 @@ static JSL__FORCE_INLINE bool jsl__str_set_add(
 )
 {
     struct JSL__StrSetEntry* entry = NULL;
-    bool replacing_tombstone = set->entry_lookup_table[lut_index] == JSL__HASHMAP_TOMBSTONE;
 
     // 
     // Allocate a new entry or copy one from the free list
@@ -384,10 +617,6 @@ static JSL__FORCE_INLINE bool jsl__str_set_add(
         ++set->item_count;
     }
 
-    if (entry != NULL && replacing_tombstone)
-    {
-        --set->tombstone_count;
-    }
 
     // 
     // Copy the value
@@ -424,43 +653,49 @@ static JSL__FORCE_INLINE bool jsl__str_set_add(
     return entry != NULL;
 }
 
-JSL_STR_SET_DEF bool jsl_str_set_insert(
+/**
+ * Insert with an already computed hash, which must come from this set's seed.
+ */
+static bool jsl__str_set_insert_hashed(
     JSLStrSet* set,
     JSLImmutableMemory value,
-    JSLStringLifeTime value_lifetime
+    JSLStringLifeTime value_lifetime,
+    uint64_t hash
 )
 { 
-    bool res = (
-        set != NULL
-        && set->sentinel == JSL__SET_PRIVATE_SENTINEL
-        && value.data != NULL
-        && value.length > -1
-    );
+    bool res = true;
+
+    if (set->old_entry_lookup_table != NULL)
+    {
+        jsl__str_set_migrate(set, set->rehash_step);
+    }
 
     bool needs_rehash = false;
     if (res)
     {
-        float occupied_count = (float) (set->item_count + set->tombstone_count);
-        float current_load_factor =  occupied_count / (float) set->entry_lookup_table_length;
-        bool too_many_tombstones = set->tombstone_count > (set->entry_lookup_table_length / 4);
-        needs_rehash = current_load_factor >= set->load_factor || too_many_tombstones;
+        float current_load_factor = (float) set->item_count / (float) set->entry_lookup_table_length;
+        needs_rehash = current_load_factor >= set->load_factor;
     }
 
     if (JSL__UNLIKELY(needs_rehash))
     {
-        res = jsl__str_set_rehash(set);
+        res = jsl__str_set_grow(set);
     }
 
-    uint64_t hash = 0;
     int64_t lut_index = -1;
     bool existing_found = false;
     if (res)
     {
-        jsl__str_set_probe(set, value, &lut_index, &hash, &existing_found);
+        jsl__str_set_probe_hashed(set, value, hash, &lut_index, &existing_found);
     }
+
+    bool found_in_old = res
+        && !existing_found
+        && set->old_entry_lookup_table != NULL
+        && jsl__str_set_find_in_old_table(set, value, hash) > -1;
     
     // new key
-    if (lut_index > -1 && !existing_found)
+    if (lut_index > -1 && !existing_found && !found_in_old)
     {
         res = jsl__str_set_add(
             set,
@@ -478,6 +713,28 @@ JSL_STR_SET_DEF bool jsl_str_set_insert(
     return res;
 }
 
+JSL_STR_SET_DEF bool jsl_str_set_insert(
+    JSLStrSet* set,
+    JSLImmutableMemory value,
+    JSLStringLifeTime value_lifetime
+)
+{ 
+    bool res = (
+        set != NULL
+        && set->sentinel == JSL__SET_PRIVATE_SENTINEL
+        && value.data != NULL
+        && value.length > -1
+    );
+
+    if (res)
+    {
+        uint64_t hash = jsl__rapidhash_withSeed(value.data, (size_t) value.length, set->hash_seed);
+        res = jsl__str_set_insert_hashed(set, value, value_lifetime, hash);
+    }
+
+    return res;
+}
+
 JSL_STR_SET_DEF bool jsl_str_set_iterator_init(
     JSLStrSet* set,
     JSLStrSetKeyValueIter* iterator
@@ -517,13 +774,20 @@ JSL_STR_SET_DEF bool jsl_str_set_iterator_next(
         && iterator->generational_id == iterator->set->generational_id
     );
 
+    // While an incremental rehash is in progress the old table is walked
+    // after the current one, as if the two were one long table
     int64_t lut_length = params_valid ? iterator->set->entry_lookup_table_length : 0;
+    int64_t old_length = params_valid && iterator->set->old_entry_lookup_table != NULL
+        ? iterator->set->old_entry_lookup_table_length
+        : 0;
     int64_t lut_index = iterator->current_lut_index;
     struct JSL__StrSetEntry* found_entry = NULL;
 
-    while (params_valid && lut_index < lut_length)
+    while (params_valid && lut_index < lut_length + old_length)
     {
-        uintptr_t lut_res = iterator->set->entry_lookup_table[lut_index];
+        uintptr_t lut_res = lut_index < lut_length
+            ? iterator->set->entry_lookup_table[lut_index]
+            : iterator->set->old_entry_lookup_table[lut_index - lut_length];
         bool occupied = lut_res != JSL__HASHMAP_EMPTY && lut_res != JSL__HASHMAP_TOMBSTONE;
 
         if (occupied)
@@ -561,7 +825,7 @@ JSL_STR_SET_DEF bool jsl_str_set_iterator_next(
     bool exhausted = params_valid && found_entry == NULL;
     if (exhausted)
     {
-        iterator->current_lut_index = lut_length;
+        iterator->current_lut_index = lut_length + old_length;
         found = false;
     }
 
@@ -582,6 +846,11 @@ JSL_STR_SET_DEF bool jsl_str_set_delete(
         && value.length > -1
     );
 
+    if (params_valid && set->old_entry_lookup_table != NULL)
+    {
+        jsl__str_set_migrate(set, set->rehash_step);
+    }
+
     uint64_t hash = 0;
     int64_t lut_index = -1;
     bool existing_found = false;
@@ -590,10 +859,27 @@ JSL_STR_SET_DEF bool jsl_str_set_delete(
         jsl__str_set_probe(set, value, &lut_index, &hash, &existing_found);
     }
 
-    if (existing_found && lut_index > -1)
+    int64_t old_index = -1;
+    if (params_valid && !existing_found && set->old_entry_lookup_table != NULL)
+    {
+        old_index = jsl__str_set_find_in_old_table(set, value, hash);
+    }
+
+    bool found_in_new = existing_found && lut_index > -1;
+
+    uintptr_t* found_slot = NULL;
+    if (found_in_new)
+    {
+        found_slot = &set->entry_lookup_table[lut_index];
+    }
+    else if (old_index > -1)
+    {
+        found_slot = &set->old_entry_lookup_table[old_index];
+    }
+
+    if (found_slot != NULL)
     {
-        struct JSL__StrSetEntry* entry =
-            (struct JSL__StrSetEntry*) set->entry_lookup_table[lut_index];
+        struct JSL__StrSetEntry* entry = (struct JSL__StrSetEntry*) *found_slot;
 
         jsl__str_set_entry_free_value(set, entry);
         entry->next = set->entry_free_list;
@@ -604,12 +890,20 @@ JSL_STR_SET_DEF bool jsl_str_set_delete(
         --set->item_count;
         ++set->generational_id;
 
-        set->entry_lookup_table[lut_index] = JSL__HASHMAP_TOMBSTONE;
-        ++set->tombstone_count;
-
         res = true;
     }
 
+    if (found_in_new)
+    {
+        jsl__str_set_backshift(set, lut_index);
+    }
+    // The old table keeps tombstones, shifting its entries back could move
+    // them behind the migration cursor where they would never be moved over
+    else if (found_slot != NULL)
+    {
+        *found_slot = JSL__HASHMAP_TOMBSTONE;
+    }
+
     return res;
 }
 
@@ -622,12 +916,20 @@ JSL_STR_SET_DEF void jsl_str_set_clear(
         && set->sentinel == JSL__SET_PRIVATE_SENTINEL
     );
 
+    // Entries which have not been migrated yet are recycled from the old
+    // table, then the old table is dropped and the rehash is over
     int64_t lut_length = params_valid ? set->entry_lookup_table_length : 0;
+    int64_t old_length = params_valid && set->old_entry_lookup_table != NULL
+        ? set->old_entry_lookup_table_length
+        : 0;
     int64_t index = 0;
 
-    while (params_valid && index < lut_length)
+    while (params_valid && index < lut_length + old_length)
     {
-        uintptr_t lut_res = set->entry_lookup_table[index];
+        uintptr_t* slot = index < lut_length
+            ? &set->entry_lookup_table[index]
+            : &set->old_entry_lookup_table[index - lut_length];
+        uintptr_t lut_res = *slot;
 
         if (lut_res != JSL__HASHMAP_EMPTY && lut_res != JSL__HASHMAP_TOMBSTONE)
         {
@@ -637,20 +939,27 @@ JSL_STR_SET_DEF void jsl_str_set_clear(
             entry->status = JSL__STATE_IN_FREE_LIST;
             entry->lifetime = JSL_STRING_LIFETIME_SHORTER;
             set->entry_free_list = entry;
-            set->entry_lookup_table[index] = JSL__HASHMAP_EMPTY;
+            *slot = JSL__HASHMAP_EMPTY;
         }
         else if (lut_res == JSL__HASHMAP_TOMBSTONE)
         {
-            set->entry_lookup_table[index] = JSL__HASHMAP_EMPTY;
+            *slot = JSL__HASHMAP_EMPTY;
         }
 
         ++index;
     }
 
+    if (params_valid && set->old_entry_lookup_table != NULL)
+    {
+        jsl_allocator_interface_free(set->allocator, set->old_entry_lookup_table);
+        set->old_entry_lookup_table = NULL;
+        set->old_entry_lookup_table_length = 0;
+        set->rehash_migrate_index = 0;
+    }
+
     if (params_valid)
     {
         set->item_count = 0;
-        set->tombstone_count = 0;
         ++set->generational_id;
     }
 
@@ -668,11 +977,16 @@ JSL_STR_SET_DEF void jsl_str_set_free(
 
     uintptr_t* lut = params_valid ? set->entry_lookup_table : NULL;
     int64_t lut_length = params_valid ? set->entry_lookup_table_length : 0;
+    int64_t old_length = params_valid && set->old_entry_lookup_table != NULL
+        ? set->old_entry_lookup_table_length
+        : 0;
 
     int64_t lut_index = 0;
-    while (params_valid && lut_index < lut_length)
+    while (params_valid && lut_index < lut_length + old_length)
     {
-        uintptr_t lut_res = lut[lut_index];
+        uintptr_t lut_res = lut_index < lut_length
+            ? lut[lut_index]
+            : set->old_entry_lookup_table[lut_index - lut_length];
         if (lut_res != JSL__HASHMAP_EMPTY && lut_res != JSL__HASHMAP_TOMBSTONE)
         {
             struct JSL__StrSetEntry* entry = (struct JSL__StrSetEntry*) lut_res;
@@ -696,92 +1010,426 @@ JSL_STR_SET_DEF void jsl_str_set_free(
         jsl_allocator_interface_free(set->allocator, set->entry_lookup_table);
     }
 
+    if (params_valid && set->old_entry_lookup_table != NULL)
+    {
+        jsl_allocator_interface_free(set->allocator, set->old_entry_lookup_table);
+    }
+
     set->sentinel = 0;
 }
 
-JSL_STR_SET_DEF bool jsl_str_set_intersection(
-    JSLStrSet* a,
-    JSLStrSet* b,
-    JSLStrSet* out
+JSL_STR_SET_DEF bool jsl_str_set_enable_incremental_rehash(
+    JSLStrSet* set,
+    int64_t slots_per_operation
 )
 {
-    bool params_valid = (
-        a != NULL
-        && b != NULL
-        && out != NULL
-        && a->sentinel == JSL__SET_PRIVATE_SENTINEL
-        && b->sentinel == JSL__SET_PRIVATE_SENTINEL
-        && out->sentinel == JSL__SET_PRIVATE_SENTINEL
+    bool res = (
+        set != NULL
+        && set->sentinel == JSL__SET_PRIVATE_SENTINEL
+        && slots_per_operation > -1
     );
 
-    JSLStrSet* smaller = NULL;
-    JSLStrSet* larger = NULL;
+    if (res)
+    {
+        set->rehash_step = slots_per_operation;
+    }
 
-    if (params_valid)
+    if (res && slots_per_operation == 0)
     {
-        smaller = a->item_count <= b->item_count ? a : b;
-        larger = a->item_count > b->item_count ? a : b;
+        res = jsl_str_set_finish_rehash(set);
+    }
+
+    return res;
+}
+
+JSL_STR_SET_DEF bool jsl_str_set_finish_rehash(
+    JSLStrSet* set
+)
+{
+    bool res = (
+        set != NULL
+        && set->sentinel == JSL__SET_PRIVATE_SENTINEL
+    );
+
+    if (res && set->old_entry_lookup_table != NULL)
+    {
+        jsl__str_set_migrate(set, INT64_MAX);
+        ++set->generational_id;
+    }
+
+    return res;
+}
+
+/**
+ * Grow the lookup table up front so that `item_count` items fit without
+ * any rehash along the way.
+ */
+static bool jsl__str_set_presize(
+    JSLStrSet* set,
+    int64_t item_count
+)
+{
+    bool res = true;
+
+    double slots_needed = (double) item_count / (double) set->load_factor;
+    bool size_possible = slots_needed < (double) (INT64_MAX / (int64_t) sizeof(uintptr_t) / 2);
+    bool needs_growth = size_possible
+        && slots_needed >= (double) set->entry_lookup_table_length;
+
+    if (needs_growth)
+    {
+        int64_t new_length = jsl_next_power_of_two_i64((int64_t) slots_needed + 1);
+        jsl__str_set_migrate(set, INT64_MAX);
+        res = jsl__str_set_rehash_to_length(set, new_length);
+    }
+
+    return res;
+}
+
+/**
+ * Smallest lookup table length that holds `item_count` values without
+ * going over the load factor, or -1 if it's too large.
+ */
+static int64_t jsl__str_set_lookup_table_length_for(
+    JSLStrSet* set,
+    int64_t item_count
+)
+{
+    double slots_needed = (double) item_count / (double) set->load_factor;
+    bool size_possible = slots_needed < (double) (INT64_MAX / (int64_t) sizeof(uintptr_t) / 2);
+
+    return size_possible
+        ? jsl_next_power_of_two_i64(JSL_MAX((int64_t) slots_needed + 1, 32L))
+        : -1;
+}
+
+JSL_STR_SET_DEF bool jsl_str_set_reserve(
+    JSLStrSet* set,
+    int64_t item_count
+)
+{
+    bool res = (
+        set != NULL
+        && set->sentinel == JSL__SET_PRIVATE_SENTINEL
+        && item_count > -1
+    );
+
+    int64_t new_length = res
+        ? jsl__str_set_lookup_table_length_for(set, item_count)
+        : -1;
+
+    res = res && new_length > 0 && jsl_str_set_finish_rehash(set);
+
+    if (res && new_length > set->entry_lookup_table_length)
+    {
+        res = jsl__str_set_rehash_to_length(set, new_length);
+    }
+
+    return res;
+}
+
+JSL_STR_SET_DEF bool jsl_str_set_shrink_to_fit(
+    JSLStrSet* set
+)
+{
+    bool res = (
+        set != NULL
+        && set->sentinel == JSL__SET_PRIVATE_SENTINEL
+    );
+
+    res = res && jsl_str_set_finish_rehash(set);
+
+    struct JSL__StrSetEntry* entry = res ? set->entry_free_list : NULL;
+    while (entry != NULL)
+    {
+        struct JSL__StrSetEntry* next = entry->next;
+        jsl_allocator_interface_free(set->allocator, entry);
+        entry = next;
+    }
+
+    if (res)
+    {
+        set->entry_free_list = NULL;
     }
 
-    JSLStrSetKeyValueIter iterator = {0};
-    jsl_str_set_iterator_init(smaller, &iterator);
+    int64_t new_length = res
+        ? jsl__str_set_lookup_table_length_for(set, set->item_count)
+        : -1;
 
-    bool success = params_valid;
-    JSLImmutableMemory out_value = {0};
-    while (success && jsl_str_set_iterator_next(&iterator, &out_value))
+    if (res && new_length > 0 && new_length < set->entry_lookup_table_length)
     {
-        if (jsl_str_set_has(larger, out_value) && !jsl_str_set_insert(out, out_value, JSL_STRING_LIFETIME_SHORTER))
+        res = jsl__str_set_rehash_to_length(set, new_length);
+    }
+
+    return res;
+}
+
+JSL_STR_SET_DEF int64_t jsl_str_set_memory_footprint(
+    JSLStrSet* set
+)
+{
+    bool params_valid = (
+        set != NULL
+        && set->sentinel == JSL__SET_PRIVATE_SENTINEL
+    );
+
+    int64_t lut_length = params_valid ? set->entry_lookup_table_length : 0;
+    int64_t old_length = params_valid && set->old_entry_lookup_table != NULL
+        ? set->old_entry_lookup_table_length
+        : 0;
+
+    int64_t res = params_valid
+        ? (int64_t) sizeof(uintptr_t) * (lut_length + old_length)
+        : -1;
+
+    int64_t lut_index = 0;
+    while (params_valid && lut_index < lut_length + old_length)
+    {
+        uintptr_t lut_res = lut_index < lut_length
+            ? set->entry_lookup_table[lut_index]
+            : set->old_entry_lookup_table[lut_index - lut_length];
+
+        if (lut_res != JSL__HASHMAP_EMPTY && lut_res != JSL__HASHMAP_TOMBSTONE)
         {
-            success = false;
+            struct JSL__StrSetEntry* entry = (struct JSL__StrSetEntry*) lut_res;
+            res += (int64_t) sizeof(struct JSL__StrSetEntry);
+
+            bool duplicated = entry->status == JSL__STATE_VALUE_IS_SET
+                && entry->lifetime == JSL_STRING_LIFETIME_SHORTER;
+            if (duplicated)
+                res += entry->value.length;
         }
+
+        ++lut_index;
     }
 
-    return success;
+    struct JSL__StrSetEntry* entry = params_valid ? set->entry_free_list : NULL;
+    while (entry != NULL)
+    {
+        res += (int64_t) sizeof(struct JSL__StrSetEntry);
+        entry = entry->next;
+    }
+
+    return res;
 }
 
-JSL_STR_SET_DEF bool jsl_str_set_union(
+/**
+ * The hash of `entry`, which lives in `source`, under the seed of `target`.
+ * Sets that share a seed share hashes, so the stored one is reused.
+ */
+static JSL__FORCE_INLINE uint64_t jsl__str_set_hash_for(
+    JSLStrSet* source,
+    struct JSL__StrSetEntry* entry,
+    JSLImmutableMemory value,
+    JSLStrSet* target
+)
+{
+    return source->hash_seed == target->hash_seed
+        ? entry->hash
+        : jsl__rapidhash_withSeed(value.data, (size_t) value.length, target->hash_seed);
+}
+
+/**
+ * Shared loop of the set operations. Copies every value stored in the
+ * slots `[begin_slot, end_slot)` of `source` into `out`, skipping values
+ * whose membership in `filter` doesn't equal `keep_if_in_filter`. A NULL
+ * `filter` keeps everything.
+ *
+ * Slots past the end of the current table index into the old table of an
+ * in progress incremental rehash, the same way the iterator walks them.
+ * Only `out` is written to, so calls with distinct `out` sets can run on
+ * different threads.
+ */
+static bool jsl__str_set_copy_filtered(
+    JSLStrSet* source,
+    int64_t begin_slot,
+    int64_t end_slot,
+    JSLStrSet* filter,
+    bool keep_if_in_filter,
+    JSLStrSet* out,
+    JSLStringLifeTime value_lifetime
+)
+{
+    bool res = true;
+
+    int64_t lut_length = source->entry_lookup_table_length;
+
+    for (int64_t slot = begin_slot; res && slot < end_slot; ++slot)
+    {
+        uintptr_t lut_res = slot < lut_length
+            ? source->entry_lookup_table[slot]
+            : source->old_entry_lookup_table[slot - lut_length];
+
+        if (lut_res == JSL__HASHMAP_EMPTY || lut_res == JSL__HASHMAP_TOMBSTONE)
+            continue;
+
+        struct JSL__StrSetEntry* entry = (struct JSL__StrSetEntry*) lut_res;
+        if (entry->status != JSL__STATE_VALUE_IS_SET && entry->status != JSL__STATE_SSO_IS_SET)
+            continue;
+
+        JSLImmutableMemory value = jsl__get_entry_value(entry);
+
+        bool keep = true;
+        if (filter != NULL)
+        {
+            uint64_t filter_hash = jsl__str_set_hash_for(source, entry, value, filter);
+            keep = jsl__str_set_has_hashed(filter, value, filter_hash) == keep_if_in_filter;
+        }
+
+        // Short values are copied into the entry either way, only borrow
+        // values which would otherwise need their own allocation
+        JSLStringLifeTime lifetime = value.length > JSL__STR_SET_SSO_LENGTH
+            ? value_lifetime
+            : JSL_STRING_LIFETIME_SHORTER;
+
+        if (keep)
+        {
+            uint64_t out_hash = jsl__str_set_hash_for(source, entry, value, out);
+            res = jsl__str_set_insert_hashed(out, value, lifetime, out_hash);
+        }
+    }
+
+    return res;
+}
+
+static JSL__FORCE_INLINE int64_t jsl__str_set_slot_count(
+    JSLStrSet* set
+)
+{
+    return set->entry_lookup_table_length
+        + (set->old_entry_lookup_table != NULL ? set->old_entry_lookup_table_length : 0);
+}
+
+static JSL__FORCE_INLINE bool jsl__str_set_operation_params_valid(
     JSLStrSet* a,
     JSLStrSet* b,
-    JSLStrSet* out
+    JSLStrSet* out,
+    JSLStringLifeTime value_lifetime
 )
 {
-    bool params_valid = (
+    return (
         a != NULL
         && b != NULL
         && out != NULL
         && a->sentinel == JSL__SET_PRIVATE_SENTINEL
         && b->sentinel == JSL__SET_PRIVATE_SENTINEL
         && out->sentinel == JSL__SET_PRIVATE_SENTINEL
+        && out != a
+        && out != b
+        && (value_lifetime == JSL_STRING_LIFETIME_SHORTER || value_lifetime == JSL_STRING_LIFETIME_LONGER)
     );
+}
 
-    JSLStrSetKeyValueIter a_iterator = {0};
-    JSLStrSetKeyValueIter b_iterator = {0};
+JSL_STR_SET_DEF bool jsl_str_set_intersection2(
+    JSLStrSet* a,
+    JSLStrSet* b,
+    JSLStrSet* out,
+    JSLStringLifeTime value_lifetime
+)
+{
+    bool res = jsl__str_set_operation_params_valid(a, b, out, value_lifetime);
 
-    if (params_valid)
+    // Walk the smaller set and look its values up in the larger one
+    JSLStrSet* smaller = NULL;
+    JSLStrSet* larger = NULL;
+    if (res)
     {
-        jsl_str_set_iterator_init(a, &a_iterator);
-        jsl_str_set_iterator_init(b, &b_iterator);
+        smaller = a->item_count <= b->item_count ? a : b;
+        larger = a->item_count <= b->item_count ? b : a;
+        res = jsl__str_set_presize(out, out->item_count + smaller->item_count);
     }
 
-    bool success = params_valid;
-    JSLImmutableMemory out_value = {0};
-    while (success && jsl_str_set_iterator_next(&a_iterator, &out_value))
+    if (res)
     {
-        if (!jsl_str_set_insert(out, out_value, JSL_STRING_LIFETIME_SHORTER))
-        {
-            success = false;
-        }
+        res = jsl__str_set_copy_filtered(
+            smaller, 0, jsl__str_set_slot_count(smaller),
+            larger, true,
+            out, value_lifetime
+        );
     }
 
-    while (success && jsl_str_set_iterator_next(&b_iterator, &out_value))
+    return res;
+}
+
+JSL_STR_SET_DEF bool jsl_str_set_union2(
+    JSLStrSet* a,
+    JSLStrSet* b,
+    JSLStrSet* out,
+    JSLStringLifeTime value_lifetime
+)
+{
+    bool res = jsl__str_set_operation_params_valid(a, b, out, value_lifetime);
+
+    // Presize for the larger input, anything past that depends on the
+    // overlap and is left to the regular growth
+    if (res)
     {
-        if (!jsl_str_set_insert(out, out_value, JSL_STRING_LIFETIME_SHORTER))
-        {
-            success = false;
-        }
+        res = jsl__str_set_presize(out, out->item_count + JSL_MAX(a->item_count, b->item_count));
+    }
+
+    if (res)
+    {
+        res = jsl__str_set_copy_filtered(
+            a, 0, jsl__str_set_slot_count(a),
+            NULL, true,
+            out, value_lifetime
+        );
+    }
+
+    if (res)
+    {
+        res = jsl__str_set_copy_filtered(
+            b, 0, jsl__str_set_slot_count(b),
+            NULL, true,
+            out, value_lifetime
+        );
+    }
+
+    return res;
+}
+
+JSL_STR_SET_DEF bool jsl_str_set_difference2(
+    JSLStrSet* a,
+    JSLStrSet* b,
+    JSLStrSet* out,
+    JSLStringLifeTime value_lifetime
+)
+{
+    bool res = jsl__str_set_operation_params_valid(a, b, out, value_lifetime);
+
+    if (res)
+    {
+        res = jsl__str_set_presize(out, out->item_count + a->item_count);
     }
 
-    return params_valid && success;
+    if (res)
+    {
+        res = jsl__str_set_copy_filtered(
+            a, 0, jsl__str_set_slot_count(a),
+            b, false,
+            out, value_lifetime
+        );
+    }
+
+    return res;
+}
+
+JSL_STR_SET_DEF bool jsl_str_set_intersection(
+    JSLStrSet* a,
+    JSLStrSet* b,
+    JSLStrSet* out
+)
+{
+    return jsl_str_set_intersection2(a, b, out, JSL_STRING_LIFETIME_SHORTER);
+}
+
+JSL_STR_SET_DEF bool jsl_str_set_union(
+    JSLStrSet* a,
+    JSLStrSet* b,
+    JSLStrSet* out
+)
+{
+    return jsl_str_set_union2(a, b, out, JSL_STRING_LIFETIME_SHORTER);
 }
 
 JSL_STR_SET_DEF bool jsl_str_set_difference(
@@ -790,34 +1438,112 @@ JSL_STR_SET_DEF bool jsl_str_set_difference(
     JSLStrSet* out
 )
 {
-    bool params_valid = (
-        a != NULL
-        && b != NULL
-        && out != NULL
-        && a->sentinel == JSL__SET_PRIVATE_SENTINEL
-        && b->sentinel == JSL__SET_PRIVATE_SENTINEL
-        && out->sentinel == JSL__SET_PRIVATE_SENTINEL
+    return jsl_str_set_difference2(a, b, out, JSL_STRING_LIFETIME_SHORTER);
+}
+
+static bool jsl__str_set_partition_params_valid(
+    JSLStrSet* a,
+    JSLStrSet* b,
+    JSLStrSet* out,
+    JSLStringLifeTime value_lifetime,
+    int64_t partition_index,
+    int64_t partition_count
+)
+{
+    return jsl__str_set_operation_params_valid(a, b, out, value_lifetime)
+        && partition_count > 0
+        && partition_index > -1
+        && partition_index < partition_count;
+}
+
+/**
+ * Slot range `[*out_begin, *out_end)` of `set` covered by one partition.
+ */
+static void jsl__str_set_partition_range(
+    JSLStrSet* set,
+    int64_t partition_index,
+    int64_t partition_count,
+    int64_t* out_begin,
+    int64_t* out_end
+)
+{
+    int64_t slot_count = jsl__str_set_slot_count(set);
+    int64_t per_partition = slot_count / partition_count;
+    int64_t remainder = slot_count % partition_count;
+
+    // The first `remainder` partitions take one extra slot each
+    *out_begin = partition_index * per_partition + JSL_MIN(partition_index, remainder);
+    *out_end = *out_begin + per_partition + (partition_index < remainder ? 1 : 0);
+}
+
+JSL_STR_SET_DEF bool jsl_str_set_intersection_partition(
+    JSLStrSet* a,
+    JSLStrSet* b,
+    JSLStrSet* out,
+    JSLStringLifeTime value_lifetime,
+    int64_t partition_index,
+    int64_t partition_count
+)
+{
+    bool res = jsl__str_set_partition_params_valid(
+        a, b, out, value_lifetime, partition_index, partition_count
     );
 
-    JSLStrSetKeyValueIter iterator = {0};
+    JSLStrSet* smaller = NULL;
+    JSLStrSet* larger = NULL;
+    int64_t begin_slot = 0;
+    int64_t end_slot = 0;
+    if (res)
+    {
+        smaller = a->item_count <= b->item_count ? a : b;
+        larger = a->item_count <= b->item_count ? b : a;
+        jsl__str_set_partition_range(smaller, partition_index, partition_count, &begin_slot, &end_slot);
+        res = jsl__str_set_presize(out, out->item_count + smaller->item_count / partition_count);
+    }
 
-    if (params_valid)
+    if (res)
+    {
+        res = jsl__str_set_copy_filtered(
+            smaller, begin_slot, end_slot,
+            larger, true,
+            out, value_lifetime
+        );
+    }
+
+    return res;
+}
+
+JSL_STR_SET_DEF bool jsl_str_set_difference_partition(
+    JSLStrSet* a,
+    JSLStrSet* b,
+    JSLStrSet* out,
+    JSLStringLifeTime value_lifetime,
+    int64_t partition_index,
+    int64_t partition_count
+)
+{
+    bool res = jsl__str_set_partition_params_valid(
+        a, b, out, value_lifetime, partition_index, partition_count
+    );
+
+    int64_t begin_slot = 0;
+    int64_t end_slot = 0;
+    if (res)
     {
-        jsl_str_set_iterator_init(a, &iterator);
+        jsl__str_set_partition_range(a, partition_index, partition_count, &begin_slot, &end_slot);
+        res = jsl__str_set_presize(out, out->item_count + a->item_count / partition_count);
     }
 
-    bool success = params_valid;
-    JSLImmutableMemory out_value = {0};
-    while (success && jsl_str_set_iterator_next(&iterator, &out_value))
+    if (res)
     {
-        bool do_insert = jsl_str_set_has(b, out_value) == false;
-        if (do_insert && !jsl_str_set_insert(out, out_value, JSL_STRING_LIFETIME_SHORTER))
-        {
-            success = false;
-        }
+        res = jsl__str_set_copy_filtered(
+            a, begin_slot, end_slot,
+            b, false,
+            out, value_lifetime
+        );
     }
 
-    return success;
+    return res;
 }
 
 #undef JSL__SET_PRIVATE_SENTINEL
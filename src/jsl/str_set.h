@@ -20,6 +20,12 @@
  * * have an initial item count guess as accurate as you can to reduce rehashes
  * * have the arena have as short a lifetime as possible
  * 
+ * By default a rehash moves every entry into the new table at once, which
+ * is a long pause on large sets. Latency sensitive users can turn on
+ * incremental rehashing with `jsl_str_set_enable_incremental_rehash`,
+ * which keeps the old table around and moves a few slots on every insert
+ * and delete instead.
+ * 
  * ## License
  *
  * Copyright (c) 2026 Jack Stouffer
@@ -112,8 +118,15 @@ struct JSL__StrSet {
     uintptr_t* entry_lookup_table;
     int64_t entry_lookup_table_length;
 
+    /// @brief previous table while an incremental rehash is in progress, NULL otherwise
+    uintptr_t* old_entry_lookup_table;
+    int64_t old_entry_lookup_table_length;
+    /// @brief next slot in the old table to move into the current table
+    int64_t rehash_migrate_index;
+    /// @brief old table slots moved per insert or delete, zero when incremental rehashing is off
+    int64_t rehash_step;
+
     int64_t item_count;
-    int64_t tombstone_count;
 
     struct JSL__StrSetEntry* entry_free_list;
 
@@ -159,6 +172,19 @@ struct JSL__StrSet {
  *  * jsl_str_set_iterator_next
  *  * jsl_str_set_delete
  *  * jsl_str_set_clear
+ *  * jsl_str_set_enable_incremental_rehash
+ *  * jsl_str_set_finish_rehash
+ *  * jsl_str_set_reserve
+ *  * jsl_str_set_shrink_to_fit
+ *  * jsl_str_set_memory_footprint
+ *  * jsl_str_set_intersection
+ *  * jsl_str_set_intersection2
+ *  * jsl_str_set_intersection_partition
+ *  * jsl_str_set_union
+ *  * jsl_str_set_union2
+ *  * jsl_str_set_difference
+ *  * jsl_str_set_difference2
+ *  * jsl_str_set_difference_partition
  *
  */
 typedef struct JSL__StrSet JSLStrSet;
@@ -353,6 +379,78 @@ JSL_STR_SET_DEF void jsl_str_set_clear(
     JSLStrSet* set
 );
 
+/**
+ * Spread future rehashes out over many operations instead of doing them all
+ * at once. Each insert or delete moves `slots_per_operation` slots of the
+ * old table into the new one until the old table is drained. Lookups check
+ * both tables while a rehash is in progress but never move entries.
+ *
+ * @param set Set to configure.
+ * @param slots_per_operation Old table slots to move per operation, or
+ * zero to turn incremental rehashing off, which finishes any rehash in progress.
+ * @return `true` on success, `false` on invalid parameters.
+ */
+JSL_STR_SET_DEF bool jsl_str_set_enable_incremental_rehash(
+    JSLStrSet* set,
+    int64_t slots_per_operation
+);
+
+/**
+ * Move every remaining entry of an in progress incremental rehash into the
+ * current table and free the old table. Does nothing if no rehash is in
+ * progress. Iterators become invalid.
+ *
+ * @param set Set to finish rehashing.
+ * @return `true` on success, `false` on invalid parameters.
+ */
+JSL_STR_SET_DEF bool jsl_str_set_finish_rehash(
+    JSLStrSet* set
+);
+
+/**
+ * Grow the lookup table once so that `item_count` values fit without any
+ * rehash along the way. Does nothing if the table is already big enough.
+ * Any incremental rehash in progress is finished first. Iterators become
+ * invalid.
+ *
+ * @param set Set to grow.
+ * @param item_count Number of values the set should hold.
+ * @return `true` on success, `false` on invalid parameters or out of memory.
+ */
+JSL_STR_SET_DEF bool jsl_str_set_reserve(
+    JSLStrSet* set,
+    int64_t item_count
+);
+
+/**
+ * Give memory which isn't needed for the current values back to the
+ * allocator. The entries recycled by deletes are freed and the values are
+ * moved into the smallest lookup table that holds them at the load factor,
+ * never smaller than 32 slots. Any incremental rehash in progress is
+ * finished first. Iterators become invalid.
+ *
+ * @param set Set to compact.
+ * @return `true` on success, `false` on invalid parameters or out of memory.
+ */
+JSL_STR_SET_DEF bool jsl_str_set_shrink_to_fit(
+    JSLStrSet* set
+);
+
+/**
+ * Get the number of bytes this set holds from its allocator. This is the
+ * lookup tables, every entry including the ones recycled by deletes, and
+ * the copies of values which were too long for the small string buffer.
+ * Allocator bookkeeping and alignment padding aren't counted.
+ *
+ * This walks every entry, so avoid calling it after every insert.
+ *
+ * @param set Set to measure.
+ * @return The size in bytes, or -1 on invalid parameters.
+ */
+JSL_STR_SET_DEF int64_t jsl_str_set_memory_footprint(
+    JSLStrSet* set
+);
+
 /**
  * Frees all of the memory for this set and sets in an invalid state from the set.
  * If you wish to reuse this set after calling this function, you must call init again.
@@ -366,6 +464,7 @@ JSL_STR_SET_DEF void jsl_str_set_free(
 /**
  * Fill a set `out` with only the values which exist in both sets `a` and `b`.
  * All of the values inserted into out are copied with `JSL_STRING_LIFETIME_SHORTER`.
+ * Same as `jsl_str_set_intersection2` with `JSL_STRING_LIFETIME_SHORTER`.
  * 
  * @param a A string set
  * @param b A string set
@@ -381,6 +480,7 @@ JSL_STR_SET_DEF bool jsl_str_set_intersection(
 /**
  * Fill a set `out` with all of the values from `a` and `b`.
  * All of the values inserted into out are copied with `JSL_STRING_LIFETIME_SHORTER`.
+ * Same as `jsl_str_set_union2` with `JSL_STRING_LIFETIME_SHORTER`.
  * 
  * @param a A string set
  * @param b A string set
@@ -396,6 +496,7 @@ JSL_STR_SET_DEF bool jsl_str_set_union(
 /**
  * Fill a set `out` with all of the values in `a` that are not in `b`.
  * All of the values inserted into out are copied with `JSL_STRING_LIFETIME_SHORTER`.
+ * Same as `jsl_str_set_difference2` with `JSL_STRING_LIFETIME_SHORTER`.
  * 
  * @param a A string set
  * @param b A string set
@@ -408,6 +509,126 @@ JSL_STR_SET_DEF bool jsl_str_set_difference(
     JSLStrSet* out
 );
 
+/**
+ * Fill a set `out` with only the values which exist in both sets `a` and `b`.
+ *
+ * The smaller set is walked and each of its values is looked up in the
+ * larger one. When the sets were initialized with the same seed the hashes
+ * already stored in the entries are reused instead of hashing every value
+ * again, so give sets that are combined often the same seed. The lookup
+ * table of `out` is grown up front to fit the result.
+ *
+ * With `JSL_STRING_LIFETIME_LONGER`, values too long for the small string
+ * buffer are not copied, `out` points at the storage of `a` and `b`
+ * instead. Both sets must then outlive `out` and not delete those values
+ * while `out` is in use.
+ *
+ * @param a A string set
+ * @param b A string set
+ * @param out The string set to fill, must not be `a` or `b`
+ * @param value_lifetime How values are stored in `out`
+ * @returns if all of the values present in both sets were successfully added to `out`
+ */
+JSL_STR_SET_DEF bool jsl_str_set_intersection2(
+    JSLStrSet* a,
+    JSLStrSet* b,
+    JSLStrSet* out,
+    JSLStringLifeTime value_lifetime
+);
+
+/**
+ * Fill a set `out` with all of the values from `a` and `b`. Stored hashes
+ * are reused and `out` is presized the same way as in
+ * `jsl_str_set_intersection2`.
+ *
+ * @param a A string set
+ * @param b A string set
+ * @param out The string set to fill, must not be `a` or `b`
+ * @param value_lifetime How values are stored in `out`, see `jsl_str_set_intersection2`
+ * @returns if all of the values present in both sets were successfully added to `out`
+ */
+JSL_STR_SET_DEF bool jsl_str_set_union2(
+    JSLStrSet* a,
+    JSLStrSet* b,
+    JSLStrSet* out,
+    JSLStringLifeTime value_lifetime
+);
+
+/**
+ * Fill a set `out` with all of the values in `a` that are not in `b`.
+ * Stored hashes are reused and `out` is presized the same way as in
+ * `jsl_str_set_intersection2`.
+ *
+ * @param a A string set
+ * @param b A string set
+ * @param out The string set to fill, must not be `a` or `b`
+ * @param value_lifetime How values are stored in `out`, see `jsl_str_set_intersection2`
+ * @returns if all of the values present in `a` and not in `b` were successfully added to `out`
+ */
+JSL_STR_SET_DEF bool jsl_str_set_difference2(
+    JSLStrSet* a,
+    JSLStrSet* b,
+    JSLStrSet* out,
+    JSLStringLifeTime value_lifetime
+);
+
+/**
+ * Compute one share of the intersection of `a` and `b` for splitting very
+ * large intersections across threads.
+ *
+ * The lookup table of the smaller set is cut into `partition_count`
+ * contiguous ranges and only the values in range `partition_index` are
+ * checked. Lookups never modify a set, so every partition can run on its
+ * own thread at the same time as long as nothing mutates `a` or `b` and
+ * each call gets its own `out` set with its own allocator, or one that is
+ * safe to share between threads. The partial results are disjoint. Use
+ * them as shards directly, or combine them with `jsl_str_set_union2`,
+ * which reuses the stored hashes if all the sets share a seed.
+ *
+ * ```
+ * // on thread i of n
+ * jsl_str_set_intersection_partition(&a, &b, &partial[i], JSL_STRING_LIFETIME_LONGER, i, n);
+ * ```
+ *
+ * @param a A string set
+ * @param b A string set
+ * @param out The string set to fill, must not be `a` or `b`
+ * @param value_lifetime How values are stored in `out`, see `jsl_str_set_intersection2`
+ * @param partition_index Which partition to compute, from zero to `partition_count - 1`
+ * @param partition_count Total number of partitions
+ * @returns if all of the values of this partition were successfully added to `out`
+ */
+JSL_STR_SET_DEF bool jsl_str_set_intersection_partition(
+    JSLStrSet* a,
+    JSLStrSet* b,
+    JSLStrSet* out,
+    JSLStringLifeTime value_lifetime,
+    int64_t partition_index,
+    int64_t partition_count
+);
+
+/**
+ * Compute one share of the difference `a` minus `b`, partitioned over the
+ * lookup table of `a`. Same threading rules as
+ * `jsl_str_set_intersection_partition`.
+ *
+ * @param a A string set
+ * @param b A string set
+ * @param out The string set to fill, must not be `a` or `b`
+ * @param value_lifetime How values are stored in `out`, see `jsl_str_set_intersection2`
+ * @param partition_index Which partition to compute, from zero to `partition_count - 1`
+ * @param partition_count Total number of partitions
+ * @returns if all of the values of this partition were successfully added to `out`
+ */
+JSL_STR_SET_DEF bool jsl_str_set_difference_partition(
+    JSLStrSet* a,
+    JSLStrSet* b,
+    JSLStrSet* out,
+    JSLStringLifeTime value_lifetime,
+    int64_t partition_index,
+    int64_t partition_count
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,623 @@
+/**
+ * # JSL String Sort
+ *
+ * This file implements sorting and merging of arrays of `JSLImmutableMemory`
+ * strings. This file is part of the Jack's Standard Library project.
+ *
+ * ## Documentation
+ *
+ * See `docs/jsl_str_sort.md` for a formatted documentation page.
+ *
+ * ## License
+ *
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L
+    #include <stdbool.h>
+#endif
+
+#include "core.h"
+#include "allocator.h"
+#include "atomic_common.h"
+#include "str_sort.h"
+
+#define JSL__STR_SORT_PRIVATE_SENTINEL 6709712396528174093U
+
+// Ranges this small are finished with insertion sort
+#define JSL__STR_SORT_INSERTION_THRESHOLD 16
+
+// Number of string bytes held by each cached key
+#define JSL__STR_SORT_KEY_BYTES 7
+
+// One bucket for strings which end at the split depth plus one per byte
+#define JSL__STR_SORT_BUCKET_COUNT 257
+
+typedef struct JSL__StrMergeHead
+{
+    uint64_t key;
+    int64_t position;
+    int32_t run;
+} JSL__StrMergeHead;
+
+/**
+ * The seven bytes of `str` starting at `depth`, most significant first and
+ * zero padded, followed by a low byte holding the number of bytes left in
+ * the string capped at eight. Keys order the same way as the strings do
+ * over those bytes, the low byte breaks ties like "ab" vs "ab\0", and two
+ * equal keys with a low byte under eight mean the strings are equal.
+ */
+static inline uint64_t jsl__str_sort_key(JSLImmutableMemory str, int64_t depth)
+{
+    int64_t remaining = JSL_MAX(str.length - depth, (int64_t) 0);
+    int64_t take = JSL_MIN(remaining, (int64_t) JSL__STR_SORT_KEY_BYTES);
+
+    uint64_t key = 0;
+    for (int64_t i = 0; i < JSL__STR_SORT_KEY_BYTES; ++i)
+    {
+        key <<= 8;
+        if (i < take)
+            key |= str.data[depth + i];
+    }
+
+    return (key << 8) | (uint64_t) JSL_MIN(remaining, (int64_t) 8);
+}
+
+static inline bool jsl__str_sort_key_continues(uint64_t key)
+{
+    return (key & 0xFF) == 8;
+}
+
+static int32_t jsl__str_sort_compare_from(
+    JSLImmutableMemory a,
+    JSLImmutableMemory b,
+    int64_t depth
+)
+{
+    int64_t a_remaining = JSL_MAX(a.length - depth, (int64_t) 0);
+    int64_t b_remaining = JSL_MAX(b.length - depth, (int64_t) 0);
+    int64_t shared = JSL_MIN(a_remaining, b_remaining);
+
+    if (shared > 0)
+    {
+        int32_t memcmp_res = JSL_MEMCMP(a.data + depth, b.data + depth, (size_t) shared);
+        if (memcmp_res != 0)
+            return memcmp_res < 0 ? -1 : 1;
+    }
+
+    return (a_remaining > b_remaining) - (a_remaining < b_remaining);
+}
+
+static inline bool jsl__str_sort_less(
+    JSLImmutableMemory a,
+    uint64_t a_key,
+    JSLImmutableMemory b,
+    uint64_t b_key,
+    int64_t depth
+)
+{
+    if (a_key != b_key)
+        return a_key < b_key;
+    if (!jsl__str_sort_key_continues(a_key))
+        return false;
+    return jsl__str_sort_compare_from(a, b, depth + JSL__STR_SORT_KEY_BYTES) < 0;
+}
+
+static inline void jsl__str_sort_swap(
+    JSLImmutableMemory* strings,
+    uint64_t* keys,
+    int64_t a,
+    int64_t b
+)
+{
+    JSLImmutableMemory tmp_string = strings[a];
+    strings[a] = strings[b];
+    strings[b] = tmp_string;
+
+    uint64_t tmp_key = keys[a];
+    keys[a] = keys[b];
+    keys[b] = tmp_key;
+}
+
+static void jsl__str_sort_load_keys(
+    JSLImmutableMemory* strings,
+    uint64_t* keys,
+    int64_t count,
+    int64_t depth
+)
+{
+    for (int64_t i = 0; i < count; ++i)
+    {
+        keys[i] = jsl__str_sort_key(strings[i], depth);
+    }
+}
+
+static void jsl__str_sort_insertion(
+    JSLImmutableMemory* strings,
+    uint64_t* keys,
+    int64_t count,
+    int64_t depth
+)
+{
+    for (int64_t i = 1; i < count; ++i)
+    {
+        JSLImmutableMemory string = strings[i];
+        uint64_t key = keys[i];
+
+        int64_t j = i;
+        while (j > 0 && jsl__str_sort_less(string, key, strings[j - 1], keys[j - 1], depth))
+        {
+            strings[j] = strings[j - 1];
+            keys[j] = keys[j - 1];
+            --j;
+        }
+
+        strings[j] = string;
+        keys[j] = key;
+    }
+}
+
+static inline uint64_t jsl__str_sort_median(uint64_t a, uint64_t b, uint64_t c)
+{
+    if (a < b)
+        return b < c ? b : (a < c ? c : a);
+    else
+        return a < c ? a : (b < c ? c : b);
+}
+
+/**
+ * Multikey quicksort over the cached keys. `keys` must already hold the keys
+ * of `strings` at `depth`.
+ */
+static void jsl__str_sort_range(
+    JSLImmutableMemory* strings,
+    uint64_t* keys,
+    int64_t count,
+    int64_t depth
+)
+{
+    while (count > JSL__STR_SORT_INSERTION_THRESHOLD)
+    {
+        uint64_t pivot;
+        if (count > 1024)
+        {
+            int64_t step = count / 8;
+            pivot = jsl__str_sort_median(
+                jsl__str_sort_median(keys[0], keys[step], keys[step * 2]),
+                jsl__str_sort_median(keys[step * 3], keys[step * 4], keys[step * 5]),
+                jsl__str_sort_median(keys[step * 6], keys[step * 7], keys[count - 1])
+            );
+        }
+        else
+        {
+            pivot = jsl__str_sort_median(keys[0], keys[count / 2], keys[count - 1]);
+        }
+
+        // Three way partition into [0, less) < pivot, [less, greater) == pivot,
+        // and [greater, count) > pivot
+        int64_t less = 0;
+        int64_t greater = count;
+        int64_t i = 0;
+        while (i < greater)
+        {
+            uint64_t key = keys[i];
+            if (key < pivot)
+            {
+                jsl__str_sort_swap(strings, keys, less, i);
+                ++less;
+                ++i;
+            }
+            else if (key > pivot)
+            {
+                --greater;
+                jsl__str_sort_swap(strings, keys, i, greater);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        // Every key matched, which is common for long shared prefixes like
+        // timestamps, so move on to the next bytes without recursing
+        if (less == 0 && greater == count)
+        {
+            if (!jsl__str_sort_key_continues(pivot))
+                return;
+
+            depth += JSL__STR_SORT_KEY_BYTES;
+            jsl__str_sort_load_keys(strings, keys, count, depth);
+            continue;
+        }
+
+        // Everything in the middle shares these bytes, so only those strings
+        // need to look further into the data
+        int64_t equal_count = greater - less;
+        if (equal_count > 1 && jsl__str_sort_key_continues(pivot))
+        {
+            int64_t next_depth = depth + JSL__STR_SORT_KEY_BYTES;
+            jsl__str_sort_load_keys(strings + less, keys + less, equal_count, next_depth);
+            jsl__str_sort_range(strings + less, keys + less, equal_count, next_depth);
+        }
+
+        // Recurse into the smaller side to bound the stack depth
+        int64_t greater_count = count - greater;
+        if (less < greater_count)
+        {
+            jsl__str_sort_range(strings, keys, less, depth);
+            strings += greater;
+            keys += greater;
+            count = greater_count;
+        }
+        else
+        {
+            jsl__str_sort_range(strings + greater, keys + greater, greater_count, depth);
+            count = less;
+        }
+    }
+
+    jsl__str_sort_insertion(strings, keys, count, depth);
+}
+
+JSL_STR_SORT_DEF int32_t jsl_str_sort_compare(
+    JSLImmutableMemory a,
+    JSLImmutableMemory b
+)
+{
+    return jsl__str_sort_compare_from(a, b, 0);
+}
+
+JSL_STR_SORT_DEF bool jsl_str_sort(
+    JSLAllocatorInterface allocator,
+    JSLImmutableMemory* strings,
+    int64_t count
+)
+{
+    bool res = count > -1 && (strings != NULL || count == 0);
+
+    if (!res || count < 2)
+        return res;
+
+    uint64_t* keys = (uint64_t*) jsl_allocator_interface_alloc(
+        allocator,
+        (int64_t) sizeof(uint64_t) * count,
+        _Alignof(uint64_t),
+        false
+    );
+    res = keys != NULL;
+
+    if (res)
+    {
+        jsl__str_sort_load_keys(strings, keys, count, 0);
+        jsl__str_sort_range(strings, keys, count, 0);
+        jsl_allocator_interface_free(allocator, keys);
+    }
+
+    return res;
+}
+
+static inline int32_t jsl__str_sort_bucket(JSLImmutableMemory str, int64_t depth)
+{
+    return str.length > depth ? 1 + (int32_t) str.data[depth] : 0;
+}
+
+JSL_STR_SORT_DEF bool jsl_str_sort_job_init(
+    JSLStrSortJob* job,
+    JSLAllocatorInterface allocator,
+    JSLImmutableMemory* strings,
+    int64_t count
+)
+{
+    bool res = job != NULL && count > -1 && (strings != NULL || count == 0);
+
+    if (res)
+    {
+        JSL_MEMSET(job, 0, sizeof(JSLStrSortJob));
+        job->allocator = allocator;
+        job->strings = strings;
+        job->count = count;
+
+        job->keys = (uint64_t*) jsl_allocator_interface_alloc(
+            allocator,
+            (int64_t) sizeof(uint64_t) * JSL_MAX(count, (int64_t) 1),
+            _Alignof(uint64_t),
+            false
+        );
+        job->bucket_starts = (int64_t*) jsl_allocator_interface_alloc(
+            allocator,
+            (int64_t) sizeof(int64_t) * (JSL__STR_SORT_BUCKET_COUNT + 1),
+            _Alignof(int64_t),
+            true
+        );
+        job->bucket_order = (int32_t*) jsl_allocator_interface_alloc(
+            allocator,
+            (int64_t) sizeof(int32_t) * JSL__STR_SORT_BUCKET_COUNT,
+            _Alignof(int32_t),
+            false
+        );
+
+        res = job->keys != NULL
+            && job->bucket_starts != NULL
+            && job->bucket_order != NULL;
+    }
+
+    // Splitting on a byte every string shares would give one bucket, so
+    // split on the first byte after the common prefix instead
+    if (res && count > 0)
+    {
+        int64_t split_depth = strings[0].length;
+        for (int64_t i = 1; i < count && split_depth > 0; ++i)
+        {
+            int64_t limit = JSL_MIN(split_depth, strings[i].length);
+            int64_t shared = 0;
+            while (shared < limit && strings[i].data[shared] == strings[0].data[shared])
+                ++shared;
+            split_depth = shared;
+        }
+        job->split_depth = split_depth;
+    }
+
+    JSLImmutableMemory* scatter = NULL;
+    if (res && count > 1)
+    {
+        scatter = (JSLImmutableMemory*) jsl_allocator_interface_alloc(
+            allocator,
+            (int64_t) sizeof(JSLImmutableMemory) * count,
+            _Alignof(JSLImmutableMemory),
+            false
+        );
+        res = scatter != NULL;
+    }
+
+    if (res && count > 1)
+    {
+        int64_t* starts = job->bucket_starts;
+
+        for (int64_t i = 0; i < count; ++i)
+        {
+            ++starts[jsl__str_sort_bucket(strings[i], job->split_depth) + 1];
+        }
+        for (int32_t bucket = 0; bucket < JSL__STR_SORT_BUCKET_COUNT; ++bucket)
+        {
+            starts[bucket + 1] += starts[bucket];
+        }
+
+        int64_t offsets[JSL__STR_SORT_BUCKET_COUNT];
+        JSL_MEMCPY(offsets, starts, sizeof(offsets));
+        for (int64_t i = 0; i < count; ++i)
+        {
+            int32_t bucket = jsl__str_sort_bucket(strings[i], job->split_depth);
+            scatter[offsets[bucket]++] = strings[i];
+        }
+        JSL_MEMCPY(strings, scatter, sizeof(JSLImmutableMemory) * (size_t) count);
+
+        // Strings which end at the split depth are all equal, so bucket zero
+        // never needs sorting. Big buckets go first so the last bucket that
+        // gets claimed is a small one and threads finish close together.
+        for (int32_t bucket = 1; bucket < JSL__STR_SORT_BUCKET_COUNT; ++bucket)
+        {
+            int64_t size = starts[bucket + 1] - starts[bucket];
+            if (size < 2)
+                continue;
+
+            int32_t j = job->bucket_count;
+            while (j > 0)
+            {
+                int32_t previous = job->bucket_order[j - 1];
+                if (starts[previous + 1] - starts[previous] >= size)
+                    break;
+                job->bucket_order[j] = previous;
+                --j;
+            }
+            job->bucket_order[j] = bucket;
+            ++job->bucket_count;
+        }
+    }
+
+    if (scatter != NULL)
+        jsl_allocator_interface_free(allocator, scatter);
+
+    if (res)
+    {
+        job->sentinel = JSL__STR_SORT_PRIVATE_SENTINEL;
+    }
+    else if (job != NULL)
+    {
+        if (job->keys != NULL)
+            jsl_allocator_interface_free(allocator, job->keys);
+        if (job->bucket_starts != NULL)
+            jsl_allocator_interface_free(allocator, job->bucket_starts);
+        if (job->bucket_order != NULL)
+            jsl_allocator_interface_free(allocator, job->bucket_order);
+        JSL_MEMSET(job, 0, sizeof(JSLStrSortJob));
+    }
+
+    return res;
+}
+
+JSL_STR_SORT_DEF int32_t jsl_str_sort_job_work(
+    JSLStrSortJob* job
+)
+{
+    int32_t sorted = 0;
+
+    if (job == NULL || job->sentinel != JSL__STR_SORT_PRIVATE_SENTINEL)
+        return sorted;
+
+    int64_t depth = job->split_depth + 1;
+
+    for (;;)
+    {
+        uint64_t claim = jsl__atomic_fetch_add_u64(&job->next_bucket, 1);
+        if (claim >= (uint64_t) job->bucket_count)
+            break;
+
+        int32_t bucket = job->bucket_order[claim];
+        int64_t start = job->bucket_starts[bucket];
+        int64_t size = job->bucket_starts[bucket + 1] - start;
+
+        jsl__str_sort_load_keys(job->strings + start, job->keys + start, size, depth);
+        jsl__str_sort_range(job->strings + start, job->keys + start, size, depth);
+        ++sorted;
+    }
+
+    return sorted;
+}
+
+JSL_STR_SORT_DEF void jsl_str_sort_job_free(
+    JSLStrSortJob* job
+)
+{
+    if (job != NULL && job->sentinel == JSL__STR_SORT_PRIVATE_SENTINEL)
+    {
+        jsl_allocator_interface_free(job->allocator, job->keys);
+        jsl_allocator_interface_free(job->allocator, job->bucket_starts);
+        jsl_allocator_interface_free(job->allocator, job->bucket_order);
+        JSL_MEMSET(job, 0, sizeof(JSLStrSortJob));
+    }
+}
+
+static inline bool jsl__str_merge_head_less(
+    const JSLImmutableMemory* const* runs,
+    const JSL__StrMergeHead* a,
+    const JSL__StrMergeHead* b
+)
+{
+    if (a->key != b->key)
+        return a->key < b->key;
+
+    if (jsl__str_sort_key_continues(a->key))
+    {
+        int32_t compare_res = jsl__str_sort_compare_from(
+            runs[a->run][a->position],
+            runs[b->run][b->position],
+            JSL__STR_SORT_KEY_BYTES
+        );
+        if (compare_res != 0)
+            return compare_res < 0;
+    }
+
+    // Equal strings come out in run order
+    return a->run < b->run;
+}
+
+static void jsl__str_merge_sift_down(
+    const JSLImmutableMemory* const* runs,
+    JSL__StrMergeHead* heap,
+    int32_t heap_size,
+    int32_t index
+)
+{
+    JSL__StrMergeHead head = heap[index];
+
+    for (;;)
+    {
+        int32_t child = index * 2 + 1;
+        if (child >= heap_size)
+            break;
+
+        if (child + 1 < heap_size && jsl__str_merge_head_less(runs, &heap[child + 1], &heap[child]))
+            ++child;
+
+        if (!jsl__str_merge_head_less(runs, &heap[child], &head))
+            break;
+
+        heap[index] = heap[child];
+        index = child;
+    }
+
+    heap[index] = head;
+}
+
+JSL_STR_SORT_DEF int64_t jsl_str_merge(
+    JSLAllocatorInterface allocator,
+    const JSLImmutableMemory* const* runs,
+    const int64_t* run_lengths,
+    int32_t run_count,
+    JSLImmutableMemory* out
+)
+{
+    bool res = run_count > -1 && (run_count == 0 || (runs != NULL && run_lengths != NULL));
+
+    int64_t total = 0;
+    for (int32_t i = 0; res && i < run_count; ++i)
+    {
+        res = run_lengths[i] > -1 && (runs[i] != NULL || run_lengths[i] == 0);
+        total += res ? run_lengths[i] : 0;
+    }
+
+    res = res && (out != NULL || total == 0);
+
+    if (!res)
+        return -1;
+    if (total == 0)
+        return 0;
+
+    JSL__StrMergeHead* heap = (JSL__StrMergeHead*) jsl_allocator_interface_alloc(
+        allocator,
+        (int64_t) sizeof(JSL__StrMergeHead) * run_count,
+        _Alignof(JSL__StrMergeHead),
+        false
+    );
+    if (heap == NULL)
+        return -1;
+
+    int32_t heap_size = 0;
+    for (int32_t i = 0; i < run_count; ++i)
+    {
+        if (run_lengths[i] == 0)
+            continue;
+
+        heap[heap_size].key = jsl__str_sort_key(runs[i][0], 0);
+        heap[heap_size].position = 0;
+        heap[heap_size].run = i;
+        ++heap_size;
+    }
+    for (int32_t i = heap_size / 2 - 1; i > -1; --i)
+    {
+        jsl__str_merge_sift_down(runs, heap, heap_size, i);
+    }
+
+    int64_t written = 0;
+    while (heap_size > 0)
+    {
+        JSL__StrMergeHead* top = &heap[0];
+        out[written++] = runs[top->run][top->position];
+
+        ++top->position;
+        if (top->position < run_lengths[top->run])
+        {
+            top->key = jsl__str_sort_key(runs[top->run][top->position], 0);
+        }
+        else
+        {
+            --heap_size;
+            heap[0] = heap[heap_size];
+        }
+
+        if (heap_size > 1)
+            jsl__str_merge_sift_down(runs, heap, heap_size, 0);
+    }
+
+    jsl_allocator_interface_free(allocator, heap);
+    return written;
+}
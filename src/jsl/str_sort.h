@@ -0,0 +1,243 @@
+/**
+ * # JSL String Sort
+ *
+ * This file implements sorting and merging of arrays of `JSLImmutableMemory`
+ * strings, for things like deduplicating log lines or preparing both sides
+ * of a merge join. This file is part of the Jack's Standard Library project.
+ *
+ * ## Documentation
+ *
+ * See `docs/jsl_str_sort.md` for a formatted documentation page.
+ *
+ * ## Order
+ *
+ * Strings are ordered bytewise, treating each byte as unsigned, and a string
+ * that is a prefix of another comes first. Two strings are equal under this
+ * order exactly when `jsl_memory_compare` says they're equal, except that
+ * all empty strings are equal to each other regardless of their pointers.
+ *
+ * ## Design
+ *
+ * `jsl_str_sort` is a multikey quicksort. Instead of comparing whole strings,
+ * it caches the next seven bytes of every string, plus a byte that records
+ * whether the string ends within them, as one `uint64_t`. Partitioning only
+ * compares these integers, which is branch friendly and never touches the
+ * string data. Only the strings which tie on the cached key are reloaded
+ * seven bytes deeper, so long shared prefixes cost one reload per seven
+ * bytes instead of one full compare per pair.
+ *
+ * For large arrays, `JSLStrSortJob` splits the work so that any number of
+ * threads can sort at once. The job does one MSD radix pass on the first
+ * byte after the common prefix of the array, then every thread that calls
+ * `jsl_str_sort_job_work` claims whole buckets, largest first, and sorts
+ * them with the same multikey quicksort. Buckets never overlap so no locks
+ * are needed. This library does not start threads itself, bring your own.
+ *
+ * `jsl_str_merge` merges already sorted runs, e.g. the output of several
+ * sorted files, with a binary heap over the run heads keyed by the same
+ * cached prefixes.
+ *
+ * ## Caveats
+ *
+ * * None of the sorts are stable.
+ * * The job only parallelizes over the first differing byte, so an array
+ *   where almost every string has the same byte there runs mostly on one
+ *   thread.
+ * * All scratch memory comes from the given allocator. When it's an arena
+ *   it does not need to be thread safe, since the job allocates all of its
+ *   scratch up front in `jsl_str_sort_job_init`.
+ *
+ * ## License
+ *
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L
+    #include <stdbool.h>
+#endif
+
+#include "core.h"
+#include "allocator.h"
+
+/* Versioning to catch mismatches across deps */
+#ifndef JSL_STR_SORT_VERSION
+    #define JSL_STR_SORT_VERSION 0x010000  /* 1.0.0 */
+#else
+    #if JSL_STR_SORT_VERSION != 0x010000
+        #error "str_sort.h version mismatch across includes"
+    #endif
+#endif
+
+#ifndef JSL_STR_SORT_DEF
+    #define JSL_STR_SORT_DEF
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A sort of one array split up so that several threads can work on it at
+ * once. See `jsl_str_sort_job_init`.
+ *
+ * All fields are private.
+ */
+typedef struct JSLStrSortJob
+{
+    uint64_t sentinel;
+    JSLAllocatorInterface allocator;
+
+    JSLImmutableMemory* strings;
+    uint64_t* keys;
+    int64_t count;
+
+    /// @brief depth of the byte the buckets were split on
+    int64_t split_depth;
+    /// @brief start offset of each bucket, plus the end of the last bucket
+    int64_t* bucket_starts;
+    /// @brief bucket indices ordered from largest to smallest
+    int32_t* bucket_order;
+    int32_t bucket_count;
+
+    /// @brief next entry of bucket_order to claim, shared between threads
+    uint64_t next_bucket;
+} JSLStrSortJob;
+
+/**
+ * Three way comparison of two strings in the order used by every function
+ * in this file.
+ *
+ * @param a First string
+ * @param b Second string
+ * @returns A negative number if `a` comes first, zero if they're equal, and
+ * a positive number if `b` comes first
+ */
+JSL_STR_SORT_DEF int32_t jsl_str_sort_compare(
+    JSLImmutableMemory a,
+    JSLImmutableMemory b
+);
+
+/**
+ * Sort an array of strings in place on the calling thread.
+ *
+ * Only the string structs are moved, the bytes they point to are not
+ * touched. The sort needs eight bytes of scratch per string.
+ *
+ * @param allocator Used for the scratch memory, which is freed before returning
+ * @param strings The strings to sort
+ * @param count The number of strings
+ * @returns false on invalid parameters or when the scratch allocation fails,
+ * in which case the array is left unchanged
+ */
+JSL_STR_SORT_DEF bool jsl_str_sort(
+    JSLAllocatorInterface allocator,
+    JSLImmutableMemory* strings,
+    int64_t count
+);
+
+/**
+ * Prepare a sort of `strings` that many threads can run at once.
+ *
+ * This runs on the calling thread and does the first radix pass over the
+ * whole array, so the strings are already grouped by their first differing
+ * byte when it returns. Afterwards call `jsl_str_sort_job_work` from as many
+ * threads as you want, and the array is sorted once every one of those calls
+ * has returned. A single call from one thread also sorts the whole array.
+ *
+ * ```
+ * JSLStrSortJob job;
+ * jsl_str_sort_job_init(&job, arena_allocator, strings, count);
+ *
+ * // on each worker thread
+ * jsl_str_sort_job_work(&job);
+ *
+ * // after joining the workers
+ * jsl_str_sort_job_free(&job);
+ * ```
+ *
+ * All scratch memory is allocated here, so `allocator` is never used by the
+ * worker threads and does not need to be thread safe. It needs twenty four
+ * bytes of scratch per string.
+ *
+ * @param job The job to initialize
+ * @param allocator Used for all of the job's scratch memory
+ * @param strings The strings to sort. Must stay valid until the job is done
+ * @param count The number of strings
+ * @returns false on invalid parameters or allocation failure
+ */
+JSL_STR_SORT_DEF bool jsl_str_sort_job_init(
+    JSLStrSortJob* job,
+    JSLAllocatorInterface allocator,
+    JSLImmutableMemory* strings,
+    int64_t count
+);
+
+/**
+ * Claim and sort buckets of the job until none are left. Safe to call from
+ * any number of threads at the same time.
+ *
+ * @param job An initialized job
+ * @returns The number of buckets this call sorted
+ */
+JSL_STR_SORT_DEF int32_t jsl_str_sort_job_work(
+    JSLStrSortJob* job
+);
+
+/**
+ * Free the scratch memory of the job. Only call this after every call to
+ * `jsl_str_sort_job_work` has returned.
+ *
+ * @param job The job to free
+ */
+JSL_STR_SORT_DEF void jsl_str_sort_job_free(
+    JSLStrSortJob* job
+);
+
+/**
+ * Merge sorted runs of strings into one sorted array.
+ *
+ * This is the k-way merge step of an external sort or of sorting chunks on
+ * separate threads. Equal strings from different runs all appear in the
+ * output, use a dedup pass afterwards if you need unique values.
+ *
+ * @param allocator Used for the merge heap, which is freed before returning
+ * @param runs Pointers to the start of each sorted run
+ * @param run_lengths The number of strings in each run
+ * @param run_count The number of runs
+ * @param out Where the merged strings are written. Must have room for the sum
+ * of `run_lengths` and must not overlap any of the runs.
+ * @returns The number of strings written, or -1 on invalid parameters or
+ * allocation failure
+ */
+JSL_STR_SORT_DEF int64_t jsl_str_merge(
+    JSLAllocatorInterface allocator,
+    const JSLImmutableMemory* const* runs,
+    const int64_t* run_lengths,
+    int32_t run_count,
+    JSLImmutableMemory* out
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -117,8 +117,13 @@ JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_init2(
     return res;
 }
 
-static bool jsl__str_to_str_map_rehash(
-    JSLStrToStrMap* map
+/**
+ * Move every entry into a new lookup table of `new_length` slots, which can
+ * be bigger or smaller than the current one. On failure nothing changes.
+ */
+static bool jsl__str_to_str_map_rehash_to_length(
+    JSLStrToStrMap* map,
+    int64_t new_length
 )
 {
     bool res = false;
@@ -131,8 +136,10 @@ static bool jsl__str_to_str_map_rehash(
     uintptr_t* old_table = params_valid ? map->entry_lookup_table : NULL;
     int64_t old_length = params_valid ? map->entry_lookup_table_length : 0;
 
-    int64_t new_length = params_valid ? jsl_next_power_of_two_i64(old_length + 1) : 0;
-    bool length_valid = params_valid && new_length > old_length && new_length > 0;
+    bool length_valid = params_valid
+        && new_length != old_length
+        && new_length > map->item_count
+        && new_length > 0;
 
     bool bytes_possible = length_valid
         && new_length <= (INT64_MAX / (int64_t) sizeof(uintptr_t));
@@ -211,7 +218,6 @@ static bool jsl__str_to_str_map_rehash(
         uintptr_t* old_table_to_free = map->entry_lookup_table;
         map->entry_lookup_table = new_table;
         map->entry_lookup_table_length = new_length;
-        map->tombstone_count = 0;
         ++map->generational_id;
         res = true;
 
@@ -228,6 +234,33 @@ static bool jsl__str_to_str_map_rehash(
     return res;
 }
 
+static bool jsl__str_to_str_map_rehash(
+    JSLStrToStrMap* map
+)
+{
+    return jsl__str_to_str_map_rehash_to_length(
+        map,
+        jsl_next_power_of_two_i64(map->entry_lookup_table_length + 1)
+    );
+}
+
+/**
+ * Smallest lookup table length that holds `item_count` entries without
+ * going over the load factor, or -1 if it's too large.
+ */
+static int64_t jsl__str_to_str_map_lookup_table_length_for(
+    JSLStrToStrMap* map,
+    int64_t item_count
+)
+{
+    double slots_needed = (double) item_count / (double) map->load_factor;
+    bool size_possible = slots_needed < (double) (INT64_MAX / (int64_t) sizeof(uintptr_t) / 2);
+
+    return size_possible
+        ? jsl_next_power_of_two_i64(JSL_MAX((int64_t) slots_needed + 1, 32L))
+        : -1;
+}
+
 static JSL__FORCE_INLINE void jsl__str_to_str_map_store_key(
     JSLStrToStrMap* map,
     struct JSL__StrToStrMapEntry* entry,
@@ -362,6 +395,187 @@ static JSL__FORCE_INLINE JSLImmutableMemory jsl__str_to_str_map_get_entry_value(
     }
 }
 
+/**
+ * Put an entry which is known not to be in the current table into its
+ * first free slot.
+ */
+static void jsl__str_to_str_map_place_entry(
+    JSLStrToStrMap* map,
+    struct JSL__StrToStrMapEntry* entry
+)
+{
+    int64_t lut_length = map->entry_lookup_table_length;
+    uint64_t lut_mask = (uint64_t) lut_length - 1u;
+    int64_t probe_index = (int64_t) (entry->hash & lut_mask);
+
+    for (int64_t probes = 0; probes < lut_length; ++probes)
+    {
+        uintptr_t probe_res = map->entry_lookup_table[probe_index];
+
+        if (probe_res == JSL__MAP_EMPTY)
+        {
+            map->entry_lookup_table[probe_index] = (uintptr_t) entry;
+            break;
+        }
+
+        probe_index = (int64_t) (((uint64_t) probe_index + 1u) & lut_mask);
+    }
+}
+
+/**
+ * Move up to `slot_budget` slots of the old table into the current table,
+ * freeing the old table once it has been fully drained. Either one changes
+ * what an iterator walks, so both invalidate iterators even when the caller
+ * (e.g. deleting a missing key) doesn't change anything else.
+ */
+static void jsl__str_to_str_map_migrate(
+    JSLStrToStrMap* map,
+    int64_t slot_budget
+)
+{
+    uintptr_t* old_table = map->old_entry_lookup_table;
+    int64_t remaining = old_table != NULL
+        ? map->old_entry_lookup_table_length - map->rehash_migrate_index
+        : 0;
+    int64_t slot_count = JSL_MIN(remaining, slot_budget);
+
+    bool moved = false;
+    for (int64_t i = 0; i < slot_count; ++i)
+    {
+        int64_t old_index = map->rehash_migrate_index + i;
+        uintptr_t lut_res = old_table[old_index];
+
+        if (lut_res != JSL__MAP_EMPTY && lut_res != JSL__MAP_TOMBSTONE)
+        {
+            jsl__str_to_str_map_place_entry(map, (struct JSL__StrToStrMapEntry*) lut_res);
+            moved = true;
+
+            // Leave a tombstone so that lookups of keys which are still in
+            // the old table keep probing past this slot
+            old_table[old_index] = JSL__MAP_TOMBSTONE;
+        }
+    }
+
+    map->rehash_migrate_index += slot_count;
+
+    bool drained = old_table != NULL
+        && map->rehash_migrate_index >= map->old_entry_lookup_table_length;
+
+    if (drained)
+    {
+        jsl_allocator_interface_free(map->allocator, old_table);
+        map->old_entry_lookup_table = NULL;
+        map->old_entry_lookup_table_length = 0;
+        map->rehash_migrate_index = 0;
+    }
+
+    if (moved || drained)
+        ++map->generational_id;
+}
+
+/**
+ * Swap in a table twice the size and keep the current table around as the
+ * old table. Entries are moved over by `jsl__str_to_str_map_migrate`.
+ */
+static bool jsl__str_to_str_map_begin_incremental_rehash(
+    JSLStrToStrMap* map
+)
+{
+    int64_t old_length = map->entry_lookup_table_length;
+    int64_t new_length = jsl_next_power_of_two_i64(old_length + 1);
+
+    bool length_valid = new_length > old_length
+        && new_length <= (INT64_MAX / (int64_t) sizeof(uintptr_t));
+
+    uintptr_t* new_table = NULL;
+    if (length_valid)
+    {
+        new_table = (uintptr_t*) jsl_allocator_interface_alloc(
+            map->allocator,
+            (int64_t) sizeof(uintptr_t) * new_length,
+            _Alignof(uintptr_t),
+            true
+        );
+    }
+
+    if (new_table != NULL)
+    {
+        map->old_entry_lookup_table = map->entry_lookup_table;
+        map->old_entry_lookup_table_length = old_length;
+        map->rehash_migrate_index = 0;
+
+        map->entry_lookup_table = new_table;
+        map->entry_lookup_table_length = new_length;
+        ++map->generational_id;
+    }
+
+    return new_table != NULL;
+}
+
+static bool jsl__str_to_str_map_grow(
+    JSLStrToStrMap* map
+)
+{
+    // A previous rehash is still in progress, so the current table filled
+    // up before the old one was drained. Finish it before growing again.
+    jsl__str_to_str_map_migrate(map, INT64_MAX);
+
+    bool res = false;
+
+    if (map->rehash_step > 0)
+    {
+        res = jsl__str_to_str_map_begin_incremental_rehash(map);
+    }
+    else
+    {
+        res = jsl__str_to_str_map_rehash(map);
+    }
+
+    return res;
+}
+
+/**
+ * Look for `key` in the old table of an in progress incremental rehash.
+ * Read only, nothing is moved.
+ *
+ * @returns The old table index of the key, or -1
+ */
+static int64_t jsl__str_to_str_map_find_in_old_table(
+    JSLStrToStrMap* map,
+    JSLImmutableMemory key,
+    uint64_t hash
+)
+{
+    int64_t res = -1;
+
+    uintptr_t* old_table = map->old_entry_lookup_table;
+    int64_t lut_length = old_table != NULL ? map->old_entry_lookup_table_length : 0;
+    uint64_t lut_mask = (uint64_t) lut_length - 1u;
+    int64_t lut_index = (int64_t) (hash & lut_mask);
+
+    for (int64_t probes = 0; res == -1 && probes < lut_length; ++probes)
+    {
+        uintptr_t lut_res = old_table[lut_index];
+
+        if (lut_res == JSL__MAP_EMPTY)
+            break;
+
+        if (lut_res != JSL__MAP_TOMBSTONE)
+        {
+            struct JSL__StrToStrMapEntry* entry = (struct JSL__StrToStrMapEntry*) lut_res;
+            bool matches = entry->hash == hash
+                && jsl_memory_compare(key, jsl__str_to_str_map_get_entry_key(entry));
+
+            if (matches)
+                res = lut_index;
+        }
+
+        lut_index = (int64_t) (((uint64_t) lut_index + 1u) & lut_mask);
+    }
+
+    return res;
+}
+
 static JSL__FORCE_INLINE bool jsl__str_to_str_map_add_new_entry(
     JSLStrToStrMap* map,
     JSLImmutableMemory key,
@@ -373,7 +587,6 @@ static JSL__FORCE_INLINE bool jsl__str_to_str_map_add_new_entry(
 )
 {
     struct JSL__StrToStrMapEntry* entry = NULL;
-    bool replacing_tombstone = map->entry_lookup_table[lut_index] == JSL__MAP_TOMBSTONE;
 
     if (map->entry_free_list == NULL)
     {
@@ -397,11 +610,6 @@ static JSL__FORCE_INLINE bool jsl__str_to_str_map_add_new_entry(
         jsl__str_to_str_map_store_value(map, entry, value, value_lifetime);
     }
 
-    if (entry != NULL && replacing_tombstone)
-    {
-        --map->tombstone_count;
-    }
-
     return entry != NULL;
 }
 
@@ -416,8 +624,6 @@ static inline void jsl__str_to_str_map_probe(
     *out_lut_index = -1;
     *out_found = false;
 
-    int64_t first_tombstone = -1;
-    bool tombstone_seen = false;
     bool searching = true;
 
     *out_hash = jsl__rapidhash_withSeed(key.data, (size_t) key.length, map->hash_seed);
@@ -427,28 +633,19 @@ static inline void jsl__str_to_str_map_probe(
     int64_t lut_index = (int64_t) (*out_hash & lut_mask);
     int64_t probes = 0;
 
+    // Deletes shift entries back instead of leaving tombstones, so the
+    // first empty slot always ends the probe sequence
     while (searching && probes < lut_length)
     {
         uintptr_t lut_res = map->entry_lookup_table[lut_index];
 
-        bool is_empty = lut_res == JSL__MAP_EMPTY;
-        bool is_tombstone = lut_res == JSL__MAP_TOMBSTONE;
-
-        if (is_empty)
+        if (lut_res == JSL__MAP_EMPTY)
         {
-            *out_lut_index = tombstone_seen ? first_tombstone : lut_index;
+            *out_lut_index = lut_index;
             searching = false;
         }
 
-        bool record_tombstone = searching && is_tombstone && !tombstone_seen;
-        if (record_tombstone)
-        {
-            first_tombstone = lut_index;
-            tombstone_seen = true;
-        }
-
-        bool slot_has_entry = searching && !is_empty && !is_tombstone;
-        struct JSL__StrToStrMapEntry* entry = slot_has_entry
+        struct JSL__StrToStrMapEntry* entry = searching
             ? (struct JSL__StrToStrMapEntry*) lut_res
             : NULL;
 
@@ -466,30 +663,56 @@ static inline void jsl__str_to_str_map_probe(
             searching = false;
         }
 
-        if (entry == NULL)
-        {
-            ++map->tombstone_count;
-            map->entry_lookup_table[lut_index] = JSL__MAP_TOMBSTONE;
-        }
-
-        if (entry == NULL && !tombstone_seen)
-        {
-            first_tombstone = lut_index;
-            tombstone_seen = true;
-        }
-
         if (searching)
         {
             lut_index = (int64_t) (((uint64_t) lut_index + 1u) & lut_mask);
             ++probes;
         }
     }
+}
 
-    bool exhausted = searching && probes >= lut_length;
-    if (exhausted)
+/**
+ * Backward shift deletion: empty `start_slot` and pull later entries of
+ * the same probe run back into the hole, so lookups never have to skip
+ * over tombstones.
+ */
+static inline void jsl__str_to_str_map_backshift(
+    JSLStrToStrMap* map,
+    int64_t start_slot
+)
+{
+    uint64_t lut_mask = (uint64_t) map->entry_lookup_table_length - 1u;
+
+    int64_t hole = start_slot;
+    int64_t current = (int64_t) (((uint64_t) start_slot + 1u) & lut_mask);
+
+    int64_t loop_check = 0;
+    while (loop_check < map->entry_lookup_table_length)
     {
-        *out_lut_index = tombstone_seen ? first_tombstone : -1;
+        uintptr_t lut_res = map->entry_lookup_table[current];
+
+        if (lut_res == JSL__MAP_EMPTY)
+            break;
+
+        struct JSL__StrToStrMapEntry* entry = (struct JSL__StrToStrMapEntry*) lut_res;
+        int64_t ideal_slot = (int64_t) (entry->hash & lut_mask);
+
+        bool should_move = (current > hole)
+            ? (ideal_slot <= hole || ideal_slot > current)
+            : (ideal_slot <= hole && ideal_slot > current);
+
+        if (should_move)
+        {
+            map->entry_lookup_table[hole] = lut_res;
+            hole = current;
+        }
+
+        current = (int64_t) (((uint64_t) current + 1u) & lut_mask);
+
+        ++loop_check;
     }
+
+    map->entry_lookup_table[hole] = JSL__MAP_EMPTY;
 }
 
 JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_insert(
@@ -509,18 +732,21 @@ JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_insert(
         && value.length > -1
     );
 
+    if (res && map->old_entry_lookup_table != NULL)
+    {
+        jsl__str_to_str_map_migrate(map, map->rehash_step);
+    }
+
     bool needs_rehash = false;
     if (res)
     {
-        float occupied_count = (float) (map->item_count + map->tombstone_count);
-        float current_load_factor =  occupied_count / (float) map->entry_lookup_table_length;
-        bool too_many_tombstones = map->tombstone_count > (map->entry_lookup_table_length / 4);
-        needs_rehash = current_load_factor >= map->load_factor || too_many_tombstones;
+        float current_load_factor = (float) map->item_count / (float) map->entry_lookup_table_length;
+        needs_rehash = current_load_factor >= map->load_factor;
     }
 
     if (JSL__UNLIKELY(needs_rehash))
     {
-        res = jsl__str_to_str_map_rehash(map);
+        res = jsl__str_to_str_map_grow(map);
     }
 
     uint64_t hash = 0;
@@ -530,9 +756,23 @@ JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_insert(
     {
         jsl__str_to_str_map_probe(map, key, &lut_index, &hash, &existing_found);
     }
-    
+
+    int64_t old_index = -1;
+    if (res && !existing_found && map->old_entry_lookup_table != NULL)
+    {
+        old_index = jsl__str_to_str_map_find_in_old_table(map, key, hash);
+    }
+
+    // update of a key which has not been migrated yet
+    if (old_index > -1)
+    {
+        struct JSL__StrToStrMapEntry* entry =
+            (struct JSL__StrToStrMapEntry*) map->old_entry_lookup_table[old_index];
+
+        jsl__str_to_str_map_store_value(map, entry, value, value_lifetime);
+    }
     // new key
-    if (lut_index > -1 && !existing_found)
+    else if (lut_index > -1 && !existing_found)
     {
         res = jsl__str_to_str_map_add_new_entry(
             map,
@@ -568,17 +808,25 @@ JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_has_key(
     int64_t lut_index = -1;
     bool existing_found = false;
 
-    if (
+    bool params_valid = (
         map != NULL
         && map->sentinel == JSL__MAP_PRIVATE_SENTINEL
         && key.data != NULL 
         && key.length > -1
-    )
+    );
+
+    if (params_valid)
     {
         jsl__str_to_str_map_probe(map, key, &lut_index, &hash, &existing_found);
     }
 
-    return lut_index > -1 && existing_found;
+    bool found_in_new = lut_index > -1 && existing_found;
+    bool found_in_old = params_valid
+        && !found_in_new
+        && map->old_entry_lookup_table != NULL
+        && jsl__str_to_str_map_find_in_old_table(map, key, hash) > -1;
+
+    return found_in_new || found_in_old;
 }
 
 JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_get(
@@ -607,6 +855,12 @@ JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_get(
         jsl__str_to_str_map_probe(map, key, &lut_index, &hash, &existing_found);
     }
 
+    int64_t old_index = -1;
+    if (params_valid && !existing_found && map->old_entry_lookup_table != NULL)
+    {
+        old_index = jsl__str_to_str_map_find_in_old_table(map, key, hash);
+    }
+
     if (params_valid && existing_found && lut_index > -1)
     {
         struct JSL__StrToStrMapEntry* entry =
@@ -614,6 +868,13 @@ JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_get(
         *out_value = jsl__str_to_str_map_get_entry_value(entry);
         res = true;
     }
+    else if (old_index > -1)
+    {
+        struct JSL__StrToStrMapEntry* entry =
+            (struct JSL__StrToStrMapEntry*) map->old_entry_lookup_table[old_index];
+        *out_value = jsl__str_to_str_map_get_entry_value(entry);
+        res = true;
+    }
     else if (out_value != NULL)
     {
         *out_value = (JSLImmutableMemory) {0};
@@ -681,13 +942,20 @@ JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_key_value_iterator_next(
         && iterator->generational_id == iterator->map->generational_id
     );
 
+    // While an incremental rehash is in progress the old table is walked
+    // after the current one, as if the two were one long table
     int64_t lut_length = params_valid ? iterator->map->entry_lookup_table_length : 0;
+    int64_t old_length = params_valid && iterator->map->old_entry_lookup_table != NULL
+        ? iterator->map->old_entry_lookup_table_length
+        : 0;
     int64_t lut_index = iterator->current_lut_index;
     struct JSL__StrToStrMapEntry* found_entry = NULL;
 
-    while (params_valid && lut_index < lut_length)
+    while (params_valid && lut_index < lut_length + old_length)
     {
-        uintptr_t lut_res = iterator->map->entry_lookup_table[lut_index];
+        uintptr_t lut_res = lut_index < lut_length
+            ? iterator->map->entry_lookup_table[lut_index]
+            : iterator->map->old_entry_lookup_table[lut_index - lut_length];
         bool occupied = lut_res != JSL__MAP_EMPTY && lut_res != JSL__MAP_TOMBSTONE;
 
         if (occupied)
@@ -712,7 +980,7 @@ JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_key_value_iterator_next(
     bool exhausted = params_valid && found_entry == NULL;
     if (exhausted)
     {
-        iterator->current_lut_index = lut_length;
+        iterator->current_lut_index = lut_length + old_length;
         found = false;
     }
 
@@ -734,6 +1002,11 @@ JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_delete(
         && key.length > -1
     );
 
+    if (params_valid && map->old_entry_lookup_table != NULL)
+    {
+        jsl__str_to_str_map_migrate(map, map->rehash_step);
+    }
+
     uint64_t hash = 0;
     int64_t lut_index = -1;
     bool existing_found = false;
@@ -742,10 +1015,27 @@ JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_delete(
         jsl__str_to_str_map_probe(map, key, &lut_index, &hash, &existing_found);
     }
 
-    if (existing_found && lut_index > -1)
+    int64_t old_index = -1;
+    if (params_valid && !existing_found && map->old_entry_lookup_table != NULL)
     {
-        struct JSL__StrToStrMapEntry* entry =
-            (struct JSL__StrToStrMapEntry*) map->entry_lookup_table[lut_index];
+        old_index = jsl__str_to_str_map_find_in_old_table(map, key, hash);
+    }
+
+    bool found_in_new = existing_found && lut_index > -1;
+
+    uintptr_t* found_slot = NULL;
+    if (found_in_new)
+    {
+        found_slot = &map->entry_lookup_table[lut_index];
+    }
+    else if (old_index > -1)
+    {
+        found_slot = &map->old_entry_lookup_table[old_index];
+    }
+
+    if (found_slot != NULL)
+    {
+        struct JSL__StrToStrMapEntry* entry = (struct JSL__StrToStrMapEntry*) *found_slot;
 
         jsl__str_to_str_map_entry_free_key(map, entry);
         jsl__str_to_str_map_entry_free_value(map, entry);
@@ -756,12 +1046,20 @@ JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_delete(
         --map->item_count;
         ++map->generational_id;
 
-        map->entry_lookup_table[lut_index] = JSL__MAP_TOMBSTONE;
-        ++map->tombstone_count;
-
         res = true;
     }
 
+    if (found_in_new)
+    {
+        jsl__str_to_str_map_backshift(map, lut_index);
+    }
+    // The old table keeps tombstones, shifting its entries back could move
+    // them behind the migration cursor where they would never be moved over
+    else if (found_slot != NULL)
+    {
+        *found_slot = JSL__MAP_TOMBSTONE;
+    }
+
     return res;
 }
 
@@ -775,12 +1073,20 @@ JSL_STR_TO_STR_MAP_DEF void jsl_str_to_str_map_clear(
         && map->entry_lookup_table != NULL
     );
 
+    // Entries which have not been migrated yet are recycled from the old
+    // table, then the old table is dropped and the rehash is over
     int64_t lut_length = params_valid ? map->entry_lookup_table_length : 0;
+    int64_t old_length = params_valid && map->old_entry_lookup_table != NULL
+        ? map->old_entry_lookup_table_length
+        : 0;
     int64_t index = 0;
 
-    while (params_valid && index < lut_length)
+    while (params_valid && index < lut_length + old_length)
     {
-        uintptr_t lut_res = map->entry_lookup_table[index];
+        uintptr_t* slot = index < lut_length
+            ? &map->entry_lookup_table[index]
+            : &map->old_entry_lookup_table[index - lut_length];
+        uintptr_t lut_res = *slot;
 
         if (lut_res != JSL__MAP_EMPTY && lut_res != JSL__MAP_TOMBSTONE)
         {
@@ -789,26 +1095,184 @@ JSL_STR_TO_STR_MAP_DEF void jsl_str_to_str_map_clear(
             jsl__str_to_str_map_entry_free_value(map, entry);
             entry->next = map->entry_free_list;
             map->entry_free_list = entry;
-            map->entry_lookup_table[index] = JSL__MAP_EMPTY;
+            *slot = JSL__MAP_EMPTY;
         }
         else if (lut_res == JSL__MAP_TOMBSTONE)
         {
-            map->entry_lookup_table[index] = JSL__MAP_EMPTY;
+            *slot = JSL__MAP_EMPTY;
         }
 
         ++index;
     }
 
+    if (params_valid && map->old_entry_lookup_table != NULL)
+    {
+        jsl_allocator_interface_free(map->allocator, map->old_entry_lookup_table);
+        map->old_entry_lookup_table = NULL;
+        map->old_entry_lookup_table_length = 0;
+        map->rehash_migrate_index = 0;
+    }
+
     if (params_valid)
     {
         map->item_count = 0;
-        map->tombstone_count = 0;
         ++map->generational_id;
     }
 
     return;
 }
 
+JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_enable_incremental_rehash(
+    JSLStrToStrMap* map,
+    int64_t slots_per_operation
+)
+{
+    bool res = (
+        map != NULL
+        && map->sentinel == JSL__MAP_PRIVATE_SENTINEL
+        && slots_per_operation > -1
+    );
+
+    if (res)
+    {
+        map->rehash_step = slots_per_operation;
+    }
+
+    if (res && slots_per_operation == 0)
+    {
+        res = jsl_str_to_str_map_finish_rehash(map);
+    }
+
+    return res;
+}
+
+JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_finish_rehash(
+    JSLStrToStrMap* map
+)
+{
+    bool res = (
+        map != NULL
+        && map->sentinel == JSL__MAP_PRIVATE_SENTINEL
+    );
+
+    if (res && map->old_entry_lookup_table != NULL)
+    {
+        jsl__str_to_str_map_migrate(map, INT64_MAX);
+        ++map->generational_id;
+    }
+
+    return res;
+}
+
+JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_reserve(
+    JSLStrToStrMap* map,
+    int64_t item_count
+)
+{
+    bool res = (
+        map != NULL
+        && map->sentinel == JSL__MAP_PRIVATE_SENTINEL
+        && item_count > -1
+    );
+
+    int64_t new_length = res
+        ? jsl__str_to_str_map_lookup_table_length_for(map, item_count)
+        : -1;
+
+    res = res && new_length > 0 && jsl_str_to_str_map_finish_rehash(map);
+
+    if (res && new_length > map->entry_lookup_table_length)
+    {
+        res = jsl__str_to_str_map_rehash_to_length(map, new_length);
+    }
+
+    return res;
+}
+
+JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_shrink_to_fit(
+    JSLStrToStrMap* map
+)
+{
+    bool res = (
+        map != NULL
+        && map->sentinel == JSL__MAP_PRIVATE_SENTINEL
+    );
+
+    res = res && jsl_str_to_str_map_finish_rehash(map);
+
+    struct JSL__StrToStrMapEntry* entry = res ? map->entry_free_list : NULL;
+    while (entry != NULL)
+    {
+        struct JSL__StrToStrMapEntry* next = entry->next;
+        jsl_allocator_interface_free(map->allocator, entry);
+        entry = next;
+    }
+
+    if (res)
+    {
+        map->entry_free_list = NULL;
+    }
+
+    int64_t new_length = res
+        ? jsl__str_to_str_map_lookup_table_length_for(map, map->item_count)
+        : -1;
+
+    if (res && new_length > 0 && new_length < map->entry_lookup_table_length)
+    {
+        res = jsl__str_to_str_map_rehash_to_length(map, new_length);
+    }
+
+    return res;
+}
+
+JSL_STR_TO_STR_MAP_DEF int64_t jsl_str_to_str_map_memory_footprint(
+    JSLStrToStrMap* map
+)
+{
+    bool params_valid = (
+        map != NULL
+        && map->sentinel == JSL__MAP_PRIVATE_SENTINEL
+    );
+
+    int64_t lut_length = params_valid ? map->entry_lookup_table_length : 0;
+    int64_t old_length = params_valid && map->old_entry_lookup_table != NULL
+        ? map->old_entry_lookup_table_length
+        : 0;
+
+    int64_t res = params_valid
+        ? (int64_t) sizeof(uintptr_t) * (lut_length + old_length)
+        : -1;
+
+    int64_t lut_index = 0;
+    while (params_valid && lut_index < lut_length + old_length)
+    {
+        uintptr_t lut_res = lut_index < lut_length
+            ? map->entry_lookup_table[lut_index]
+            : map->old_entry_lookup_table[lut_index - lut_length];
+
+        if (lut_res != JSL__MAP_EMPTY && lut_res != JSL__MAP_TOMBSTONE)
+        {
+            struct JSL__StrToStrMapEntry* entry = (struct JSL__StrToStrMapEntry*) lut_res;
+            res += (int64_t) sizeof(struct JSL__StrToStrMapEntry);
+
+            if (entry->key_lifetime == JSL__MAP_LIFETIME_DUPLICATED)
+                res += entry->key.length;
+            if (entry->value_lifetime == JSL__MAP_LIFETIME_DUPLICATED)
+                res += entry->value.length;
+        }
+
+        ++lut_index;
+    }
+
+    struct JSL__StrToStrMapEntry* entry = params_valid ? map->entry_free_list : NULL;
+    while (entry != NULL)
+    {
+        res += (int64_t) sizeof(struct JSL__StrToStrMapEntry);
+        entry = entry->next;
+    }
+
+    return res;
+}
 
 JSL_STR_TO_STR_MAP_DEF void jsl_str_to_str_map_free(
     JSLStrToStrMap* map
@@ -821,11 +1285,16 @@ JSL_STR_TO_STR_MAP_DEF void jsl_str_to_str_map_free(
 
     uintptr_t* lut = params_valid ? map->entry_lookup_table : NULL;
     int64_t lut_length = params_valid ? map->entry_lookup_table_length : 0;
+    int64_t old_length = params_valid && map->old_entry_lookup_table != NULL
+        ? map->old_entry_lookup_table_length
+        : 0;
 
     int64_t lut_index = 0;
-    while (params_valid && lut_index < lut_length)
+    while (params_valid && lut_index < lut_length + old_length)
     {
-        uintptr_t lut_res = lut[lut_index];
+        uintptr_t lut_res = lut_index < lut_length
+            ? lut[lut_index]
+            : map->old_entry_lookup_table[lut_index - lut_length];
         if (lut_res != JSL__HASHMAP_EMPTY && lut_res != JSL__HASHMAP_TOMBSTONE)
         {
             struct JSL__StrToStrMapEntry* entry = (struct JSL__StrToStrMapEntry*) lut_res;
@@ -850,6 +1319,11 @@ JSL_STR_TO_STR_MAP_DEF void jsl_str_to_str_map_free(
         jsl_allocator_interface_free(map->allocator, map->entry_lookup_table);
     }
 
+    if (params_valid && map->old_entry_lookup_table != NULL)
+    {
+        jsl_allocator_interface_free(map->allocator, map->old_entry_lookup_table);
+    }
+
     map->sentinel = 0;
 }
 
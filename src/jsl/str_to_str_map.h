@@ -22,6 +22,12 @@
  * * have an initial item count guess as accurate as you can to reduce rehashes
  * * have the arena have as short a lifetime as possible
  * 
+ * By default a rehash moves every entry into the new table at once, which
+ * is a long pause on large maps. Latency sensitive users can turn on
+ * incremental rehashing with `jsl_str_to_str_map_enable_incremental_rehash`,
+ * which keeps the old table around and moves a few slots on every insert
+ * and delete instead.
+ * 
  * ## License
  *
  * Copyright (c) 2026 Jack Stouffer
@@ -129,8 +135,15 @@ struct JSL__StrToStrMap {
     uintptr_t* entry_lookup_table;
     int64_t entry_lookup_table_length;
 
+    /// @brief previous table while an incremental rehash is in progress, NULL otherwise
+    uintptr_t* old_entry_lookup_table;
+    int64_t old_entry_lookup_table_length;
+    /// @brief next slot in the old table to move into the current table
+    int64_t rehash_migrate_index;
+    /// @brief old table slots moved per insert or delete, zero when incremental rehashing is off
+    int64_t rehash_step;
+
     int64_t item_count;
-    int64_t tombstone_count;
 
     struct JSL__StrToStrMapEntry* entry_free_list;
 
@@ -180,6 +193,11 @@ struct JSL__StrToStrMap {
  *  * jsl_str_to_str_map_key_value_iterator_next
  *  * jsl_str_to_str_map_delete
  *  * jsl_str_to_str_map_clear
+ *  * jsl_str_to_str_map_enable_incremental_rehash
+ *  * jsl_str_to_str_map_finish_rehash
+ *  * jsl_str_to_str_map_reserve
+ *  * jsl_str_to_str_map_shrink_to_fit
+ *  * jsl_str_to_str_map_memory_footprint
  *
  */
 typedef struct JSL__StrToStrMap JSLStrToStrMap;
@@ -388,6 +406,92 @@ JSL_STR_TO_STR_MAP_DEF void jsl_str_to_str_map_clear(
     JSLStrToStrMap* map
 );
 
+/**
+ * Spread future rehashes out over many operations instead of doing them all
+ * at once.
+ *
+ * When the map grows, the new table is allocated and the old one is kept.
+ * Each following insert or delete moves `slots_per_operation` slots of the
+ * old table into the new one until the old table is empty and freed.
+ * Lookups check both tables in the meantime. Lookups never move entries,
+ * so they stay free of side effects for code that iterates while reading.
+ *
+ * This bounds the worst case insert time at the cost of slightly slower
+ * lookups, and twice the lookup table memory, while a rehash is in progress.
+ * If the new table fills up before the old one is drained the remaining
+ * slots are moved all at once, so avoid tiny steps with low load factors.
+ *
+ * @param map Map to configure.
+ * @param slots_per_operation Old table slots to move per operation, or
+ * zero to turn incremental rehashing off, which finishes any rehash in progress.
+ * @return `true` on success, `false` on invalid parameters.
+ */
+JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_enable_incremental_rehash(
+    JSLStrToStrMap* map,
+    int64_t slots_per_operation
+);
+
+/**
+ * Move every remaining entry of an in progress incremental rehash into the
+ * current table and free the old table. Does nothing if no rehash is in
+ * progress. Useful to pay the remaining cost at a convenient time, like
+ * before a read heavy phase. Iterators become invalid.
+ *
+ * @param map Map to finish rehashing.
+ * @return `true` on success, `false` on invalid parameters.
+ */
+JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_finish_rehash(
+    JSLStrToStrMap* map
+);
+
+/**
+ * Grow the lookup table once so that `item_count` entries fit without any
+ * rehash along the way. Does nothing if the table is already big enough.
+ * Any incremental rehash in progress is finished first. Iterators become
+ * invalid.
+ *
+ * @param map Map to grow.
+ * @param item_count Number of entries the map should hold.
+ * @return `true` on success, `false` on invalid parameters or out of memory.
+ */
+JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_reserve(
+    JSLStrToStrMap* map,
+    int64_t item_count
+);
+
+/**
+ * Give memory which isn't needed for the current entries back to the
+ * allocator. The entries recycled by deletes are freed and the entries are
+ * moved into the smallest lookup table that holds them at the load factor,
+ * never smaller than 32 slots. Any incremental rehash in progress is
+ * finished first. Iterators become invalid.
+ *
+ * With an arena allocator the memory isn't reusable until the arena is
+ * reset, so this is mostly useful with a general purpose allocator.
+ *
+ * @param map Map to compact.
+ * @return `true` on success, `false` on invalid parameters or out of memory.
+ */
+JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_shrink_to_fit(
+    JSLStrToStrMap* map
+);
+
+/**
+ * Get the number of bytes this map holds from its allocator. This is the
+ * lookup tables, every entry including the ones recycled by deletes, and
+ * the copies of keys and values which were too long for the small string
+ * buffer. Strings with `JSL_STRING_LIFETIME_LONGER` belong to the caller and
+ * aren't counted, neither is allocator bookkeeping or alignment padding.
+ *
+ * This walks every entry, so avoid calling it after every insert.
+ *
+ * @param map Map to measure.
+ * @return The size in bytes, or -1 on invalid parameters.
+ */
+JSL_STR_TO_STR_MAP_DEF int64_t jsl_str_to_str_map_memory_footprint(
+    JSLStrToStrMap* map
+);
+
 /**
  * Free all underlying memory allocated by this map. This map is then put into an
  * invalid state. If you wish to use the map again you will need to call init.
@@ -59,6 +59,11 @@
 #define JSL__DUPLICATED 1u
 #define JSL__STATIC 2u
 #define JSL__SSO 3u
+#define JSL__PACKED 4u
+
+#define JSL__MULTIMAP_VALUE_MIN_CAPACITY 4
+#define JSL__MULTIMAP_VALUE_CHUNK_MIN_SIZE 256
+#define JSL__MULTIMAP_VALUE_CHUNK_MAX_SIZE 4096
 
 JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_init(
     JSLStrToStrMultimap* map,
@@ -123,8 +128,13 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_init2(
     return res;
 }
 
-static bool jsl__str_to_str_multimap_rehash(
-    JSLStrToStrMultimap* map
+/**
+ * Move every key into a new lookup table of `new_length` slots, which can
+ * be bigger or smaller than the current one. On failure nothing changes.
+ */
+static bool jsl__str_to_str_multimap_rehash_to_length(
+    JSLStrToStrMultimap* map,
+    int64_t new_length
 )
 {
     bool res = false;
@@ -137,8 +147,10 @@ static bool jsl__str_to_str_multimap_rehash(
     uintptr_t* old_table = params_valid ? map->entry_lookup_table : NULL;
     int64_t old_length = params_valid ? map->entry_lookup_table_length : 0;
 
-    int64_t new_length = params_valid ? jsl_next_power_of_two_i64(old_length + 1) : 0;
-    bool length_valid = params_valid && new_length > old_length && new_length > 0;
+    bool length_valid = params_valid
+        && new_length != old_length
+        && new_length > map->key_count
+        && new_length > 0;
 
     bool bytes_possible = length_valid
         && new_length <= (INT64_MAX / (int64_t) sizeof(uintptr_t));
@@ -185,7 +197,6 @@ static bool jsl__str_to_str_multimap_rehash(
 
         bool has_values = occupied
             && entry != NULL
-            && entry->values_head != NULL
             && entry->value_count > 0;
 
         int64_t probe_index = has_values
@@ -233,7 +244,6 @@ static bool jsl__str_to_str_multimap_rehash(
         uintptr_t* old_table_to_free = map->entry_lookup_table;
         map->entry_lookup_table = new_table;
         map->entry_lookup_table_length = new_length;
-        map->tombstone_count = 0;
         ++map->generational_id;
         res = true;
 
@@ -250,6 +260,33 @@ static bool jsl__str_to_str_multimap_rehash(
     return res;
 }
 
+static bool jsl__str_to_str_multimap_rehash(
+    JSLStrToStrMultimap* map
+)
+{
+    return jsl__str_to_str_multimap_rehash_to_length(
+        map,
+        jsl_next_power_of_two_i64(map->entry_lookup_table_length + 1)
+    );
+}
+
+/**
+ * Smallest lookup table length that holds `key_count` keys without going
+ * over the load factor, or -1 if it's too large.
+ */
+static int64_t jsl__str_to_str_multimap_lookup_table_length_for(
+    JSLStrToStrMultimap* map,
+    int64_t key_count
+)
+{
+    double slots_needed = (double) key_count / (double) map->load_factor;
+    bool size_possible = slots_needed < (double) (INT64_MAX / (int64_t) sizeof(uintptr_t) / 2);
+
+    return size_possible
+        ? jsl_next_power_of_two_i64(JSL_MAX((int64_t) slots_needed + 1, 32L))
+        : -1;
+}
+
 static JSL__FORCE_INLINE void jsl__str_to_str_multimap_store_key(
     JSLStrToStrMultimap* map,
     struct JSL__StrToStrMultimapEntry* entry,
@@ -300,100 +337,178 @@ static JSL__FORCE_INLINE JSLImmutableMemory jsl__str_to_str_multimap_get_key(
     }
 }
 
-static JSL__FORCE_INLINE void jsl__str_to_str_multimap_store_value(
+static JSL__FORCE_INLINE void jsl__str_to_str_multimap_free_key_if_needed(
     JSLStrToStrMultimap* map,
-    struct JSL__StrToStrMultimapValue* value_record,
-    JSLImmutableMemory value,
-    JSLStringLifeTime value_lifetime
+    struct JSL__StrToStrMultimapEntry* entry
 )
 {
-    if (
-        value_lifetime == JSL_STRING_LIFETIME_SHORTER
-        && value.length <= JSL__MULTIMAP_VALUE_SSO_LENGTH
-    )
-    {
-        JSL_MEMCPY(value_record->small_string_buffer, value.data, (size_t) value.length);
-        value_record->sso_len = value.length;
-        value_record->value_state = JSL__SSO;
-    }
-    else if (
-        value_lifetime == JSL_STRING_LIFETIME_SHORTER
-        && value.length > JSL__MULTIMAP_VALUE_SSO_LENGTH
-    )
+    if (map == NULL || entry == NULL)
     {
-        value_record->value = jsl_duplicate(map->allocator, value);
-        value_record->value_state = JSL__DUPLICATED;
+        return;
     }
-    else
+
+    bool should_free = (
+        entry->key_state == JSL__DUPLICATED
+        && entry->key.data != NULL
+        && entry->key.length > 0
+    );
+
+    if (should_free)
     {
-        value_record->value = value;
-        value_record->value_state = JSL__STATIC;
+        jsl_allocator_interface_free(map->allocator, entry->key.data);
     }
 }
 
-static JSL__FORCE_INLINE JSLImmutableMemory jsl__str_to_str_multimap_get_value(
-    struct JSL__StrToStrMultimapValue* value_record
+/**
+ * Make room for at least one more value in the entry's value array. The
+ * views and their states share one allocation, which doubles when full.
+ */
+static bool jsl__str_to_str_multimap_reserve_value(
+    JSLStrToStrMultimap* map,
+    struct JSL__StrToStrMultimapEntry* entry
 )
 {
-    if (value_record == NULL)
-    {
-        return (JSLImmutableMemory) {0};
-    }
+    bool res = entry->value_count < entry->value_capacity;
+
+    int64_t record_size = (int64_t) (sizeof(JSLImmutableMemory) + sizeof(uint8_t));
+    int64_t new_capacity = entry->value_capacity > 0
+        ? entry->value_capacity * 2
+        : JSL__MULTIMAP_VALUE_MIN_CAPACITY;
 
-    if (value_record->value_state == JSL__SSO)
+    bool grow = !res
+        && new_capacity > entry->value_capacity
+        && new_capacity <= INT64_MAX / record_size;
+
+    JSLImmutableMemory* new_values = NULL;
+    if (grow)
     {
-        return (JSLImmutableMemory) {value_record->small_string_buffer, value_record->sso_len};
+        new_values = (JSLImmutableMemory*) jsl_allocator_interface_alloc(
+            map->allocator,
+            record_size * new_capacity,
+            _Alignof(JSLImmutableMemory),
+            false
+        );
     }
-    else if (value_record->value_state == JSL__DUPLICATED || value_record->value_state == JSL__STATIC)
+
+    if (new_values != NULL)
     {
-        return value_record->value;
+        uint8_t* new_states = (uint8_t*) (new_values + new_capacity);
+
+        if (entry->value_count > 0)
+        {
+            JSL_MEMCPY(
+                new_values,
+                entry->values,
+                sizeof(JSLImmutableMemory) * (size_t) entry->value_count
+            );
+            JSL_MEMCPY(new_states, entry->value_states, (size_t) entry->value_count);
+        }
+
+        if (entry->values != NULL)
+            jsl_allocator_interface_free(map->allocator, entry->values);
+
+        entry->values = new_values;
+        entry->value_states = new_states;
+        entry->value_capacity = new_capacity;
+        res = true;
     }
 
-    return (JSLImmutableMemory) {0};
+    return res;
 }
 
-static JSL__FORCE_INLINE void jsl__str_to_str_multimap_free_key_if_needed(
+/**
+ * Copy a short value into the entry's packed chunks, starting a new chunk
+ * twice the size of the last one when the newest chunk is full.
+ *
+ * @returns A view of the copy, with NULL data on allocation failure
+ */
+static JSLImmutableMemory jsl__str_to_str_multimap_pack_value(
     JSLStrToStrMultimap* map,
-    struct JSL__StrToStrMultimapEntry* entry
+    struct JSL__StrToStrMultimapEntry* entry,
+    JSLImmutableMemory value
 )
 {
-    if (map == NULL || entry == NULL)
+    JSLImmutableMemory res = {0};
+
+    struct JSL__StrToStrMultimapValueChunk* chunk = entry->value_chunks;
+    bool fits = chunk != NULL && chunk->capacity - chunk->used >= value.length;
+
+    if (!fits)
     {
-        return;
-    }
+        int64_t capacity = chunk != NULL
+            ? JSL_MIN(chunk->capacity * 2, (int64_t) JSL__MULTIMAP_VALUE_CHUNK_MAX_SIZE)
+            : (int64_t) JSL__MULTIMAP_VALUE_CHUNK_MIN_SIZE;
 
-    bool should_free = (
-        entry->key_state == JSL__DUPLICATED
-        && entry->key.data != NULL
-        && entry->key.length > 0
-    );
+        chunk = (struct JSL__StrToStrMultimapValueChunk*) jsl_allocator_interface_alloc(
+            map->allocator,
+            (int64_t) sizeof(struct JSL__StrToStrMultimapValueChunk) + capacity,
+            _Alignof(struct JSL__StrToStrMultimapValueChunk),
+            false
+        );
 
-    if (should_free)
+        if (chunk != NULL)
+        {
+            chunk->bytes = (uint8_t*) (chunk + 1);
+            chunk->used = 0;
+            chunk->capacity = capacity;
+            chunk->next = entry->value_chunks;
+            entry->value_chunks = chunk;
+        }
+    }
+
+    if (chunk != NULL)
     {
-        jsl_allocator_interface_free(map->allocator, entry->key.data);
+        uint8_t* destination = chunk->bytes + chunk->used;
+        if (value.length > 0)
+            JSL_MEMCPY(destination, value.data, (size_t) value.length);
+
+        chunk->used += value.length;
+        res = (JSLImmutableMemory) {destination, value.length};
     }
+
+    return res;
 }
 
-static JSL__FORCE_INLINE void jsl__str_to_str_multimap_free_value_if_needed(
+/**
+ * Drop every value of the entry. The value array and the newest packed
+ * chunk are kept so a recycled entry can reuse them.
+ */
+static void jsl__str_to_str_multimap_release_values(
     JSLStrToStrMultimap* map,
-    struct JSL__StrToStrMultimapValue* value_record
+    struct JSL__StrToStrMultimapEntry* entry
 )
 {
-    if (map == NULL || value_record == NULL)
+    for (int64_t i = 0; i < entry->value_count; ++i)
     {
-        return;
+        bool should_free = (
+            entry->value_states[i] == JSL__DUPLICATED
+            && entry->values[i].data != NULL
+            && entry->values[i].length > 0
+        );
+
+        if (should_free)
+            jsl_allocator_interface_free(map->allocator, entry->values[i].data);
     }
 
-    bool should_free = (
-        value_record->value_state == JSL__DUPLICATED
-        && value_record->value.data != NULL
-        && value_record->value.length > 0
-    );
+    struct JSL__StrToStrMultimapValueChunk* chunk = entry->value_chunks != NULL
+        ? entry->value_chunks->next
+        : NULL;
 
-    if (should_free)
+    while (chunk != NULL)
     {
-        jsl_allocator_interface_free(map->allocator, value_record->value.data);
+        struct JSL__StrToStrMultimapValueChunk* next = chunk->next;
+        jsl_allocator_interface_free(map->allocator, chunk);
+        chunk = next;
     }
+
+    if (entry->value_chunks != NULL)
+    {
+        entry->value_chunks->next = NULL;
+        entry->value_chunks->used = 0;
+    }
+
+    map->value_count -= entry->value_count;
+    entry->value_count = 0;
 }
 
 static JSL__FORCE_INLINE bool jsl__str_to_str_multimap_add_key(
@@ -405,11 +520,18 @@ static JSL__FORCE_INLINE bool jsl__str_to_str_multimap_add_key(
 )
 {
     struct JSL__StrToStrMultimapEntry* entry = NULL;
-    bool replacing_tombstone = map->entry_lookup_table[lut_index] == JSL__MULTIMAP_TOMBSTONE;
 
     if (map->entry_free_list == NULL)
     {
         entry = JSL_TYPED_ALLOCATE(struct JSL__StrToStrMultimapEntry, map->allocator);
+
+        if (entry != NULL)
+        {
+            entry->values = NULL;
+            entry->value_states = NULL;
+            entry->value_capacity = 0;
+            entry->value_chunks = NULL;
+        }
     }
     else
     {
@@ -420,7 +542,6 @@ static JSL__FORCE_INLINE bool jsl__str_to_str_multimap_add_key(
 
     if (entry != NULL)
     {
-        entry->values_head = NULL;
         entry->value_count = 0;
         entry->hash = hash;
         
@@ -430,11 +551,6 @@ static JSL__FORCE_INLINE bool jsl__str_to_str_multimap_add_key(
         jsl__str_to_str_multimap_store_key(map, entry, key, key_lifetime);
     }
 
-    if (entry != NULL && replacing_tombstone)
-    {
-        --map->tombstone_count;
-    }
-
     return entry != NULL;
 }
 
@@ -445,35 +561,243 @@ static JSL__FORCE_INLINE bool jsl__str_to_str_multimap_add_value_to_key(
     int64_t lut_index
 )
 {
-    struct JSL__StrToStrMultimapValue* value_record = NULL;
     uintptr_t lut_res = map->entry_lookup_table[lut_index];
     struct JSL__StrToStrMultimapEntry* entry = (struct JSL__StrToStrMultimapEntry*) lut_res;
 
-    bool values_ok = lut_res != 0
+    bool res = lut_res != 0
         && lut_res != JSL__MULTIMAP_EMPTY
-        && lut_res != JSL__MULTIMAP_TOMBSTONE;
+        && lut_res != JSL__MULTIMAP_TOMBSTONE
+        && jsl__str_to_str_multimap_reserve_value(map, entry);
+
+    JSLImmutableMemory stored = {0};
+    uint8_t state = JSL__STATIC;
 
-    if (values_ok && map->value_free_list == NULL)
+    if (
+        res
+        && value_lifetime == JSL_STRING_LIFETIME_SHORTER
+        && value.length <= JSL__MULTIMAP_VALUE_SSO_LENGTH
+    )
+    {
+        stored = jsl__str_to_str_multimap_pack_value(map, entry, value);
+        state = JSL__PACKED;
+    }
+    else if (res && value_lifetime == JSL_STRING_LIFETIME_SHORTER)
     {
-        value_record = JSL_TYPED_ALLOCATE(struct JSL__StrToStrMultimapValue, map->allocator);
+        stored = jsl_duplicate(map->allocator, value);
+        state = JSL__DUPLICATED;
     }
-    else if (values_ok)
+    else if (res)
     {
-        struct JSL__StrToStrMultimapValue* next = map->value_free_list->next;
-        value_record = map->value_free_list;
-        map->value_free_list = next;
+        stored = value;
     }
 
-    if (value_record != NULL)
+    res = res && stored.data != NULL;
+
+    if (res)
     {
+        entry->values[entry->value_count] = stored;
+        entry->value_states[entry->value_count] = state;
         ++entry->value_count;
         ++map->value_count;
-        value_record->next = entry->values_head;
-        entry->values_head = value_record;
-        jsl__str_to_str_multimap_store_value(map, value_record, value, value_lifetime);
     }
 
-    return value_record != NULL;
+    return res;
+}
+
+/**
+ * Put an entry which is known not to be in the current table into its
+ * first free slot.
+ */
+static void jsl__str_to_str_multimap_place_entry(
+    JSLStrToStrMultimap* map,
+    struct JSL__StrToStrMultimapEntry* entry
+)
+{
+    int64_t lut_length = map->entry_lookup_table_length;
+    uint64_t lut_mask = (uint64_t) lut_length - 1u;
+    int64_t probe_index = (int64_t) (entry->hash & lut_mask);
+
+    for (int64_t probes = 0; probes < lut_length; ++probes)
+    {
+        uintptr_t probe_res = map->entry_lookup_table[probe_index];
+
+        if (probe_res == 0 || probe_res == JSL__MULTIMAP_EMPTY)
+        {
+            map->entry_lookup_table[probe_index] = (uintptr_t) entry;
+            break;
+        }
+
+        probe_index = (int64_t) (((uint64_t) probe_index + 1u) & lut_mask);
+    }
+}
+
+/**
+ * Move up to `slot_budget` slots of the old table into the current table,
+ * freeing the old table once it has been fully drained. Either one changes
+ * what an iterator walks, so both invalidate iterators even when the caller
+ * (e.g. deleting a missing key) doesn't change anything else.
+ */
+static void jsl__str_to_str_multimap_migrate(
+    JSLStrToStrMultimap* map,
+    int64_t slot_budget
+)
+{
+    uintptr_t* old_table = map->old_entry_lookup_table;
+    int64_t remaining = old_table != NULL
+        ? map->old_entry_lookup_table_length - map->rehash_migrate_index
+        : 0;
+    int64_t slot_count = JSL_MIN(remaining, slot_budget);
+
+    bool moved = false;
+    for (int64_t i = 0; i < slot_count; ++i)
+    {
+        int64_t old_index = map->rehash_migrate_index + i;
+        uintptr_t lut_res = old_table[old_index];
+
+        bool occupied = (
+            lut_res != 0
+            && lut_res != JSL__MULTIMAP_EMPTY
+            && lut_res != JSL__MULTIMAP_TOMBSTONE
+        );
+
+        if (occupied)
+        {
+            struct JSL__StrToStrMultimapEntry* entry = (struct JSL__StrToStrMultimapEntry*) lut_res;
+
+            if (entry->value_count > 0)
+                jsl__str_to_str_multimap_place_entry(map, entry);
+
+            // Leave a tombstone so that lookups of keys which are still
+            // in the old table keep probing past this slot
+            old_table[old_index] = JSL__MULTIMAP_TOMBSTONE;
+            moved = true;
+        }
+    }
+
+    map->rehash_migrate_index += slot_count;
+
+    bool drained = old_table != NULL
+        && map->rehash_migrate_index >= map->old_entry_lookup_table_length;
+
+    if (drained)
+    {
+        jsl_allocator_interface_free(map->allocator, old_table);
+        map->old_entry_lookup_table = NULL;
+        map->old_entry_lookup_table_length = 0;
+        map->rehash_migrate_index = 0;
+    }
+
+    if (moved || drained)
+        ++map->generational_id;
+}
+
+/**
+ * Swap in a table twice the size and keep the current table around as the
+ * old table. Keys are moved over by `jsl__str_to_str_multimap_migrate`.
+ */
+static bool jsl__str_to_str_multimap_begin_incremental_rehash(
+    JSLStrToStrMultimap* map
+)
+{
+    int64_t old_length = map->entry_lookup_table_length;
+    int64_t new_length = jsl_next_power_of_two_i64(old_length + 1);
+
+    bool length_valid = new_length > old_length
+        && new_length <= (INT64_MAX / (int64_t) sizeof(uintptr_t));
+
+    uintptr_t* new_table = NULL;
+    if (length_valid)
+    {
+        new_table = (uintptr_t*) jsl_allocator_interface_alloc(
+            map->allocator,
+            (int64_t) sizeof(uintptr_t) * new_length,
+            _Alignof(uintptr_t),
+            false
+        );
+    }
+
+    for (int64_t i = 0; new_table != NULL && i < new_length; ++i)
+    {
+        new_table[i] = JSL__MULTIMAP_EMPTY;
+    }
+
+    if (new_table != NULL)
+    {
+        map->old_entry_lookup_table = map->entry_lookup_table;
+        map->old_entry_lookup_table_length = old_length;
+        map->rehash_migrate_index = 0;
+
+        map->entry_lookup_table = new_table;
+        map->entry_lookup_table_length = new_length;
+        ++map->generational_id;
+    }
+
+    return new_table != NULL;
+}
+
+static bool jsl__str_to_str_multimap_grow(
+    JSLStrToStrMultimap* map
+)
+{
+    // A previous rehash is still in progress, so the current table filled
+    // up before the old one was drained. Finish it before growing again.
+    jsl__str_to_str_multimap_migrate(map, INT64_MAX);
+
+    bool res = false;
+
+    if (map->rehash_step > 0)
+    {
+        res = jsl__str_to_str_multimap_begin_incremental_rehash(map);
+    }
+    else
+    {
+        res = jsl__str_to_str_multimap_rehash(map);
+    }
+
+    return res;
+}
+
+/**
+ * Look for `key` in the old table of an in progress incremental rehash.
+ * Read only, nothing is moved.
+ *
+ * @returns The old table index of the key, or -1
+ */
+static int64_t jsl__str_to_str_multimap_find_in_old_table(
+    JSLStrToStrMultimap* map,
+    JSLImmutableMemory key,
+    uint64_t hash
+)
+{
+    int64_t res = -1;
+
+    uintptr_t* old_table = map->old_entry_lookup_table;
+    int64_t lut_length = old_table != NULL ? map->old_entry_lookup_table_length : 0;
+    uint64_t lut_mask = (uint64_t) lut_length - 1u;
+    int64_t lut_index = (int64_t) (hash & lut_mask);
+
+    for (int64_t probes = 0; res == -1 && probes < lut_length; ++probes)
+    {
+        uintptr_t lut_res = old_table[lut_index];
+
+        if (lut_res == 0 || lut_res == JSL__MULTIMAP_EMPTY)
+            break;
+
+        if (lut_res != JSL__MULTIMAP_TOMBSTONE)
+        {
+            struct JSL__StrToStrMultimapEntry* entry = (struct JSL__StrToStrMultimapEntry*) lut_res;
+            bool matches = entry->value_count > 0
+                && entry->hash == hash
+                && jsl_memory_compare(key, jsl__str_to_str_multimap_get_key(entry));
+
+            if (matches)
+                res = lut_index;
+        }
+
+        lut_index = (int64_t) (((uint64_t) lut_index + 1u) & lut_mask);
+    }
+
+    return res;
 }
 
 static inline void jsl__str_to_str_multimap_probe(
@@ -487,8 +811,6 @@ static inline void jsl__str_to_str_multimap_probe(
     *out_lut_index = -1;
     *out_found = false;
 
-    int64_t first_tombstone = -1;
-    bool tombstone_seen = false;
     bool searching = true;
 
     *out_hash = jsl__rapidhash_withSeed(key.data, (size_t) key.length, map->hash_seed);
@@ -498,34 +820,25 @@ static inline void jsl__str_to_str_multimap_probe(
     int64_t lut_index = (int64_t) (*out_hash & lut_mask);
     int64_t probes = 0;
 
+    // Deletes shift entries back instead of leaving tombstones, so the
+    // first empty slot always ends the probe sequence
     while (searching && probes < lut_length)
     {
         uintptr_t lut_res = map->entry_lookup_table[lut_index];
 
         bool is_empty = lut_res == JSL__MULTIMAP_EMPTY || lut_res == 0;
-        bool is_tombstone = lut_res == JSL__MULTIMAP_TOMBSTONE;
 
         if (is_empty)
         {
-            *out_lut_index = tombstone_seen ? first_tombstone : lut_index;
+            *out_lut_index = lut_index;
             searching = false;
         }
 
-        bool record_tombstone = searching && is_tombstone && !tombstone_seen;
-        if (record_tombstone)
-        {
-            first_tombstone = lut_index;
-            tombstone_seen = true;
-        }
-
-        bool slot_has_entry = searching && !is_empty && !is_tombstone;
-        struct JSL__StrToStrMultimapEntry* entry = slot_has_entry
+        struct JSL__StrToStrMultimapEntry* entry = searching
             ? (struct JSL__StrToStrMultimapEntry*) lut_res
             : NULL;
 
-        bool entry_valid = slot_has_entry
-            && entry != NULL
-            && entry->value_count > 0;
+        bool entry_valid = entry != NULL && entry->value_count > 0;
 
         JSLImmutableMemory entry_key = entry_valid ? jsl__str_to_str_multimap_get_key(entry) : (JSLImmutableMemory) {0};
         bool matches = entry_valid
@@ -539,33 +852,119 @@ static inline void jsl__str_to_str_multimap_probe(
             searching = false;
         }
 
-        bool empty_entry = slot_has_entry
-            && (entry == NULL || entry->value_count <= 0);
+        bool advance_probe = searching;
+        if (advance_probe)
+        {
+            lut_index = (int64_t) (((uint64_t) lut_index + 1u) & lut_mask);
+            ++probes;
+        }
+    }
+}
+
+/**
+ * Backward shift deletion: empty `start_slot` and pull later keys of
+ * the same probe run back into the hole, so lookups never have to skip
+ * over tombstones.
+ */
+static inline void jsl__str_to_str_multimap_backshift(
+    JSLStrToStrMultimap* map,
+    int64_t start_slot
+)
+{
+    uint64_t lut_mask = (uint64_t) map->entry_lookup_table_length - 1u;
+
+    int64_t hole = start_slot;
+    int64_t current = (int64_t) (((uint64_t) start_slot + 1u) & lut_mask);
+
+    int64_t loop_check = 0;
+    while (loop_check < map->entry_lookup_table_length)
+    {
+        uintptr_t lut_res = map->entry_lookup_table[current];
+
+        if (lut_res == 0 || lut_res == JSL__MULTIMAP_EMPTY)
+            break;
 
-        if (empty_entry)
+        struct JSL__StrToStrMultimapEntry* entry = (struct JSL__StrToStrMultimapEntry*) lut_res;
+        int64_t ideal_slot = (int64_t) (entry->hash & lut_mask);
+
+        bool should_move = (current > hole)
+            ? (ideal_slot <= hole || ideal_slot > current)
+            : (ideal_slot <= hole && ideal_slot > current);
+
+        if (should_move)
         {
-            ++map->tombstone_count;
-            map->entry_lookup_table[lut_index] = JSL__MULTIMAP_TOMBSTONE;
-            if (!tombstone_seen)
-            {
-                first_tombstone = lut_index;
-                tombstone_seen = true;
-            }
+            map->entry_lookup_table[hole] = lut_res;
+            hole = current;
         }
 
-        bool advance_probe = searching;
-        if (advance_probe)
-        {
-            lut_index = (int64_t) (((uint64_t) lut_index + 1u) & lut_mask);
-            ++probes;
-        }
+        current = (int64_t) (((uint64_t) current + 1u) & lut_mask);
+
+        ++loop_check;
+    }
+
+    map->entry_lookup_table[hole] = JSL__MULTIMAP_EMPTY;
+}
+
+/**
+ * Remove the key in `slot` from whichever table holds it. The current
+ * table is compacted with a backward shift. The old table of an
+ * incremental rehash keeps a tombstone instead, shifting its keys back
+ * could move them behind the migration cursor where they would never be
+ * moved over.
+ */
+static inline void jsl__str_to_str_multimap_remove_slot(
+    JSLStrToStrMultimap* map,
+    uintptr_t* slot,
+    bool in_old_table
+)
+{
+    if (in_old_table)
+    {
+        *slot = JSL__MULTIMAP_TOMBSTONE;
+    }
+    else
+    {
+        jsl__str_to_str_multimap_backshift(map, (int64_t) (slot - map->entry_lookup_table));
+    }
+}
+
+/**
+ * Find the lookup table slot holding `key`, checking the old table of an
+ * in progress incremental rehash when the key isn't in the current one.
+ *
+ * @returns A pointer to the slot, or NULL when the key isn't in the map
+ */
+static uintptr_t* jsl__str_to_str_multimap_find_slot(
+    JSLStrToStrMultimap* map,
+    JSLImmutableMemory key,
+    bool* out_in_old_table
+)
+{
+    uintptr_t* res = NULL;
+    *out_in_old_table = false;
+
+    uint64_t hash = 0;
+    int64_t lut_index = -1;
+    bool existing_found = false;
+    jsl__str_to_str_multimap_probe(map, key, &lut_index, &hash, &existing_found);
+
+    int64_t old_index = -1;
+    if (!existing_found && map->old_entry_lookup_table != NULL)
+    {
+        old_index = jsl__str_to_str_multimap_find_in_old_table(map, key, hash);
     }
 
-    bool exhausted = searching && probes >= lut_length;
-    if (exhausted)
+    if (existing_found && lut_index > -1)
+    {
+        res = &map->entry_lookup_table[lut_index];
+    }
+    else if (old_index > -1)
     {
-        *out_lut_index = tombstone_seen ? first_tombstone : -1;
+        res = &map->old_entry_lookup_table[old_index];
+        *out_in_old_table = true;
     }
+
+    return res;
 }
 
 JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_insert(
@@ -585,18 +984,21 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_insert(
         && value.length > -1
     );
 
+    if (res && map->old_entry_lookup_table != NULL)
+    {
+        jsl__str_to_str_multimap_migrate(map, map->rehash_step);
+    }
+
     bool needs_rehash = false;
     if (res)
     {
-        float occupied_count = (float) (map->key_count + map->tombstone_count);
-        float current_load_factor =  occupied_count / (float) map->entry_lookup_table_length;
-        bool too_many_tombstones = map->tombstone_count > (map->entry_lookup_table_length / 4);
-        needs_rehash = current_load_factor >= map->load_factor || too_many_tombstones;
+        float current_load_factor = (float) map->key_count / (float) map->entry_lookup_table_length;
+        needs_rehash = current_load_factor >= map->load_factor;
     }
 
     if (JSL__UNLIKELY(needs_rehash))
     {
-        res = jsl__str_to_str_multimap_rehash(map);
+        res = jsl__str_to_str_multimap_grow(map);
     }
 
     uint64_t hash = 0;
@@ -606,6 +1008,24 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_insert(
     {
         jsl__str_to_str_multimap_probe(map, key, &lut_index, &hash, &existing_found);
     }
+
+    int64_t old_index = -1;
+    if (res && !existing_found && map->old_entry_lookup_table != NULL)
+    {
+        old_index = jsl__str_to_str_multimap_find_in_old_table(map, key, hash);
+    }
+
+    // insert into existing key which hasn't been migrated yet, it's moved
+    // into the current table first so that the value helpers only ever
+    // deal with one table
+    if (old_index > -1 && lut_index > -1)
+    {
+        struct JSL__StrToStrMultimapEntry* entry = (struct JSL__StrToStrMultimapEntry*)
+            map->old_entry_lookup_table[old_index];
+        map->old_entry_lookup_table[old_index] = JSL__MULTIMAP_TOMBSTONE;
+        map->entry_lookup_table[lut_index] = (uintptr_t) entry;
+        existing_found = true;
+    }
     
     // insert into existing
     if (lut_index > -1 && existing_found)
@@ -635,9 +1055,8 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_has_key(
     JSLImmutableMemory key
 )
 {
-    uint64_t hash = 0;
-    int64_t lut_index = -1;
-    bool existing_found = false;
+    uintptr_t* found_slot = NULL;
+    bool in_old_table = false;
 
     if (
         map != NULL
@@ -646,10 +1065,10 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_has_key(
         && key.length > -1
     )
     {
-        jsl__str_to_str_multimap_probe(map, key, &lut_index, &hash, &existing_found);
+        found_slot = jsl__str_to_str_multimap_find_slot(map, key, &in_old_table);
     }
 
-    return lut_index > -1 && existing_found;
+    return found_slot != NULL;
 }
 
 JSL_STR_TO_STR_MULTIMAP_DEF int64_t jsl_str_to_str_multimap_get_key_count(
@@ -704,19 +1123,17 @@ JSL_STR_TO_STR_MULTIMAP_DEF int64_t jsl_str_to_str_multimap_get_value_count_for_
     )
         proceed = true;
 
-    uint64_t hash = 0;
-    int64_t lut_index = -1;
-    bool existing_found = false;
+    uintptr_t* found_slot = NULL;
+    bool in_old_table = false;
     if (proceed)
     {
-        jsl__str_to_str_multimap_probe(map, key, &lut_index, &hash, &existing_found);
-        proceed = lut_index > -1 && existing_found;
+        found_slot = jsl__str_to_str_multimap_find_slot(map, key, &in_old_table);
+        proceed = found_slot != NULL;
     }
 
     if (proceed)
     {
-        struct JSL__StrToStrMultimapEntry* entry = (struct JSL__StrToStrMultimapEntry*) 
-            map->entry_lookup_table[lut_index];
+        struct JSL__StrToStrMultimapEntry* entry = (struct JSL__StrToStrMultimapEntry*) *found_slot;
         res = entry->value_count;
     }
     else if (map != NULL && map->sentinel == JSL__MULTIMAP_PRIVATE_SENTINEL)
@@ -727,6 +1144,46 @@ JSL_STR_TO_STR_MULTIMAP_DEF int64_t jsl_str_to_str_multimap_get_value_count_for_
     return res;
 }
 
+JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_get_values_span(
+    JSLStrToStrMultimap* map,
+    JSLImmutableMemory key,
+    const JSLImmutableMemory** out_values,
+    int64_t* out_value_count
+)
+{
+    bool params_valid = (
+        map != NULL
+        && map->sentinel == JSL__MULTIMAP_PRIVATE_SENTINEL
+        && key.data != NULL
+        && key.length > -1
+        && out_values != NULL
+        && out_value_count != NULL
+    );
+
+    if (params_valid)
+    {
+        *out_values = NULL;
+        *out_value_count = 0;
+    }
+
+    uintptr_t* found_slot = NULL;
+    bool in_old_table = false;
+    if (params_valid)
+    {
+        found_slot = jsl__str_to_str_multimap_find_slot(map, key, &in_old_table);
+    }
+
+    bool res = found_slot != NULL;
+    if (res)
+    {
+        struct JSL__StrToStrMultimapEntry* entry = (struct JSL__StrToStrMultimapEntry*) *found_slot;
+        *out_values = entry->values;
+        *out_value_count = entry->value_count;
+    }
+
+    return res;
+}
+
 JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_key_value_iterator_init(
     JSLStrToStrMultimap* map,
     JSLStrToStrMultimapKeyValueIter* iterator
@@ -743,7 +1200,7 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_key_value_iterator_init
         iterator->map = map;
         iterator->current_lut_index = 0;
         iterator->current_entry = NULL;
-        iterator->current_value = NULL;
+        iterator->current_value_index = 0;
         iterator->sentinel = JSL__MULTIMAP_PRIVATE_SENTINEL;
         iterator->generational_id = map->generational_id;
         res = true;
@@ -774,21 +1231,17 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_key_value_iterator_next
     bool try_same_entry = (
         params_valid
         && iterator->current_entry != NULL
-        && iterator->current_value != NULL
     );
 
-    struct JSL__StrToStrMultimapValue* next_value = NULL;
-    if (try_same_entry)
-    {
-        next_value = iterator->current_value->next;
-    }
+    int64_t next_value_index = iterator != NULL ? iterator->current_value_index + 1 : 0;
 
-    bool next_value_ready = try_same_entry && next_value != NULL;
+    bool next_value_ready = try_same_entry
+        && next_value_index < iterator->current_entry->value_count;
     if (next_value_ready)
     {
-        iterator->current_value = next_value;
+        iterator->current_value_index = next_value_index;
         *out_key = jsl__str_to_str_multimap_get_key(iterator->current_entry);
-        *out_value = jsl__str_to_str_multimap_get_value(iterator->current_value);
+        *out_value = iterator->current_entry->values[next_value_index];
         found = true;
     }
 
@@ -796,17 +1249,24 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_key_value_iterator_next
     if (reached_end_of_entry)
     {
         iterator->current_entry = NULL;
-        iterator->current_value = NULL;
+        iterator->current_value_index = 0;
     }
 
+    // While an incremental rehash is in progress the old table is walked
+    // after the current one, as if the two were one long table
     bool search_for_entry = params_valid && !found;
     int64_t lut_length = params_valid ? iterator->map->entry_lookup_table_length : 0;
+    int64_t old_length = params_valid && iterator->map->old_entry_lookup_table != NULL
+        ? iterator->map->old_entry_lookup_table_length
+        : 0;
     int64_t lut_index = iterator->current_lut_index;
     struct JSL__StrToStrMultimapEntry* found_entry = NULL;
 
-    while (search_for_entry && lut_index < lut_length)
+    while (search_for_entry && lut_index < lut_length + old_length)
     {
-        uintptr_t lut_res = iterator->map->entry_lookup_table[lut_index];
+        uintptr_t lut_res = lut_index < lut_length
+            ? iterator->map->entry_lookup_table[lut_index]
+            : iterator->map->old_entry_lookup_table[lut_index - lut_length];
 
         bool occupied = (
             lut_res != 0
@@ -823,10 +1283,7 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_key_value_iterator_next
         bool has_values = false;
         if (occupied)
         {
-            has_values = (
-                candidate_entry->values_head != NULL
-                && candidate_entry->value_count > 0
-            );
+            has_values = candidate_entry->value_count > 0;
         }
 
         if (has_values)
@@ -846,10 +1303,10 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_key_value_iterator_next
     if (entry_found)
     {
         iterator->current_entry = found_entry;
-        iterator->current_value = found_entry->values_head;
+        iterator->current_value_index = 0;
         iterator->current_lut_index = lut_index + 1;
         *out_key = jsl__str_to_str_multimap_get_key(iterator->current_entry);
-        *out_value = jsl__str_to_str_multimap_get_value(iterator->current_value);
+        *out_value = found_entry->values[0];
         found = true;
     }
 
@@ -857,8 +1314,8 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_key_value_iterator_next
     if (exhausted)
     {
         iterator->current_entry = NULL;
-        iterator->current_value = NULL;
-        iterator->current_lut_index = lut_length;
+        iterator->current_value_index = 0;
+        iterator->current_lut_index = lut_length + old_length;
     }
 
     bool invalidated = !params_valid;
@@ -882,7 +1339,7 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_get_values_for_key_iter
     {
         iterator->map = NULL;
         iterator->entry = NULL;
-        iterator->current_value = NULL;
+        iterator->current_value_index = 0;
         iterator->generational_id = 0;
         iterator->sentinel = 0;
     }
@@ -896,39 +1353,37 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_get_values_for_key_iter
         && key.length > -1
     );
 
-    uint64_t hash = 0;
-    int64_t lut_index = -1;
-    bool existing_found = false;
+    uintptr_t* found_slot = NULL;
+    bool in_old_table = false;
     if (params_valid)
     {
         iterator->map = map;
         iterator->generational_id = map->generational_id;
         iterator->sentinel = JSL__MULTIMAP_PRIVATE_SENTINEL;
 
-        jsl__str_to_str_multimap_probe(map, key, &lut_index, &hash, &existing_found);
+        found_slot = jsl__str_to_str_multimap_find_slot(map, key, &in_old_table);
     }
 
     struct JSL__StrToStrMultimapEntry* found_entry = NULL;
-    bool entry_found = existing_found && lut_index > -1;
+    bool entry_found = found_slot != NULL;
     if (entry_found)
     {
-        found_entry = (struct JSL__StrToStrMultimapEntry*) map->entry_lookup_table[lut_index];
+        found_entry = (struct JSL__StrToStrMultimapEntry*) *found_slot;
     }
 
     bool has_values = entry_found
         && found_entry != NULL
-        && found_entry->values_head != NULL
         && found_entry->value_count > 0;
 
     if (has_values)
     {
         iterator->entry = found_entry;
-        iterator->current_value = NULL;
+        iterator->current_value_index = 0;
     }
-    else
+    else if (iterator_valid)
     {
         iterator->entry = NULL;
-        iterator->current_value = NULL;
+        iterator->current_value_index = 0;
     }
 
     return params_valid;
@@ -953,21 +1408,12 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_get_values_for_key_iter
 
     bool entry_available = params_valid && iterator->entry != NULL;
 
-    struct JSL__StrToStrMultimapValue* next_value = NULL;
-    if (entry_available && iterator->current_value == NULL)
-    {
-        next_value = iterator->entry->values_head;
-    }
-    else if (entry_available && iterator->current_value != NULL)
-    {
-        next_value = iterator->current_value->next;
-    }
-
-    bool next_ready = entry_available && next_value != NULL;
+    bool next_ready = entry_available
+        && iterator->current_value_index < iterator->entry->value_count;
     if (next_ready)
     {
-        iterator->current_value = next_value;
-        *out_value = jsl__str_to_str_multimap_get_value(next_value);
+        *out_value = iterator->entry->values[iterator->current_value_index];
+        ++iterator->current_value_index;
         found = true;
     }
 
@@ -975,7 +1421,7 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_get_values_for_key_iter
     if (exhausted)
     {
         iterator->entry = NULL;
-        iterator->current_value = NULL;
+        iterator->current_value_index = 0;
     }
 
     return found;
@@ -996,48 +1442,32 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_delete_key(
         && key.length > -1
     );
 
-    uint64_t hash = 0;
-    int64_t lut_index = -1;
-    bool existing_found = false;
+    if (params_valid && map->old_entry_lookup_table != NULL)
+    {
+        jsl__str_to_str_multimap_migrate(map, map->rehash_step);
+    }
+
+    uintptr_t* found_slot = NULL;
+    bool in_old_table = false;
     if (params_valid)
     {
-        jsl__str_to_str_multimap_probe(map, key, &lut_index, &hash, &existing_found);
+        found_slot = jsl__str_to_str_multimap_find_slot(map, key, &in_old_table);
     }
 
-    bool key_found = existing_found && lut_index > -1;
+    bool key_found = found_slot != NULL;
 
     struct JSL__StrToStrMultimapEntry* entry = NULL;
     if (key_found)
     {
-        entry = (struct JSL__StrToStrMultimapEntry*) map->entry_lookup_table[lut_index];
+        entry = (struct JSL__StrToStrMultimapEntry*) *found_slot;
     }
 
     bool entry_valid = key_found && entry != NULL;
 
-    int64_t removed_value_count = 0;
-    struct JSL__StrToStrMultimapValue* value_record = NULL;
-    if (entry_valid)
-    {
-        value_record = entry->values_head;
-    }
-
-    while (entry_valid && value_record != NULL)
-    {
-        struct JSL__StrToStrMultimapValue* next = value_record->next;
-        jsl__str_to_str_multimap_free_value_if_needed(map, value_record);
-        value_record->next = map->value_free_list;
-        map->value_free_list = value_record;
-        value_record = next;
-        ++removed_value_count;
-    }
-
     if (entry_valid)
     {
-        entry->values_head = NULL;
-        entry->value_count = 0;
-
-        map->value_count -= removed_value_count;
-        map->entry_lookup_table[lut_index] = JSL__MULTIMAP_TOMBSTONE;
+        jsl__str_to_str_multimap_release_values(map, entry);
+        jsl__str_to_str_multimap_remove_slot(map, found_slot, in_old_table);
 
         jsl__str_to_str_multimap_free_key_if_needed(map, entry);
         entry->next = map->entry_free_list;
@@ -1045,7 +1475,6 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_delete_key(
 
         --map->key_count;
         ++map->generational_id;
-        ++map->tombstone_count;
 
         res = true;
     }
@@ -1071,76 +1500,70 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_delete_value(
         && value.length > -1
     );
 
-    uint64_t hash = 0;
-    int64_t lut_index = -1;
-    bool existing_found = false;
+    if (params_valid && map->old_entry_lookup_table != NULL)
+    {
+        jsl__str_to_str_multimap_migrate(map, map->rehash_step);
+    }
+
+    uintptr_t* found_slot = NULL;
+    bool in_old_table = false;
     if (params_valid)
     {
-        jsl__str_to_str_multimap_probe(map, key, &lut_index, &hash, &existing_found);
+        found_slot = jsl__str_to_str_multimap_find_slot(map, key, &in_old_table);
     }
 
-    bool key_found = params_valid && existing_found && lut_index > -1;
+    bool key_found = params_valid && found_slot != NULL;
 
     struct JSL__StrToStrMultimapEntry* entry = NULL;
     if (key_found)
     {
-        entry = (struct JSL__StrToStrMultimapEntry*) map->entry_lookup_table[lut_index];
+        entry = (struct JSL__StrToStrMultimapEntry*) *found_slot;
     }
 
     bool entry_valid = key_found
         && entry != NULL
-        && entry->values_head != NULL
         && entry->value_count > 0;
 
-    struct JSL__StrToStrMultimapValue* previous = NULL;
-    struct JSL__StrToStrMultimapValue* current = NULL;
-    if (entry_valid)
-    {
-        current = entry->values_head;
-    }
-
+    int64_t value_index = 0;
     bool value_found = false;
-    while (entry_valid && current != NULL && !value_found)
+    while (entry_valid && !value_found && value_index < entry->value_count)
     {
-        JSLImmutableMemory stored_value = jsl__str_to_str_multimap_get_value(current);
-        bool equal = jsl_memory_compare(stored_value, value);
-        if (equal)
-        {
-            value_found = true;
-        }
+        value_found = jsl_memory_compare(entry->values[value_index], value);
 
-        bool advance = !value_found;
-        if (advance)
-        {
-            previous = current;
-            current = current->next;
-        }
+        if (!value_found)
+            ++value_index;
     }
 
-    bool remove_from_list = entry_valid && value_found && current != NULL;
-    struct JSL__StrToStrMultimapValue* next_node = NULL;
+    bool remove_from_list = entry_valid && value_found;
     if (remove_from_list)
     {
-        next_node = current->next;
-    }
+        JSLImmutableMemory removed = entry->values[value_index];
+        bool should_free = (
+            entry->value_states[value_index] == JSL__DUPLICATED
+            && removed.data != NULL
+            && removed.length > 0
+        );
 
-    bool removing_head = remove_from_list && previous == NULL;
-    if (removing_head)
-    {
-        entry->values_head = next_node;
-    }
+        if (should_free)
+            jsl_allocator_interface_free(map->allocator, removed.data);
 
-    bool removing_non_head = remove_from_list && previous != NULL;
-    if (removing_non_head)
-    {
-        previous->next = next_node;
-    }
+        // Shift the later values down rather than swapping in the last one
+        // so that the values keep their insertion order
+        int64_t trailing = entry->value_count - value_index - 1;
+        if (trailing > 0)
+        {
+            JSL_MEMMOVE(
+                &entry->values[value_index],
+                &entry->values[value_index + 1],
+                sizeof(JSLImmutableMemory) * (size_t) trailing
+            );
+            JSL_MEMMOVE(
+                &entry->value_states[value_index],
+                &entry->value_states[value_index + 1],
+                (size_t) trailing
+            );
+        }
 
-    if (remove_from_list)
-    {
-        jsl__str_to_str_multimap_free_value_if_needed(map, current);
-        current->next = map->value_free_list;
-        map->value_free_list = current;
         --entry->value_count;
         --map->value_count;
     }
@@ -1148,8 +1571,8 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_delete_value(
     bool entry_empty = remove_from_list && entry->value_count == 0;
     if (entry_empty)
     {
-        map->entry_lookup_table[lut_index] = JSL__MULTIMAP_TOMBSTONE;
-        ++map->tombstone_count;
+        jsl__str_to_str_multimap_release_values(map, entry);
+        jsl__str_to_str_multimap_remove_slot(map, found_slot, in_old_table);
 
         jsl__str_to_str_multimap_free_key_if_needed(map, entry);
         entry->next = map->entry_free_list;
@@ -1177,12 +1600,20 @@ JSL_STR_TO_STR_MULTIMAP_DEF void jsl_str_to_str_multimap_clear(
         && map->entry_lookup_table != NULL
     );
 
+    // Keys which have not been migrated yet are recycled from the old
+    // table, then the old table is dropped and the rehash is over
     int64_t lut_length = params_valid ? map->entry_lookup_table_length : 0;
+    int64_t old_length = params_valid && map->old_entry_lookup_table != NULL
+        ? map->old_entry_lookup_table_length
+        : 0;
     int64_t index = 0;
 
-    while (params_valid && index < lut_length)
+    while (params_valid && index < lut_length + old_length)
     {
-        uintptr_t lut_res = map->entry_lookup_table[index];
+        uintptr_t* slot = index < lut_length
+            ? &map->entry_lookup_table[index]
+            : &map->old_entry_lookup_table[index - lut_length];
+        uintptr_t lut_res = *slot;
         bool occupied = (
             lut_res != 0
             && lut_res != JSL__MULTIMAP_EMPTY
@@ -1197,28 +1628,11 @@ JSL_STR_TO_STR_MULTIMAP_DEF void jsl_str_to_str_multimap_clear(
 
         bool entry_has_values = occupied
             && entry != NULL
-            && entry->values_head != NULL
             && entry->value_count > 0;
 
-        struct JSL__StrToStrMultimapValue* value_record = NULL;
-        if (entry_has_values)
-        {
-            value_record = entry->values_head;
-        }
-
-        while (entry_has_values && value_record != NULL)
-        {
-            struct JSL__StrToStrMultimapValue* next_value = value_record->next;
-            jsl__str_to_str_multimap_free_value_if_needed(map, value_record);
-            value_record->next = map->value_free_list;
-            map->value_free_list = value_record;
-            value_record = next_value;
-        }
-
         if (entry_has_values)
         {
-            entry->values_head = NULL;
-            entry->value_count = 0;
+            jsl__str_to_str_multimap_release_values(map, entry);
         }
 
         bool recycle_entry = occupied && entry != NULL;
@@ -1227,27 +1641,235 @@ JSL_STR_TO_STR_MULTIMAP_DEF void jsl_str_to_str_multimap_clear(
             jsl__str_to_str_multimap_free_key_if_needed(map, entry);
             entry->next = map->entry_free_list;
             map->entry_free_list = entry;
-            map->entry_lookup_table[index] = JSL__MULTIMAP_EMPTY;
+            *slot = JSL__MULTIMAP_EMPTY;
         }
         else if (params_valid && lut_res == JSL__MULTIMAP_TOMBSTONE)
         {
-            map->entry_lookup_table[index] = JSL__MULTIMAP_EMPTY;
+            *slot = JSL__MULTIMAP_EMPTY;
         }
 
         ++index;
     }
 
+    if (params_valid && map->old_entry_lookup_table != NULL)
+    {
+        jsl_allocator_interface_free(map->allocator, map->old_entry_lookup_table);
+        map->old_entry_lookup_table = NULL;
+        map->old_entry_lookup_table_length = 0;
+        map->rehash_migrate_index = 0;
+    }
+
     if (params_valid)
     {
         map->key_count = 0;
         map->value_count = 0;
-        map->tombstone_count = 0;
         ++map->generational_id;
     }
 
     return;
 }
 
+JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_enable_incremental_rehash(
+    JSLStrToStrMultimap* map,
+    int64_t slots_per_operation
+)
+{
+    bool res = (
+        map != NULL
+        && map->sentinel == JSL__MULTIMAP_PRIVATE_SENTINEL
+        && slots_per_operation > -1
+    );
+
+    if (res)
+    {
+        map->rehash_step = slots_per_operation;
+    }
+
+    if (res && slots_per_operation == 0)
+    {
+        res = jsl_str_to_str_multimap_finish_rehash(map);
+    }
+
+    return res;
+}
+
+JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_finish_rehash(
+    JSLStrToStrMultimap* map
+)
+{
+    bool res = (
+        map != NULL
+        && map->sentinel == JSL__MULTIMAP_PRIVATE_SENTINEL
+    );
+
+    if (res && map->old_entry_lookup_table != NULL)
+    {
+        jsl__str_to_str_multimap_migrate(map, INT64_MAX);
+        ++map->generational_id;
+    }
+
+    return res;
+}
+
+JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_reserve(
+    JSLStrToStrMultimap* map,
+    int64_t key_count
+)
+{
+    bool res = (
+        map != NULL
+        && map->sentinel == JSL__MULTIMAP_PRIVATE_SENTINEL
+        && key_count > -1
+    );
+
+    int64_t new_length = res
+        ? jsl__str_to_str_multimap_lookup_table_length_for(map, key_count)
+        : -1;
+
+    res = res && new_length > 0 && jsl_str_to_str_multimap_finish_rehash(map);
+
+    if (res && new_length > map->entry_lookup_table_length)
+    {
+        res = jsl__str_to_str_multimap_rehash_to_length(map, new_length);
+    }
+
+    return res;
+}
+
+JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_shrink_to_fit(
+    JSLStrToStrMultimap* map
+)
+{
+    bool res = (
+        map != NULL
+        && map->sentinel == JSL__MULTIMAP_PRIVATE_SENTINEL
+    );
+
+    res = res && jsl_str_to_str_multimap_finish_rehash(map);
+
+    // Recycled entries keep their value array and newest packed chunk
+    struct JSL__StrToStrMultimapEntry* entry = res ? map->entry_free_list : NULL;
+    while (entry != NULL)
+    {
+        struct JSL__StrToStrMultimapEntry* next = entry->next;
+
+        if (entry->values != NULL)
+            jsl_allocator_interface_free(map->allocator, entry->values);
+
+        struct JSL__StrToStrMultimapValueChunk* chunk = entry->value_chunks;
+        while (chunk != NULL)
+        {
+            struct JSL__StrToStrMultimapValueChunk* next_chunk = chunk->next;
+            jsl_allocator_interface_free(map->allocator, chunk);
+            chunk = next_chunk;
+        }
+
+        jsl_allocator_interface_free(map->allocator, entry);
+        entry = next;
+    }
+
+    if (res)
+    {
+        map->entry_free_list = NULL;
+    }
+
+    int64_t new_length = res
+        ? jsl__str_to_str_multimap_lookup_table_length_for(map, map->key_count)
+        : -1;
+
+    if (res && new_length > 0 && new_length < map->entry_lookup_table_length)
+    {
+        res = jsl__str_to_str_multimap_rehash_to_length(map, new_length);
+    }
+
+    return res;
+}
+
+/**
+ * Bytes an entry holds apart from its key, the entry itself, its value
+ * array, its packed chunks, and its duplicated values.
+ */
+static int64_t jsl__str_to_str_multimap_entry_footprint(
+    struct JSL__StrToStrMultimapEntry* entry
+)
+{
+    int64_t record_size = (int64_t) (sizeof(JSLImmutableMemory) + sizeof(uint8_t));
+    int64_t res = (int64_t) sizeof(struct JSL__StrToStrMultimapEntry)
+        + record_size * entry->value_capacity;
+
+    struct JSL__StrToStrMultimapValueChunk* chunk = entry->value_chunks;
+    while (chunk != NULL)
+    {
+        res += (int64_t) sizeof(struct JSL__StrToStrMultimapValueChunk) + chunk->capacity;
+        chunk = chunk->next;
+    }
+
+    for (int64_t i = 0; i < entry->value_count; ++i)
+    {
+        if (entry->value_states[i] == JSL__DUPLICATED)
+            res += entry->values[i].length;
+    }
+
+    return res;
+}
+
+JSL_STR_TO_STR_MULTIMAP_DEF int64_t jsl_str_to_str_multimap_memory_footprint(
+    JSLStrToStrMultimap* map
+)
+{
+    bool params_valid = (
+        map != NULL
+        && map->sentinel == JSL__MULTIMAP_PRIVATE_SENTINEL
+    );
+
+    int64_t lut_length = params_valid ? map->entry_lookup_table_length : 0;
+    int64_t old_length = params_valid && map->old_entry_lookup_table != NULL
+        ? map->old_entry_lookup_table_length
+        : 0;
+
+    int64_t res = params_valid
+        ? (int64_t) sizeof(uintptr_t) * (lut_length + old_length)
+        : -1;
+
+    int64_t lut_index = 0;
+    while (params_valid && lut_index < lut_length + old_length)
+    {
+        uintptr_t lut_res = lut_index < lut_length
+            ? map->entry_lookup_table[lut_index]
+            : map->old_entry_lookup_table[lut_index - lut_length];
+
+        bool occupied = (
+            lut_res != 0
+            && lut_res != JSL__MULTIMAP_EMPTY
+            && lut_res != JSL__MULTIMAP_TOMBSTONE
+        );
+
+        if (occupied)
+        {
+            struct JSL__StrToStrMultimapEntry* entry = (struct JSL__StrToStrMultimapEntry*) lut_res;
+            res += jsl__str_to_str_multimap_entry_footprint(entry);
+
+            if (entry->key_state == JSL__DUPLICATED)
+                res += entry->key.length;
+        }
+
+        ++lut_index;
+    }
+
+    // Keys are freed on delete, the rest of the entry is kept for reuse
+    struct JSL__StrToStrMultimapEntry* entry = params_valid ? map->entry_free_list : NULL;
+    while (entry != NULL)
+    {
+        res += jsl__str_to_str_multimap_entry_footprint(entry);
+        entry = entry->next;
+    }
+
+    return res;
+}
+
 #undef JSL__MULTIMAP_KEY_SSO_LENGTH
 #undef JSL__MULTIMAP_VALUE_SSO_LENGTH
 #undef JSL__MULTIMAP_PRIVATE_SENTINEL
+#undef JSL__MULTIMAP_VALUE_MIN_CAPACITY
+#undef JSL__MULTIMAP_VALUE_CHUNK_MIN_SIZE
+#undef JSL__MULTIMAP_VALUE_CHUNK_MAX_SIZE
@@ -22,6 +22,18 @@
  * * have an initial item count guess as accurate as you can to reduce rehashes
  * * have the arena have as short a lifetime as possible
  * 
+ * By default a rehash moves every entry into the new table at once, which
+ * is a long pause on large multimaps. Latency sensitive users can turn on
+ * incremental rehashing with `jsl_str_to_str_multimap_enable_incremental_rehash`,
+ * which keeps the old table around and moves a few slots on every insert
+ * and delete instead.
+ * 
+ * The values of a key are kept in one contiguous array in insertion order,
+ * and short values which are copied into the map are packed together into
+ * per key blocks. Space for a value removed with
+ * `jsl_str_to_str_multimap_delete_value` is only reclaimed once the whole
+ * key is deleted or the map is cleared.
+ * 
  * ## License
  *
  * Copyright (c) 2026 Jack Stouffer
@@ -81,20 +93,14 @@ enum JSLStrToStrMultimapKeyState {
 #define JSL__MULTIMAP_KEY_SSO_LENGTH 24
 #define JSL__MULTIMAP_VALUE_SSO_LENGTH 32
 
-struct JSL__StrToStrMultimapValue
+/// @brief Block that short values copied into the map are packed into.
+/// Each key owns a list of these, newest first.
+struct JSL__StrToStrMultimapValueChunk
 {
-    union
-    {
-        struct
-        {
-            int64_t sso_len;
-            uint8_t small_string_buffer[JSL__MULTIMAP_VALUE_SSO_LENGTH];
-        };
-        JSLImmutableMemory value;
-    };
-    
-    struct JSL__StrToStrMultimapValue* next;
-    uint8_t value_state;
+    struct JSL__StrToStrMultimapValueChunk* next;
+    uint8_t* bytes;
+    int64_t used;
+    int64_t capacity;
 };
 
 struct JSL__StrToStrMultimapEntry {
@@ -115,17 +121,24 @@ struct JSL__StrToStrMultimapEntry {
     // TODO: docs
     uint64_t hash;
 
-    // TODO: docs
-    struct JSL__StrToStrMultimapValue* values_head;
-
+    /// @brief Every value of the key in insertion order. Values are stored
+    /// contiguously so they can be handed out as one span.
+    JSLImmutableMemory* values;
+    /// @brief How each value is stored, parallel to `values` and in the same allocation
+    uint8_t* value_states;
     int64_t value_count;
+    int64_t value_capacity;
+
+    /// @brief Storage for short values with a shorter lifetime than the map
+    struct JSL__StrToStrMultimapValueChunk* value_chunks;
+
     uint8_t key_state;
 };
 
 struct JSL__StrToStrMultimapKeyValueIter {
     struct JSL__StrToStrMultimap* map;
     struct JSL__StrToStrMultimapEntry* current_entry;
-    struct JSL__StrToStrMultimapValue* current_value;
+    int64_t current_value_index;
     int64_t current_lut_index;
     int64_t generational_id;
     uint64_t sentinel;
@@ -134,7 +147,7 @@ struct JSL__StrToStrMultimapKeyValueIter {
 struct JSL__StrToStrMultimapValueIter {
     struct JSL__StrToStrMultimap* map;
     struct JSL__StrToStrMultimapEntry* entry;
-    struct JSL__StrToStrMultimapValue* current_value;
+    int64_t current_value_index;
     int64_t generational_id;
     uint64_t sentinel;
 };
@@ -150,12 +163,18 @@ struct JSL__StrToStrMultimap {
     uintptr_t* entry_lookup_table;
     int64_t entry_lookup_table_length;
 
+    /// @brief previous table while an incremental rehash is in progress, NULL otherwise
+    uintptr_t* old_entry_lookup_table;
+    int64_t old_entry_lookup_table_length;
+    /// @brief next slot in the old table to move into the current table
+    int64_t rehash_migrate_index;
+    /// @brief old table slots moved per insert or delete, zero when incremental rehashing is off
+    int64_t rehash_step;
+
     int64_t key_count;
     int64_t value_count;
-    int64_t tombstone_count;
 
     struct JSL__StrToStrMultimapEntry* entry_free_list;
-    struct JSL__StrToStrMultimapValue* value_free_list;
 
     uint64_t hash_seed;
     float load_factor;
@@ -205,6 +224,7 @@ struct JSL__StrToStrMultimap {
  * * jsl_str_to_str_multimap_has_key
  * * jsl_str_to_str_multimap_insert
  * * jsl_str_to_str_multimap_get_value_count_for_key
+ * * jsl_str_to_str_multimap_get_values_span
  * * jsl_str_to_str_multimap_key_value_iterator_init
  * * jsl_str_to_str_multimap_key_value_iterator_next
  * * jsl_str_to_str_multimap_get_values_for_key_iterator_init
@@ -212,6 +232,11 @@ struct JSL__StrToStrMultimap {
  * * jsl_str_to_str_multimap_delete_key
  * * jsl_str_to_str_multimap_delete_value
  * * jsl_str_to_str_multimap_clear
+ * * jsl_str_to_str_multimap_enable_incremental_rehash
+ * * jsl_str_to_str_multimap_finish_rehash
+ * * jsl_str_to_str_multimap_reserve
+ * * jsl_str_to_str_multimap_shrink_to_fit
+ * * jsl_str_to_str_multimap_memory_footprint
  */
 typedef struct JSL__StrToStrMultimap JSLStrToStrMultimap;
 
@@ -358,6 +383,41 @@ JSL_STR_TO_STR_MULTIMAP_DEF int64_t jsl_str_to_str_multimap_get_value_count_for_
     JSLImmutableMemory key
 );
 
+/**
+ * Get every value of a key at once.
+ *
+ * The values are stored contiguously, so this is a single lookup with no
+ * copying, which is much cheaper than the values iterator for keys with
+ * many values. Values are in insertion order. The returned array is owned
+ * by the map and is only valid until the map is next mutated.
+ *
+ * Example:
+ *
+ * ```
+ * const JSLImmutableMemory* values;
+ * int64_t value_count;
+ * if (jsl_str_to_str_multimap_get_values_span(&map, key, &values, &value_count))
+ * {
+ *     for (int64_t i = 0; i < value_count; ++i)
+ *     {
+ *         ...
+ *     }
+ * }
+ * ```
+ *
+ * @param map Pointer to the multimap.
+ * @param key Key to look up.
+ * @param out_values Output for the first value, set to `NULL` if the key is missing.
+ * @param out_value_count Output for the number of values, set to zero if the key is missing.
+ * @return `true` if the key was found, `false` if not or on invalid parameters.
+ */
+JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_get_values_span(
+    JSLStrToStrMultimap* map,
+    JSLImmutableMemory key,
+    const JSLImmutableMemory** out_values,
+    int64_t* out_value_count
+);
+
 /**
  * Initialize an iterator that visits every key/value pair in the multimap.
  * 
@@ -478,9 +538,9 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_get_values_for_key_iter
  *
  * Returns the next value for the key supplied to
  * `jsl_str_to_str_multimap_get_values_for_key_iterator_init`. The iterator
- * must be initialized and becomes invalid if the map is mutated; iteration
- * order is undefined. When the values are exhausted or the iterator is
- * invalid, the function returns `false`.
+ * must be initialized and becomes invalid if the map is mutated; values
+ * are returned in insertion order. When the values are exhausted or the
+ * iterator is invalid, the function returns `false`.
  *
  * @param iterator Iterator to advance; must be initialized.
  * @param out_value Output for the current value.
@@ -509,10 +569,10 @@ JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_delete_key(
 /**
  * Remove a single value for the given key.
  *
- * If the value is found, it is removed from the key's list and recycled
- * into the value free list. When the last value is removed, the key entry
- * itself is recycled. No action is taken if the key or value is missing
- * or parameters are invalid.
+ * If the value is found, the first matching value is removed from the key's
+ * value array and the later values are moved down to keep insertion order.
+ * When the last value is removed, the key entry itself is recycled. No action
+ * is taken if the key or value is missing or parameters are invalid.
  *
  * @param map Multimap to mutate.
  * @param key Key whose value should be removed.
@@ -534,6 +594,80 @@ JSL_STR_TO_STR_MULTIMAP_DEF void jsl_str_to_str_multimap_clear(
     JSLStrToStrMultimap* map
 );
 
+/**
+ * Spread future rehashes out over many operations instead of doing them all
+ * at once. Each insert or delete moves `slots_per_operation` slots of the
+ * old table into the new one until the old table is drained. Lookups check
+ * both tables while a rehash is in progress but never move entries.
+ *
+ * @param map Multimap to configure.
+ * @param slots_per_operation Old table slots to move per operation, or
+ * zero to turn incremental rehashing off, which finishes any rehash in progress.
+ * @return `true` on success, `false` on invalid parameters.
+ */
+JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_enable_incremental_rehash(
+    JSLStrToStrMultimap* map,
+    int64_t slots_per_operation
+);
+
+/**
+ * Move every remaining key of an in progress incremental rehash into the
+ * current table and free the old table. Does nothing if no rehash is in
+ * progress. Iterators become invalid.
+ *
+ * @param map Multimap to finish rehashing.
+ * @return `true` on success, `false` on invalid parameters.
+ */
+JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_finish_rehash(
+    JSLStrToStrMultimap* map
+);
+
+/**
+ * Grow the lookup table once so that `key_count` keys fit without any
+ * rehash along the way. Does nothing if the table is already big enough.
+ * Any incremental rehash in progress is finished first. Iterators become
+ * invalid.
+ *
+ * @param map Map to grow.
+ * @param key_count Number of distinct keys the map should hold.
+ * @return `true` on success, `false` on invalid parameters or out of memory.
+ */
+JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_reserve(
+    JSLStrToStrMultimap* map,
+    int64_t key_count
+);
+
+/**
+ * Give memory which isn't needed for the current keys and values back to
+ * the allocator. The entries recycled by deletes are freed, along with the
+ * value storage they kept for reuse, and the keys are moved into the
+ * smallest lookup table that holds them at the load factor, never smaller
+ * than 32 slots. Any incremental rehash in progress is finished first.
+ * Iterators become invalid.
+ *
+ * @param map Map to compact.
+ * @return `true` on success, `false` on invalid parameters or out of memory.
+ */
+JSL_STR_TO_STR_MULTIMAP_DEF bool jsl_str_to_str_multimap_shrink_to_fit(
+    JSLStrToStrMultimap* map
+);
+
+/**
+ * Get the number of bytes this map holds from its allocator. This is the
+ * lookup tables, every entry including the ones recycled by deletes, each
+ * key's value array and packed value storage, and the copies of keys and
+ * values which didn't fit in the small string storage. Allocator
+ * bookkeeping and alignment padding aren't counted.
+ *
+ * This walks every entry, so avoid calling it after every insert.
+ *
+ * @param map Map to measure.
+ * @return The size in bytes, or -1 on invalid parameters.
+ */
+JSL_STR_TO_STR_MULTIMAP_DEF int64_t jsl_str_to_str_multimap_memory_footprint(
+    JSLStrToStrMultimap* map
+);
+
 #ifdef __cplusplus
 }
 #endif
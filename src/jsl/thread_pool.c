@@ -0,0 +1,771 @@
+/**
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L
+    #include <stdbool.h>
+#endif
+
+#include "core.h"
+#include "allocator.h"
+#include "allocator_arena.h"
+#include "atomic_common.h"
+#include "os.h"
+#include "thread_pool.h"
+
+#if defined(JSL_THREAD_POOL_USE_C11_THREADS)
+    #include <threads.h>
+#elif JSL_IS_WINDOWS
+    #include <windows.h>
+#elif JSL_IS_POSIX
+    #include <pthread.h>
+    #include <sched.h>
+#else
+    #error "thread_pool.c: Only windows and posix systems are supported without JSL_THREAD_POOL_USE_C11_THREADS"
+#endif
+
+#define JSL__THREAD_POOL_PRIVATE_SENTINEL 3853189502617384213U
+
+// Ranges each worker can have waiting at once. Halving splits push one range
+// per level, so this only runs out with very deep nesting.
+#define JSL__THREAD_POOL_DEQUE_CAPACITY 256
+#define JSL__THREAD_POOL_DEQUE_MASK (JSL__THREAD_POOL_DEQUE_CAPACITY - 1)
+
+// Failed attempts to find work before an idle worker yields its time slice,
+// and then before it goes to sleep
+#define JSL__THREAD_POOL_SPIN_ROUNDS 64
+#define JSL__THREAD_POOL_YIELD_ROUNDS 96
+
+#if defined(JSL_THREAD_POOL_USE_C11_THREADS)
+    typedef thrd_t JSL__ThreadPoolThread;
+#elif JSL_IS_WINDOWS
+    typedef HANDLE JSL__ThreadPoolThread;
+#else
+    typedef pthread_t JSL__ThreadPoolThread;
+#endif
+
+struct JSL__ThreadPoolSleep
+{
+    #if defined(JSL_THREAD_POOL_USE_C11_THREADS)
+        mtx_t mutex;
+        cnd_t condition;
+    #elif JSL_IS_WINDOWS
+        CRITICAL_SECTION mutex;
+        CONDITION_VARIABLE condition;
+    #else
+        pthread_mutex_t mutex;
+        pthread_cond_t condition;
+    #endif
+};
+
+/**
+ * One parallel for loop. Lives on the stack of the thread that started it,
+ * which doesn't return until `remaining` is zero.
+ */
+typedef struct JSL__ThreadPoolJob
+{
+    JSLThreadPoolRangeFunction function;
+    void* user_data;
+    uint64_t grain;
+    /// @brief number of indices whose range function hasn't returned yet
+    uint64_t remaining;
+} JSL__ThreadPoolJob;
+
+/**
+ * A deque slot. Thieves can read a slot while the owner overwrites it, in
+ * which case their compare and swap on top fails and the read is thrown
+ * away, so every field is only accessed atomically.
+ */
+typedef struct JSL__ThreadPoolSlot
+{
+    void* job;
+    uint64_t begin;
+    uint64_t end;
+} JSL__ThreadPoolSlot;
+
+typedef struct JSL__ThreadPoolRange
+{
+    JSL__ThreadPoolJob* job;
+    int64_t begin;
+    int64_t end;
+} JSL__ThreadPoolRange;
+
+struct JSL__ThreadPoolWorker
+{
+    /// @brief oldest range, advanced by thieves and by the owner taking the last range
+    uint64_t top;
+    uint8_t padding_top[JSL__CACHE_LINE_SIZE - sizeof(uint64_t)];
+
+    /// @brief one past the newest range, only written by the owner
+    uint64_t bottom;
+    uint8_t padding_bottom[JSL__CACHE_LINE_SIZE - sizeof(uint64_t)];
+
+    JSL__ThreadPoolSlot slots[JSL__THREAD_POOL_DEQUE_CAPACITY];
+
+    JSLThreadPool* pool;
+    int32_t index;
+    uint64_t random_state;
+    JSLArena scratch;
+    JSL__ThreadPoolThread thread;
+
+    // Keeps the owner's writes to the fields above off the next worker's top
+    uint8_t padding_end[JSL__CACHE_LINE_SIZE];
+};
+
+static void jsl__thread_pool_yield(void)
+{
+    #if defined(JSL_THREAD_POOL_USE_C11_THREADS)
+        thrd_yield();
+    #elif JSL_IS_WINDOWS
+        SwitchToThread();
+    #else
+        sched_yield();
+    #endif
+}
+
+static void jsl__thread_pool_lock(struct JSL__ThreadPoolSleep* sleep)
+{
+    #if defined(JSL_THREAD_POOL_USE_C11_THREADS)
+        mtx_lock(&sleep->mutex);
+    #elif JSL_IS_WINDOWS
+        EnterCriticalSection(&sleep->mutex);
+    #else
+        pthread_mutex_lock(&sleep->mutex);
+    #endif
+}
+
+static void jsl__thread_pool_unlock(struct JSL__ThreadPoolSleep* sleep)
+{
+    #if defined(JSL_THREAD_POOL_USE_C11_THREADS)
+        mtx_unlock(&sleep->mutex);
+    #elif JSL_IS_WINDOWS
+        LeaveCriticalSection(&sleep->mutex);
+    #else
+        pthread_mutex_unlock(&sleep->mutex);
+    #endif
+}
+
+// Must be called with the mutex held
+static void jsl__thread_pool_wait(struct JSL__ThreadPoolSleep* sleep)
+{
+    #if defined(JSL_THREAD_POOL_USE_C11_THREADS)
+        cnd_wait(&sleep->condition, &sleep->mutex);
+    #elif JSL_IS_WINDOWS
+        SleepConditionVariableCS(&sleep->condition, &sleep->mutex, INFINITE);
+    #else
+        pthread_cond_wait(&sleep->condition, &sleep->mutex);
+    #endif
+}
+
+static void jsl__thread_pool_wake_all(struct JSL__ThreadPoolSleep* sleep)
+{
+    jsl__thread_pool_lock(sleep);
+
+    #if defined(JSL_THREAD_POOL_USE_C11_THREADS)
+        cnd_broadcast(&sleep->condition);
+    #elif JSL_IS_WINDOWS
+        WakeAllConditionVariable(&sleep->condition);
+    #else
+        pthread_cond_broadcast(&sleep->condition);
+    #endif
+
+    jsl__thread_pool_unlock(sleep);
+}
+
+static bool jsl__thread_pool_sleep_init(struct JSL__ThreadPoolSleep* sleep)
+{
+    #if defined(JSL_THREAD_POOL_USE_C11_THREADS)
+        if (mtx_init(&sleep->mutex, mtx_plain) != thrd_success)
+            return false;
+        if (cnd_init(&sleep->condition) != thrd_success)
+        {
+            mtx_destroy(&sleep->mutex);
+            return false;
+        }
+        return true;
+    #elif JSL_IS_WINDOWS
+        InitializeCriticalSection(&sleep->mutex);
+        InitializeConditionVariable(&sleep->condition);
+        return true;
+    #else
+        if (pthread_mutex_init(&sleep->mutex, NULL) != 0)
+            return false;
+        if (pthread_cond_init(&sleep->condition, NULL) != 0)
+        {
+            pthread_mutex_destroy(&sleep->mutex);
+            return false;
+        }
+        return true;
+    #endif
+}
+
+static void jsl__thread_pool_sleep_destroy(struct JSL__ThreadPoolSleep* sleep)
+{
+    #if defined(JSL_THREAD_POOL_USE_C11_THREADS)
+        cnd_destroy(&sleep->condition);
+        mtx_destroy(&sleep->mutex);
+    #elif JSL_IS_WINDOWS
+        DeleteCriticalSection(&sleep->mutex);
+    #else
+        pthread_cond_destroy(&sleep->condition);
+        pthread_mutex_destroy(&sleep->mutex);
+    #endif
+}
+
+static bool jsl__thread_pool_has_work(JSLThreadPool* pool)
+{
+    for (int32_t i = 0; i < pool->worker_count; ++i)
+    {
+        JSLThreadPoolWorker* worker = &pool->workers[i];
+        int64_t top = (int64_t) jsl__atomic_load_u64(&worker->top);
+        int64_t bottom = (int64_t) jsl__atomic_load_u64(&worker->bottom);
+        if (top < bottom)
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Push a range onto the bottom of the worker's own deque. Only the thread
+ * running as `worker` may call this.
+ */
+static bool jsl__thread_pool_push(
+    JSLThreadPoolWorker* worker,
+    JSL__ThreadPoolJob* job,
+    int64_t begin,
+    int64_t end
+)
+{
+    int64_t bottom = (int64_t) worker->bottom;
+    int64_t top = (int64_t) jsl__atomic_load_u64(&worker->top);
+
+    if (bottom - top >= JSL__THREAD_POOL_DEQUE_CAPACITY)
+        return false;
+
+    JSL__ThreadPoolSlot* slot = &worker->slots[bottom & JSL__THREAD_POOL_DEQUE_MASK];
+    jsl__atomic_store_ptr(&slot->job, job);
+    jsl__atomic_store_u64(&slot->begin, (uint64_t) begin);
+    jsl__atomic_store_u64(&slot->end, (uint64_t) end);
+    jsl__atomic_store_u64(&worker->bottom, (uint64_t) (bottom + 1));
+
+    // Pairs with the fence in jsl__thread_pool_sleep, either this sees the
+    // sleeper or the sleeper sees the new bottom
+    jsl__atomic_thread_fence();
+    JSLThreadPool* pool = worker->pool;
+    if (jsl__atomic_load_u64(&pool->sleeper_count) > 0)
+        jsl__thread_pool_wake_all(pool->sleep);
+
+    return true;
+}
+
+static void jsl__thread_pool_read_slot(
+    JSLThreadPoolWorker* worker,
+    int64_t position,
+    JSL__ThreadPoolRange* out_range
+)
+{
+    JSL__ThreadPoolSlot* slot = &worker->slots[position & JSL__THREAD_POOL_DEQUE_MASK];
+    out_range->job = (JSL__ThreadPoolJob*) jsl__atomic_load_ptr(&slot->job);
+    out_range->begin = (int64_t) jsl__atomic_load_u64(&slot->begin);
+    out_range->end = (int64_t) jsl__atomic_load_u64(&slot->end);
+}
+
+/**
+ * Pop the newest range from the bottom of the worker's own deque. Only the
+ * thread running as `worker` may call this.
+ */
+static bool jsl__thread_pool_pop(JSLThreadPoolWorker* worker, JSL__ThreadPoolRange* out_range)
+{
+    int64_t bottom = (int64_t) worker->bottom - 1;
+    jsl__atomic_store_u64(&worker->bottom, (uint64_t) bottom);
+    jsl__atomic_thread_fence();
+    int64_t top = (int64_t) jsl__atomic_load_u64(&worker->top);
+
+    if (top > bottom)
+    {
+        jsl__atomic_store_u64(&worker->bottom, (uint64_t) (bottom + 1));
+        return false;
+    }
+
+    jsl__thread_pool_read_slot(worker, bottom, out_range);
+    if (top < bottom)
+        return true;
+
+    // Last range, race the thieves for it
+    bool won = jsl__atomic_compare_exchange_u64(
+        &worker->top,
+        (uint64_t) top,
+        (uint64_t) (top + 1)
+    );
+    jsl__atomic_store_u64(&worker->bottom, (uint64_t) (bottom + 1));
+    return won;
+}
+
+// Take the oldest range from the top of someone else's deque
+static bool jsl__thread_pool_steal(JSLThreadPoolWorker* victim, JSL__ThreadPoolRange* out_range)
+{
+    int64_t top = (int64_t) jsl__atomic_load_u64(&victim->top);
+    jsl__atomic_thread_fence();
+    int64_t bottom = (int64_t) jsl__atomic_load_u64(&victim->bottom);
+
+    if (top >= bottom)
+        return false;
+
+    jsl__thread_pool_read_slot(victim, top, out_range);
+    return jsl__atomic_compare_exchange_u64(
+        &victim->top,
+        (uint64_t) top,
+        (uint64_t) (top + 1)
+    );
+}
+
+static void jsl__thread_pool_call(
+    JSLThreadPoolWorker* worker,
+    JSL__ThreadPoolJob* job,
+    int64_t begin,
+    int64_t end
+)
+{
+    if (worker->scratch.start != NULL)
+    {
+        uint8_t* restore_point = jsl_arena_save_restore_point(&worker->scratch);
+        job->function(worker, begin, end, job->user_data);
+        jsl_arena_load_restore_point(&worker->scratch, restore_point);
+    }
+    else
+    {
+        job->function(worker, begin, end, job->user_data);
+    }
+}
+
+/**
+ * Run a range, first pushing its upper halves for other workers to steal
+ * until what's left fits in one grain.
+ */
+static void jsl__thread_pool_run_range(
+    JSLThreadPoolWorker* worker,
+    JSL__ThreadPoolJob* job,
+    int64_t begin,
+    int64_t end
+)
+{
+    uint64_t length = (uint64_t) end - (uint64_t) begin;
+
+    while (length > job->grain)
+    {
+        int64_t middle = begin + (int64_t) (length / 2);
+        if (!jsl__thread_pool_push(worker, job, middle, end))
+            break;
+
+        end = middle;
+        length = (uint64_t) end - (uint64_t) begin;
+    }
+
+    // Only more than a grain when the deque was full
+    int64_t part_begin = begin;
+    while (part_begin < end)
+    {
+        uint64_t part_length = JSL_MIN((uint64_t) end - (uint64_t) part_begin, job->grain);
+        int64_t part_end = part_begin + (int64_t) part_length;
+        jsl__thread_pool_call(worker, job, part_begin, part_end);
+        part_begin = part_end;
+    }
+
+    jsl__atomic_fetch_add_u64(&job->remaining, 0 - length);
+}
+
+static uint64_t jsl__thread_pool_random(JSLThreadPoolWorker* worker)
+{
+    uint64_t x = worker->random_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    worker->random_state = x;
+    return x;
+}
+
+// Run one range from the worker's own deque, or failing that, a stolen one
+static bool jsl__thread_pool_run_one(JSLThreadPoolWorker* worker)
+{
+    JSL__ThreadPoolRange range;
+    bool found = jsl__thread_pool_pop(worker, &range);
+
+    JSLThreadPool* pool = worker->pool;
+    int32_t worker_count = pool->worker_count;
+
+    if (!found && worker_count > 1)
+    {
+        // Start at a random victim so thieves spread out
+        int32_t first = (int32_t) (jsl__thread_pool_random(worker) % (uint64_t) worker_count);
+        for (int32_t i = 0; i < worker_count && !found; ++i)
+        {
+            int32_t victim = (first + i) % worker_count;
+            if (victim != worker->index)
+                found = jsl__thread_pool_steal(&pool->workers[victim], &range);
+        }
+    }
+
+    if (found)
+        jsl__thread_pool_run_range(worker, range.job, range.begin, range.end);
+
+    return found;
+}
+
+static void jsl__thread_pool_sleep(JSLThreadPoolWorker* worker)
+{
+    JSLThreadPool* pool = worker->pool;
+
+    jsl__thread_pool_lock(pool->sleep);
+    jsl__atomic_fetch_add_u64(&pool->sleeper_count, 1);
+
+    // Pairs with the fence in jsl__thread_pool_push
+    jsl__atomic_thread_fence();
+    if (
+        jsl__atomic_load_u64(&pool->shutdown) == 0
+        && !jsl__thread_pool_has_work(pool)
+    )
+        jsl__thread_pool_wait(pool->sleep);
+
+    jsl__atomic_fetch_add_u64(&pool->sleeper_count, (uint64_t) -1);
+    jsl__thread_pool_unlock(pool->sleep);
+}
+
+static void jsl__thread_pool_worker_main(JSLThreadPoolWorker* worker)
+{
+    JSLThreadPool* pool = worker->pool;
+    int32_t idle_rounds = 0;
+
+    while (jsl__atomic_load_u64(&pool->shutdown) == 0)
+    {
+        if (jsl__thread_pool_run_one(worker))
+        {
+            idle_rounds = 0;
+        }
+        else if (++idle_rounds < JSL__THREAD_POOL_SPIN_ROUNDS)
+        {
+            jsl__cpu_relax();
+        }
+        else if (idle_rounds < JSL__THREAD_POOL_YIELD_ROUNDS)
+        {
+            jsl__thread_pool_yield();
+        }
+        else
+        {
+            jsl__thread_pool_sleep(worker);
+            idle_rounds = 0;
+        }
+    }
+}
+
+#if defined(JSL_THREAD_POOL_USE_C11_THREADS)
+    static int jsl__thread_pool_entry(void* arg)
+    {
+        jsl__thread_pool_worker_main((JSLThreadPoolWorker*) arg);
+        return 0;
+    }
+#elif JSL_IS_WINDOWS
+    static DWORD WINAPI jsl__thread_pool_entry(LPVOID arg)
+    {
+        jsl__thread_pool_worker_main((JSLThreadPoolWorker*) arg);
+        return 0;
+    }
+#else
+    static void* jsl__thread_pool_entry(void* arg)
+    {
+        jsl__thread_pool_worker_main((JSLThreadPoolWorker*) arg);
+        return NULL;
+    }
+#endif
+
+static bool jsl__thread_pool_start_thread(JSLThreadPoolWorker* worker)
+{
+    #if defined(JSL_THREAD_POOL_USE_C11_THREADS)
+        return thrd_create(&worker->thread, jsl__thread_pool_entry, worker) == thrd_success;
+    #elif JSL_IS_WINDOWS
+        worker->thread = CreateThread(NULL, 0, jsl__thread_pool_entry, worker, 0, NULL);
+        return worker->thread != NULL;
+    #else
+        return pthread_create(&worker->thread, NULL, jsl__thread_pool_entry, worker) == 0;
+    #endif
+}
+
+static void jsl__thread_pool_join_thread(JSLThreadPoolWorker* worker)
+{
+    #if defined(JSL_THREAD_POOL_USE_C11_THREADS)
+        thrd_join(worker->thread, NULL);
+    #elif JSL_IS_WINDOWS
+        WaitForSingleObject(worker->thread, INFINITE);
+        CloseHandle(worker->thread);
+    #else
+        pthread_join(worker->thread, NULL);
+    #endif
+}
+
+// Stop and join the first `started_count` workers' threads and free everything
+static void jsl__thread_pool_destroy(JSLThreadPool* pool, int32_t started_count)
+{
+    if (pool->sleep != NULL)
+    {
+        jsl__atomic_store_u64(&pool->shutdown, 1);
+        jsl__atomic_thread_fence();
+        jsl__thread_pool_wake_all(pool->sleep);
+    }
+
+    // Worker zero is the thread that called init and has no thread of its own
+    for (int32_t i = 1; i < started_count; ++i)
+    {
+        jsl__thread_pool_join_thread(&pool->workers[i]);
+    }
+
+    if (pool->sleep != NULL)
+    {
+        jsl__thread_pool_sleep_destroy(pool->sleep);
+        jsl_allocator_interface_free(pool->allocator, pool->sleep);
+        pool->sleep = NULL;
+    }
+
+    if (pool->workers != NULL)
+    {
+        for (int32_t i = 0; i < pool->worker_count; ++i)
+        {
+            if (pool->workers[i].scratch.start != NULL)
+                jsl_allocator_interface_free(pool->allocator, pool->workers[i].scratch.start);
+        }
+
+        jsl_allocator_interface_free(pool->allocator, pool->workers);
+        pool->workers = NULL;
+    }
+
+    pool->worker_count = 0;
+    pool->sentinel = 0;
+}
+
+JSL_THREAD_POOL_DEF bool jsl_thread_pool_init(
+    JSLThreadPool* pool,
+    JSLAllocatorInterface allocator,
+    int32_t worker_count,
+    int64_t scratch_bytes_per_worker
+)
+{
+    if (pool == NULL || scratch_bytes_per_worker < 0)
+        return false;
+
+    JSL_MEMSET(pool, 0, sizeof(JSLThreadPool));
+    pool->allocator = allocator;
+
+    if (worker_count < 1)
+    {
+        int32_t processor_errno = 0;
+        worker_count = JSL_MAX(jsl_get_logical_processor_count(&processor_errno), 1);
+    }
+
+    pool->workers = (JSLThreadPoolWorker*) jsl_allocator_interface_alloc(
+        allocator,
+        (int64_t) sizeof(JSLThreadPoolWorker) * worker_count,
+        JSL__CACHE_LINE_SIZE,
+        true
+    );
+    bool res = pool->workers != NULL;
+
+    if (res)
+    {
+        pool->worker_count = worker_count;
+
+        for (int32_t i = 0; i < worker_count && res; ++i)
+        {
+            JSLThreadPoolWorker* worker = &pool->workers[i];
+            worker->pool = pool;
+            worker->index = i;
+            worker->random_state = 0x9E3779B97F4A7C15U * (uint64_t) (i + 1);
+
+            if (scratch_bytes_per_worker > 0)
+            {
+                void* memory = jsl_allocator_interface_alloc(
+                    allocator,
+                    scratch_bytes_per_worker,
+                    JSL_DEFAULT_ALLOCATION_ALIGNMENT,
+                    false
+                );
+                res = memory != NULL;
+
+                if (res)
+                    jsl_arena_init(&worker->scratch, memory, scratch_bytes_per_worker);
+            }
+        }
+    }
+
+    if (res)
+    {
+        pool->sleep = JSL_TYPED_ALLOCATE(struct JSL__ThreadPoolSleep, allocator);
+        res = pool->sleep != NULL;
+
+        if (res && !jsl__thread_pool_sleep_init(pool->sleep))
+        {
+            jsl_allocator_interface_free(allocator, pool->sleep);
+            pool->sleep = NULL;
+            res = false;
+        }
+    }
+
+    int32_t started_count = 1;
+    while (res && started_count < pool->worker_count)
+    {
+        res = jsl__thread_pool_start_thread(&pool->workers[started_count]);
+        if (res)
+            ++started_count;
+    }
+
+    if (res)
+        pool->sentinel = JSL__THREAD_POOL_PRIVATE_SENTINEL;
+    else
+        jsl__thread_pool_destroy(pool, started_count);
+
+    return res;
+}
+
+static bool jsl__thread_pool_run_job(
+    JSLThreadPoolWorker* worker,
+    int64_t begin,
+    int64_t end,
+    int64_t grain,
+    JSLThreadPoolRangeFunction function,
+    void* user_data
+)
+{
+    bool res = (
+        function != NULL
+        && grain > 0
+        && begin <= end
+    );
+
+    if (res && begin < end)
+    {
+        JSL__ThreadPoolJob job = {
+            .function = function,
+            .user_data = user_data,
+            .grain = (uint64_t) grain,
+            .remaining = (uint64_t) end - (uint64_t) begin
+        };
+
+        jsl__thread_pool_run_range(worker, &job, begin, end);
+
+        // Help with whatever is left, ours or not, until every part of this
+        // loop has returned
+        int32_t idle_rounds = 0;
+        while (jsl__atomic_load_u64(&job.remaining) != 0)
+        {
+            if (jsl__thread_pool_run_one(worker))
+            {
+                idle_rounds = 0;
+            }
+            else if (++idle_rounds < JSL__THREAD_POOL_SPIN_ROUNDS)
+            {
+                jsl__cpu_relax();
+            }
+            else
+            {
+                jsl__thread_pool_yield();
+            }
+        }
+    }
+
+    return res;
+}
+
+JSL_THREAD_POOL_DEF bool jsl_thread_pool_parallel_for(
+    JSLThreadPool* pool,
+    int64_t begin,
+    int64_t end,
+    int64_t grain,
+    JSLThreadPoolRangeFunction function,
+    void* user_data
+)
+{
+    if (pool == NULL || pool->sentinel != JSL__THREAD_POOL_PRIVATE_SENTINEL)
+        return false;
+
+    return jsl__thread_pool_run_job(&pool->workers[0], begin, end, grain, function, user_data);
+}
+
+JSL_THREAD_POOL_DEF bool jsl_thread_pool_worker_parallel_for(
+    JSLThreadPoolWorker* worker,
+    int64_t begin,
+    int64_t end,
+    int64_t grain,
+    JSLThreadPoolRangeFunction function,
+    void* user_data
+)
+{
+    if (
+        worker == NULL
+        || worker->pool == NULL
+        || worker->pool->sentinel != JSL__THREAD_POOL_PRIVATE_SENTINEL
+    )
+        return false;
+
+    return jsl__thread_pool_run_job(worker, begin, end, grain, function, user_data);
+}
+
+JSL_THREAD_POOL_DEF int32_t jsl_thread_pool_worker_index(JSLThreadPoolWorker* worker)
+{
+    if (
+        worker == NULL
+        || worker->pool == NULL
+        || worker->pool->sentinel != JSL__THREAD_POOL_PRIVATE_SENTINEL
+    )
+        return -1;
+
+    return worker->index;
+}
+
+JSL_THREAD_POOL_DEF bool jsl_thread_pool_worker_scratch(
+    JSLThreadPoolWorker* worker,
+    JSLAllocatorInterface* out_allocator
+)
+{
+    bool res = (
+        worker != NULL
+        && out_allocator != NULL
+        && worker->pool != NULL
+        && worker->pool->sentinel == JSL__THREAD_POOL_PRIVATE_SENTINEL
+    );
+
+    if (res)
+        jsl_arena_get_allocator_interface(out_allocator, &worker->scratch);
+
+    return res;
+}
+
+JSL_THREAD_POOL_DEF int32_t jsl_thread_pool_worker_count(JSLThreadPool* pool)
+{
+    if (pool == NULL || pool->sentinel != JSL__THREAD_POOL_PRIVATE_SENTINEL)
+        return -1;
+
+    return pool->worker_count;
+}
+
+JSL_THREAD_POOL_DEF void jsl_thread_pool_free(JSLThreadPool* pool)
+{
+    if (pool != NULL && pool->sentinel == JSL__THREAD_POOL_PRIVATE_SENTINEL)
+        jsl__thread_pool_destroy(pool, pool->worker_count);
+}
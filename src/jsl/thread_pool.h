@@ -0,0 +1,269 @@
+/**
+ * # JSL Thread Pool
+ *
+ * This file implements a work stealing thread pool and a parallel for loop
+ * over index ranges. This file is part of the Jack's Standard Library
+ * project.
+ *
+ * ## Documentation
+ *
+ * See `docs/jsl_thread_pool.md` for a formatted documentation page.
+ *
+ * ## Design
+ *
+ * The pool starts one thread less than the requested worker count. The
+ * thread that created the pool is worker zero, and it does its share of the
+ * work while it waits in `jsl_thread_pool_parallel_for`. By default the
+ * worker count is `jsl_get_logical_processor_count`.
+ *
+ * Every worker owns a fixed size Chase-Lev deque of index ranges. A worker
+ * that runs a range bigger than the grain size splits it in half, pushes the
+ * upper half onto the bottom of its own deque, and keeps going with the
+ * lower half until the range fits the grain. It then pops its own deque from
+ * the bottom, which keeps recently touched data in cache. Workers with
+ * nothing to do steal from the top of another worker's deque, which is
+ * always the biggest range that's left, so a single steal moves a lot of
+ * work and the threads rarely touch the same cache lines. The owner's push
+ * and pop don't use any locks or compare and swaps except when the deque is
+ * down to its last range.
+ *
+ * Workers that find nothing to steal spin briefly, then sleep on a condition
+ * variable until more ranges are pushed. Waking is skipped entirely when no
+ * worker is asleep.
+ *
+ * Each worker has its own arena of scratch memory. Anything allocated from
+ * `jsl_thread_pool_worker_scratch` is released when the range function that
+ * allocated it returns, so short lived buffers don't need a thread safe
+ * allocator or any cleanup.
+ *
+ * A range function can start a nested parallel for with
+ * `jsl_thread_pool_worker_parallel_for`. While waiting for the nested loop,
+ * the worker runs other ranges instead of blocking.
+ *
+ * The threads come from C11 `threads.h` when `JSL_THREAD_POOL_USE_C11_THREADS`
+ * is defined, and from Win32 or pthreads otherwise, since many C libraries
+ * still don't ship `threads.h`.
+ *
+ * ## Caveats
+ *
+ * * `jsl_thread_pool_parallel_for` must only be called from the thread that
+ *   called `jsl_thread_pool_init`, and only one loop can run from that
+ *   thread at a time. Use the worker version from inside range functions.
+ * * A range that is pushed while its worker's deque is full is not split any
+ *   further, so very deep nesting loses parallelism but stays correct.
+ * * Range functions must not block waiting on other range functions, except
+ *   through a nested parallel for.
+ * * On platforms with neither pthreads nor Win32 the pool needs the C11
+ *   threads option.
+ *
+ * ## License
+ *
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L
+    #include <stdbool.h>
+#endif
+
+#include "core.h"
+#include "allocator.h"
+
+/* Versioning to catch mismatches across deps */
+#ifndef JSL_THREAD_POOL_VERSION
+    #define JSL_THREAD_POOL_VERSION 0x010000  /* 1.0.0 */
+#else
+    #if JSL_THREAD_POOL_VERSION != 0x010000
+        #error "thread_pool.h version mismatch across includes"
+    #endif
+#endif
+
+#ifndef JSL_THREAD_POOL_DEF
+    #define JSL_THREAD_POOL_DEF
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The state of one worker thread. Range functions get a pointer to the
+ * worker that's running them.
+ *
+ * This struct is private.
+ */
+typedef struct JSL__ThreadPoolWorker JSLThreadPoolWorker;
+
+/**
+ * Function run by `jsl_thread_pool_parallel_for` on each part of the range.
+ *
+ * @param worker The worker running this part, valid until the function returns
+ * @param begin First index of the part
+ * @param end One past the last index of the part
+ * @param user_data The pointer given to the parallel for
+ */
+typedef void (*JSLThreadPoolRangeFunction)(
+    JSLThreadPoolWorker* worker,
+    int64_t begin,
+    int64_t end,
+    void* user_data
+);
+
+/**
+ * A set of worker threads. See `jsl_thread_pool_init`.
+ *
+ * All fields are private.
+ */
+typedef struct JSLThreadPool
+{
+    uint64_t sentinel;
+    JSLAllocatorInterface allocator;
+
+    /// @brief worker_count workers, index zero is the thread that called init
+    JSLThreadPoolWorker* workers;
+    int32_t worker_count;
+
+    /// @brief mutex and condition variable used by sleeping workers
+    struct JSL__ThreadPoolSleep* sleep;
+
+    /// @brief non zero once the pool is shutting down
+    uint64_t shutdown;
+    /// @brief number of workers waiting on the condition variable
+    uint64_t sleeper_count;
+} JSLThreadPool;
+
+/**
+ * Start the worker threads.
+ *
+ * @param pool The pool to initialize
+ * @param allocator Used for the workers and their scratch memory, only by
+ * init and free, so it doesn't need to be thread safe
+ * @param worker_count The number of workers including the calling thread,
+ * zero or less means `jsl_get_logical_processor_count`
+ * @param scratch_bytes_per_worker Size of the arena each worker gets for
+ * `jsl_thread_pool_worker_scratch`, can be zero
+ * @returns false on invalid parameters, if an allocation failed, or if a
+ * thread could not be started. The pool is left uninitialized in that case.
+ */
+JSL_THREAD_POOL_DEF bool jsl_thread_pool_init(
+    JSLThreadPool* pool,
+    JSLAllocatorInterface allocator,
+    int32_t worker_count,
+    int64_t scratch_bytes_per_worker
+);
+
+/**
+ * Run `function` over every index in `[begin, end)`, split across all of the
+ * workers in parts of at most `grain` indices, and wait until every part has
+ * returned. The calling thread runs parts as well.
+ *
+ * Only call this from the thread that called `jsl_thread_pool_init`. From
+ * inside a range function use `jsl_thread_pool_worker_parallel_for`.
+ *
+ * @param pool The pool
+ * @param begin First index
+ * @param end One past the last index
+ * @param grain The most indices given to one call of `function`. Larger
+ * grains cost less overhead, smaller grains balance uneven work better.
+ * @param function Called once per part, from any worker
+ * @param user_data Passed through to `function`
+ * @returns false on invalid parameters, in which case `function` is never
+ * called
+ */
+JSL_THREAD_POOL_DEF bool jsl_thread_pool_parallel_for(
+    JSLThreadPool* pool,
+    int64_t begin,
+    int64_t end,
+    int64_t grain,
+    JSLThreadPoolRangeFunction function,
+    void* user_data
+);
+
+/**
+ * The same as `jsl_thread_pool_parallel_for`, for use inside a range
+ * function. The worker runs other parts, from this loop or any other, until
+ * the nested loop is finished.
+ *
+ * @param worker The worker given to the calling range function
+ * @param begin First index
+ * @param end One past the last index
+ * @param grain The most indices given to one call of `function`
+ * @param function Called once per part, from any worker
+ * @param user_data Passed through to `function`
+ * @returns false on invalid parameters
+ */
+JSL_THREAD_POOL_DEF bool jsl_thread_pool_worker_parallel_for(
+    JSLThreadPoolWorker* worker,
+    int64_t begin,
+    int64_t end,
+    int64_t grain,
+    JSLThreadPoolRangeFunction function,
+    void* user_data
+);
+
+/**
+ * Get the index of a worker, from zero up to the worker count. Useful for
+ * indexing per worker accumulators without any atomics.
+ *
+ * @param worker The worker given to a range function
+ * @returns The index, or -1 on invalid parameters
+ */
+JSL_THREAD_POOL_DEF int32_t jsl_thread_pool_worker_index(JSLThreadPoolWorker* worker);
+
+/**
+ * Get an allocator for the worker's scratch arena. Everything allocated from
+ * it is released when the range function that allocated it returns. It must
+ * only be used by the thread running that function.
+ *
+ * When the pool was initialized without scratch memory every allocation
+ * from it fails.
+ *
+ * @param worker The worker given to a range function
+ * @param out_allocator Where the allocator is written
+ * @returns false on invalid parameters
+ */
+JSL_THREAD_POOL_DEF bool jsl_thread_pool_worker_scratch(
+    JSLThreadPoolWorker* worker,
+    JSLAllocatorInterface* out_allocator
+);
+
+/**
+ * Get the number of workers, including the thread that called init.
+ *
+ * @param pool The pool
+ * @returns The worker count, or -1 on invalid parameters
+ */
+JSL_THREAD_POOL_DEF int32_t jsl_thread_pool_worker_count(JSLThreadPool* pool);
+
+/**
+ * Stop and join all of the worker threads and free their memory. Must not be
+ * called while a parallel for is running. Calling this on a pool that failed
+ * to initialize, or was already freed, does nothing.
+ *
+ * @param pool The pool
+ */
+JSL_THREAD_POOL_DEF void jsl_thread_pool_free(JSLThreadPool* pool);
+
+#ifdef __cplusplus
+}
+#endif
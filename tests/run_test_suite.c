@@ -85,11 +85,13 @@ typedef struct HashMapDecl {
     bool key_is_str;
     bool value_is_str;
     char** headers;
+    char** extra_args;
 } HashMapDecl;
 
 typedef struct ArrayDecl {
     char *name, *prefix, *value_type, *impl_type;
     char** headers;
+    char** extra_args;
 } ArrayDecl;
 
 typedef struct UnitTestDecl {
@@ -349,25 +351,55 @@ static UnitTestDecl unit_test_declarations[] = {
             "tests/test_allocator_pool.c",
             "tests/test_array.c",
             "tests/test_cmd_line.c",
+            "tests/test_concurrent_str_map.c",
             "tests/test_file_utils.c",
             "tests/test_format.c",
+            "tests/test_frozen_str_map.c",
+            "tests/test_hash.c",
             "tests/test_hash_map.c",
             "tests/test_hash_set.c",
             "tests/test_intrinsics.c",
+            "tests/test_rope.c",
+            "tests/test_str_sort.c",
             "tests/test_str_to_str_multimap.c",
             "tests/test_string_builder.c",
             "tests/test_subprocess.c",
+            "tests/test_thread_pool.c",
             "src/jsl/everything.c",
             "tests/arrays/dynamic_comp1_array.c",
             "tests/arrays/dynamic_comp2_array.c",
             "tests/arrays/dynamic_comp3_array.c",
+            "tests/arrays/dynamic_double_array.c",
+            "tests/arrays/dynamic_comp1_ring.c",
             "tests/arrays/dynamic_int32_array.c",
+            "tests/arrays/fixed_int32_ring.c",
+            "tests/arrays/mpmc_comp1_queue.c",
+            "tests/arrays/segmented_comp1_array.c",
+            "tests/arrays/soa_comp2_array.c",
+            "tests/arrays/spsc_int64_queue.c",
             "tests/hash_maps/fixed_comp2_to_int_map.c",
             "tests/hash_maps/fixed_comp3_to_comp2_map.c",
             "tests/hash_maps/fixed_int32_to_comp1_map.c",
             "tests/hash_maps/fixed_int32_to_int32_map.c",
             "tests/hash_maps/fixed_int32_to_str_map.c",
             "tests/hash_maps/fixed_str_to_int32_map.c",
+            "tests/hash_maps/fixed_int64_to_int32_crc32c_map.c",
+            "tests/hash_maps/fixed_str_to_int32_aes_map.c",
+            "tests/hash_maps/fixed_int32_to_int32_robin_hood_map.c",
+            "tests/hash_maps/fixed_str_to_int32_robin_hood_map.c",
+            "tests/hash_maps/fixed_int64_to_comp1_control_map.c",
+            "tests/hash_maps/fixed_str_to_int32_control_map.c",
+            "tests/hash_maps/dynamic_int32_to_int32_map.c",
+            "tests/hash_maps/dynamic_str_to_int32_map.c",
+            "tests/hash_maps/dynamic_int32_to_str_map.c",
+            "tests/hash_maps/dynamic_comp2_to_int_map.c",
+            "tests/hash_maps/concurrent_int64_to_uint64_map.c",
+            "tests/hash_maps/concurrent_comp2_to_int_map.c",
+            "tests/hash_maps/fixed_int32_set.c",
+            "tests/hash_maps/fixed_str_set.c",
+            "tests/hash_maps/dynamic_int64_set.c",
+            "tests/hash_maps/int64_to_int32_cache.c",
+            "tests/hash_maps/comp2_to_int_cache.c",
             NULL
         }
     }
@@ -385,7 +417,8 @@ static HashMapDecl hash_map_declarations[] = {
         (char*[]) {
             "../tests/hash_maps/fixed_int32_to_int32_map.h",
             "../tests/test_hash_map_types.h", NULL
-        }
+        },
+        NULL
     },
     {
         "FixedIntToCompositeType1Map",
@@ -398,7 +431,8 @@ static HashMapDecl hash_map_declarations[] = {
         (char*[]) {
             "../tests/hash_maps/fixed_int32_to_comp1_map.h",
             "../tests/test_hash_map_types.h", NULL
-        }
+        },
+        NULL
     },
     {
         "FixedCompositeType2ToIntMap",
@@ -411,7 +445,8 @@ static HashMapDecl hash_map_declarations[] = {
         (char*[]) {
             "../tests/hash_maps/fixed_comp2_to_int_map.h",
             "../tests/test_hash_map_types.h", NULL
-        }
+        },
+        NULL
     },
     {
         "FixedCompositeType3ToCompositeType2Map",
@@ -424,7 +459,8 @@ static HashMapDecl hash_map_declarations[] = {
         (char*[]) {
             "../tests/hash_maps/fixed_comp3_to_comp2_map.h",
             "../tests/test_hash_map_types.h", NULL
-        }
+        },
+        NULL
     },
     {
         "FixedStrToIntMap",
@@ -437,7 +473,8 @@ static HashMapDecl hash_map_declarations[] = {
         (char*[]) {
             "../tests/hash_maps/fixed_str_to_int32_map.h",
             "../tests/test_hash_map_types.h", NULL
-        }
+        },
+        NULL
     },
     {
         "FixedIntToStrMap",
@@ -450,7 +487,246 @@ static HashMapDecl hash_map_declarations[] = {
         (char*[]) {
             "../tests/hash_maps/fixed_int32_to_str_map.h",
             "../tests/test_hash_map_types.h", NULL
-        }
+        },
+        NULL
+    },
+    {
+        "FixedInt64ToIntCrc32cMap",
+        "fixed_int64_to_int32_crc32c_map",
+        "int64_t",
+        "int32_t",
+        "--fixed",
+        false,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/fixed_int64_to_int32_crc32c_map.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        (char*[]) { "--hash", "crc32c", NULL }
+    },
+    {
+        "FixedStrToIntAesMap",
+        "fixed_str_to_int32_aes_map",
+        NULL,
+        "int32_t",
+        "--fixed",
+        true,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/fixed_str_to_int32_aes_map.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        (char*[]) { "--hash", "aes", NULL }
+    },
+    {
+        "FixedIntToIntRobinHoodMap",
+        "fixed_int32_to_int32_robin_hood_map",
+        "int32_t",
+        "int32_t",
+        "--fixed",
+        false,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/fixed_int32_to_int32_robin_hood_map.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        (char*[]) { "--robin-hood", NULL }
+    },
+    {
+        "FixedStrToIntRobinHoodMap",
+        "fixed_str_to_int32_robin_hood_map",
+        NULL,
+        "int32_t",
+        "--fixed",
+        true,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/fixed_str_to_int32_robin_hood_map.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        (char*[]) { "--robin-hood", NULL }
+    },
+    {
+        "FixedInt64ToCompositeType1ControlMap",
+        "fixed_int64_to_comp1_control_map",
+        "int64_t",
+        "CompositeType1",
+        "--fixed",
+        false,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/fixed_int64_to_comp1_control_map.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        (char*[]) { "--control-bytes", NULL }
+    },
+    {
+        "FixedStrToIntControlMap",
+        "fixed_str_to_int32_control_map",
+        NULL,
+        "int32_t",
+        "--fixed",
+        true,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/fixed_str_to_int32_control_map.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        (char*[]) { "--control-bytes", NULL }
+    },
+    {
+        "DynamicIntToIntMap",
+        "dynamic_int32_to_int32_map",
+        "int32_t",
+        "int32_t",
+        "--dynamic",
+        false,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/dynamic_int32_to_int32_map.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        NULL
+    },
+    {
+        "DynamicStrToIntMap",
+        "dynamic_str_to_int32_map",
+        NULL,
+        "int32_t",
+        "--dynamic",
+        true,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/dynamic_str_to_int32_map.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        NULL
+    },
+    {
+        "DynamicIntToStrMap",
+        "dynamic_int32_to_str_map",
+        "int32_t",
+        NULL,
+        "--dynamic",
+        false,
+        true,
+        (char*[]) {
+            "../tests/hash_maps/dynamic_int32_to_str_map.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        NULL
+    },
+    {
+        "DynamicCompositeType2ToIntMap",
+        "dynamic_comp2_to_int_map",
+        "CompositeType2",
+        "int32_t",
+        "--dynamic",
+        false,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/dynamic_comp2_to_int_map.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        NULL
+    },
+    {
+        "ConcurrentInt64ToUInt64Map",
+        "concurrent_int64_to_uint64_map",
+        "int64_t",
+        "uint64_t",
+        "--concurrent",
+        false,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/concurrent_int64_to_uint64_map.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        NULL
+    },
+    {
+        "ConcurrentCompositeType2ToIntMap",
+        "concurrent_comp2_to_int_map",
+        "CompositeType2",
+        "int32_t",
+        "--concurrent",
+        false,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/concurrent_comp2_to_int_map.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        NULL
+    },
+    {
+        "FixedIntSet",
+        "fixed_int32_set",
+        "int32_t",
+        NULL,
+        "--fixed",
+        false,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/fixed_int32_set.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        NULL
+    },
+    {
+        "FixedStrSet",
+        "fixed_str_set",
+        NULL,
+        NULL,
+        "--fixed",
+        true,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/fixed_str_set.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        NULL
+    },
+    {
+        "DynamicInt64Set",
+        "dynamic_int64_set",
+        "int64_t",
+        NULL,
+        "--dynamic",
+        false,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/dynamic_int64_set.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        NULL
+    },
+    {
+        "Int64ToInt32Cache",
+        "int64_to_int32_cache",
+        "int64_t",
+        "int32_t",
+        "--cache",
+        false,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/int64_to_int32_cache.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        NULL
+    },
+    {
+        "CompositeType2ToIntCache",
+        "comp2_to_int_cache",
+        "CompositeType2",
+        "int32_t",
+        "--cache",
+        false,
+        false,
+        (char*[]) {
+            "../tests/hash_maps/comp2_to_int_cache.h",
+            "../tests/test_hash_map_types.h", NULL
+        },
+        NULL
     }
 };
 
@@ -464,6 +740,10 @@ static ArrayDecl array_declarations[] = {
             "../tests/hash_maps/dynamic_int32_array.h",
             "",
             NULL
+        },
+        (char*[]) {
+            "--sort",
+            NULL
         }
     },
     {
@@ -475,6 +755,12 @@ static ArrayDecl array_declarations[] = {
             "../tests/hash_maps/dynamic_comp1_array.h",
             "../tests/test_hash_map_types.h",
             NULL
+        },
+        (char*[]) {
+            "--sort",
+            "--key-function", "comp1_sort_key",
+            "--key-type", "int32_t",
+            NULL
         }
     },
     {
@@ -486,7 +772,8 @@ static ArrayDecl array_declarations[] = {
             "../tests/hash_maps/dynamic_comp2_array.h",
             "../tests/test_hash_map_types.h",
             NULL
-        }
+        },
+        NULL
     },
     {
         "DynamicCompositeType3ToCompositeType2Map",
@@ -497,6 +784,120 @@ static ArrayDecl array_declarations[] = {
             "../tests/hash_maps/dynamic_comp3_array.h",
             "../tests/test_hash_map_types.h",
             NULL
+        },
+        (char*[]) {
+            "--sort",
+            "--less-than", "comp3_less_than",
+            NULL
+        }
+    },
+    {
+        "DynamicDoubleArray",
+        "dynamic_double_array",
+        "double",
+        "--dynamic",
+        (char*[]) {
+            "../tests/hash_maps/dynamic_double_array.h",
+            "",
+            NULL
+        },
+        (char*[]) {
+            "--sort",
+            NULL
+        }
+    },
+    {
+        "SoaComp2Array",
+        "soa_comp2_array",
+        "CompositeType2",
+        "--dynamic",
+        (char*[]) {
+            "../tests/hash_maps/soa_comp2_array.h",
+            "../tests/test_hash_map_types.h",
+            NULL
+        },
+        (char*[]) {
+            "--soa",
+            "--field", "a:int32_t",
+            "--field", "b:int32_t",
+            "--field", "c:bool",
+            NULL
+        }
+    },
+    {
+        "SegmentedComp1Array",
+        "segmented_comp1_array",
+        "CompositeType1",
+        "--dynamic",
+        (char*[]) {
+            "../tests/hash_maps/segmented_comp1_array.h",
+            "../tests/test_hash_map_types.h",
+            NULL
+        },
+        (char*[]) {
+            "--segmented",
+            "--block-length", "16",
+            NULL
+        }
+    },
+    {
+        "DynamicComp1Ring",
+        "dynamic_comp1_ring",
+        "CompositeType1",
+        "--dynamic",
+        (char*[]) {
+            "../tests/hash_maps/dynamic_comp1_ring.h",
+            "../tests/test_hash_map_types.h",
+            NULL
+        },
+        (char*[]) {
+            "--ring",
+            NULL
+        }
+    },
+    {
+        "FixedInt32Ring",
+        "fixed_int32_ring",
+        "int32_t",
+        "--fixed",
+        (char*[]) {
+            "../tests/hash_maps/fixed_int32_ring.h",
+            "",
+            NULL
+        },
+        (char*[]) {
+            "--ring",
+            NULL
+        }
+    },
+    {
+        "SpscInt64Queue",
+        "spsc_int64_queue",
+        "int64_t",
+        "--fixed",
+        (char*[]) {
+            "../tests/hash_maps/spsc_int64_queue.h",
+            "",
+            NULL
+        },
+        (char*[]) {
+            "--spsc",
+            NULL
+        }
+    },
+    {
+        "MpmcComp1Queue",
+        "mpmc_comp1_queue",
+        "CompositeType1",
+        "--fixed",
+        (char*[]) {
+            "../tests/hash_maps/mpmc_comp1_queue.h",
+            "../tests/test_hash_map_types.h",
+            NULL
+        },
+        (char*[]) {
+            "--mpmc",
+            NULL
         }
     }
 };
@@ -841,6 +1242,11 @@ int32_t main(int32_t argc, char **argv)
                 "../test_hash_map_types.h"
             );
 
+            for (int32_t arg_idx = 0; decl->extra_args != NULL && decl->extra_args[arg_idx] != NULL; ++arg_idx)
+            {
+                jsl_subprocess_arg_cstr(write_array_header, decl->extra_args[arg_idx]);
+            }
+
             JSLImmutableMemory header_out_file_name = jsl_format(
                 build_memory_interface,
                 JSL_CSTR_EXPRESSION("tests/arrays/%s.h"),
@@ -886,6 +1292,11 @@ int32_t main(int32_t argc, char **argv)
                 header_name
             );
 
+            for (int32_t arg_idx = 0; decl->extra_args != NULL && decl->extra_args[arg_idx] != NULL; ++arg_idx)
+            {
+                jsl_subprocess_arg_cstr(write_array_source, decl->extra_args[arg_idx]);
+            }
+
             JSLImmutableMemory source_out_file_name = jsl_format(
                 build_memory_interface,
                 JSL_CSTR_EXPRESSION("tests/arrays/%s.c"),
@@ -1015,7 +1426,19 @@ int32_t main(int32_t argc, char **argv)
                 generate_hash_map_run_exe_command
             );
 
-            if (decl->key_is_str)
+            if (decl->key_is_str && decl->value_type == NULL)
+            {
+                jsl_subprocess_arg_cstr(
+                    write_hash_map_header,
+                    "--name", decl->name,
+                    "--function-prefix", decl->prefix,
+                    "--key-is-string",
+                    "--set",
+                    decl->impl_type,
+                    "--header"
+                );
+            }
+            else if (decl->key_is_str)
             {
                 jsl_subprocess_arg_cstr(
                     write_hash_map_header,
@@ -1039,6 +1462,18 @@ int32_t main(int32_t argc, char **argv)
                     "--header"
                 );
             }
+            else if (decl->value_type == NULL)
+            {
+                jsl_subprocess_arg_cstr(
+                    write_hash_map_header,
+                    "--name", decl->name,
+                    "--function-prefix", decl->prefix,
+                    "--key-type", decl->key_type,
+                    "--set",
+                    decl->impl_type,
+                    "--header"
+                );
+            }
             else
             {
                 jsl_subprocess_arg_cstr(
@@ -1066,6 +1501,11 @@ int32_t main(int32_t argc, char **argv)
                 );
             }
 
+            for (int32_t arg_idx = 0; decl->extra_args != NULL && decl->extra_args[arg_idx] != NULL; ++arg_idx)
+            {
+                jsl_subprocess_arg_cstr(write_hash_map_header, decl->extra_args[arg_idx]);
+            }
+
             JSLImmutableMemory out_file_name = jsl_format(
                 build_memory_interface,
                 JSL_CSTR_EXPRESSION("tests/hash_maps/%s.h"),
@@ -1088,7 +1528,17 @@ int32_t main(int32_t argc, char **argv)
                 generate_hash_map_run_exe_command
             );
 
-            if (decl->key_is_str)
+            if (decl->key_is_str && decl->value_type == NULL)
+                jsl_subprocess_arg_cstr(
+                    write_hash_map_source,
+                    "--name", decl->name,
+                    "--function-prefix", decl->prefix,
+                    "--key-is-string",
+                    "--set",
+                    decl->impl_type,
+                    "--source"
+                );
+            else if (decl->key_is_str)
                 jsl_subprocess_arg_cstr(
                     write_hash_map_source,
                     "--name", decl->name,
@@ -1108,6 +1558,16 @@ int32_t main(int32_t argc, char **argv)
                     decl->impl_type,
                     "--source"
                 );
+            else if (decl->value_type == NULL)
+                jsl_subprocess_arg_cstr(
+                    write_hash_map_source,
+                    "--name", decl->name,
+                    "--function-prefix", decl->prefix,
+                    "--key-type", decl->key_type,
+                    "--set",
+                    decl->impl_type,
+                    "--source"
+                );
             else
                 jsl_subprocess_arg_cstr(
                     write_hash_map_source,
@@ -1133,6 +1593,11 @@ int32_t main(int32_t argc, char **argv)
                 );
             }
 
+            for (int32_t arg_idx = 0; decl->extra_args != NULL && decl->extra_args[arg_idx] != NULL; ++arg_idx)
+            {
+                jsl_subprocess_arg_cstr(write_hash_map_source, decl->extra_args[arg_idx]);
+            }
+
             out_file_name = jsl_format(
                 build_memory_interface,
                 JSL_CSTR_EXPRESSION("tests/hash_maps/%s.c"),
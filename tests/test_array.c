@@ -33,8 +33,17 @@
 #include "jsl/allocator.h"
 #include "jsl/allocator_arena.h"
 #include "jsl/allocator_infinite_arena.h"
+#include "jsl/allocator_libc.h"
 #include "jsl/str_to_str_map.h"
 
+#if JSL_IS_WINDOWS
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
 #include "minctest.h"
 #include "test_array.h"
 #include "test_hash_map_types.h"
@@ -42,6 +51,13 @@
 #include "arrays/dynamic_comp1_array.h"
 #include "arrays/dynamic_comp2_array.h"
 #include "arrays/dynamic_comp3_array.h"
+#include "arrays/dynamic_double_array.h"
+#include "arrays/soa_comp2_array.h"
+#include "arrays/segmented_comp1_array.h"
+#include "arrays/dynamic_comp1_ring.h"
+#include "arrays/fixed_int32_ring.h"
+#include "arrays/spsc_int64_queue.h"
+#include "arrays/mpmc_comp1_queue.h"
 
 extern JSLInfiniteArena global_arena;
 
@@ -708,3 +724,1090 @@ void test_dynamic_array_checks_sentinel(void)
     dynamic_int32_array_clear(&array);
     TEST_INT64_EQUAL(array.length, (int64_t) 5);
 }
+
+// A column store only round trips the fields, never the padding between them
+static bool comp2_fields_equal(const CompositeType2* lhs, const CompositeType2* rhs)
+{
+    return lhs->a == rhs->a && lhs->b == rhs->b && lhs->c == rhs->c;
+}
+
+void test_soa_array_insert_and_grow(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    SoaComp2Array array;
+    TEST_BOOL(!soa_comp2_array_init(NULL, allocator, 8));
+    TEST_BOOL(!soa_comp2_array_init(&array, allocator, -1));
+    TEST_BOOL(soa_comp2_array_init(&array, allocator, 0));
+    TEST_INT64_EQUAL(array.capacity, (int64_t) 32);
+
+    // each column starts on its own cache line inside the one block
+    TEST_BOOL(((uintptr_t) array.a % 64) == 0);
+    TEST_BOOL(((uintptr_t) array.b % 64) == 0);
+    TEST_BOOL(((uintptr_t) array.c % 64) == 0);
+    TEST_POINTERS_EQUAL((void*) array.a, (void*) array.block);
+    TEST_BOOL((uint8_t*) array.b == array.block + 128);
+    TEST_BOOL((uint8_t*) array.c == array.block + 256);
+
+    for (int32_t i = 0; i < 1000; ++i)
+    {
+        TEST_BOOL(soa_comp2_array_insert(&array, make_comp2(i, -i, (i & 1) == 1)));
+    }
+    TEST_INT64_EQUAL(array.length, (int64_t) 1000);
+    TEST_INT64_EQUAL(array.capacity, (int64_t) 1024);
+
+    // growing keeps a single allocation for every column
+    TEST_BOOL(libc_allocator.head != NULL && libc_allocator.head->prev == NULL);
+
+    int32_t* a_values = NULL;
+    int64_t a_length = 0;
+    TEST_BOOL(soa_comp2_array_a_span(&array, &a_values, &a_length));
+    TEST_INT64_EQUAL(a_length, (int64_t) 1000);
+    TEST_POINTERS_EQUAL((void*) a_values, (void*) array.a);
+
+    bool* c_values = NULL;
+    int64_t c_length = 0;
+    TEST_BOOL(soa_comp2_array_c_span(&array, &c_values, &c_length));
+    TEST_BOOL(!soa_comp2_array_c_span(&array, NULL, &c_length));
+
+    int64_t a_sum = 0;
+    int64_t c_count = 0;
+    for (int64_t i = 0; i < a_length; ++i)
+    {
+        a_sum += a_values[i];
+        c_count += c_values[i] ? 1 : 0;
+    }
+    TEST_INT64_EQUAL(a_sum, (int64_t) 499500);
+    TEST_INT64_EQUAL(c_count, (int64_t) 500);
+
+    CompositeType2 value;
+    for (int32_t i = 0; i < 1000; ++i)
+    {
+        JSL_MEMSET(&value, 0, sizeof(value));
+        TEST_BOOL(soa_comp2_array_get(&array, i, &value));
+        CompositeType2 expected = make_comp2(i, -i, (i & 1) == 1);
+        TEST_BOOL(comp2_fields_equal(&value, &expected));
+    }
+    TEST_BOOL(!soa_comp2_array_get(&array, 1000, &value));
+    TEST_BOOL(!soa_comp2_array_get(&array, -1, &value));
+
+    CompositeType2 many[100];
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        many[i] = make_comp2(1000 + i, 7, false);
+    }
+    TEST_BOOL(soa_comp2_array_insert_multiple(&array, many, 100));
+    TEST_BOOL(!soa_comp2_array_insert_multiple(&array, NULL, 1));
+    TEST_INT64_EQUAL(array.length, (int64_t) 1100);
+    TEST_BOOL(soa_comp2_array_get(&array, 1050, &value));
+    TEST_BOOL(comp2_fields_equal(&value, &many[50]));
+
+    soa_comp2_array_free(&array);
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+    TEST_BOOL(!soa_comp2_array_insert(&array, make_comp2(0, 0, false)));
+}
+
+void test_soa_array_set_delete_and_clear(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    SoaComp2Array array;
+    TEST_BOOL(soa_comp2_array_init(&array, allocator, 4));
+
+    for (int32_t i = 0; i < 5; ++i)
+    {
+        TEST_BOOL(soa_comp2_array_insert(&array, make_comp2(i, i * 10, false)));
+    }
+
+    TEST_BOOL(soa_comp2_array_set(&array, 2, make_comp2(20, 200, true)));
+    TEST_BOOL(!soa_comp2_array_set(&array, 5, make_comp2(0, 0, false)));
+
+    TEST_BOOL(soa_comp2_array_delete_at(&array, 0));
+    TEST_BOOL(soa_comp2_array_delete_at(&array, array.length - 1));
+    TEST_BOOL(!soa_comp2_array_delete_at(&array, array.length));
+    TEST_INT64_EQUAL(array.length, (int64_t) 3);
+
+    CompositeType2 expected[] = {
+        make_comp2(1, 10, false),
+        make_comp2(20, 200, true),
+        make_comp2(3, 30, false)
+    };
+    for (int32_t i = 0; i < 3; ++i)
+    {
+        CompositeType2 value;
+        JSL_MEMSET(&value, 0, sizeof(value));
+        TEST_BOOL(soa_comp2_array_get(&array, i, &value));
+        TEST_BOOL(comp2_fields_equal(&value, &expected[i]));
+        TEST_INT64_EQUAL((int64_t) array.b[i], (int64_t) expected[i].b);
+    }
+
+    soa_comp2_array_clear(&array);
+    TEST_INT64_EQUAL(array.length, (int64_t) 0);
+    TEST_INT64_EQUAL(array.capacity, (int64_t) 32);
+
+    CompositeType2 value;
+    TEST_BOOL(!soa_comp2_array_get(&array, 0, &value));
+
+    jsl_allocator_interface_free_all(allocator);
+}
+
+static uint64_t sort_test_state = 0x9E3779B97F4A7C15u;
+
+static uint32_t sort_test_random(void)
+{
+    sort_test_state ^= sort_test_state << 13;
+    sort_test_state ^= sort_test_state >> 7;
+    sort_test_state ^= sort_test_state << 17;
+    return (uint32_t) (sort_test_state >> 32);
+}
+
+static int compare_int32(const void* lhs, const void* rhs)
+{
+    int32_t a = *(const int32_t*) lhs;
+    int32_t b = *(const int32_t*) rhs;
+    return (a > b) - (a < b);
+}
+
+static void fill_sort_pattern(int32_t* values, int64_t count, int32_t pattern)
+{
+    for (int64_t i = 0; i < count; ++i)
+    {
+        int32_t index = (int32_t) i;
+        switch (pattern)
+        {
+            case 0: values[i] = (int32_t) sort_test_random(); break;
+            case 1: values[i] = index; break;
+            case 2: values[i] = (int32_t) count - index; break;
+            case 3: values[i] = 42; break;
+            case 4: values[i] = (int32_t) (sort_test_random() % 4) - 2; break;
+            // organ pipe, ascending then descending
+            case 5: values[i] = index < count / 2 ? index : (int32_t) count - index; break;
+            // sorted with a few random swaps
+            default:
+                values[i] = index;
+                if (i > 0 && sort_test_random() % 64 == 0)
+                {
+                    int32_t tmp = values[i - 1];
+                    values[i - 1] = values[i];
+                    values[i] = tmp;
+                }
+                break;
+        }
+    }
+}
+
+void test_dynamic_array_sort(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    static int64_t lengths[] = { 0, 1, 2, 5, 23, 24, 25, 129, 5000 };
+    int32_t* input = (int32_t*) jsl_allocator_interface_alloc(
+        allocator,
+        sizeof(int32_t) * 5000,
+        _Alignof(int32_t),
+        false
+    );
+    int32_t* expected = (int32_t*) jsl_allocator_interface_alloc(
+        allocator,
+        sizeof(int32_t) * 5000,
+        _Alignof(int32_t),
+        false
+    );
+
+    for (int32_t pattern = 0; pattern < 7; ++pattern)
+    {
+        for (int32_t l = 0; l < (int32_t) (sizeof(lengths) / sizeof(lengths[0])); ++l)
+        {
+            int64_t length = lengths[l];
+
+            DynamicInt32Array array;
+            TEST_BOOL(dynamic_int32_array_init(&array, allocator, length));
+            fill_sort_pattern(input, length, pattern);
+            TEST_BOOL(dynamic_int32_array_insert_multiple(&array, input, length));
+            JSL_MEMCPY(expected, input, sizeof(int32_t) * (size_t) length);
+            qsort(expected, (size_t) length, sizeof(int32_t), compare_int32);
+
+            dynamic_int32_array_sort(&array);
+
+            TEST_INT64_EQUAL(array.length, length);
+            bool matches = length == 0
+                || memcmp(array.data, expected, sizeof(int32_t) * (size_t) length) == 0;
+            TEST_BOOL(matches);
+
+            // the radix sort has to agree with the comparison sort
+            dynamic_int32_array_clear(&array);
+            TEST_BOOL(dynamic_int32_array_insert_multiple(&array, input, length));
+            TEST_BOOL(dynamic_int32_array_radix_sort(&array));
+            matches = length == 0
+                || memcmp(array.data, expected, sizeof(int32_t) * (size_t) length) == 0;
+            TEST_BOOL(matches);
+
+            dynamic_int32_array_free(&array);
+        }
+    }
+
+    dynamic_int32_array_sort(NULL);
+    TEST_BOOL(!dynamic_int32_array_radix_sort(NULL));
+
+    jsl_allocator_interface_free_all(allocator);
+}
+
+void test_dynamic_array_radix_sort_keys(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    // sign handling of signed integers
+    DynamicInt32Array ints;
+    TEST_BOOL(dynamic_int32_array_init(&ints, allocator, 0));
+    int32_t int_values[] = { 5, -1, INT32_MAX, 0, INT32_MIN, -300, 300, -1, 70000 };
+    int32_t sorted_ints[] = { INT32_MIN, -300, -1, -1, 0, 5, 300, 70000, INT32_MAX };
+    TEST_BOOL(dynamic_int32_array_insert_multiple(&ints, int_values, 9));
+    TEST_BOOL(dynamic_int32_array_radix_sort(&ints));
+    TEST_BOOL(memcmp(ints.data, sorted_ints, sizeof(sorted_ints)) == 0);
+    dynamic_int32_array_free(&ints);
+
+    // negative floating point numbers order backwards by their bits
+    DynamicDoubleArray doubles;
+    TEST_BOOL(dynamic_double_array_init(&doubles, allocator, 0));
+    for (int32_t i = 0; i < 3000; ++i)
+    {
+        double value = ((double) sort_test_random() - 2147483648.0) / 1000.0;
+        TEST_BOOL(dynamic_double_array_insert(&doubles, value) != NULL);
+    }
+    TEST_BOOL(dynamic_double_array_insert(&doubles, -0.5) != NULL);
+    TEST_BOOL(dynamic_double_array_insert(&doubles, 0.0) != NULL);
+    TEST_BOOL(dynamic_double_array_insert(&doubles, 1e300) != NULL);
+    TEST_BOOL(dynamic_double_array_insert(&doubles, -1e300) != NULL);
+
+    TEST_BOOL(dynamic_double_array_radix_sort(&doubles));
+    bool ordered = true;
+    for (int64_t i = 1; i < doubles.length; ++i)
+    {
+        ordered = ordered && doubles.data[i - 1] <= doubles.data[i];
+    }
+    TEST_BOOL(ordered);
+    TEST_BOOL(doubles.data[0] == -1e300);
+    TEST_BOOL(doubles.data[doubles.length - 1] == 1e300);
+    dynamic_double_array_free(&doubles);
+
+    // a key function sorts the structs by one member, and the radix sort
+    // keeps equal keys in their original order
+    DynamicCompositeType1Map structs;
+    TEST_BOOL(dynamic_comp1_array_init(&structs, allocator, 0));
+    for (int32_t i = 0; i < 2000; ++i)
+    {
+        int32_t key = (int32_t) (sort_test_random() % 50) - 25;
+        TEST_BOOL(dynamic_comp1_array_insert(&structs, make_comp1(key, i)) != NULL);
+    }
+    TEST_BOOL(dynamic_comp1_array_radix_sort(&structs));
+    bool stable = true;
+    for (int64_t i = 1; i < structs.length; ++i)
+    {
+        const CompositeType1* prev = &structs.data[i - 1];
+        const CompositeType1* current = &structs.data[i];
+        stable = stable && (prev->a < current->a || (prev->a == current->a && prev->b < current->b));
+    }
+    TEST_BOOL(stable);
+
+    dynamic_comp1_array_sort(&structs);
+    ordered = true;
+    for (int64_t i = 1; i < structs.length; ++i)
+    {
+        ordered = ordered && structs.data[i - 1].a <= structs.data[i].a;
+    }
+    TEST_BOOL(ordered);
+    dynamic_comp1_array_free(&structs);
+
+    // the scratch buffer is returned to the allocator
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+}
+
+void test_dynamic_array_nth_element_and_partial_sort(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    int32_t values[3000];
+    int32_t expected[3000];
+    fill_sort_pattern(values, 3000, 0);
+    for (int32_t i = 0; i < 3000; ++i)
+    {
+        values[i] %= 1000;
+    }
+    JSL_MEMCPY(expected, values, sizeof(values));
+    qsort(expected, 3000, sizeof(int32_t), compare_int32);
+
+    DynamicInt32Array array;
+    TEST_BOOL(dynamic_int32_array_init(&array, allocator, 3000));
+
+    static int64_t nths[] = { 0, 1, 1499, 2998, 2999 };
+    for (int32_t n = 0; n < (int32_t) (sizeof(nths) / sizeof(nths[0])); ++n)
+    {
+        int64_t nth = nths[n];
+        dynamic_int32_array_clear(&array);
+        TEST_BOOL(dynamic_int32_array_insert_multiple(&array, values, 3000));
+
+        TEST_BOOL(dynamic_int32_array_nth_element(&array, nth));
+        TEST_INT64_EQUAL((int64_t) array.data[nth], (int64_t) expected[nth]);
+
+        bool partitioned = true;
+        for (int64_t i = 0; i < array.length; ++i)
+        {
+            if (i < nth)
+                partitioned = partitioned && array.data[i] <= array.data[nth];
+            else
+                partitioned = partitioned && array.data[i] >= array.data[nth];
+        }
+        TEST_BOOL(partitioned);
+    }
+    TEST_BOOL(!dynamic_int32_array_nth_element(&array, -1));
+    TEST_BOOL(!dynamic_int32_array_nth_element(&array, 3000));
+
+    static int64_t counts[] = { 0, 1, 10, 500, 2999, 3000, 4000 };
+    for (int32_t c = 0; c < (int32_t) (sizeof(counts) / sizeof(counts[0])); ++c)
+    {
+        int64_t count = counts[c];
+        dynamic_int32_array_clear(&array);
+        TEST_BOOL(dynamic_int32_array_insert_multiple(&array, values, 3000));
+
+        TEST_BOOL(dynamic_int32_array_partial_sort(&array, count));
+        int64_t sorted_count = JSL_MIN(count, (int64_t) 3000);
+        bool matches = sorted_count == 0
+            || memcmp(array.data, expected, sizeof(int32_t) * (size_t) sorted_count) == 0;
+        TEST_BOOL(matches);
+    }
+    TEST_BOOL(!dynamic_int32_array_partial_sort(&array, -1));
+
+    // custom comparison, a then b
+    DynamicCompositeType3ToCompositeType2Map structs;
+    TEST_BOOL(dynamic_comp3_array_init(&structs, allocator, 0));
+    for (int32_t i = 0; i < 500; ++i)
+    {
+        int64_t a = (int64_t) (sort_test_random() % 10);
+        int64_t b = (int64_t) (sort_test_random() % 1000);
+        TEST_BOOL(dynamic_comp3_array_insert(&structs, make_comp3(a, b, i, 0, 0, 0, 0)) != NULL);
+    }
+    TEST_BOOL(dynamic_comp3_array_partial_sort(&structs, 50));
+    bool ordered = true;
+    for (int64_t i = 1; i < 50; ++i)
+    {
+        ordered = ordered && !comp3_less_than(&structs.data[i], &structs.data[i - 1]);
+    }
+    for (int64_t i = 50; i < structs.length; ++i)
+    {
+        ordered = ordered && !comp3_less_than(&structs.data[i], &structs.data[49]);
+    }
+    TEST_BOOL(ordered);
+
+    dynamic_comp3_array_sort(&structs);
+    ordered = true;
+    for (int64_t i = 1; i < structs.length; ++i)
+    {
+        ordered = ordered && !comp3_less_than(&structs.data[i], &structs.data[i - 1]);
+    }
+    TEST_BOOL(ordered);
+
+    jsl_allocator_interface_free_all(allocator);
+}
+
+void test_dynamic_array_lower_and_upper_bound(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    DynamicInt32Array array;
+    TEST_BOOL(dynamic_int32_array_init(&array, allocator, 0));
+
+    int32_t probe = 7;
+    TEST_INT64_EQUAL(dynamic_int32_array_lower_bound(&array, &probe), (int64_t) 0);
+    TEST_INT64_EQUAL(dynamic_int32_array_upper_bound(&array, &probe), (int64_t) 0);
+    TEST_INT64_EQUAL(dynamic_int32_array_lower_bound(NULL, &probe), (int64_t) -1);
+    TEST_INT64_EQUAL(dynamic_int32_array_upper_bound(&array, NULL), (int64_t) -1);
+
+    // runs of duplicates with gaps between them
+    for (int32_t i = 0; i < 777; ++i)
+    {
+        TEST_BOOL(dynamic_int32_array_insert(&array, (i / 3) * 2) != NULL);
+    }
+
+    bool matches = true;
+    for (probe = -3; probe < 522; ++probe)
+    {
+        int64_t expected_lower = 0;
+        while (expected_lower < array.length && array.data[expected_lower] < probe)
+            ++expected_lower;
+
+        int64_t expected_upper = expected_lower;
+        while (expected_upper < array.length && array.data[expected_upper] <= probe)
+            ++expected_upper;
+
+        matches = matches
+            && dynamic_int32_array_lower_bound(&array, &probe) == expected_lower
+            && dynamic_int32_array_upper_bound(&array, &probe) == expected_upper;
+    }
+    TEST_BOOL(matches);
+
+    probe = 10;
+    TEST_INT64_EQUAL(dynamic_int32_array_lower_bound(&array, &probe), (int64_t) 15);
+    TEST_INT64_EQUAL(dynamic_int32_array_upper_bound(&array, &probe), (int64_t) 18);
+
+    // bounds use the key function too
+    DynamicCompositeType1Map structs;
+    TEST_BOOL(dynamic_comp1_array_init(&structs, allocator, 0));
+    for (int32_t i = 0; i < 10; ++i)
+    {
+        TEST_BOOL(dynamic_comp1_array_insert(&structs, make_comp1(i / 2, 100 - i)) != NULL);
+    }
+    CompositeType1 key = make_comp1(3, 0);
+    TEST_INT64_EQUAL(dynamic_comp1_array_lower_bound(&structs, &key), (int64_t) 6);
+    TEST_INT64_EQUAL(dynamic_comp1_array_upper_bound(&structs, &key), (int64_t) 8);
+
+    jsl_allocator_interface_free_all(allocator);
+}
+
+void test_segmented_array_stable_addresses(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    SegmentedComp1Array array;
+    TEST_BOOL(!segmented_comp1_array_init(NULL, allocator, 0));
+    TEST_BOOL(!segmented_comp1_array_init(&array, allocator, -1));
+    TEST_BOOL(segmented_comp1_array_init(&array, allocator, 0));
+    TEST_INT64_EQUAL(array.capacity, segmented_comp1_array_BLOCK_LENGTH);
+    TEST_INT64_EQUAL(array.block_count, (int64_t) 1);
+
+    CompositeType1* pointers[1000];
+    for (int32_t i = 0; i < 1000; ++i)
+    {
+        pointers[i] = segmented_comp1_array_insert(&array, make_comp1(i, -i));
+        TEST_BOOL(pointers[i] != NULL);
+    }
+    TEST_INT64_EQUAL(array.length, (int64_t) 1000);
+    TEST_INT64_EQUAL(array.block_count, (int64_t) 63);
+    TEST_INT64_EQUAL(array.capacity, (int64_t) 63 * 16);
+
+    // growing never moved anything that was already inserted
+    bool stable = true;
+    for (int32_t i = 0; i < 1000; ++i)
+    {
+        CompositeType1 expected = make_comp1(i, -i);
+        stable = stable
+            && segmented_comp1_array_get(&array, i) == pointers[i]
+            && comp1_equal(pointers[i], &expected);
+    }
+    TEST_BOOL(stable);
+    TEST_POINTERS_EQUAL(segmented_comp1_array_get(&array, 1000), NULL);
+    TEST_POINTERS_EQUAL(segmented_comp1_array_get(&array, -1), NULL);
+
+    // a run that starts mid block and spans several blocks
+    CompositeType1 many[40];
+    for (int32_t i = 0; i < 40; ++i)
+    {
+        many[i] = make_comp1(5000 + i, 0);
+    }
+    TEST_BOOL(segmented_comp1_array_insert_multiple(&array, many, 40));
+    TEST_BOOL(!segmented_comp1_array_insert_multiple(&array, NULL, 1));
+    TEST_INT64_EQUAL(array.length, (int64_t) 1040);
+    bool copied = true;
+    for (int32_t i = 0; i < 40; ++i)
+    {
+        copied = copied && comp1_equal(segmented_comp1_array_get(&array, 1000 + i), &many[i]);
+    }
+    TEST_BOOL(copied);
+    TEST_POINTERS_EQUAL((void*) segmented_comp1_array_get(&array, 0), (void*) pointers[0]);
+
+    // walking the blocks visits every element once, in order
+    int64_t visited = 0;
+    bool in_order = true;
+    for (int64_t block = 0; block * segmented_comp1_array_BLOCK_LENGTH < array.length; ++block)
+    {
+        int64_t block_length = 0;
+        CompositeType1* values = segmented_comp1_array_block(&array, block, &block_length);
+        TEST_BOOL(values != NULL);
+        for (int64_t i = 0; i < block_length; ++i)
+        {
+            in_order = in_order && &values[i] == segmented_comp1_array_get(&array, visited);
+            ++visited;
+        }
+    }
+    TEST_INT64_EQUAL(visited, (int64_t) 1040);
+    TEST_BOOL(in_order);
+
+    int64_t empty_length = -1;
+    TEST_POINTERS_EQUAL(segmented_comp1_array_block(&array, array.block_count, &empty_length), NULL);
+    TEST_INT64_EQUAL(empty_length, (int64_t) 0);
+
+    segmented_comp1_array_free(&array);
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+    TEST_POINTERS_EQUAL(segmented_comp1_array_insert(&array, make_comp1(0, 0)), NULL);
+}
+
+void test_segmented_array_reserve_delete_and_clear(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    SegmentedComp1Array array;
+    TEST_BOOL(segmented_comp1_array_init(&array, allocator, 17));
+    TEST_INT64_EQUAL(array.block_count, (int64_t) 2);
+
+    TEST_BOOL(segmented_comp1_array_reserve(&array, 100));
+    TEST_INT64_EQUAL(array.block_count, (int64_t) 7);
+    TEST_BOOL(segmented_comp1_array_reserve(&array, 10));
+    TEST_INT64_EQUAL(array.block_count, (int64_t) 7);
+    TEST_BOOL(!segmented_comp1_array_reserve(&array, -1));
+
+    CompositeType1 value;
+    TEST_BOOL(!segmented_comp1_array_delete_last(&array, &value));
+
+    for (int32_t i = 0; i < 20; ++i)
+    {
+        TEST_BOOL(segmented_comp1_array_insert(&array, make_comp1(i, i)) != NULL);
+    }
+    CompositeType1* sixteenth = segmented_comp1_array_get(&array, 16);
+
+    TEST_BOOL(segmented_comp1_array_delete_last(&array, &value));
+    CompositeType1 expected = make_comp1(19, 19);
+    TEST_BOOL(comp1_equal(&value, &expected));
+    TEST_BOOL(segmented_comp1_array_delete_last(&array, NULL));
+    TEST_INT64_EQUAL(array.length, (int64_t) 18);
+    TEST_POINTERS_EQUAL((void*) segmented_comp1_array_get(&array, 16), (void*) sixteenth);
+
+    // clearing keeps the blocks, so refilling doesn't allocate
+    segmented_comp1_array_clear(&array);
+    TEST_INT64_EQUAL(array.length, (int64_t) 0);
+    TEST_INT64_EQUAL(array.capacity, (int64_t) 7 * 16);
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        TEST_BOOL(segmented_comp1_array_insert(&array, make_comp1(i, 0)) != NULL);
+    }
+    TEST_INT64_EQUAL(array.block_count, (int64_t) 7);
+    TEST_POINTERS_EQUAL((void*) segmented_comp1_array_get(&array, 16), (void*) sixteenth);
+
+    segmented_comp1_array_free(&array);
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+}
+
+void test_ring_push_pop_and_growth(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    DynamicComp1Ring ring;
+    TEST_BOOL(!dynamic_comp1_ring_init(NULL, allocator, 4));
+    TEST_BOOL(!dynamic_comp1_ring_init(&ring, allocator, -1));
+    TEST_BOOL(dynamic_comp1_ring_init(&ring, allocator, 3));
+    TEST_INT64_EQUAL(ring.capacity, (int64_t) 4);
+
+    CompositeType1 value;
+    TEST_BOOL(!dynamic_comp1_ring_pop_front(&ring, &value));
+    TEST_BOOL(!dynamic_comp1_ring_pop_back(&ring, &value));
+
+    // move the head forward so the next pushes wrap around the end
+    TEST_BOOL(dynamic_comp1_ring_push_back(&ring, make_comp1(0, 0)));
+    TEST_BOOL(dynamic_comp1_ring_push_back(&ring, make_comp1(1, 0)));
+    TEST_BOOL(dynamic_comp1_ring_push_back(&ring, make_comp1(2, 0)));
+    TEST_BOOL(dynamic_comp1_ring_pop_front(&ring, &value));
+    TEST_INT32_EQUAL(value.a, 0);
+    TEST_BOOL(dynamic_comp1_ring_pop_front(&ring, NULL));
+    TEST_BOOL(dynamic_comp1_ring_push_back(&ring, make_comp1(3, 0)));
+    TEST_BOOL(dynamic_comp1_ring_push_back(&ring, make_comp1(4, 0)));
+    TEST_BOOL(dynamic_comp1_ring_push_back(&ring, make_comp1(5, 0)));
+    TEST_INT64_EQUAL(ring.capacity, (int64_t) 4);
+    TEST_INT64_EQUAL(ring.length, (int64_t) 4);
+
+    CompositeType1* first = NULL;
+    CompositeType1* second = NULL;
+    int64_t first_length = 0;
+    int64_t second_length = 0;
+    TEST_BOOL(dynamic_comp1_ring_spans(&ring, &first, &first_length, &second, &second_length));
+    TEST_INT64_EQUAL(first_length, (int64_t) 2);
+    TEST_INT64_EQUAL(second_length, (int64_t) 2);
+    TEST_INT32_EQUAL(first[0].a, 2);
+    TEST_INT32_EQUAL(second[1].a, 5);
+    TEST_BOOL(!dynamic_comp1_ring_spans(&ring, &first, NULL, &second, &second_length));
+
+    // growing while wrapped keeps front to back order
+    TEST_BOOL(dynamic_comp1_ring_push_front(&ring, make_comp1(1, 0)));
+    TEST_INT64_EQUAL(ring.capacity, (int64_t) 8);
+    bool in_order = true;
+    for (int64_t i = 0; i < ring.length; ++i)
+    {
+        in_order = in_order && dynamic_comp1_ring_get(&ring, i)->a == (int32_t) i + 1;
+    }
+    TEST_BOOL(in_order);
+    TEST_INT64_EQUAL(ring.length, (int64_t) 5);
+    TEST_POINTERS_EQUAL(dynamic_comp1_ring_get(&ring, 5), NULL);
+
+    TEST_BOOL(dynamic_comp1_ring_pop_back(&ring, &value));
+    TEST_INT32_EQUAL(value.a, 5);
+    TEST_BOOL(dynamic_comp1_ring_pop_front(&ring, &value));
+    TEST_INT32_EQUAL(value.a, 1);
+
+    // many items through a small ring, as a FIFO queue
+    bool fifo = true;
+    int32_t next_out = 2;
+    for (int32_t i = 5; i < 1000; ++i)
+    {
+        TEST_BOOL(dynamic_comp1_ring_push_back(&ring, make_comp1(i, -i)));
+        if (i % 3 != 0)
+        {
+            fifo = fifo && dynamic_comp1_ring_pop_front(&ring, &value) && value.a == next_out;
+            ++next_out;
+        }
+    }
+    TEST_BOOL(fifo);
+    TEST_INT64_EQUAL(ring.length, (int64_t) (1000 - next_out));
+
+    dynamic_comp1_ring_clear(&ring);
+    TEST_INT64_EQUAL(ring.length, (int64_t) 0);
+    TEST_BOOL(!dynamic_comp1_ring_pop_front(&ring, &value));
+
+    dynamic_comp1_ring_free(&ring);
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+    TEST_BOOL(!dynamic_comp1_ring_push_back(&ring, make_comp1(0, 0)));
+}
+
+void test_ring_fixed_bulk_push_and_pop(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+
+    FixedInt32Ring ring;
+    TEST_BOOL(fixed_int32_ring_init(&ring, allocator, 5));
+    TEST_INT64_EQUAL(ring.capacity, (int64_t) 8);
+
+    int32_t values[16];
+    for (int32_t i = 0; i < 16; ++i)
+    {
+        values[i] = i;
+    }
+    int32_t out[16] = {0};
+
+    TEST_BOOL(fixed_int32_ring_push_many(&ring, values, 6));
+    TEST_INT64_EQUAL(fixed_int32_ring_pop_many(&ring, out, 4), (int64_t) 4);
+    TEST_INT32_EQUAL(out[0], 0);
+    TEST_INT32_EQUAL(out[3], 3);
+
+    // the free space wraps around the end of the buffer
+    TEST_BOOL(fixed_int32_ring_push_many(&ring, values + 6, 5));
+    TEST_INT64_EQUAL(ring.length, (int64_t) 7);
+
+    // a fixed ring is all or nothing when full
+    TEST_BOOL(!fixed_int32_ring_push_many(&ring, values + 11, 2));
+    TEST_INT64_EQUAL(ring.length, (int64_t) 7);
+    TEST_BOOL(fixed_int32_ring_push_back(&ring, 11));
+    TEST_BOOL(!fixed_int32_ring_push_back(&ring, 12));
+    TEST_BOOL(!fixed_int32_ring_push_front(&ring, 12));
+    TEST_INT64_EQUAL(ring.capacity, (int64_t) 8);
+
+    TEST_INT64_EQUAL(fixed_int32_ring_pop_many(&ring, NULL, 2), (int64_t) 2);
+
+    // the remaining elements wrap, so this is a two part copy
+    TEST_INT64_EQUAL(fixed_int32_ring_pop_many(&ring, out, 16), (int64_t) 6);
+    bool in_order = true;
+    for (int32_t i = 0; i < 6; ++i)
+    {
+        in_order = in_order && out[i] == i + 6;
+    }
+    TEST_BOOL(in_order);
+
+    TEST_INT64_EQUAL(fixed_int32_ring_pop_many(&ring, out, 4), (int64_t) 0);
+    TEST_INT64_EQUAL(fixed_int32_ring_pop_many(&ring, out, -1), (int64_t) -1);
+    TEST_BOOL(!fixed_int32_ring_push_many(&ring, NULL, 1));
+    TEST_BOOL(!fixed_int32_ring_push_many(&ring, values, -1));
+    TEST_BOOL(fixed_int32_ring_push_many(&ring, NULL, 0));
+
+    TEST_BOOL(fixed_int32_ring_push_front(&ring, 2));
+    TEST_BOOL(fixed_int32_ring_push_front(&ring, 1));
+    TEST_BOOL(fixed_int32_ring_push_back(&ring, 3));
+    int32_t value = 0;
+    TEST_BOOL(fixed_int32_ring_pop_front(&ring, &value));
+    TEST_INT32_EQUAL(value, 1);
+    TEST_BOOL(fixed_int32_ring_pop_back(&ring, &value));
+    TEST_INT32_EQUAL(value, 3);
+    TEST_INT32_EQUAL(*fixed_int32_ring_get(&ring, 0), 2);
+}
+
+void test_spsc_queue_batches(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    SpscInt64Queue queue;
+    TEST_BOOL(!spsc_int64_queue_init(NULL, allocator, 8));
+    TEST_BOOL(!spsc_int64_queue_init(&queue, allocator, -1));
+    TEST_BOOL(spsc_int64_queue_init(&queue, allocator, 5));
+    TEST_INT64_EQUAL(queue.capacity, (int64_t) 8);
+
+    int64_t value = 0;
+    TEST_BOOL(!spsc_int64_queue_try_pop(&queue, &value));
+
+    int64_t values[12];
+    for (int64_t i = 0; i < 12; ++i)
+    {
+        values[i] = i;
+    }
+    int64_t out[12] = {0};
+
+    // only what fits is pushed
+    TEST_INT64_EQUAL(spsc_int64_queue_push_many(&queue, values, 12), (int64_t) 8);
+    TEST_BOOL(!spsc_int64_queue_try_push(&queue, 100));
+    TEST_INT64_EQUAL(spsc_int64_queue_approximate_length(&queue), (int64_t) 8);
+
+    TEST_INT64_EQUAL(spsc_int64_queue_pop_many(&queue, out, 3), (int64_t) 3);
+    TEST_INT64_EQUAL(out[2], (int64_t) 2);
+
+    // these wrap around the end of the buffer
+    TEST_INT64_EQUAL(spsc_int64_queue_push_many(&queue, values + 8, 4), (int64_t) 3);
+    TEST_INT64_EQUAL(spsc_int64_queue_pop_many(&queue, out, 12), (int64_t) 8);
+    bool in_order = true;
+    for (int64_t i = 0; i < 8; ++i)
+    {
+        in_order = in_order && out[i] == i + 3;
+    }
+    TEST_BOOL(in_order);
+
+    TEST_BOOL(spsc_int64_queue_try_push(&queue, 42));
+    TEST_BOOL(spsc_int64_queue_try_pop(&queue, &value));
+    TEST_INT64_EQUAL(value, (int64_t) 42);
+    TEST_INT64_EQUAL(spsc_int64_queue_pop_many(&queue, out, 4), (int64_t) 0);
+
+    TEST_INT64_EQUAL(spsc_int64_queue_push_many(&queue, NULL, 1), (int64_t) -1);
+    TEST_INT64_EQUAL(spsc_int64_queue_pop_many(&queue, out, -1), (int64_t) -1);
+    TEST_BOOL(!spsc_int64_queue_try_pop(&queue, NULL));
+
+    spsc_int64_queue_free(&queue);
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+    TEST_BOOL(!spsc_int64_queue_try_push(&queue, 1));
+}
+
+#define QUEUE_ITEMS_PER_PRODUCER 20000
+#define QUEUE_PRODUCER_COUNT 4
+#define QUEUE_CONSUMER_COUNT 4
+
+// Give up the time slice when the queue is full or empty, so the test
+// doesn't crawl on machines with fewer cores than threads
+static void queue_test_yield(void)
+{
+    #if JSL_IS_WINDOWS
+        SwitchToThread();
+    #else
+        sched_yield();
+    #endif
+}
+
+static void spsc_producer_loop(SpscInt64Queue* queue)
+{
+    // alternate single pushes and batches to exercise both paths
+    int64_t batch[7];
+    int64_t next = 0;
+    while (next < QUEUE_ITEMS_PER_PRODUCER)
+    {
+        int64_t previous = next;
+        if (next % 2 == 0)
+        {
+            if (spsc_int64_queue_try_push(queue, next))
+                ++next;
+        }
+        else
+        {
+            int64_t batch_length = JSL_MIN((int64_t) 7, QUEUE_ITEMS_PER_PRODUCER - next);
+            for (int64_t i = 0; i < batch_length; ++i)
+            {
+                batch[i] = next + i;
+            }
+            next += spsc_int64_queue_push_many(queue, batch, batch_length);
+        }
+
+        if (next == previous)
+            queue_test_yield();
+    }
+}
+
+#if JSL_IS_WINDOWS
+    static DWORD WINAPI spsc_producer_entry(LPVOID arg)
+    {
+        spsc_producer_loop((SpscInt64Queue*) arg);
+        return 0;
+    }
+#else
+    static void* spsc_producer_entry(void* arg)
+    {
+        spsc_producer_loop((SpscInt64Queue*) arg);
+        return NULL;
+    }
+#endif
+
+void test_spsc_queue_threaded(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+
+    SpscInt64Queue queue;
+    TEST_BOOL(spsc_int64_queue_init(&queue, allocator, 64));
+
+    #if JSL_IS_WINDOWS
+        HANDLE thread = CreateThread(NULL, 0, spsc_producer_entry, &queue, 0, NULL);
+    #else
+        pthread_t thread;
+        pthread_create(&thread, NULL, spsc_producer_entry, &queue);
+    #endif
+
+    // every value arrives exactly once and in order
+    int64_t expected = 0;
+    int64_t errors = 0;
+    int64_t out[5];
+    while (expected < QUEUE_ITEMS_PER_PRODUCER)
+    {
+        int64_t previous = expected;
+        int64_t popped = spsc_int64_queue_pop_many(&queue, out, 5);
+        for (int64_t i = 0; i < popped; ++i)
+        {
+            if (out[i] != expected)
+                ++errors;
+            ++expected;
+        }
+
+        int64_t value;
+        if (spsc_int64_queue_try_pop(&queue, &value))
+        {
+            if (value != expected)
+                ++errors;
+            ++expected;
+        }
+
+        if (expected == previous)
+            queue_test_yield();
+    }
+
+    #if JSL_IS_WINDOWS
+        WaitForSingleObject(thread, INFINITE);
+        CloseHandle(thread);
+    #else
+        pthread_join(thread, NULL);
+    #endif
+
+    TEST_INT64_EQUAL(errors, (int64_t) 0);
+    TEST_INT64_EQUAL(spsc_int64_queue_approximate_length(&queue), (int64_t) 0);
+    spsc_int64_queue_free(&queue);
+}
+
+typedef struct MpmcQueueThreadState {
+    MpmcComp1Queue* queue;
+    uint64_t* consumed_total;
+    int32_t thread_index;
+    int64_t consumed;
+    int64_t value_sum;
+    int64_t errors;
+} MpmcQueueThreadState;
+
+static void mpmc_producer_loop(MpmcQueueThreadState* state)
+{
+    CompositeType1 batch[5];
+    int32_t next = 0;
+    while (next < QUEUE_ITEMS_PER_PRODUCER)
+    {
+        int32_t previous = next;
+        if (next % 3 == 0)
+        {
+            if (mpmc_comp1_queue_try_push(state->queue, make_comp1(state->thread_index, next)))
+                ++next;
+        }
+        else
+        {
+            int32_t batch_length = JSL_MIN(5, QUEUE_ITEMS_PER_PRODUCER - next);
+            for (int32_t i = 0; i < batch_length; ++i)
+            {
+                batch[i] = make_comp1(state->thread_index, next + i);
+            }
+            next += (int32_t) mpmc_comp1_queue_push_many(state->queue, batch, batch_length);
+        }
+
+        if (next == previous)
+            queue_test_yield();
+    }
+}
+
+static void mpmc_consumer_loop(MpmcQueueThreadState* state)
+{
+    // positions are claimed in order, so one consumer sees each producer's
+    // values in increasing order even with other consumers running
+    int32_t last_seen[QUEUE_PRODUCER_COUNT];
+    for (int32_t i = 0; i < QUEUE_PRODUCER_COUNT; ++i)
+    {
+        last_seen[i] = -1;
+    }
+
+    const uint64_t total = QUEUE_PRODUCER_COUNT * QUEUE_ITEMS_PER_PRODUCER;
+    CompositeType1 out[6];
+
+    while (jsl__atomic_load_u64(state->consumed_total) < total)
+    {
+        int64_t popped = mpmc_comp1_queue_pop_many(state->queue, out, 6);
+        for (int64_t i = 0; i < popped; ++i)
+        {
+            int32_t producer = out[i].a;
+            if (producer < 0 || producer >= QUEUE_PRODUCER_COUNT || out[i].b <= last_seen[producer])
+            {
+                ++state->errors;
+                continue;
+            }
+
+            last_seen[producer] = out[i].b;
+            state->value_sum += out[i].b;
+        }
+
+        if (popped > 0)
+        {
+            state->consumed += popped;
+            jsl__atomic_fetch_add_u64(state->consumed_total, (uint64_t) popped);
+        }
+        else
+        {
+            queue_test_yield();
+        }
+    }
+}
+
+#if JSL_IS_WINDOWS
+    static DWORD WINAPI mpmc_producer_entry(LPVOID arg)
+    {
+        mpmc_producer_loop((MpmcQueueThreadState*) arg);
+        return 0;
+    }
+
+    static DWORD WINAPI mpmc_consumer_entry(LPVOID arg)
+    {
+        mpmc_consumer_loop((MpmcQueueThreadState*) arg);
+        return 0;
+    }
+#else
+    static void* mpmc_producer_entry(void* arg)
+    {
+        mpmc_producer_loop((MpmcQueueThreadState*) arg);
+        return NULL;
+    }
+
+    static void* mpmc_consumer_entry(void* arg)
+    {
+        mpmc_consumer_loop((MpmcQueueThreadState*) arg);
+        return NULL;
+    }
+#endif
+
+void test_mpmc_queue_threaded(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+
+    MpmcComp1Queue queue;
+    TEST_BOOL(!mpmc_comp1_queue_init(&queue, allocator, -1));
+    TEST_BOOL(mpmc_comp1_queue_init(&queue, allocator, 3));
+    TEST_INT64_EQUAL(queue.capacity, (int64_t) 4);
+
+    // full and empty on one thread
+    CompositeType1 batch[6] = {
+        make_comp1(0, 0), make_comp1(0, 1), make_comp1(0, 2),
+        make_comp1(0, 3), make_comp1(0, 4), make_comp1(0, 5)
+    };
+    CompositeType1 value;
+    TEST_BOOL(!mpmc_comp1_queue_try_pop(&queue, &value));
+    TEST_INT64_EQUAL(mpmc_comp1_queue_push_many(&queue, batch, 6), (int64_t) 4);
+    TEST_BOOL(!mpmc_comp1_queue_try_push(&queue, make_comp1(0, 9)));
+    TEST_INT64_EQUAL(mpmc_comp1_queue_approximate_length(&queue), (int64_t) 4);
+    TEST_BOOL(mpmc_comp1_queue_try_pop(&queue, &value));
+    TEST_INT32_EQUAL(value.b, 0);
+    TEST_INT64_EQUAL(mpmc_comp1_queue_push_many(&queue, batch + 4, 2), (int64_t) 1);
+    TEST_INT64_EQUAL(mpmc_comp1_queue_pop_many(&queue, batch, 6), (int64_t) 4);
+    TEST_INT32_EQUAL(batch[0].b, 1);
+    TEST_INT32_EQUAL(batch[3].b, 4);
+    TEST_INT64_EQUAL(mpmc_comp1_queue_pop_many(&queue, batch, 6), (int64_t) 0);
+    TEST_INT64_EQUAL(mpmc_comp1_queue_pop_many(&queue, NULL, 1), (int64_t) -1);
+    mpmc_comp1_queue_free(&queue);
+
+    TEST_BOOL(mpmc_comp1_queue_init(&queue, allocator, 128));
+
+    uint64_t consumed_total = 0;
+    MpmcQueueThreadState states[QUEUE_PRODUCER_COUNT + QUEUE_CONSUMER_COUNT];
+
+    #if JSL_IS_WINDOWS
+        HANDLE threads[QUEUE_PRODUCER_COUNT + QUEUE_CONSUMER_COUNT];
+    #else
+        pthread_t threads[QUEUE_PRODUCER_COUNT + QUEUE_CONSUMER_COUNT];
+    #endif
+
+    for (int32_t i = 0; i < QUEUE_PRODUCER_COUNT + QUEUE_CONSUMER_COUNT; ++i)
+    {
+        states[i] = (MpmcQueueThreadState) {
+            .queue = &queue,
+            .consumed_total = &consumed_total,
+            .thread_index = i
+        };
+        bool is_producer = i < QUEUE_PRODUCER_COUNT;
+        #if JSL_IS_WINDOWS
+            threads[i] = CreateThread(
+                NULL,
+                0,
+                is_producer ? mpmc_producer_entry : mpmc_consumer_entry,
+                &states[i],
+                0,
+                NULL
+            );
+        #else
+            pthread_create(
+                &threads[i],
+                NULL,
+                is_producer ? mpmc_producer_entry : mpmc_consumer_entry,
+                &states[i]
+            );
+        #endif
+    }
+
+    int64_t consumed = 0;
+    int64_t value_sum = 0;
+    int64_t errors = 0;
+    for (int32_t i = 0; i < QUEUE_PRODUCER_COUNT + QUEUE_CONSUMER_COUNT; ++i)
+    {
+        #if JSL_IS_WINDOWS
+            WaitForSingleObject(threads[i], INFINITE);
+            CloseHandle(threads[i]);
+        #else
+            pthread_join(threads[i], NULL);
+        #endif
+
+        consumed += states[i].consumed;
+        value_sum += states[i].value_sum;
+        errors += states[i].errors;
+    }
+
+    // every value was popped exactly once
+    int64_t per_producer_sum = (int64_t) QUEUE_ITEMS_PER_PRODUCER * (QUEUE_ITEMS_PER_PRODUCER - 1) / 2;
+    TEST_INT64_EQUAL(errors, (int64_t) 0);
+    TEST_INT64_EQUAL(consumed, (int64_t) QUEUE_PRODUCER_COUNT * QUEUE_ITEMS_PER_PRODUCER);
+    TEST_INT64_EQUAL(value_sum, per_producer_sum * QUEUE_PRODUCER_COUNT);
+    TEST_INT64_EQUAL(mpmc_comp1_queue_approximate_length(&queue), (int64_t) 0);
+
+    mpmc_comp1_queue_free(&queue);
+}
@@ -9,4 +9,22 @@ void test_dynamic_array_delete_at_removes_and_shifts(void);
 void test_dynamic_array_clear_resets_length(void);
 void test_dynamic_array_checks_sentinel(void);
 
+void test_soa_array_insert_and_grow(void);
+void test_soa_array_set_delete_and_clear(void);
+
+void test_dynamic_array_sort(void);
+void test_dynamic_array_radix_sort_keys(void);
+void test_dynamic_array_nth_element_and_partial_sort(void);
+void test_dynamic_array_lower_and_upper_bound(void);
+
+void test_segmented_array_stable_addresses(void);
+void test_segmented_array_reserve_delete_and_clear(void);
+
+void test_ring_push_pop_and_growth(void);
+void test_ring_fixed_bulk_push_and_pop(void);
+
+void test_spsc_queue_batches(void);
+void test_spsc_queue_threaded(void);
+void test_mpmc_queue_threaded(void);
+
 #endif
@@ -0,0 +1,413 @@
+/**
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "jsl/core.h"
+#include "jsl/allocator.h"
+#include "jsl/allocator_infinite_arena.h"
+#include "jsl/allocator_libc.h"
+#include "jsl/atomic_common.h"
+#include "jsl/frozen_str_map.h"
+#include "jsl/concurrent_str_map.h"
+
+#if JSL_IS_WINDOWS
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+#include "minctest.h"
+#include "test_concurrent_str_map.h"
+
+extern JSLInfiniteArena global_arena;
+
+void test_jsl_concurrent_str_map_publish_visibility(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLConcurrentStrMap map;
+    bool ok = jsl_concurrent_str_map_init(&map, allocator, 0x5EED, 4);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLConcurrentStrMapReader reader;
+    TEST_BOOL(jsl_concurrent_str_map_reader_register(&map, &reader));
+
+    const JSLFrozenStrMap* snapshot = jsl_concurrent_str_map_read_begin(&reader);
+    TEST_BOOL(snapshot != NULL);
+    TEST_INT64_EQUAL(jsl_frozen_str_map_item_count(snapshot), (int64_t) 0);
+    jsl_concurrent_str_map_read_end(&reader);
+
+    jsl_concurrent_str_map_insert(
+        &map,
+        JSL_CSTR_EXPRESSION("alpha"), JSL_STRING_LIFETIME_SHORTER,
+        JSL_CSTR_EXPRESSION("one"), JSL_STRING_LIFETIME_SHORTER
+    );
+
+    // Not visible until published
+    TEST_BOOL(!jsl_concurrent_str_map_has_key(&reader, JSL_CSTR_EXPRESSION("alpha")));
+
+    TEST_BOOL(jsl_concurrent_str_map_publish(&map));
+    TEST_BOOL(jsl_concurrent_str_map_has_key(&reader, JSL_CSTR_EXPRESSION("alpha")));
+
+    snapshot = jsl_concurrent_str_map_read_begin(&reader);
+    JSLImmutableMemory value = {0};
+    TEST_BOOL(jsl_frozen_str_map_get(snapshot, JSL_CSTR_EXPRESSION("alpha"), &value));
+    TEST_BOOL(jsl_memory_compare(value, JSL_CSTR_EXPRESSION("one")));
+
+    // A snapshot taken before a publish keeps the old contents
+    jsl_concurrent_str_map_delete(&map, JSL_CSTR_EXPRESSION("alpha"));
+    jsl_concurrent_str_map_insert(
+        &map,
+        JSL_CSTR_EXPRESSION("beta"), JSL_STRING_LIFETIME_SHORTER,
+        JSL_CSTR_EXPRESSION("two"), JSL_STRING_LIFETIME_SHORTER
+    );
+    TEST_BOOL(jsl_concurrent_str_map_publish(&map));
+
+    TEST_BOOL(jsl_frozen_str_map_has_key(snapshot, JSL_CSTR_EXPRESSION("alpha")));
+    TEST_BOOL(!jsl_frozen_str_map_has_key(snapshot, JSL_CSTR_EXPRESSION("beta")));
+    jsl_concurrent_str_map_read_end(&reader);
+
+    TEST_BOOL(!jsl_concurrent_str_map_has_key(&reader, JSL_CSTR_EXPRESSION("alpha")));
+    TEST_BOOL(jsl_concurrent_str_map_has_key(&reader, JSL_CSTR_EXPRESSION("beta")));
+
+    jsl_concurrent_str_map_clear(&map);
+    TEST_BOOL(jsl_concurrent_str_map_publish(&map));
+    TEST_BOOL(!jsl_concurrent_str_map_has_key(&reader, JSL_CSTR_EXPRESSION("beta")));
+
+    jsl_concurrent_str_map_reader_unregister(&reader);
+    jsl_concurrent_str_map_free(&map);
+}
+
+void test_jsl_concurrent_str_map_deferred_reclaim(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    JSLConcurrentStrMap map;
+    bool ok = jsl_concurrent_str_map_init(&map, allocator, 0x5EED, 2);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLConcurrentStrMapReader slow_reader;
+    TEST_BOOL(jsl_concurrent_str_map_reader_register(&map, &slow_reader));
+
+    // Nobody is reading, so every publish frees the version it replaced
+    for (int32_t i = 0; i < 4; ++i)
+    {
+        jsl_concurrent_str_map_insert(
+            &map,
+            JSL_CSTR_EXPRESSION("key"), JSL_STRING_LIFETIME_SHORTER,
+            JSL_CSTR_EXPRESSION("value"), JSL_STRING_LIFETIME_SHORTER
+        );
+        jsl_concurrent_str_map_publish(&map);
+    }
+    TEST_INT64_EQUAL(jsl_concurrent_str_map_reclaim(&map), (int64_t) 0);
+
+    const JSLFrozenStrMap* snapshot = jsl_concurrent_str_map_read_begin(&slow_reader);
+
+    // The version the reader holds and everything after it must stay alive
+    for (int32_t i = 0; i < 3; ++i)
+    {
+        jsl_concurrent_str_map_insert(
+            &map,
+            JSL_CSTR_EXPRESSION("key"), JSL_STRING_LIFETIME_SHORTER,
+            JSL_CSTR_EXPRESSION("new value"), JSL_STRING_LIFETIME_SHORTER
+        );
+        jsl_concurrent_str_map_publish(&map);
+    }
+    TEST_INT64_EQUAL(jsl_concurrent_str_map_reclaim(&map), (int64_t) 3);
+
+    JSLImmutableMemory value = {0};
+    TEST_BOOL(jsl_frozen_str_map_get(snapshot, JSL_CSTR_EXPRESSION("key"), &value));
+    TEST_BOOL(jsl_memory_compare(value, JSL_CSTR_EXPRESSION("value")));
+
+    jsl_concurrent_str_map_read_end(&slow_reader);
+    TEST_INT64_EQUAL(jsl_concurrent_str_map_reclaim(&map), (int64_t) 0);
+
+    // A read section that starts after a publish does not hold back the
+    // versions retired before it
+    jsl_concurrent_str_map_read_begin(&slow_reader);
+    jsl_concurrent_str_map_publish(&map);
+    TEST_INT64_EQUAL(jsl_concurrent_str_map_reclaim(&map), (int64_t) 1);
+    jsl_concurrent_str_map_read_end(&slow_reader);
+
+    jsl_concurrent_str_map_read_begin(&slow_reader);
+    jsl_concurrent_str_map_publish(&map);
+    TEST_INT64_EQUAL(jsl_concurrent_str_map_reclaim(&map), (int64_t) 1);
+    jsl_concurrent_str_map_read_end(&slow_reader);
+    TEST_INT64_EQUAL(jsl_concurrent_str_map_reclaim(&map), (int64_t) 0);
+
+    jsl_concurrent_str_map_reader_unregister(&slow_reader);
+    jsl_concurrent_str_map_free(&map);
+    jsl_libc_allocator_free_all(&libc_allocator);
+}
+
+void test_jsl_concurrent_str_map_reader_slots(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLConcurrentStrMap map;
+    bool ok = jsl_concurrent_str_map_init(&map, allocator, 1, 2);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLConcurrentStrMapReader readers[3];
+    TEST_BOOL(jsl_concurrent_str_map_reader_register(&map, &readers[0]));
+    TEST_BOOL(jsl_concurrent_str_map_reader_register(&map, &readers[1]));
+    TEST_BOOL(!jsl_concurrent_str_map_reader_register(&map, &readers[2]));
+
+    jsl_concurrent_str_map_reader_unregister(&readers[0]);
+    TEST_BOOL(jsl_concurrent_str_map_read_begin(&readers[0]) == NULL);
+    TEST_BOOL(jsl_concurrent_str_map_reader_register(&map, &readers[2]));
+    TEST_BOOL(jsl_concurrent_str_map_read_begin(&readers[2]) != NULL);
+    jsl_concurrent_str_map_read_end(&readers[2]);
+
+    jsl_concurrent_str_map_reader_unregister(&readers[1]);
+    jsl_concurrent_str_map_reader_unregister(&readers[2]);
+    jsl_concurrent_str_map_free(&map);
+}
+
+void test_jsl_concurrent_str_map_invalid_parameters(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLConcurrentStrMap map;
+    TEST_BOOL(!jsl_concurrent_str_map_init(NULL, allocator, 0, 4));
+    TEST_BOOL(!jsl_concurrent_str_map_init(&map, allocator, 0, 0));
+
+    JSLConcurrentStrMap zeroed = {0};
+    JSLConcurrentStrMapReader reader = {0};
+    TEST_BOOL(!jsl_concurrent_str_map_insert(
+        &zeroed,
+        JSL_CSTR_EXPRESSION("a"), JSL_STRING_LIFETIME_SHORTER,
+        JSL_CSTR_EXPRESSION("b"), JSL_STRING_LIFETIME_SHORTER
+    ));
+    TEST_BOOL(!jsl_concurrent_str_map_delete(&zeroed, JSL_CSTR_EXPRESSION("a")));
+    TEST_BOOL(!jsl_concurrent_str_map_publish(&zeroed));
+    TEST_INT64_EQUAL(jsl_concurrent_str_map_reclaim(&zeroed), (int64_t) -1);
+    TEST_BOOL(!jsl_concurrent_str_map_reader_register(&zeroed, &reader));
+    TEST_BOOL(jsl_concurrent_str_map_read_begin(&reader) == NULL);
+    TEST_BOOL(jsl_concurrent_str_map_read_begin(NULL) == NULL);
+    TEST_BOOL(!jsl_concurrent_str_map_has_key(&reader, JSL_CSTR_EXPRESSION("a")));
+
+    jsl_concurrent_str_map_clear(&zeroed);
+    jsl_concurrent_str_map_read_end(&reader);
+    jsl_concurrent_str_map_reader_unregister(&reader);
+    jsl_concurrent_str_map_free(&zeroed);
+    jsl_concurrent_str_map_free(NULL);
+}
+
+#define THREADED_READER_COUNT 4
+#define THREADED_GENERATIONS 150
+
+typedef struct ThreadedReaderState
+{
+    JSLConcurrentStrMap* map;
+    uint64_t* stop;
+    int64_t reads;
+    int64_t errors;
+} ThreadedReaderState;
+
+static bool parse_generation(JSLImmutableMemory value, int64_t* out_generation)
+{
+    int64_t generation = 0;
+    for (int64_t i = 0; i < value.length; ++i)
+    {
+        generation = generation * 10 + (value.data[i] - '0');
+    }
+    *out_generation = generation;
+    return value.length > 0;
+}
+
+static void threaded_reader_loop(ThreadedReaderState* state)
+{
+    JSLConcurrentStrMapReader reader;
+    if (!jsl_concurrent_str_map_reader_register(state->map, &reader))
+    {
+        ++state->errors;
+        return;
+    }
+
+    int64_t last_generation = 0;
+    char key_buffer[32];
+
+    while (jsl__atomic_load_u64(state->stop) == 0)
+    {
+        const JSLFrozenStrMap* snapshot = jsl_concurrent_str_map_read_begin(&reader);
+
+        JSLImmutableMemory value = {0};
+        int64_t generation = 0;
+        bool ok = jsl_frozen_str_map_get(snapshot, JSL_CSTR_EXPRESSION("generation"), &value)
+            && parse_generation(value, &generation);
+
+        // Every snapshot must be internally consistent: generation N has
+        // exactly the items 0 to N - 1, and generations never go backwards
+        if (ok)
+        {
+            int key_length = snprintf(key_buffer, sizeof(key_buffer), "item-%lld", (long long) (generation - 1));
+            ok = generation >= last_generation
+                && jsl_frozen_str_map_item_count(snapshot) == generation + 1
+                && jsl_frozen_str_map_has_key(
+                    snapshot,
+                    jsl_immutable_memory((const uint8_t*) key_buffer, key_length)
+                );
+            last_generation = generation;
+        }
+
+        jsl_concurrent_str_map_read_end(&reader);
+
+        if (!ok)
+            ++state->errors;
+        ++state->reads;
+    }
+
+    jsl_concurrent_str_map_reader_unregister(&reader);
+}
+
+#if JSL_IS_WINDOWS
+    static DWORD WINAPI threaded_reader_entry(LPVOID arg)
+    {
+        threaded_reader_loop((ThreadedReaderState*) arg);
+        return 0;
+    }
+#else
+    static void* threaded_reader_entry(void* arg)
+    {
+        threaded_reader_loop((ThreadedReaderState*) arg);
+        return NULL;
+    }
+#endif
+
+void test_jsl_concurrent_str_map_threaded_readers(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    JSLConcurrentStrMap map;
+    bool ok = jsl_concurrent_str_map_init(&map, allocator, 0xABCDEF, THREADED_READER_COUNT);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    jsl_concurrent_str_map_insert(
+        &map,
+        JSL_CSTR_EXPRESSION("generation"), JSL_STRING_LIFETIME_SHORTER,
+        JSL_CSTR_EXPRESSION("1"), JSL_STRING_LIFETIME_SHORTER
+    );
+    jsl_concurrent_str_map_insert(
+        &map,
+        JSL_CSTR_EXPRESSION("item-0"), JSL_STRING_LIFETIME_SHORTER,
+        JSL_CSTR_EXPRESSION("0"), JSL_STRING_LIFETIME_SHORTER
+    );
+    jsl_concurrent_str_map_publish(&map);
+
+    uint64_t stop = 0;
+    ThreadedReaderState states[THREADED_READER_COUNT];
+
+    #if JSL_IS_WINDOWS
+        HANDLE threads[THREADED_READER_COUNT];
+    #else
+        pthread_t threads[THREADED_READER_COUNT];
+    #endif
+
+    for (int32_t i = 0; i < THREADED_READER_COUNT; ++i)
+    {
+        states[i] = (ThreadedReaderState) { .map = &map, .stop = &stop };
+        #if JSL_IS_WINDOWS
+            threads[i] = CreateThread(NULL, 0, threaded_reader_entry, &states[i], 0, NULL);
+        #else
+            pthread_create(&threads[i], NULL, threaded_reader_entry, &states[i]);
+        #endif
+    }
+
+    char key_buffer[32];
+    char value_buffer[32];
+    int32_t failed_publishes = 0;
+
+    for (int32_t generation = 2; generation <= THREADED_GENERATIONS; ++generation)
+    {
+        int key_length = snprintf(key_buffer, sizeof(key_buffer), "item-%d", generation - 1);
+        int value_length = snprintf(value_buffer, sizeof(value_buffer), "%d", generation);
+
+        jsl_concurrent_str_map_insert(
+            &map,
+            jsl_immutable_memory((const uint8_t*) key_buffer, key_length), JSL_STRING_LIFETIME_SHORTER,
+            JSL_CSTR_EXPRESSION("x"), JSL_STRING_LIFETIME_SHORTER
+        );
+        jsl_concurrent_str_map_insert(
+            &map,
+            JSL_CSTR_EXPRESSION("generation"), JSL_STRING_LIFETIME_SHORTER,
+            jsl_immutable_memory((const uint8_t*) value_buffer, value_length), JSL_STRING_LIFETIME_SHORTER
+        );
+
+        if (!jsl_concurrent_str_map_publish(&map))
+            ++failed_publishes;
+    }
+
+    jsl__atomic_store_u64(&stop, 1);
+
+    int64_t total_reads = 0;
+    int64_t total_errors = 0;
+    for (int32_t i = 0; i < THREADED_READER_COUNT; ++i)
+    {
+        #if JSL_IS_WINDOWS
+            WaitForSingleObject(threads[i], INFINITE);
+            CloseHandle(threads[i]);
+        #else
+            pthread_join(threads[i], NULL);
+        #endif
+
+        total_reads += states[i].reads;
+        total_errors += states[i].errors;
+    }
+
+    TEST_INT32_EQUAL(failed_publishes, 0);
+    TEST_INT64_EQUAL(total_errors, (int64_t) 0);
+    TEST_BOOL(total_reads > 0);
+
+    // All readers are gone so every retired version can be freed
+    TEST_INT64_EQUAL(jsl_concurrent_str_map_reclaim(&map), (int64_t) 0);
+
+    jsl_concurrent_str_map_free(&map);
+    jsl_libc_allocator_free_all(&libc_allocator);
+}
+
+#undef THREADED_READER_COUNT
+#undef THREADED_GENERATIONS
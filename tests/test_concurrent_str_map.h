@@ -0,0 +1,10 @@
+#ifndef TEST_CONCURRENT_STR_MAP_H
+#define TEST_CONCURRENT_STR_MAP_H
+
+void test_jsl_concurrent_str_map_publish_visibility(void);
+void test_jsl_concurrent_str_map_deferred_reclaim(void);
+void test_jsl_concurrent_str_map_reader_slots(void);
+void test_jsl_concurrent_str_map_invalid_parameters(void);
+void test_jsl_concurrent_str_map_threaded_readers(void);
+
+#endif
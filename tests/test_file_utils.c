@@ -33,6 +33,7 @@
 #include "jsl/core.h"
 #include "jsl/allocator.h"
 #include "jsl/allocator_arena.h"
+#include "jsl/allocator_libc.h"
 #include "jsl/os.h"
 
 #if JSL_IS_LINUX
@@ -124,6 +125,171 @@ void test_jsl_get_file_size(void)
     TEST_INT64_EQUAL(size, (int64_t) expected_size);
 }
 
+void test_jsl_map_file(void)
+{
+    #if JSL_IS_WINDOWS
+        char* path = "tests\\example.txt";
+    #else
+        char* path = "./tests/example.txt";
+    #endif
+
+    char stack_buffer[4*1024] = {0};
+    int64_t file_size;
+
+    // Load the comparison using libc
+    {
+        FILE* file = fopen(path, "rb");
+        fseek(file, 0, SEEK_END);
+        file_size = ftell(file);
+        TEST_BOOL(file_size > 0);
+        rewind(file);
+
+        size_t res = fread(stack_buffer, (size_t) file_size, 1, file);
+        assert(res > 0);
+        fclose(file);
+    }
+
+    JSLMappedFile mapping;
+    int32_t os_error = 0;
+    JSLMapFileResultEnum res = jsl_map_file(
+        jsl_cstr_to_memory(path),
+        &mapping,
+        &os_error
+    );
+
+    TEST_INT32_EQUAL(res, JSL_MAP_FILE_SUCCESS);
+    if (res != JSL_MAP_FILE_SUCCESS)
+        return;
+
+    TEST_INT64_EQUAL(mapping.contents.length, file_size);
+    TEST_BUFFERS_EQUAL(stack_buffer, mapping.contents.data, (size_t) file_size);
+
+    TEST_BOOL(jsl_unmap_file(&mapping));
+    TEST_POINTERS_EQUAL(mapping.contents.data, NULL);
+    TEST_BOOL(!jsl_unmap_file(&mapping));
+}
+
+void test_jsl_map_file_bad_parameters(void)
+{
+    JSLMappedFile mapping;
+
+    JSLMapFileResultEnum res = jsl_map_file(jsl_cstr_to_memory(NULL), &mapping, NULL);
+    TEST_INT32_EQUAL(res, JSL_MAP_FILE_BAD_PARAMETERS);
+
+    res = jsl_map_file(JSL_CSTR_EXPRESSION("./tests/example.txt"), NULL, NULL);
+    TEST_INT32_EQUAL(res, JSL_MAP_FILE_BAD_PARAMETERS);
+
+    int32_t os_error = 0;
+    res = jsl_map_file(
+        JSL_CSTR_EXPRESSION("./tests/does_not_exist_map_file_xyz.txt"),
+        &mapping,
+        &os_error
+    );
+    TEST_INT32_EQUAL(res, JSL_MAP_FILE_COULD_NOT_OPEN);
+    TEST_BOOL(os_error != 0);
+
+    TEST_BOOL(!jsl_unmap_file(NULL));
+}
+
+void test_jsl_map_file_advise(void)
+{
+    JSLMappedFile mapping;
+    JSLMapFileResultEnum res = jsl_map_file(
+        JSL_CSTR_EXPRESSION("./tests/example.txt"),
+        &mapping,
+        NULL
+    );
+    TEST_INT32_EQUAL(res, JSL_MAP_FILE_SUCCESS);
+    if (res != JSL_MAP_FILE_SUCCESS)
+        return;
+
+    TEST_BOOL(jsl_map_file_advise(&mapping, JSL_MAP_FILE_HINT_SEQUENTIAL));
+    TEST_BOOL(jsl_map_file_advise(
+        &mapping,
+        JSL_MAP_FILE_HINT_SEQUENTIAL | JSL_MAP_FILE_HINT_WILL_NEED
+    ));
+    // Accepted even where it has no effect
+    TEST_BOOL(jsl_map_file_advise(&mapping, JSL_MAP_FILE_HINT_HUGE_PAGES));
+    TEST_BOOL(jsl_map_file_advise(&mapping, 0));
+
+    // Advice never changes the contents
+    TEST_BOOL(mapping.contents.length > 0);
+    TEST_BOOL(mapping.contents.data != NULL);
+
+    TEST_BOOL(jsl_unmap_file(&mapping));
+
+    TEST_BOOL(!jsl_map_file_advise(&mapping, JSL_MAP_FILE_HINT_SEQUENTIAL));
+    TEST_BOOL(!jsl_map_file_advise(NULL, JSL_MAP_FILE_HINT_SEQUENTIAL));
+}
+
+void test_jsl_map_file_or_load(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    // Regular files are mapped, not loaded
+    JSLMappedFile mapping;
+    JSLMapFileResultEnum res = jsl_map_file_or_load(
+        allocator,
+        JSL_CSTR_EXPRESSION("./tests/example.txt"),
+        &mapping,
+        NULL
+    );
+    TEST_INT32_EQUAL(res, JSL_MAP_FILE_SUCCESS);
+    TEST_BOOL(!mapping.is_loaded);
+    TEST_BOOL(mapping.contents.length > 0);
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+    TEST_BOOL(jsl_unmap_file(&mapping));
+
+    int32_t os_error = 0;
+    res = jsl_map_file_or_load(
+        allocator,
+        JSL_CSTR_EXPRESSION("./tests/does_not_exist_map_file_xyz.txt"),
+        &mapping,
+        &os_error
+    );
+    TEST_INT32_EQUAL(res, JSL_MAP_FILE_COULD_NOT_OPEN);
+    TEST_BOOL(os_error != 0);
+
+    res = jsl_map_file_or_load(allocator, jsl_cstr_to_memory(NULL), &mapping, NULL);
+    TEST_INT32_EQUAL(res, JSL_MAP_FILE_BAD_PARAMETERS);
+
+    #if JSL_IS_LINUX
+        // sysfs files report a size but can't be mapped
+        const char* sysfs_path = "/sys/kernel/mm/transparent_hugepage/enabled";
+        JSLMappedFile sysfs_mapping;
+        int32_t sysfs_error = 0;
+        JSLMapFileResultEnum map_res = jsl_map_file(
+            jsl_cstr_to_memory(sysfs_path),
+            &sysfs_mapping,
+            &sysfs_error
+        );
+
+        if (map_res == JSL_MAP_FILE_COULD_NOT_MAP)
+        {
+            res = jsl_map_file_or_load(
+                allocator,
+                jsl_cstr_to_memory(sysfs_path),
+                &sysfs_mapping,
+                NULL
+            );
+            TEST_INT32_EQUAL(res, JSL_MAP_FILE_SUCCESS);
+            TEST_BOOL(sysfs_mapping.is_loaded);
+            TEST_BOOL(sysfs_mapping.contents.length > 0);
+            TEST_BOOL(jsl_map_file_advise(&sysfs_mapping, JSL_MAP_FILE_HINT_WILL_NEED));
+            TEST_BOOL(jsl_unmap_file(&sysfs_mapping));
+        }
+        else if (map_res == JSL_MAP_FILE_SUCCESS)
+        {
+            jsl_unmap_file(&sysfs_mapping);
+        }
+    #endif
+
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+}
+
 void test_jsl_load_file_contents_buffer(void)
 {
     char* path = "./tests/example.txt";
@@ -155,6 +321,235 @@ void test_jsl_load_file_contents_buffer(void)
     TEST_BOOL(memcmp(stack_buffer, buffer.data, (size_t) file_size) == 0);
 }
 
+void test_jsl_write_file_contents_vectored(void)
+{
+    const char* path = "./tests/tmp_write_file_vectored.txt";
+
+    // More parts than fit in one writev batch
+    char numbers[100][4];
+    JSLImmutableMemory parts[104];
+    int64_t part_count = 0;
+    parts[part_count++] = JSL_CSTR_EXPRESSION("Hello");
+    parts[part_count++] = jsl_immutable_memory(NULL, 0);
+    parts[part_count++] = JSL_CSTR_EXPRESSION(", World\n");
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        snprintf(numbers[i], sizeof(numbers[i]), "%02d,", i);
+        parts[part_count++] = jsl_immutable_memory((const uint8_t*) numbers[i], 3);
+    }
+    parts[part_count++] = jsl_immutable_memory(NULL, 0);
+
+    char expected[512] = {0};
+    int64_t expected_length = 0;
+    for (int64_t i = 0; i < part_count; ++i)
+    {
+        if (parts[i].length > 0)
+            memcpy(expected + expected_length, parts[i].data, (size_t) parts[i].length);
+        expected_length += parts[i].length;
+    }
+
+    int64_t bytes_written = 0;
+    int32_t os_error = 0;
+    JSLWriteFileResultEnum res = jsl_write_file_contents_vectored(
+        parts,
+        part_count,
+        jsl_cstr_to_memory(path),
+        &bytes_written,
+        &os_error
+    );
+    TEST_INT32_EQUAL(res, JSL_FILE_WRITE_SUCCESS);
+    TEST_INT64_EQUAL(bytes_written, expected_length);
+
+    JSLArena arena;
+    jsl_arena_init(&arena, malloc(JSL_KILOBYTES(4)), JSL_KILOBYTES(4));
+    JSLAllocatorInterface allocator;
+    jsl_arena_get_allocator_interface(&allocator, &arena);
+
+    JSLImmutableMemory contents = {0};
+    JSLLoadFileResultEnum load_res = jsl_load_file_contents(
+        allocator,
+        jsl_cstr_to_memory(path),
+        &contents,
+        NULL
+    );
+    TEST_INT32_EQUAL(load_res, JSL_FILE_LOAD_SUCCESS);
+    TEST_INT64_EQUAL(contents.length, expected_length);
+    if (contents.length == expected_length)
+        TEST_BUFFERS_EQUAL(expected, contents.data, (size_t) expected_length);
+
+    // No parts at all leaves an empty file
+    res = jsl_write_file_contents_vectored(
+        NULL,
+        0,
+        jsl_cstr_to_memory(path),
+        &bytes_written,
+        NULL
+    );
+    TEST_INT32_EQUAL(res, JSL_FILE_WRITE_SUCCESS);
+    TEST_INT64_EQUAL(bytes_written, 0);
+
+    int64_t size = -1;
+    jsl_get_file_size(jsl_cstr_to_memory(path), &size, NULL);
+    TEST_INT64_EQUAL(size, 0);
+
+    jsl_delete_file(jsl_cstr_to_memory(path), NULL);
+    free(arena.start);
+}
+
+void test_jsl_write_file_contents_vectored_bad_parameters(void)
+{
+    JSLImmutableMemory path = JSL_CSTR_EXPRESSION("./tests/tmp_write_file_vectored_bad.txt");
+    JSLImmutableMemory parts[2] = {
+        JSL_CSTR_EXPRESSION("valid"),
+        JSL_CSTR_EXPRESSION("also valid")
+    };
+
+    JSLWriteFileResultEnum res = jsl_write_file_contents_vectored(
+        NULL, 2, path, NULL, NULL
+    );
+    TEST_INT32_EQUAL(res, JSL_FILE_WRITE_BAD_PARAMETERS);
+
+    res = jsl_write_file_contents_vectored(parts, -1, path, NULL, NULL);
+    TEST_INT32_EQUAL(res, JSL_FILE_WRITE_BAD_PARAMETERS);
+
+    res = jsl_write_file_contents_vectored(
+        parts, 2, jsl_cstr_to_memory(NULL), NULL, NULL
+    );
+    TEST_INT32_EQUAL(res, JSL_FILE_WRITE_BAD_PARAMETERS);
+
+    parts[1] = jsl_immutable_memory(NULL, 4);
+    res = jsl_write_file_contents_vectored(parts, 2, path, NULL, NULL);
+    TEST_INT32_EQUAL(res, JSL_FILE_WRITE_BAD_PARAMETERS);
+
+    int32_t os_error = 0;
+    res = jsl_write_file_contents_vectored(
+        parts,
+        1,
+        JSL_CSTR_EXPRESSION("./tests/does_not_exist_dir_xyz/out.txt"),
+        NULL,
+        &os_error
+    );
+    TEST_INT32_EQUAL(res, JSL_FILE_WRITE_COULD_NOT_OPEN);
+    TEST_BOOL(os_error != 0);
+}
+
+void test_jsl_file_writer(void)
+{
+    FILE* file = tmpfile();
+    TEST_BOOL(file != NULL);
+    if (file == NULL)
+        return;
+
+    uint8_t staging_buffer[32];
+    JSLFileWriter writer;
+    TEST_BOOL(jsl_file_writer_init(
+        &writer,
+        (int32_t) fileno(file),
+        jsl_mutable_memory(staging_buffer, sizeof(staging_buffer))
+    ));
+
+    char expected[1024] = {0};
+    int64_t expected_length = 0;
+    #define APPEND_EXPECTED(str) \
+        memcpy(expected + expected_length, str, strlen(str)); \
+        expected_length += (int64_t) strlen(str)
+
+    TEST_BOOL(jsl_file_writer_queue(&writer, JSL_CSTR_EXPRESSION("queued ")));
+    APPEND_EXPECTED("queued ");
+
+    // The copies are reused right away, only the staging buffer keeps them
+    char scratch[16];
+    for (int32_t i = 0; i < 20; ++i)
+    {
+        int32_t length = snprintf(scratch, sizeof(scratch), "%d ", i);
+        TEST_BOOL(jsl_file_writer_write(
+            &writer,
+            jsl_immutable_memory((const uint8_t*) scratch, length)
+        ));
+        APPEND_EXPECTED(scratch);
+    }
+
+    // Bigger than the staging buffer
+    const char* large = "this string is longer than the staging buffer ";
+    TEST_BOOL(jsl_file_writer_write(&writer, jsl_cstr_to_memory(large)));
+    APPEND_EXPECTED(large);
+
+    // More than a full queue of parts
+    for (int32_t i = 0; i < JSL_FILE_WRITER_MAX_PARTS * 2 + 3; ++i)
+    {
+        TEST_BOOL(jsl_file_writer_queue(&writer, JSL_CSTR_EXPRESSION("q")));
+        TEST_BOOL(jsl_file_writer_write(&writer, JSL_CSTR_EXPRESSION("w")));
+        APPEND_EXPECTED("qw");
+    }
+
+    JSLOutputSink sink = jsl_file_writer_output_sink(&writer);
+    jsl_format_sink(sink, JSL_CSTR_EXPRESSION(" %s %d"), "formatted", 42);
+    APPEND_EXPECTED(" formatted 42");
+
+    #undef APPEND_EXPECTED
+
+    int32_t os_error = 0;
+    TEST_BOOL(jsl_file_writer_flush(&writer, &os_error));
+    TEST_INT32_EQUAL(os_error, 0);
+
+    TEST_BOOL(fseek(file, 0, SEEK_SET) == 0);
+    char buffer[1024] = {0};
+    size_t read = fread(buffer, 1, sizeof(buffer), file);
+    TEST_INT64_EQUAL((int64_t) read, expected_length);
+    TEST_BUFFERS_EQUAL(expected, buffer, (size_t) expected_length);
+
+    fclose(file);
+}
+
+void test_jsl_file_writer_write_failure(void)
+{
+    // Writing to a descriptor that's only open for reading fails
+    FILE* file = fopen("./tests/example.txt", "rb");
+    TEST_BOOL(file != NULL);
+    if (file == NULL)
+        return;
+
+    uint8_t staging_buffer[16];
+    JSLFileWriter writer;
+    TEST_BOOL(jsl_file_writer_init(
+        &writer,
+        (int32_t) fileno(file),
+        jsl_mutable_memory(staging_buffer, sizeof(staging_buffer))
+    ));
+
+    TEST_BOOL(jsl_file_writer_write(&writer, JSL_CSTR_EXPRESSION("hello")));
+
+    int32_t os_error = 0;
+    TEST_BOOL(!jsl_file_writer_flush(&writer, &os_error));
+    TEST_BOOL(os_error != 0);
+
+    // The error sticks
+    TEST_BOOL(!jsl_file_writer_write(&writer, JSL_CSTR_EXPRESSION("hello")));
+    TEST_BOOL(!jsl_file_writer_flush(&writer, NULL));
+
+    fclose(file);
+}
+
+void test_jsl_file_writer_bad_parameters(void)
+{
+    uint8_t staging_buffer[16];
+    JSLMutableMemory staging = jsl_mutable_memory(staging_buffer, sizeof(staging_buffer));
+    JSLFileWriter writer;
+
+    TEST_BOOL(!jsl_file_writer_init(NULL, 1, staging));
+    TEST_BOOL(!jsl_file_writer_init(&writer, -1, staging));
+    TEST_BOOL(!jsl_file_writer_init(&writer, 1, jsl_mutable_memory(NULL, 16)));
+
+    TEST_BOOL(!jsl_file_writer_queue(NULL, JSL_CSTR_EXPRESSION("a")));
+    TEST_BOOL(!jsl_file_writer_write(NULL, JSL_CSTR_EXPRESSION("a")));
+    TEST_BOOL(!jsl_file_writer_flush(NULL, NULL));
+
+    TEST_BOOL(jsl_file_writer_init(&writer, 1, staging));
+    TEST_BOOL(!jsl_file_writer_queue(&writer, jsl_immutable_memory(NULL, 4)));
+    TEST_BOOL(!jsl_file_writer_write(&writer, jsl_immutable_memory(NULL, 4)));
+    TEST_BOOL(jsl_file_writer_flush(&writer, NULL));
+}
+
 
 
 #if defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
@@ -4,11 +4,20 @@
 void test_jsl_load_file_contents(void);
 void test_jsl_get_file_size(void);
 void test_jsl_load_file_contents_buffer(void);
+void test_jsl_map_file(void);
+void test_jsl_map_file_bad_parameters(void);
+void test_jsl_map_file_advise(void);
+void test_jsl_map_file_or_load(void);
 void test_jsl_format_file_formats_and_writes_output(void);
 void test_jsl_format_file_accepts_empty_format(void);
 void test_jsl_format_file_null_out_parameter(void);
 void test_jsl_format_file_null_format_pointer(void);
 void test_jsl_format_file_negative_length(void);
+void test_jsl_write_file_contents_vectored(void);
+void test_jsl_write_file_contents_vectored_bad_parameters(void);
+void test_jsl_file_writer(void);
+void test_jsl_file_writer_write_failure(void);
+void test_jsl_file_writer_bad_parameters(void);
 void test_jsl_format_file_write_failure(void);
 void test_jsl_make_directory_bad_parameters(void);
 void test_jsl_make_directory_creates_directory(void);
@@ -0,0 +1,765 @@
+/**
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "jsl/core.h"
+#include "jsl/allocator.h"
+#include "jsl/allocator_infinite_arena.h"
+#include "jsl/allocator_libc.h"
+#include "jsl/str_to_str_map.h"
+#include "jsl/str_set.h"
+#include "jsl/frozen_str_map.h"
+#include "jsl/frozen_str_map_file.h"
+#include "jsl/os.h"
+
+#include "minctest.h"
+#include "test_frozen_str_map.h"
+
+extern JSLInfiniteArena global_arena;
+
+void test_jsl_str_to_str_map_freeze_basic(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrToStrMap map;
+    bool ok = jsl_str_to_str_map_init(&map, allocator, 0x1234);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    jsl_str_to_str_map_insert(
+        &map,
+        JSL_CSTR_EXPRESSION("alpha"), JSL_STRING_LIFETIME_LONGER,
+        JSL_CSTR_EXPRESSION("one"), JSL_STRING_LIFETIME_LONGER
+    );
+    jsl_str_to_str_map_insert(
+        &map,
+        JSL_CSTR_EXPRESSION("beta"), JSL_STRING_LIFETIME_LONGER,
+        JSL_CSTR_EXPRESSION("two"), JSL_STRING_LIFETIME_LONGER
+    );
+    jsl_str_to_str_map_insert(
+        &map,
+        JSL_CSTR_EXPRESSION("a much longer key that does not fit in sso"), JSL_STRING_LIFETIME_SHORTER,
+        JSL_CSTR_EXPRESSION("a much longer value that does not fit in sso"), JSL_STRING_LIFETIME_SHORTER
+    );
+
+    JSLFrozenStrMap frozen;
+    ok = jsl_str_to_str_map_freeze(&map, allocator, &frozen);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    TEST_INT64_EQUAL(jsl_frozen_str_map_item_count(&frozen), (int64_t) 3);
+
+    JSLImmutableMemory value = {0};
+    TEST_BOOL(jsl_frozen_str_map_get(&frozen, JSL_CSTR_EXPRESSION("alpha"), &value));
+    TEST_BOOL(jsl_memory_compare(value, JSL_CSTR_EXPRESSION("one")));
+
+    TEST_BOOL(jsl_frozen_str_map_get(&frozen, JSL_CSTR_EXPRESSION("beta"), &value));
+    TEST_BOOL(jsl_memory_compare(value, JSL_CSTR_EXPRESSION("two")));
+
+    TEST_BOOL(jsl_frozen_str_map_get(
+        &frozen,
+        JSL_CSTR_EXPRESSION("a much longer key that does not fit in sso"),
+        &value
+    ));
+    TEST_BOOL(jsl_memory_compare(value, JSL_CSTR_EXPRESSION("a much longer value that does not fit in sso")));
+
+    TEST_BOOL(jsl_frozen_str_map_has_key(&frozen, JSL_CSTR_EXPRESSION("alpha")));
+    TEST_BOOL(!jsl_frozen_str_map_has_key(&frozen, JSL_CSTR_EXPRESSION("gamma")));
+    TEST_BOOL(!jsl_frozen_str_map_has_key(&frozen, JSL_CSTR_EXPRESSION("alph")));
+
+    TEST_BOOL(!jsl_frozen_str_map_get(&frozen, JSL_CSTR_EXPRESSION("gamma"), &value));
+    TEST_POINTERS_EQUAL(value.data, NULL);
+    TEST_INT64_EQUAL(value.length, (int64_t) 0);
+}
+
+void test_jsl_str_to_str_map_freeze_many_keys(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrToStrMap map;
+    bool ok = jsl_str_to_str_map_init2(&map, allocator, 0xBEEF, 4096, 0.75f);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    const int32_t key_count = 5000;
+
+    for (int32_t i = 0; i < key_count; ++i)
+    {
+        JSLImmutableMemory key = jsl_format(allocator, JSL_CSTR_EXPRESSION("key-%d"), i);
+        JSLImmutableMemory value = jsl_format(allocator, JSL_CSTR_EXPRESSION("value-%d"), i * 7);
+        jsl_str_to_str_map_insert(
+            &map,
+            key, JSL_STRING_LIFETIME_LONGER,
+            value, JSL_STRING_LIFETIME_LONGER
+        );
+    }
+
+    JSLFrozenStrMap frozen;
+    ok = jsl_str_to_str_map_freeze(&map, allocator, &frozen);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    TEST_INT64_EQUAL(jsl_frozen_str_map_item_count(&frozen), (int64_t) key_count);
+
+    int32_t mismatches = 0;
+    for (int32_t i = 0; i < key_count; ++i)
+    {
+        JSLImmutableMemory key = jsl_format(allocator, JSL_CSTR_EXPRESSION("key-%d"), i);
+        JSLImmutableMemory expected = jsl_format(allocator, JSL_CSTR_EXPRESSION("value-%d"), i * 7);
+        JSLImmutableMemory value = {0};
+
+        bool found = jsl_frozen_str_map_get(&frozen, key, &value);
+        if (!found || !jsl_memory_compare(value, expected))
+            ++mismatches;
+    }
+    TEST_INT32_EQUAL(mismatches, 0);
+
+    int32_t false_positives = 0;
+    for (int32_t i = key_count; i < key_count * 2; ++i)
+    {
+        JSLImmutableMemory key = jsl_format(allocator, JSL_CSTR_EXPRESSION("key-%d"), i);
+        if (jsl_frozen_str_map_has_key(&frozen, key))
+            ++false_positives;
+    }
+    TEST_INT32_EQUAL(false_positives, 0);
+}
+
+void test_jsl_str_to_str_map_freeze_empty_and_binary(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrToStrMap map;
+    bool ok = jsl_str_to_str_map_init(&map, allocator, 99);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    static const uint8_t binary_key_data[] = {0x00, 0xFF, 0x10, 0x00};
+    static const uint8_t binary_value_data[] = {0x7F, 0x00, 0x01};
+    JSLImmutableMemory binary_key = jsl_immutable_memory(binary_key_data, sizeof(binary_key_data));
+    JSLImmutableMemory binary_value = jsl_immutable_memory(binary_value_data, sizeof(binary_value_data));
+
+    jsl_str_to_str_map_insert(
+        &map,
+        JSL_CSTR_EXPRESSION(""), JSL_STRING_LIFETIME_LONGER,
+        JSL_CSTR_EXPRESSION("empty key"), JSL_STRING_LIFETIME_LONGER
+    );
+    jsl_str_to_str_map_insert(
+        &map,
+        JSL_CSTR_EXPRESSION("empty value"), JSL_STRING_LIFETIME_LONGER,
+        JSL_CSTR_EXPRESSION(""), JSL_STRING_LIFETIME_LONGER
+    );
+    jsl_str_to_str_map_insert(
+        &map,
+        binary_key, JSL_STRING_LIFETIME_SHORTER,
+        binary_value, JSL_STRING_LIFETIME_SHORTER
+    );
+
+    JSLFrozenStrMap frozen;
+    ok = jsl_str_to_str_map_freeze(&map, allocator, &frozen);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLImmutableMemory value = {0};
+    TEST_BOOL(jsl_frozen_str_map_get(&frozen, JSL_CSTR_EXPRESSION(""), &value));
+    TEST_BOOL(jsl_memory_compare(value, JSL_CSTR_EXPRESSION("empty key")));
+
+    TEST_BOOL(jsl_frozen_str_map_get(&frozen, JSL_CSTR_EXPRESSION("empty value"), &value));
+    TEST_INT64_EQUAL(value.length, (int64_t) 0);
+
+    TEST_BOOL(jsl_frozen_str_map_get(&frozen, binary_key, &value));
+    TEST_BOOL(jsl_memory_compare(value, binary_value));
+
+    JSLImmutableMemory truncated_key = jsl_immutable_memory(binary_key_data, 2);
+    TEST_BOOL(!jsl_frozen_str_map_has_key(&frozen, truncated_key));
+}
+
+void test_jsl_str_to_str_map_freeze_outlives_source(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    JSLStrToStrMap map;
+    bool ok = jsl_str_to_str_map_init(&map, allocator, 7);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    char key_buffer[32];
+    char value_buffer[32];
+
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        snprintf(key_buffer, sizeof(key_buffer), "transient-key-%d", i);
+        snprintf(value_buffer, sizeof(value_buffer), "transient-value-%d", i);
+        jsl_str_to_str_map_insert(
+            &map,
+            jsl_cstr_to_memory(key_buffer), JSL_STRING_LIFETIME_SHORTER,
+            jsl_cstr_to_memory(value_buffer), JSL_STRING_LIFETIME_SHORTER
+        );
+    }
+
+    JSLFrozenStrMap frozen;
+    ok = jsl_str_to_str_map_freeze(&map, allocator, &frozen);
+    TEST_BOOL(ok);
+
+    jsl_str_to_str_map_free(&map);
+
+    int32_t mismatches = 0;
+    for (int32_t i = 0; ok && i < 100; ++i)
+    {
+        snprintf(key_buffer, sizeof(key_buffer), "transient-key-%d", i);
+        snprintf(value_buffer, sizeof(value_buffer), "transient-value-%d", i);
+
+        JSLImmutableMemory value = {0};
+        bool found = jsl_frozen_str_map_get(&frozen, jsl_cstr_to_memory(key_buffer), &value);
+        if (!found || !jsl_memory_compare(value, jsl_cstr_to_memory(value_buffer)))
+            ++mismatches;
+    }
+    TEST_INT32_EQUAL(mismatches, 0);
+
+    jsl_frozen_str_map_free(&frozen);
+    TEST_INT64_EQUAL(jsl_frozen_str_map_item_count(&frozen), (int64_t) -1);
+    TEST_BOOL(!jsl_frozen_str_map_has_key(&frozen, JSL_CSTR_EXPRESSION("transient-key-1")));
+
+    jsl_libc_allocator_free_all(&libc_allocator);
+}
+
+void test_jsl_str_to_str_map_freeze_empty_map(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrToStrMap map;
+    bool ok = jsl_str_to_str_map_init(&map, allocator, 0);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLFrozenStrMap frozen;
+    ok = jsl_str_to_str_map_freeze(&map, allocator, &frozen);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    TEST_INT64_EQUAL(jsl_frozen_str_map_item_count(&frozen), (int64_t) 0);
+    TEST_BOOL(!jsl_frozen_str_map_has_key(&frozen, JSL_CSTR_EXPRESSION("anything")));
+    TEST_BOOL(!jsl_frozen_str_map_has_key(&frozen, JSL_CSTR_EXPRESSION("")));
+
+    JSLFrozenStrIter iter;
+    TEST_BOOL(jsl_frozen_str_map_key_value_iterator_init(&frozen, &iter));
+
+    JSLImmutableMemory key;
+    JSLImmutableMemory value;
+    TEST_BOOL(!jsl_frozen_str_map_key_value_iterator_next(&iter, &key, &value));
+}
+
+void test_jsl_frozen_str_map_iterator_covers_all_pairs(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrToStrMap map;
+    bool ok = jsl_str_to_str_map_init(&map, allocator, 31337);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    #define pair_count 40
+    JSLImmutableMemory keys[pair_count];
+    JSLImmutableMemory values[pair_count];
+    bool seen[pair_count] = {0};
+
+    for (int32_t i = 0; i < pair_count; ++i)
+    {
+        keys[i] = jsl_format(allocator, JSL_CSTR_EXPRESSION("iter-key-%d"), i);
+        values[i] = jsl_format(allocator, JSL_CSTR_EXPRESSION("iter-value-%d"), i);
+        jsl_str_to_str_map_insert(
+            &map,
+            keys[i], JSL_STRING_LIFETIME_LONGER,
+            values[i], JSL_STRING_LIFETIME_LONGER
+        );
+    }
+
+    JSLFrozenStrMap frozen;
+    ok = jsl_str_to_str_map_freeze(&map, allocator, &frozen);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLFrozenStrIter iter;
+    TEST_BOOL(jsl_frozen_str_map_key_value_iterator_init(&frozen, &iter));
+
+    int32_t count = 0;
+    JSLImmutableMemory key;
+    JSLImmutableMemory value;
+    while (jsl_frozen_str_map_key_value_iterator_next(&iter, &key, &value))
+    {
+        for (int32_t i = 0; i < pair_count; ++i)
+        {
+            if (jsl_memory_compare(key, keys[i]))
+            {
+                TEST_BOOL(!seen[i]);
+                TEST_BOOL(jsl_memory_compare(value, values[i]));
+                seen[i] = true;
+            }
+        }
+        ++count;
+    }
+
+    TEST_INT32_EQUAL(count, pair_count);
+    for (int32_t i = 0; i < pair_count; ++i)
+    {
+        TEST_BOOL(seen[i]);
+    }
+
+    #undef pair_count
+}
+
+void test_jsl_frozen_str_map_invalid_parameters(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrToStrMap uninitialized_map = {0};
+    JSLFrozenStrMap frozen = {0};
+
+    TEST_BOOL(!jsl_str_to_str_map_freeze(NULL, allocator, &frozen));
+    TEST_BOOL(!jsl_str_to_str_map_freeze(&uninitialized_map, allocator, &frozen));
+
+    JSLStrToStrMap map;
+    bool ok = jsl_str_to_str_map_init(&map, allocator, 1);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    TEST_BOOL(!jsl_str_to_str_map_freeze(&map, allocator, NULL));
+
+    TEST_INT64_EQUAL(jsl_frozen_str_map_item_count(NULL), (int64_t) -1);
+    TEST_INT64_EQUAL(jsl_frozen_str_map_item_count(&frozen), (int64_t) -1);
+    TEST_BOOL(!jsl_frozen_str_map_has_key(&frozen, JSL_CSTR_EXPRESSION("key")));
+
+    JSLImmutableMemory value = {0};
+    TEST_BOOL(!jsl_frozen_str_map_get(&frozen, JSL_CSTR_EXPRESSION("key"), &value));
+
+    ok = jsl_str_to_str_map_freeze(&map, allocator, &frozen);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLImmutableMemory null_key = {0};
+    TEST_BOOL(!jsl_frozen_str_map_has_key(&frozen, null_key));
+    TEST_BOOL(!jsl_frozen_str_map_get(&frozen, JSL_CSTR_EXPRESSION("key"), NULL));
+
+    JSLFrozenStrIter iter;
+    TEST_BOOL(!jsl_frozen_str_map_key_value_iterator_init(NULL, &iter));
+    TEST_BOOL(!jsl_frozen_str_map_key_value_iterator_init(&frozen, NULL));
+
+    // A map iterator must not be usable through the set API
+    JSLImmutableMemory key;
+    TEST_BOOL(jsl_frozen_str_map_key_value_iterator_init(&frozen, &iter));
+    TEST_BOOL(!jsl_frozen_str_set_iterator_next(&iter, &key));
+}
+
+void test_jsl_str_set_freeze_basic(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrSet set;
+    bool ok = jsl_str_set_init(&set, allocator, 0xAAAA);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    jsl_str_set_insert(&set, JSL_CSTR_EXPRESSION("red"), JSL_STRING_LIFETIME_LONGER);
+    jsl_str_set_insert(&set, JSL_CSTR_EXPRESSION("green"), JSL_STRING_LIFETIME_SHORTER);
+    jsl_str_set_insert(&set, JSL_CSTR_EXPRESSION(""), JSL_STRING_LIFETIME_LONGER);
+    jsl_str_set_insert(
+        &set,
+        JSL_CSTR_EXPRESSION("a set value long enough to skip the small string buffer"),
+        JSL_STRING_LIFETIME_SHORTER
+    );
+
+    JSLFrozenStrSet frozen;
+    ok = jsl_str_set_freeze(&set, allocator, &frozen);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    TEST_INT64_EQUAL(jsl_frozen_str_set_item_count(&frozen), (int64_t) 4);
+    TEST_BOOL(jsl_frozen_str_set_has(&frozen, JSL_CSTR_EXPRESSION("red")));
+    TEST_BOOL(jsl_frozen_str_set_has(&frozen, JSL_CSTR_EXPRESSION("green")));
+    TEST_BOOL(jsl_frozen_str_set_has(&frozen, JSL_CSTR_EXPRESSION("")));
+    TEST_BOOL(jsl_frozen_str_set_has(
+        &frozen,
+        JSL_CSTR_EXPRESSION("a set value long enough to skip the small string buffer")
+    ));
+    TEST_BOOL(!jsl_frozen_str_set_has(&frozen, JSL_CSTR_EXPRESSION("blue")));
+
+    TEST_BOOL(!jsl_str_set_freeze(NULL, allocator, &frozen));
+    TEST_INT64_EQUAL(jsl_frozen_str_set_item_count(NULL), (int64_t) -1);
+
+    jsl_frozen_str_set_free(&frozen);
+    TEST_INT64_EQUAL(jsl_frozen_str_set_item_count(&frozen), (int64_t) -1);
+    TEST_BOOL(!jsl_frozen_str_set_has(&frozen, JSL_CSTR_EXPRESSION("red")));
+}
+
+void test_jsl_str_set_freeze_many_values(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrSet set;
+    bool ok = jsl_str_set_init2(&set, allocator, 42, 8192, 0.75f);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    const int32_t value_count = 6000;
+
+    for (int32_t i = 0; i < value_count; ++i)
+    {
+        JSLImmutableMemory value = jsl_format(allocator, JSL_CSTR_EXPRESSION("member-%d"), i * 2);
+        jsl_str_set_insert(&set, value, JSL_STRING_LIFETIME_LONGER);
+    }
+
+    JSLFrozenStrSet frozen;
+    ok = jsl_str_set_freeze(&set, allocator, &frozen);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    TEST_INT64_EQUAL(jsl_frozen_str_set_item_count(&frozen), (int64_t) value_count);
+
+    int32_t wrong = 0;
+    for (int32_t i = 0; i < value_count * 2; ++i)
+    {
+        JSLImmutableMemory value = jsl_format(allocator, JSL_CSTR_EXPRESSION("member-%d"), i);
+        bool expected = (i % 2) == 0;
+        if (jsl_frozen_str_set_has(&frozen, value) != expected)
+            ++wrong;
+    }
+    TEST_INT32_EQUAL(wrong, 0);
+}
+
+void test_jsl_frozen_str_set_iterator_covers_all_values(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrSet set;
+    bool ok = jsl_str_set_init(&set, allocator, 5);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    #define value_count 25
+    JSLImmutableMemory values[value_count];
+    bool seen[value_count] = {0};
+
+    for (int32_t i = 0; i < value_count; ++i)
+    {
+        values[i] = jsl_format(allocator, JSL_CSTR_EXPRESSION("set-iter-%d"), i);
+        jsl_str_set_insert(&set, values[i], JSL_STRING_LIFETIME_LONGER);
+    }
+
+    JSLFrozenStrSet frozen;
+    ok = jsl_str_set_freeze(&set, allocator, &frozen);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLFrozenStrIter iter;
+    TEST_BOOL(jsl_frozen_str_set_iterator_init(&frozen, &iter));
+
+    int32_t count = 0;
+    JSLImmutableMemory value;
+    while (jsl_frozen_str_set_iterator_next(&iter, &value))
+    {
+        for (int32_t i = 0; i < value_count; ++i)
+        {
+            if (jsl_memory_compare(value, values[i]))
+            {
+                TEST_BOOL(!seen[i]);
+                seen[i] = true;
+            }
+        }
+        ++count;
+    }
+
+    TEST_INT32_EQUAL(count, value_count);
+    for (int32_t i = 0; i < value_count; ++i)
+    {
+        TEST_BOOL(seen[i]);
+    }
+
+    #undef value_count
+}
+
+static bool build_frozen_test_map(
+    JSLAllocatorInterface allocator,
+    int32_t key_count,
+    JSLFrozenStrMap* out_frozen
+)
+{
+    JSLStrToStrMap map;
+    bool ok = jsl_str_to_str_map_init(&map, allocator, 0xC0FFEE);
+
+    for (int32_t i = 0; ok && i < key_count; ++i)
+    {
+        JSLImmutableMemory key = jsl_format(allocator, JSL_CSTR_EXPRESSION("image-key-%d"), i);
+        JSLImmutableMemory value = jsl_format(allocator, JSL_CSTR_EXPRESSION("image-value-%d"), i);
+        ok = jsl_str_to_str_map_insert(
+            &map,
+            key, JSL_STRING_LIFETIME_LONGER,
+            value, JSL_STRING_LIFETIME_LONGER
+        );
+    }
+
+    return ok && jsl_str_to_str_map_freeze(&map, allocator, out_frozen);
+}
+
+static int32_t count_frozen_test_map_mismatches(
+    JSLAllocatorInterface allocator,
+    const JSLFrozenStrMap* frozen,
+    int32_t key_count
+)
+{
+    int32_t mismatches = 0;
+
+    for (int32_t i = 0; i < key_count; ++i)
+    {
+        JSLImmutableMemory key = jsl_format(allocator, JSL_CSTR_EXPRESSION("image-key-%d"), i);
+        JSLImmutableMemory expected = jsl_format(allocator, JSL_CSTR_EXPRESSION("image-value-%d"), i);
+        JSLImmutableMemory value = {0};
+
+        bool found = jsl_frozen_str_map_get(frozen, key, &value);
+        if (!found || !jsl_memory_compare(value, expected))
+            ++mismatches;
+    }
+
+    return mismatches;
+}
+
+void test_jsl_frozen_str_map_image_round_trip(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLFrozenStrMap frozen;
+    bool ok = build_frozen_test_map(allocator, 300, &frozen);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLImmutableMemory image = {0};
+    TEST_BOOL(jsl_frozen_str_map_get_image(&frozen, &image));
+    TEST_BOOL(image.length > 0);
+
+    // Copy the image somewhere else to make sure nothing in it is an
+    // absolute address
+    uint8_t* copy = (uint8_t*) jsl_allocator_interface_alloc(allocator, image.length, 8, false);
+    JSL_MEMCPY(copy, image.data, (size_t) image.length);
+    jsl_frozen_str_map_free(&frozen);
+
+    JSLFrozenStrMap loaded;
+    ok = jsl_frozen_str_map_init_from_image(&loaded, jsl_immutable_memory(copy, image.length));
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    TEST_INT64_EQUAL(jsl_frozen_str_map_item_count(&loaded), (int64_t) 300);
+    TEST_INT32_EQUAL(count_frozen_test_map_mismatches(allocator, &loaded, 300), 0);
+    TEST_BOOL(!jsl_frozen_str_map_has_key(&loaded, JSL_CSTR_EXPRESSION("image-key-300")));
+
+    // A map image is not a set image
+    JSLFrozenStrSet wrong_kind;
+    TEST_BOOL(!jsl_frozen_str_set_init_from_image(&wrong_kind, jsl_immutable_memory(copy, image.length)));
+
+    // Freeing a loaded map must leave the borrowed image alone
+    jsl_frozen_str_map_free(&loaded);
+    ok = jsl_frozen_str_map_init_from_image(&loaded, jsl_immutable_memory(copy, image.length));
+    TEST_BOOL(ok);
+}
+
+void test_jsl_frozen_str_map_image_rejects_corruption(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLFrozenStrMap frozen;
+    bool ok = build_frozen_test_map(allocator, 50, &frozen);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLImmutableMemory image = {0};
+    jsl_frozen_str_map_get_image(&frozen, &image);
+
+    uint8_t* copy = (uint8_t*) jsl_allocator_interface_alloc(allocator, image.length, 8, false);
+    JSLImmutableMemory copy_memory = jsl_immutable_memory(copy, image.length);
+    JSLFrozenStrMap loaded;
+
+    // Flip a bit in the last string byte
+    JSL_MEMCPY(copy, image.data, (size_t) image.length);
+    copy[image.length - 1] ^= 0x01;
+    TEST_BOOL(!jsl_frozen_str_map_init_from_image(&loaded, copy_memory));
+
+    // Flip a bit in the seed
+    JSL_MEMCPY(copy, image.data, (size_t) image.length);
+    copy[16] ^= 0x80;
+    TEST_BOOL(!jsl_frozen_str_map_init_from_image(&loaded, copy_memory));
+
+    // Bad magic
+    JSL_MEMCPY(copy, image.data, (size_t) image.length);
+    copy[0] = 'X';
+    TEST_BOOL(!jsl_frozen_str_map_init_from_image(&loaded, copy_memory));
+
+    // Truncated
+    JSL_MEMCPY(copy, image.data, (size_t) image.length);
+    TEST_BOOL(!jsl_frozen_str_map_init_from_image(&loaded, jsl_immutable_memory(copy, image.length - 1)));
+    TEST_BOOL(!jsl_frozen_str_map_init_from_image(&loaded, jsl_immutable_memory(copy, 8)));
+
+    // Misaligned
+    uint8_t* misaligned = (uint8_t*) jsl_allocator_interface_alloc(allocator, image.length + 1, 8, false);
+    JSL_MEMCPY(misaligned + 1, image.data, (size_t) image.length);
+    TEST_BOOL(!jsl_frozen_str_map_init_from_image(&loaded, jsl_immutable_memory(misaligned + 1, image.length)));
+
+    TEST_BOOL(!jsl_frozen_str_map_init_from_image(NULL, copy_memory));
+    TEST_BOOL(!jsl_frozen_str_map_init_from_image(&loaded, (JSLImmutableMemory) {0}));
+
+    // And the untouched copy still loads
+    TEST_BOOL(jsl_frozen_str_map_init_from_image(&loaded, copy_memory));
+}
+
+void test_jsl_frozen_str_map_file_round_trip(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLImmutableMemory path = JSL_CSTR_EXPRESSION("./tests/tmp_frozen_str_map.img");
+
+    JSLFrozenStrMap frozen;
+    bool ok = build_frozen_test_map(allocator, 1000, &frozen);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLFrozenImageFileResultEnum res = jsl_frozen_str_map_write_file(&frozen, path, NULL);
+    TEST_INT32_EQUAL(res, JSL_FROZEN_IMAGE_FILE_SUCCESS);
+    jsl_frozen_str_map_free(&frozen);
+
+    JSLFrozenStrMap loaded;
+    JSLMappedFile mapping;
+    res = jsl_frozen_str_map_open_file(path, &loaded, &mapping, NULL);
+    TEST_INT32_EQUAL(res, JSL_FROZEN_IMAGE_FILE_SUCCESS);
+
+    if (res == JSL_FROZEN_IMAGE_FILE_SUCCESS)
+    {
+        TEST_INT64_EQUAL(jsl_frozen_str_map_item_count(&loaded), (int64_t) 1000);
+        TEST_INT32_EQUAL(count_frozen_test_map_mismatches(allocator, &loaded, 1000), 0);
+
+        JSLFrozenStrSet wrong_kind;
+        JSLMappedFile wrong_mapping;
+        res = jsl_frozen_str_set_open_file(path, &wrong_kind, &wrong_mapping, NULL);
+        TEST_INT32_EQUAL(res, JSL_FROZEN_IMAGE_FILE_INVALID_IMAGE);
+
+        jsl_frozen_str_map_free(&loaded);
+        TEST_BOOL(jsl_unmap_file(&mapping));
+    }
+
+    res = jsl_frozen_str_map_open_file(
+        JSL_CSTR_EXPRESSION("./tests/tmp_frozen_does_not_exist.img"),
+        &loaded,
+        &mapping,
+        NULL
+    );
+    TEST_INT32_EQUAL(res, JSL_FROZEN_IMAGE_FILE_COULD_NOT_OPEN);
+
+    res = jsl_frozen_str_map_open_file(path, NULL, &mapping, NULL);
+    TEST_INT32_EQUAL(res, JSL_FROZEN_IMAGE_FILE_BAD_PARAMETERS);
+
+    res = jsl_frozen_str_map_write_file(NULL, path, NULL);
+    TEST_INT32_EQUAL(res, JSL_FROZEN_IMAGE_FILE_BAD_PARAMETERS);
+
+    jsl_delete_file(path, NULL);
+}
+
+void test_jsl_frozen_str_set_file_round_trip(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLImmutableMemory path = JSL_CSTR_EXPRESSION("./tests/tmp_frozen_str_set.img");
+
+    JSLStrSet set;
+    bool ok = jsl_str_set_init(&set, allocator, 77);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    for (int32_t i = 0; i < 500; ++i)
+    {
+        JSLImmutableMemory value = jsl_format(allocator, JSL_CSTR_EXPRESSION("image-member-%d"), i);
+        jsl_str_set_insert(&set, value, JSL_STRING_LIFETIME_LONGER);
+    }
+
+    JSLFrozenStrSet frozen;
+    ok = jsl_str_set_freeze(&set, allocator, &frozen);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLFrozenImageFileResultEnum res = jsl_frozen_str_set_write_file(&frozen, path, NULL);
+    TEST_INT32_EQUAL(res, JSL_FROZEN_IMAGE_FILE_SUCCESS);
+
+    JSLFrozenStrSet loaded;
+    JSLMappedFile mapping;
+    res = jsl_frozen_str_set_open_file(path, &loaded, &mapping, NULL);
+    TEST_INT32_EQUAL(res, JSL_FROZEN_IMAGE_FILE_SUCCESS);
+
+    if (res == JSL_FROZEN_IMAGE_FILE_SUCCESS)
+    {
+        TEST_INT64_EQUAL(jsl_frozen_str_set_item_count(&loaded), (int64_t) 500);
+
+        int32_t wrong = 0;
+        for (int32_t i = 0; i < 1000; ++i)
+        {
+            JSLImmutableMemory value = jsl_format(allocator, JSL_CSTR_EXPRESSION("image-member-%d"), i);
+            if (jsl_frozen_str_set_has(&loaded, value) != (i < 500))
+                ++wrong;
+        }
+        TEST_INT32_EQUAL(wrong, 0);
+
+        jsl_frozen_str_set_free(&loaded);
+        TEST_BOOL(jsl_unmap_file(&mapping));
+    }
+
+    jsl_delete_file(path, NULL);
+}
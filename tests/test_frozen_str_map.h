@@ -0,0 +1,19 @@
+#ifndef TEST_FROZEN_STR_MAP_H
+#define TEST_FROZEN_STR_MAP_H
+
+void test_jsl_str_to_str_map_freeze_basic(void);
+void test_jsl_str_to_str_map_freeze_many_keys(void);
+void test_jsl_str_to_str_map_freeze_empty_and_binary(void);
+void test_jsl_str_to_str_map_freeze_outlives_source(void);
+void test_jsl_str_to_str_map_freeze_empty_map(void);
+void test_jsl_frozen_str_map_iterator_covers_all_pairs(void);
+void test_jsl_frozen_str_map_invalid_parameters(void);
+void test_jsl_str_set_freeze_basic(void);
+void test_jsl_str_set_freeze_many_values(void);
+void test_jsl_frozen_str_set_iterator_covers_all_values(void);
+void test_jsl_frozen_str_map_image_round_trip(void);
+void test_jsl_frozen_str_map_image_rejects_corruption(void);
+void test_jsl_frozen_str_map_file_round_trip(void);
+void test_jsl_frozen_str_set_file_round_trip(void);
+
+#endif
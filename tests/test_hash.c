@@ -0,0 +1,275 @@
+/**
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "jsl/core.h"
+#include "jsl/allocator.h"
+#include "jsl/allocator_infinite_arena.h"
+#include "jsl/hash_map_common.h"
+#include "jsl/hash.h"
+
+#include "minctest.h"
+#include "test_hash.h"
+
+extern JSLInfiniteArena global_arena;
+
+#define TEST_HASH_DATA_LENGTH 700
+
+static uint8_t test_hash_data[TEST_HASH_DATA_LENGTH];
+
+static void fill_test_hash_data(void)
+{
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (int64_t i = 0; i < TEST_HASH_DATA_LENGTH; ++i)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        test_hash_data[i] = (uint8_t) (state >> 56);
+    }
+}
+
+void test_jsl_hash_matches_container_hashes(void)
+{
+    fill_test_hash_data();
+
+    for (int64_t length = 0; length <= 300; ++length)
+    {
+        JSLImmutableMemory data = jsl_immutable_memory(test_hash_data, length);
+        TEST_UINT64_EQUAL(
+            jsl_hash_bytes(data, 1234),
+            jsl__rapidhash_withSeed(test_hash_data, (size_t) length, 1234)
+        );
+    }
+
+    uint64_t values[] = { 0, 1, 42, UINT64_MAX, 0x8000000000000000ULL };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+    {
+        TEST_UINT64_EQUAL(jsl_hash_u64(values[i], 99), jsl__murmur3_fmix_u64(values[i], 99));
+    }
+
+    TEST_BOOL(jsl_hash_bytes(JSL_CSTR_EXPRESSION("hello"), 1) != jsl_hash_bytes(JSL_CSTR_EXPRESSION("hello"), 2));
+}
+
+void test_jsl_hash_many_matches_single(void)
+{
+    fill_test_hash_data();
+
+    JSLImmutableMemory keys[64];
+    uint64_t hashes[64];
+
+    // every short length plus a few long ones, at odd offsets
+    for (int64_t i = 0; i < 64; ++i)
+    {
+        int64_t length = i < 40 ? i % 20 : 17 + i * 7;
+        keys[i] = jsl_immutable_memory(test_hash_data + i * 3, length);
+    }
+
+    TEST_BOOL(jsl_hash_many(keys, 64, 555, hashes));
+    for (int64_t i = 0; i < 64; ++i)
+    {
+        TEST_UINT64_EQUAL(hashes[i], jsl_hash_bytes(keys[i], 555));
+    }
+
+    int64_t key_sizes[] = { 1, 3, 4, 8, 12, 16, 17, 24, 40 };
+    for (size_t s = 0; s < sizeof(key_sizes) / sizeof(key_sizes[0]); ++s)
+    {
+        int64_t key_size = key_sizes[s];
+        int64_t count = TEST_HASH_DATA_LENGTH / key_size;
+        count = JSL_MIN(count, (int64_t) 64);
+
+        TEST_BOOL(jsl_hash_many_fixed(test_hash_data, key_size, count, 77, hashes));
+        for (int64_t i = 0; i < count; ++i)
+        {
+            JSLImmutableMemory key = jsl_immutable_memory(test_hash_data + i * key_size, key_size);
+            TEST_UINT64_EQUAL(hashes[i], jsl_hash_bytes(key, 77));
+        }
+    }
+
+    // counts that don't fill a whole vector at the end
+    uint64_t integers[37];
+    for (int64_t i = 0; i < 37; ++i)
+    {
+        integers[i] = (uint64_t) i * 0x0123456789ABCDEFULL;
+    }
+
+    for (int64_t count = 0; count <= 37; ++count)
+    {
+        JSL_MEMSET(hashes, 0, sizeof(hashes));
+        TEST_BOOL(jsl_hash_many_u64(integers, count, 31337, hashes));
+        for (int64_t i = 0; i < count; ++i)
+        {
+            TEST_UINT64_EQUAL(hashes[i], jsl_hash_u64(integers[i], 31337));
+        }
+    }
+
+    // in place
+    uint64_t expected_last = jsl_hash_u64(integers[36], 5);
+    TEST_BOOL(jsl_hash_many_u64(integers, 37, 5, integers));
+    TEST_UINT64_EQUAL(integers[36], expected_last);
+}
+
+void test_jsl_hash_stream_matches_one_shot(void)
+{
+    fill_test_hash_data();
+
+    int64_t chunk_sizes[] = { 1, 3, 16, 111, 112, 113, 500, TEST_HASH_DATA_LENGTH };
+    int64_t lengths[] = { 0, 1, 15, 16, 17, 100, 112, 113, 120, 127, 128, 129, 224, 225, 230, 336, 337, 699, 700 };
+
+    for (size_t c = 0; c < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++c)
+    {
+        for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l)
+        {
+            int64_t length = lengths[l];
+
+            JSLHashStream stream;
+            TEST_BOOL(jsl_hash_stream_init(&stream, 4242));
+
+            int64_t offset = 0;
+            while (offset < length)
+            {
+                int64_t take = JSL_MIN(chunk_sizes[c], length - offset);
+                TEST_BOOL(jsl_hash_stream_update(&stream, jsl_immutable_memory(test_hash_data + offset, take)));
+                offset += take;
+            }
+
+            JSLImmutableMemory all = jsl_immutable_memory(test_hash_data, length);
+            TEST_UINT64_EQUAL(jsl_hash_stream_finish(&stream), jsl_hash_bytes(all, 4242));
+        }
+    }
+
+    // finishing doesn't end the stream
+    JSLHashStream stream;
+    jsl_hash_stream_init(&stream, 0);
+    jsl_hash_stream_update(&stream, jsl_immutable_memory(test_hash_data, 200));
+    TEST_UINT64_EQUAL(jsl_hash_stream_finish(&stream), jsl_hash_bytes(jsl_immutable_memory(test_hash_data, 200), 0));
+    jsl_hash_stream_update(&stream, jsl_immutable_memory(test_hash_data + 200, 300));
+    TEST_UINT64_EQUAL(jsl_hash_stream_finish(&stream), jsl_hash_bytes(jsl_immutable_memory(test_hash_data, 500), 0));
+}
+
+void test_jsl_hash_stream_output_sink(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+
+    JSLHashStream stream;
+    TEST_BOOL(jsl_hash_stream_init(&stream, 8));
+
+    JSLOutputSink sink = jsl_hash_stream_output_sink(&stream);
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        jsl_format_sink(sink, JSL_CSTR_EXPRESSION("line %d of the output\n"), i);
+    }
+
+    JSLImmutableMemory expected = {0};
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        JSLImmutableMemory line = jsl_format(allocator, JSL_CSTR_EXPRESSION("line %d of the output\n"), i);
+        expected = i == 0
+            ? line
+            : jsl_format(allocator, JSL_CSTR_EXPRESSION("%y%y"), expected, line);
+    }
+
+    TEST_UINT64_EQUAL(jsl_hash_stream_finish(&stream), jsl_hash_bytes(expected, 8));
+}
+
+void test_jsl_hash_crc32c_and_aes_known_values(void)
+{
+    // RFC 3720 test vectors, 32 bytes of zeros and 32 bytes of ones with the
+    // usual pre and post inversion
+    uint32_t crc = 0xFFFFFFFFU;
+    for (int32_t i = 0; i < 4; ++i)
+        crc = jsl__crc32c_step(crc, 0);
+    TEST_UINT64_EQUAL((uint64_t) ~crc, (uint64_t) 0x8A9136AAU);
+
+    crc = 0xFFFFFFFFU;
+    for (int32_t i = 0; i < 4; ++i)
+        crc = jsl__crc32c_step(crc, UINT64_MAX);
+    TEST_UINT64_EQUAL((uint64_t) ~crc, (uint64_t) 0x62A8AB43U);
+
+    // Fixed results so the hardware and the portable versions are held to
+    // the same output, the test suite is built both with and without them
+    fill_test_hash_data();
+
+    TEST_UINT64_EQUAL(jsl_hash_crc32c_u64(0x0123456789ABCDEFULL, 42), 0xd354f73734dbf1a4ULL);
+    TEST_UINT64_EQUAL(jsl_hash_aes_u64(0x0123456789ABCDEFULL, 42), 0x22b51637e875a8e4ULL);
+
+    int64_t lengths[] = { 0, 3, 8, 15, 16, 17, 33, 100 };
+    uint64_t expected_crc32c[] = {
+        0x0000000000000063ULL, 0xc874e6e242743eb0ULL, 0x17ae4f2da6b47372ULL, 0x9b33e4bc47d0cd17ULL,
+        0xa7cf3e7ce9c62bcdULL, 0x3c253511b26d9d1cULL, 0x6d4047887f2d0dc0ULL, 0xc780b71b6dcf0aa6ULL
+    };
+    uint64_t expected_aes[] = {
+        0x444d8ea825e9bfa9ULL, 0x350f7189d5476018ULL, 0xea9d1f0645a7892cULL, 0x3b5996d8ac66dd50ULL,
+        0xc43274da2a559522ULL, 0x8f5d1c5afd0b9217ULL, 0xf3c484b4fed89f8cULL, 0x885b60166e71edecULL
+    };
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i)
+    {
+        JSLImmutableMemory data = jsl_immutable_memory(test_hash_data, lengths[i]);
+        TEST_UINT64_EQUAL(jsl_hash_crc32c_bytes(data, 99), expected_crc32c[i]);
+        TEST_UINT64_EQUAL(jsl_hash_aes_bytes(data, 99), expected_aes[i]);
+    }
+
+    // every input bit has to reach the low bits the hash maps index with
+    for (int32_t bit = 0; bit < 64; ++bit)
+    {
+        uint64_t value = (uint64_t) 1 << bit;
+        TEST_BOOL((jsl_hash_crc32c_u64(value, 7) & 0xFFFF) != (jsl_hash_crc32c_u64(0, 7) & 0xFFFF));
+        TEST_BOOL((jsl_hash_aes_u64(value, 7) & 0xFFFF) != (jsl_hash_aes_u64(0, 7) & 0xFFFF));
+    }
+
+    TEST_BOOL(jsl_hash_aes_bytes(JSL_CSTR_EXPRESSION("a"), 0) != jsl_hash_aes_bytes((JSLImmutableMemory) {(const uint8_t*) "a\0", 2}, 0));
+    TEST_BOOL(jsl_hash_crc32c_bytes(JSL_CSTR_EXPRESSION("a"), 0) != jsl_hash_crc32c_bytes((JSLImmutableMemory) {(const uint8_t*) "a\0", 2}, 0));
+}
+
+void test_jsl_hash_invalid_parameters(void)
+{
+    uint64_t hashes[4] = {0};
+    uint64_t integers[4] = {1, 2, 3, 4};
+    JSLImmutableMemory keys[1] = { JSL_CSTR_INITIALIZER("key") };
+
+    TEST_BOOL(!jsl_hash_many(NULL, 1, 0, hashes));
+    TEST_BOOL(!jsl_hash_many(keys, 1, 0, NULL));
+    TEST_BOOL(!jsl_hash_many(keys, -1, 0, hashes));
+    TEST_BOOL(jsl_hash_many(NULL, 0, 0, NULL));
+
+    TEST_BOOL(!jsl_hash_many_fixed(integers, 0, 4, 0, hashes));
+    TEST_BOOL(!jsl_hash_many_fixed(NULL, 8, 4, 0, hashes));
+    TEST_BOOL(!jsl_hash_many_fixed(integers, INT64_MAX, 4, 0, hashes));
+
+    TEST_BOOL(!jsl_hash_many_u64(NULL, 4, 0, hashes));
+    TEST_BOOL(!jsl_hash_many_u64(integers, -4, 0, hashes));
+
+    TEST_BOOL(!jsl_hash_stream_init(NULL, 0));
+
+    JSLHashStream stream = {0};
+    TEST_BOOL(!jsl_hash_stream_update(&stream, JSL_CSTR_EXPRESSION("data")));
+    TEST_UINT64_EQUAL(jsl_hash_stream_finish(&stream), (uint64_t) 0);
+
+    jsl_hash_stream_init(&stream, 0);
+    TEST_BOOL(!jsl_hash_stream_update(&stream, (JSLImmutableMemory) {NULL, 4}));
+    TEST_BOOL(jsl_hash_stream_update(&stream, (JSLImmutableMemory) {NULL, 0}));
+    TEST_UINT64_EQUAL(jsl_hash_stream_finish(&stream), jsl_hash_bytes((JSLImmutableMemory) {NULL, 0}, 0));
+}
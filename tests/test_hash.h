@@ -0,0 +1,11 @@
+#ifndef TEST_HASH_H
+#define TEST_HASH_H
+
+void test_jsl_hash_matches_container_hashes(void);
+void test_jsl_hash_many_matches_single(void);
+void test_jsl_hash_stream_matches_one_shot(void);
+void test_jsl_hash_stream_output_sink(void);
+void test_jsl_hash_crc32c_and_aes_known_values(void);
+void test_jsl_hash_invalid_parameters(void);
+
+#endif
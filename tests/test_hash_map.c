@@ -33,8 +33,16 @@
 #include "jsl/allocator.h"
 #include "jsl/allocator_arena.h"
 #include "jsl/allocator_infinite_arena.h"
+#include "jsl/allocator_libc.h"
 #include "jsl/str_to_str_map.h"
 
+#if JSL_IS_WINDOWS
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif
+
 #include "minctest.h"
 #include "test_hash_map.h"
 #include "test_hash_map_types.h"
@@ -44,6 +52,23 @@
 #include "hash_maps/fixed_int32_to_int32_map.h"
 #include "hash_maps/fixed_int32_to_str_map.h"
 #include "hash_maps/fixed_str_to_int32_map.h"
+#include "hash_maps/fixed_int64_to_int32_crc32c_map.h"
+#include "hash_maps/fixed_str_to_int32_aes_map.h"
+#include "hash_maps/fixed_int32_to_int32_robin_hood_map.h"
+#include "hash_maps/fixed_str_to_int32_robin_hood_map.h"
+#include "hash_maps/fixed_int64_to_comp1_control_map.h"
+#include "hash_maps/fixed_str_to_int32_control_map.h"
+#include "hash_maps/dynamic_int32_to_int32_map.h"
+#include "hash_maps/dynamic_str_to_int32_map.h"
+#include "hash_maps/dynamic_int32_to_str_map.h"
+#include "hash_maps/dynamic_comp2_to_int_map.h"
+#include "hash_maps/concurrent_int64_to_uint64_map.h"
+#include "hash_maps/concurrent_comp2_to_int_map.h"
+#include "hash_maps/fixed_int32_set.h"
+#include "hash_maps/fixed_str_set.h"
+#include "hash_maps/dynamic_int64_set.h"
+#include "hash_maps/int64_to_int32_cache.h"
+#include "hash_maps/comp2_to_int_cache.h"
 
 extern JSLInfiniteArena global_arena;
 
@@ -985,236 +1010,1997 @@ void test_fixed_struct_key_padding(void)
     jsl_allocator_interface_free_all(allocator);
 }
 
-typedef struct ExpectedPair {
-    JSLImmutableMemory key;
-    JSLImmutableMemory value;
-    bool seen;
-} ExpectedPair;
-
-void test_jsl_str_to_str_map_init_success(void)
+void test_fixed_builtin_hash_options(void)
 {
     JSLAllocatorInterface allocator;
     jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
     jsl_allocator_interface_free_all(allocator);
 
-    JSLStrToStrMap map = {0};
-    bool ok = jsl_str_to_str_map_init2(&map, allocator, 0xBEEF, 64, 0.5f);
-    TEST_BOOL(ok);
-    if (!ok) return;
+    {
+        FixedInt64ToIntCrc32cMap hashmap;
+        fixed_int64_to_int32_crc32c_map_init(&hashmap, allocator, 512, 0x1234);
 
-    TEST_BOOL(map.entry_lookup_table != NULL);
-    int64_t expected_length = JSL_MAX(32L, jsl_next_power_of_two_i64(65));
-    TEST_INT64_EQUAL(map.entry_lookup_table_length, expected_length);
-    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) 0);
-    TEST_BOOL(map.load_factor == 0.5f);
-}
+        // sequential and widely spaced keys, the two patterns CRC is worst at
+        for (int32_t i = 0; i < 256; ++i)
+        {
+            TEST_BOOL(fixed_int64_to_int32_crc32c_map_insert(&hashmap, (int64_t) i, i));
+            TEST_BOOL(fixed_int64_to_int32_crc32c_map_insert(&hashmap, (int64_t) i << 40, -i));
+        }
+        TEST_INT64_EQUAL(hashmap.item_count, (int64_t) 511);
 
-void test_jsl_str_to_str_map_init_invalid_arguments(void)
-{
-    JSLAllocatorInterface allocator;
-    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
-    jsl_allocator_interface_free_all(allocator);
+        for (int32_t i = 0; i < 256; i += 2)
+        {
+            TEST_BOOL(fixed_int64_to_int32_crc32c_map_delete(&hashmap, (int64_t) i));
+        }
 
-    JSLStrToStrMap map = {0};
+        for (int32_t i = 1; i < 256; ++i)
+        {
+            int32_t* low = fixed_int64_to_int32_crc32c_map_get(&hashmap, (int64_t) i);
+            int32_t* high = fixed_int64_to_int32_crc32c_map_get(&hashmap, (int64_t) i << 40);
 
-    TEST_BOOL(!jsl_str_to_str_map_init2(NULL, allocator, 0, 8, 0.5f));
-    TEST_BOOL(!jsl_str_to_str_map_init2(&map, allocator, 0, 0, 0.5f));
-    TEST_BOOL(!jsl_str_to_str_map_init2(&map, allocator, 0, -4, 0.5f));
-    TEST_BOOL(!jsl_str_to_str_map_init2(&map, allocator, 0, 4, 0.0f));
-    TEST_BOOL(!jsl_str_to_str_map_init2(&map, allocator, 0, 4, 1.0f));
-    TEST_BOOL(!jsl_str_to_str_map_init2(&map, allocator, 0, 4, 1.5f));
-}
+            if (i % 2 == 0)
+                TEST_POINTERS_EQUAL(low, NULL);
+            else
+                TEST_BOOL(low != NULL && *low == i);
+
+            TEST_BOOL(high != NULL && *high == -i);
+        }
+
+        // the generated map must be using the CRC32C hash
+        for (int64_t slot = 0; slot < hashmap.arrays_length; ++slot)
+        {
+            if (hashmap.hashes_array[slot] > (uint64_t) JSL__HASHMAP_VALUE_OK)
+            {
+                TEST_UINT64_EQUAL(
+                    hashmap.hashes_array[slot],
+                    jsl__crc32c_u64((uint64_t) hashmap.keys_array[slot], 0x1234)
+                );
+            }
+        }
+    }
 
-void test_jsl_str_to_str_map_item_count_and_has_key(void)
-{
-    JSLAllocatorInterface allocator;
-    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
     jsl_allocator_interface_free_all(allocator);
 
-    JSLStrToStrMap map = {0};
-    bool ok = jsl_str_to_str_map_init(&map, allocator, 1234);
-    TEST_BOOL(ok);
-    if (!ok) return;
+    {
+        FixedStrToIntAesMap hashmap;
+        fixed_str_to_int32_aes_map_init(&hashmap, allocator, 512, 0x1234);
 
-    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) 0);
+        for (int32_t i = 0; i < 300; ++i)
+        {
+            JSLImmutableMemory key = jsl_format(allocator, JSL_CSTR_EXPRESSION("aes-key-%d"), i);
+            TEST_BOOL(fixed_str_to_int32_aes_map_insert(&hashmap, key, JSL_STRING_LIFETIME_LONGER, i));
+        }
 
-    JSLImmutableMemory key1 = JSL_CSTR_INITIALIZER("alpha");
-    JSLImmutableMemory key2 = JSL_CSTR_INITIALIZER("beta");
-    JSLImmutableMemory missing = JSL_CSTR_INITIALIZER("missing");
+        TEST_BOOL(fixed_str_to_int32_aes_map_insert(&hashmap, JSL_CSTR_EXPRESSION(""), JSL_STRING_LIFETIME_LONGER, -1));
+        TEST_INT64_EQUAL(hashmap.item_count, (int64_t) 301);
 
-    TEST_BOOL(jsl_str_to_str_map_insert(&map, key1, JSL_STRING_LIFETIME_LONGER, JSL_CSTR_EXPRESSION("one"), JSL_STRING_LIFETIME_LONGER));
-    TEST_BOOL(jsl_str_to_str_map_insert(&map, key2, JSL_STRING_LIFETIME_LONGER, JSL_CSTR_EXPRESSION("two"), JSL_STRING_LIFETIME_LONGER));
+        TEST_BOOL(fixed_str_to_int32_aes_map_delete(&hashmap, JSL_CSTR_EXPRESSION("aes-key-7")));
+        TEST_POINTERS_EQUAL(fixed_str_to_int32_aes_map_get(&hashmap, JSL_CSTR_EXPRESSION("aes-key-7")), NULL);
 
-    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) 2);
-    TEST_BOOL(jsl_str_to_str_map_has_key(&map, key1));
-    TEST_BOOL(jsl_str_to_str_map_has_key(&map, key2));
-    TEST_BOOL(!jsl_str_to_str_map_has_key(&map, missing));
+        int32_t* get_res = fixed_str_to_int32_aes_map_get(&hashmap, JSL_CSTR_EXPRESSION("aes-key-299"));
+        TEST_BOOL(get_res != NULL && *get_res == 299);
 
-    JSLStrToStrMap uninitialized = {0};
-    TEST_BOOL(!jsl_str_to_str_map_has_key(&uninitialized, key1));
-    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&uninitialized), (int64_t) -1);
+        get_res = fixed_str_to_int32_aes_map_get(&hashmap, JSL_CSTR_EXPRESSION(""));
+        TEST_BOOL(get_res != NULL && *get_res == -1);
+
+        get_res = fixed_str_to_int32_aes_map_get(&hashmap, JSL_CSTR_EXPRESSION("aes-key-8"));
+        TEST_BOOL(get_res != NULL && *get_res == 8);
+
+        for (int64_t slot = 0; slot < hashmap.arrays_length; ++slot)
+        {
+            if (hashmap.hashes_array[slot] > (uint64_t) JSL__HASHMAP_VALUE_OK)
+            {
+                JSLImmutableMemory key = hashmap.keys_array[slot];
+                TEST_UINT64_EQUAL(
+                    hashmap.hashes_array[slot],
+                    jsl__aes_bytes(key.data, (size_t) key.length, 0x1234)
+                );
+            }
+        }
+    }
+
+    jsl_allocator_interface_free_all(allocator);
 }
 
-void test_jsl_str_to_str_map_get(void)
+void test_fixed_robin_hood(void)
 {
     JSLAllocatorInterface allocator;
     jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
     jsl_allocator_interface_free_all(allocator);
 
-    JSLStrToStrMap map = {0};
-    bool ok = jsl_str_to_str_map_init2(&map, allocator, 2468, 8, 0.6f);
-    TEST_BOOL(ok);
-    if (!ok) return;
+    FixedIntToIntRobinHoodMap hashmap;
+    TEST_BOOL(fixed_int32_to_int32_robin_hood_map_init(&hashmap, allocator, 900, 0));
+    // sized for a 90% load factor rather than 75%
+    TEST_INT64_EQUAL(hashmap.arrays_length, (int64_t) 1024);
 
-    JSLImmutableMemory key = JSL_CSTR_INITIALIZER("lookup-key");
-    JSLImmutableMemory value = JSL_CSTR_INITIALIZER("lookup-value");
+    static bool present[4096];
+    JSL_MEMSET(present, 0, sizeof(present));
 
-    JSLImmutableMemory out_value = JSL_CSTR_EXPRESSION("should-reset");
-    TEST_BOOL(!jsl_str_to_str_map_get(&map, key, &out_value));
-    TEST_INT64_EQUAL(out_value.length, (int64_t) 0);
+    // random churn around a full table, checked against a plain array
+    uint64_t state = 88172645463325252ULL;
+    for (int32_t i = 0; i < 20000; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        int32_t key = (int32_t) (state % 4096);
 
-    TEST_BOOL(jsl_str_to_str_map_insert(
-        &map,
-        key, JSL_STRING_LIFETIME_LONGER,
-        value, JSL_STRING_LIFETIME_LONGER
-    ));
+        if (present[key] && (state >> 32) % 3 == 0)
+        {
+            TEST_BOOL(fixed_int32_to_int32_robin_hood_map_delete(&hashmap, key));
+            present[key] = false;
+        }
+        else if (hashmap.item_count < hashmap.max_item_count)
+        {
+            TEST_BOOL(fixed_int32_to_int32_robin_hood_map_insert(&hashmap, key, key * 2));
+            present[key] = true;
+        }
+        else
+        {
+            // the map is full, which also rejects updates
+            TEST_BOOL(!fixed_int32_to_int32_robin_hood_map_insert(&hashmap, key, key * 2));
+        }
+    }
 
-    TEST_BOOL(jsl_str_to_str_map_get(&map, key, &out_value));
-    TEST_BOOL(jsl_memory_compare(out_value, value));
+    int64_t expected_count = 0;
+    for (int32_t key = 0; key < 4096; ++key)
+    {
+        int32_t* value = fixed_int32_to_int32_robin_hood_map_get(&hashmap, key);
+        if (present[key])
+        {
+            ++expected_count;
+            TEST_BOOL(value != NULL && *value == key * 2);
+        }
+        else
+        {
+            TEST_POINTERS_EQUAL(value, NULL);
+        }
+    }
+    TEST_INT64_EQUAL(hashmap.item_count, expected_count);
 
-    JSLImmutableMemory missing = JSL_CSTR_INITIALIZER("missing");
-    out_value = JSL_CSTR_EXPRESSION("still-reset");
-    TEST_BOOL(!jsl_str_to_str_map_get(&map, missing, &out_value));
-    TEST_INT64_EQUAL(out_value.length, (int64_t) 0);
+    // Robin Hood invariant, walking forward a slot can be at most one
+    // further from its ideal slot than the one before it
+    uint64_t slot_mask = (uint64_t) hashmap.arrays_length - 1u;
+    for (int64_t slot = 0; slot < hashmap.arrays_length; ++slot)
+    {
+        int64_t next = (int64_t) (((uint64_t) slot + 1u) & slot_mask);
+        uint64_t hash = hashmap.hashes_array[slot];
+        uint64_t next_hash = hashmap.hashes_array[next];
+        if (hash == JSL__HASHMAP_EMPTY || next_hash == JSL__HASHMAP_EMPTY)
+            continue;
+
+        uint64_t distance = ((uint64_t) slot - (hash & slot_mask)) & slot_mask;
+        uint64_t next_distance = ((uint64_t) next - (next_hash & slot_mask)) & slot_mask;
+        TEST_BOOL(next_distance <= distance + 1);
+    }
 
-    TEST_BOOL(!jsl_str_to_str_map_get(&map, key, NULL));
+    jsl_allocator_interface_free_all(allocator);
 }
 
-void test_jsl_str_to_str_map_insert_overwrites_value(void)
+void test_fixed_str_key_lifetimes_survive_moves(void)
 {
     JSLAllocatorInterface allocator;
     jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
     jsl_allocator_interface_free_all(allocator);
 
-    JSLStrToStrMap map = {0};
-    bool ok = jsl_str_to_str_map_init2(&map, allocator, 42, 8, 0.7f);
-    TEST_BOOL(ok);
-    if (!ok) return;
+    // keys with the longer lifetime point into this buffer, keys with the
+    // shorter lifetime are copied out of it
+    static char key_buffer[200][16];
+    for (int32_t i = 0; i < 200; ++i)
+        snprintf(key_buffer[i], sizeof(key_buffer[i]), "key-%d", i);
 
-    JSLImmutableMemory key = JSL_CSTR_INITIALIZER("dup-key");
+    const uint8_t* buffer_start = (const uint8_t*) key_buffer;
+    const uint8_t* buffer_end = buffer_start + sizeof(key_buffer);
 
-    TEST_BOOL(jsl_str_to_str_map_insert(&map, key, JSL_STRING_LIFETIME_LONGER, JSL_CSTR_EXPRESSION("first"), JSL_STRING_LIFETIME_LONGER));
-    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) 1);
+    {
+        FixedStrToIntMap hashmap;
+        fixed_str_to_int32_map_init(&hashmap, allocator, 200, 0);
 
-    TEST_BOOL(jsl_str_to_str_map_insert(&map, key, JSL_STRING_LIFETIME_LONGER, JSL_CSTR_EXPRESSION("second"), JSL_STRING_LIFETIME_LONGER));
-    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) 1);
+        for (int32_t i = 0; i < 200; ++i)
+        {
+            JSLStringLifeTime lifetime = i % 2 == 0 ? JSL_STRING_LIFETIME_LONGER : JSL_STRING_LIFETIME_SHORTER;
+            fixed_str_to_int32_map_insert(&hashmap, jsl_cstr_to_memory(key_buffer[i]), lifetime, i);
+        }
+        for (int32_t i = 0; i < 200; i += 3)
+        {
+            TEST_BOOL(fixed_str_to_int32_map_delete(&hashmap, jsl_cstr_to_memory(key_buffer[i])));
+        }
 
-    JSLStrToStrMapKeyValueIter iter;
-    jsl_str_to_str_map_key_value_iterator_init(&map, &iter);
+        for (int64_t slot = 0; slot < hashmap.arrays_length; ++slot)
+        {
+            if (hashmap.hashes_array[slot] == JSL__HASHMAP_EMPTY)
+                continue;
+
+            const uint8_t* data = hashmap.keys_array[slot].data;
+            bool in_buffer = data >= buffer_start && data < buffer_end;
+            TEST_BOOL(in_buffer == (hashmap.key_lifetime_array[slot] == JSL_STRING_LIFETIME_LONGER));
+        }
+    }
+
+    jsl_allocator_interface_free_all(allocator);
 
-    JSLImmutableMemory out_key = (JSLImmutableMemory) {0};
-    JSLImmutableMemory out_value = (JSLImmutableMemory) {0};
-    bool found = false;
-    while (jsl_str_to_str_map_key_value_iterator_next(&iter, &out_key, &out_value))
     {
-        if (jsl_memory_compare(out_key, key))
+        FixedStrToIntRobinHoodMap hashmap;
+        fixed_str_to_int32_robin_hood_map_init(&hashmap, allocator, 200, 0);
+
+        for (int32_t i = 0; i < 200; ++i)
         {
-            found = true;
-            TEST_BOOL(jsl_memory_compare(out_value, JSL_CSTR_EXPRESSION("second")));
-            break;
+            JSLStringLifeTime lifetime = i % 2 == 0 ? JSL_STRING_LIFETIME_LONGER : JSL_STRING_LIFETIME_SHORTER;
+            fixed_str_to_int32_robin_hood_map_insert(&hashmap, jsl_cstr_to_memory(key_buffer[i]), lifetime, i);
+        }
+        for (int32_t i = 0; i < 200; i += 3)
+        {
+            TEST_BOOL(fixed_str_to_int32_robin_hood_map_delete(&hashmap, jsl_cstr_to_memory(key_buffer[i])));
+        }
+
+        for (int64_t slot = 0; slot < hashmap.arrays_length; ++slot)
+        {
+            if (hashmap.hashes_array[slot] == JSL__HASHMAP_EMPTY)
+                continue;
+
+            const uint8_t* data = hashmap.keys_array[slot].data;
+            bool in_buffer = data >= buffer_start && data < buffer_end;
+            TEST_BOOL(in_buffer == (hashmap.key_lifetime_array[slot] == JSL_STRING_LIFETIME_LONGER));
+        }
+
+        for (int32_t i = 0; i < 200; ++i)
+        {
+            int32_t* value = fixed_str_to_int32_robin_hood_map_get(&hashmap, jsl_cstr_to_memory(key_buffer[i]));
+            if (i % 3 == 0)
+                TEST_POINTERS_EQUAL(value, NULL);
+            else
+                TEST_BOOL(value != NULL && *value == i);
         }
     }
 
-    TEST_BOOL(found);
+    jsl_allocator_interface_free_all(allocator);
 }
 
-void test_jsl_str_to_str_map_transient_lifetime_copies_data(void)
+void test_fixed_control_bytes(void)
 {
     JSLAllocatorInterface allocator;
     jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
     jsl_allocator_interface_free_all(allocator);
 
-    JSLStrToStrMap map = {0};
-    bool ok = jsl_str_to_str_map_init2(&map, allocator, 555, 8, 0.6f);
-    TEST_BOOL(ok);
-    if (!ok) return;
-
-    char key_small_buf[] = "short";
-    char val_small_buf[] = "miniVal";
-    char key_long_buf[] = "a-longer-key";
-    char val_long_buf[] = "a-longer-value";
+    {
+        FixedInt64ToCompositeType1ControlMap hashmap;
+        TEST_BOOL(fixed_int64_to_comp1_control_map_init(&hashmap, allocator, 896, 0));
+        // sized for a 87.5% load factor rather than 75%
+        TEST_INT64_EQUAL(hashmap.arrays_length, (int64_t) 1024);
 
-    JSLImmutableMemory key_small = jsl_cstr_to_memory(key_small_buf);
-    JSLImmutableMemory val_small = jsl_cstr_to_memory(val_small_buf);
-    JSLImmutableMemory key_long = jsl_cstr_to_memory(key_long_buf);
-    JSLImmutableMemory val_long = jsl_cstr_to_memory(val_long_buf);
+        static bool present[4096];
+        JSL_MEMSET(present, 0, sizeof(present));
 
-    TEST_BOOL(jsl_str_to_str_map_insert(&map, key_small, JSL_STRING_LIFETIME_SHORTER, val_small, JSL_STRING_LIFETIME_SHORTER));
-    TEST_BOOL(jsl_str_to_str_map_insert(&map, key_long, JSL_STRING_LIFETIME_SHORTER, val_long, JSL_STRING_LIFETIME_SHORTER));
+        // random churn around a full table, checked against a plain array
+        uint64_t state = 88172645463325252ULL;
+        for (int32_t i = 0; i < 20000; ++i)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            int32_t index = (int32_t) (state % 4096);
+            int64_t key = ((int64_t) index << 40) - 2048;
+            CompositeType1 value = { .a = index, .b = -index };
+
+            if (present[index] && (state >> 32) % 3 == 0)
+            {
+                TEST_BOOL(fixed_int64_to_comp1_control_map_delete(&hashmap, key));
+                present[index] = false;
+            }
+            else if (hashmap.item_count < hashmap.max_item_count)
+            {
+                TEST_BOOL(fixed_int64_to_comp1_control_map_insert(&hashmap, key, value));
+                present[index] = true;
+            }
+            else
+            {
+                // the map is full, which also rejects updates
+                TEST_BOOL(!fixed_int64_to_comp1_control_map_insert(&hashmap, key, value));
+            }
+        }
 
-    key_small_buf[0] = 'X';
-    val_small_buf[0] = 'Z';
-    key_long_buf[0] = 'Y';
-    val_long_buf[0] = 'Q';
+        int64_t expected_count = 0;
+        for (int32_t index = 0; index < 4096; ++index)
+        {
+            int64_t key = ((int64_t) index << 40) - 2048;
+            CompositeType1* value = fixed_int64_to_comp1_control_map_get(&hashmap, key);
+            if (present[index])
+            {
+                ++expected_count;
+                TEST_BOOL(value != NULL && value->a == index && value->b == -index);
+            }
+            else
+            {
+                TEST_POINTERS_EQUAL(value, NULL);
+            }
+        }
+        TEST_INT64_EQUAL(hashmap.item_count, expected_count);
 
-    const JSLImmutableMemory expected_small_key = JSL_CSTR_EXPRESSION("short");
-    const JSLImmutableMemory expected_small_value = JSL_CSTR_EXPRESSION("miniVal");
-    const JSLImmutableMemory expected_long_key = JSL_CSTR_EXPRESSION("a-longer-key");
-    const JSLImmutableMemory expected_long_value = JSL_CSTR_EXPRESSION("a-longer-value");
+        // every occupied control byte holds the tag of its key's hash, and
+        // the first group is mirrored after the end of the table
+        int64_t occupied_count = 0;
+        for (int64_t slot = 0; slot < hashmap.arrays_length; ++slot)
+        {
+            uint8_t control = hashmap.control_array[slot];
+            if (control == JSL__HASHMAP_CONTROL_EMPTY)
+                continue;
+
+            ++occupied_count;
+            uint64_t hash = jsl__murmur3_fmix_u64((uint64_t) hashmap.keys_array[slot], 0);
+            if (hash <= (uint64_t) JSL__HASHMAP_TOMBSTONE)
+                hash = (uint64_t) JSL__HASHMAP_VALUE_OK;
+            TEST_UINT64_EQUAL((uint64_t) control, hash & 0x7Fu);
+        }
+        TEST_INT64_EQUAL(occupied_count, expected_count);
+        for (int64_t slot = 0; slot < JSL__HASHMAP_GROUP_WIDTH; ++slot)
+        {
+            TEST_UINT64_EQUAL(
+                (uint64_t) hashmap.control_array[hashmap.arrays_length + slot],
+                (uint64_t) hashmap.control_array[slot]
+            );
+        }
+    }
 
-    JSLStrToStrMapKeyValueIter iter;
-    jsl_str_to_str_map_key_value_iterator_init(&map, &iter);
+    jsl_allocator_interface_free_all(allocator);
 
-    bool saw_small = false;
-    bool saw_long = false;
-    JSLImmutableMemory out_key = (JSLImmutableMemory) {0};
-    JSLImmutableMemory out_value = (JSLImmutableMemory) {0};
-    while (jsl_str_to_str_map_key_value_iterator_next(&iter, &out_key, &out_value))
     {
-        if (jsl_memory_compare(out_key, expected_small_key))
+        FixedStrToIntControlMap hashmap;
+        TEST_BOOL(fixed_str_to_int32_control_map_init(&hashmap, allocator, 200, 0));
+
+        static char key_buffer[200][16];
+        for (int32_t i = 0; i < 200; ++i)
+            snprintf(key_buffer[i], sizeof(key_buffer[i]), "key-%d", i);
+
+        for (int32_t i = 0; i < 200; ++i)
         {
-            saw_small = true;
-            TEST_BOOL(jsl_memory_compare(out_value, expected_small_value));
-            TEST_BOOL(out_key.data != (uint8_t*) key_small_buf);
-            TEST_BOOL(out_value.data != (uint8_t*) val_small_buf);
+            JSLStringLifeTime lifetime = i % 2 == 0 ? JSL_STRING_LIFETIME_LONGER : JSL_STRING_LIFETIME_SHORTER;
+            TEST_BOOL(fixed_str_to_int32_control_map_insert(&hashmap, jsl_cstr_to_memory(key_buffer[i]), lifetime, i));
         }
-        else if (jsl_memory_compare(out_key, expected_long_key))
+        for (int32_t i = 0; i < 200; i += 3)
         {
-            saw_long = true;
-            TEST_BOOL(jsl_memory_compare(out_value, expected_long_value));
-            TEST_BOOL(out_key.data != (uint8_t*) key_long_buf);
-            TEST_BOOL(out_value.data != (uint8_t*) val_long_buf);
+            TEST_BOOL(fixed_str_to_int32_control_map_delete(&hashmap, jsl_cstr_to_memory(key_buffer[i])));
+        }
+
+        for (int32_t i = 0; i < 200; ++i)
+        {
+            int32_t* value = fixed_str_to_int32_control_map_get(&hashmap, jsl_cstr_to_memory(key_buffer[i]));
+            if (i % 3 == 0)
+                TEST_POINTERS_EQUAL(value, NULL);
+            else
+                TEST_BOOL(value != NULL && *value == i);
+        }
+
+        int64_t iterated = 0;
+        JSLImmutableMemory key;
+        int32_t value;
+        FixedStrToIntControlMapIterator iterator;
+        fixed_str_to_int32_control_map_iterator_start(&hashmap, &iterator);
+        while (fixed_str_to_int32_control_map_iterator_next(&iterator, &key, &value))
+        {
+            TEST_BOOL(jsl_memory_compare(key, jsl_cstr_to_memory(key_buffer[value])));
+            ++iterated;
         }
+        TEST_INT64_EQUAL(iterated, hashmap.item_count);
+
+        fixed_str_to_int32_control_map_free(&hashmap);
     }
 
-    TEST_BOOL(saw_small);
-    TEST_BOOL(saw_long);
+    jsl_allocator_interface_free_all(allocator);
 }
 
-void test_jsl_str_to_str_map_fixed_lifetime_uses_original_pointers(void)
+void test_dynamic_insert_grows(void)
 {
     JSLAllocatorInterface allocator;
     jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
     jsl_allocator_interface_free_all(allocator);
 
-    JSLStrToStrMap map = {0};
-    bool ok = jsl_str_to_str_map_init2(&map, allocator, 777, 8, 0.65f);
-    TEST_BOOL(ok);
-    if (!ok) return;
+    {
+        DynamicIntToIntMap hashmap;
+        TEST_BOOL(!dynamic_int32_to_int32_map_init2(NULL, allocator, 0, 16, 0.75f));
+        TEST_BOOL(!dynamic_int32_to_int32_map_init2(&hashmap, allocator, 0, -1, 0.75f));
+        TEST_BOOL(!dynamic_int32_to_int32_map_init2(&hashmap, allocator, 0, 16, 0.0f));
+        TEST_BOOL(!dynamic_int32_to_int32_map_init2(&hashmap, allocator, 0, 16, 1.0f));
+
+        // room for the guess without growing
+        TEST_BOOL(dynamic_int32_to_int32_map_init2(&hashmap, allocator, 0, 1000, 0.5f));
+        TEST_INT64_EQUAL(hashmap.table.arrays_length, (int64_t) 2048);
+        TEST_BOOL(dynamic_int32_to_int32_map_init(&hashmap, allocator, 0));
+        TEST_INT64_EQUAL(hashmap.table.arrays_length, (int64_t) 64);
+    }
 
-    JSLImmutableMemory key = JSL_CSTR_INITIALIZER("fixed-key");
-    JSLImmutableMemory value = JSL_CSTR_INITIALIZER("fixed-value");
+    jsl_allocator_interface_free_all(allocator);
 
-    const uint8_t* expected_key_ptr = key.data;
-    const uint8_t* expected_val_ptr = value.data;
+    {
+        DynamicIntToIntMap hashmap;
+        TEST_BOOL(dynamic_int32_to_int32_map_init2(&hashmap, allocator, 0, 0, 0.75f));
+        TEST_INT64_EQUAL(hashmap.table.arrays_length, (int64_t) 32);
 
-    TEST_BOOL(jsl_str_to_str_map_insert(&map, key, JSL_STRING_LIFETIME_LONGER, value, JSL_STRING_LIFETIME_LONGER));
+        for (int32_t i = 0; i < 10000; ++i)
+        {
+            TEST_BOOL(dynamic_int32_to_int32_map_insert(&hashmap, i * 7, i));
+        }
 
-    JSLStrToStrMapKeyValueIter iter;
-    jsl_str_to_str_map_key_value_iterator_init(&map, &iter);
+        TEST_INT64_EQUAL(dynamic_int32_to_int32_map_item_count(&hashmap), (int64_t) 10000);
+        TEST_INT64_EQUAL(hashmap.table.arrays_length, (int64_t) 16384);
+        TEST_POINTERS_EQUAL(hashmap.old_table.hashes_array, NULL);
 
-    JSLImmutableMemory out_key = (JSLImmutableMemory) {0};
-    JSLImmutableMemory out_value = (JSLImmutableMemory) {0};
+        for (int32_t i = 0; i < 10000; ++i)
+        {
+            int32_t* value = dynamic_int32_to_int32_map_get(&hashmap, i * 7);
+            TEST_BOOL(value != NULL && *value == i);
+            TEST_POINTERS_EQUAL(dynamic_int32_to_int32_map_get(&hashmap, i * 7 + 1), NULL);
+        }
+
+        // updates never grow the table
+        int64_t length = hashmap.table.arrays_length;
+        for (int32_t i = 0; i < 10000; ++i)
+        {
+            TEST_BOOL(dynamic_int32_to_int32_map_insert(&hashmap, i * 7, -i));
+        }
+        TEST_INT64_EQUAL(hashmap.table.arrays_length, length);
+        TEST_INT64_EQUAL(dynamic_int32_to_int32_map_item_count(&hashmap), (int64_t) 10000);
+        TEST_BOOL(*dynamic_int32_to_int32_map_get(&hashmap, 700) == -100);
+
+        dynamic_int32_to_int32_map_clear(&hashmap);
+        TEST_INT64_EQUAL(dynamic_int32_to_int32_map_item_count(&hashmap), (int64_t) 0);
+        TEST_INT64_EQUAL(hashmap.table.arrays_length, length);
+        TEST_POINTERS_EQUAL(dynamic_int32_to_int32_map_get(&hashmap, 700), NULL);
+        TEST_BOOL(dynamic_int32_to_int32_map_insert(&hashmap, 700, 1));
+        TEST_INT64_EQUAL(dynamic_int32_to_int32_map_item_count(&hashmap), (int64_t) 1);
+
+        dynamic_int32_to_int32_map_free(&hashmap);
+        TEST_INT64_EQUAL(dynamic_int32_to_int32_map_item_count(&hashmap), (int64_t) -1);
+        TEST_BOOL(!dynamic_int32_to_int32_map_insert(&hashmap, 700, 1));
+    }
+
+    jsl_allocator_interface_free_all(allocator);
+}
+
+void test_dynamic_delete_churn(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    // once with full rehashes and once with the smallest incremental step
+    for (int64_t rehash_step = 0; rehash_step < 2; ++rehash_step)
+    {
+        DynamicIntToIntMap hashmap;
+        TEST_BOOL(dynamic_int32_to_int32_map_init2(&hashmap, allocator, 0, 0, 0.75f));
+        TEST_BOOL(dynamic_int32_to_int32_map_enable_incremental_rehash(&hashmap, rehash_step));
+
+        static int32_t expected[8192];
+        static bool present[8192];
+        JSL_MEMSET(present, 0, sizeof(present));
+
+        // random churn, growing the key range over time, checked against a plain array
+        uint64_t state = 88172645463325252ULL;
+        for (int32_t i = 0; i < 60000; ++i)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            int32_t key = (int32_t) (state % (uint64_t) (1024 + i / 10));
+            int32_t value = (int32_t) (state >> 40);
+
+            if (present[key] && (state >> 32) % 3 == 0)
+            {
+                TEST_BOOL(dynamic_int32_to_int32_map_delete(&hashmap, key));
+                present[key] = false;
+            }
+            else
+            {
+                TEST_BOOL(dynamic_int32_to_int32_map_insert(&hashmap, key, value));
+                present[key] = true;
+                expected[key] = value;
+            }
+        }
+
+        int64_t expected_count = 0;
+        for (int32_t key = 0; key < 8192; ++key)
+        {
+            int32_t* value = dynamic_int32_to_int32_map_get(&hashmap, key);
+            if (present[key])
+            {
+                ++expected_count;
+                TEST_BOOL(value != NULL && *value == expected[key]);
+            }
+            else
+            {
+                TEST_POINTERS_EQUAL(value, NULL);
+                TEST_BOOL(!dynamic_int32_to_int32_map_delete(&hashmap, key));
+            }
+        }
+        TEST_INT64_EQUAL(dynamic_int32_to_int32_map_item_count(&hashmap), expected_count);
+
+        int64_t iterated = 0;
+        int32_t key;
+        int32_t value;
+        DynamicIntToIntMapIterator iterator;
+        dynamic_int32_to_int32_map_iterator_start(&hashmap, &iterator);
+        while (dynamic_int32_to_int32_map_iterator_next(&iterator, &key, &value))
+        {
+            TEST_BOOL(present[key] && expected[key] == value);
+            ++iterated;
+        }
+        TEST_INT64_EQUAL(iterated, expected_count);
+    }
+
+    jsl_allocator_interface_free_all(allocator);
+
+    {
+        DynamicCompositeType2ToIntMap hashmap;
+        TEST_BOOL(dynamic_comp2_to_int_map_init(&hashmap, allocator, 0));
+
+        for (int32_t i = 0; i < 2000; ++i)
+        {
+            CompositeType2 key;
+            JSL_MEMSET(&key, 0, sizeof(CompositeType2));
+            key.a = i;
+            key.b = -i;
+            key.c = i % 2 == 0;
+            TEST_BOOL(dynamic_comp2_to_int_map_insert(&hashmap, &key, i));
+        }
+
+        for (int32_t i = 0; i < 2000; i += 2)
+        {
+            CompositeType2 key;
+            JSL_MEMSET(&key, 0, sizeof(CompositeType2));
+            key.a = i;
+            key.b = -i;
+            key.c = true;
+            TEST_BOOL(dynamic_comp2_to_int_map_delete(&hashmap, &key));
+        }
+
+        TEST_INT64_EQUAL(dynamic_comp2_to_int_map_item_count(&hashmap), (int64_t) 1000);
+
+        for (int32_t i = 0; i < 2000; ++i)
+        {
+            CompositeType2 key;
+            JSL_MEMSET(&key, 0, sizeof(CompositeType2));
+            key.a = i;
+            key.b = -i;
+            key.c = i % 2 == 0;
+            int32_t* value = dynamic_comp2_to_int_map_get(&hashmap, &key);
+            if (i % 2 == 0)
+                TEST_POINTERS_EQUAL(value, NULL);
+            else
+                TEST_BOOL(value != NULL && *value == i);
+        }
+    }
+
+    jsl_allocator_interface_free_all(allocator);
+}
+
+void test_dynamic_incremental_rehash(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    DynamicIntToIntMap hashmap;
+    TEST_BOOL(dynamic_int32_to_int32_map_init2(&hashmap, allocator, 0, 0, 0.75f));
+    TEST_BOOL(!dynamic_int32_to_int32_map_enable_incremental_rehash(&hashmap, -1));
+    TEST_BOOL(dynamic_int32_to_int32_map_enable_incremental_rehash(&hashmap, 4));
+
+    // 24 items fill a 32 slot table, the next insert starts the rehash
+    for (int32_t i = 0; i < 25; ++i)
+    {
+        TEST_BOOL(dynamic_int32_to_int32_map_insert(&hashmap, i, i * 10));
+    }
+
+    TEST_INT64_EQUAL(hashmap.table.arrays_length, (int64_t) 64);
+    TEST_INT64_EQUAL(hashmap.old_table.arrays_length, (int64_t) 32);
+    TEST_BOOL(hashmap.old_table.hashes_array != NULL);
+
+    // lookups find entries in either table and don't move anything
+    int64_t migrate_index = hashmap.rehash_migrate_index;
+    for (int32_t i = 0; i < 25; ++i)
+    {
+        int32_t* value = dynamic_int32_to_int32_map_get(&hashmap, i);
+        TEST_BOOL(value != NULL && *value == i * 10);
+    }
+    TEST_INT64_EQUAL(hashmap.rehash_migrate_index, migrate_index);
+
+    // iteration covers both tables exactly once
+    {
+        static bool seen[25];
+        JSL_MEMSET(seen, 0, sizeof(seen));
+        int64_t iterated = 0;
+        int32_t key;
+        int32_t value;
+        DynamicIntToIntMapIterator iterator;
+        dynamic_int32_to_int32_map_iterator_start(&hashmap, &iterator);
+        while (dynamic_int32_to_int32_map_iterator_next(&iterator, &key, &value))
+        {
+            TEST_BOOL(key >= 0 && key < 25 && !seen[key] && value == key * 10);
+            seen[key] = true;
+            ++iterated;
+        }
+        TEST_INT64_EQUAL(iterated, (int64_t) 25);
+    }
+
+    // deleting a missing key still migrates slots, which has to invalidate
+    // iterators even though no entry was removed
+    {
+        bool will_move = false;
+        for (int64_t slot = hashmap.rehash_migrate_index; slot < hashmap.rehash_migrate_index + 4; ++slot)
+        {
+            if (hashmap.old_table.hashes_array[slot] > JSL__HASHMAP_TOMBSTONE)
+                will_move = true;
+        }
+        TEST_BOOL(will_move);
+
+        int32_t key;
+        int32_t value;
+        DynamicIntToIntMapIterator iterator;
+        dynamic_int32_to_int32_map_iterator_start(&hashmap, &iterator);
+        TEST_BOOL(dynamic_int32_to_int32_map_iterator_next(&iterator, &key, &value));
+
+        TEST_BOOL(!dynamic_int32_to_int32_map_delete(&hashmap, 1000));
+        TEST_BOOL(!dynamic_int32_to_int32_map_iterator_next(&iterator, &key, &value));
+        TEST_INT64_EQUAL(dynamic_int32_to_int32_map_item_count(&hashmap), (int64_t) 25);
+    }
+
+    // updates and deletes of entries which are still in the old table
+    // the update and the delete each migrate four slots first, so pick a key
+    // past those
+    int32_t old_key = -1;
+    for (int64_t slot = hashmap.rehash_migrate_index + 8; slot < hashmap.old_table.arrays_length; ++slot)
+    {
+        if (hashmap.old_table.hashes_array[slot] > JSL__HASHMAP_TOMBSTONE)
+        {
+            old_key = hashmap.old_table.keys_array[slot];
+            break;
+        }
+    }
+    TEST_BOOL(old_key > -1);
+    TEST_BOOL(dynamic_int32_to_int32_map_insert(&hashmap, old_key, -1));
+    TEST_INT64_EQUAL(dynamic_int32_to_int32_map_item_count(&hashmap), (int64_t) 25);
+    TEST_BOOL(*dynamic_int32_to_int32_map_get(&hashmap, old_key) == -1);
+    TEST_BOOL(dynamic_int32_to_int32_map_delete(&hashmap, old_key));
+    TEST_POINTERS_EQUAL(dynamic_int32_to_int32_map_get(&hashmap, old_key), NULL);
+    TEST_INT64_EQUAL(dynamic_int32_to_int32_map_item_count(&hashmap), (int64_t) 24);
+
+    // eight operations at four slots each drains the 32 slot table
+    for (int32_t i = 25; i < 31; ++i)
+    {
+        TEST_BOOL(dynamic_int32_to_int32_map_insert(&hashmap, i, i * 10));
+    }
+    TEST_POINTERS_EQUAL(hashmap.old_table.hashes_array, NULL);
+    TEST_INT64_EQUAL(hashmap.old_table.arrays_length, (int64_t) 0);
+
+    for (int32_t i = 0; i < 31; ++i)
+    {
+        int32_t* value = dynamic_int32_to_int32_map_get(&hashmap, i);
+        if (i == old_key)
+            TEST_POINTERS_EQUAL(value, NULL);
+        else
+            TEST_BOOL(value != NULL && *value == i * 10);
+    }
+
+    // growing again before a rehash is done finishes the earlier one first
+    TEST_BOOL(dynamic_int32_to_int32_map_enable_incremental_rehash(&hashmap, 1));
+    for (int32_t i = 31; i < 2000; ++i)
+    {
+        TEST_BOOL(dynamic_int32_to_int32_map_insert(&hashmap, i, i * 10));
+    }
+    TEST_INT64_EQUAL(dynamic_int32_to_int32_map_item_count(&hashmap), (int64_t) 1999);
+
+    TEST_BOOL(dynamic_int32_to_int32_map_finish_rehash(&hashmap));
+    TEST_POINTERS_EQUAL(hashmap.old_table.hashes_array, NULL);
+    for (int32_t i = 0; i < 2000; ++i)
+    {
+        int32_t* value = dynamic_int32_to_int32_map_get(&hashmap, i);
+        if (i == old_key)
+            TEST_POINTERS_EQUAL(value, NULL);
+        else
+            TEST_BOOL(value != NULL && *value == i * 10);
+    }
+
+    jsl_allocator_interface_free_all(allocator);
+}
+
+void test_dynamic_str_lifetimes(void)
+{
+    // The libc allocator tracks every allocation, so anything the map
+    // forgets to free is still in its list at the end
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    {
+        DynamicStrToIntMap hashmap;
+        TEST_BOOL(dynamic_str_to_int32_map_init(&hashmap, allocator, 0));
+        TEST_BOOL(dynamic_str_to_int32_map_enable_incremental_rehash(&hashmap, 8));
+
+        static char literal_keys[1000][16];
+        char buffer[16];
+        for (int32_t i = 0; i < 1000; ++i)
+        {
+            snprintf(literal_keys[i], sizeof(literal_keys[i]), "key-%d", i);
+
+            if (i % 2 == 0)
+            {
+                TEST_BOOL(dynamic_str_to_int32_map_insert(
+                    &hashmap, jsl_cstr_to_memory(literal_keys[i]), JSL_STRING_LIFETIME_LONGER, i
+                ));
+            }
+            else
+            {
+                // the map has to copy the key, the buffer is reused right away
+                snprintf(buffer, sizeof(buffer), "key-%d", i);
+                TEST_BOOL(dynamic_str_to_int32_map_insert(
+                    &hashmap, jsl_cstr_to_memory(buffer), JSL_STRING_LIFETIME_SHORTER, i
+                ));
+            }
+        }
+        JSL_MEMSET(buffer, 0, sizeof(buffer));
+
+        for (int32_t i = 0; i < 1000; i += 3)
+        {
+            TEST_BOOL(dynamic_str_to_int32_map_delete(&hashmap, jsl_cstr_to_memory(literal_keys[i])));
+        }
+
+        int64_t expected_count = 0;
+        for (int32_t i = 0; i < 1000; ++i)
+        {
+            int32_t* value = dynamic_str_to_int32_map_get(&hashmap, jsl_cstr_to_memory(literal_keys[i]));
+            if (i % 3 == 0)
+            {
+                TEST_POINTERS_EQUAL(value, NULL);
+            }
+            else
+            {
+                ++expected_count;
+                TEST_BOOL(value != NULL && *value == i);
+            }
+        }
+
+        int64_t iterated = 0;
+        JSLImmutableMemory key;
+        int32_t value;
+        DynamicStrToIntMapIterator iterator;
+        dynamic_str_to_int32_map_iterator_start(&hashmap, &iterator);
+        while (dynamic_str_to_int32_map_iterator_next(&iterator, &key, &value))
+        {
+            TEST_BOOL(jsl_memory_compare(key, jsl_cstr_to_memory(literal_keys[value])));
+            ++iterated;
+        }
+        TEST_INT64_EQUAL(iterated, expected_count);
+        TEST_INT64_EQUAL(dynamic_str_to_int32_map_item_count(&hashmap), expected_count);
+
+        dynamic_str_to_int32_map_clear(&hashmap);
+        TEST_INT64_EQUAL(dynamic_str_to_int32_map_item_count(&hashmap), (int64_t) 0);
+
+        snprintf(buffer, sizeof(buffer), "after-clear");
+        TEST_BOOL(dynamic_str_to_int32_map_insert(
+            &hashmap, jsl_cstr_to_memory(buffer), JSL_STRING_LIFETIME_SHORTER, 1
+        ));
+
+        dynamic_str_to_int32_map_free(&hashmap);
+    }
+
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+
+    {
+        DynamicIntToStrMap hashmap;
+        TEST_BOOL(dynamic_int32_to_str_map_init(&hashmap, allocator, 0));
+        TEST_BOOL(dynamic_int32_to_str_map_enable_incremental_rehash(&hashmap, 2));
+
+        char buffer[32];
+        for (int32_t i = 0; i < 500; ++i)
+        {
+            snprintf(buffer, sizeof(buffer), "value-%d", i);
+            TEST_BOOL(dynamic_int32_to_str_map_insert(
+                &hashmap, i, jsl_cstr_to_memory(buffer), JSL_STRING_LIFETIME_SHORTER
+            ));
+        }
+
+        // overwriting frees the old copy
+        for (int32_t i = 0; i < 500; i += 2)
+        {
+            snprintf(buffer, sizeof(buffer), "new-%d", i);
+            TEST_BOOL(dynamic_int32_to_str_map_insert(
+                &hashmap, i, jsl_cstr_to_memory(buffer), JSL_STRING_LIFETIME_SHORTER
+            ));
+        }
+        for (int32_t i = 0; i < 500; i += 5)
+        {
+            TEST_BOOL(dynamic_int32_to_str_map_delete(&hashmap, i));
+        }
+
+        for (int32_t i = 0; i < 500; ++i)
+        {
+            JSLImmutableMemory value = dynamic_int32_to_str_map_get(&hashmap, i);
+            if (i % 5 == 0)
+            {
+                TEST_POINTERS_EQUAL(value.data, NULL);
+                continue;
+            }
+
+            snprintf(buffer, sizeof(buffer), i % 2 == 0 ? "new-%d" : "value-%d", i);
+            TEST_BOOL(jsl_memory_compare(value, jsl_cstr_to_memory(buffer)));
+        }
+
+        TEST_BOOL(dynamic_int32_to_str_map_finish_rehash(&hashmap));
+        dynamic_int32_to_str_map_free(&hashmap);
+    }
+
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+}
+
+static void concurrent_add_one(uint64_t* value, void* user_data)
+{
+    (void) user_data;
+    *value += 1;
+}
+
+void test_concurrent_basic(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    {
+        ConcurrentInt64ToUInt64Map hashmap;
+        TEST_BOOL(!concurrent_int64_to_uint64_map_init2(NULL, allocator, 100, 4, 0));
+        TEST_BOOL(!concurrent_int64_to_uint64_map_init2(&hashmap, allocator, -1, 4, 0));
+        TEST_BOOL(!concurrent_int64_to_uint64_map_init2(&hashmap, allocator, 100, 0, 0));
+
+        TEST_BOOL(concurrent_int64_to_uint64_map_init2(&hashmap, allocator, 100, 3, 0));
+        TEST_INT64_EQUAL(hashmap.shard_count, (int64_t) 4);
+        TEST_BOOL(concurrent_int64_to_uint64_map_init(&hashmap, allocator, 4000, 0));
+        TEST_INT64_EQUAL(hashmap.shard_count, (int64_t) 64);
+
+        for (int64_t i = 0; i < 4000; ++i)
+        {
+            TEST_BOOL(concurrent_int64_to_uint64_map_insert(&hashmap, i * 3, (uint64_t) i));
+        }
+        TEST_INT64_EQUAL(concurrent_int64_to_uint64_map_item_count(&hashmap), (int64_t) 4000);
+
+        for (int64_t i = 0; i < 4000; ++i)
+        {
+            TEST_BOOL(concurrent_int64_to_uint64_map_update(&hashmap, i * 3, 0, concurrent_add_one, NULL));
+        }
+        // a missing key starts from the initial value
+        TEST_BOOL(concurrent_int64_to_uint64_map_update(&hashmap, -1, 100, concurrent_add_one, NULL));
+        TEST_BOOL(!concurrent_int64_to_uint64_map_update(&hashmap, -1, 100, NULL, NULL));
+
+        uint64_t value = 0;
+        TEST_BOOL(concurrent_int64_to_uint64_map_get(&hashmap, -1, &value));
+        TEST_UINT64_EQUAL(value, (uint64_t) 101);
+        TEST_BOOL(concurrent_int64_to_uint64_map_delete(&hashmap, -1));
+        TEST_BOOL(!concurrent_int64_to_uint64_map_delete(&hashmap, -1));
+        TEST_BOOL(!concurrent_int64_to_uint64_map_get(&hashmap, -1, &value));
+
+        for (int64_t i = 0; i < 4000; i += 2)
+        {
+            TEST_BOOL(concurrent_int64_to_uint64_map_delete(&hashmap, i * 3));
+        }
+
+        for (int64_t i = 0; i < 4000; ++i)
+        {
+            bool found = concurrent_int64_to_uint64_map_get(&hashmap, i * 3, &value);
+            if (i % 2 == 0)
+            {
+                TEST_BOOL(!found);
+            }
+            else
+            {
+                TEST_BOOL(found);
+                TEST_UINT64_EQUAL(value, (uint64_t) i + 1);
+            }
+        }
+        TEST_INT64_EQUAL(concurrent_int64_to_uint64_map_item_count(&hashmap), (int64_t) 2000);
+
+        int64_t iterated = 0;
+        int64_t key;
+        ConcurrentInt64ToUInt64MapIterator iterator;
+        TEST_BOOL(concurrent_int64_to_uint64_map_iterator_start(&hashmap, allocator, &iterator));
+        // the snapshot doesn't change with the map
+        concurrent_int64_to_uint64_map_clear(&hashmap);
+        while (concurrent_int64_to_uint64_map_iterator_next(&iterator, &key, &value))
+        {
+            TEST_BOOL(key % 6 == 3);
+            TEST_UINT64_EQUAL(value, (uint64_t) (key / 3) + 1);
+            ++iterated;
+        }
+        TEST_INT64_EQUAL(iterated, (int64_t) 2000);
+        concurrent_int64_to_uint64_map_iterator_free(&iterator);
+
+        TEST_INT64_EQUAL(concurrent_int64_to_uint64_map_item_count(&hashmap), (int64_t) 0);
+        TEST_BOOL(!concurrent_int64_to_uint64_map_get(&hashmap, 3, &value));
+
+        concurrent_int64_to_uint64_map_free(&hashmap);
+        TEST_INT64_EQUAL(concurrent_int64_to_uint64_map_item_count(&hashmap), (int64_t) -1);
+    }
+
+    jsl_allocator_interface_free_all(allocator);
+
+    // a full shard rejects new keys but still takes updates
+    {
+        ConcurrentInt64ToUInt64Map hashmap;
+        TEST_BOOL(concurrent_int64_to_uint64_map_init2(&hashmap, allocator, 0, 2, 0));
+
+        int64_t inserted = 0;
+        int64_t rejected_key = -1;
+        for (int64_t i = 0; i < 100; ++i)
+        {
+            if (concurrent_int64_to_uint64_map_insert(&hashmap, i, 0))
+                ++inserted;
+            else if (rejected_key < 0)
+                rejected_key = i;
+        }
+
+        TEST_INT64_EQUAL(inserted, hashmap.shard_max_item_count * 2);
+        TEST_BOOL(rejected_key > -1);
+        TEST_BOOL(!concurrent_int64_to_uint64_map_update(&hashmap, rejected_key, 0, concurrent_add_one, NULL));
+        TEST_BOOL(concurrent_int64_to_uint64_map_insert(&hashmap, 0, 7));
+        TEST_BOOL(concurrent_int64_to_uint64_map_update(&hashmap, 0, 0, concurrent_add_one, NULL));
+
+        uint64_t value = 0;
+        TEST_BOOL(concurrent_int64_to_uint64_map_get(&hashmap, 0, &value));
+        TEST_UINT64_EQUAL(value, (uint64_t) 8);
+    }
+
+    jsl_allocator_interface_free_all(allocator);
+
+    {
+        ConcurrentCompositeType2ToIntMap hashmap;
+        TEST_BOOL(concurrent_comp2_to_int_map_init(&hashmap, allocator, 500, 0));
+
+        for (int32_t i = 0; i < 500; ++i)
+        {
+            CompositeType2 key;
+            JSL_MEMSET(&key, 0, sizeof(CompositeType2));
+            key.a = i;
+            key.b = i * 2;
+            key.c = i % 3 == 0;
+            TEST_BOOL(concurrent_comp2_to_int_map_insert(&hashmap, &key, -i));
+        }
+
+        int64_t iterated = 0;
+        const CompositeType2* key;
+        int32_t value;
+        ConcurrentCompositeType2ToIntMapIterator iterator;
+        TEST_BOOL(concurrent_comp2_to_int_map_iterator_start(&hashmap, allocator, &iterator));
+        while (concurrent_comp2_to_int_map_iterator_next(&iterator, &key, &value))
+        {
+            TEST_BOOL(key->b == key->a * 2 && key->c == (key->a % 3 == 0) && value == -key->a);
+            ++iterated;
+        }
+        TEST_INT64_EQUAL(iterated, (int64_t) 500);
+        concurrent_comp2_to_int_map_iterator_free(&iterator);
+    }
+
+    jsl_allocator_interface_free_all(allocator);
+}
+
+#define CONCURRENT_THREAD_COUNT 8
+#define CONCURRENT_COUNTER_COUNT 512
+#define CONCURRENT_ITERATIONS 8192
+
+typedef struct ConcurrentWriterState
+{
+    ConcurrentInt64ToUInt64Map* map;
+    int64_t thread_index;
+    int64_t errors;
+} ConcurrentWriterState;
+
+static void concurrent_writer_loop(ConcurrentWriterState* state)
+{
+    for (int64_t i = 0; i < CONCURRENT_ITERATIONS; ++i)
+    {
+        // shared counters which every thread hits
+        if (!concurrent_int64_to_uint64_map_update(
+            state->map, i % CONCURRENT_COUNTER_COUNT, 0, concurrent_add_one, NULL
+        ))
+            ++state->errors;
+
+        // keys only this thread touches, every other one is deleted again
+        int64_t private_key = ((state->thread_index + 1) << 32) | i;
+        if (!concurrent_int64_to_uint64_map_insert(state->map, private_key, (uint64_t) i))
+            ++state->errors;
+
+        uint64_t value = 0;
+        if (!concurrent_int64_to_uint64_map_get(state->map, private_key, &value) || value != (uint64_t) i)
+            ++state->errors;
+
+        if (i % 2 == 1 && !concurrent_int64_to_uint64_map_delete(state->map, private_key))
+            ++state->errors;
+    }
+}
+
+#if JSL_IS_WINDOWS
+    static DWORD WINAPI concurrent_writer_entry(LPVOID arg)
+    {
+        concurrent_writer_loop((ConcurrentWriterState*) arg);
+        return 0;
+    }
+#else
+    static void* concurrent_writer_entry(void* arg)
+    {
+        concurrent_writer_loop((ConcurrentWriterState*) arg);
+        return NULL;
+    }
+#endif
+
+void test_concurrent_threaded_writers(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    ConcurrentInt64ToUInt64Map hashmap;
+    int64_t max_item_count = CONCURRENT_COUNTER_COUNT
+        + CONCURRENT_THREAD_COUNT * CONCURRENT_ITERATIONS / 2 + CONCURRENT_THREAD_COUNT;
+    TEST_BOOL(concurrent_int64_to_uint64_map_init2(&hashmap, allocator, max_item_count, 16, 0));
+
+    ConcurrentWriterState states[CONCURRENT_THREAD_COUNT];
+
+    #if JSL_IS_WINDOWS
+        HANDLE threads[CONCURRENT_THREAD_COUNT];
+    #else
+        pthread_t threads[CONCURRENT_THREAD_COUNT];
+    #endif
+
+    for (int32_t i = 0; i < CONCURRENT_THREAD_COUNT; ++i)
+    {
+        states[i] = (ConcurrentWriterState) { .map = &hashmap, .thread_index = i };
+        #if JSL_IS_WINDOWS
+            threads[i] = CreateThread(NULL, 0, concurrent_writer_entry, &states[i], 0, NULL);
+        #else
+            pthread_create(&threads[i], NULL, concurrent_writer_entry, &states[i]);
+        #endif
+    }
+
+    // snapshots taken while the writers run are still internally consistent
+    int64_t snapshot_errors = 0;
+    for (int32_t i = 0; i < 20; ++i)
+    {
+        ConcurrentInt64ToUInt64MapIterator iterator;
+        if (!concurrent_int64_to_uint64_map_iterator_start(&hashmap, allocator, &iterator))
+        {
+            ++snapshot_errors;
+            continue;
+        }
+
+        int64_t iterated = 0;
+        int64_t key;
+        uint64_t value;
+        while (concurrent_int64_to_uint64_map_iterator_next(&iterator, &key, &value))
+        {
+            if (key < CONCURRENT_COUNTER_COUNT && value > CONCURRENT_THREAD_COUNT * CONCURRENT_ITERATIONS / CONCURRENT_COUNTER_COUNT)
+                ++snapshot_errors;
+            ++iterated;
+        }
+        if (iterated != iterator.item_count)
+            ++snapshot_errors;
+
+        concurrent_int64_to_uint64_map_iterator_free(&iterator);
+    }
+
+    int64_t total_errors = 0;
+    for (int32_t i = 0; i < CONCURRENT_THREAD_COUNT; ++i)
+    {
+        #if JSL_IS_WINDOWS
+            WaitForSingleObject(threads[i], INFINITE);
+            CloseHandle(threads[i]);
+        #else
+            pthread_join(threads[i], NULL);
+        #endif
+
+        total_errors += states[i].errors;
+    }
+
+    TEST_INT64_EQUAL(total_errors, (int64_t) 0);
+    TEST_INT64_EQUAL(snapshot_errors, (int64_t) 0);
+
+    // no increments were lost
+    for (int64_t key = 0; key < CONCURRENT_COUNTER_COUNT; ++key)
+    {
+        uint64_t value = 0;
+        TEST_BOOL(concurrent_int64_to_uint64_map_get(&hashmap, key, &value));
+        TEST_UINT64_EQUAL(value, (uint64_t) (CONCURRENT_THREAD_COUNT * CONCURRENT_ITERATIONS / CONCURRENT_COUNTER_COUNT));
+    }
+
+    TEST_INT64_EQUAL(
+        concurrent_int64_to_uint64_map_item_count(&hashmap),
+        (int64_t) (CONCURRENT_COUNTER_COUNT + CONCURRENT_THREAD_COUNT * CONCURRENT_ITERATIONS / 2)
+    );
+
+    jsl_allocator_interface_free_all(allocator);
+}
+
+/**
+ * Total bytes currently handed out by a libc allocator, which records the
+ * requested size of every live allocation.
+ */
+static int64_t libc_allocated_bytes(JSLLibcAllocator* libc_allocator)
+{
+    int64_t total = 0;
+    for (struct JSL__LibcAllocationHeader* header = libc_allocator->head; header != NULL; header = header->prev)
+    {
+        total += header->length;
+    }
+    return total;
+}
+
+void test_fixed_memory_footprint(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    TEST_INT64_EQUAL(fixed_int32_to_int32_map_memory_footprint_for(-1), (int64_t) -1);
+    TEST_INT64_EQUAL(fixed_int32_to_int32_map_memory_footprint_for(INT64_MAX), (int64_t) -1);
+    TEST_INT64_EQUAL(fixed_int32_to_int32_map_memory_footprint(NULL), (int64_t) -1);
+
+    {
+        FixedIntToIntMap hashmap;
+        TEST_BOOL(fixed_int32_to_int32_map_init(&hashmap, allocator, 1000, 0));
+
+        // 1000 / 0.75 rounds up to 2048 slots of key, value, and hash
+        int64_t expected = 2048 * (int64_t) (sizeof(int32_t) * 2 + sizeof(uint64_t));
+        TEST_INT64_EQUAL(fixed_int32_to_int32_map_memory_footprint_for(1000), expected);
+        TEST_INT64_EQUAL(fixed_int32_to_int32_map_memory_footprint(&hashmap), expected);
+        TEST_INT64_EQUAL(libc_allocated_bytes(&libc_allocator), expected);
+
+        // the smallest table is 32 slots
+        TEST_INT64_EQUAL(
+            fixed_int32_to_int32_map_memory_footprint_for(0),
+            32 * (int64_t) (sizeof(int32_t) * 2 + sizeof(uint64_t))
+        );
+
+        fixed_int32_to_int32_map_free(&hashmap);
+    }
+
+    {
+        FixedStrToIntControlMap hashmap;
+        TEST_BOOL(fixed_str_to_int32_control_map_init(&hashmap, allocator, 300, 0));
+        TEST_INT64_EQUAL(
+            fixed_str_to_int32_control_map_memory_footprint(&hashmap),
+            fixed_str_to_int32_control_map_memory_footprint_for(300)
+        );
+
+        // borrowed keys aren't counted, copied ones are
+        TEST_BOOL(fixed_str_to_int32_control_map_insert(
+            &hashmap, JSL_CSTR_EXPRESSION("borrowed-key"), JSL_STRING_LIFETIME_LONGER, -1
+        ));
+
+        char buffer[64];
+        for (int32_t i = 0; i < 299; ++i)
+        {
+            snprintf(buffer, sizeof(buffer), "a-fairly-long-key-%d", i);
+            TEST_BOOL(fixed_str_to_int32_control_map_insert(
+                &hashmap, jsl_cstr_to_memory(buffer), JSL_STRING_LIFETIME_SHORTER, i
+            ));
+        }
+
+        TEST_INT64_EQUAL(
+            fixed_str_to_int32_control_map_memory_footprint(&hashmap),
+            libc_allocated_bytes(&libc_allocator)
+        );
+        TEST_BOOL(
+            fixed_str_to_int32_control_map_memory_footprint(&hashmap)
+            > fixed_str_to_int32_control_map_memory_footprint_for(300)
+        );
+
+        fixed_str_to_int32_control_map_free(&hashmap);
+    }
+
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+}
+
+void test_dynamic_reserve_and_shrink(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    TEST_INT64_EQUAL(dynamic_int32_to_int32_map_memory_footprint_for(-1, 0.75f), (int64_t) -1);
+    TEST_INT64_EQUAL(dynamic_int32_to_int32_map_memory_footprint_for(10, 1.0f), (int64_t) -1);
+    TEST_INT64_EQUAL(dynamic_int32_to_int32_map_memory_footprint_for(INT64_MAX, 0.75f), (int64_t) -1);
+
+    {
+        DynamicIntToIntMap hashmap;
+        TEST_BOOL(dynamic_int32_to_int32_map_init(&hashmap, allocator, 0));
+        TEST_BOOL(!dynamic_int32_to_int32_map_reserve(&hashmap, -1));
+        TEST_BOOL(!dynamic_int32_to_int32_map_reserve(NULL, 10));
+        TEST_BOOL(!dynamic_int32_to_int32_map_shrink_to_fit(NULL));
+
+        TEST_BOOL(dynamic_int32_to_int32_map_reserve(&hashmap, 5000));
+        int64_t reserved_length = hashmap.table.arrays_length;
+        TEST_INT64_EQUAL(reserved_length, (int64_t) 8192);
+        TEST_INT64_EQUAL(
+            dynamic_int32_to_int32_map_memory_footprint(&hashmap),
+            dynamic_int32_to_int32_map_memory_footprint_for(5000, 0.75f)
+        );
+
+        // a smaller reserve never shrinks
+        TEST_BOOL(dynamic_int32_to_int32_map_reserve(&hashmap, 10));
+        TEST_INT64_EQUAL(hashmap.table.arrays_length, reserved_length);
+
+        for (int32_t i = 0; i < 5000; ++i)
+        {
+            TEST_BOOL(dynamic_int32_to_int32_map_insert(&hashmap, i, i * 2));
+        }
+
+        // no growth along the way
+        TEST_INT64_EQUAL(hashmap.table.arrays_length, reserved_length);
+        TEST_INT64_EQUAL(
+            dynamic_int32_to_int32_map_memory_footprint(&hashmap),
+            libc_allocated_bytes(&libc_allocator)
+        );
+
+        for (int32_t i = 100; i < 5000; ++i)
+        {
+            TEST_BOOL(dynamic_int32_to_int32_map_delete(&hashmap, i));
+        }
+
+        TEST_BOOL(dynamic_int32_to_int32_map_shrink_to_fit(&hashmap));
+        TEST_INT64_EQUAL(hashmap.table.arrays_length, (int64_t) 256);
+        TEST_INT64_EQUAL(
+            dynamic_int32_to_int32_map_memory_footprint(&hashmap),
+            libc_allocated_bytes(&libc_allocator)
+        );
+
+        for (int32_t i = 0; i < 5000; ++i)
+        {
+            int32_t* value = dynamic_int32_to_int32_map_get(&hashmap, i);
+            if (i < 100)
+                TEST_BOOL(value != NULL && *value == i * 2);
+            else
+                TEST_POINTERS_EQUAL(value, NULL);
+        }
+
+        // shrinking an already tight map does nothing
+        TEST_BOOL(dynamic_int32_to_int32_map_shrink_to_fit(&hashmap));
+        TEST_INT64_EQUAL(hashmap.table.arrays_length, (int64_t) 256);
+
+        // both tables are counted while a rehash is in progress
+        TEST_BOOL(dynamic_int32_to_int32_map_enable_incremental_rehash(&hashmap, 1));
+        int32_t key = 100;
+        while (hashmap.old_table.hashes_array == NULL)
+        {
+            TEST_BOOL(dynamic_int32_to_int32_map_insert(&hashmap, key, key * 2));
+            ++key;
+        }
+        TEST_INT64_EQUAL(
+            dynamic_int32_to_int32_map_memory_footprint(&hashmap),
+            libc_allocated_bytes(&libc_allocator)
+        );
+
+        // and shrinking finishes it first
+        TEST_BOOL(dynamic_int32_to_int32_map_shrink_to_fit(&hashmap));
+        TEST_POINTERS_EQUAL(hashmap.old_table.hashes_array, NULL);
+        TEST_INT64_EQUAL(dynamic_int32_to_int32_map_item_count(&hashmap), (int64_t) key);
+        for (int32_t i = 0; i < key; ++i)
+        {
+            int32_t* value = dynamic_int32_to_int32_map_get(&hashmap, i);
+            TEST_BOOL(value != NULL && *value == i * 2);
+        }
+
+        dynamic_int32_to_int32_map_free(&hashmap);
+    }
+
+    {
+        DynamicStrToIntMap hashmap;
+        TEST_BOOL(dynamic_str_to_int32_map_init(&hashmap, allocator, 0));
+
+        char buffer[64];
+        for (int32_t i = 0; i < 500; ++i)
+        {
+            snprintf(buffer, sizeof(buffer), "dynamic-key-%d", i);
+            TEST_BOOL(dynamic_str_to_int32_map_insert(
+                &hashmap, jsl_cstr_to_memory(buffer), JSL_STRING_LIFETIME_SHORTER, i
+            ));
+        }
+
+        TEST_INT64_EQUAL(
+            dynamic_str_to_int32_map_memory_footprint(&hashmap),
+            libc_allocated_bytes(&libc_allocator)
+        );
+
+        for (int32_t i = 0; i < 490; ++i)
+        {
+            snprintf(buffer, sizeof(buffer), "dynamic-key-%d", i);
+            TEST_BOOL(dynamic_str_to_int32_map_delete(&hashmap, jsl_cstr_to_memory(buffer)));
+        }
+
+        TEST_BOOL(dynamic_str_to_int32_map_shrink_to_fit(&hashmap));
+        TEST_INT64_EQUAL(hashmap.table.arrays_length, (int64_t) 32);
+        TEST_INT64_EQUAL(
+            dynamic_str_to_int32_map_memory_footprint(&hashmap),
+            libc_allocated_bytes(&libc_allocator)
+        );
+
+        snprintf(buffer, sizeof(buffer), "dynamic-key-%d", 495);
+        int32_t* value = dynamic_str_to_int32_map_get(&hashmap, jsl_cstr_to_memory(buffer));
+        TEST_BOOL(value != NULL && *value == 495);
+
+        dynamic_str_to_int32_map_free(&hashmap);
+    }
+
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+}
+
+void test_concurrent_memory_footprint(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    ConcurrentInt64ToUInt64Map hashmap;
+    TEST_INT64_EQUAL(concurrent_int64_to_uint64_map_memory_footprint(NULL), (int64_t) -1);
+    TEST_BOOL(concurrent_int64_to_uint64_map_init2(&hashmap, allocator, 10000, 8, 0));
+
+    int64_t footprint = concurrent_int64_to_uint64_map_memory_footprint(&hashmap);
+    TEST_INT64_EQUAL(footprint, libc_allocated_bytes(&libc_allocator));
+
+    for (int64_t i = 0; i < 10000; ++i)
+    {
+        TEST_BOOL(concurrent_int64_to_uint64_map_insert(&hashmap, i, (uint64_t) i));
+    }
+    TEST_INT64_EQUAL(concurrent_int64_to_uint64_map_memory_footprint(&hashmap), footprint);
+
+    concurrent_int64_to_uint64_map_free(&hashmap);
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+}
+
+void test_generated_sets(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    {
+        FixedIntSet set;
+        TEST_BOOL(fixed_int32_set_init(&set, allocator, 100, 0));
+
+        // a set has no values array at all
+        TEST_INT64_EQUAL(
+            fixed_int32_set_memory_footprint(&set),
+            256 * (int64_t) (sizeof(int32_t) + sizeof(uint64_t))
+        );
+        TEST_INT64_EQUAL(fixed_int32_set_memory_footprint(&set), libc_allocated_bytes(&libc_allocator));
+
+        for (int32_t i = 0; i < 50; ++i)
+        {
+            TEST_BOOL(fixed_int32_set_insert(&set, i * 3));
+        }
+        // inserting again changes nothing
+        for (int32_t i = 0; i < 50; ++i)
+        {
+            TEST_BOOL(fixed_int32_set_insert(&set, i * 3));
+        }
+        TEST_INT64_EQUAL(set.item_count, (int64_t) 50);
+
+        for (int32_t i = 50; i < 100; ++i)
+        {
+            TEST_BOOL(fixed_int32_set_insert(&set, i * 3));
+        }
+        TEST_INT64_EQUAL(set.item_count, (int64_t) 100);
+        TEST_BOOL(!fixed_int32_set_insert(&set, 1000));
+
+        for (int32_t i = 0; i < 300; ++i)
+        {
+            TEST_BOOL(fixed_int32_set_has(&set, i) == (i % 3 == 0));
+        }
+
+        TEST_BOOL(fixed_int32_set_delete(&set, 3));
+        TEST_BOOL(!fixed_int32_set_delete(&set, 3));
+        TEST_BOOL(!fixed_int32_set_has(&set, 3));
+
+        FixedIntSetIterator iterator;
+        TEST_BOOL(fixed_int32_set_iterator_start(&set, &iterator));
+        int32_t key;
+        int64_t seen = 0;
+        int64_t sum = 0;
+        while (fixed_int32_set_iterator_next(&iterator, &key))
+        {
+            ++seen;
+            sum += key;
+        }
+        TEST_INT64_EQUAL(seen, (int64_t) 99);
+        // 3 * (0 + 1 + ... + 99) - 3
+        TEST_INT64_EQUAL(sum, (int64_t) 14847);
+
+        fixed_int32_set_free(&set);
+    }
+
+    {
+        FixedStrSet set;
+        TEST_BOOL(fixed_str_set_init(&set, allocator, 50, 0));
+
+        char buffer[64];
+        for (int32_t i = 0; i < 50; ++i)
+        {
+            snprintf(buffer, sizeof(buffer), "set-member-%d", i);
+            TEST_BOOL(fixed_str_set_insert(&set, jsl_cstr_to_memory(buffer), JSL_STRING_LIFETIME_SHORTER));
+        }
+
+        // the keys were copied, so overwriting the buffer doesn't matter
+        snprintf(buffer, sizeof(buffer), "set-member-%d", 7);
+        TEST_BOOL(fixed_str_set_has(&set, jsl_cstr_to_memory(buffer)));
+        snprintf(buffer, sizeof(buffer), "set-member-%d", 50);
+        TEST_BOOL(!fixed_str_set_has(&set, jsl_cstr_to_memory(buffer)));
+
+        snprintf(buffer, sizeof(buffer), "set-member-%d", 7);
+        TEST_BOOL(fixed_str_set_delete(&set, jsl_cstr_to_memory(buffer)));
+        TEST_BOOL(!fixed_str_set_has(&set, jsl_cstr_to_memory(buffer)));
+
+        TEST_INT64_EQUAL(fixed_str_set_memory_footprint(&set), libc_allocated_bytes(&libc_allocator));
+
+        FixedStrSetIterator iterator;
+        TEST_BOOL(fixed_str_set_iterator_start(&set, &iterator));
+        JSLImmutableMemory key;
+        int64_t seen = 0;
+        while (fixed_str_set_iterator_next(&iterator, &key))
+        {
+            TEST_BOOL(jsl_starts_with(key, JSL_CSTR_EXPRESSION("set-member-")));
+            ++seen;
+        }
+        TEST_INT64_EQUAL(seen, (int64_t) 49);
+
+        fixed_str_set_free(&set);
+    }
+
+    {
+        DynamicInt64Set set;
+        TEST_BOOL(dynamic_int64_set_init(&set, allocator, 0));
+
+        static bool present[2048];
+        JSL_MEMSET(present, 0, sizeof(present));
+
+        // random churn with growth, checked against a plain array
+        uint64_t state = 88172645463325252ULL;
+        for (int32_t i = 0; i < 20000; ++i)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            int64_t key = (int64_t) (state % 2048);
+
+            if (present[key] && (state >> 32) % 3 == 0)
+            {
+                TEST_BOOL(dynamic_int64_set_delete(&set, key));
+                present[key] = false;
+            }
+            else
+            {
+                TEST_BOOL(dynamic_int64_set_insert(&set, key));
+                present[key] = true;
+            }
+        }
+
+        int64_t expected_count = 0;
+        for (int64_t key = 0; key < 2048; ++key)
+        {
+            if (present[key])
+                ++expected_count;
+            TEST_BOOL(dynamic_int64_set_has(&set, key) == present[key]);
+        }
+        TEST_INT64_EQUAL(dynamic_int64_set_item_count(&set), expected_count);
+
+        TEST_BOOL(dynamic_int64_set_shrink_to_fit(&set));
+        TEST_INT64_EQUAL(dynamic_int64_set_memory_footprint(&set), libc_allocated_bytes(&libc_allocator));
+
+        dynamic_int64_set_free(&set);
+    }
+
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+}
+
+void test_cache_basic(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    Int64ToInt32Cache cache;
+    TEST_BOOL(!int64_to_int32_cache_init(&cache, allocator, 0, 0));
+    TEST_BOOL(!int64_to_int32_cache_init(&cache, allocator, (int64_t) INT32_MAX + 1, 0));
+    TEST_BOOL(!int64_to_int32_cache_init(NULL, allocator, 10, 0));
+    TEST_INT64_EQUAL(int64_to_int32_cache_memory_footprint_for(0), (int64_t) -1);
+
+    TEST_BOOL(int64_to_int32_cache_init(&cache, allocator, 100, 0));
+
+    // everything is allocated up front
+    int64_t footprint = int64_to_int32_cache_memory_footprint(&cache);
+    TEST_INT64_EQUAL(footprint, int64_to_int32_cache_memory_footprint_for(100));
+    TEST_INT64_EQUAL(footprint, libc_allocated_bytes(&libc_allocator));
+
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        TEST_BOOL(int64_to_int32_cache_insert(&cache, i, (int32_t) i * 2));
+    }
+    TEST_INT64_EQUAL(cache.item_count, (int64_t) 100);
+    TEST_INT64_EQUAL(cache.eviction_count, (int64_t) 0);
+    TEST_INT64_EQUAL(libc_allocated_bytes(&libc_allocator), footprint);
+
+    // updating a key doesn't take a new entry
+    TEST_BOOL(int64_to_int32_cache_insert(&cache, 10, -1));
+    TEST_INT64_EQUAL(cache.item_count, (int64_t) 100);
+
+    int32_t* value = int64_to_int32_cache_get(&cache, 10);
+    TEST_BOOL(value != NULL && *value == -1);
+    value = int64_to_int32_cache_get(&cache, 99);
+    TEST_BOOL(value != NULL && *value == 198);
+    TEST_POINTERS_EQUAL(int64_to_int32_cache_get(&cache, 100), NULL);
+    TEST_INT64_EQUAL(cache.hit_count, (int64_t) 2);
+    TEST_INT64_EQUAL(cache.miss_count, (int64_t) 1);
+
+    // deleting moves the last entry into the hole
+    TEST_BOOL(int64_to_int32_cache_delete(&cache, 0));
+    TEST_BOOL(!int64_to_int32_cache_delete(&cache, 0));
+    TEST_INT64_EQUAL(cache.item_count, (int64_t) 99);
+    for (int64_t i = 1; i < 100; ++i)
+    {
+        value = int64_to_int32_cache_get(&cache, i);
+        TEST_BOOL(value != NULL && *value == (i == 10 ? -1 : (int32_t) i * 2));
+    }
+
+    Int64ToInt32CacheIterator iterator;
+    TEST_BOOL(int64_to_int32_cache_iterator_start(&cache, &iterator));
+    int64_t key;
+    int32_t iterated_value;
+    int64_t seen = 0;
+    while (int64_to_int32_cache_iterator_next(&iterator, &key, &iterated_value))
+    {
+        TEST_BOOL(key > 0 && key < 100);
+        ++seen;
+    }
+    TEST_INT64_EQUAL(seen, (int64_t) 99);
+
+    // mutation invalidates the iterator
+    TEST_BOOL(int64_to_int32_cache_iterator_start(&cache, &iterator));
+    TEST_BOOL(int64_to_int32_cache_insert(&cache, 500, 1));
+    TEST_BOOL(!int64_to_int32_cache_iterator_next(&iterator, &key, &iterated_value));
+
+    int64_to_int32_cache_clear(&cache);
+    TEST_INT64_EQUAL(cache.item_count, (int64_t) 0);
+    TEST_POINTERS_EQUAL(int64_to_int32_cache_get(&cache, 1), NULL);
+    TEST_BOOL(int64_to_int32_cache_insert(&cache, 1, 1));
+
+    int64_to_int32_cache_free(&cache);
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+    TEST_BOOL(!int64_to_int32_cache_insert(&cache, 1, 1));
+
+    {
+        CompositeType2ToIntCache struct_cache;
+        TEST_BOOL(comp2_to_int_cache_init(&struct_cache, allocator, 16, 0));
+
+        for (int32_t i = 0; i < 16; ++i)
+        {
+            CompositeType2 struct_key;
+            JSL_MEMSET(&struct_key, 0, sizeof(struct_key));
+            struct_key.a = i;
+            struct_key.b = -i;
+            struct_key.c = (i & 1) == 1;
+            TEST_BOOL(comp2_to_int_cache_insert(&struct_cache, &struct_key, i));
+        }
+
+        CompositeType2 struct_key;
+        JSL_MEMSET(&struct_key, 0, sizeof(struct_key));
+        struct_key.a = 5;
+        struct_key.b = -5;
+        struct_key.c = true;
+        value = comp2_to_int_cache_get(&struct_cache, &struct_key);
+        TEST_BOOL(value != NULL && *value == 5);
+
+        struct_key.c = false;
+        TEST_POINTERS_EQUAL(comp2_to_int_cache_get(&struct_cache, &struct_key), NULL);
+
+        comp2_to_int_cache_free(&struct_cache);
+    }
+
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+}
+
+typedef struct CacheEvictLog {
+    int64_t keys[8];
+    int64_t count;
+} CacheEvictLog;
+
+static void cache_evict_logger(int64_t key, int32_t* value, void* user_data)
+{
+    CacheEvictLog* log = (CacheEvictLog*) user_data;
+    if (*value == (int32_t) key * 10 && log->count < 8)
+        log->keys[log->count] = key;
+    ++log->count;
+}
+
+void test_cache_clock_eviction(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    CacheEvictLog log;
+    JSL_MEMSET(&log, 0, sizeof(log));
+
+    Int64ToInt32Cache cache;
+    TEST_BOOL(int64_to_int32_cache_init(&cache, allocator, 4, 0));
+    int64_to_int32_cache_set_evict_function(&cache, cache_evict_logger, &log);
+
+    for (int64_t i = 0; i < 4; ++i)
+    {
+        TEST_BOOL(int64_to_int32_cache_insert(&cache, i, (int32_t) i * 10));
+    }
+
+    TEST_BOOL(int64_to_int32_cache_get(&cache, 0) != NULL);
+    TEST_BOOL(int64_to_int32_cache_get(&cache, 2) != NULL);
+
+    // The hand clears 0's reference and takes 1, then clears 2's and
+    // takes 3, so the keys which were read survive
+    TEST_BOOL(int64_to_int32_cache_insert(&cache, 4, 40));
+    TEST_BOOL(int64_to_int32_cache_insert(&cache, 5, 50));
+
+    TEST_INT64_EQUAL(log.count, (int64_t) 2);
+    TEST_INT64_EQUAL(log.keys[0], (int64_t) 1);
+    TEST_INT64_EQUAL(log.keys[1], (int64_t) 3);
+    TEST_INT64_EQUAL(cache.eviction_count, (int64_t) 2);
+    TEST_INT64_EQUAL(cache.item_count, (int64_t) 4);
+
+    TEST_POINTERS_EQUAL(int64_to_int32_cache_get(&cache, 1), NULL);
+    TEST_POINTERS_EQUAL(int64_to_int32_cache_get(&cache, 3), NULL);
+    for (int64_t key = 0; key < 6; key += 2)
+    {
+        int32_t* value = int64_to_int32_cache_get(&cache, key);
+        TEST_BOOL(value != NULL && *value == (int32_t) key * 10);
+    }
+    int32_t* value = int64_to_int32_cache_get(&cache, 5);
+    TEST_BOOL(value != NULL && *value == 50);
+
+    // once every entry has been read, the hand goes all the way around
+    // and takes the first one it cleared
+    TEST_BOOL(int64_to_int32_cache_insert(&cache, 6, 60));
+    TEST_INT64_EQUAL(log.count, (int64_t) 3);
+    TEST_INT64_EQUAL(cache.eviction_count, (int64_t) 3);
+    TEST_INT64_EQUAL(cache.item_count, (int64_t) 4);
+
+    int64_t remaining = 0;
+    for (int64_t key = 0; key < 7; ++key)
+    {
+        if (int64_to_int32_cache_get(&cache, key) != NULL)
+            ++remaining;
+    }
+    TEST_INT64_EQUAL(remaining, (int64_t) 4);
+    TEST_BOOL(int64_to_int32_cache_get(&cache, 6) != NULL);
+}
+
+void test_cache_churn(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    Int64ToInt32Cache cache;
+    TEST_BOOL(int64_to_int32_cache_init(&cache, allocator, 300, 0));
+
+    static bool present[1024];
+    JSL_MEMSET(present, 0, sizeof(present));
+
+    // random churn which never fills the cache, checked against a plain array
+    uint64_t state = 88172645463325252ULL;
+    for (int32_t i = 0; i < 20000; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        int64_t key = (int64_t) (state % 1024);
+
+        if (present[key] && (state >> 32) % 2 == 0)
+        {
+            TEST_BOOL(int64_to_int32_cache_delete(&cache, key));
+            present[key] = false;
+        }
+        else if (present[key])
+        {
+            int32_t* value = int64_to_int32_cache_get(&cache, key);
+            TEST_BOOL(value != NULL && *value == (int32_t) key * 3);
+        }
+        else if (cache.item_count < cache.capacity)
+        {
+            TEST_BOOL(int64_to_int32_cache_insert(&cache, key, (int32_t) key * 3));
+            present[key] = true;
+        }
+    }
+
+    int64_t expected_count = 0;
+    for (int64_t key = 0; key < 1024; ++key)
+    {
+        int32_t* value = int64_to_int32_cache_get(&cache, key);
+        if (present[key])
+        {
+            ++expected_count;
+            TEST_BOOL(value != NULL && *value == (int32_t) key * 3);
+        }
+        else
+        {
+            TEST_POINTERS_EQUAL(value, NULL);
+        }
+    }
+    TEST_INT64_EQUAL(cache.item_count, expected_count);
+    TEST_INT64_EQUAL(cache.eviction_count, (int64_t) 0);
+
+    // now keep it full, every entry found by iteration must be reachable
+    // through the table and nothing else may be
+    for (int32_t i = 0; i < 20000; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        int64_t key = (int64_t) (state % 1024);
+
+        if ((state >> 32) % 4 == 0)
+            (void) int64_to_int32_cache_delete(&cache, key);
+        else if ((state >> 32) % 4 == 1)
+            (void) int64_to_int32_cache_get(&cache, key);
+        else
+            TEST_BOOL(int64_to_int32_cache_insert(&cache, key, (int32_t) key * 3));
+    }
+
+    JSL_MEMSET(present, 0, sizeof(present));
+    Int64ToInt32CacheIterator iterator;
+    TEST_BOOL(int64_to_int32_cache_iterator_start(&cache, &iterator));
+    int64_t key;
+    int32_t iterated_value;
+    int64_t seen = 0;
+    while (int64_to_int32_cache_iterator_next(&iterator, &key, &iterated_value))
+    {
+        TEST_BOOL(!present[key]);
+        TEST_INT64_EQUAL((int64_t) iterated_value, key * 3);
+        present[key] = true;
+        ++seen;
+    }
+    TEST_INT64_EQUAL(seen, cache.item_count);
+    TEST_BOOL(cache.eviction_count > 0);
+
+    for (key = 0; key < 1024; ++key)
+    {
+        TEST_BOOL((int64_to_int32_cache_get(&cache, key) != NULL) == present[key]);
+    }
+}
+
+typedef struct ExpectedPair {
+    JSLImmutableMemory key;
+    JSLImmutableMemory value;
+    bool seen;
+} ExpectedPair;
+
+void test_jsl_str_to_str_map_init_success(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrToStrMap map = {0};
+    bool ok = jsl_str_to_str_map_init2(&map, allocator, 0xBEEF, 64, 0.5f);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    TEST_BOOL(map.entry_lookup_table != NULL);
+    int64_t expected_length = JSL_MAX(32L, jsl_next_power_of_two_i64(65));
+    TEST_INT64_EQUAL(map.entry_lookup_table_length, expected_length);
+    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) 0);
+    TEST_BOOL(map.load_factor == 0.5f);
+}
+
+void test_jsl_str_to_str_map_init_invalid_arguments(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrToStrMap map = {0};
+
+    TEST_BOOL(!jsl_str_to_str_map_init2(NULL, allocator, 0, 8, 0.5f));
+    TEST_BOOL(!jsl_str_to_str_map_init2(&map, allocator, 0, 0, 0.5f));
+    TEST_BOOL(!jsl_str_to_str_map_init2(&map, allocator, 0, -4, 0.5f));
+    TEST_BOOL(!jsl_str_to_str_map_init2(&map, allocator, 0, 4, 0.0f));
+    TEST_BOOL(!jsl_str_to_str_map_init2(&map, allocator, 0, 4, 1.0f));
+    TEST_BOOL(!jsl_str_to_str_map_init2(&map, allocator, 0, 4, 1.5f));
+}
+
+void test_jsl_str_to_str_map_item_count_and_has_key(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrToStrMap map = {0};
+    bool ok = jsl_str_to_str_map_init(&map, allocator, 1234);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) 0);
+
+    JSLImmutableMemory key1 = JSL_CSTR_INITIALIZER("alpha");
+    JSLImmutableMemory key2 = JSL_CSTR_INITIALIZER("beta");
+    JSLImmutableMemory missing = JSL_CSTR_INITIALIZER("missing");
+
+    TEST_BOOL(jsl_str_to_str_map_insert(&map, key1, JSL_STRING_LIFETIME_LONGER, JSL_CSTR_EXPRESSION("one"), JSL_STRING_LIFETIME_LONGER));
+    TEST_BOOL(jsl_str_to_str_map_insert(&map, key2, JSL_STRING_LIFETIME_LONGER, JSL_CSTR_EXPRESSION("two"), JSL_STRING_LIFETIME_LONGER));
+
+    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) 2);
+    TEST_BOOL(jsl_str_to_str_map_has_key(&map, key1));
+    TEST_BOOL(jsl_str_to_str_map_has_key(&map, key2));
+    TEST_BOOL(!jsl_str_to_str_map_has_key(&map, missing));
+
+    JSLStrToStrMap uninitialized = {0};
+    TEST_BOOL(!jsl_str_to_str_map_has_key(&uninitialized, key1));
+    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&uninitialized), (int64_t) -1);
+}
+
+void test_jsl_str_to_str_map_get(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrToStrMap map = {0};
+    bool ok = jsl_str_to_str_map_init2(&map, allocator, 2468, 8, 0.6f);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLImmutableMemory key = JSL_CSTR_INITIALIZER("lookup-key");
+    JSLImmutableMemory value = JSL_CSTR_INITIALIZER("lookup-value");
+
+    JSLImmutableMemory out_value = JSL_CSTR_EXPRESSION("should-reset");
+    TEST_BOOL(!jsl_str_to_str_map_get(&map, key, &out_value));
+    TEST_INT64_EQUAL(out_value.length, (int64_t) 0);
+
+    TEST_BOOL(jsl_str_to_str_map_insert(
+        &map,
+        key, JSL_STRING_LIFETIME_LONGER,
+        value, JSL_STRING_LIFETIME_LONGER
+    ));
+
+    TEST_BOOL(jsl_str_to_str_map_get(&map, key, &out_value));
+    TEST_BOOL(jsl_memory_compare(out_value, value));
+
+    JSLImmutableMemory missing = JSL_CSTR_INITIALIZER("missing");
+    out_value = JSL_CSTR_EXPRESSION("still-reset");
+    TEST_BOOL(!jsl_str_to_str_map_get(&map, missing, &out_value));
+    TEST_INT64_EQUAL(out_value.length, (int64_t) 0);
+
+    TEST_BOOL(!jsl_str_to_str_map_get(&map, key, NULL));
+}
+
+void test_jsl_str_to_str_map_insert_overwrites_value(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrToStrMap map = {0};
+    bool ok = jsl_str_to_str_map_init2(&map, allocator, 42, 8, 0.7f);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLImmutableMemory key = JSL_CSTR_INITIALIZER("dup-key");
+
+    TEST_BOOL(jsl_str_to_str_map_insert(&map, key, JSL_STRING_LIFETIME_LONGER, JSL_CSTR_EXPRESSION("first"), JSL_STRING_LIFETIME_LONGER));
+    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) 1);
+
+    TEST_BOOL(jsl_str_to_str_map_insert(&map, key, JSL_STRING_LIFETIME_LONGER, JSL_CSTR_EXPRESSION("second"), JSL_STRING_LIFETIME_LONGER));
+    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) 1);
+
+    JSLStrToStrMapKeyValueIter iter;
+    jsl_str_to_str_map_key_value_iterator_init(&map, &iter);
+
+    JSLImmutableMemory out_key = (JSLImmutableMemory) {0};
+    JSLImmutableMemory out_value = (JSLImmutableMemory) {0};
+    bool found = false;
+    while (jsl_str_to_str_map_key_value_iterator_next(&iter, &out_key, &out_value))
+    {
+        if (jsl_memory_compare(out_key, key))
+        {
+            found = true;
+            TEST_BOOL(jsl_memory_compare(out_value, JSL_CSTR_EXPRESSION("second")));
+            break;
+        }
+    }
+
+    TEST_BOOL(found);
+}
+
+void test_jsl_str_to_str_map_transient_lifetime_copies_data(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrToStrMap map = {0};
+    bool ok = jsl_str_to_str_map_init2(&map, allocator, 555, 8, 0.6f);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    char key_small_buf[] = "short";
+    char val_small_buf[] = "miniVal";
+    char key_long_buf[] = "a-longer-key";
+    char val_long_buf[] = "a-longer-value";
+
+    JSLImmutableMemory key_small = jsl_cstr_to_memory(key_small_buf);
+    JSLImmutableMemory val_small = jsl_cstr_to_memory(val_small_buf);
+    JSLImmutableMemory key_long = jsl_cstr_to_memory(key_long_buf);
+    JSLImmutableMemory val_long = jsl_cstr_to_memory(val_long_buf);
+
+    TEST_BOOL(jsl_str_to_str_map_insert(&map, key_small, JSL_STRING_LIFETIME_SHORTER, val_small, JSL_STRING_LIFETIME_SHORTER));
+    TEST_BOOL(jsl_str_to_str_map_insert(&map, key_long, JSL_STRING_LIFETIME_SHORTER, val_long, JSL_STRING_LIFETIME_SHORTER));
+
+    key_small_buf[0] = 'X';
+    val_small_buf[0] = 'Z';
+    key_long_buf[0] = 'Y';
+    val_long_buf[0] = 'Q';
+
+    const JSLImmutableMemory expected_small_key = JSL_CSTR_EXPRESSION("short");
+    const JSLImmutableMemory expected_small_value = JSL_CSTR_EXPRESSION("miniVal");
+    const JSLImmutableMemory expected_long_key = JSL_CSTR_EXPRESSION("a-longer-key");
+    const JSLImmutableMemory expected_long_value = JSL_CSTR_EXPRESSION("a-longer-value");
+
+    JSLStrToStrMapKeyValueIter iter;
+    jsl_str_to_str_map_key_value_iterator_init(&map, &iter);
+
+    bool saw_small = false;
+    bool saw_long = false;
+    JSLImmutableMemory out_key = (JSLImmutableMemory) {0};
+    JSLImmutableMemory out_value = (JSLImmutableMemory) {0};
+    while (jsl_str_to_str_map_key_value_iterator_next(&iter, &out_key, &out_value))
+    {
+        if (jsl_memory_compare(out_key, expected_small_key))
+        {
+            saw_small = true;
+            TEST_BOOL(jsl_memory_compare(out_value, expected_small_value));
+            TEST_BOOL(out_key.data != (uint8_t*) key_small_buf);
+            TEST_BOOL(out_value.data != (uint8_t*) val_small_buf);
+        }
+        else if (jsl_memory_compare(out_key, expected_long_key))
+        {
+            saw_long = true;
+            TEST_BOOL(jsl_memory_compare(out_value, expected_long_value));
+            TEST_BOOL(out_key.data != (uint8_t*) key_long_buf);
+            TEST_BOOL(out_value.data != (uint8_t*) val_long_buf);
+        }
+    }
+
+    TEST_BOOL(saw_small);
+    TEST_BOOL(saw_long);
+}
+
+void test_jsl_str_to_str_map_fixed_lifetime_uses_original_pointers(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrToStrMap map = {0};
+    bool ok = jsl_str_to_str_map_init2(&map, allocator, 777, 8, 0.65f);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLImmutableMemory key = JSL_CSTR_INITIALIZER("fixed-key");
+    JSLImmutableMemory value = JSL_CSTR_INITIALIZER("fixed-value");
+
+    const uint8_t* expected_key_ptr = key.data;
+    const uint8_t* expected_val_ptr = value.data;
+
+    TEST_BOOL(jsl_str_to_str_map_insert(&map, key, JSL_STRING_LIFETIME_LONGER, value, JSL_STRING_LIFETIME_LONGER));
+
+    JSLStrToStrMapKeyValueIter iter;
+    jsl_str_to_str_map_key_value_iterator_init(&map, &iter);
+
+    JSLImmutableMemory out_key = (JSLImmutableMemory) {0};
+    JSLImmutableMemory out_value = (JSLImmutableMemory) {0};
     bool found = jsl_str_to_str_map_key_value_iterator_next(&iter, &out_key, &out_value);
     TEST_BOOL(found);
     if (!found) return;
@@ -1505,6 +3291,169 @@ void test_jsl_str_to_str_map_rehash(void)
     #undef key_count
 }
 
+void test_jsl_str_to_str_map_delete_churn(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrToStrMap map = {0};
+    bool ok = jsl_str_to_str_map_init2(&map, allocator, 9090, 64, 0.75f);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    int64_t table_length = map.entry_lookup_table_length;
+
+    // replace the whole population every round, deletes must not leave
+    // anything behind that makes the table grow or lookups fail
+    for (int round = 0; round < 20; ++round)
+    {
+        JSLImmutableMemory keys[64];
+
+        for (int i = 0; i < 64; ++i)
+        {
+            keys[i] = jsl_format(allocator, JSL_CSTR_EXPRESSION("r%d-%d"), round, i);
+            TEST_BOOL(jsl_str_to_str_map_insert(
+                &map,
+                keys[i], JSL_STRING_LIFETIME_LONGER,
+                keys[i], JSL_STRING_LIFETIME_LONGER
+            ));
+        }
+
+        // delete every other key first so the survivors have to be
+        // found across the holes the deletes left
+        for (int i = 0; i < 64; i += 2)
+        {
+            TEST_BOOL(jsl_str_to_str_map_delete(&map, keys[i]));
+        }
+
+        for (int i = 1; i < 64; i += 2)
+        {
+            JSLImmutableMemory out_value = {0};
+            TEST_BOOL(jsl_str_to_str_map_get(&map, keys[i], &out_value));
+            TEST_BOOL(jsl_memory_compare(out_value, keys[i]));
+            TEST_BOOL(jsl_str_to_str_map_delete(&map, keys[i]));
+        }
+
+        TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) 0);
+    }
+
+    TEST_INT64_EQUAL(map.entry_lookup_table_length, table_length);
+
+    for (int64_t i = 0; i < map.entry_lookup_table_length; ++i)
+    {
+        TEST_BOOL(map.entry_lookup_table[i] == JSL__MAP_EMPTY);
+    }
+}
+
+void test_jsl_str_to_str_map_incremental_rehash(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrToStrMap map = {0};
+    bool ok = jsl_str_to_str_map_init2(&map, allocator, 5555, 4, 0.5f);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    TEST_BOOL(!jsl_str_to_str_map_enable_incremental_rehash(&map, -1));
+    TEST_BOOL(jsl_str_to_str_map_enable_incremental_rehash(&map, 2));
+
+    #define max_keys 256
+    JSLImmutableMemory keys[max_keys] = {0};
+    JSLImmutableMemory values[max_keys] = {0};
+
+    // keep inserting until a table grow leaves a rehash in progress
+    int key_count = 0;
+    while (key_count < max_keys)
+    {
+        keys[key_count] = jsl_format(allocator, JSL_CSTR_EXPRESSION("key-%d"), key_count);
+        values[key_count] = jsl_format(allocator, JSL_CSTR_EXPRESSION("val-%d"), key_count);
+
+        bool insert_res = jsl_str_to_str_map_insert(
+            &map,
+            keys[key_count], JSL_STRING_LIFETIME_LONGER,
+            values[key_count], JSL_STRING_LIFETIME_LONGER
+        );
+        TEST_BOOL(insert_res);
+        ++key_count;
+
+        if (key_count > 16 && map.old_entry_lookup_table != NULL)
+            break;
+    }
+
+    TEST_BOOL(map.old_entry_lookup_table != NULL);
+    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) key_count);
+
+    for (int i = 0; i < key_count; ++i)
+    {
+        JSLImmutableMemory out_value = {0};
+        TEST_BOOL(jsl_str_to_str_map_get(&map, keys[i], &out_value));
+        TEST_BOOL(jsl_memory_compare(out_value, values[i]));
+    }
+
+    JSLStrToStrMapKeyValueIter iter;
+    jsl_str_to_str_map_key_value_iterator_init(&map, &iter);
+
+    int64_t seen = 0;
+    JSLImmutableMemory out_key = {0};
+    JSLImmutableMemory out_value = {0};
+    while (jsl_str_to_str_map_key_value_iterator_next(&iter, &out_key, &out_value))
+    {
+        seen++;
+    }
+    TEST_INT64_EQUAL(seen, (int64_t) key_count);
+
+    // deleting a missing key still migrates slots, which has to invalidate
+    // iterators even though no entry was removed
+    {
+        bool will_move = false;
+        for (int64_t i = map.rehash_migrate_index; i < map.rehash_migrate_index + 2; ++i)
+        {
+            uintptr_t slot = map.old_entry_lookup_table[i];
+            if (slot != JSL__MAP_EMPTY && slot != JSL__MAP_TOMBSTONE)
+                will_move = true;
+        }
+        TEST_BOOL(will_move);
+
+        jsl_str_to_str_map_key_value_iterator_init(&map, &iter);
+        TEST_BOOL(jsl_str_to_str_map_key_value_iterator_next(&iter, &out_key, &out_value));
+        TEST_BOOL(!jsl_str_to_str_map_delete(&map, JSL_CSTR_EXPRESSION("missing")));
+        TEST_BOOL(!jsl_str_to_str_map_key_value_iterator_next(&iter, &out_key, &out_value));
+        TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) key_count);
+    }
+
+    // the earliest keys are the most likely to still be in the old table
+    values[0] = JSL_CSTR_EXPRESSION("overwritten");
+    TEST_BOOL(jsl_str_to_str_map_insert(
+        &map,
+        keys[0], JSL_STRING_LIFETIME_LONGER,
+        values[0], JSL_STRING_LIFETIME_LONGER
+    ));
+    TEST_BOOL(jsl_str_to_str_map_delete(&map, keys[1]));
+    TEST_BOOL(!jsl_str_to_str_map_delete(&map, keys[1]));
+    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) key_count - 1);
+
+    TEST_BOOL(jsl_str_to_str_map_finish_rehash(&map));
+    TEST_POINTERS_EQUAL(map.old_entry_lookup_table, NULL);
+
+    TEST_BOOL(!jsl_str_to_str_map_has_key(&map, keys[1]));
+    for (int i = 0; i < key_count; ++i)
+    {
+        if (i == 1) continue;
+
+        JSLImmutableMemory get_value = {0};
+        TEST_BOOL(jsl_str_to_str_map_get(&map, keys[i], &get_value));
+        TEST_BOOL(jsl_memory_compare(get_value, values[i]));
+    }
+
+    TEST_BOOL(jsl_str_to_str_map_enable_incremental_rehash(&map, 0));
+    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) key_count - 1);
+
+    #undef max_keys
+}
+
 void test_jsl_str_to_str_map_invalid_inserts(void)
 {
     JSLAllocatorInterface allocator;
@@ -1533,6 +3482,95 @@ void test_jsl_str_to_str_map_invalid_inserts(void)
     TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) 0);
 }
 
+void test_jsl_str_to_str_map_reserve_and_shrink(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    JSLStrToStrMap map = {0};
+    TEST_BOOL(!jsl_str_to_str_map_reserve(&map, 10));
+    TEST_BOOL(!jsl_str_to_str_map_shrink_to_fit(&map));
+    TEST_INT64_EQUAL(jsl_str_to_str_map_memory_footprint(&map), (int64_t) -1);
+
+    bool ok = jsl_str_to_str_map_init(&map, allocator, 42);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    TEST_BOOL(!jsl_str_to_str_map_reserve(&map, -1));
+    TEST_BOOL(jsl_str_to_str_map_reserve(&map, 3000));
+    int64_t reserved_length = map.entry_lookup_table_length;
+    TEST_INT64_EQUAL(reserved_length, (int64_t) 4096);
+
+    char key_buffer[64];
+    char value_buffer[64];
+    for (int32_t i = 0; i < 3000; ++i)
+    {
+        // mix small string buffer copies, heap copies, and borrowed strings
+        snprintf(key_buffer, sizeof(key_buffer), i % 2 == 0 ? "k%d" : "a-long-key-%d", i);
+        snprintf(value_buffer, sizeof(value_buffer), "a-long-value-%d", i);
+        TEST_BOOL(jsl_str_to_str_map_insert(
+            &map,
+            jsl_cstr_to_memory(key_buffer), JSL_STRING_LIFETIME_SHORTER,
+            i % 3 == 0 ? JSL_CSTR_EXPRESSION("static") : jsl_cstr_to_memory(value_buffer),
+            JSL_STRING_LIFETIME_SHORTER
+        ));
+    }
+
+    TEST_INT64_EQUAL(map.entry_lookup_table_length, reserved_length);
+    TEST_INT64_EQUAL(jsl_str_to_str_map_memory_footprint(&map), libc_allocated_bytes(&libc_allocator));
+
+    for (int32_t i = 50; i < 3000; ++i)
+    {
+        snprintf(key_buffer, sizeof(key_buffer), i % 2 == 0 ? "k%d" : "a-long-key-%d", i);
+        TEST_BOOL(jsl_str_to_str_map_delete(&map, jsl_cstr_to_memory(key_buffer)));
+    }
+
+    // deleted entries sit in the free list until shrink_to_fit
+    TEST_INT64_EQUAL(jsl_str_to_str_map_memory_footprint(&map), libc_allocated_bytes(&libc_allocator));
+
+    TEST_BOOL(jsl_str_to_str_map_shrink_to_fit(&map));
+    TEST_INT64_EQUAL(map.entry_lookup_table_length, (int64_t) 128);
+    TEST_POINTERS_EQUAL(map.entry_free_list, NULL);
+    TEST_INT64_EQUAL(jsl_str_to_str_map_memory_footprint(&map), libc_allocated_bytes(&libc_allocator));
+
+    for (int32_t i = 0; i < 50; ++i)
+    {
+        snprintf(key_buffer, sizeof(key_buffer), i % 2 == 0 ? "k%d" : "a-long-key-%d", i);
+        snprintf(value_buffer, sizeof(value_buffer), "a-long-value-%d", i);
+
+        JSLImmutableMemory out_value = {0};
+        TEST_BOOL(jsl_str_to_str_map_get(&map, jsl_cstr_to_memory(key_buffer), &out_value));
+        TEST_BOOL(jsl_memory_compare(
+            out_value,
+            i % 3 == 0 ? JSL_CSTR_EXPRESSION("static") : jsl_cstr_to_memory(value_buffer)
+        ));
+    }
+
+    // the old table is counted while an incremental rehash is in progress
+    TEST_BOOL(jsl_str_to_str_map_enable_incremental_rehash(&map, 1));
+    int32_t key_count = 50;
+    while (map.old_entry_lookup_table == NULL)
+    {
+        snprintf(key_buffer, sizeof(key_buffer), "extra-key-%d", key_count);
+        TEST_BOOL(jsl_str_to_str_map_insert(
+            &map,
+            jsl_cstr_to_memory(key_buffer), JSL_STRING_LIFETIME_SHORTER,
+            JSL_CSTR_EXPRESSION("v"), JSL_STRING_LIFETIME_LONGER
+        ));
+        ++key_count;
+    }
+    TEST_INT64_EQUAL(jsl_str_to_str_map_memory_footprint(&map), libc_allocated_bytes(&libc_allocator));
+
+    TEST_BOOL(jsl_str_to_str_map_reserve(&map, 0));
+    TEST_POINTERS_EQUAL(map.old_entry_lookup_table, NULL);
+    TEST_INT64_EQUAL(jsl_str_to_str_map_item_count(&map), (int64_t) key_count);
+
+    jsl_str_to_str_map_free(&map);
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+}
+
 void test_fixed_int32_to_str_free(void)
 {
     JSLAllocatorInterface allocator;
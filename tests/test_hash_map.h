@@ -6,6 +6,10 @@ void test_fixed_get(void);
 void test_fixed_delete(void);
 void test_fixed_iterator(void);
 void test_fixed_struct_key_padding(void);
+void test_fixed_builtin_hash_options(void);
+void test_fixed_robin_hood(void);
+void test_fixed_str_key_lifetimes_survive_moves(void);
+void test_fixed_control_bytes(void);
 void test_fixed_int32_to_str_insert_overwrites(void);
 void test_fixed_str_to_int32_insert_overwrites(void);
 void test_fixed_int32_to_str_lifetime(void);
@@ -14,6 +18,24 @@ void test_fixed_int32_to_str_free(void);
 void test_fixed_str_to_int32_free(void);
 void test_fixed_int32_to_str_overwrite_frees_old(void);
 
+void test_dynamic_insert_grows(void);
+void test_dynamic_delete_churn(void);
+void test_dynamic_incremental_rehash(void);
+void test_dynamic_str_lifetimes(void);
+void test_dynamic_reserve_and_shrink(void);
+
+void test_concurrent_basic(void);
+void test_concurrent_threaded_writers(void);
+void test_concurrent_memory_footprint(void);
+
+void test_generated_sets(void);
+
+void test_cache_basic(void);
+void test_cache_clock_eviction(void);
+void test_cache_churn(void);
+
+void test_fixed_memory_footprint(void);
+
 void test_jsl_str_to_str_map_init_success(void);
 void test_jsl_str_to_str_map_init_invalid_arguments(void);
 void test_jsl_str_to_str_map_item_count_and_has_key(void);
@@ -27,6 +49,9 @@ void test_jsl_str_to_str_map_iterator_invalidated_on_mutation(void);
 void test_jsl_str_to_str_map_delete(void);
 void test_jsl_str_to_str_map_clear(void);
 void test_jsl_str_to_str_map_rehash(void);
+void test_jsl_str_to_str_map_delete_churn(void);
+void test_jsl_str_to_str_map_incremental_rehash(void);
 void test_jsl_str_to_str_map_invalid_inserts(void);
+void test_jsl_str_to_str_map_reserve_and_shrink(void);
 
 #endif
@@ -17,3 +17,15 @@ typedef struct CompositeType3
 {
     int64_t a, b, c, d, e, f, g;
 } CompositeType3;
+
+// Sort key for the generated comp1 array's --key-function
+static inline int32_t comp1_sort_key(const CompositeType1* value)
+{
+    return value->a;
+}
+
+// Comparison for the generated comp3 array's --less-than, ordering by a then b
+static inline bool comp3_less_than(const CompositeType3* a, const CompositeType3* b)
+{
+    return a->a < b->a || (a->a == b->a && a->b < b->b);
+}
@@ -33,6 +33,7 @@
 #include "jsl/allocator.h"
 #include "jsl/allocator_arena.h"
 #include "jsl/allocator_infinite_arena.h"
+#include "jsl/allocator_libc.h"
 #include "jsl/str_set.h"
 
 #include "minctest.h"
@@ -74,7 +75,11 @@ void test_jsl_str_set_init_success(void)
     TEST_BOOL(set.entry_lookup_table != NULL);
     TEST_INT64_EQUAL(set.entry_lookup_table_length, jsl_next_power_of_two_i64(33));
     TEST_INT64_EQUAL(set.item_count, (int64_t) 0);
-    TEST_INT64_EQUAL(set.tombstone_count, (int64_t) 0);
+
+    for (int64_t i = 0; i < set.entry_lookup_table_length; ++i)
+    {
+        TEST_BOOL(set.entry_lookup_table[i] == JSL__HASHMAP_EMPTY);
+    }
 }
 
 void test_jsl_str_set_init_invalid_arguments(void)
@@ -301,7 +306,11 @@ void test_jsl_str_set_clear(void)
     TEST_BOOL(!jsl_str_set_has(&set, JSL_CSTR_EXPRESSION("x")));
     TEST_BOOL(!jsl_str_set_has(&set, JSL_CSTR_EXPRESSION("y")));
     TEST_BOOL(!jsl_str_set_has(&set, JSL_CSTR_EXPRESSION("z")));
-    TEST_INT64_EQUAL(set.tombstone_count, (int64_t) 0);
+
+    for (int64_t i = 0; i < set.entry_lookup_table_length; ++i)
+    {
+        TEST_BOOL(set.entry_lookup_table[i] == JSL__HASHMAP_EMPTY);
+    }
 
     JSLStrSetKeyValueIter iter;
     TEST_BOOL(jsl_str_set_iterator_init(&set, &iter));
@@ -603,9 +612,228 @@ void test_jsl_str_set_set_operations_invalid_parameters(void)
     TEST_BOOL(!jsl_str_set_difference(&a, &uninitialized, &out));
     TEST_BOOL(!jsl_str_set_difference(&a, &b, &uninitialized));
 
+    TEST_BOOL(!jsl_str_set_intersection(&a, &b, &a));
+    TEST_BOOL(!jsl_str_set_union(&a, &b, &b));
+    TEST_BOOL(!jsl_str_set_difference(&a, &b, &a));
+    TEST_BOOL(!jsl_str_set_intersection2(&a, &b, &out, (JSLStringLifeTime) 99));
+
+    TEST_BOOL(!jsl_str_set_intersection_partition(&a, &b, &out, JSL_STRING_LIFETIME_SHORTER, 0, 0));
+    TEST_BOOL(!jsl_str_set_intersection_partition(&a, &b, &out, JSL_STRING_LIFETIME_SHORTER, -1, 2));
+    TEST_BOOL(!jsl_str_set_intersection_partition(&a, &b, &out, JSL_STRING_LIFETIME_SHORTER, 2, 2));
+    TEST_BOOL(!jsl_str_set_difference_partition(&a, &b, &out, JSL_STRING_LIFETIME_SHORTER, 3, 2));
+    TEST_BOOL(!jsl_str_set_difference_partition(&a, NULL, &out, JSL_STRING_LIFETIME_SHORTER, 0, 2));
+
     TEST_INT64_EQUAL(jsl_str_set_item_count(&out), (int64_t) 0);
 }
 
+static void fill_numbered_set(JSLStrSet* set, int32_t begin, int32_t end)
+{
+    char buffer[64] = {0};
+    for (int32_t i = begin; i < end; ++i)
+    {
+        // every third value is too long for the small string buffer
+        if (i % 3 == 0)
+            snprintf(buffer, sizeof(buffer), "a-rather-long-numbered-value-%d", i);
+        else
+            snprintf(buffer, sizeof(buffer), "v-%d", i);
+
+        TEST_BOOL(jsl_str_set_insert(set, jsl_cstr_to_memory(buffer), JSL_STRING_LIFETIME_SHORTER));
+    }
+}
+
+static bool sets_equal(JSLStrSet* a, JSLStrSet* b)
+{
+    bool res = jsl_str_set_item_count(a) == jsl_str_set_item_count(b);
+
+    JSLStrSetKeyValueIter iter;
+    jsl_str_set_iterator_init(a, &iter);
+    JSLImmutableMemory value = {0};
+    while (res && jsl_str_set_iterator_next(&iter, &value))
+    {
+        res = jsl_str_set_has(b, value);
+    }
+
+    return res;
+}
+
+void test_jsl_str_set_operations_reuse_hashes(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    // a and b share a seed, c has the contents of b under another seed
+    JSLStrSet a = {0};
+    JSLStrSet b = {0};
+    JSLStrSet c = {0};
+    bool ok = (
+        jsl_str_set_init(&a, allocator, 1111)
+        && jsl_str_set_init(&b, allocator, 1111)
+        && jsl_str_set_init(&c, allocator, 2222)
+    );
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    fill_numbered_set(&a, 0, 300);
+    fill_numbered_set(&b, 200, 400);
+    fill_numbered_set(&c, 200, 400);
+
+    JSLStrSet same_seed = {0};
+    JSLStrSet mixed_seed = {0};
+
+    // intersection
+    TEST_BOOL(jsl_str_set_init(&same_seed, allocator, 1111));
+    TEST_BOOL(jsl_str_set_init(&mixed_seed, allocator, 3333));
+    TEST_BOOL(jsl_str_set_intersection2(&a, &b, &same_seed, JSL_STRING_LIFETIME_SHORTER));
+    TEST_BOOL(jsl_str_set_intersection2(&a, &c, &mixed_seed, JSL_STRING_LIFETIME_SHORTER));
+    TEST_INT64_EQUAL(jsl_str_set_item_count(&same_seed), (int64_t) 100);
+    TEST_BOOL(sets_equal(&same_seed, &mixed_seed));
+    TEST_BOOL(jsl_str_set_has(&same_seed, JSL_CSTR_EXPRESSION("v-250")));
+    TEST_BOOL(!jsl_str_set_has(&same_seed, JSL_CSTR_EXPRESSION("v-100")));
+
+    // the output was presized, so it holds a full copy of the smaller
+    // input without going over its load factor
+    TEST_BOOL(
+        (float) jsl_str_set_item_count(&b)
+        <= (float) same_seed.entry_lookup_table_length * same_seed.load_factor
+    );
+
+    // union
+    TEST_BOOL(jsl_str_set_init(&same_seed, allocator, 1111));
+    TEST_BOOL(jsl_str_set_init(&mixed_seed, allocator, 3333));
+    TEST_BOOL(jsl_str_set_union2(&a, &b, &same_seed, JSL_STRING_LIFETIME_SHORTER));
+    TEST_BOOL(jsl_str_set_union2(&a, &c, &mixed_seed, JSL_STRING_LIFETIME_SHORTER));
+    TEST_INT64_EQUAL(jsl_str_set_item_count(&same_seed), (int64_t) 400);
+    TEST_BOOL(sets_equal(&same_seed, &mixed_seed));
+
+    // difference
+    TEST_BOOL(jsl_str_set_init(&same_seed, allocator, 1111));
+    TEST_BOOL(jsl_str_set_init(&mixed_seed, allocator, 3333));
+    TEST_BOOL(jsl_str_set_difference2(&a, &b, &same_seed, JSL_STRING_LIFETIME_SHORTER));
+    TEST_BOOL(jsl_str_set_difference2(&a, &c, &mixed_seed, JSL_STRING_LIFETIME_SHORTER));
+    TEST_INT64_EQUAL(jsl_str_set_item_count(&same_seed), (int64_t) 200);
+    TEST_BOOL(sets_equal(&same_seed, &mixed_seed));
+    TEST_BOOL(jsl_str_set_has(&same_seed, JSL_CSTR_EXPRESSION("v-1")));
+    TEST_BOOL(!jsl_str_set_has(&same_seed, JSL_CSTR_EXPRESSION("v-201")));
+
+    // with LONGER, long values point at the storage of the input set that
+    // was walked, the smaller one, while short ones are still copied into
+    // the entry
+    JSLStrSet borrowed = {0};
+    TEST_BOOL(jsl_str_set_init(&borrowed, allocator, 1111));
+    TEST_BOOL(jsl_str_set_intersection2(&a, &b, &borrowed, JSL_STRING_LIFETIME_LONGER));
+    TEST_INT64_EQUAL(jsl_str_set_item_count(&borrowed), (int64_t) 100);
+
+    JSLImmutableMemory long_value = JSL_CSTR_EXPRESSION("a-rather-long-numbered-value-210");
+    const uint8_t* source_data = NULL;
+    const uint8_t* borrowed_data = NULL;
+    int64_t short_values_borrowed = 0;
+
+    JSLStrSetKeyValueIter iter;
+    JSLImmutableMemory value = {0};
+    jsl_str_set_iterator_init(&b, &iter);
+    while (jsl_str_set_iterator_next(&iter, &value))
+    {
+        if (jsl_memory_compare(value, long_value))
+            source_data = value.data;
+    }
+    jsl_str_set_iterator_init(&borrowed, &iter);
+    while (jsl_str_set_iterator_next(&iter, &value))
+    {
+        if (jsl_memory_compare(value, long_value))
+            borrowed_data = value.data;
+
+        if (value.length > 16)
+            continue;
+
+        JSLStrSetKeyValueIter source_iter;
+        JSLImmutableMemory source_value = {0};
+        jsl_str_set_iterator_init(&b, &source_iter);
+        while (jsl_str_set_iterator_next(&source_iter, &source_value))
+        {
+            if (source_value.data == value.data)
+                ++short_values_borrowed;
+        }
+    }
+
+    TEST_BOOL(source_data != NULL);
+    TEST_POINTERS_EQUAL(borrowed_data, source_data);
+    TEST_INT64_EQUAL(short_values_borrowed, (int64_t) 0);
+}
+
+void test_jsl_str_set_partitioned_operations(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrSet a = {0};
+    JSLStrSet b = {0};
+    JSLStrSet expected_intersection = {0};
+    JSLStrSet expected_difference = {0};
+    bool ok = (
+        jsl_str_set_init(&a, allocator, 4242)
+        && jsl_str_set_init(&b, allocator, 4242)
+        && jsl_str_set_init(&expected_intersection, allocator, 4242)
+        && jsl_str_set_init(&expected_difference, allocator, 4242)
+    );
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    fill_numbered_set(&a, 0, 500);
+    fill_numbered_set(&b, 250, 1000);
+
+    TEST_BOOL(jsl_str_set_intersection(&a, &b, &expected_intersection));
+    TEST_BOOL(jsl_str_set_difference(&a, &b, &expected_difference));
+
+    int64_t partition_counts[] = {1, 3, 7, 64};
+    for (size_t c = 0; c < sizeof(partition_counts) / sizeof(partition_counts[0]); ++c)
+    {
+        int64_t partition_count = partition_counts[c];
+
+        JSLStrSet intersection_merged = {0};
+        JSLStrSet difference_merged = {0};
+        TEST_BOOL(jsl_str_set_init(&intersection_merged, allocator, 4242));
+        TEST_BOOL(jsl_str_set_init(&difference_merged, allocator, 4242));
+
+        int64_t intersection_total = 0;
+        int64_t difference_total = 0;
+
+        for (int64_t p = 0; p < partition_count; ++p)
+        {
+            JSLStrSet intersection_part = {0};
+            JSLStrSet difference_part = {0};
+            JSLStrSet merged_copy = {0};
+            TEST_BOOL(jsl_str_set_init(&intersection_part, allocator, 4242));
+            TEST_BOOL(jsl_str_set_init(&difference_part, allocator, 4242));
+
+            TEST_BOOL(jsl_str_set_intersection_partition(
+                &a, &b, &intersection_part, JSL_STRING_LIFETIME_LONGER, p, partition_count
+            ));
+            TEST_BOOL(jsl_str_set_difference_partition(
+                &a, &b, &difference_part, JSL_STRING_LIFETIME_LONGER, p, partition_count
+            ));
+
+            intersection_total += jsl_str_set_item_count(&intersection_part);
+            difference_total += jsl_str_set_item_count(&difference_part);
+
+            TEST_BOOL(jsl_str_set_init(&merged_copy, allocator, 4242));
+            TEST_BOOL(jsl_str_set_union2(&intersection_merged, &intersection_part, &merged_copy, JSL_STRING_LIFETIME_LONGER));
+            intersection_merged = merged_copy;
+
+            TEST_BOOL(jsl_str_set_init(&merged_copy, allocator, 4242));
+            TEST_BOOL(jsl_str_set_union2(&difference_merged, &difference_part, &merged_copy, JSL_STRING_LIFETIME_LONGER));
+            difference_merged = merged_copy;
+        }
+
+        // partitions are disjoint and together cover the whole result
+        TEST_INT64_EQUAL(intersection_total, jsl_str_set_item_count(&expected_intersection));
+        TEST_INT64_EQUAL(difference_total, jsl_str_set_item_count(&expected_difference));
+        TEST_BOOL(sets_equal(&intersection_merged, &expected_intersection));
+        TEST_BOOL(sets_equal(&difference_merged, &expected_difference));
+    }
+}
+
 void test_jsl_str_set_rehash_preserves_entries(void)
 {
     JSLAllocatorInterface allocator;
@@ -648,6 +876,146 @@ void test_jsl_str_set_rehash_preserves_entries(void)
     TEST_INT64_EQUAL(iterated, (int64_t) insert_count);
 }
 
+void test_jsl_str_set_delete_churn(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrSet set = {0};
+    bool ok = jsl_str_set_init2(&set, allocator, 8080, 64, 0.75f);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    int64_t table_length = set.entry_lookup_table_length;
+    char buffer[32] = {0};
+
+    // replace the whole population every round, deletes must not leave
+    // anything behind that makes the table grow or lookups fail
+    for (int32_t round = 0; round < 20; ++round)
+    {
+        for (int32_t i = 0; i < 64; ++i)
+        {
+            snprintf(buffer, sizeof(buffer), "r%d-%d", round, i);
+            TEST_BOOL(jsl_str_set_insert(&set, jsl_cstr_to_memory(buffer), JSL_STRING_LIFETIME_SHORTER));
+        }
+
+        // delete every other value first so the survivors have to be
+        // found across the holes the deletes left
+        for (int32_t i = 0; i < 64; i += 2)
+        {
+            snprintf(buffer, sizeof(buffer), "r%d-%d", round, i);
+            TEST_BOOL(jsl_str_set_delete(&set, jsl_cstr_to_memory(buffer)));
+        }
+
+        for (int32_t i = 1; i < 64; i += 2)
+        {
+            snprintf(buffer, sizeof(buffer), "r%d-%d", round, i);
+            TEST_BOOL(jsl_str_set_has(&set, jsl_cstr_to_memory(buffer)));
+            TEST_BOOL(jsl_str_set_delete(&set, jsl_cstr_to_memory(buffer)));
+        }
+
+        TEST_INT64_EQUAL(jsl_str_set_item_count(&set), (int64_t) 0);
+    }
+
+    TEST_INT64_EQUAL(set.entry_lookup_table_length, table_length);
+
+    for (int64_t i = 0; i < set.entry_lookup_table_length; ++i)
+    {
+        TEST_BOOL(set.entry_lookup_table[i] == JSL__HASHMAP_EMPTY);
+    }
+}
+
+void test_jsl_str_set_incremental_rehash(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    JSLStrSet set = {0};
+    bool ok = jsl_str_set_init2(&set, allocator, 7070, 4, 0.5f);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    TEST_BOOL(!jsl_str_set_enable_incremental_rehash(&set, -1));
+    TEST_BOOL(jsl_str_set_enable_incremental_rehash(&set, 2));
+
+    const int32_t max_values = 256;
+    char buffer[32] = {0};
+
+    // keep inserting until a table grow leaves a rehash in progress
+    int32_t value_count = 0;
+    while (value_count < max_values)
+    {
+        snprintf(buffer, sizeof(buffer), "value-%d", value_count);
+        TEST_BOOL(jsl_str_set_insert(&set, jsl_cstr_to_memory(buffer), JSL_STRING_LIFETIME_SHORTER));
+        ++value_count;
+
+        if (value_count > 16 && set.old_entry_lookup_table != NULL)
+            break;
+    }
+
+    TEST_BOOL(set.old_entry_lookup_table != NULL);
+    TEST_INT64_EQUAL(jsl_str_set_item_count(&set), (int64_t) value_count);
+
+    for (int32_t i = 0; i < value_count; ++i)
+    {
+        snprintf(buffer, sizeof(buffer), "value-%d", i);
+        TEST_BOOL(jsl_str_set_has(&set, jsl_cstr_to_memory(buffer)));
+    }
+
+    int64_t iterated = 0;
+    JSLStrSetKeyValueIter iter;
+    TEST_BOOL(jsl_str_set_iterator_init(&set, &iter));
+    JSLImmutableMemory out_value = {0};
+    while (jsl_str_set_iterator_next(&iter, &out_value))
+    {
+        iterated++;
+    }
+    TEST_INT64_EQUAL(iterated, (int64_t) value_count);
+
+    // deleting a missing value still migrates slots, which has to invalidate
+    // iterators even though nothing was removed
+    {
+        bool will_move = false;
+        for (int64_t i = set.rehash_migrate_index; i < set.rehash_migrate_index + 2; ++i)
+        {
+            uintptr_t slot = set.old_entry_lookup_table[i];
+            if (slot != JSL__HASHMAP_EMPTY && slot != JSL__HASHMAP_TOMBSTONE)
+                will_move = true;
+        }
+        TEST_BOOL(will_move);
+
+        TEST_BOOL(jsl_str_set_iterator_init(&set, &iter));
+        TEST_BOOL(jsl_str_set_iterator_next(&iter, &out_value));
+        TEST_BOOL(!jsl_str_set_delete(&set, JSL_CSTR_EXPRESSION("missing")));
+        TEST_BOOL(!jsl_str_set_iterator_next(&iter, &out_value));
+        TEST_INT64_EQUAL(jsl_str_set_item_count(&set), (int64_t) value_count);
+    }
+
+    // the earliest values are the most likely to still be in the old table,
+    // inserting one again must not add a duplicate
+    TEST_BOOL(jsl_str_set_insert(&set, JSL_CSTR_EXPRESSION("value-0"), JSL_STRING_LIFETIME_SHORTER));
+    TEST_BOOL(jsl_str_set_delete(&set, JSL_CSTR_EXPRESSION("value-1")));
+    TEST_BOOL(!jsl_str_set_delete(&set, JSL_CSTR_EXPRESSION("value-1")));
+    TEST_INT64_EQUAL(jsl_str_set_item_count(&set), (int64_t) value_count - 1);
+
+    TEST_BOOL(jsl_str_set_finish_rehash(&set));
+    TEST_POINTERS_EQUAL(set.old_entry_lookup_table, NULL);
+
+    iterated = 0;
+    TEST_BOOL(jsl_str_set_iterator_init(&set, &iter));
+    while (jsl_str_set_iterator_next(&iter, &out_value))
+    {
+        TEST_BOOL(!jsl_memory_compare(out_value, JSL_CSTR_EXPRESSION("value-1")));
+        iterated++;
+    }
+    TEST_INT64_EQUAL(iterated, (int64_t) value_count - 1);
+
+    TEST_BOOL(jsl_str_set_enable_incremental_rehash(&set, 0));
+    TEST_BOOL(jsl_str_set_has(&set, JSL_CSTR_EXPRESSION("value-0")));
+}
+
 void test_jsl_str_set_rejects_invalid_parameters(void)
 {
     JSLAllocatorInterface allocator;
@@ -671,3 +1039,70 @@ void test_jsl_str_set_rejects_invalid_parameters(void)
 
     TEST_INT64_EQUAL(jsl_str_set_item_count(&set), (int64_t) 0);
 }
+
+static int64_t libc_allocated_bytes(JSLLibcAllocator* libc_allocator)
+{
+    int64_t total = 0;
+    for (struct JSL__LibcAllocationHeader* header = libc_allocator->head; header != NULL; header = header->prev)
+    {
+        total += header->length;
+    }
+    return total;
+}
+
+void test_jsl_str_set_reserve_and_shrink(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    JSLStrSet set = {0};
+    TEST_BOOL(!jsl_str_set_reserve(&set, 10));
+    TEST_BOOL(!jsl_str_set_shrink_to_fit(&set));
+    TEST_INT64_EQUAL(jsl_str_set_memory_footprint(&set), (int64_t) -1);
+
+    bool ok = jsl_str_set_init(&set, allocator, 31);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    TEST_BOOL(!jsl_str_set_reserve(&set, -1));
+    TEST_BOOL(jsl_str_set_reserve(&set, 2000));
+    int64_t reserved_length = set.entry_lookup_table_length;
+    TEST_INT64_EQUAL(reserved_length, (int64_t) 4096);
+
+    char buffer[64];
+    for (int32_t i = 0; i < 2000; ++i)
+    {
+        // short values live in the entry, long ones are copied
+        snprintf(buffer, sizeof(buffer), i % 2 == 0 ? "v%d" : "a-value-long-enough-to-be-copied-%d", i);
+        TEST_BOOL(jsl_str_set_insert(&set, jsl_cstr_to_memory(buffer), JSL_STRING_LIFETIME_SHORTER));
+    }
+    TEST_BOOL(jsl_str_set_insert(&set, JSL_CSTR_EXPRESSION("a-borrowed-value-which-is-not-copied"), JSL_STRING_LIFETIME_LONGER));
+
+    TEST_INT64_EQUAL(set.entry_lookup_table_length, reserved_length);
+    TEST_INT64_EQUAL(jsl_str_set_memory_footprint(&set), libc_allocated_bytes(&libc_allocator));
+
+    for (int32_t i = 10; i < 2000; ++i)
+    {
+        snprintf(buffer, sizeof(buffer), i % 2 == 0 ? "v%d" : "a-value-long-enough-to-be-copied-%d", i);
+        TEST_BOOL(jsl_str_set_delete(&set, jsl_cstr_to_memory(buffer)));
+    }
+
+    TEST_INT64_EQUAL(jsl_str_set_memory_footprint(&set), libc_allocated_bytes(&libc_allocator));
+
+    TEST_BOOL(jsl_str_set_shrink_to_fit(&set));
+    TEST_INT64_EQUAL(set.entry_lookup_table_length, (int64_t) 32);
+    TEST_POINTERS_EQUAL(set.entry_free_list, NULL);
+    TEST_INT64_EQUAL(jsl_str_set_memory_footprint(&set), libc_allocated_bytes(&libc_allocator));
+
+    TEST_INT64_EQUAL(jsl_str_set_item_count(&set), (int64_t) 11);
+    for (int32_t i = 0; i < 10; ++i)
+    {
+        snprintf(buffer, sizeof(buffer), i % 2 == 0 ? "v%d" : "a-value-long-enough-to-be-copied-%d", i);
+        TEST_BOOL(jsl_str_set_has(&set, jsl_cstr_to_memory(buffer)));
+    }
+
+    jsl_str_set_free(&set);
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+}
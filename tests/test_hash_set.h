@@ -17,7 +17,12 @@ void test_jsl_str_set_union_with_empty_sets(void);
 void test_jsl_str_set_difference_basic(void);
 void test_jsl_str_set_difference_with_empty_sets(void);
 void test_jsl_str_set_set_operations_invalid_parameters(void);
+void test_jsl_str_set_operations_reuse_hashes(void);
+void test_jsl_str_set_partitioned_operations(void);
 void test_jsl_str_set_rehash_preserves_entries(void);
+void test_jsl_str_set_delete_churn(void);
+void test_jsl_str_set_incremental_rehash(void);
 void test_jsl_str_set_rejects_invalid_parameters(void);
+void test_jsl_str_set_reserve_and_shrink(void);
 
 #endif
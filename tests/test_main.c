@@ -47,13 +47,19 @@
 #include "test_allocator_pool.h"
 #include "test_array.h"
 #include "test_cmd_line.h"
+#include "test_concurrent_str_map.h"
+#include "test_rope.h"
+#include "test_str_sort.h"
 #include "test_file_utils.h"
 #include "test_format.h"
+#include "test_frozen_str_map.h"
+#include "test_hash.h"
 #include "test_hash_map.h"
 #include "test_hash_set.h"
 #include "test_intrinsics.h"
 #include "test_str_to_str_multimap.h"
 #include "test_string_builder.h"
+#include "test_thread_pool.h"
 #include "test_subprocess.h"
 
 size_t ltests = 0;
@@ -231,6 +237,15 @@ int main(void)
     RUN_TEST_FUNCTION("Test jsl_load_file_contents", test_jsl_load_file_contents);
     RUN_TEST_FUNCTION("Test jsl_get_file_size", test_jsl_get_file_size);
     RUN_TEST_FUNCTION("Test jsl_load_file_contents_buffer", test_jsl_load_file_contents_buffer);
+    RUN_TEST_FUNCTION("Test jsl_map_file", test_jsl_map_file);
+    RUN_TEST_FUNCTION("Test jsl_map_file bad parameters", test_jsl_map_file_bad_parameters);
+    RUN_TEST_FUNCTION("Test jsl_map_file_advise", test_jsl_map_file_advise);
+    RUN_TEST_FUNCTION("Test jsl_map_file_or_load", test_jsl_map_file_or_load);
+    RUN_TEST_FUNCTION("Test jsl_write_file_contents_vectored", test_jsl_write_file_contents_vectored);
+    RUN_TEST_FUNCTION("Test jsl_write_file_contents_vectored bad parameters", test_jsl_write_file_contents_vectored_bad_parameters);
+    RUN_TEST_FUNCTION("Test jsl_file_writer", test_jsl_file_writer);
+    RUN_TEST_FUNCTION("Test jsl_file_writer write failure", test_jsl_file_writer_write_failure);
+    RUN_TEST_FUNCTION("Test jsl_file_writer bad parameters", test_jsl_file_writer_bad_parameters);
 
     RUN_TEST_FUNCTION("Test jsl_format_to_c_file formats and writes output", test_jsl_format_file_formats_and_writes_output);
     RUN_TEST_FUNCTION("Test jsl_format_to_c_file accepts empty format", test_jsl_format_file_accepts_empty_format);
@@ -314,6 +329,19 @@ int main(void)
     RUN_TEST_FUNCTION("Test dynamic array delete at", test_dynamic_array_delete_at_removes_and_shifts);
     RUN_TEST_FUNCTION("Test dynamic array clear", test_dynamic_array_clear_resets_length);
     RUN_TEST_FUNCTION("Test dynamic array sentinel checks", test_dynamic_array_checks_sentinel);
+    RUN_TEST_FUNCTION("Test structure of arrays insert and grow", test_soa_array_insert_and_grow);
+    RUN_TEST_FUNCTION("Test structure of arrays set, delete, and clear", test_soa_array_set_delete_and_clear);
+    RUN_TEST_FUNCTION("Test dynamic array sort", test_dynamic_array_sort);
+    RUN_TEST_FUNCTION("Test dynamic array radix sort keys", test_dynamic_array_radix_sort_keys);
+    RUN_TEST_FUNCTION("Test dynamic array nth element and partial sort", test_dynamic_array_nth_element_and_partial_sort);
+    RUN_TEST_FUNCTION("Test dynamic array lower and upper bound", test_dynamic_array_lower_and_upper_bound);
+    RUN_TEST_FUNCTION("Test segmented array stable addresses", test_segmented_array_stable_addresses);
+    RUN_TEST_FUNCTION("Test segmented array reserve, delete, and clear", test_segmented_array_reserve_delete_and_clear);
+    RUN_TEST_FUNCTION("Test ring push, pop, and growth", test_ring_push_pop_and_growth);
+    RUN_TEST_FUNCTION("Test fixed ring bulk push and pop", test_ring_fixed_bulk_push_and_pop);
+    RUN_TEST_FUNCTION("Test SPSC queue batches", test_spsc_queue_batches);
+    RUN_TEST_FUNCTION("Test SPSC queue threaded", test_spsc_queue_threaded);
+    RUN_TEST_FUNCTION("Test MPMC queue threaded", test_mpmc_queue_threaded);
     // 
     //              Test Fixed Hash Map
     // 
@@ -323,6 +351,10 @@ int main(void)
     RUN_TEST_FUNCTION("Test fixed hashmap iterator", test_fixed_iterator);
     RUN_TEST_FUNCTION("Test fixed hashmap delete", test_fixed_delete);
     RUN_TEST_FUNCTION("Test fixed hashmap struct key padding", test_fixed_struct_key_padding);
+    RUN_TEST_FUNCTION("Test fixed hashmap built in hash options", test_fixed_builtin_hash_options);
+    RUN_TEST_FUNCTION("Test fixed hashmap robin hood", test_fixed_robin_hood);
+    RUN_TEST_FUNCTION("Test fixed hashmap str key lifetimes survive moves", test_fixed_str_key_lifetimes_survive_moves);
+    RUN_TEST_FUNCTION("Test fixed hashmap control bytes", test_fixed_control_bytes);
     RUN_TEST_FUNCTION("Test fixed int32 to str insert overwrites", test_fixed_int32_to_str_insert_overwrites);
     RUN_TEST_FUNCTION("Test fixed str to int32 insert overwrites", test_fixed_str_to_int32_insert_overwrites);
     RUN_TEST_FUNCTION("Test fixed int32 to str lifetime", test_fixed_int32_to_str_lifetime);
@@ -330,6 +362,29 @@ int main(void)
     RUN_TEST_FUNCTION("Test fixed int32 to str free", test_fixed_int32_to_str_free);
     RUN_TEST_FUNCTION("Test fixed str to int32 free", test_fixed_str_to_int32_free);
     RUN_TEST_FUNCTION("Test fixed int32 to str overwrite frees old", test_fixed_int32_to_str_overwrite_frees_old);
+    RUN_TEST_FUNCTION("Test fixed hashmap memory footprint", test_fixed_memory_footprint);
+
+    // 
+    //              Test Dynamic Hash Map
+    // 
+
+    RUN_TEST_FUNCTION("Test dynamic hashmap insert grows", test_dynamic_insert_grows);
+    RUN_TEST_FUNCTION("Test dynamic hashmap delete churn", test_dynamic_delete_churn);
+    RUN_TEST_FUNCTION("Test dynamic hashmap incremental rehash", test_dynamic_incremental_rehash);
+    RUN_TEST_FUNCTION("Test dynamic hashmap str lifetimes", test_dynamic_str_lifetimes);
+    RUN_TEST_FUNCTION("Test dynamic hashmap reserve and shrink", test_dynamic_reserve_and_shrink);
+
+    // 
+    //              Test Concurrent Hash Map
+    // 
+
+    RUN_TEST_FUNCTION("Test concurrent hashmap basic", test_concurrent_basic);
+    RUN_TEST_FUNCTION("Test concurrent hashmap threaded writers", test_concurrent_threaded_writers);
+    RUN_TEST_FUNCTION("Test concurrent hashmap memory footprint", test_concurrent_memory_footprint);
+    RUN_TEST_FUNCTION("Test generated hash sets", test_generated_sets);
+    RUN_TEST_FUNCTION("Test cache basic", test_cache_basic);
+    RUN_TEST_FUNCTION("Test cache CLOCK eviction", test_cache_clock_eviction);
+    RUN_TEST_FUNCTION("Test cache churn", test_cache_churn);
 
     // 
     //              Test String to String Hash Map
@@ -348,7 +403,10 @@ int main(void)
     RUN_TEST_FUNCTION("Test str to str map delete", test_jsl_str_to_str_map_delete);
     RUN_TEST_FUNCTION("Test str to str map clear", test_jsl_str_to_str_map_clear);
     RUN_TEST_FUNCTION("Test str to str map rehash", test_jsl_str_to_str_map_rehash);
+    RUN_TEST_FUNCTION("Test str to str map delete churn", test_jsl_str_to_str_map_delete_churn);
+    RUN_TEST_FUNCTION("Test str to str map incremental rehash", test_jsl_str_to_str_map_incremental_rehash);
     RUN_TEST_FUNCTION("Test str to str map invalid inserts", test_jsl_str_to_str_map_invalid_inserts);
+    RUN_TEST_FUNCTION("Test str to str map reserve and shrink", test_jsl_str_to_str_map_reserve_and_shrink);
 
     // 
     //              Test String to String Multimap
@@ -367,6 +425,10 @@ int main(void)
     RUN_TEST_FUNCTION("delete value removes empty key", test_jsl_str_to_str_multimap_delete_value_removes_empty_key);
     RUN_TEST_FUNCTION("delete key behavior", test_jsl_str_to_str_multimap_delete_key);
     RUN_TEST_FUNCTION("clear and reuse", test_jsl_str_to_str_multimap_clear);
+    RUN_TEST_FUNCTION("delete churn", test_jsl_str_to_str_multimap_delete_churn);
+    RUN_TEST_FUNCTION("values span", test_jsl_str_to_str_multimap_values_span);
+    RUN_TEST_FUNCTION("incremental rehash", test_jsl_str_to_str_multimap_incremental_rehash);
+    RUN_TEST_FUNCTION("reserve and shrink_to_fit", test_jsl_str_to_str_multimap_reserve_and_shrink);
     RUN_TEST_FUNCTION("stress test", test_stress_test);
 
     // 
@@ -389,8 +451,82 @@ int main(void)
     RUN_TEST_FUNCTION("String Set difference basic cases", test_jsl_str_set_difference_basic);
     RUN_TEST_FUNCTION("String Set difference with empty sets", test_jsl_str_set_difference_with_empty_sets);
     RUN_TEST_FUNCTION("String Set operations invalid parameters", test_jsl_str_set_set_operations_invalid_parameters);
+    RUN_TEST_FUNCTION("String Set operations reuse hashes", test_jsl_str_set_operations_reuse_hashes);
+    RUN_TEST_FUNCTION("String Set partitioned operations", test_jsl_str_set_partitioned_operations);
     RUN_TEST_FUNCTION("String Set rehash preserves entries", test_jsl_str_set_rehash_preserves_entries);
+    RUN_TEST_FUNCTION("String Set delete churn", test_jsl_str_set_delete_churn);
+    RUN_TEST_FUNCTION("String Set incremental rehash", test_jsl_str_set_incremental_rehash);
     RUN_TEST_FUNCTION("String Set rejects invalid parameters", test_jsl_str_set_rejects_invalid_parameters);
+    RUN_TEST_FUNCTION("String Set reserve and shrink_to_fit", test_jsl_str_set_reserve_and_shrink);
+
+    // 
+    //              Test Frozen String Map and Set
+    // 
+
+    RUN_TEST_FUNCTION("Test str to str map freeze basic", test_jsl_str_to_str_map_freeze_basic);
+    RUN_TEST_FUNCTION("Test str to str map freeze many keys", test_jsl_str_to_str_map_freeze_many_keys);
+    RUN_TEST_FUNCTION("Test str to str map freeze empty and binary", test_jsl_str_to_str_map_freeze_empty_and_binary);
+    RUN_TEST_FUNCTION("Test str to str map freeze outlives source", test_jsl_str_to_str_map_freeze_outlives_source);
+    RUN_TEST_FUNCTION("Test str to str map freeze empty map", test_jsl_str_to_str_map_freeze_empty_map);
+    RUN_TEST_FUNCTION("Test frozen str map iterator", test_jsl_frozen_str_map_iterator_covers_all_pairs);
+    RUN_TEST_FUNCTION("Test frozen str map invalid parameters", test_jsl_frozen_str_map_invalid_parameters);
+    RUN_TEST_FUNCTION("Test str set freeze basic", test_jsl_str_set_freeze_basic);
+    RUN_TEST_FUNCTION("Test str set freeze many values", test_jsl_str_set_freeze_many_values);
+    RUN_TEST_FUNCTION("Test frozen str set iterator", test_jsl_frozen_str_set_iterator_covers_all_values);
+    RUN_TEST_FUNCTION("Test frozen str map image round trip", test_jsl_frozen_str_map_image_round_trip);
+    RUN_TEST_FUNCTION("Test frozen str map image rejects corruption", test_jsl_frozen_str_map_image_rejects_corruption);
+    RUN_TEST_FUNCTION("Test frozen str map file round trip", test_jsl_frozen_str_map_file_round_trip);
+    RUN_TEST_FUNCTION("Test frozen str set file round trip", test_jsl_frozen_str_set_file_round_trip);
+
+    //
+    //              Test Hashing
+    //
+
+    RUN_TEST_FUNCTION("Test hash matches container hashes", test_jsl_hash_matches_container_hashes);
+    RUN_TEST_FUNCTION("Test hash many matches single", test_jsl_hash_many_matches_single);
+    RUN_TEST_FUNCTION("Test hash stream matches one shot", test_jsl_hash_stream_matches_one_shot);
+    RUN_TEST_FUNCTION("Test hash stream output sink", test_jsl_hash_stream_output_sink);
+    RUN_TEST_FUNCTION("Test hash crc32c and aes known values", test_jsl_hash_crc32c_and_aes_known_values);
+    RUN_TEST_FUNCTION("Test hash invalid parameters", test_jsl_hash_invalid_parameters);
+
+    //
+    //              Test Concurrent String Map
+    //
+
+    RUN_TEST_FUNCTION("Test concurrent str map publish visibility", test_jsl_concurrent_str_map_publish_visibility);
+    RUN_TEST_FUNCTION("Test concurrent str map deferred reclaim", test_jsl_concurrent_str_map_deferred_reclaim);
+    RUN_TEST_FUNCTION("Test concurrent str map reader slots", test_jsl_concurrent_str_map_reader_slots);
+    RUN_TEST_FUNCTION("Test concurrent str map invalid parameters", test_jsl_concurrent_str_map_invalid_parameters);
+    RUN_TEST_FUNCTION("Test concurrent str map threaded readers", test_jsl_concurrent_str_map_threaded_readers);
+
+    //
+    //              Test String Sort
+    //
+
+    RUN_TEST_FUNCTION("Test str sort compare order", test_jsl_str_sort_compare_order);
+    RUN_TEST_FUNCTION("Test str sort single thread", test_jsl_str_sort_single_thread);
+    RUN_TEST_FUNCTION("Test str sort job threaded", test_jsl_str_sort_job_threaded);
+    RUN_TEST_FUNCTION("Test str sort job split", test_jsl_str_sort_job_split);
+    RUN_TEST_FUNCTION("Test str merge", test_jsl_str_merge);
+
+    //
+    //              Test Rope
+    //
+
+    RUN_TEST_FUNCTION("Test rope append and iterate", test_jsl_rope_append_and_iterate);
+    RUN_TEST_FUNCTION("Test rope random edits", test_jsl_rope_random_edits);
+    RUN_TEST_FUNCTION("Test rope large pieces", test_jsl_rope_large_pieces);
+    RUN_TEST_FUNCTION("Test rope output sink", test_jsl_rope_output_sink);
+    RUN_TEST_FUNCTION("Test rope invalid parameters", test_jsl_rope_invalid_parameters);
+
+    //
+    //              Test Thread Pool
+    //
+
+    RUN_TEST_FUNCTION("Test thread pool parallel for covers range", test_jsl_thread_pool_parallel_for_covers_range);
+    RUN_TEST_FUNCTION("Test thread pool nested parallel for", test_jsl_thread_pool_nested_parallel_for);
+    RUN_TEST_FUNCTION("Test thread pool worker scratch", test_jsl_thread_pool_worker_scratch);
+    RUN_TEST_FUNCTION("Test thread pool invalid parameters", test_jsl_thread_pool_invalid_parameters);
 
     //
     //              Test String builder
@@ -0,0 +1,327 @@
+/**
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "jsl/core.h"
+#include "jsl/allocator.h"
+#include "jsl/allocator_infinite_arena.h"
+#include "jsl/allocator_libc.h"
+#include "jsl/rope.h"
+#include "jsl/string_builder.h"
+
+#include "minctest.h"
+#include "test_rope.h"
+
+extern JSLInfiniteArena global_arena;
+
+static uint64_t rope_random_state = 0x2545F4914F6CDD1Du;
+
+static uint32_t rope_random(void)
+{
+    rope_random_state ^= rope_random_state << 13;
+    rope_random_state ^= rope_random_state >> 7;
+    rope_random_state ^= rope_random_state << 17;
+    return (uint32_t) (rope_random_state >> 32);
+}
+
+/**
+ * Flatten the rope through its sink and compare against `expected`, which
+ * also checks that the pieces add up to the length.
+ */
+static bool rope_equals(JSLRope* rope, const uint8_t* expected, int64_t expected_length)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+
+    JSLStringBuilder builder;
+    bool res = (
+        jsl_rope_length(rope) == expected_length
+        && jsl_string_builder_init(&builder, allocator, expected_length)
+        && jsl_rope_write_to_sink(rope, jsl_string_builder_output_sink(&builder))
+    );
+
+    JSLImmutableMemory flat = {0};
+    if (res)
+    {
+        flat = jsl_string_builder_get_string(&builder);
+        res = flat.length == expected_length
+            && (expected_length == 0 || memcmp(flat.data, expected, (size_t) expected_length) == 0);
+    }
+
+    // Walking the pieces by hand sees the same bytes in the same order
+    JSLRopeIterator iterator;
+    res = res && jsl_rope_iterator_init(&iterator, rope);
+
+    int64_t offset = 0;
+    int64_t pieces = 0;
+    JSLImmutableMemory piece;
+    while (res && jsl_rope_iterator_next(&iterator, &piece))
+    {
+        res = piece.length > 0
+            && offset + piece.length <= expected_length
+            && memcmp(piece.data, expected + offset, (size_t) piece.length) == 0;
+        offset += piece.length;
+        ++pieces;
+    }
+
+    return res && offset == expected_length && pieces == jsl_rope_piece_count(rope);
+}
+
+void test_jsl_rope_append_and_iterate(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    JSLRope rope;
+    TEST_BOOL(jsl_rope_init(&rope, allocator, 0));
+    TEST_INT64_EQUAL(jsl_rope_length(&rope), (int64_t) 0);
+    TEST_BOOL(rope_equals(&rope, NULL, 0));
+
+    char expected[4096];
+    int64_t expected_length = 0;
+    for (int32_t i = 0; i < 400; ++i)
+    {
+        char line[16];
+        int length = snprintf(line, sizeof(line), "line %d\n", i);
+        JSL_MEMCPY(expected + expected_length, line, (size_t) length);
+        expected_length += length;
+
+        TEST_BOOL(jsl_rope_append(&rope, jsl_cstr_to_memory(line)));
+    }
+
+    // Appends that fit in the chunk grow the same piece
+    TEST_INT64_EQUAL(jsl_rope_piece_count(&rope), (int64_t) 1);
+    TEST_BOOL(rope_equals(&rope, (const uint8_t*) expected, expected_length));
+
+    // Typing in the middle only splits once, then keeps extending
+    int64_t middle = 1000;
+    const char* typed = "typed";
+    for (int32_t i = 0; i < 5; ++i)
+    {
+        JSLImmutableMemory letter = { (const uint8_t*) typed + i, 1 };
+        TEST_BOOL(jsl_rope_insert(&rope, middle + i, letter));
+    }
+    JSL_MEMMOVE(expected + middle + 5, expected + middle, (size_t) (expected_length - middle));
+    JSL_MEMCPY(expected + middle, typed, 5);
+    expected_length += 5;
+
+    TEST_INT64_EQUAL(jsl_rope_piece_count(&rope), (int64_t) 3);
+    TEST_BOOL(rope_equals(&rope, (const uint8_t*) expected, expected_length));
+
+    jsl_rope_clear(&rope);
+    TEST_INT64_EQUAL(jsl_rope_length(&rope), (int64_t) 0);
+    TEST_INT64_EQUAL(jsl_rope_piece_count(&rope), (int64_t) 0);
+    TEST_BOOL(jsl_rope_append(&rope, JSL_CSTR_EXPRESSION("again")));
+    TEST_BOOL(rope_equals(&rope, (const uint8_t*) "again", 5));
+
+    jsl_rope_free(&rope);
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+
+    jsl_infinite_arena_reset(&global_arena);
+}
+
+void test_jsl_rope_random_edits(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    // Tiny chunks so edits cross chunk boundaries and big inserts get
+    // chunks of their own
+    JSLRope rope;
+    TEST_BOOL(jsl_rope_init(&rope, allocator, 64));
+
+    int64_t capacity = 1 << 16;
+    uint8_t* expected = (uint8_t*) malloc((size_t) capacity);
+    int64_t expected_length = 0;
+
+    uint8_t text[200];
+    for (int32_t i = 0; i < (int32_t) sizeof(text); ++i)
+        text[i] = (uint8_t) ('a' + i % 26);
+
+    bool all_equal = true;
+    for (int32_t step = 0; step < 4000 && all_equal; ++step)
+    {
+        bool do_insert = expected_length < 64 || rope_random() % 3 != 0;
+
+        if (do_insert && expected_length < capacity - (int64_t) sizeof(text))
+        {
+            int64_t offset = (int64_t) (rope_random() % (uint32_t) (expected_length + 1));
+            int64_t length = 1 + (int64_t) (rope_random() % (step % 10 == 0 ? 200u : 12u));
+            int64_t start = (int64_t) (rope_random() % (uint32_t) ((int64_t) sizeof(text) - length + 1));
+
+            JSLImmutableMemory str = { text + start, length };
+            all_equal = jsl_rope_insert(&rope, offset, str);
+
+            JSL_MEMMOVE(expected + offset + length, expected + offset, (size_t) (expected_length - offset));
+            JSL_MEMCPY(expected + offset, text + start, (size_t) length);
+            expected_length += length;
+        }
+        else
+        {
+            int64_t offset = (int64_t) (rope_random() % (uint32_t) expected_length);
+            int64_t count = (int64_t) (rope_random() % (uint32_t) JSL_MIN(expected_length - offset, (int64_t) 40));
+            all_equal = jsl_rope_delete(&rope, offset, count);
+
+            JSL_MEMMOVE(
+                expected + offset,
+                expected + offset + count,
+                (size_t) (expected_length - offset - count)
+            );
+            expected_length -= count;
+        }
+
+        if (all_equal && step % 97 == 0)
+            all_equal = rope_equals(&rope, expected, expected_length);
+    }
+
+    TEST_BOOL(all_equal);
+    TEST_BOOL(rope_equals(&rope, expected, expected_length));
+
+    // Deleting everything leaves no pieces behind
+    TEST_BOOL(jsl_rope_delete(&rope, 0, expected_length));
+    TEST_INT64_EQUAL(jsl_rope_piece_count(&rope), (int64_t) 0);
+    TEST_BOOL(rope_equals(&rope, NULL, 0));
+
+    free(expected);
+    jsl_rope_free(&rope);
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+
+    jsl_infinite_arena_reset(&global_arena);
+}
+
+void test_jsl_rope_large_pieces(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+
+    JSLRope rope;
+    TEST_BOOL(jsl_rope_init(&rope, allocator, 1024));
+
+    // Inserting at the front over and over, the worst case for a flat buffer
+    int64_t block_length = 3000;
+    uint8_t* block = (uint8_t*) jsl_allocator_interface_alloc(allocator, block_length, 8, false);
+    int32_t block_count = 200;
+    bool res = true;
+    for (int32_t i = 0; i < block_count && res; ++i)
+    {
+        JSL_MEMSET(block, 'A' + i % 26, (size_t) block_length);
+        res = jsl_rope_insert(&rope, 0, (JSLImmutableMemory) { block, block_length });
+    }
+    TEST_BOOL(res);
+    TEST_INT64_EQUAL(jsl_rope_length(&rope), block_length * block_count);
+    TEST_INT64_EQUAL(jsl_rope_piece_count(&rope), (int64_t) block_count);
+
+    JSLRopeIterator iterator;
+    TEST_BOOL(jsl_rope_iterator_init(&iterator, &rope));
+    JSLImmutableMemory piece;
+    int32_t index = block_count - 1;
+    bool pieces_match = true;
+    while (jsl_rope_iterator_next(&iterator, &piece) && pieces_match)
+    {
+        pieces_match = piece.length == block_length
+            && piece.data[0] == 'A' + index % 26
+            && piece.data[block_length - 1] == 'A' + index % 26;
+        --index;
+    }
+    TEST_BOOL(pieces_match);
+    TEST_INT32_EQUAL(index, -1);
+
+    // Cutting across piece boundaries
+    TEST_BOOL(jsl_rope_delete(&rope, block_length / 2, block_length * 3));
+    TEST_INT64_EQUAL(jsl_rope_length(&rope), block_length * (block_count - 3));
+
+    jsl_rope_free(&rope);
+    jsl_infinite_arena_reset(&global_arena);
+}
+
+void test_jsl_rope_output_sink(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+
+    JSLRope rope;
+    TEST_BOOL(jsl_rope_init(&rope, allocator, 0));
+
+    JSLOutputSink sink = jsl_rope_output_sink(&rope);
+    jsl_format_sink(sink, JSL_CSTR_EXPRESSION("%s-%d"), "alpha", 42);
+    jsl_format_sink(sink, JSL_CSTR_EXPRESSION(":%02X"), 0xAB);
+
+    TEST_BOOL(rope_equals(&rope, (const uint8_t*) "alpha-42:AB", 11));
+
+    jsl_rope_free(&rope);
+    jsl_infinite_arena_reset(&global_arena);
+}
+
+void test_jsl_rope_invalid_parameters(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+
+    JSLRope rope;
+    TEST_BOOL(!jsl_rope_init(NULL, allocator, 0));
+    TEST_BOOL(!jsl_rope_init(&rope, allocator, -1));
+
+    TEST_BOOL(jsl_rope_init(&rope, allocator, 0));
+    TEST_BOOL(jsl_rope_append(&rope, JSL_CSTR_EXPRESSION("hello")));
+
+    TEST_BOOL(!jsl_rope_insert(&rope, -1, JSL_CSTR_EXPRESSION("x")));
+    TEST_BOOL(!jsl_rope_insert(&rope, 6, JSL_CSTR_EXPRESSION("x")));
+    TEST_BOOL(!jsl_rope_insert(&rope, 0, (JSLImmutableMemory) { NULL, 3 }));
+    TEST_BOOL(!jsl_rope_delete(&rope, -1, 1));
+    TEST_BOOL(!jsl_rope_delete(&rope, 3, 3));
+    TEST_BOOL(!jsl_rope_delete(&rope, 0, -1));
+
+    // Empty edits are allowed and change nothing
+    TEST_BOOL(jsl_rope_insert(&rope, 5, (JSLImmutableMemory) { NULL, 0 }));
+    TEST_BOOL(jsl_rope_delete(&rope, 5, 0));
+    TEST_BOOL(rope_equals(&rope, (const uint8_t*) "hello", 5));
+
+    JSLRopeIterator iterator;
+    JSLImmutableMemory piece;
+    TEST_BOOL(!jsl_rope_iterator_init(NULL, &rope));
+    TEST_BOOL(!jsl_rope_iterator_init(&iterator, NULL));
+    TEST_BOOL(jsl_rope_iterator_init(&iterator, &rope));
+    TEST_BOOL(!jsl_rope_iterator_next(&iterator, NULL));
+
+    jsl_rope_free(&rope);
+    TEST_INT64_EQUAL(jsl_rope_length(&rope), (int64_t) -1);
+    TEST_INT64_EQUAL(jsl_rope_piece_count(&rope), (int64_t) -1);
+    TEST_BOOL(!jsl_rope_append(&rope, JSL_CSTR_EXPRESSION("x")));
+    TEST_BOOL(!jsl_rope_iterator_next(&iterator, &piece));
+    TEST_BOOL(!jsl_rope_write_to_sink(&rope, jsl_rope_output_sink(&rope)));
+    jsl_rope_free(&rope);
+    jsl_rope_clear(NULL);
+    jsl_rope_free(NULL);
+
+    jsl_infinite_arena_reset(&global_arena);
+}
@@ -0,0 +1,10 @@
+#ifndef TEST_ROPE_H
+#define TEST_ROPE_H
+
+void test_jsl_rope_append_and_iterate(void);
+void test_jsl_rope_random_edits(void);
+void test_jsl_rope_large_pieces(void);
+void test_jsl_rope_output_sink(void);
+void test_jsl_rope_invalid_parameters(void);
+
+#endif
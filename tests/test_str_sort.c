@@ -0,0 +1,368 @@
+/**
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "jsl/core.h"
+#include "jsl/allocator.h"
+#include "jsl/allocator_infinite_arena.h"
+#include "jsl/allocator_libc.h"
+#include "jsl/str_sort.h"
+
+#if JSL_IS_WINDOWS
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+#include "minctest.h"
+#include "test_str_sort.h"
+
+#define STR_SORT_THREAD_COUNT 4
+
+extern JSLInfiniteArena global_arena;
+
+static uint64_t str_sort_random_state = 0x2545F4914F6CDD1Du;
+
+static uint32_t str_sort_random(void)
+{
+    str_sort_random_state ^= str_sort_random_state << 13;
+    str_sort_random_state ^= str_sort_random_state >> 7;
+    str_sort_random_state ^= str_sort_random_state << 17;
+    return (uint32_t) (str_sort_random_state >> 32);
+}
+
+static int compare_for_qsort(const void* lhs, const void* rhs)
+{
+    return jsl_str_sort_compare(
+        *(const JSLImmutableMemory*) lhs,
+        *(const JSLImmutableMemory*) rhs
+    );
+}
+
+/**
+ * Strings that look like log lines: a long prefix shared by most of them,
+ * a few distinct prefixes, tiny alphabets so there are many duplicates, and
+ * the occasional zero byte or high byte.
+ */
+static JSLImmutableMemory* make_test_strings(JSLAllocatorInterface allocator, int64_t count)
+{
+    static const char* prefixes[] = {
+        "2026-10-18T12:00:00Z INFO request handled ",
+        "2026-10-18T12:00:00Z WARN ",
+        "",
+        "id-"
+    };
+
+    JSLImmutableMemory* strings = (JSLImmutableMemory*) jsl_allocator_interface_alloc(
+        allocator,
+        (int64_t) sizeof(JSLImmutableMemory) * count,
+        _Alignof(JSLImmutableMemory),
+        false
+    );
+
+    for (int64_t i = 0; i < count; ++i)
+    {
+        const char* prefix = prefixes[str_sort_random() % 4];
+        int64_t prefix_length = (int64_t) strlen(prefix);
+        int64_t suffix_length = (int64_t) (str_sort_random() % 24);
+
+        uint8_t* data = (uint8_t*) jsl_allocator_interface_alloc(
+            allocator,
+            prefix_length + suffix_length + 1,
+            1,
+            false
+        );
+        JSL_MEMCPY(data, prefix, (size_t) prefix_length);
+        for (int64_t j = 0; j < suffix_length; ++j)
+        {
+            uint32_t roll = str_sort_random() % 16;
+            if (roll == 0)
+                data[prefix_length + j] = 0;
+            else if (roll == 1)
+                data[prefix_length + j] = 0xF0;
+            else
+                data[prefix_length + j] = (uint8_t) ('a' + roll % 3);
+        }
+
+        strings[i] = jsl_immutable_memory(data, prefix_length + suffix_length);
+    }
+
+    return strings;
+}
+
+static bool matches_reference(
+    const JSLImmutableMemory* sorted,
+    const JSLImmutableMemory* reference,
+    int64_t count
+)
+{
+    bool res = true;
+    for (int64_t i = 0; res && i < count; ++i)
+    {
+        res = jsl_str_sort_compare(sorted[i], reference[i]) == 0;
+    }
+    return res;
+}
+
+static JSLImmutableMemory* sorted_reference(
+    JSLAllocatorInterface allocator,
+    const JSLImmutableMemory* strings,
+    int64_t count
+)
+{
+    JSLImmutableMemory* reference = (JSLImmutableMemory*) jsl_allocator_interface_alloc(
+        allocator,
+        (int64_t) sizeof(JSLImmutableMemory) * JSL_MAX(count, (int64_t) 1),
+        _Alignof(JSLImmutableMemory),
+        false
+    );
+    JSL_MEMCPY(reference, strings, sizeof(JSLImmutableMemory) * (size_t) count);
+    qsort(reference, (size_t) count, sizeof(JSLImmutableMemory), compare_for_qsort);
+    return reference;
+}
+
+void test_jsl_str_sort_compare_order(void)
+{
+    JSLImmutableMemory empty = {0};
+    JSLImmutableMemory ab = JSL_CSTR_EXPRESSION("ab");
+    JSLImmutableMemory ab_zero = jsl_immutable_memory((const uint8_t*) "ab\0", 3);
+    JSLImmutableMemory ab_one = jsl_immutable_memory((const uint8_t*) "ab\x01", 3);
+    JSLImmutableMemory high = jsl_immutable_memory((const uint8_t*) "\xF0", 1);
+
+    TEST_BOOL(jsl_str_sort_compare(empty, ab) < 0);
+    TEST_BOOL(jsl_str_sort_compare(ab, ab_zero) < 0);
+    TEST_BOOL(jsl_str_sort_compare(ab_zero, ab_one) < 0);
+    TEST_BOOL(jsl_str_sort_compare(ab_one, high) < 0);
+    TEST_BOOL(jsl_str_sort_compare(high, ab) > 0);
+    TEST_INT64_EQUAL((int64_t) jsl_str_sort_compare(ab, JSL_CSTR_EXPRESSION("ab")), (int64_t) 0);
+    TEST_INT64_EQUAL((int64_t) jsl_str_sort_compare(empty, JSL_CSTR_EXPRESSION("")), (int64_t) 0);
+
+    // the tie on the cached key has to be broken by the length byte
+    JSLImmutableMemory strings[] = { ab_one, ab_zero, high, ab, empty, ab_zero };
+    JSLImmutableMemory expected[] = { empty, ab, ab_zero, ab_zero, ab_one, high };
+
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    TEST_BOOL(jsl_str_sort(allocator, strings, 6));
+    TEST_BOOL(matches_reference(strings, expected, 6));
+
+    TEST_BOOL(jsl_str_sort(allocator, NULL, 0));
+    TEST_BOOL(!jsl_str_sort(allocator, NULL, 4));
+    TEST_BOOL(!jsl_str_sort(allocator, strings, -1));
+}
+
+void test_jsl_str_sort_single_thread(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface scratch;
+    jsl_libc_allocator_get_allocator_interface(&scratch, &libc_allocator);
+
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    static int64_t counts[] = { 1, 2, 15, 17, 300, 5000 };
+    for (int32_t c = 0; c < (int32_t) (sizeof(counts) / sizeof(counts[0])); ++c)
+    {
+        int64_t count = counts[c];
+        JSLImmutableMemory* strings = make_test_strings(allocator, count);
+        JSLImmutableMemory* reference = sorted_reference(allocator, strings, count);
+
+        TEST_BOOL(jsl_str_sort(scratch, strings, count));
+        TEST_BOOL(matches_reference(strings, reference, count));
+
+        // sorting sorted input is a no-op
+        TEST_BOOL(jsl_str_sort(scratch, strings, count));
+        TEST_BOOL(matches_reference(strings, reference, count));
+    }
+
+    // many long identical strings walk the whole length seven bytes at a time
+    JSLImmutableMemory same[100];
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        same[i] = JSL_CSTR_EXPRESSION("the same fairly long line repeated over and over again");
+    }
+    same[50] = JSL_CSTR_EXPRESSION("the same fairly long line repeated over and over again!");
+    TEST_BOOL(jsl_str_sort(scratch, same, 100));
+    TEST_INT64_EQUAL(same[99].length, (int64_t) 55);
+    TEST_INT64_EQUAL(same[0].length, (int64_t) 54);
+
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+    jsl_allocator_interface_free_all(allocator);
+}
+
+#if JSL_IS_WINDOWS
+    static DWORD WINAPI str_sort_worker_entry(LPVOID arg)
+    {
+        jsl_str_sort_job_work((JSLStrSortJob*) arg);
+        return 0;
+    }
+#else
+    static void* str_sort_worker_entry(void* arg)
+    {
+        jsl_str_sort_job_work((JSLStrSortJob*) arg);
+        return NULL;
+    }
+#endif
+
+void test_jsl_str_sort_job_threaded(void)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    int64_t count = 20000;
+    JSLImmutableMemory* strings = make_test_strings(allocator, count);
+    JSLImmutableMemory* reference = sorted_reference(allocator, strings, count);
+
+    JSLStrSortJob job;
+    TEST_BOOL(jsl_str_sort_job_init(&job, allocator, strings, count));
+
+    #if JSL_IS_WINDOWS
+        HANDLE threads[STR_SORT_THREAD_COUNT];
+    #else
+        pthread_t threads[STR_SORT_THREAD_COUNT];
+    #endif
+
+    for (int32_t i = 0; i < STR_SORT_THREAD_COUNT; ++i)
+    {
+        #if JSL_IS_WINDOWS
+            threads[i] = CreateThread(NULL, 0, str_sort_worker_entry, &job, 0, NULL);
+        #else
+            pthread_create(&threads[i], NULL, str_sort_worker_entry, &job);
+        #endif
+    }
+    for (int32_t i = 0; i < STR_SORT_THREAD_COUNT; ++i)
+    {
+        #if JSL_IS_WINDOWS
+            WaitForSingleObject(threads[i], INFINITE);
+            CloseHandle(threads[i]);
+        #else
+            pthread_join(threads[i], NULL);
+        #endif
+    }
+
+    TEST_BOOL(matches_reference(strings, reference, count));
+    TEST_INT64_EQUAL((int64_t) jsl_str_sort_job_work(&job), (int64_t) 0);
+    jsl_str_sort_job_free(&job);
+    TEST_INT64_EQUAL((int64_t) jsl_str_sort_job_work(&job), (int64_t) 0);
+
+    jsl_allocator_interface_free_all(allocator);
+}
+
+void test_jsl_str_sort_job_split(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    // the shared "line " prefix is skipped and the split happens on the
+    // digit after it, with "line " itself landing in the ended bucket
+    JSLImmutableMemory strings[] = {
+        JSL_CSTR_EXPRESSION("line 3b"),
+        JSL_CSTR_EXPRESSION("line 1"),
+        JSL_CSTR_EXPRESSION("line 3a"),
+        JSL_CSTR_EXPRESSION("line "),
+        JSL_CSTR_EXPRESSION("line 2"),
+        JSL_CSTR_EXPRESSION("line 3"),
+        JSL_CSTR_EXPRESSION("line 1")
+    };
+    JSLImmutableMemory expected[] = {
+        JSL_CSTR_EXPRESSION("line "),
+        JSL_CSTR_EXPRESSION("line 1"),
+        JSL_CSTR_EXPRESSION("line 1"),
+        JSL_CSTR_EXPRESSION("line 2"),
+        JSL_CSTR_EXPRESSION("line 3"),
+        JSL_CSTR_EXPRESSION("line 3a"),
+        JSL_CSTR_EXPRESSION("line 3b")
+    };
+
+    JSLStrSortJob job;
+    TEST_BOOL(jsl_str_sort_job_init(&job, allocator, strings, 7));
+    // "line 1" x2 and "line 3*" x3 are the only buckets which need sorting
+    TEST_INT64_EQUAL((int64_t) jsl_str_sort_job_work(&job), (int64_t) 2);
+    TEST_BOOL(matches_reference(strings, expected, 7));
+    jsl_str_sort_job_free(&job);
+
+    TEST_BOOL(jsl_str_sort_job_init(&job, allocator, NULL, 0));
+    TEST_INT64_EQUAL((int64_t) jsl_str_sort_job_work(&job), (int64_t) 0);
+    jsl_str_sort_job_free(&job);
+
+    TEST_BOOL(!jsl_str_sort_job_init(&job, allocator, NULL, 3));
+    TEST_BOOL(!jsl_str_sort_job_init(NULL, allocator, strings, 7));
+
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+}
+
+void test_jsl_str_merge(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface scratch;
+    jsl_libc_allocator_get_allocator_interface(&scratch, &libc_allocator);
+
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+    jsl_allocator_interface_free_all(allocator);
+
+    int64_t count = 3000;
+    JSLImmutableMemory* strings = make_test_strings(allocator, count);
+    JSLImmutableMemory* reference = sorted_reference(allocator, strings, count);
+
+    // uneven runs, including an empty one
+    int64_t run_lengths[] = { 1000, 0, 1, 1500, 499 };
+    const JSLImmutableMemory* runs[5];
+    int64_t offset = 0;
+    for (int32_t i = 0; i < 5; ++i)
+    {
+        TEST_BOOL(jsl_str_sort(scratch, strings + offset, run_lengths[i]));
+        runs[i] = strings + offset;
+        offset += run_lengths[i];
+    }
+
+    JSLImmutableMemory* merged = (JSLImmutableMemory*) jsl_allocator_interface_alloc(
+        allocator,
+        (int64_t) sizeof(JSLImmutableMemory) * count,
+        _Alignof(JSLImmutableMemory),
+        false
+    );
+    TEST_INT64_EQUAL(jsl_str_merge(scratch, runs, run_lengths, 5, merged), count);
+    TEST_BOOL(matches_reference(merged, reference, count));
+
+    TEST_INT64_EQUAL(jsl_str_merge(scratch, NULL, NULL, 0, NULL), (int64_t) 0);
+    TEST_INT64_EQUAL(jsl_str_merge(scratch, runs, run_lengths, 5, NULL), (int64_t) -1);
+    int64_t bad_lengths[] = { 1, -1 };
+    TEST_INT64_EQUAL(jsl_str_merge(scratch, runs, bad_lengths, 2, merged), (int64_t) -1);
+
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+    jsl_allocator_interface_free_all(allocator);
+}
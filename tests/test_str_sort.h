@@ -0,0 +1,10 @@
+#ifndef TEST_STR_SORT_H
+#define TEST_STR_SORT_H
+
+void test_jsl_str_sort_compare_order(void);
+void test_jsl_str_sort_single_thread(void);
+void test_jsl_str_sort_job_threaded(void);
+void test_jsl_str_sort_job_split(void);
+void test_jsl_str_merge(void);
+
+#endif
@@ -27,11 +27,13 @@
 #include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdio.h>
 
 #include "jsl/core.h"
 #include "jsl/allocator.h"
 #include "jsl/allocator_arena.h"
 #include "jsl/allocator_infinite_arena.h"
+#include "jsl/allocator_libc.h"
 #include "jsl/str_to_str_multimap.h"
 
 #include "minctest.h"
@@ -512,6 +514,244 @@ void test_jsl_str_to_str_multimap_clear(void)
     TEST_INT64_EQUAL(jsl_str_to_str_multimap_get_value_count_for_key(&map, JSL_CSTR_EXPRESSION("z")), (int64_t) 1);
 }
 
+void test_jsl_str_to_str_multimap_delete_churn(void)
+{
+    JSLStrToStrMultimap map = {0};
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+
+    bool ok = jsl_str_to_str_multimap_init2(&map, allocator, 7171, 64, 0.75f);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    int64_t table_length = map.entry_lookup_table_length;
+
+    // replace the whole population every round, alternating between the
+    // two ways a key can leave the map
+    for (int round = 0; round < 20; ++round)
+    {
+        JSLImmutableMemory keys[64];
+
+        for (int i = 0; i < 64; ++i)
+        {
+            keys[i] = jsl_format(allocator, JSL_CSTR_EXPRESSION("r%d-%d"), round, i);
+            TEST_BOOL(jsl_str_to_str_multimap_insert(&map, keys[i], JSL_STRING_LIFETIME_LONGER, JSL_CSTR_EXPRESSION("v"), JSL_STRING_LIFETIME_LONGER));
+        }
+
+        for (int i = 0; i < 64; i += 2)
+        {
+            TEST_BOOL(jsl_str_to_str_multimap_delete_key(&map, keys[i]));
+        }
+
+        for (int i = 1; i < 64; i += 2)
+        {
+            TEST_INT64_EQUAL(jsl_str_to_str_multimap_get_value_count_for_key(&map, keys[i]), (int64_t) 1);
+            TEST_BOOL(jsl_str_to_str_multimap_delete_value(&map, keys[i], JSL_CSTR_EXPRESSION("v")));
+        }
+
+        TEST_INT64_EQUAL(jsl_str_to_str_multimap_get_key_count(&map), (int64_t) 0);
+    }
+
+    TEST_INT64_EQUAL(map.entry_lookup_table_length, table_length);
+
+    for (int64_t i = 0; i < map.entry_lookup_table_length; ++i)
+    {
+        TEST_BOOL(map.entry_lookup_table[i] == JSL__MULTIMAP_EMPTY);
+    }
+}
+
+void test_jsl_str_to_str_multimap_values_span(void)
+{
+    JSLStrToStrMultimap map = {0};
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+
+    bool ok = jsl_str_to_str_multimap_init(&map, allocator, 4242);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    JSLImmutableMemory key = JSL_CSTR_EXPRESSION("x-forwarded-for");
+    const int64_t value_total = 500;
+
+    // short transient values are packed, every tenth one is long enough to
+    // need its own copy
+    JSLImmutableMemory inserted[500];
+    for (int64_t i = 0; i < value_total; ++i)
+    {
+        inserted[i] = i % 10 == 0
+            ? jsl_format(allocator, JSL_CSTR_EXPRESSION("a-much-longer-value-that-does-not-fit-%lld"), (long long) i)
+            : jsl_format(allocator, JSL_CSTR_EXPRESSION("v%lld"), (long long) i);
+
+        TEST_BOOL(jsl_str_to_str_multimap_insert(&map, key, JSL_STRING_LIFETIME_SHORTER, inserted[i], JSL_STRING_LIFETIME_SHORTER));
+    }
+
+    const JSLImmutableMemory* values = NULL;
+    int64_t value_count = -1;
+    TEST_BOOL(jsl_str_to_str_multimap_get_values_span(&map, key, &values, &value_count));
+    TEST_INT64_EQUAL(value_count, value_total);
+    TEST_BOOL(values != NULL);
+    if (values == NULL) return;
+
+    for (int64_t i = 0; i < value_count; ++i)
+    {
+        TEST_BOOL(jsl_memory_compare(values[i], inserted[i]));
+        TEST_BOOL(values[i].data != inserted[i].data);
+    }
+
+    // the span and the iterator agree, both in insertion order
+    JSLStrToStrMultimapValueIter iter;
+    TEST_BOOL(jsl_str_to_str_multimap_get_values_for_key_iterator_init(&map, &iter, key));
+    JSLImmutableMemory iter_value;
+    int64_t iter_index = 0;
+    while (jsl_str_to_str_multimap_get_values_for_key_iterator_next(&iter, &iter_value))
+    {
+        TEST_BOOL(iter_index < value_count && iter_value.data == values[iter_index].data);
+        ++iter_index;
+    }
+    TEST_INT64_EQUAL(iter_index, value_count);
+
+    // deleting keeps the remaining values in order
+    TEST_BOOL(jsl_str_to_str_multimap_delete_value(&map, key, JSL_CSTR_EXPRESSION("v1")));
+    TEST_BOOL(jsl_str_to_str_multimap_delete_value(&map, key, JSL_CSTR_EXPRESSION("a-much-longer-value-that-does-not-fit-10")));
+    TEST_BOOL(jsl_str_to_str_multimap_get_values_span(&map, key, &values, &value_count));
+    TEST_INT64_EQUAL(value_count, value_total - 2);
+    TEST_BOOL(jsl_memory_compare(values[0], JSL_CSTR_EXPRESSION("a-much-longer-value-that-does-not-fit-0")));
+    TEST_BOOL(jsl_memory_compare(values[1], JSL_CSTR_EXPRESSION("v2")));
+    TEST_BOOL(jsl_memory_compare(values[8], JSL_CSTR_EXPRESSION("v9")));
+    TEST_BOOL(jsl_memory_compare(values[9], JSL_CSTR_EXPRESSION("v11")));
+    TEST_BOOL(jsl_memory_compare(values[value_count - 1], JSL_CSTR_EXPRESSION("v499")));
+
+    // missing keys and bad parameters
+    TEST_BOOL(!jsl_str_to_str_multimap_get_values_span(&map, JSL_CSTR_EXPRESSION("missing"), &values, &value_count));
+    TEST_POINTERS_EQUAL(values, NULL);
+    TEST_INT64_EQUAL(value_count, (int64_t) 0);
+    TEST_BOOL(!jsl_str_to_str_multimap_get_values_span(NULL, key, &values, &value_count));
+    TEST_BOOL(!jsl_str_to_str_multimap_get_values_span(&map, key, NULL, &value_count));
+    TEST_BOOL(!jsl_str_to_str_multimap_get_values_span(&map, key, &values, NULL));
+
+    // a recycled key reuses the value array of the deleted one
+    struct JSL__StrToStrMultimapEntry* entry = NULL;
+    for (int64_t i = 0; i < map.entry_lookup_table_length; ++i)
+    {
+        uintptr_t slot = map.entry_lookup_table[i];
+        if (slot != JSL__MULTIMAP_EMPTY && slot != JSL__MULTIMAP_TOMBSTONE && slot != 0)
+            entry = (struct JSL__StrToStrMultimapEntry*) slot;
+    }
+    TEST_BOOL(entry != NULL);
+    if (entry == NULL) return;
+
+    JSLImmutableMemory* value_array = entry->values;
+    TEST_BOOL(jsl_str_to_str_multimap_delete_key(&map, key));
+    TEST_INT64_EQUAL(jsl_str_to_str_multimap_get_value_count(&map), (int64_t) 0);
+
+    JSLImmutableMemory other_key = JSL_CSTR_EXPRESSION("x-request-id");
+    TEST_BOOL(jsl_str_to_str_multimap_insert(&map, other_key, JSL_STRING_LIFETIME_LONGER, JSL_CSTR_EXPRESSION("abc"), JSL_STRING_LIFETIME_SHORTER));
+    TEST_BOOL(jsl_str_to_str_multimap_get_values_span(&map, other_key, &values, &value_count));
+    TEST_INT64_EQUAL(value_count, (int64_t) 1);
+    TEST_POINTERS_EQUAL(values, value_array);
+    TEST_BOOL(jsl_memory_compare(values[0], JSL_CSTR_EXPRESSION("abc")));
+}
+
+void test_jsl_str_to_str_multimap_incremental_rehash(void)
+{
+    JSLStrToStrMultimap map = {0};
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+
+    bool ok = jsl_str_to_str_multimap_init2(&map, allocator, 6060, 4, 0.5f);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    TEST_BOOL(!jsl_str_to_str_multimap_enable_incremental_rehash(&map, -1));
+    TEST_BOOL(jsl_str_to_str_multimap_enable_incremental_rehash(&map, 2));
+
+    #define max_keys 256
+    JSLImmutableMemory keys[max_keys] = {0};
+
+    // keep inserting until a table grow leaves a rehash in progress,
+    // every key gets two values
+    int key_count = 0;
+    while (key_count < max_keys)
+    {
+        keys[key_count] = jsl_format(allocator, JSL_CSTR_EXPRESSION("key-%d"), key_count);
+
+        TEST_BOOL(jsl_str_to_str_multimap_insert(&map, keys[key_count], JSL_STRING_LIFETIME_LONGER, JSL_CSTR_EXPRESSION("a"), JSL_STRING_LIFETIME_LONGER));
+        TEST_BOOL(jsl_str_to_str_multimap_insert(&map, keys[key_count], JSL_STRING_LIFETIME_LONGER, JSL_CSTR_EXPRESSION("b"), JSL_STRING_LIFETIME_LONGER));
+        ++key_count;
+
+        if (key_count > 16 && map.old_entry_lookup_table != NULL)
+            break;
+    }
+
+    TEST_BOOL(map.old_entry_lookup_table != NULL);
+    TEST_INT64_EQUAL(jsl_str_to_str_multimap_get_key_count(&map), (int64_t) key_count);
+    TEST_INT64_EQUAL(jsl_str_to_str_multimap_get_value_count(&map), (int64_t) key_count * 2);
+
+    for (int i = 0; i < key_count; ++i)
+    {
+        TEST_BOOL(jsl_str_to_str_multimap_has_key(&map, keys[i]));
+        TEST_INT64_EQUAL(jsl_str_to_str_multimap_get_value_count_for_key(&map, keys[i]), (int64_t) 2);
+    }
+
+    int64_t seen = 0;
+    JSLStrToStrMultimapKeyValueIter iter;
+    jsl_str_to_str_multimap_key_value_iterator_init(&map, &iter);
+    JSLImmutableMemory out_key = {0};
+    JSLImmutableMemory out_value = {0};
+    while (jsl_str_to_str_multimap_key_value_iterator_next(&iter, &out_key, &out_value))
+    {
+        seen++;
+    }
+    TEST_INT64_EQUAL(seen, (int64_t) key_count * 2);
+
+    // deleting a missing key still migrates slots, which has to invalidate
+    // iterators even though nothing was removed
+    {
+        bool will_move = false;
+        for (int64_t i = map.rehash_migrate_index; i < map.rehash_migrate_index + 2; ++i)
+        {
+            uintptr_t slot = map.old_entry_lookup_table[i];
+            if (slot != 0 && slot != JSL__MULTIMAP_EMPTY && slot != JSL__MULTIMAP_TOMBSTONE)
+                will_move = true;
+        }
+        TEST_BOOL(will_move);
+
+        jsl_str_to_str_multimap_key_value_iterator_init(&map, &iter);
+        TEST_BOOL(jsl_str_to_str_multimap_key_value_iterator_next(&iter, &out_key, &out_value));
+        TEST_BOOL(!jsl_str_to_str_multimap_delete_key(&map, JSL_CSTR_EXPRESSION("missing")));
+        TEST_BOOL(!jsl_str_to_str_multimap_key_value_iterator_next(&iter, &out_key, &out_value));
+        TEST_INT64_EQUAL(jsl_str_to_str_multimap_get_key_count(&map), (int64_t) key_count);
+    }
+
+    // the earliest keys are the most likely to still be in the old table
+    TEST_BOOL(jsl_str_to_str_multimap_insert(&map, keys[0], JSL_STRING_LIFETIME_LONGER, JSL_CSTR_EXPRESSION("c"), JSL_STRING_LIFETIME_LONGER));
+    TEST_BOOL(jsl_str_to_str_multimap_delete_key(&map, keys[1]));
+    TEST_BOOL(jsl_str_to_str_multimap_delete_value(&map, keys[2], JSL_CSTR_EXPRESSION("a")));
+    TEST_BOOL(jsl_str_to_str_multimap_delete_value(&map, keys[2], JSL_CSTR_EXPRESSION("b")));
+    TEST_BOOL(!jsl_str_to_str_multimap_has_key(&map, keys[2]));
+
+    TEST_BOOL(jsl_str_to_str_multimap_finish_rehash(&map));
+    TEST_POINTERS_EQUAL(map.old_entry_lookup_table, NULL);
+
+    TEST_INT64_EQUAL(jsl_str_to_str_multimap_get_key_count(&map), (int64_t) key_count - 2);
+    TEST_INT64_EQUAL(jsl_str_to_str_multimap_get_value_count(&map), (int64_t) key_count * 2 - 3);
+    TEST_INT64_EQUAL(jsl_str_to_str_multimap_get_value_count_for_key(&map, keys[0]), (int64_t) 3);
+    TEST_BOOL(!jsl_str_to_str_multimap_has_key(&map, keys[1]));
+
+    JSLStrToStrMultimapValueIter value_iter;
+    TEST_BOOL(jsl_str_to_str_multimap_get_values_for_key_iterator_init(&map, &value_iter, keys[3]));
+    int64_t values_seen = 0;
+    while (jsl_str_to_str_multimap_get_values_for_key_iterator_next(&value_iter, &out_value))
+    {
+        values_seen++;
+    }
+    TEST_INT64_EQUAL(values_seen, (int64_t) 2);
+
+    TEST_BOOL(jsl_str_to_str_multimap_enable_incremental_rehash(&map, 0));
+
+    #undef max_keys
+}
+
 void test_stress_test(void)
 {
     JSLStrToStrMultimap map = {0};
@@ -570,3 +810,92 @@ void test_stress_test(void)
 
     TEST_INT64_EQUAL(seen_value_count, key_count * value_per_key);
 }
+
+static int64_t libc_allocated_bytes(JSLLibcAllocator* libc_allocator)
+{
+    int64_t total = 0;
+    for (struct JSL__LibcAllocationHeader* header = libc_allocator->head; header != NULL; header = header->prev)
+    {
+        total += header->length;
+    }
+    return total;
+}
+
+void test_jsl_str_to_str_multimap_reserve_and_shrink(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    JSLStrToStrMultimap map = {0};
+    TEST_BOOL(!jsl_str_to_str_multimap_reserve(&map, 10));
+    TEST_BOOL(!jsl_str_to_str_multimap_shrink_to_fit(&map));
+    TEST_INT64_EQUAL(jsl_str_to_str_multimap_memory_footprint(&map), (int64_t) -1);
+
+    bool ok = jsl_str_to_str_multimap_init(&map, allocator, 99);
+    TEST_BOOL(ok);
+    if (!ok) return;
+
+    TEST_BOOL(!jsl_str_to_str_multimap_reserve(&map, -1));
+    TEST_BOOL(jsl_str_to_str_multimap_reserve(&map, 1000));
+    int64_t reserved_length = map.entry_lookup_table_length;
+    TEST_INT64_EQUAL(reserved_length, (int64_t) 2048);
+
+    char key_buffer[64];
+    char value_buffer[64];
+    for (int32_t i = 0; i < 1000; ++i)
+    {
+        // short keys live in the entry, long ones are copied, values are
+        // packed, copied, or borrowed
+        snprintf(key_buffer, sizeof(key_buffer), i % 2 == 0 ? "k%d" : "a-key-long-enough-to-be-copied-%d", i);
+        JSLImmutableMemory key = jsl_cstr_to_memory(key_buffer);
+
+        snprintf(value_buffer, sizeof(value_buffer), "v%d", i);
+        TEST_BOOL(jsl_str_to_str_multimap_insert(
+            &map, key, JSL_STRING_LIFETIME_SHORTER,
+            jsl_cstr_to_memory(value_buffer), JSL_STRING_LIFETIME_SHORTER
+        ));
+
+        snprintf(value_buffer, sizeof(value_buffer), "a-value-long-enough-to-be-copied-%d", i);
+        TEST_BOOL(jsl_str_to_str_multimap_insert(
+            &map, key, JSL_STRING_LIFETIME_SHORTER,
+            jsl_cstr_to_memory(value_buffer), JSL_STRING_LIFETIME_SHORTER
+        ));
+
+        TEST_BOOL(jsl_str_to_str_multimap_insert(
+            &map, key, JSL_STRING_LIFETIME_SHORTER,
+            JSL_CSTR_EXPRESSION("borrowed"), JSL_STRING_LIFETIME_LONGER
+        ));
+    }
+
+    TEST_INT64_EQUAL(map.entry_lookup_table_length, reserved_length);
+    TEST_INT64_EQUAL(jsl_str_to_str_multimap_memory_footprint(&map), libc_allocated_bytes(&libc_allocator));
+
+    for (int32_t i = 20; i < 1000; ++i)
+    {
+        snprintf(key_buffer, sizeof(key_buffer), i % 2 == 0 ? "k%d" : "a-key-long-enough-to-be-copied-%d", i);
+        TEST_BOOL(jsl_str_to_str_multimap_delete_key(&map, jsl_cstr_to_memory(key_buffer)));
+    }
+
+    // deleted keys keep their entry and value storage in the free list
+    TEST_INT64_EQUAL(jsl_str_to_str_multimap_memory_footprint(&map), libc_allocated_bytes(&libc_allocator));
+
+    TEST_BOOL(jsl_str_to_str_multimap_shrink_to_fit(&map));
+    TEST_INT64_EQUAL(map.entry_lookup_table_length, (int64_t) 32);
+    TEST_POINTERS_EQUAL(map.entry_free_list, NULL);
+    TEST_INT64_EQUAL(jsl_str_to_str_multimap_memory_footprint(&map), libc_allocated_bytes(&libc_allocator));
+
+    TEST_INT64_EQUAL(jsl_str_to_str_multimap_get_key_count(&map), (int64_t) 20);
+    for (int32_t i = 0; i < 20; ++i)
+    {
+        snprintf(key_buffer, sizeof(key_buffer), i % 2 == 0 ? "k%d" : "a-key-long-enough-to-be-copied-%d", i);
+        TEST_INT64_EQUAL(
+            jsl_str_to_str_multimap_get_value_count_for_key(&map, jsl_cstr_to_memory(key_buffer)),
+            (int64_t) 3
+        );
+    }
+
+    // the multimap has no free, hand everything back through the allocator
+    jsl_allocator_interface_free_all(allocator);
+}
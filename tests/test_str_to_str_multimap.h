@@ -14,6 +14,10 @@ void test_jsl_str_to_str_multimap_delete_value(void);
 void test_jsl_str_to_str_multimap_delete_value_removes_empty_key(void);
 void test_jsl_str_to_str_multimap_delete_key(void);
 void test_jsl_str_to_str_multimap_clear(void);
+void test_jsl_str_to_str_multimap_delete_churn(void);
+void test_jsl_str_to_str_multimap_values_span(void);
+void test_jsl_str_to_str_multimap_incremental_rehash(void);
+void test_jsl_str_to_str_multimap_reserve_and_shrink(void);
 void test_stress_test(void);
 
 #endif
@@ -0,0 +1,286 @@
+/**
+ * Copyright (c) 2026 Jack Stouffer
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the “Software”),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "jsl/core.h"
+#include "jsl/allocator.h"
+#include "jsl/allocator_infinite_arena.h"
+#include "jsl/allocator_libc.h"
+#include "jsl/atomic_common.h"
+#include "jsl/os.h"
+#include "jsl/thread_pool.h"
+
+#include "minctest.h"
+#include "test_thread_pool.h"
+
+#define THREAD_POOL_WORKER_COUNT 4
+
+extern JSLInfiniteArena global_arena;
+
+typedef struct CoverageState {
+    int32_t* hits;
+    int64_t offset;
+    int64_t grain;
+    int32_t worker_count;
+    /// @brief set when a part was bigger than the grain or a worker index was out of bounds
+    uint64_t failed;
+} CoverageState;
+
+static void mark_range(JSLThreadPoolWorker* worker, int64_t begin, int64_t end, void* user_data)
+{
+    CoverageState* state = (CoverageState*) user_data;
+
+    int32_t index = jsl_thread_pool_worker_index(worker);
+    if (end - begin > state->grain || index < 0 || index >= state->worker_count)
+        jsl__atomic_store_u64(&state->failed, 1);
+
+    // Parts never overlap, so plain writes are enough
+    for (int64_t i = begin; i < end; ++i)
+        ++state->hits[i - state->offset];
+}
+
+static bool run_coverage(JSLThreadPool* pool, int64_t begin, int64_t end, int64_t grain)
+{
+    JSLAllocatorInterface allocator;
+    jsl_infinite_arena_get_allocator_interface(&allocator, &global_arena);
+
+    int64_t count = end - begin;
+    CoverageState state = {
+        .hits = (int32_t*) jsl_allocator_interface_alloc(
+            allocator,
+            (int64_t) sizeof(int32_t) * JSL_MAX(count, (int64_t) 1),
+            _Alignof(int32_t),
+            true
+        ),
+        .offset = begin,
+        .grain = grain,
+        .worker_count = jsl_thread_pool_worker_count(pool)
+    };
+
+    bool res = jsl_thread_pool_parallel_for(pool, begin, end, grain, mark_range, &state);
+
+    for (int64_t i = 0; i < count && res; ++i)
+    {
+        res = state.hits[i] == 1;
+    }
+
+    return res && state.failed == 0;
+}
+
+void test_jsl_thread_pool_parallel_for_covers_range(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    JSLThreadPool pool;
+    TEST_BOOL(jsl_thread_pool_init(&pool, allocator, THREAD_POOL_WORKER_COUNT, 0));
+    TEST_INT32_EQUAL(jsl_thread_pool_worker_count(&pool), THREAD_POOL_WORKER_COUNT);
+
+    TEST_BOOL(run_coverage(&pool, 0, 100003, 64));
+    TEST_BOOL(run_coverage(&pool, -5000, 5000, 1));
+    TEST_BOOL(run_coverage(&pool, 7, 8, 1));
+    TEST_BOOL(run_coverage(&pool, 0, 1000, 5000));
+
+    // The pool can be reused for many loops in a row
+    bool repeated = true;
+    for (int32_t i = 0; i < 100 && repeated; ++i)
+        repeated = run_coverage(&pool, 0, 300, 3);
+    TEST_BOOL(repeated);
+
+    jsl_thread_pool_free(&pool);
+
+    // A single worker runs everything on the calling thread
+    TEST_BOOL(jsl_thread_pool_init(&pool, allocator, 1, 0));
+    TEST_BOOL(run_coverage(&pool, 0, 4099, 16));
+    jsl_thread_pool_free(&pool);
+
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+
+    jsl_infinite_arena_reset(&global_arena);
+}
+
+typedef struct NestedState {
+    uint64_t total;
+    uint64_t inner_calls;
+} NestedState;
+
+static void inner_sum(JSLThreadPoolWorker* worker, int64_t begin, int64_t end, void* user_data)
+{
+    (void) worker;
+    NestedState* state = (NestedState*) user_data;
+
+    uint64_t sum = 0;
+    for (int64_t i = begin; i < end; ++i)
+        sum += (uint64_t) i;
+
+    jsl__atomic_fetch_add_u64(&state->total, sum);
+    jsl__atomic_fetch_add_u64(&state->inner_calls, 1);
+}
+
+static void outer_loop(JSLThreadPoolWorker* worker, int64_t begin, int64_t end, void* user_data)
+{
+    for (int64_t i = begin; i < end; ++i)
+    {
+        bool res = jsl_thread_pool_worker_parallel_for(worker, 0, 1024, 8, inner_sum, user_data);
+        JSL_ASSERT(res);
+    }
+}
+
+void test_jsl_thread_pool_nested_parallel_for(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    JSLThreadPool pool;
+    TEST_BOOL(jsl_thread_pool_init(&pool, allocator, THREAD_POOL_WORKER_COUNT, 0));
+
+    NestedState state = {0};
+    TEST_BOOL(jsl_thread_pool_parallel_for(&pool, 0, 16, 1, outer_loop, &state));
+
+    // Every inner loop has returned by the time the outer one does, and
+    // halving 1024 down to the grain gives exactly 128 parts per inner loop
+    TEST_INT64_EQUAL((int64_t) state.total, (int64_t) (16 * (1023 * 1024 / 2)));
+    TEST_INT64_EQUAL((int64_t) state.inner_calls, (int64_t) (16 * 128));
+
+    jsl_thread_pool_free(&pool);
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+}
+
+typedef struct ScratchState {
+    uint64_t failed_allocations;
+    uint64_t calls;
+} ScratchState;
+
+static void use_scratch(JSLThreadPoolWorker* worker, int64_t begin, int64_t end, void* user_data)
+{
+    (void) begin;
+    (void) end;
+    ScratchState* state = (ScratchState*) user_data;
+
+    JSLAllocatorInterface scratch;
+    bool res = jsl_thread_pool_worker_scratch(worker, &scratch);
+
+    // Three quarters of the arena per call, which only keeps fitting if each
+    // call's memory is released when it returns
+    for (int32_t i = 0; i < 3 && res; ++i)
+    {
+        uint8_t* memory = (uint8_t*) jsl_allocator_interface_alloc(scratch, 512, 8, false);
+        res = memory != NULL;
+        if (res)
+            JSL_MEMSET(memory, 0xAB, 512);
+    }
+
+    if (!res)
+        jsl__atomic_fetch_add_u64(&state->failed_allocations, 1);
+    jsl__atomic_fetch_add_u64(&state->calls, 1);
+}
+
+void test_jsl_thread_pool_worker_scratch(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    JSLThreadPool pool;
+    TEST_BOOL(jsl_thread_pool_init(&pool, allocator, THREAD_POOL_WORKER_COUNT, 2048));
+
+    ScratchState state = {0};
+    TEST_BOOL(jsl_thread_pool_parallel_for(&pool, 0, 1000, 1, use_scratch, &state));
+    TEST_INT64_EQUAL((int64_t) state.calls, (int64_t) 1000);
+    TEST_INT64_EQUAL((int64_t) state.failed_allocations, (int64_t) 0);
+
+    jsl_thread_pool_free(&pool);
+
+    // Without scratch memory every allocation fails
+    TEST_BOOL(jsl_thread_pool_init(&pool, allocator, 2, 0));
+    state = (ScratchState) {0};
+    TEST_BOOL(jsl_thread_pool_parallel_for(&pool, 0, 10, 1, use_scratch, &state));
+    TEST_INT64_EQUAL((int64_t) state.calls, (int64_t) 10);
+    TEST_INT64_EQUAL((int64_t) state.failed_allocations, (int64_t) 10);
+
+    jsl_thread_pool_free(&pool);
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+}
+
+static void count_calls(JSLThreadPoolWorker* worker, int64_t begin, int64_t end, void* user_data)
+{
+    (void) worker;
+    (void) begin;
+    (void) end;
+    jsl__atomic_fetch_add_u64((uint64_t*) user_data, 1);
+}
+
+void test_jsl_thread_pool_invalid_parameters(void)
+{
+    JSLLibcAllocator libc_allocator;
+    jsl_libc_allocator_init(&libc_allocator);
+    JSLAllocatorInterface allocator;
+    jsl_libc_allocator_get_allocator_interface(&allocator, &libc_allocator);
+
+    JSLThreadPool pool;
+    TEST_BOOL(!jsl_thread_pool_init(NULL, allocator, 2, 0));
+    TEST_BOOL(!jsl_thread_pool_init(&pool, allocator, 2, -1));
+
+    uint64_t calls = 0;
+    TEST_BOOL(!jsl_thread_pool_parallel_for(&pool, 0, 10, 1, count_calls, &calls));
+    TEST_INT32_EQUAL(jsl_thread_pool_worker_count(&pool), -1);
+    TEST_INT32_EQUAL(jsl_thread_pool_worker_index(NULL), -1);
+
+    JSLAllocatorInterface scratch;
+    TEST_BOOL(!jsl_thread_pool_worker_scratch(NULL, &scratch));
+    TEST_BOOL(!jsl_thread_pool_worker_parallel_for(NULL, 0, 10, 1, count_calls, &calls));
+
+    // Zero workers means one per logical processor
+    int32_t processor_errno = 0;
+    int32_t processor_count = jsl_get_logical_processor_count(&processor_errno);
+    TEST_BOOL(jsl_thread_pool_init(&pool, allocator, 0, 0));
+    TEST_INT32_EQUAL(jsl_thread_pool_worker_count(&pool), JSL_MAX(processor_count, 1));
+
+    TEST_BOOL(!jsl_thread_pool_parallel_for(NULL, 0, 10, 1, count_calls, &calls));
+    TEST_BOOL(!jsl_thread_pool_parallel_for(&pool, 0, 10, 0, count_calls, &calls));
+    TEST_BOOL(!jsl_thread_pool_parallel_for(&pool, 10, 0, 1, count_calls, &calls));
+    TEST_BOOL(!jsl_thread_pool_parallel_for(&pool, 0, 10, 1, NULL, &calls));
+    TEST_INT64_EQUAL((int64_t) calls, (int64_t) 0);
+
+    // An empty range is valid and never calls the function
+    TEST_BOOL(jsl_thread_pool_parallel_for(&pool, 5, 5, 1, count_calls, &calls));
+    TEST_INT64_EQUAL((int64_t) calls, (int64_t) 0);
+
+    jsl_thread_pool_free(&pool);
+    jsl_thread_pool_free(&pool);
+    jsl_thread_pool_free(NULL);
+    TEST_BOOL(!jsl_thread_pool_parallel_for(&pool, 0, 10, 1, count_calls, &calls));
+
+    TEST_POINTERS_EQUAL(libc_allocator.head, NULL);
+}
@@ -0,0 +1,9 @@
+#ifndef TEST_THREAD_POOL_H
+#define TEST_THREAD_POOL_H
+
+void test_jsl_thread_pool_parallel_for_covers_range(void);
+void test_jsl_thread_pool_nested_parallel_for(void);
+void test_jsl_thread_pool_worker_scratch(void);
+void test_jsl_thread_pool_invalid_parameters(void);
+
+#endif
@@ -62,7 +62,12 @@ JSLImmutableMemory help_message = JSL_CSTR_INITIALIZER(
     "This program generates both a C source and header file for an array with the given\n"
     "element type. More documentation is included in the source file.\n\n"
     "USAGE:\n\n"
-    "\tgenerate_array --name TYPE_NAME --function-prefix PREFIX --value-type TYPE [--static | --dynamic] [--header | --source] [--add-header=FILE]...\n\n"
+    "\tgenerate_array --name TYPE_NAME --function-prefix PREFIX --value-type TYPE [--static | --dynamic] [--header | --source] [--add-header=FILE]...\n"
+    "\tgenerate_array --name TYPE_NAME --function-prefix PREFIX --value-type STRUCT --dynamic --soa --field NAME:TYPE... [--header | --source] [--add-header=FILE]...\n"
+    "\tgenerate_array --name TYPE_NAME --function-prefix PREFIX --value-type TYPE --dynamic --sort [--less-than FUNC | --key-function FUNC --key-type TYPE] [--header | --source] [--add-header=FILE]...\n"
+    "\tgenerate_array --name TYPE_NAME --function-prefix PREFIX --value-type TYPE --dynamic --segmented [--block-length N] [--header | --source] [--add-header=FILE]...\n"
+    "\tgenerate_array --name TYPE_NAME --function-prefix PREFIX --value-type TYPE [--fixed | --dynamic] --ring [--header | --source] [--add-header=FILE]...\n"
+    "\tgenerate_array --name TYPE_NAME --function-prefix PREFIX --value-type TYPE --fixed [--spsc | --mpmc] [--header | --source] [--add-header=FILE]...\n\n"
     "Required arguments:\n"
     "\t--name\t\t\tThe name to give the hash map container type\n"
     "\t--function-prefix\tThe prefix added to each of the functions for the hash map\n"
@@ -72,10 +77,54 @@ JSLImmutableMemory help_message = JSL_CSTR_INITIALIZER(
     "\t--source\t\tWrite the source file to stdout\n"
     "\t--dynamic\t\tGenerate a hash map which grows dynamically\n"
     "\t--static\t\tGenerate a statically sized hash map\n"
+    "\t--soa\t\t\tGenerate a structure of arrays with one column per --field of the value struct\n"
+    "\t--field\t\t\tA column of a --soa array given as NAME:TYPE, e.g. --field x:float. Repeat for each field\n"
+    "\t--sort\t\t\tAlso generate sort, nth element, partial sort, lower and upper bound, and for numeric keys radix sort functions\n"
+    "\t--less-than\t\tName of a bool FUNC(const TYPE* a, const TYPE* b) to sort with instead of <\n"
+    "\t--key-function\t\tName of a KEY FUNC(const TYPE* value) which returns the key to sort by\n"
+    "\t--key-type\t\tThe C type returned by --key-function\n"
+    "\t--segmented\t\tStore elements in fixed size blocks which never move, so pointers to elements stay valid as the array grows\n"
+    "\t--block-length\t\tThe number of elements per --segmented block, a power of two. Defaults to 1024\n"
+    "\t--ring\t\t\tGenerate a power of two ring buffer usable as a queue or deque. With --fixed it never grows and pushes to a full ring fail\n"
+    "\t--spsc\t\t\tGenerate a bounded lock free queue for one producer thread and one consumer thread\n"
+    "\t--mpmc\t\t\tGenerate a bounded lock free queue for any number of producer and consumer threads\n"
     "\t--add-header\t\tPath to a C header which will be added with a #include directive at the top of the generated file\n"
     "\t--custom-hash\t\tOverride the included hash call with the given function name\n"
 );
 
+// Columns become struct members, so they have to be identifiers which don't
+// collide with the bookkeeping members of the generated struct
+static bool is_valid_field_name(JSLImmutableMemory field_name)
+{
+    static JSLImmutableMemory reserved_names[] = {
+        JSL_CSTR_INITIALIZER("sentinel"),
+        JSL_CSTR_INITIALIZER("allocator"),
+        JSL_CSTR_INITIALIZER("block"),
+        JSL_CSTR_INITIALIZER("length"),
+        JSL_CSTR_INITIALIZER("capacity")
+    };
+
+    bool res = field_name.length > 0
+        && !(field_name.data[0] >= '0' && field_name.data[0] <= '9');
+
+    for (int64_t i = 0; res && i < field_name.length; ++i)
+    {
+        uint8_t c = field_name.data[i];
+        res = (c >= 'a' && c <= 'z')
+            || (c >= 'A' && c <= 'Z')
+            || (c >= '0' && c <= '9')
+            || c == '_';
+    }
+
+    int32_t reserved_count = (int32_t) (sizeof(reserved_names) / sizeof(JSLImmutableMemory));
+    for (int32_t i = 0; res && i < reserved_count; ++i)
+    {
+        res = !jsl_memory_compare(field_name, reserved_names[i]);
+    }
+
+    return res;
+}
+
 static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
 {
     bool show_help = false;
@@ -85,6 +134,11 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
     ArrayImplementation impl = IMPL_ERROR;
     JSLImmutableMemory* header_includes = NULL;
     int32_t header_includes_count = 0;
+    ArrayField* fields = NULL;
+    ArraySortOptions sort_options = {0};
+    JSLImmutableMemory block_length_arg = {0};
+    int32_t block_length = 1024;
+    int32_t field_count = 0;
 
     JSLOutputSink stdout_sink = jsl_c_file_output_sink(stdout);
     JSLOutputSink stderr_sink = jsl_c_file_output_sink(stderr);
@@ -98,6 +152,17 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
     static JSLImmutableMemory header_flag_str = JSL_CSTR_INITIALIZER("header");
     static JSLImmutableMemory source_flag_str = JSL_CSTR_INITIALIZER("source");
     static JSLImmutableMemory add_header_flag_str = JSL_CSTR_INITIALIZER("add-header");
+    static JSLImmutableMemory soa_flag_str = JSL_CSTR_INITIALIZER("soa");
+    static JSLImmutableMemory field_flag_str = JSL_CSTR_INITIALIZER("field");
+    static JSLImmutableMemory sort_flag_str = JSL_CSTR_INITIALIZER("sort");
+    static JSLImmutableMemory less_than_flag_str = JSL_CSTR_INITIALIZER("less-than");
+    static JSLImmutableMemory key_function_flag_str = JSL_CSTR_INITIALIZER("key-function");
+    static JSLImmutableMemory key_type_flag_str = JSL_CSTR_INITIALIZER("key-type");
+    static JSLImmutableMemory segmented_flag_str = JSL_CSTR_INITIALIZER("segmented");
+    static JSLImmutableMemory block_length_flag_str = JSL_CSTR_INITIALIZER("block-length");
+    static JSLImmutableMemory ring_flag_str = JSL_CSTR_INITIALIZER("ring");
+    static JSLImmutableMemory spsc_flag_str = JSL_CSTR_INITIALIZER("spsc");
+    static JSLImmutableMemory mpmc_flag_str = JSL_CSTR_INITIALIZER("mpmc");
 
     //
     // Parsing command line
@@ -109,6 +174,10 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
     jsl_cmd_line_args_pop_flag_with_value(cmd, name_flag_str, &name);
     jsl_cmd_line_args_pop_flag_with_value(cmd, function_prefix_flag_str, &function_prefix);
     jsl_cmd_line_args_pop_flag_with_value(cmd, value_type_flag_str, &value_type);
+    jsl_cmd_line_args_pop_flag_with_value(cmd, less_than_flag_str, &sort_options.less_than_function);
+    jsl_cmd_line_args_pop_flag_with_value(cmd, key_function_flag_str, &sort_options.key_function);
+    jsl_cmd_line_args_pop_flag_with_value(cmd, key_type_flag_str, &sort_options.key_type_name);
+    jsl_cmd_line_args_pop_flag_with_value(cmd, block_length_flag_str, &block_length_arg);
 
     JSLImmutableMemory custom_header = {0};
     while (jsl_cmd_line_args_pop_flag_with_value(cmd, add_header_flag_str, &custom_header))
@@ -121,10 +190,49 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
         header_includes[header_includes_count - 1] = custom_header;
     }
 
+    JSLImmutableMemory field_arg = {0};
+    while (jsl_cmd_line_args_pop_flag_with_value(cmd, field_flag_str, &field_arg))
+    {
+        int64_t separator = jsl_index_of(field_arg, ':');
+        ArrayField field = {0};
+        if (separator > -1)
+        {
+            field.name = jsl_slice(field_arg, 0, separator);
+            field.type_name = jsl_slice(field_arg, separator + 1, field_arg.length);
+            jsl_strip_whitespace(&field.name);
+            jsl_strip_whitespace(&field.type_name);
+        }
+
+        if (!is_valid_field_name(field.name) || field.type_name.length == 0)
+        {
+            jsl_format_sink(
+                stderr_sink,
+                JSL_CSTR_EXPRESSION("Error: --%y must be NAME:TYPE with a C identifier for a name, got \"%y\"\n"),
+                field_flag_str,
+                field_arg
+            );
+            return EXIT_FAILURE;
+        }
+
+        ++field_count;
+        fields = realloc(
+            fields,
+            sizeof(ArrayField) * (size_t) field_count
+        );
+        fields[field_count - 1] = field;
+    }
+
     bool fixed_flag_set = jsl_cmd_line_args_has_flag(cmd, fixed_flag_str);
     bool dynamic_flag_set = jsl_cmd_line_args_has_flag(cmd, dynamic_flag_str);
     bool header_flag_set = jsl_cmd_line_args_has_flag(cmd, header_flag_str);
     bool source_flag_set = jsl_cmd_line_args_has_flag(cmd, source_flag_str);
+    bool soa_flag_set = jsl_cmd_line_args_has_flag(cmd, soa_flag_str);
+    bool sort_flag_set = jsl_cmd_line_args_has_flag(cmd, sort_flag_str);
+    bool segmented_flag_set = jsl_cmd_line_args_has_flag(cmd, segmented_flag_str);
+    bool ring_flag_set = jsl_cmd_line_args_has_flag(cmd, ring_flag_str);
+    bool spsc_flag_set = jsl_cmd_line_args_has_flag(cmd, spsc_flag_str);
+    bool mpmc_flag_set = jsl_cmd_line_args_has_flag(cmd, mpmc_flag_str);
+    bool queue_flag_set = spsc_flag_set || mpmc_flag_set;
 
     if (show_help)
     {
@@ -204,10 +312,305 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
         return EXIT_FAILURE;
     }
 
+    if (soa_flag_set && !dynamic_flag_set)
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: --%y requires --%y\n"),
+            soa_flag_str,
+            dynamic_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+    if (soa_flag_set && field_count == 0)
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: --%y requires at least one --%y\n"),
+            soa_flag_str,
+            field_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+    if (!soa_flag_set && field_count > 0)
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: --%y can only be used with --%y\n"),
+            field_flag_str,
+            soa_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+
+    if (sort_flag_set && !dynamic_flag_set)
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: --%y requires --%y\n"),
+            sort_flag_str,
+            dynamic_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+    if (sort_flag_set && soa_flag_set)
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: cannot set both --%y and --%y\n"),
+            sort_flag_str,
+            soa_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+    if (
+        !sort_flag_set
+        && (
+            sort_options.less_than_function.data != NULL
+            || sort_options.key_function.data != NULL
+            || sort_options.key_type_name.data != NULL
+        )
+    )
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: --%y, --%y, and --%y can only be used with --%y\n"),
+            less_than_flag_str,
+            key_function_flag_str,
+            key_type_flag_str,
+            sort_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+    if (sort_options.less_than_function.data != NULL && sort_options.key_function.data != NULL)
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: cannot set both --%y and --%y\n"),
+            less_than_flag_str,
+            key_function_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+    if ((sort_options.key_function.data == NULL) != (sort_options.key_type_name.data == NULL))
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: --%y and --%y must be used together\n"),
+            key_function_flag_str,
+            key_type_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+
+    if (segmented_flag_set && !dynamic_flag_set)
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: --%y requires --%y\n"),
+            segmented_flag_str,
+            dynamic_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+    if (segmented_flag_set && (soa_flag_set || sort_flag_set))
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: --%y cannot be combined with --%y or --%y\n"),
+            segmented_flag_str,
+            soa_flag_str,
+            sort_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+    if (ring_flag_set && (soa_flag_set || sort_flag_set || segmented_flag_set))
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: --%y cannot be combined with --%y, --%y, or --%y\n"),
+            ring_flag_str,
+            soa_flag_str,
+            sort_flag_str,
+            segmented_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+    if (spsc_flag_set && mpmc_flag_set)
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: cannot set both --%y and --%y\n"),
+            spsc_flag_str,
+            mpmc_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+    if (queue_flag_set && !fixed_flag_set)
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: --%y and --%y queues are bounded and require --%y\n"),
+            spsc_flag_str,
+            mpmc_flag_str,
+            fixed_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+    if (queue_flag_set && (soa_flag_set || sort_flag_set || segmented_flag_set || ring_flag_set))
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: --%y and --%y cannot be combined with --%y, --%y, --%y, or --%y\n"),
+            spsc_flag_str,
+            mpmc_flag_str,
+            soa_flag_str,
+            sort_flag_str,
+            segmented_flag_str,
+            ring_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+    if (block_length_arg.data != NULL && !segmented_flag_set)
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: --%y can only be used with --%y\n"),
+            block_length_flag_str,
+            segmented_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+    if (block_length_arg.data != NULL)
+    {
+        int32_t read = jsl_memory_to_i32(block_length_arg, &block_length);
+        if (
+            read != block_length_arg.length
+            || block_length < 1
+            || block_length > (1 << 30)
+            || (block_length & (block_length - 1)) != 0
+        )
+        {
+            jsl_format_sink(
+                stderr_sink,
+                JSL_CSTR_EXPRESSION("Error: --%y must be a power of two, got \"%y\"\n"),
+                block_length_flag_str,
+                block_length_arg
+            );
+            return EXIT_FAILURE;
+        }
+    }
+
     if (fixed_flag_set) impl = IMPL_FIXED;
     if (dynamic_flag_set) impl = IMPL_DYNAMIC;
 
-    if (header_flag_set)
+    if (soa_flag_set && header_flag_set)
+    {
+        write_soa_array_header(
+            allocator,
+            stdout_sink,
+            name,
+            function_prefix,
+            value_type,
+            fields,
+            field_count,
+            header_includes,
+            header_includes_count
+        );
+    }
+    else if (soa_flag_set)
+    {
+        write_soa_array_source(
+            allocator,
+            stdout_sink,
+            name,
+            function_prefix,
+            value_type,
+            fields,
+            field_count,
+            header_includes,
+            header_includes_count
+        );
+    }
+    else if (segmented_flag_set && header_flag_set)
+    {
+        write_segmented_array_header(
+            allocator,
+            stdout_sink,
+            name,
+            function_prefix,
+            value_type,
+            block_length,
+            header_includes,
+            header_includes_count
+        );
+    }
+    else if (segmented_flag_set)
+    {
+        write_segmented_array_source(
+            allocator,
+            stdout_sink,
+            name,
+            function_prefix,
+            value_type,
+            block_length,
+            header_includes,
+            header_includes_count
+        );
+    }
+    else if (ring_flag_set && header_flag_set)
+    {
+        write_ring_array_header(
+            allocator,
+            stdout_sink,
+            impl,
+            name,
+            function_prefix,
+            value_type,
+            header_includes,
+            header_includes_count
+        );
+    }
+    else if (ring_flag_set)
+    {
+        write_ring_array_source(
+            allocator,
+            stdout_sink,
+            impl,
+            name,
+            function_prefix,
+            value_type,
+            header_includes,
+            header_includes_count
+        );
+    }
+    else if (queue_flag_set && header_flag_set)
+    {
+        write_queue_header(
+            allocator,
+            stdout_sink,
+            spsc_flag_set ? QUEUE_SPSC : QUEUE_MPMC,
+            name,
+            function_prefix,
+            value_type,
+            header_includes,
+            header_includes_count
+        );
+    }
+    else if (queue_flag_set)
+    {
+        write_queue_source(
+            allocator,
+            stdout_sink,
+            spsc_flag_set ? QUEUE_SPSC : QUEUE_MPMC,
+            name,
+            function_prefix,
+            value_type,
+            header_includes,
+            header_includes_count
+        );
+    }
+    else if (header_flag_set)
     {
         write_array_header(
             allocator,
@@ -219,6 +622,18 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
             header_includes,
             header_includes_count
         );
+
+        if (sort_flag_set)
+        {
+            write_array_sort_header(
+                allocator,
+                stdout_sink,
+                name,
+                function_prefix,
+                value_type,
+                &sort_options
+            );
+        }
     }
     else
     {
@@ -232,6 +647,18 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
             header_includes,
             header_includes_count
         );
+
+        if (sort_flag_set)
+        {
+            write_array_sort_source(
+                allocator,
+                stdout_sink,
+                name,
+                function_prefix,
+                value_type,
+                &sort_options
+            );
+        }
     }
 
     return EXIT_SUCCESS;
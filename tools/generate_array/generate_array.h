@@ -130,6 +130,13 @@
         IMPL_DYNAMIC
     } ArrayImplementation;
 
+    typedef enum {
+        /// @brief one producer thread and one consumer thread
+        QUEUE_SPSC,
+        /// @brief any number of producer and consumer threads
+        QUEUE_MPMC
+    } ArrayQueueKind;
+
     /**
      * Generate the text of the C header and insert it into the string sink.
      * 
@@ -175,6 +182,288 @@
         JSLImmutableMemory* include_header_array,
         int32_t include_header_count
     );
+
+    /**
+     * One column of a structure of arrays. `name` is the name of the field in
+     * the value struct and `type_name` is its C type.
+     */
+    typedef struct ArrayField {
+        JSLImmutableMemory name;
+        JSLImmutableMemory type_name;
+    } ArrayField;
+
+    /**
+     * Generate the text of the C header for a structure of arrays and insert
+     * it into the string sink. Each field in `field_array` becomes its own
+     * column, all of which share one allocation, length, and capacity.
+     * 
+     * @param allocator Used for all memory allocations
+     * @param sink Used to insert the generated text
+     * @param array_type_name The name of the container type
+     * @param function_prefix The prefix plus "_" for each function
+     * @param value_type_name The struct type which is split into columns
+     * @param field_array The fields of the value struct to store, in order
+     * @param field_count The length of the field array, must be at least one
+     * @param include_header_array If you need custom header includes then set this, otherwise pass NULL
+     * @param include_header_count The length of the header array
+     */
+    GENERATE_ARRAY_DEF void write_soa_array_header(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        ArrayField* field_array,
+        int32_t field_count,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    );
+
+    /**
+     * Generate the text of the C source for a structure of arrays and insert
+     * it into the string sink.
+     * 
+     * @param allocator Used for all memory allocations
+     * @param sink Used to insert the generated text
+     * @param array_type_name The name of the container type
+     * @param function_prefix The prefix plus "_" for each function
+     * @param value_type_name The struct type which is split into columns
+     * @param field_array The fields of the value struct to store, in order
+     * @param field_count The length of the field array, must be at least one
+     * @param include_header_array If you need custom header includes then set this, otherwise pass NULL
+     * @param include_header_count The length of the header array
+     */
+    GENERATE_ARRAY_DEF void write_soa_array_source(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        ArrayField* field_array,
+        int32_t field_count,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    );
+
+    /**
+     * Generate the text of the C header for a segmented array and insert it
+     * into the string sink. The elements are stored in separately allocated
+     * blocks of `block_length` elements, so growing never moves them.
+     * 
+     * @param allocator Used for all memory allocations
+     * @param sink Used to insert the generated text
+     * @param array_type_name The name of the container type
+     * @param function_prefix The prefix plus "_" for each function
+     * @param value_type_name The type of the array value
+     * @param block_length The number of elements per block, must be a power of two
+     * @param include_header_array If you need custom header includes then set this, otherwise pass NULL
+     * @param include_header_count The length of the header array
+     */
+    GENERATE_ARRAY_DEF void write_segmented_array_header(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        int64_t block_length,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    );
+
+    /**
+     * Generate the text of the C source for a segmented array and insert it
+     * into the string sink.
+     * 
+     * @param allocator Used for all memory allocations
+     * @param sink Used to insert the generated text
+     * @param array_type_name The name of the container type
+     * @param function_prefix The prefix plus "_" for each function
+     * @param value_type_name The type of the array value
+     * @param block_length The number of elements per block, must be a power of two
+     * @param include_header_array If you need custom header includes then set this, otherwise pass NULL
+     * @param include_header_count The length of the header array
+     */
+    GENERATE_ARRAY_DEF void write_segmented_array_source(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        int64_t block_length,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    );
+
+    /**
+     * Generate the text of the C header for a ring buffer and insert it into
+     * the string sink. The ring can be used as a FIFO queue or a double ended
+     * queue, and its capacity is always a power of two.
+     * 
+     * @param allocator Used for all memory allocations
+     * @param sink Used to insert the generated text
+     * @param impl IMPL_DYNAMIC to reallocate when the ring is full, IMPL_FIXED to fail the push instead
+     * @param array_type_name The name of the container type
+     * @param function_prefix The prefix plus "_" for each function
+     * @param value_type_name The type of the ring value
+     * @param include_header_array If you need custom header includes then set this, otherwise pass NULL
+     * @param include_header_count The length of the header array
+     */
+    GENERATE_ARRAY_DEF void write_ring_array_header(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        ArrayImplementation impl,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    );
+
+    /**
+     * Generate the text of the C source for a ring buffer and insert it into
+     * the string sink.
+     * 
+     * @param allocator Used for all memory allocations
+     * @param sink Used to insert the generated text
+     * @param impl IMPL_DYNAMIC to reallocate when the ring is full, IMPL_FIXED to fail the push instead
+     * @param array_type_name The name of the container type
+     * @param function_prefix The prefix plus "_" for each function
+     * @param value_type_name The type of the ring value
+     * @param include_header_array If you need custom header includes then set this, otherwise pass NULL
+     * @param include_header_count The length of the header array
+     */
+    GENERATE_ARRAY_DEF void write_ring_array_source(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        ArrayImplementation impl,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    );
+
+    /**
+     * Generate the text of the C header for a bounded, lock free queue which
+     * passes values between threads and insert it into the string sink.
+     * 
+     * @param allocator Used for all memory allocations
+     * @param sink Used to insert the generated text
+     * @param kind Whether the queue supports one or many producers and consumers
+     * @param array_type_name The name of the container type
+     * @param function_prefix The prefix plus "_" for each function
+     * @param value_type_name The type of the queue value
+     * @param include_header_array If you need custom header includes then set this, otherwise pass NULL
+     * @param include_header_count The length of the header array
+     */
+    GENERATE_ARRAY_DEF void write_queue_header(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        ArrayQueueKind kind,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    );
+
+    /**
+     * Generate the text of the C source for a bounded, lock free queue and
+     * insert it into the string sink.
+     * 
+     * @param allocator Used for all memory allocations
+     * @param sink Used to insert the generated text
+     * @param kind Whether the queue supports one or many producers and consumers
+     * @param array_type_name The name of the container type
+     * @param function_prefix The prefix plus "_" for each function
+     * @param value_type_name The type of the queue value
+     * @param include_header_array If you need custom header includes then set this, otherwise pass NULL
+     * @param include_header_count The length of the header array
+     */
+    GENERATE_ARRAY_DEF void write_queue_source(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        ArrayQueueKind kind,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    );
+
+    /**
+     * How the generated sort functions order elements. Leave everything
+     * zeroed to compare the elements directly with `<`, which works for any
+     * arithmetic value type.
+     */
+    typedef struct ArraySortOptions {
+        /**
+         * Name of a `bool less_than(const VALUE* a, const VALUE* b)` function
+         * to compare with. Declare it `static inline` in an added header so
+         * it's inlined into the sort. Disables the radix sort.
+         */
+        JSLImmutableMemory less_than_function;
+        /**
+         * Name of a `KEY key(const VALUE* value)` function which extracts a
+         * numeric sort key from each element. Needs `key_type_name`.
+         */
+        JSLImmutableMemory key_function;
+        JSLImmutableMemory key_type_name;
+    } ArraySortOptions;
+
+    /**
+     * Whether the sort functions for this value type and options include
+     * `_radix_sort`, which is the case when the sort key is one of the fixed
+     * width integer types, `float`, or `double`.
+     *
+     * @param value_type_name The type of the array value
+     * @param options The sort options, or NULL for the defaults
+     */
+    GENERATE_ARRAY_DEF bool array_sort_has_radix(
+        JSLImmutableMemory value_type_name,
+        ArraySortOptions* options
+    );
+
+    /**
+     * Generate the declarations of the sort, nth element, partial sort, and
+     * binary search functions for a dynamic array. Write this into the same
+     * sink right after `write_array_header`.
+     *
+     * @param allocator Used for all memory allocations
+     * @param sink Used to insert the generated text
+     * @param array_type_name The name of the container type
+     * @param function_prefix The prefix plus "_" for each function
+     * @param value_type_name The type of the array value
+     * @param options How elements are ordered, or NULL for the defaults
+     */
+    GENERATE_ARRAY_DEF void write_array_sort_header(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        ArraySortOptions* options
+    );
+
+    /**
+     * Generate the definitions of the sort functions. Write this into the
+     * same sink right after `write_array_source`.
+     *
+     * @param allocator Used for all memory allocations
+     * @param sink Used to insert the generated text
+     * @param array_type_name The name of the container type
+     * @param function_prefix The prefix plus "_" for each function
+     * @param value_type_name The type of the array value
+     * @param options How elements are ordered, or NULL for the defaults
+     */
+    GENERATE_ARRAY_DEF void write_array_sort_source(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        ArraySortOptions* options
+    );
     
     #ifdef __cplusplus
     }
@@ -596,84 +885,3294 @@
         "}\n"
     );
 
-    static JSLImmutableMemory array_type_name_key = JSL_CSTR_INITIALIZER("array_type_name");
-    static JSLImmutableMemory value_type_name_key = JSL_CSTR_INITIALIZER("value_type_name");
-    static JSLImmutableMemory function_prefix_key = JSL_CSTR_INITIALIZER("function_prefix");
-
-    // because rand max on some platforms is 32k
-    static inline uint64_t rand_u64(void)
-    {
-        uint64_t value = 0;
-
-        value = (value << 8) | (uint64_t)(rand() & 0xFF);
-        value = (value << 8) | (uint64_t)(rand() & 0xFF);
-        value = (value << 8) | (uint64_t)(rand() & 0xFF);
-        value = (value << 8) | (uint64_t)(rand() & 0xFF);
-        value = (value << 8) | (uint64_t)(rand() & 0xFF);
-        value = (value << 8) | (uint64_t)(rand() & 0xFF);
-        value = (value << 8) | (uint64_t)(rand() & 0xFF);
-        value = (value << 8) | (uint64_t)(rand() & 0xFF);
-
-        return value;
-    }
-
-    static void render_template(
-        JSLOutputSink sink,
-        JSLImmutableMemory template,
-        JSLStrToStrMap* variables
-    )
-    {
-        static JSLImmutableMemory open_param = JSL_CSTR_INITIALIZER("{{");
-        static JSLImmutableMemory close_param = JSL_CSTR_INITIALIZER("}}");
-        JSLImmutableMemory template_reader = template;
-        
-        while (template_reader.length > 0)
-        {
-            int64_t index_of_open = jsl_substring_search(template_reader, open_param);
-
-            // No more variables, write everything
-            if (index_of_open == -1)
-            {
-                jsl_output_sink_write(sink, template_reader);
-                break;
-            }
-
-            if (index_of_open > 0)
-            {
-                JSLImmutableMemory slice = jsl_slice(template_reader, 0, index_of_open);
-                jsl_output_sink_write(sink, slice);
-            }
-
-            JSL_MEMORY_ADVANCE(template_reader, index_of_open + open_param.length);
-
-            int64_t index_of_close = jsl_substring_search(template_reader, close_param);
-
-            // Improperly closed template param, write everything including the open marker
-            if (index_of_close == -1)
-            {
-                jsl_output_sink_write(sink, open_param);
-                jsl_output_sink_write(sink, template_reader);
-                break;
-            }
-
-            JSLImmutableMemory var_name = jsl_slice(template_reader, 0, index_of_close);
-            jsl_strip_whitespace(&var_name);
-
-            JSLImmutableMemory var_value;
-            if (jsl_str_to_str_map_get(variables, var_name, &var_value))
-            {
-                jsl_output_sink_write(sink, var_value);
-            }
-
-            JSL_MEMORY_ADVANCE(template_reader, index_of_close + close_param.length);
-        }
-    }
-
-    /**
-     * Generates the header file data for your hash map. This file includes all the typedefs
-     * and function signatures for this hash map.
-     *
-     * The generated header file includes "jacks_hash_map.h", and it's assumed to be in the
+    static JSLImmutableMemory soa_header_template = JSL_CSTR_INITIALIZER(
+        "/**\n"
+        " * AUTO GENERATED FILE\n"
+        " *\n"
+        " * This file contains the header for a structure of arrays `{{ array_type_name }}`\n"
+        " * which stores `{{ value_type_name }}` values as one column per field.\n"
+        " *\n"
+        " * This file was auto generated from the array code generation utility that's part of\n"
+        " * the \"Jack's Standard Library\" project. The utility generates a header file and a\n"
+        " * C file for a type safe structure of arrays. By generating the code rather than using macros,\n"
+        " * two benefits are gained. One, the code is much easier to debug. Two, it's much more\n"
+        " * obvious how much code you're generating, which means you are much less likely to accidentally\n"
+        " * create the combinatoric explosion of code that's so common in C++ projects. Adding friction\n"
+        " * to things is actually good sometimes.\n"
+        " */\n"
+        "\n"
+        "\n"
+        "#pragma once\n"
+        "\n"
+        "#include <stdint.h>\n"
+        "#include <stddef.h>\n"
+        "#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L\n"
+        "    #include <stdbool.h>\n"
+        "#endif\n"
+        "\n"
+        "#include \"jsl/core.h\"\n"
+        "#include \"jsl/allocator.h\"\n"
+        "\n"
+        "#ifdef __cplusplus\n"
+        "extern \"C\" {\n"
+        "#endif\n"
+        "\n"
+        "/**\n"
+        " * Dynamic structure of arrays of {{ value_type_name }}.\n"
+        " *\n"
+        " * Each field of {{ value_type_name }} is stored in its own column, so a loop\n"
+        " * which only reads one or two fields walks densely packed memory instead of\n"
+        " * striding over the fields it doesn't touch. All of the columns share the\n"
+        " * same length and capacity, and they live in a single allocation which is\n"
+        " * grown as one. Every column starts on a 64 byte boundary.\n"
+        " *\n"
+        " * Example:\n"
+        " *\n"
+        " * ```\n"
+        " * {{ array_type_name }} array;\n"
+        " * {{ function_prefix }}_init(&array, allocator, 0);\n"
+        " *\n"
+        " * {{ function_prefix }}_insert(&array, ... );\n"
+        " *\n"
+        " * for (int64_t i = 0; i < array.length; ++i)\n"
+        " * {\n"
+        " *      array.{{ first_field_name }}[i] ...\n"
+        " * }\n"
+        " * ```\n"
+        " *\n"
+        " * ## Functions\n"
+        " *\n"
+        " *  * {{ function_prefix }}_init\n"
+        " *  * {{ function_prefix }}_insert\n"
+        " *  * {{ function_prefix }}_insert_multiple\n"
+        " *  * {{ function_prefix }}_get\n"
+        " *  * {{ function_prefix }}_set\n"
+        " *  * {{ function_prefix }}_delete_at\n"
+        " *  * {{ function_prefix }}_clear\n"
+        " *  * {{ function_prefix }}_free\n"
+        "{{ column_span_list }} *\n"
+        " */\n"
+        "typedef struct {{ array_type_name }} {\n"
+        "    // putting the sentinel first means it's much more likely to get\n"
+        "    // corrupted from accidental overwrites, therefore making it\n"
+        "    // more likely that memory bugs are caught.\n"
+        "    uint64_t sentinel;\n"
+        "    JSLAllocatorInterface allocator;\n"
+        "    // Start of the allocation all of the columns live in\n"
+        "    uint8_t* block;\n"
+        "{{ column_members }}    int64_t length;\n"
+        "    int64_t capacity;\n"
+        "} {{ array_type_name }};\n"
+        "\n"
+        "/**\n"
+        " * Initialize an instance of {{ array_type_name }}. Enough room will be allocated\n"
+        " * for `initial_capacity` elements in every column.\n"
+        " *\n"
+        " * @param array The pointer to the array instance to initialize\n"
+        " * @param allocator The allocator that this array will use to allocate memory\n"
+        " * @param initial_capacity Allocate enough space to hold this many elements\n"
+        " * @returns If the allocation succeed\n"
+        " */\n"
+        "bool {{ function_prefix }}_init(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    JSLAllocatorInterface allocator,\n"
+        "    int64_t initial_capacity\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Split `value` into its fields and append each one to the end of its column.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " * @param value The value to add\n"
+        " * @returns If the insertion succeed\n"
+        " */\n"
+        "bool {{ function_prefix }}_insert(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    {{ value_type_name }} value\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Append multiple `{{ value_type_name }}` at once, growing at most one time.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " * @param values The pointer to the start of the values\n"
+        " * @param value_count The number of values\n"
+        " * @returns If the insertion succeed\n"
+        " */\n"
+        "bool {{ function_prefix }}_insert_multiple(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    const {{ value_type_name }}* values,\n"
+        "    int64_t value_count\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Gather the fields at `index` back into a `{{ value_type_name }}`. Fields\n"
+        " * of the struct which don't have a column are left untouched in `out_value`.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " * @param index The index to read\n"
+        " * @param out_value Where the value is written\n"
+        " * @returns false if the index is out of bounds\n"
+        " */\n"
+        "bool {{ function_prefix }}_get(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t index,\n"
+        "    {{ value_type_name }}* out_value\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Overwrite every column at `index` with the fields of `value`.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " * @param index The index to write\n"
+        " * @param value The new value\n"
+        " * @returns false if the index is out of bounds\n"
+        " */\n"
+        "bool {{ function_prefix }}_set(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t index,\n"
+        "    {{ value_type_name }} value\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Delete the element at the specified index from every column, moving\n"
+        " * everything after that index to its index minus one.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " * @param index The index to delete\n"
+        " * @returns if deletion succeed\n"
+        " */\n"
+        "bool {{ function_prefix }}_delete_at(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t index\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Set the length of the array back to zero. Does not shrink the underlying capacity.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " */\n"
+        "void {{ function_prefix }}_clear(\n"
+        "    {{ array_type_name }}* array\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Free the underlying memory of the array. This sets the array into an invalid state.\n"
+        " * You will have to call init again if you wish to use this array instance.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " */\n"
+        "void {{ function_prefix }}_free(\n"
+        "    {{ array_type_name }}* array\n"
+        ");\n"
+        "{{ column_span_declarations }}\n"
+        "#ifdef __cplusplus\n"
+        "}\n"
+        "#endif\n"
+    );
+
+    static JSLImmutableMemory soa_source_template = JSL_CSTR_INITIALIZER(
+        "/**\n"
+        " * AUTO GENERATED FILE\n"
+        " *\n"
+        " * This file contains the source for a structure of arrays `{{ array_type_name }}`\n"
+        " * which stores `{{ value_type_name }}` values as one column per field.\n"
+        " *\n"
+        " * This file was auto generated from the array code generation utility that's part of\n"
+        " * the \"Jack's Standard Library\" project. The utility generates a header file and a\n"
+        " * C file for a type safe structure of arrays. By generating the code rather than using macros,\n"
+        " * two benefits are gained. One, the code is much easier to debug. Two, it's much more\n"
+        " * obvious how much code you're generating, which means you are much less likely to accidentally\n"
+        " * create the combinatoric explosion of code that's so common in C++ projects. Adding friction\n"
+        " * to things is actually good sometimes.\n"
+        " */\n"
+        "\n"
+        "\n"
+        "#include <stdint.h>\n"
+        "#include <stddef.h>\n"
+        "#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L\n"
+        "    #include <stdbool.h>\n"
+        "#endif\n"
+        "#include <string.h>\n"
+        "\n"
+        "#include \"jsl/core.h\"\n"
+        "#include \"jsl/allocator.h\"\n"
+        "\n"
+        "// Every column starts on a cache line so the start of a column scan never\n"
+        "// shares a line with the end of the previous column\n"
+        "#define {{ function_prefix }}__COLUMN_ALIGNMENT 64\n"
+        "\n"
+        "static inline int64_t {{ function_prefix }}__column_bytes(\n"
+        "    int64_t bytes\n"
+        ")\n"
+        "{\n"
+        "    return (bytes + {{ function_prefix }}__COLUMN_ALIGNMENT - 1)\n"
+        "        & ~((int64_t) {{ function_prefix }}__COLUMN_ALIGNMENT - 1);\n"
+        "}\n"
+        "\n"
+        "static int64_t {{ function_prefix }}__block_bytes(\n"
+        "    int64_t capacity\n"
+        ")\n"
+        "{\n"
+        "    int64_t bytes = 0;\n"
+        "{{ column_block_bytes }}    return bytes;\n"
+        "}\n"
+        "\n"
+        "static bool {{ function_prefix }}__ensure_capacity(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t needed_capacity\n"
+        ")\n"
+        "{\n"
+        "    if (JSL__LIKELY(needed_capacity <= array->capacity))\n"
+        "        return true;\n"
+        "\n"
+        "    // Keeps the power of two rounding and the byte counts in range\n"
+        "    if (needed_capacity > INT64_MAX / 1024)\n"
+        "        return false;\n"
+        "\n"
+        "    int64_t target_capacity = jsl_next_power_of_two_i64(JSL_MAX(needed_capacity, (int64_t) 2));\n"
+        "\n"
+        "    uint8_t* block = (uint8_t*) jsl_allocator_interface_alloc(\n"
+        "        array->allocator,\n"
+        "        {{ function_prefix }}__block_bytes(target_capacity),\n"
+        "        {{ function_prefix }}__COLUMN_ALIGNMENT,\n"
+        "        false\n"
+        "    );\n"
+        "    if (block == NULL)\n"
+        "        return false;\n"
+        "\n"
+        "    // All of the columns move together, so a failed allocation leaves the\n"
+        "    // old block untouched and there's never a partially grown array\n"
+        "    uint8_t* cursor = block;\n"
+        "{{ column_relocate }}\n"
+        "    if (array->block != NULL)\n"
+        "        jsl_allocator_interface_free(array->allocator, array->block);\n"
+        "\n"
+        "    array->block = block;\n"
+        "    array->capacity = target_capacity;\n"
+        "    return true;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_init(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    JSLAllocatorInterface allocator,\n"
+        "    int64_t initial_capacity\n"
+        ")\n"
+        "{\n"
+        "    bool res = array != NULL && initial_capacity > -1;\n"
+        "\n"
+        "    if (res)\n"
+        "    {\n"
+        "        JSL_MEMSET(array, 0, sizeof({{ array_type_name }}));\n"
+        "        array->allocator = allocator;\n"
+        "        array->sentinel = PRIVATE_SENTINEL_{{ array_type_name }};\n"
+        "\n"
+        "        res = {{ function_prefix }}__ensure_capacity(array, JSL_MAX((int64_t) 32, initial_capacity));\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_insert(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    {{ value_type_name }} value\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "        res = {{ function_prefix }}__ensure_capacity(array, array->length + 1);\n"
+        "\n"
+        "    if (res)\n"
+        "    {\n"
+        "        int64_t index = array->length;\n"
+        "{{ column_store }}        ++array->length;\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_insert_multiple(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    const {{ value_type_name }}* values,\n"
+        "    int64_t value_count\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && value_count > -1\n"
+        "        && (values != NULL || value_count == 0)\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "        res = {{ function_prefix }}__ensure_capacity(array, array->length + value_count);\n"
+        "\n"
+        "    // One column at a time, so each pass only writes to one stream\n"
+        "    if (res)\n"
+        "    {\n"
+        "{{ column_store_multiple }}        array->length += value_count;\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_get(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t index,\n"
+        "    {{ value_type_name }}* out_value\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && out_value != NULL\n"
+        "        && index > -1\n"
+        "        && index < array->length\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "    {\n"
+        "{{ column_load }}    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_set(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t index,\n"
+        "    {{ value_type_name }} value\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && index > -1\n"
+        "        && index < array->length\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "    {\n"
+        "{{ column_store }}    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_delete_at(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t index\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && index > -1\n"
+        "        && index < array->length\n"
+        "    );\n"
+        "\n"
+        "    int64_t items_to_move = res ? array->length - index - 1 : -1;\n"
+        "\n"
+        "    if (items_to_move > 0)\n"
+        "    {\n"
+        "{{ column_move }}    }\n"
+        "\n"
+        "    if (res)\n"
+        "        --array->length;\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "void {{ function_prefix }}_clear(\n"
+        "    {{ array_type_name }}* array\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "    )\n"
+        "    {\n"
+        "        array->length = 0;\n"
+        "    }\n"
+        "}\n"
+        "\n"
+        "void {{ function_prefix }}_free(\n"
+        "    {{ array_type_name }}* array\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "    )\n"
+        "    {\n"
+        "        jsl_allocator_interface_free(\n"
+        "            array->allocator,\n"
+        "            array->block\n"
+        "        );\n"
+        "        array->block = NULL;\n"
+        "        array->length = 0;\n"
+        "        array->capacity = 0;\n"
+        "        array->sentinel = 0;\n"
+        "    }\n"
+        "}\n"
+        "{{ column_span_definitions }}"
+    );
+
+    static JSLImmutableMemory segmented_header_template = JSL_CSTR_INITIALIZER(
+        "/**\n"
+        " * AUTO GENERATED FILE\n"
+        " *\n"
+        " * This file contains the header for a segmented array `{{ array_type_name }}` of\n"
+        " * `{{ value_type_name }}` values.\n"
+        " *\n"
+        " * This file was auto generated from the array code generation utility that's part of\n"
+        " * the \"Jack's Standard Library\" project. The utility generates a header file and a\n"
+        " * C file for a type safe segmented, stable address array. By generating the code rather than using macros,\n"
+        " * two benefits are gained. One, the code is much easier to debug. Two, it's much more\n"
+        " * obvious how much code you're generating, which means you are much less likely to accidentally\n"
+        " * create the combinatoric explosion of code that's so common in C++ projects. Adding friction\n"
+        " * to things is actually good sometimes.\n"
+        " */\n"
+        "\n"
+        "\n"
+        "#pragma once\n"
+        "\n"
+        "#include <stdint.h>\n"
+        "#include <stddef.h>\n"
+        "#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L\n"
+        "    #include <stdbool.h>\n"
+        "#endif\n"
+        "\n"
+        "#include \"jsl/core.h\"\n"
+        "#include \"jsl/allocator.h\"\n"
+        "\n"
+        "#ifdef __cplusplus\n"
+        "extern \"C\" {\n"
+        "#endif\n"
+        "\n"
+        "// Every block holds exactly this many elements\n"
+        "#define {{ function_prefix }}_BLOCK_SHIFT {{ block_shift }}\n"
+        "#define {{ function_prefix }}_BLOCK_LENGTH ((int64_t) 1 << {{ function_prefix }}_BLOCK_SHIFT)\n"
+        "\n"
+        "/**\n"
+        " * Segmented array of {{ value_type_name }}.\n"
+        " *\n"
+        " * Elements live in separately allocated blocks of {{ block_length }} elements,\n"
+        " * and a small directory holds the pointer to each block. Growing the array\n"
+        " * allocates one new block at a time and never moves existing elements, so\n"
+        " * pointers to elements stay valid until the element is removed or the array\n"
+        " * is freed. Only the directory of block pointers is ever reallocated.\n"
+        " *\n"
+        " * Indexing is a shift and a mask, but there's no single `data` pointer. To\n"
+        " * loop over every element, either use `{{ function_prefix }}_get` or walk the\n"
+        " * blocks directly:\n"
+        " *\n"
+        " * ```\n"
+        " * {{ array_type_name }} array;\n"
+        " * {{ function_prefix }}_init(&array, allocator, 0);\n"
+        " *\n"
+        " * {{ value_type_name }}* stable = {{ function_prefix }}_insert(&array, ... );\n"
+        " *\n"
+        " * for (int64_t block = 0; block * {{ function_prefix }}_BLOCK_LENGTH < array.length; ++block)\n"
+        " * {\n"
+        " *      int64_t block_length = 0;\n"
+        " *      {{ value_type_name }}* values = {{ function_prefix }}_block(&array, block, &block_length);\n"
+        " *      for (int64_t i = 0; i < block_length; ++i)\n"
+        " *      {\n"
+        " *          ...\n"
+        " *      }\n"
+        " * }\n"
+        " * ```\n"
+        " *\n"
+        " * ## Functions\n"
+        " *\n"
+        " *  * {{ function_prefix }}_init\n"
+        " *  * {{ function_prefix }}_reserve\n"
+        " *  * {{ function_prefix }}_insert\n"
+        " *  * {{ function_prefix }}_insert_multiple\n"
+        " *  * {{ function_prefix }}_get\n"
+        " *  * {{ function_prefix }}_block\n"
+        " *  * {{ function_prefix }}_delete_last\n"
+        " *  * {{ function_prefix }}_clear\n"
+        " *  * {{ function_prefix }}_free\n"
+        " *\n"
+        " */\n"
+        "typedef struct {{ array_type_name }} {\n"
+        "    // putting the sentinel first means it's much more likely to get\n"
+        "    // corrupted from accidental overwrites, therefore making it\n"
+        "    // more likely that memory bugs are caught.\n"
+        "    uint64_t sentinel;\n"
+        "    JSLAllocatorInterface allocator;\n"
+        "    // Directory of block pointers, the first `block_count` are allocated\n"
+        "    {{ value_type_name }}** blocks;\n"
+        "    int64_t block_count;\n"
+        "    int64_t directory_capacity;\n"
+        "    int64_t length;\n"
+        "    int64_t capacity;\n"
+        "} {{ array_type_name }};\n"
+        "\n"
+        "/**\n"
+        " * Initialize an instance of {{ array_type_name }}. Enough blocks will be allocated\n"
+        " * for `initial_capacity` elements.\n"
+        " *\n"
+        " * @param array The pointer to the array instance to initialize\n"
+        " * @param allocator The allocator that this array will use to allocate memory\n"
+        " * @param initial_capacity Allocate enough space to hold this many elements\n"
+        " * @returns If the allocation succeed\n"
+        " */\n"
+        "bool {{ function_prefix }}_init(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    JSLAllocatorInterface allocator,\n"
+        "    int64_t initial_capacity\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Allocate blocks up front until there's room for `capacity` elements.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " * @param capacity The number of elements to make room for\n"
+        " * @returns If the allocations succeed\n"
+        " */\n"
+        "bool {{ function_prefix }}_reserve(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t capacity\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Insert an `{{ value_type_name }}` at the end of the array.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " * @param value The value to add\n"
+        " * @returns If the insertion succeed then the pointer to the item in the array,\n"
+        " * which stays valid as the array grows, NULL otherwise\n"
+        " */\n"
+        "{{ value_type_name }}* {{ function_prefix }}_insert(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    {{ value_type_name }} value\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Insert multiple `{{ value_type_name }}` at once at the end of the array.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " * @param values The pointer to the start of the values\n"
+        " * @param value_count The number of values\n"
+        " * @returns If the insertion succeed\n"
+        " */\n"
+        "bool {{ function_prefix }}_insert_multiple(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    const {{ value_type_name }}* values,\n"
+        "    int64_t value_count\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Get the pointer to the element at `index`.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " * @param index The index of the element\n"
+        " * @returns The pointer to the element, or NULL if the index is out of bounds\n"
+        " */\n"
+        "{{ value_type_name }}* {{ function_prefix }}_get(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t index\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Get one block of contiguous elements for fast iteration.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " * @param block_index Which block, block `b` holds the indices starting at\n"
+        " * `b * {{ function_prefix }}_BLOCK_LENGTH`\n"
+        " * @param out_length Set to the number of elements in use in the block\n"
+        " * @returns The start of the block, or NULL if the block holds no elements\n"
+        " */\n"
+        "{{ value_type_name }}* {{ function_prefix }}_block(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t block_index,\n"
+        "    int64_t* out_length\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Remove the last element of the array. The block it lived in is kept for\n"
+        " * reuse.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " * @param out_value If not NULL, the removed value is written here\n"
+        " * @returns false if the array is empty\n"
+        " */\n"
+        "bool {{ function_prefix }}_delete_last(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    {{ value_type_name }}* out_value\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Set the length of the array back to zero. Does not free any blocks.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " */\n"
+        "void {{ function_prefix }}_clear(\n"
+        "    {{ array_type_name }}* array\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Free every block and the directory. This sets the array into an invalid state.\n"
+        " * You will have to call init again if you wish to use this array instance.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " */\n"
+        "void {{ function_prefix }}_free(\n"
+        "    {{ array_type_name }}* array\n"
+        ");\n"
+        "\n"
+        "#ifdef __cplusplus\n"
+        "}\n"
+        "#endif\n"
+    );
+
+    static JSLImmutableMemory segmented_source_template = JSL_CSTR_INITIALIZER(
+        "/**\n"
+        " * AUTO GENERATED FILE\n"
+        " *\n"
+        " * This file contains the source for a segmented array `{{ array_type_name }}` of\n"
+        " * `{{ value_type_name }}` values.\n"
+        " *\n"
+        " * This file was auto generated from the array code generation utility that's part of\n"
+        " * the \"Jack's Standard Library\" project. The utility generates a header file and a\n"
+        " * C file for a type safe segmented, stable address array. By generating the code rather than using macros,\n"
+        " * two benefits are gained. One, the code is much easier to debug. Two, it's much more\n"
+        " * obvious how much code you're generating, which means you are much less likely to accidentally\n"
+        " * create the combinatoric explosion of code that's so common in C++ projects. Adding friction\n"
+        " * to things is actually good sometimes.\n"
+        " */\n"
+        "\n"
+        "\n"
+        "#include <stdint.h>\n"
+        "#include <stddef.h>\n"
+        "#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L\n"
+        "    #include <stdbool.h>\n"
+        "#endif\n"
+        "#include <string.h>\n"
+        "\n"
+        "#include \"jsl/core.h\"\n"
+        "#include \"jsl/allocator.h\"\n"
+        "\n"
+        "#define {{ function_prefix }}__BLOCK_MASK ({{ function_prefix }}_BLOCK_LENGTH - 1)\n"
+        "\n"
+        "static bool {{ function_prefix }}__ensure_capacity(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t needed_capacity\n"
+        ")\n"
+        "{\n"
+        "    if (JSL__LIKELY(needed_capacity <= array->capacity))\n"
+        "        return true;\n"
+        "\n"
+        "    // Keeps the block and directory byte counts in range\n"
+        "    if (needed_capacity > INT64_MAX / 2 - {{ function_prefix }}_BLOCK_LENGTH)\n"
+        "        return false;\n"
+        "\n"
+        "    int64_t needed_blocks = (needed_capacity + {{ function_prefix }}__BLOCK_MASK)\n"
+        "        >> {{ function_prefix }}_BLOCK_SHIFT;\n"
+        "\n"
+        "    // The directory is only pointers, so copying it on growth is cheap\n"
+        "    // compared to copying the elements\n"
+        "    if (needed_blocks > array->directory_capacity)\n"
+        "    {\n"
+        "        int64_t target_directory = jsl_next_power_of_two_i64(JSL_MAX(needed_blocks, (int64_t) 8));\n"
+        "        {{ value_type_name }}** directory = ({{ value_type_name }}**) jsl_allocator_interface_alloc(\n"
+        "            array->allocator,\n"
+        "            ((int64_t) sizeof({{ value_type_name }}*)) * target_directory,\n"
+        "            _Alignof({{ value_type_name }}*),\n"
+        "            false\n"
+        "        );\n"
+        "        if (directory == NULL)\n"
+        "            return false;\n"
+        "\n"
+        "        if (array->blocks != NULL)\n"
+        "        {\n"
+        "            JSL_MEMCPY(\n"
+        "                directory,\n"
+        "                array->blocks,\n"
+        "                sizeof({{ value_type_name }}*) * (size_t) array->block_count\n"
+        "            );\n"
+        "            jsl_allocator_interface_free(array->allocator, array->blocks);\n"
+        "        }\n"
+        "\n"
+        "        array->blocks = directory;\n"
+        "        array->directory_capacity = target_directory;\n"
+        "    }\n"
+        "\n"
+        "    while (array->block_count < needed_blocks)\n"
+        "    {\n"
+        "        {{ value_type_name }}* block = ({{ value_type_name }}*) jsl_allocator_interface_alloc(\n"
+        "            array->allocator,\n"
+        "            ((int64_t) sizeof({{ value_type_name }})) * {{ function_prefix }}_BLOCK_LENGTH,\n"
+        "            _Alignof({{ value_type_name }}),\n"
+        "            false\n"
+        "        );\n"
+        "        if (block == NULL)\n"
+        "            return false;\n"
+        "\n"
+        "        array->blocks[array->block_count] = block;\n"
+        "        ++array->block_count;\n"
+        "        array->capacity += {{ function_prefix }}_BLOCK_LENGTH;\n"
+        "    }\n"
+        "\n"
+        "    return true;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_init(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    JSLAllocatorInterface allocator,\n"
+        "    int64_t initial_capacity\n"
+        ")\n"
+        "{\n"
+        "    bool res = array != NULL && initial_capacity > -1;\n"
+        "\n"
+        "    if (res)\n"
+        "    {\n"
+        "        JSL_MEMSET(array, 0, sizeof({{ array_type_name }}));\n"
+        "        array->allocator = allocator;\n"
+        "        array->sentinel = PRIVATE_SENTINEL_{{ array_type_name }};\n"
+        "\n"
+        "        res = {{ function_prefix }}__ensure_capacity(array, JSL_MAX((int64_t) 1, initial_capacity));\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_reserve(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t capacity\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && capacity > -1\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "        res = {{ function_prefix }}__ensure_capacity(array, capacity);\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "{{ value_type_name }}* {{ function_prefix }}_insert(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    {{ value_type_name }} value\n"
+        ")\n"
+        "{\n"
+        "    {{ value_type_name }}* res = NULL;\n"
+        "\n"
+        "    bool has_capacity = false;\n"
+        "    if (array != NULL && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }})\n"
+        "    {\n"
+        "        has_capacity = {{ function_prefix }}__ensure_capacity(array, array->length + 1);\n"
+        "    }\n"
+        "\n"
+        "    if (has_capacity)\n"
+        "    {\n"
+        "        int64_t index = array->length;\n"
+        "        res = &array->blocks[index >> {{ function_prefix }}_BLOCK_SHIFT][index & {{ function_prefix }}__BLOCK_MASK];\n"
+        "        *res = value;\n"
+        "        ++array->length;\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_insert_multiple(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    const {{ value_type_name }}* values,\n"
+        "    int64_t value_count\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && value_count > -1\n"
+        "        && (values != NULL || value_count == 0)\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "        res = {{ function_prefix }}__ensure_capacity(array, array->length + value_count);\n"
+        "\n"
+        "    // Copy one block sized run at a time\n"
+        "    int64_t copied = 0;\n"
+        "    while (res && copied < value_count)\n"
+        "    {\n"
+        "        int64_t index = array->length;\n"
+        "        int64_t offset = index & {{ function_prefix }}__BLOCK_MASK;\n"
+        "        int64_t run = JSL_MIN(value_count - copied, {{ function_prefix }}_BLOCK_LENGTH - offset);\n"
+        "\n"
+        "        JSL_MEMCPY(\n"
+        "            &array->blocks[index >> {{ function_prefix }}_BLOCK_SHIFT][offset],\n"
+        "            values + copied,\n"
+        "            sizeof({{ value_type_name }}) * (size_t) run\n"
+        "        );\n"
+        "\n"
+        "        copied += run;\n"
+        "        array->length += run;\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "{{ value_type_name }}* {{ function_prefix }}_get(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t index\n"
+        ")\n"
+        "{\n"
+        "    {{ value_type_name }}* res = NULL;\n"
+        "\n"
+        "    if (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && index > -1\n"
+        "        && index < array->length\n"
+        "    )\n"
+        "    {\n"
+        "        res = &array->blocks[index >> {{ function_prefix }}_BLOCK_SHIFT][index & {{ function_prefix }}__BLOCK_MASK];\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "{{ value_type_name }}* {{ function_prefix }}_block(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t block_index,\n"
+        "    int64_t* out_length\n"
+        ")\n"
+        "{\n"
+        "    {{ value_type_name }}* res = NULL;\n"
+        "    int64_t length = 0;\n"
+        "\n"
+        "    if (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && block_index > -1\n"
+        "        && block_index < array->block_count\n"
+        "    )\n"
+        "    {\n"
+        "        int64_t start = block_index << {{ function_prefix }}_BLOCK_SHIFT;\n"
+        "        length = JSL_MIN(array->length - start, {{ function_prefix }}_BLOCK_LENGTH);\n"
+        "        length = JSL_MAX(length, (int64_t) 0);\n"
+        "        res = length > 0 ? array->blocks[block_index] : NULL;\n"
+        "    }\n"
+        "\n"
+        "    if (out_length != NULL)\n"
+        "        *out_length = length;\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_delete_last(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    {{ value_type_name }}* out_value\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && array->length > 0\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "    {\n"
+        "        --array->length;\n"
+        "        int64_t index = array->length;\n"
+        "        if (out_value != NULL)\n"
+        "            *out_value = array->blocks[index >> {{ function_prefix }}_BLOCK_SHIFT][index & {{ function_prefix }}__BLOCK_MASK];\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "void {{ function_prefix }}_clear(\n"
+        "    {{ array_type_name }}* array\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "    )\n"
+        "    {\n"
+        "        array->length = 0;\n"
+        "    }\n"
+        "}\n"
+        "\n"
+        "void {{ function_prefix }}_free(\n"
+        "    {{ array_type_name }}* array\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "    )\n"
+        "    {\n"
+        "        for (int64_t i = 0; i < array->block_count; ++i)\n"
+        "        {\n"
+        "            jsl_allocator_interface_free(array->allocator, array->blocks[i]);\n"
+        "        }\n"
+        "        if (array->blocks != NULL)\n"
+        "            jsl_allocator_interface_free(array->allocator, array->blocks);\n"
+        "\n"
+        "        array->blocks = NULL;\n"
+        "        array->block_count = 0;\n"
+        "        array->directory_capacity = 0;\n"
+        "        array->length = 0;\n"
+        "        array->capacity = 0;\n"
+        "        array->sentinel = 0;\n"
+        "    }\n"
+        "}\n"
+    );
+
+    static JSLImmutableMemory ring_header_template = JSL_CSTR_INITIALIZER(
+        "/**\n"
+        " * AUTO GENERATED FILE\n"
+        " *\n"
+        " * This file contains the header for a ring buffer `{{ array_type_name }}` of\n"
+        " * `{{ value_type_name }}` values.\n"
+        " *\n"
+        " * This file was auto generated from the array code generation utility that's part of\n"
+        " * the \"Jack's Standard Library\" project. The utility generates a header file and a\n"
+        " * C file for a type safe ring buffer. By generating the code rather than using macros,\n"
+        " * two benefits are gained. One, the code is much easier to debug. Two, it's much more\n"
+        " * obvious how much code you're generating, which means you are much less likely to accidentally\n"
+        " * create the combinatoric explosion of code that's so common in C++ projects. Adding friction\n"
+        " * to things is actually good sometimes.\n"
+        " */\n"
+        "\n"
+        "\n"
+        "#pragma once\n"
+        "\n"
+        "#include <stdint.h>\n"
+        "#include <stddef.h>\n"
+        "#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L\n"
+        "    #include <stdbool.h>\n"
+        "#endif\n"
+        "\n"
+        "#include \"jsl/core.h\"\n"
+        "#include \"jsl/allocator.h\"\n"
+        "\n"
+        "#ifdef __cplusplus\n"
+        "extern \"C\" {\n"
+        "#endif\n"
+        "\n"
+        "// 1 if the ring reallocates when it's full, 0 if pushes fail instead\n"
+        "#define {{ function_prefix }}_CAN_GROW {{ can_grow }}\n"
+        "\n"
+        "/**\n"
+        " * Ring buffer of {{ value_type_name }} which can be used as a FIFO queue or a\n"
+        " * double ended queue.\n"
+        " *\n"
+        " * The capacity is always a power of two, so wrapping an index around the end\n"
+        " * of the buffer is a mask rather than a division. Pushing and popping at\n"
+        " * either end is O(1), unlike deleting index zero of a dynamic array which\n"
+        " * moves every other element.\n"
+        " *\n"
+        " * The elements of the ring are at most two contiguous spans of the buffer, so\n"
+        " * the bulk functions `{{ function_prefix }}_push_many` and `{{ function_prefix }}_pop_many`\n"
+        " * are at most two memcpy calls.\n"
+        " *\n"
+        " * {{ growth_description }}\n"
+        " *\n"
+        " * ```\n"
+        " * {{ array_type_name }} ring;\n"
+        " * {{ function_prefix }}_init(&ring, allocator, 256);\n"
+        " *\n"
+        " * {{ function_prefix }}_push_back(&ring, ... );\n"
+        " *\n"
+        " * {{ value_type_name }} value;\n"
+        " * while ({{ function_prefix }}_pop_front(&ring, &value))\n"
+        " * {\n"
+        " *      ...\n"
+        " * }\n"
+        " * ```\n"
+        " *\n"
+        " * ## Functions\n"
+        " *\n"
+        " *  * {{ function_prefix }}_init\n"
+        " *  * {{ function_prefix }}_push_back\n"
+        " *  * {{ function_prefix }}_push_front\n"
+        " *  * {{ function_prefix }}_pop_front\n"
+        " *  * {{ function_prefix }}_pop_back\n"
+        " *  * {{ function_prefix }}_push_many\n"
+        " *  * {{ function_prefix }}_pop_many\n"
+        " *  * {{ function_prefix }}_get\n"
+        " *  * {{ function_prefix }}_spans\n"
+        " *  * {{ function_prefix }}_clear\n"
+        " *  * {{ function_prefix }}_free\n"
+        " *\n"
+        " */\n"
+        "typedef struct {{ array_type_name }} {\n"
+        "    // putting the sentinel first means it's much more likely to get\n"
+        "    // corrupted from accidental overwrites, therefore making it\n"
+        "    // more likely that memory bugs are caught.\n"
+        "    uint64_t sentinel;\n"
+        "    JSLAllocatorInterface allocator;\n"
+        "    {{ value_type_name }}* data;\n"
+        "    // Buffer index of the front element\n"
+        "    int64_t head;\n"
+        "    int64_t length;\n"
+        "    int64_t capacity;\n"
+        "} {{ array_type_name }};\n"
+        "\n"
+        "/**\n"
+        " * Initialize an instance of {{ array_type_name }}. The capacity is rounded up\n"
+        " * to the next power of two.\n"
+        " *\n"
+        " * @param ring The pointer to the ring instance to initialize\n"
+        " * @param allocator The allocator that this ring will use to allocate memory\n"
+        " * @param capacity Allocate enough space to hold this many elements\n"
+        " * @returns If the allocation succeed\n"
+        " */\n"
+        "bool {{ function_prefix }}_init(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    JSLAllocatorInterface allocator,\n"
+        "    int64_t capacity\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Add an element after the back of the ring.\n"
+        " *\n"
+        " * @param ring The pointer to the ring\n"
+        " * @param value The value to add\n"
+        " * @returns false if the ring is full and can't grow\n"
+        " */\n"
+        "bool {{ function_prefix }}_push_back(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    {{ value_type_name }} value\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Add an element before the front of the ring.\n"
+        " *\n"
+        " * @param ring The pointer to the ring\n"
+        " * @param value The value to add\n"
+        " * @returns false if the ring is full and can't grow\n"
+        " */\n"
+        "bool {{ function_prefix }}_push_front(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    {{ value_type_name }} value\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Remove the element at the front of the ring.\n"
+        " *\n"
+        " * @param ring The pointer to the ring\n"
+        " * @param out_value If not NULL, the removed value is written here\n"
+        " * @returns false if the ring is empty\n"
+        " */\n"
+        "bool {{ function_prefix }}_pop_front(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    {{ value_type_name }}* out_value\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Remove the element at the back of the ring.\n"
+        " *\n"
+        " * @param ring The pointer to the ring\n"
+        " * @param out_value If not NULL, the removed value is written here\n"
+        " * @returns false if the ring is empty\n"
+        " */\n"
+        "bool {{ function_prefix }}_pop_back(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    {{ value_type_name }}* out_value\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Add multiple elements after the back of the ring, in order. Either all of\n"
+        " * the values are added or none are.\n"
+        " *\n"
+        " * @param ring The pointer to the ring\n"
+        " * @param values The pointer to the start of the values\n"
+        " * @param value_count The number of values\n"
+        " * @returns false on invalid parameters or if the values don't fit and the ring can't grow\n"
+        " */\n"
+        "bool {{ function_prefix }}_push_many(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    const {{ value_type_name }}* values,\n"
+        "    int64_t value_count\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Remove up to `max_count` elements from the front of the ring, in order.\n"
+        " *\n"
+        " * @param ring The pointer to the ring\n"
+        " * @param out_values Where the removed values are written, or NULL to discard them\n"
+        " * @param max_count The most elements to remove\n"
+        " * @returns The number of elements removed, or -1 on invalid parameters\n"
+        " */\n"
+        "int64_t {{ function_prefix }}_pop_many(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    {{ value_type_name }}* out_values,\n"
+        "    int64_t max_count\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Get the pointer to the element `index` places from the front. The pointer\n"
+        " * is invalidated by any push or pop.\n"
+        " *\n"
+        " * @param ring The pointer to the ring\n"
+        " * @param index The position counted from the front\n"
+        " * @returns The pointer to the element, or NULL if the index is out of bounds\n"
+        " */\n"
+        "{{ value_type_name }}* {{ function_prefix }}_get(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    int64_t index\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Get the elements of the ring, front to back, as two contiguous spans for\n"
+        " * reading or writing them in place. The second span is empty unless the\n"
+        " * elements wrap around the end of the buffer.\n"
+        " *\n"
+        " * @param ring The pointer to the ring\n"
+        " * @param out_first Set to the start of the first span\n"
+        " * @param out_first_length Set to the length of the first span\n"
+        " * @param out_second Set to the start of the second span\n"
+        " * @param out_second_length Set to the length of the second span\n"
+        " * @returns false on invalid parameters\n"
+        " */\n"
+        "bool {{ function_prefix }}_spans(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    {{ value_type_name }}** out_first,\n"
+        "    int64_t* out_first_length,\n"
+        "    {{ value_type_name }}** out_second,\n"
+        "    int64_t* out_second_length\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Remove every element. Does not free any memory.\n"
+        " *\n"
+        " * @param ring The pointer to the ring\n"
+        " */\n"
+        "void {{ function_prefix }}_clear(\n"
+        "    {{ array_type_name }}* ring\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Free the underlying memory. This sets the ring into an invalid state.\n"
+        " * You will have to call init again if you wish to use this ring instance.\n"
+        " *\n"
+        " * @param ring The pointer to the ring\n"
+        " */\n"
+        "void {{ function_prefix }}_free(\n"
+        "    {{ array_type_name }}* ring\n"
+        ");\n"
+        "\n"
+        "#ifdef __cplusplus\n"
+        "}\n"
+        "#endif\n"
+    );
+
+    static JSLImmutableMemory ring_source_template = JSL_CSTR_INITIALIZER(
+        "/**\n"
+        " * AUTO GENERATED FILE\n"
+        " *\n"
+        " * This file contains the source for a ring buffer `{{ array_type_name }}` of\n"
+        " * `{{ value_type_name }}` values.\n"
+        " *\n"
+        " * This file was auto generated from the array code generation utility that's part of\n"
+        " * the \"Jack's Standard Library\" project. The utility generates a header file and a\n"
+        " * C file for a type safe ring buffer. By generating the code rather than using macros,\n"
+        " * two benefits are gained. One, the code is much easier to debug. Two, it's much more\n"
+        " * obvious how much code you're generating, which means you are much less likely to accidentally\n"
+        " * create the combinatoric explosion of code that's so common in C++ projects. Adding friction\n"
+        " * to things is actually good sometimes.\n"
+        " */\n"
+        "\n"
+        "\n"
+        "#include <stdint.h>\n"
+        "#include <stddef.h>\n"
+        "#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L\n"
+        "    #include <stdbool.h>\n"
+        "#endif\n"
+        "#include <string.h>\n"
+        "\n"
+        "#include \"jsl/core.h\"\n"
+        "#include \"jsl/allocator.h\"\n"
+        "\n"
+        "static bool {{ function_prefix }}__ensure_capacity(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    int64_t needed_capacity\n"
+        ")\n"
+        "{\n"
+        "    if (JSL__LIKELY(needed_capacity <= ring->capacity))\n"
+        "        return true;\n"
+        "\n"
+        "    if (!{{ function_prefix }}_CAN_GROW)\n"
+        "        return false;\n"
+        "\n"
+        "    // Keeps the power of two rounding and the byte count in range\n"
+        "    if (needed_capacity > (INT64_MAX / 2) / (int64_t) sizeof({{ value_type_name }}))\n"
+        "        return false;\n"
+        "\n"
+        "    int64_t target_capacity = jsl_next_power_of_two_i64(JSL_MAX(needed_capacity, (int64_t) 2));\n"
+        "\n"
+        "    {{ value_type_name }}* data = ({{ value_type_name }}*) jsl_allocator_interface_alloc(\n"
+        "        ring->allocator,\n"
+        "        ((int64_t) sizeof({{ value_type_name }})) * target_capacity,\n"
+        "        _Alignof({{ value_type_name }}),\n"
+        "        false\n"
+        "    );\n"
+        "    if (data == NULL)\n"
+        "        return false;\n"
+        "\n"
+        "    // Unwrap the elements to the start of the new buffer\n"
+        "    int64_t first_length = JSL_MIN(ring->length, ring->capacity - ring->head);\n"
+        "    if (first_length > 0)\n"
+        "    {\n"
+        "        JSL_MEMCPY(\n"
+        "            data,\n"
+        "            ring->data + ring->head,\n"
+        "            sizeof({{ value_type_name }}) * (size_t) first_length\n"
+        "        );\n"
+        "    }\n"
+        "    if (ring->length > first_length)\n"
+        "    {\n"
+        "        JSL_MEMCPY(\n"
+        "            data + first_length,\n"
+        "            ring->data,\n"
+        "            sizeof({{ value_type_name }}) * (size_t) (ring->length - first_length)\n"
+        "        );\n"
+        "    }\n"
+        "\n"
+        "    if (ring->data != NULL)\n"
+        "        jsl_allocator_interface_free(ring->allocator, ring->data);\n"
+        "\n"
+        "    ring->data = data;\n"
+        "    ring->head = 0;\n"
+        "    ring->capacity = target_capacity;\n"
+        "    return true;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_init(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    JSLAllocatorInterface allocator,\n"
+        "    int64_t capacity\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        ring != NULL\n"
+        "        && capacity > -1\n"
+        "        && capacity <= (INT64_MAX / 2) / (int64_t) sizeof({{ value_type_name }})\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "    {\n"
+        "        JSL_MEMSET(ring, 0, sizeof({{ array_type_name }}));\n"
+        "        ring->allocator = allocator;\n"
+        "        ring->sentinel = PRIVATE_SENTINEL_{{ array_type_name }};\n"
+        "\n"
+        "        ring->capacity = jsl_next_power_of_two_i64(JSL_MAX(capacity, (int64_t) 2));\n"
+        "        ring->data = ({{ value_type_name }}*) jsl_allocator_interface_alloc(\n"
+        "            allocator,\n"
+        "            ((int64_t) sizeof({{ value_type_name }})) * ring->capacity,\n"
+        "            _Alignof({{ value_type_name }}),\n"
+        "            false\n"
+        "        );\n"
+        "        res = ring->data != NULL;\n"
+        "    }\n"
+        "\n"
+        "    if (ring != NULL && !res)\n"
+        "    {\n"
+        "        ring->capacity = 0;\n"
+        "        ring->sentinel = 0;\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_push_back(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    {{ value_type_name }} value\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        ring != NULL\n"
+        "        && ring->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "        res = {{ function_prefix }}__ensure_capacity(ring, ring->length + 1);\n"
+        "\n"
+        "    if (res)\n"
+        "    {\n"
+        "        ring->data[(ring->head + ring->length) & (ring->capacity - 1)] = value;\n"
+        "        ++ring->length;\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_push_front(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    {{ value_type_name }} value\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        ring != NULL\n"
+        "        && ring->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "        res = {{ function_prefix }}__ensure_capacity(ring, ring->length + 1);\n"
+        "\n"
+        "    if (res)\n"
+        "    {\n"
+        "        ring->head = (ring->head - 1) & (ring->capacity - 1);\n"
+        "        ring->data[ring->head] = value;\n"
+        "        ++ring->length;\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_pop_front(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    {{ value_type_name }}* out_value\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        ring != NULL\n"
+        "        && ring->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && ring->length > 0\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "    {\n"
+        "        if (out_value != NULL)\n"
+        "            *out_value = ring->data[ring->head];\n"
+        "\n"
+        "        ring->head = (ring->head + 1) & (ring->capacity - 1);\n"
+        "        --ring->length;\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_pop_back(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    {{ value_type_name }}* out_value\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        ring != NULL\n"
+        "        && ring->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && ring->length > 0\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "    {\n"
+        "        --ring->length;\n"
+        "        if (out_value != NULL)\n"
+        "            *out_value = ring->data[(ring->head + ring->length) & (ring->capacity - 1)];\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_push_many(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    const {{ value_type_name }}* values,\n"
+        "    int64_t value_count\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        ring != NULL\n"
+        "        && ring->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && value_count > -1\n"
+        "        && (values != NULL || value_count == 0)\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "        res = value_count <= INT64_MAX - ring->length;\n"
+        "\n"
+        "    if (res)\n"
+        "        res = {{ function_prefix }}__ensure_capacity(ring, ring->length + value_count);\n"
+        "\n"
+        "    // The free space is at most two spans, the one up to the end of the\n"
+        "    // buffer and the one wrapped around to the start\n"
+        "    if (res && value_count > 0)\n"
+        "    {\n"
+        "        int64_t tail = (ring->head + ring->length) & (ring->capacity - 1);\n"
+        "        int64_t first_length = JSL_MIN(value_count, ring->capacity - tail);\n"
+        "\n"
+        "        JSL_MEMCPY(\n"
+        "            ring->data + tail,\n"
+        "            values,\n"
+        "            sizeof({{ value_type_name }}) * (size_t) first_length\n"
+        "        );\n"
+        "        if (value_count > first_length)\n"
+        "        {\n"
+        "            JSL_MEMCPY(\n"
+        "                ring->data,\n"
+        "                values + first_length,\n"
+        "                sizeof({{ value_type_name }}) * (size_t) (value_count - first_length)\n"
+        "            );\n"
+        "        }\n"
+        "\n"
+        "        ring->length += value_count;\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "int64_t {{ function_prefix }}_pop_many(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    {{ value_type_name }}* out_values,\n"
+        "    int64_t max_count\n"
+        ")\n"
+        "{\n"
+        "    int64_t res = -1;\n"
+        "\n"
+        "    if (\n"
+        "        ring != NULL\n"
+        "        && ring->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && max_count > -1\n"
+        "    )\n"
+        "    {\n"
+        "        res = JSL_MIN(max_count, ring->length);\n"
+        "    }\n"
+        "\n"
+        "    if (res > 0)\n"
+        "    {\n"
+        "        int64_t first_length = JSL_MIN(res, ring->capacity - ring->head);\n"
+        "\n"
+        "        if (out_values != NULL)\n"
+        "        {\n"
+        "            JSL_MEMCPY(\n"
+        "                out_values,\n"
+        "                ring->data + ring->head,\n"
+        "                sizeof({{ value_type_name }}) * (size_t) first_length\n"
+        "            );\n"
+        "            if (res > first_length)\n"
+        "            {\n"
+        "                JSL_MEMCPY(\n"
+        "                    out_values + first_length,\n"
+        "                    ring->data,\n"
+        "                    sizeof({{ value_type_name }}) * (size_t) (res - first_length)\n"
+        "                );\n"
+        "            }\n"
+        "        }\n"
+        "\n"
+        "        ring->head = (ring->head + res) & (ring->capacity - 1);\n"
+        "        ring->length -= res;\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "{{ value_type_name }}* {{ function_prefix }}_get(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    int64_t index\n"
+        ")\n"
+        "{\n"
+        "    {{ value_type_name }}* res = NULL;\n"
+        "\n"
+        "    if (\n"
+        "        ring != NULL\n"
+        "        && ring->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && index > -1\n"
+        "        && index < ring->length\n"
+        "    )\n"
+        "    {\n"
+        "        res = &ring->data[(ring->head + index) & (ring->capacity - 1)];\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_spans(\n"
+        "    {{ array_type_name }}* ring,\n"
+        "    {{ value_type_name }}** out_first,\n"
+        "    int64_t* out_first_length,\n"
+        "    {{ value_type_name }}** out_second,\n"
+        "    int64_t* out_second_length\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        ring != NULL\n"
+        "        && ring->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && out_first != NULL\n"
+        "        && out_first_length != NULL\n"
+        "        && out_second != NULL\n"
+        "        && out_second_length != NULL\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "    {\n"
+        "        int64_t first_length = JSL_MIN(ring->length, ring->capacity - ring->head);\n"
+        "\n"
+        "        *out_first = ring->data + ring->head;\n"
+        "        *out_first_length = first_length;\n"
+        "        *out_second = ring->data;\n"
+        "        *out_second_length = ring->length - first_length;\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "void {{ function_prefix }}_clear(\n"
+        "    {{ array_type_name }}* ring\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        ring != NULL\n"
+        "        && ring->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "    )\n"
+        "    {\n"
+        "        ring->head = 0;\n"
+        "        ring->length = 0;\n"
+        "    }\n"
+        "}\n"
+        "\n"
+        "void {{ function_prefix }}_free(\n"
+        "    {{ array_type_name }}* ring\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        ring != NULL\n"
+        "        && ring->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "    )\n"
+        "    {\n"
+        "        jsl_allocator_interface_free(ring->allocator, ring->data);\n"
+        "        ring->data = NULL;\n"
+        "        ring->head = 0;\n"
+        "        ring->length = 0;\n"
+        "        ring->capacity = 0;\n"
+        "        ring->sentinel = 0;\n"
+        "    }\n"
+        "}\n"
+    );
+
+    static JSLImmutableMemory spsc_header_template = JSL_CSTR_INITIALIZER(
+        "/**\n"
+        " * AUTO GENERATED FILE\n"
+        " *\n"
+        " * This file contains the header for a single producer, single consumer queue\n"
+        " * `{{ array_type_name }}` of `{{ value_type_name }}` values.\n"
+        " *\n"
+        " * This file was auto generated from the array code generation utility that's part of\n"
+        " * the \"Jack's Standard Library\" project. The utility generates a header file and a\n"
+        " * C file for a type safe, bounded, single producer, single consumer queue. By generating\n"
+        " * the code rather than using macros, two benefits are gained. One, the code is much\n"
+        " * easier to debug. Two, it's much more obvious how much code you're generating, which\n"
+        " * means you are much less likely to accidentally create the combinatoric explosion of\n"
+        " * code that's so common in C++ projects. Adding friction to things is actually good\n"
+        " * sometimes.\n"
+        " */\n"
+        "\n"
+        "\n"
+        "#pragma once\n"
+        "\n"
+        "#include <stdint.h>\n"
+        "#include <stddef.h>\n"
+        "#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L\n"
+        "    #include <stdbool.h>\n"
+        "#endif\n"
+        "\n"
+        "#include \"jsl/core.h\"\n"
+        "#include \"jsl/allocator.h\"\n"
+        "#include \"jsl/atomic_common.h\"\n"
+        "\n"
+        "#ifdef __cplusplus\n"
+        "extern \"C\" {\n"
+        "#endif\n"
+        "\n"
+        "/**\n"
+        " * Bounded lock free queue of {{ value_type_name }} for passing values from\n"
+        " * exactly one producer thread to exactly one consumer thread.\n"
+        " *\n"
+        " * The buffer is a power of two ring. The producer only writes the tail and\n"
+        " * the consumer only writes the head, and each side keeps a cached copy of\n"
+        " * the other side's index on its own cache line, so in the common case a push\n"
+        " * or a pop touches no cache line that the other thread writes to. The\n"
+        " * cached index is only refreshed when the queue looks full or empty.\n"
+        " *\n"
+        " * The batch functions move as many values as fit with at most two memcpy\n"
+        " * calls and a single index publish, which is much cheaper per value than\n"
+        " * calling `{{ function_prefix }}_try_push` in a loop.\n"
+        " *\n"
+        " * Init and free must not run at the same time as any other function. Using\n"
+        " * the push functions from more than one thread, or the pop functions from\n"
+        " * more than one thread, is a data race.\n"
+        " *\n"
+        " * ## Functions\n"
+        " *\n"
+        " *  * {{ function_prefix }}_init\n"
+        " *  * {{ function_prefix }}_try_push\n"
+        " *  * {{ function_prefix }}_try_pop\n"
+        " *  * {{ function_prefix }}_push_many\n"
+        " *  * {{ function_prefix }}_pop_many\n"
+        " *  * {{ function_prefix }}_approximate_length\n"
+        " *  * {{ function_prefix }}_free\n"
+        " *\n"
+        " */\n"
+        "typedef struct {{ array_type_name }} {\n"
+        "    // putting the sentinel first means it's much more likely to get\n"
+        "    // corrupted from accidental overwrites, therefore making it\n"
+        "    // more likely that memory bugs are caught.\n"
+        "    uint64_t sentinel;\n"
+        "    JSLAllocatorInterface allocator;\n"
+        "    {{ value_type_name }}* data;\n"
+        "    int64_t capacity;\n"
+        "    uint64_t mask;\n"
+        "\n"
+        "    // Keeps the read only fields above off of the consumer's line\n"
+        "    uint8_t padding_cold[JSL__CACHE_LINE_SIZE];\n"
+        "\n"
+        "    /// @brief written only by the consumer\n"
+        "    uint64_t head;\n"
+        "    /// @brief the consumer's last seen value of tail\n"
+        "    uint64_t cached_tail;\n"
+        "    uint8_t padding_head[JSL__CACHE_LINE_SIZE - 2 * sizeof(uint64_t)];\n"
+        "\n"
+        "    /// @brief written only by the producer\n"
+        "    uint64_t tail;\n"
+        "    /// @brief the producer's last seen value of head\n"
+        "    uint64_t cached_head;\n"
+        "    uint8_t padding_tail[JSL__CACHE_LINE_SIZE - 2 * sizeof(uint64_t)];\n"
+        "} {{ array_type_name }};\n"
+        "\n"
+        "/**\n"
+        " * Initialize an instance of {{ array_type_name }}. The capacity is rounded up\n"
+        " * to the next power of two and never changes.\n"
+        " *\n"
+        " * @param queue The pointer to the queue instance to initialize\n"
+        " * @param allocator Only used by init and free, so it doesn't need to be thread safe\n"
+        " * @param capacity The most values the queue can hold at once\n"
+        " * @returns If the allocation succeed\n"
+        " */\n"
+        "bool {{ function_prefix }}_init(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    JSLAllocatorInterface allocator,\n"
+        "    int64_t capacity\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Add a value to the queue. Only call this from the producer thread.\n"
+        " *\n"
+        " * @param queue The pointer to the queue\n"
+        " * @param value The value to add\n"
+        " * @returns false if the queue is full\n"
+        " */\n"
+        "bool {{ function_prefix }}_try_push(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    {{ value_type_name }} value\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Remove the oldest value from the queue. Only call this from the consumer thread.\n"
+        " *\n"
+        " * @param queue The pointer to the queue\n"
+        " * @param out_value Where the removed value is written\n"
+        " * @returns false if the queue is empty\n"
+        " */\n"
+        "bool {{ function_prefix }}_try_pop(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    {{ value_type_name }}* out_value\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Add as many of `values` as fit, in order. Only call this from the producer thread.\n"
+        " *\n"
+        " * @param queue The pointer to the queue\n"
+        " * @param values The pointer to the start of the values\n"
+        " * @param value_count The number of values\n"
+        " * @returns The number of values added, which is less than `value_count` when\n"
+        " * the queue fills up, or -1 on invalid parameters\n"
+        " */\n"
+        "int64_t {{ function_prefix }}_push_many(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    const {{ value_type_name }}* values,\n"
+        "    int64_t value_count\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Remove up to `max_count` of the oldest values, in order. Only call this\n"
+        " * from the consumer thread.\n"
+        " *\n"
+        " * @param queue The pointer to the queue\n"
+        " * @param out_values Where the removed values are written\n"
+        " * @param max_count The most values to remove\n"
+        " * @returns The number of values removed, or -1 on invalid parameters\n"
+        " */\n"
+        "int64_t {{ function_prefix }}_pop_many(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    {{ value_type_name }}* out_values,\n"
+        "    int64_t max_count\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Get the number of values in the queue. When other threads are using the\n"
+        " * queue this is already stale by the time it returns, so only use it for\n"
+        " * statistics and heuristics.\n"
+        " *\n"
+        " * @param queue The pointer to the queue\n"
+        " * @returns The number of values, or -1 on invalid parameters\n"
+        " */\n"
+        "int64_t {{ function_prefix }}_approximate_length(\n"
+        "    {{ array_type_name }}* queue\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Free the underlying memory. This sets the queue into an invalid state.\n"
+        " * You will have to call init again if you wish to use this queue instance.\n"
+        " *\n"
+        " * @param queue The pointer to the queue\n"
+        " */\n"
+        "void {{ function_prefix }}_free(\n"
+        "    {{ array_type_name }}* queue\n"
+        ");\n"
+        "\n"
+        "#ifdef __cplusplus\n"
+        "}\n"
+        "#endif\n"
+    );
+
+    static JSLImmutableMemory spsc_source_template = JSL_CSTR_INITIALIZER(
+        "/**\n"
+        " * AUTO GENERATED FILE\n"
+        " *\n"
+        " * This file contains the source for a single producer, single consumer queue\n"
+        " * `{{ array_type_name }}` of `{{ value_type_name }}` values.\n"
+        " *\n"
+        " * This file was auto generated from the array code generation utility that's part of\n"
+        " * the \"Jack's Standard Library\" project. The utility generates a header file and a\n"
+        " * C file for a type safe, bounded, single producer, single consumer queue. By generating\n"
+        " * the code rather than using macros, two benefits are gained. One, the code is much\n"
+        " * easier to debug. Two, it's much more obvious how much code you're generating, which\n"
+        " * means you are much less likely to accidentally create the combinatoric explosion of\n"
+        " * code that's so common in C++ projects. Adding friction to things is actually good\n"
+        " * sometimes.\n"
+        " */\n"
+        "\n"
+        "\n"
+        "#include <stdint.h>\n"
+        "#include <stddef.h>\n"
+        "#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L\n"
+        "    #include <stdbool.h>\n"
+        "#endif\n"
+        "#include <string.h>\n"
+        "\n"
+        "#include \"jsl/core.h\"\n"
+        "#include \"jsl/allocator.h\"\n"
+        "#include \"jsl/atomic_common.h\"\n"
+        "\n"
+        "bool {{ function_prefix }}_init(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    JSLAllocatorInterface allocator,\n"
+        "    int64_t capacity\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        queue != NULL\n"
+        "        && capacity > -1\n"
+        "        && capacity <= (INT64_MAX / 2) / (int64_t) sizeof({{ value_type_name }})\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "    {\n"
+        "        JSL_MEMSET(queue, 0, sizeof({{ array_type_name }}));\n"
+        "        queue->allocator = allocator;\n"
+        "        queue->capacity = jsl_next_power_of_two_i64(JSL_MAX(capacity, (int64_t) 2));\n"
+        "        queue->mask = (uint64_t) queue->capacity - 1;\n"
+        "\n"
+        "        queue->data = ({{ value_type_name }}*) jsl_allocator_interface_alloc(\n"
+        "            allocator,\n"
+        "            ((int64_t) sizeof({{ value_type_name }})) * queue->capacity,\n"
+        "            _Alignof({{ value_type_name }}),\n"
+        "            false\n"
+        "        );\n"
+        "        res = queue->data != NULL;\n"
+        "    }\n"
+        "\n"
+        "    if (res)\n"
+        "        queue->sentinel = PRIVATE_SENTINEL_{{ array_type_name }};\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "// Copy `count` values into the ring starting at the unmasked position\n"
+        "// `position`, in at most two parts\n"
+        "static inline void {{ function_prefix }}__copy_in(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    uint64_t position,\n"
+        "    const {{ value_type_name }}* values,\n"
+        "    int64_t count\n"
+        ")\n"
+        "{\n"
+        "    int64_t start = (int64_t) (position & queue->mask);\n"
+        "    int64_t first_length = JSL_MIN(count, queue->capacity - start);\n"
+        "\n"
+        "    JSL_MEMCPY(\n"
+        "        queue->data + start,\n"
+        "        values,\n"
+        "        sizeof({{ value_type_name }}) * (size_t) first_length\n"
+        "    );\n"
+        "    if (count > first_length)\n"
+        "    {\n"
+        "        JSL_MEMCPY(\n"
+        "            queue->data,\n"
+        "            values + first_length,\n"
+        "            sizeof({{ value_type_name }}) * (size_t) (count - first_length)\n"
+        "        );\n"
+        "    }\n"
+        "}\n"
+        "\n"
+        "static inline void {{ function_prefix }}__copy_out(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    uint64_t position,\n"
+        "    {{ value_type_name }}* out_values,\n"
+        "    int64_t count\n"
+        ")\n"
+        "{\n"
+        "    int64_t start = (int64_t) (position & queue->mask);\n"
+        "    int64_t first_length = JSL_MIN(count, queue->capacity - start);\n"
+        "\n"
+        "    JSL_MEMCPY(\n"
+        "        out_values,\n"
+        "        queue->data + start,\n"
+        "        sizeof({{ value_type_name }}) * (size_t) first_length\n"
+        "    );\n"
+        "    if (count > first_length)\n"
+        "    {\n"
+        "        JSL_MEMCPY(\n"
+        "            out_values + first_length,\n"
+        "            queue->data,\n"
+        "            sizeof({{ value_type_name }}) * (size_t) (count - first_length)\n"
+        "        );\n"
+        "    }\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_try_push(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    {{ value_type_name }} value\n"
+        ")\n"
+        "{\n"
+        "    if (queue == NULL || queue->sentinel != PRIVATE_SENTINEL_{{ array_type_name }})\n"
+        "        return false;\n"
+        "\n"
+        "    // The producer is the only writer of tail, so it can read it plainly\n"
+        "    uint64_t tail = queue->tail;\n"
+        "\n"
+        "    if (tail - queue->cached_head >= (uint64_t) queue->capacity)\n"
+        "    {\n"
+        "        queue->cached_head = jsl__atomic_load_u64(&queue->head);\n"
+        "        if (tail - queue->cached_head >= (uint64_t) queue->capacity)\n"
+        "            return false;\n"
+        "    }\n"
+        "\n"
+        "    queue->data[tail & queue->mask] = value;\n"
+        "    jsl__atomic_store_u64(&queue->tail, tail + 1);\n"
+        "    return true;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_try_pop(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    {{ value_type_name }}* out_value\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        queue == NULL\n"
+        "        || queue->sentinel != PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        || out_value == NULL\n"
+        "    )\n"
+        "        return false;\n"
+        "\n"
+        "    uint64_t head = queue->head;\n"
+        "\n"
+        "    if (head == queue->cached_tail)\n"
+        "    {\n"
+        "        queue->cached_tail = jsl__atomic_load_u64(&queue->tail);\n"
+        "        if (head == queue->cached_tail)\n"
+        "            return false;\n"
+        "    }\n"
+        "\n"
+        "    *out_value = queue->data[head & queue->mask];\n"
+        "    jsl__atomic_store_u64(&queue->head, head + 1);\n"
+        "    return true;\n"
+        "}\n"
+        "\n"
+        "int64_t {{ function_prefix }}_push_many(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    const {{ value_type_name }}* values,\n"
+        "    int64_t value_count\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        queue == NULL\n"
+        "        || queue->sentinel != PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        || value_count < 0\n"
+        "        || (values == NULL && value_count > 0)\n"
+        "    )\n"
+        "        return -1;\n"
+        "\n"
+        "    uint64_t tail = queue->tail;\n"
+        "    int64_t free_slots = queue->capacity - (int64_t) (tail - queue->cached_head);\n"
+        "\n"
+        "    if (free_slots < value_count)\n"
+        "    {\n"
+        "        queue->cached_head = jsl__atomic_load_u64(&queue->head);\n"
+        "        free_slots = queue->capacity - (int64_t) (tail - queue->cached_head);\n"
+        "    }\n"
+        "\n"
+        "    int64_t count = JSL_MIN(value_count, free_slots);\n"
+        "    if (count > 0)\n"
+        "    {\n"
+        "        {{ function_prefix }}__copy_in(queue, tail, values, count);\n"
+        "        jsl__atomic_store_u64(&queue->tail, tail + (uint64_t) count);\n"
+        "    }\n"
+        "\n"
+        "    return count;\n"
+        "}\n"
+        "\n"
+        "int64_t {{ function_prefix }}_pop_many(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    {{ value_type_name }}* out_values,\n"
+        "    int64_t max_count\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        queue == NULL\n"
+        "        || queue->sentinel != PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        || max_count < 0\n"
+        "        || (out_values == NULL && max_count > 0)\n"
+        "    )\n"
+        "        return -1;\n"
+        "\n"
+        "    uint64_t head = queue->head;\n"
+        "    int64_t available = (int64_t) (queue->cached_tail - head);\n"
+        "\n"
+        "    if (available < max_count)\n"
+        "    {\n"
+        "        queue->cached_tail = jsl__atomic_load_u64(&queue->tail);\n"
+        "        available = (int64_t) (queue->cached_tail - head);\n"
+        "    }\n"
+        "\n"
+        "    int64_t count = JSL_MIN(max_count, available);\n"
+        "    if (count > 0)\n"
+        "    {\n"
+        "        {{ function_prefix }}__copy_out(queue, head, out_values, count);\n"
+        "        jsl__atomic_store_u64(&queue->head, head + (uint64_t) count);\n"
+        "    }\n"
+        "\n"
+        "    return count;\n"
+        "}\n"
+        "\n"
+        "int64_t {{ function_prefix }}_approximate_length(\n"
+        "    {{ array_type_name }}* queue\n"
+        ")\n"
+        "{\n"
+        "    if (queue == NULL || queue->sentinel != PRIVATE_SENTINEL_{{ array_type_name }})\n"
+        "        return -1;\n"
+        "\n"
+        "    // Head first, so a concurrent pop can't make the result negative\n"
+        "    uint64_t head = jsl__atomic_load_u64(&queue->head);\n"
+        "    uint64_t tail = jsl__atomic_load_u64(&queue->tail);\n"
+        "    return (int64_t) (tail - head);\n"
+        "}\n"
+        "\n"
+        "void {{ function_prefix }}_free(\n"
+        "    {{ array_type_name }}* queue\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        queue != NULL\n"
+        "        && queue->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "    )\n"
+        "    {\n"
+        "        jsl_allocator_interface_free(queue->allocator, queue->data);\n"
+        "        queue->data = NULL;\n"
+        "        queue->capacity = 0;\n"
+        "        queue->head = 0;\n"
+        "        queue->tail = 0;\n"
+        "        queue->sentinel = 0;\n"
+        "    }\n"
+        "}\n"
+    );
+
+    static JSLImmutableMemory mpmc_header_template = JSL_CSTR_INITIALIZER(
+        "/**\n"
+        " * AUTO GENERATED FILE\n"
+        " *\n"
+        " * This file contains the header for a multi producer, multi consumer queue\n"
+        " * `{{ array_type_name }}` of `{{ value_type_name }}` values.\n"
+        " *\n"
+        " * This file was auto generated from the array code generation utility that's part of\n"
+        " * the \"Jack's Standard Library\" project. The utility generates a header file and a\n"
+        " * C file for a type safe, bounded, multi producer, multi consumer queue. By generating\n"
+        " * the code rather than using macros, two benefits are gained. One, the code is much\n"
+        " * easier to debug. Two, it's much more obvious how much code you're generating, which\n"
+        " * means you are much less likely to accidentally create the combinatoric explosion of\n"
+        " * code that's so common in C++ projects. Adding friction to things is actually good\n"
+        " * sometimes.\n"
+        " */\n"
+        "\n"
+        "\n"
+        "#pragma once\n"
+        "\n"
+        "#include <stdint.h>\n"
+        "#include <stddef.h>\n"
+        "#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L\n"
+        "    #include <stdbool.h>\n"
+        "#endif\n"
+        "\n"
+        "#include \"jsl/core.h\"\n"
+        "#include \"jsl/allocator.h\"\n"
+        "#include \"jsl/atomic_common.h\"\n"
+        "\n"
+        "#ifdef __cplusplus\n"
+        "extern \"C\" {\n"
+        "#endif\n"
+        "\n"
+        "/**\n"
+        " * One slot of the queue. The sequence number says whose turn it is: equal to\n"
+        " * the slot's position when a producer may fill it, one past the position\n"
+        " * when a consumer may empty it.\n"
+        " */\n"
+        "typedef struct {{ array_type_name }}Cell {\n"
+        "    uint64_t sequence;\n"
+        "    {{ value_type_name }} value;\n"
+        "} {{ array_type_name }}Cell;\n"
+        "\n"
+        "/**\n"
+        " * Bounded queue of {{ value_type_name }} which any number of threads can push\n"
+        " * to and pop from at once, based on Dmitry Vyukov's bounded MPMC queue.\n"
+        " *\n"
+        " * Producers claim positions by advancing a shared enqueue counter with a\n"
+        " * compare and swap, consumers do the same with a dequeue counter, and each\n"
+        " * slot's sequence number hands it back and forth. The two counters are on\n"
+        " * their own cache lines so producers and consumers don't slow each other\n"
+        " * down. There are no locks, a push or pop either claims a slot or returns\n"
+        " * false right away when the queue is full or empty.\n"
+        " *\n"
+        " * The batch functions claim a whole run of slots with a single compare and\n"
+        " * swap, so contention on the counters drops with the batch size.\n"
+        " *\n"
+        " * Values from different producers interleave in whatever order their pushes\n"
+        " * claimed slots. With a single consumer, the values of each producer come\n"
+        " * out in the order it pushed them.\n"
+        " *\n"
+        " * Init and free must not run at the same time as any other function.\n"
+        " *\n"
+        " * ## Functions\n"
+        " *\n"
+        " *  * {{ function_prefix }}_init\n"
+        " *  * {{ function_prefix }}_try_push\n"
+        " *  * {{ function_prefix }}_try_pop\n"
+        " *  * {{ function_prefix }}_push_many\n"
+        " *  * {{ function_prefix }}_pop_many\n"
+        " *  * {{ function_prefix }}_approximate_length\n"
+        " *  * {{ function_prefix }}_free\n"
+        " *\n"
+        " */\n"
+        "typedef struct {{ array_type_name }} {\n"
+        "    // putting the sentinel first means it's much more likely to get\n"
+        "    // corrupted from accidental overwrites, therefore making it\n"
+        "    // more likely that memory bugs are caught.\n"
+        "    uint64_t sentinel;\n"
+        "    JSLAllocatorInterface allocator;\n"
+        "    {{ array_type_name }}Cell* cells;\n"
+        "    int64_t capacity;\n"
+        "    uint64_t mask;\n"
+        "\n"
+        "    // Keeps the read only fields above off of the producers' line\n"
+        "    uint8_t padding_cold[JSL__CACHE_LINE_SIZE];\n"
+        "\n"
+        "    uint64_t enqueue_position;\n"
+        "    uint8_t padding_enqueue[JSL__CACHE_LINE_SIZE - sizeof(uint64_t)];\n"
+        "\n"
+        "    uint64_t dequeue_position;\n"
+        "    uint8_t padding_dequeue[JSL__CACHE_LINE_SIZE - sizeof(uint64_t)];\n"
+        "} {{ array_type_name }};\n"
+        "\n"
+        "/**\n"
+        " * Initialize an instance of {{ array_type_name }}. The capacity is rounded up\n"
+        " * to the next power of two and never changes.\n"
+        " *\n"
+        " * @param queue The pointer to the queue instance to initialize\n"
+        " * @param allocator Only used by init and free, so it doesn't need to be thread safe\n"
+        " * @param capacity The most values the queue can hold at once\n"
+        " * @returns If the allocation succeed\n"
+        " */\n"
+        "bool {{ function_prefix }}_init(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    JSLAllocatorInterface allocator,\n"
+        "    int64_t capacity\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Add a value to the queue.\n"
+        " *\n"
+        " * @param queue The pointer to the queue\n"
+        " * @param value The value to add\n"
+        " * @returns false if the queue is full\n"
+        " */\n"
+        "bool {{ function_prefix }}_try_push(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    {{ value_type_name }} value\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Remove a value from the queue.\n"
+        " *\n"
+        " * @param queue The pointer to the queue\n"
+        " * @param out_value Where the removed value is written\n"
+        " * @returns false if the queue is empty\n"
+        " */\n"
+        "bool {{ function_prefix }}_try_pop(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    {{ value_type_name }}* out_value\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Add as many of `values` as there are free slots for, in order, claiming\n"
+        " * all of the slots at once.\n"
+        " *\n"
+        " * @param queue The pointer to the queue\n"
+        " * @param values The pointer to the start of the values\n"
+        " * @param value_count The number of values\n"
+        " * @returns The number of values added, which is less than `value_count` when\n"
+        " * the queue fills up, or -1 on invalid parameters\n"
+        " */\n"
+        "int64_t {{ function_prefix }}_push_many(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    const {{ value_type_name }}* values,\n"
+        "    int64_t value_count\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Remove up to `max_count` values, claiming all of the slots at once.\n"
+        " *\n"
+        " * @param queue The pointer to the queue\n"
+        " * @param out_values Where the removed values are written\n"
+        " * @param max_count The most values to remove\n"
+        " * @returns The number of values removed, or -1 on invalid parameters\n"
+        " */\n"
+        "int64_t {{ function_prefix }}_pop_many(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    {{ value_type_name }}* out_values,\n"
+        "    int64_t max_count\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Get the number of values in the queue. When other threads are using the\n"
+        " * queue this is already stale by the time it returns, so only use it for\n"
+        " * statistics and heuristics.\n"
+        " *\n"
+        " * @param queue The pointer to the queue\n"
+        " * @returns The number of values, or -1 on invalid parameters\n"
+        " */\n"
+        "int64_t {{ function_prefix }}_approximate_length(\n"
+        "    {{ array_type_name }}* queue\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Free the underlying memory. This sets the queue into an invalid state.\n"
+        " * You will have to call init again if you wish to use this queue instance.\n"
+        " *\n"
+        " * @param queue The pointer to the queue\n"
+        " */\n"
+        "void {{ function_prefix }}_free(\n"
+        "    {{ array_type_name }}* queue\n"
+        ");\n"
+        "\n"
+        "#ifdef __cplusplus\n"
+        "}\n"
+        "#endif\n"
+    );
+
+    static JSLImmutableMemory mpmc_source_template = JSL_CSTR_INITIALIZER(
+        "/**\n"
+        " * AUTO GENERATED FILE\n"
+        " *\n"
+        " * This file contains the source for a multi producer, multi consumer queue\n"
+        " * `{{ array_type_name }}` of `{{ value_type_name }}` values.\n"
+        " *\n"
+        " * This file was auto generated from the array code generation utility that's part of\n"
+        " * the \"Jack's Standard Library\" project. The utility generates a header file and a\n"
+        " * C file for a type safe, bounded, multi producer, multi consumer queue. By generating\n"
+        " * the code rather than using macros, two benefits are gained. One, the code is much\n"
+        " * easier to debug. Two, it's much more obvious how much code you're generating, which\n"
+        " * means you are much less likely to accidentally create the combinatoric explosion of\n"
+        " * code that's so common in C++ projects. Adding friction to things is actually good\n"
+        " * sometimes.\n"
+        " */\n"
+        "\n"
+        "\n"
+        "#include <stdint.h>\n"
+        "#include <stddef.h>\n"
+        "#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L\n"
+        "    #include <stdbool.h>\n"
+        "#endif\n"
+        "#include <string.h>\n"
+        "\n"
+        "#include \"jsl/core.h\"\n"
+        "#include \"jsl/allocator.h\"\n"
+        "#include \"jsl/atomic_common.h\"\n"
+        "\n"
+        "bool {{ function_prefix }}_init(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    JSLAllocatorInterface allocator,\n"
+        "    int64_t capacity\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        queue != NULL\n"
+        "        && capacity > -1\n"
+        "        && capacity <= (INT64_MAX / 2) / (int64_t) sizeof({{ array_type_name }}Cell)\n"
+        "    );\n"
+        "\n"
+        "    if (res)\n"
+        "    {\n"
+        "        JSL_MEMSET(queue, 0, sizeof({{ array_type_name }}));\n"
+        "        queue->allocator = allocator;\n"
+        "        queue->capacity = jsl_next_power_of_two_i64(JSL_MAX(capacity, (int64_t) 2));\n"
+        "        queue->mask = (uint64_t) queue->capacity - 1;\n"
+        "\n"
+        "        queue->cells = ({{ array_type_name }}Cell*) jsl_allocator_interface_alloc(\n"
+        "            allocator,\n"
+        "            ((int64_t) sizeof({{ array_type_name }}Cell)) * queue->capacity,\n"
+        "            _Alignof({{ array_type_name }}Cell),\n"
+        "            false\n"
+        "        );\n"
+        "        res = queue->cells != NULL;\n"
+        "    }\n"
+        "\n"
+        "    if (res)\n"
+        "    {\n"
+        "        for (int64_t i = 0; i < queue->capacity; ++i)\n"
+        "        {\n"
+        "            queue->cells[i].sequence = (uint64_t) i;\n"
+        "        }\n"
+        "\n"
+        "        queue->sentinel = PRIVATE_SENTINEL_{{ array_type_name }};\n"
+        "    }\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "/**\n"
+        " * Claim up to `max_count` consecutive slots starting at the shared `counter`.\n"
+        " * A slot at position `p` can be claimed when its sequence is `p + offset`,\n"
+        " * which is zero for producers and one for consumers.\n"
+        " */\n"
+        "static int64_t {{ function_prefix }}__claim(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    volatile uint64_t* counter,\n"
+        "    uint64_t offset,\n"
+        "    int64_t max_count,\n"
+        "    uint64_t* out_position\n"
+        ")\n"
+        "{\n"
+        "    uint64_t position = jsl__atomic_load_u64(counter);\n"
+        "\n"
+        "    for (;;)\n"
+        "    {\n"
+        "        int64_t count = 0;\n"
+        "        int64_t first_difference = 0;\n"
+        "\n"
+        "        while (count < max_count)\n"
+        "        {\n"
+        "            uint64_t slot = position + (uint64_t) count;\n"
+        "            uint64_t sequence = jsl__atomic_load_u64(&queue->cells[slot & queue->mask].sequence);\n"
+        "            int64_t difference = (int64_t) (sequence - (slot + offset));\n"
+        "\n"
+        "            if (count == 0)\n"
+        "                first_difference = difference;\n"
+        "            if (difference != 0)\n"
+        "                break;\n"
+        "\n"
+        "            ++count;\n"
+        "        }\n"
+        "\n"
+        "        // The first slot is still a lap behind, so the queue is full for a\n"
+        "        // producer or empty for a consumer\n"
+        "        if (count == 0 && first_difference < 0)\n"
+        "            return 0;\n"
+        "\n"
+        "        // Otherwise the slots were seen free, and the claim only fails when\n"
+        "        // another thread moved the counter first\n"
+        "        if (count > 0 && jsl__atomic_compare_exchange_u64(counter, position, position + (uint64_t) count))\n"
+        "        {\n"
+        "            *out_position = position;\n"
+        "            return count;\n"
+        "        }\n"
+        "\n"
+        "        jsl__cpu_relax();\n"
+        "        position = jsl__atomic_load_u64(counter);\n"
+        "    }\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_try_push(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    {{ value_type_name }} value\n"
+        ")\n"
+        "{\n"
+        "    if (queue == NULL || queue->sentinel != PRIVATE_SENTINEL_{{ array_type_name }})\n"
+        "        return false;\n"
+        "\n"
+        "    uint64_t position = 0;\n"
+        "    if ({{ function_prefix }}__claim(queue, &queue->enqueue_position, 0, 1, &position) == 0)\n"
+        "        return false;\n"
+        "\n"
+        "    {{ array_type_name }}Cell* cell = &queue->cells[position & queue->mask];\n"
+        "    cell->value = value;\n"
+        "    jsl__atomic_store_u64(&cell->sequence, position + 1);\n"
+        "    return true;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_try_pop(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    {{ value_type_name }}* out_value\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        queue == NULL\n"
+        "        || queue->sentinel != PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        || out_value == NULL\n"
+        "    )\n"
+        "        return false;\n"
+        "\n"
+        "    uint64_t position = 0;\n"
+        "    if ({{ function_prefix }}__claim(queue, &queue->dequeue_position, 1, 1, &position) == 0)\n"
+        "        return false;\n"
+        "\n"
+        "    {{ array_type_name }}Cell* cell = &queue->cells[position & queue->mask];\n"
+        "    *out_value = cell->value;\n"
+        "    jsl__atomic_store_u64(&cell->sequence, position + queue->mask + 1);\n"
+        "    return true;\n"
+        "}\n"
+        "\n"
+        "int64_t {{ function_prefix }}_push_many(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    const {{ value_type_name }}* values,\n"
+        "    int64_t value_count\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        queue == NULL\n"
+        "        || queue->sentinel != PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        || value_count < 0\n"
+        "        || (values == NULL && value_count > 0)\n"
+        "    )\n"
+        "        return -1;\n"
+        "\n"
+        "    uint64_t position = 0;\n"
+        "    int64_t count = value_count > 0\n"
+        "        ? {{ function_prefix }}__claim(queue, &queue->enqueue_position, 0, value_count, &position)\n"
+        "        : 0;\n"
+        "\n"
+        "    for (int64_t i = 0; i < count; ++i)\n"
+        "    {\n"
+        "        uint64_t slot = position + (uint64_t) i;\n"
+        "        {{ array_type_name }}Cell* cell = &queue->cells[slot & queue->mask];\n"
+        "        cell->value = values[i];\n"
+        "        jsl__atomic_store_u64(&cell->sequence, slot + 1);\n"
+        "    }\n"
+        "\n"
+        "    return count;\n"
+        "}\n"
+        "\n"
+        "int64_t {{ function_prefix }}_pop_many(\n"
+        "    {{ array_type_name }}* queue,\n"
+        "    {{ value_type_name }}* out_values,\n"
+        "    int64_t max_count\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        queue == NULL\n"
+        "        || queue->sentinel != PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        || max_count < 0\n"
+        "        || (out_values == NULL && max_count > 0)\n"
+        "    )\n"
+        "        return -1;\n"
+        "\n"
+        "    uint64_t position = 0;\n"
+        "    int64_t count = max_count > 0\n"
+        "        ? {{ function_prefix }}__claim(queue, &queue->dequeue_position, 1, max_count, &position)\n"
+        "        : 0;\n"
+        "\n"
+        "    for (int64_t i = 0; i < count; ++i)\n"
+        "    {\n"
+        "        uint64_t slot = position + (uint64_t) i;\n"
+        "        {{ array_type_name }}Cell* cell = &queue->cells[slot & queue->mask];\n"
+        "        out_values[i] = cell->value;\n"
+        "        jsl__atomic_store_u64(&cell->sequence, slot + queue->mask + 1);\n"
+        "    }\n"
+        "\n"
+        "    return count;\n"
+        "}\n"
+        "\n"
+        "int64_t {{ function_prefix }}_approximate_length(\n"
+        "    {{ array_type_name }}* queue\n"
+        ")\n"
+        "{\n"
+        "    if (queue == NULL || queue->sentinel != PRIVATE_SENTINEL_{{ array_type_name }})\n"
+        "        return -1;\n"
+        "\n"
+        "    // Dequeue first, so a concurrent pop can't make the result negative\n"
+        "    uint64_t dequeue_position = jsl__atomic_load_u64(&queue->dequeue_position);\n"
+        "    uint64_t enqueue_position = jsl__atomic_load_u64(&queue->enqueue_position);\n"
+        "    return (int64_t) (enqueue_position - dequeue_position);\n"
+        "}\n"
+        "\n"
+        "void {{ function_prefix }}_free(\n"
+        "    {{ array_type_name }}* queue\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        queue != NULL\n"
+        "        && queue->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "    )\n"
+        "    {\n"
+        "        jsl_allocator_interface_free(queue->allocator, queue->cells);\n"
+        "        queue->cells = NULL;\n"
+        "        queue->capacity = 0;\n"
+        "        queue->enqueue_position = 0;\n"
+        "        queue->dequeue_position = 0;\n"
+        "        queue->sentinel = 0;\n"
+        "    }\n"
+        "}\n"
+    );
+
+    static JSLImmutableMemory sort_header_template = JSL_CSTR_INITIALIZER(
+        "\n"
+        "#ifdef __cplusplus\n"
+        "extern \"C\" {\n"
+        "#endif\n"
+        "\n"
+        "/**\n"
+        " * Sort the array in place with pattern defeating quicksort. The comparison is\n"
+        " * `{{ less_than_description }}` and it's inlined into the sort, so there's no\n"
+        " * function pointer call per comparison like with `qsort`.\n"
+        " *\n"
+        " * The sort is not stable. Already sorted, reverse sorted, and mostly equal\n"
+        " * inputs are detected and finish in linear time, and adversarial inputs fall\n"
+        " * back to heapsort, so the worst case is O(n log n).\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " */\n"
+        "void {{ function_prefix }}_sort(\n"
+        "    {{ array_type_name }}* array\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Rearrange the array so that the element at `nth` is the one which would be\n"
+        " * there if the whole array was sorted. Every element before it is not greater\n"
+        " * than it and every element after it is not less than it. Expected O(n).\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " * @param nth The index to place the correct element at\n"
+        " * @returns false if `nth` is out of bounds\n"
+        " */\n"
+        "bool {{ function_prefix }}_nth_element(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t nth\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Sort only the smallest `count` elements into `array->data[0 .. count)`.\n"
+        " * The order of the remaining elements is unspecified. This is much cheaper\n"
+        " * than a full sort when `count` is small relative to the length.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " * @param count The number of elements to sort, clamped to the array length\n"
+        " * @returns false on invalid parameters\n"
+        " */\n"
+        "bool {{ function_prefix }}_partial_sort(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t count\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Find the first index in a sorted array whose element is not less than\n"
+        " * `value`. This is the index `value` would be inserted at to keep the array\n"
+        " * sorted. The search is branchless.\n"
+        " *\n"
+        " * @param array The pointer to the sorted array\n"
+        " * @param value The value to search for\n"
+        " * @returns The index, which is `array->length` if every element is less than `value`,\n"
+        " * or -1 on invalid parameters\n"
+        " */\n"
+        "int64_t {{ function_prefix }}_lower_bound(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    const {{ value_type_name }}* value\n"
+        ");\n"
+        "\n"
+        "/**\n"
+        " * Find the first index in a sorted array whose element is greater than `value`.\n"
+        " *\n"
+        " * @param array The pointer to the sorted array\n"
+        " * @param value The value to search for\n"
+        " * @returns The index, which is `array->length` if no element is greater than `value`,\n"
+        " * or -1 on invalid parameters\n"
+        " */\n"
+        "int64_t {{ function_prefix }}_upper_bound(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    const {{ value_type_name }}* value\n"
+        ");\n"
+        "{{ radix_declaration }}\n"
+        "#ifdef __cplusplus\n"
+        "}\n"
+        "#endif\n"
+    );
+
+    static JSLImmutableMemory sort_source_template = JSL_CSTR_INITIALIZER(
+        "\n"
+        "/**\n"
+        " * Sorting and searching for {{ array_type_name }}\n"
+        " *\n"
+        " * The sort is pattern defeating quicksort (Orson Peters, 2021). It's an\n"
+        " * introsort with median of three or ninther pivots that detects already\n"
+        " * sorted runs, puts elements equal to the previous pivot aside in one pass,\n"
+        " * and shuffles or falls back to heapsort when partitions keep coming out\n"
+        " * unbalanced.\n"
+        " */\n"
+        "\n"
+        "#define {{ function_prefix }}__INSERTION_SORT_THRESHOLD 24\n"
+        "#define {{ function_prefix }}__NINTHER_THRESHOLD 128\n"
+        "#define {{ function_prefix }}__PARTIAL_INSERTION_SORT_LIMIT 8\n"
+        "\n"
+        "static inline bool {{ function_prefix }}__less(\n"
+        "    const {{ value_type_name }}* a,\n"
+        "    const {{ value_type_name }}* b\n"
+        ")\n"
+        "{\n"
+        "    return {{ less_than_expression }};\n"
+        "}\n"
+        "\n"
+        "static inline void {{ function_prefix }}__swap(\n"
+        "    {{ value_type_name }}* a,\n"
+        "    {{ value_type_name }}* b\n"
+        ")\n"
+        "{\n"
+        "    {{ value_type_name }} tmp = *a;\n"
+        "    *a = *b;\n"
+        "    *b = tmp;\n"
+        "}\n"
+        "\n"
+        "static inline void {{ function_prefix }}__sort2(\n"
+        "    {{ value_type_name }}* a,\n"
+        "    {{ value_type_name }}* b\n"
+        ")\n"
+        "{\n"
+        "    if ({{ function_prefix }}__less(b, a))\n"
+        "        {{ function_prefix }}__swap(a, b);\n"
+        "}\n"
+        "\n"
+        "static inline void {{ function_prefix }}__sort3(\n"
+        "    {{ value_type_name }}* a,\n"
+        "    {{ value_type_name }}* b,\n"
+        "    {{ value_type_name }}* c\n"
+        ")\n"
+        "{\n"
+        "    {{ function_prefix }}__sort2(a, b);\n"
+        "    {{ function_prefix }}__sort2(b, c);\n"
+        "    {{ function_prefix }}__sort2(a, b);\n"
+        "}\n"
+        "\n"
+        "static inline int32_t {{ function_prefix }}__log2(\n"
+        "    int64_t length\n"
+        ")\n"
+        "{\n"
+        "    int32_t log = 0;\n"
+        "    while (length >>= 1)\n"
+        "        ++log;\n"
+        "    return log;\n"
+        "}\n"
+        "\n"
+        "static void {{ function_prefix }}__insertion_sort(\n"
+        "    {{ value_type_name }}* begin,\n"
+        "    {{ value_type_name }}* end\n"
+        ")\n"
+        "{\n"
+        "    if (begin == end)\n"
+        "        return;\n"
+        "\n"
+        "    for ({{ value_type_name }}* current = begin + 1; current != end; ++current)\n"
+        "    {\n"
+        "        {{ value_type_name }}* sift = current;\n"
+        "        {{ value_type_name }}* sift_1 = current - 1;\n"
+        "\n"
+        "        if ({{ function_prefix }}__less(sift, sift_1))\n"
+        "        {\n"
+        "            {{ value_type_name }} tmp = *sift;\n"
+        "\n"
+        "            do\n"
+        "            {\n"
+        "                *sift-- = *sift_1;\n"
+        "            }\n"
+        "            while (sift != begin && {{ function_prefix }}__less(&tmp, --sift_1));\n"
+        "\n"
+        "            *sift = tmp;\n"
+        "        }\n"
+        "    }\n"
+        "}\n"
+        "\n"
+        "/**\n"
+        " * Same as the insertion sort, but the element before `begin` must not be\n"
+        " * greater than anything in the range. That element stops the sift, so the\n"
+        " * inner loop doesn't need a bounds check.\n"
+        " */\n"
+        "static void {{ function_prefix }}__unguarded_insertion_sort(\n"
+        "    {{ value_type_name }}* begin,\n"
+        "    {{ value_type_name }}* end\n"
+        ")\n"
+        "{\n"
+        "    if (begin == end)\n"
+        "        return;\n"
+        "\n"
+        "    for ({{ value_type_name }}* current = begin + 1; current != end; ++current)\n"
+        "    {\n"
+        "        {{ value_type_name }}* sift = current;\n"
+        "        {{ value_type_name }}* sift_1 = current - 1;\n"
+        "\n"
+        "        if ({{ function_prefix }}__less(sift, sift_1))\n"
+        "        {\n"
+        "            {{ value_type_name }} tmp = *sift;\n"
+        "\n"
+        "            do\n"
+        "            {\n"
+        "                *sift-- = *sift_1;\n"
+        "            }\n"
+        "            while ({{ function_prefix }}__less(&tmp, --sift_1));\n"
+        "\n"
+        "            *sift = tmp;\n"
+        "        }\n"
+        "    }\n"
+        "}\n"
+        "\n"
+        "/**\n"
+        " * Insertion sort which gives up once it has moved more than a handful of\n"
+        " * elements. Returns true if the range ended up sorted.\n"
+        " */\n"
+        "static bool {{ function_prefix }}__partial_insertion_sort(\n"
+        "    {{ value_type_name }}* begin,\n"
+        "    {{ value_type_name }}* end\n"
+        ")\n"
+        "{\n"
+        "    if (begin == end)\n"
+        "        return true;\n"
+        "\n"
+        "    int64_t moved = 0;\n"
+        "    for ({{ value_type_name }}* current = begin + 1; current != end; ++current)\n"
+        "    {\n"
+        "        {{ value_type_name }}* sift = current;\n"
+        "        {{ value_type_name }}* sift_1 = current - 1;\n"
+        "\n"
+        "        if ({{ function_prefix }}__less(sift, sift_1))\n"
+        "        {\n"
+        "            {{ value_type_name }} tmp = *sift;\n"
+        "\n"
+        "            do\n"
+        "            {\n"
+        "                *sift-- = *sift_1;\n"
+        "            }\n"
+        "            while (sift != begin && {{ function_prefix }}__less(&tmp, --sift_1));\n"
+        "\n"
+        "            *sift = tmp;\n"
+        "            moved += current - sift;\n"
+        "        }\n"
+        "\n"
+        "        if (moved > {{ function_prefix }}__PARTIAL_INSERTION_SORT_LIMIT)\n"
+        "            return false;\n"
+        "    }\n"
+        "\n"
+        "    return true;\n"
+        "}\n"
+        "\n"
+        "/**\n"
+        " * Partition around the pivot at `begin`. Elements equal to the pivot go to\n"
+        " * the right. The pivot must have been chosen as a median, so that there's\n"
+        " * an element not less than it before `end`, which stops the first scan.\n"
+        " */\n"
+        "static {{ value_type_name }}* {{ function_prefix }}__partition_right(\n"
+        "    {{ value_type_name }}* begin,\n"
+        "    {{ value_type_name }}* end,\n"
+        "    bool* out_already_partitioned\n"
+        ")\n"
+        "{\n"
+        "    {{ value_type_name }} pivot = *begin;\n"
+        "    {{ value_type_name }}* first = begin;\n"
+        "    {{ value_type_name }}* last = end;\n"
+        "\n"
+        "    while ({{ function_prefix }}__less(++first, &pivot));\n"
+        "\n"
+        "    // If nothing was skipped there may be no element less than the pivot\n"
+        "    // to stop the scan, so it has to be bounds checked\n"
+        "    if (first - 1 == begin)\n"
+        "    {\n"
+        "        while (first < last && !{{ function_prefix }}__less(--last, &pivot));\n"
+        "    }\n"
+        "    else\n"
+        "    {\n"
+        "        while (!{{ function_prefix }}__less(--last, &pivot));\n"
+        "    }\n"
+        "\n"
+        "    *out_already_partitioned = first >= last;\n"
+        "\n"
+        "    while (first < last)\n"
+        "    {\n"
+        "        {{ function_prefix }}__swap(first, last);\n"
+        "        while ({{ function_prefix }}__less(++first, &pivot));\n"
+        "        while (!{{ function_prefix }}__less(--last, &pivot));\n"
+        "    }\n"
+        "\n"
+        "    {{ value_type_name }}* pivot_position = first - 1;\n"
+        "    *begin = *pivot_position;\n"
+        "    *pivot_position = pivot;\n"
+        "\n"
+        "    return pivot_position;\n"
+        "}\n"
+        "\n"
+        "/**\n"
+        " * Partition around the pivot at `begin` with the elements equal to it going\n"
+        " * left. Only used when the element before the range is equal to the pivot,\n"
+        " * in which case everything which goes left is already in its final spot.\n"
+        " */\n"
+        "static {{ value_type_name }}* {{ function_prefix }}__partition_left(\n"
+        "    {{ value_type_name }}* begin,\n"
+        "    {{ value_type_name }}* end\n"
+        ")\n"
+        "{\n"
+        "    {{ value_type_name }} pivot = *begin;\n"
+        "    {{ value_type_name }}* first = begin;\n"
+        "    {{ value_type_name }}* last = end;\n"
+        "\n"
+        "    while ({{ function_prefix }}__less(&pivot, --last));\n"
+        "\n"
+        "    if (last + 1 == end)\n"
+        "    {\n"
+        "        while (first < last && !{{ function_prefix }}__less(&pivot, ++first));\n"
+        "    }\n"
+        "    else\n"
+        "    {\n"
+        "        while (!{{ function_prefix }}__less(&pivot, ++first));\n"
+        "    }\n"
+        "\n"
+        "    while (first < last)\n"
+        "    {\n"
+        "        {{ function_prefix }}__swap(first, last);\n"
+        "        while ({{ function_prefix }}__less(&pivot, --last));\n"
+        "        while (!{{ function_prefix }}__less(&pivot, ++first));\n"
+        "    }\n"
+        "\n"
+        "    {{ value_type_name }}* pivot_position = last;\n"
+        "    *begin = *pivot_position;\n"
+        "    *pivot_position = pivot;\n"
+        "\n"
+        "    return pivot_position;\n"
+        "}\n"
+        "\n"
+        "static void {{ function_prefix }}__sift_down(\n"
+        "    {{ value_type_name }}* data,\n"
+        "    int64_t root,\n"
+        "    int64_t length\n"
+        ")\n"
+        "{\n"
+        "    while (true)\n"
+        "    {\n"
+        "        int64_t child = root * 2 + 1;\n"
+        "        if (child >= length)\n"
+        "            break;\n"
+        "\n"
+        "        if (child + 1 < length && {{ function_prefix }}__less(&data[child], &data[child + 1]))\n"
+        "            ++child;\n"
+        "\n"
+        "        if (!{{ function_prefix }}__less(&data[root], &data[child]))\n"
+        "            break;\n"
+        "\n"
+        "        {{ function_prefix }}__swap(&data[root], &data[child]);\n"
+        "        root = child;\n"
+        "    }\n"
+        "}\n"
+        "\n"
+        "static void {{ function_prefix }}__heap_sort(\n"
+        "    {{ value_type_name }}* begin,\n"
+        "    {{ value_type_name }}* end\n"
+        ")\n"
+        "{\n"
+        "    int64_t length = end - begin;\n"
+        "\n"
+        "    for (int64_t i = length / 2 - 1; i > -1; --i)\n"
+        "        {{ function_prefix }}__sift_down(begin, i, length);\n"
+        "\n"
+        "    for (int64_t i = length - 1; i > 0; --i)\n"
+        "    {\n"
+        "        {{ function_prefix }}__swap(&begin[0], &begin[i]);\n"
+        "        {{ function_prefix }}__sift_down(begin, 0, i);\n"
+        "    }\n"
+        "}\n"
+        "\n"
+        "static void {{ function_prefix }}__pdqsort_loop(\n"
+        "    {{ value_type_name }}* begin,\n"
+        "    {{ value_type_name }}* end,\n"
+        "    int32_t bad_allowed,\n"
+        "    bool leftmost\n"
+        ")\n"
+        "{\n"
+        "    while (true)\n"
+        "    {\n"
+        "        int64_t size = end - begin;\n"
+        "\n"
+        "        if (size < {{ function_prefix }}__INSERTION_SORT_THRESHOLD)\n"
+        "        {\n"
+        "            if (leftmost)\n"
+        "                {{ function_prefix }}__insertion_sort(begin, end);\n"
+        "            else\n"
+        "                {{ function_prefix }}__unguarded_insertion_sort(begin, end);\n"
+        "            return;\n"
+        "        }\n"
+        "\n"
+        "        // Put the median of three, or the ninther for big ranges, at begin\n"
+        "        int64_t half = size / 2;\n"
+        "        if (size > {{ function_prefix }}__NINTHER_THRESHOLD)\n"
+        "        {\n"
+        "            {{ function_prefix }}__sort3(begin, begin + half, end - 1);\n"
+        "            {{ function_prefix }}__sort3(begin + 1, begin + (half - 1), end - 2);\n"
+        "            {{ function_prefix }}__sort3(begin + 2, begin + (half + 1), end - 3);\n"
+        "            {{ function_prefix }}__sort3(begin + (half - 1), begin + half, begin + (half + 1));\n"
+        "            {{ function_prefix }}__swap(begin, begin + half);\n"
+        "        }\n"
+        "        else\n"
+        "        {\n"
+        "            {{ function_prefix }}__sort3(begin + half, begin, end - 1);\n"
+        "        }\n"
+        "\n"
+        "        // The element before this range was a pivot at some point. If it's\n"
+        "        // equal to this pivot, then everything equal to the pivot is done\n"
+        "        if (!leftmost && !{{ function_prefix }}__less(begin - 1, begin))\n"
+        "        {\n"
+        "            begin = {{ function_prefix }}__partition_left(begin, end) + 1;\n"
+        "            continue;\n"
+        "        }\n"
+        "\n"
+        "        bool already_partitioned = false;\n"
+        "        {{ value_type_name }}* pivot_position = {{ function_prefix }}__partition_right(\n"
+        "            begin,\n"
+        "            end,\n"
+        "            &already_partitioned\n"
+        "        );\n"
+        "\n"
+        "        int64_t left_size = pivot_position - begin;\n"
+        "        int64_t right_size = end - (pivot_position + 1);\n"
+        "        bool highly_unbalanced = left_size < size / 8 || right_size < size / 8;\n"
+        "\n"
+        "        if (highly_unbalanced)\n"
+        "        {\n"
+        "            // Too many bad pivots means the input is likely adversarial\n"
+        "            if (--bad_allowed == 0)\n"
+        "            {\n"
+        "                {{ function_prefix }}__heap_sort(begin, end);\n"
+        "                return;\n"
+        "            }\n"
+        "\n"
+        "            // Shuffle a few elements around to break up whatever pattern\n"
+        "            // caused the bad partition\n"
+        "            if (left_size >= {{ function_prefix }}__INSERTION_SORT_THRESHOLD)\n"
+        "            {\n"
+        "                {{ function_prefix }}__swap(begin, begin + left_size / 4);\n"
+        "                {{ function_prefix }}__swap(pivot_position - 1, pivot_position - left_size / 4);\n"
+        "\n"
+        "                if (left_size > {{ function_prefix }}__NINTHER_THRESHOLD)\n"
+        "                {\n"
+        "                    {{ function_prefix }}__swap(begin + 1, begin + (left_size / 4 + 1));\n"
+        "                    {{ function_prefix }}__swap(begin + 2, begin + (left_size / 4 + 2));\n"
+        "                    {{ function_prefix }}__swap(pivot_position - 2, pivot_position - (left_size / 4 + 1));\n"
+        "                    {{ function_prefix }}__swap(pivot_position - 3, pivot_position - (left_size / 4 + 2));\n"
+        "                }\n"
+        "            }\n"
+        "\n"
+        "            if (right_size >= {{ function_prefix }}__INSERTION_SORT_THRESHOLD)\n"
+        "            {\n"
+        "                {{ function_prefix }}__swap(pivot_position + 1, pivot_position + (1 + right_size / 4));\n"
+        "                {{ function_prefix }}__swap(end - 1, end - right_size / 4);\n"
+        "\n"
+        "                if (right_size > {{ function_prefix }}__NINTHER_THRESHOLD)\n"
+        "                {\n"
+        "                    {{ function_prefix }}__swap(pivot_position + 2, pivot_position + (2 + right_size / 4));\n"
+        "                    {{ function_prefix }}__swap(pivot_position + 3, pivot_position + (3 + right_size / 4));\n"
+        "                    {{ function_prefix }}__swap(end - 2, end - (1 + right_size / 4));\n"
+        "                    {{ function_prefix }}__swap(end - 3, end - (2 + right_size / 4));\n"
+        "                }\n"
+        "            }\n"
+        "        }\n"
+        "        else if (\n"
+        "            already_partitioned\n"
+        "            && {{ function_prefix }}__partial_insertion_sort(begin, pivot_position)\n"
+        "            && {{ function_prefix }}__partial_insertion_sort(pivot_position + 1, end)\n"
+        "        )\n"
+        "        {\n"
+        "            return;\n"
+        "        }\n"
+        "\n"
+        "        {{ function_prefix }}__pdqsort_loop(begin, pivot_position, bad_allowed, leftmost);\n"
+        "        begin = pivot_position + 1;\n"
+        "        leftmost = false;\n"
+        "    }\n"
+        "}\n"
+        "\n"
+        "void {{ function_prefix }}_sort(\n"
+        "    {{ array_type_name }}* array\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        array == NULL\n"
+        "        || array->sentinel != PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        || array->length < 2\n"
+        "    )\n"
+        "        return;\n"
+        "\n"
+        "    {{ function_prefix }}__pdqsort_loop(\n"
+        "        array->data,\n"
+        "        array->data + array->length,\n"
+        "        {{ function_prefix }}__log2(array->length),\n"
+        "        true\n"
+        "    );\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_nth_element(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t nth\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && nth > -1\n"
+        "        && nth < array->length\n"
+        "    );\n"
+        "\n"
+        "    if (!res)\n"
+        "        return res;\n"
+        "\n"
+        "    {{ value_type_name }}* begin = array->data;\n"
+        "    {{ value_type_name }}* end = array->data + array->length;\n"
+        "    {{ value_type_name }}* target = array->data + nth;\n"
+        "    int32_t bad_allowed = {{ function_prefix }}__log2(array->length);\n"
+        "\n"
+        "    // Quickselect with the same partition as the sort, only following the\n"
+        "    // side that holds the target\n"
+        "    while (end - begin > {{ function_prefix }}__INSERTION_SORT_THRESHOLD)\n"
+        "    {\n"
+        "        int64_t size = end - begin;\n"
+        "        {{ function_prefix }}__sort3(begin + size / 2, begin, end - 1);\n"
+        "\n"
+        "        bool already_partitioned = false;\n"
+        "        {{ value_type_name }}* pivot_position = {{ function_prefix }}__partition_right(\n"
+        "            begin,\n"
+        "            end,\n"
+        "            &already_partitioned\n"
+        "        );\n"
+        "\n"
+        "        int64_t left_size = pivot_position - begin;\n"
+        "        int64_t right_size = end - (pivot_position + 1);\n"
+        "        if ((left_size < size / 8 || right_size < size / 8) && --bad_allowed == 0)\n"
+        "        {\n"
+        "            // Sorting what's left keeps the worst case at O(n log n)\n"
+        "            {{ function_prefix }}__pdqsort_loop(begin, end, {{ function_prefix }}__log2(size), true);\n"
+        "            return res;\n"
+        "        }\n"
+        "\n"
+        "        if (pivot_position == target)\n"
+        "            return res;\n"
+        "        else if (target < pivot_position)\n"
+        "            end = pivot_position;\n"
+        "        else\n"
+        "            begin = pivot_position + 1;\n"
+        "    }\n"
+        "\n"
+        "    {{ function_prefix }}__insertion_sort(begin, end);\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "bool {{ function_prefix }}_partial_sort(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    int64_t count\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "        && count > -1\n"
+        "    );\n"
+        "\n"
+        "    if (!res || count == 0)\n"
+        "        return res;\n"
+        "\n"
+        "    if (count >= array->length)\n"
+        "    {\n"
+        "        {{ function_prefix }}_sort(array);\n"
+        "        return res;\n"
+        "    }\n"
+        "\n"
+        "    // Everything before the (count - 1)th element is not greater than it,\n"
+        "    // so only that prefix is left to sort\n"
+        "    {{ function_prefix }}_nth_element(array, count - 1);\n"
+        "    {{ function_prefix }}__pdqsort_loop(\n"
+        "        array->data,\n"
+        "        array->data + (count - 1),\n"
+        "        {{ function_prefix }}__log2(count),\n"
+        "        true\n"
+        "    );\n"
+        "\n"
+        "    return res;\n"
+        "}\n"
+        "\n"
+        "int64_t {{ function_prefix }}_lower_bound(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    const {{ value_type_name }}* value\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        array == NULL\n"
+        "        || value == NULL\n"
+        "        || array->sentinel != PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "    )\n"
+        "        return -1;\n"
+        "\n"
+        "    if (array->length == 0)\n"
+        "        return 0;\n"
+        "\n"
+        "    // Halve the window every step without a data dependent branch, so\n"
+        "    // the compiler can use a conditional move instead of mispredicting\n"
+        "    const {{ value_type_name }}* base = array->data;\n"
+        "    int64_t length = array->length;\n"
+        "    while (length > 1)\n"
+        "    {\n"
+        "        int64_t half = length / 2;\n"
+        "        base = {{ function_prefix }}__less(&base[half], value) ? base + half : base;\n"
+        "        length -= half;\n"
+        "    }\n"
+        "\n"
+        "    return (base - array->data) + ({{ function_prefix }}__less(base, value) ? 1 : 0);\n"
+        "}\n"
+        "\n"
+        "int64_t {{ function_prefix }}_upper_bound(\n"
+        "    {{ array_type_name }}* array,\n"
+        "    const {{ value_type_name }}* value\n"
+        ")\n"
+        "{\n"
+        "    if (\n"
+        "        array == NULL\n"
+        "        || value == NULL\n"
+        "        || array->sentinel != PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "    )\n"
+        "        return -1;\n"
+        "\n"
+        "    if (array->length == 0)\n"
+        "        return 0;\n"
+        "\n"
+        "    const {{ value_type_name }}* base = array->data;\n"
+        "    int64_t length = array->length;\n"
+        "    while (length > 1)\n"
+        "    {\n"
+        "        int64_t half = length / 2;\n"
+        "        base = !{{ function_prefix }}__less(value, &base[half]) ? base + half : base;\n"
+        "        length -= half;\n"
+        "    }\n"
+        "\n"
+        "    return (base - array->data) + (!{{ function_prefix }}__less(value, base) ? 1 : 0);\n"
+        "}\n"
+        "{{ radix_definition }}"
+    );
+
+    static JSLImmutableMemory radix_sort_header_template = JSL_CSTR_INITIALIZER(
+        "\n"
+        "/**\n"
+        " * Sort the array in place with a least significant digit radix sort on\n"
+        " * `{{ key_description }}`. This is O(n) and stable, and it's usually the\n"
+        " * fastest option for large arrays of numeric keys. The order matches\n"
+        " * `{{ function_prefix }}_sort` except that for floating point keys negative zero\n"
+        " * sorts before positive zero and NaNs sort by their bit patterns to either end.\n"
+        " *\n"
+        " * Passes for bytes which are the same in every key are skipped, so small\n"
+        " * values in a wide key type only pay for the bytes they use.\n"
+        " *\n"
+        " * A scratch buffer the size of the array is allocated from the array's\n"
+        " * allocator for the duration of the call.\n"
+        " *\n"
+        " * @param array The pointer to the array\n"
+        " * @returns false on invalid parameters or if the scratch allocation failed\n"
+        " */\n"
+        "bool {{ function_prefix }}_radix_sort(\n"
+        "    {{ array_type_name }}* array\n"
+        ");\n"
+    );
+
+    static JSLImmutableMemory radix_sort_source_template = JSL_CSTR_INITIALIZER(
+        "\n"
+        "/**\n"
+        " * Map the sort key to an unsigned integer which has the same order, so the\n"
+        " * radix sort can treat every key as plain bytes.\n"
+        " */\n"
+        "static inline {{ radix_unsigned_type }} {{ function_prefix }}__radix_key(\n"
+        "    const {{ value_type_name }}* value\n"
+        ")\n"
+        "{\n"
+        "    {{ key_type_name }} key = {{ key_expression }};\n"
+        "{{ radix_key_body }}}\n"
+        "\n"
+        "bool {{ function_prefix }}_radix_sort(\n"
+        "    {{ array_type_name }}* array\n"
+        ")\n"
+        "{\n"
+        "    bool res = (\n"
+        "        array != NULL\n"
+        "        && array->sentinel == PRIVATE_SENTINEL_{{ array_type_name }}\n"
+        "    );\n"
+        "\n"
+        "    if (!res || array->length < 2)\n"
+        "        return res;\n"
+        "\n"
+        "    {{ value_type_name }}* scratch = ({{ value_type_name }}*) jsl_allocator_interface_alloc(\n"
+        "        array->allocator,\n"
+        "        ((int64_t) sizeof({{ value_type_name }})) * array->length,\n"
+        "        (int32_t) _Alignof({{ value_type_name }}),\n"
+        "        false\n"
+        "    );\n"
+        "    if (scratch == NULL)\n"
+        "        return false;\n"
+        "\n"
+        "    // Every byte's histogram is filled in one read of the array\n"
+        "    int64_t counts[sizeof({{ key_type_name }})][256];\n"
+        "    JSL_MEMSET(counts, 0, sizeof(counts));\n"
+        "\n"
+        "    for (int64_t i = 0; i < array->length; ++i)\n"
+        "    {\n"
+        "        {{ radix_unsigned_type }} key = {{ function_prefix }}__radix_key(&array->data[i]);\n"
+        "        for (int32_t byte = 0; byte < (int32_t) sizeof({{ key_type_name }}); ++byte)\n"
+        "        {\n"
+        "            ++counts[byte][(key >> (byte * 8)) & 0xFF];\n"
+        "        }\n"
+        "    }\n"
+        "\n"
+        "    {{ value_type_name }}* from = array->data;\n"
+        "    {{ value_type_name }}* to = scratch;\n"
+        "\n"
+        "    for (int32_t byte = 0; byte < (int32_t) sizeof({{ key_type_name }}); ++byte)\n"
+        "    {\n"
+        "        int32_t shift = byte * 8;\n"
+        "\n"
+        "        // When every key has the same value in this byte the pass wouldn't\n"
+        "        // change the order\n"
+        "        {{ radix_unsigned_type }} first_key = {{ function_prefix }}__radix_key(&from[0]);\n"
+        "        if (counts[byte][(first_key >> shift) & 0xFF] == array->length)\n"
+        "            continue;\n"
+        "\n"
+        "        int64_t offsets[256];\n"
+        "        int64_t total = 0;\n"
+        "        for (int32_t digit = 0; digit < 256; ++digit)\n"
+        "        {\n"
+        "            offsets[digit] = total;\n"
+        "            total += counts[byte][digit];\n"
+        "        }\n"
+        "\n"
+        "        for (int64_t i = 0; i < array->length; ++i)\n"
+        "        {\n"
+        "            {{ radix_unsigned_type }} key = {{ function_prefix }}__radix_key(&from[i]);\n"
+        "            to[offsets[(key >> shift) & 0xFF]++] = from[i];\n"
+        "        }\n"
+        "\n"
+        "        {{ value_type_name }}* tmp = from;\n"
+        "        from = to;\n"
+        "        to = tmp;\n"
+        "    }\n"
+        "\n"
+        "    if (from != array->data)\n"
+        "        JSL_MEMCPY(array->data, from, sizeof({{ value_type_name }}) * (size_t) array->length);\n"
+        "\n"
+        "    jsl_allocator_interface_free(array->allocator, scratch);\n"
+        "    return res;\n"
+        "}\n"
+    );
+
+    static JSLImmutableMemory array_type_name_key = JSL_CSTR_INITIALIZER("array_type_name");
+    static JSLImmutableMemory value_type_name_key = JSL_CSTR_INITIALIZER("value_type_name");
+    static JSLImmutableMemory function_prefix_key = JSL_CSTR_INITIALIZER("function_prefix");
+    static JSLImmutableMemory first_field_name_key = JSL_CSTR_INITIALIZER("first_field_name");
+
+    // because rand max on some platforms is 32k
+    static inline uint64_t rand_u64(void)
+    {
+        uint64_t value = 0;
+
+        value = (value << 8) | (uint64_t)(rand() & 0xFF);
+        value = (value << 8) | (uint64_t)(rand() & 0xFF);
+        value = (value << 8) | (uint64_t)(rand() & 0xFF);
+        value = (value << 8) | (uint64_t)(rand() & 0xFF);
+        value = (value << 8) | (uint64_t)(rand() & 0xFF);
+        value = (value << 8) | (uint64_t)(rand() & 0xFF);
+        value = (value << 8) | (uint64_t)(rand() & 0xFF);
+        value = (value << 8) | (uint64_t)(rand() & 0xFF);
+
+        return value;
+    }
+
+    static void render_template(
+        JSLOutputSink sink,
+        JSLImmutableMemory template,
+        JSLStrToStrMap* variables
+    )
+    {
+        static JSLImmutableMemory open_param = JSL_CSTR_INITIALIZER("{{");
+        static JSLImmutableMemory close_param = JSL_CSTR_INITIALIZER("}}");
+        JSLImmutableMemory template_reader = template;
+        
+        while (template_reader.length > 0)
+        {
+            int64_t index_of_open = jsl_substring_search(template_reader, open_param);
+
+            // No more variables, write everything
+            if (index_of_open == -1)
+            {
+                jsl_output_sink_write(sink, template_reader);
+                break;
+            }
+
+            if (index_of_open > 0)
+            {
+                JSLImmutableMemory slice = jsl_slice(template_reader, 0, index_of_open);
+                jsl_output_sink_write(sink, slice);
+            }
+
+            JSL_MEMORY_ADVANCE(template_reader, index_of_open + open_param.length);
+
+            int64_t index_of_close = jsl_substring_search(template_reader, close_param);
+
+            // Improperly closed template param, write everything including the open marker
+            if (index_of_close == -1)
+            {
+                jsl_output_sink_write(sink, open_param);
+                jsl_output_sink_write(sink, template_reader);
+                break;
+            }
+
+            JSLImmutableMemory var_name = jsl_slice(template_reader, 0, index_of_close);
+            jsl_strip_whitespace(&var_name);
+
+            JSLImmutableMemory var_value;
+            if (jsl_str_to_str_map_get(variables, var_name, &var_value))
+            {
+                jsl_output_sink_write(sink, var_value);
+            }
+
+            JSL_MEMORY_ADVANCE(template_reader, index_of_close + close_param.length);
+        }
+    }
+
+    /**
+     * Generates the header file data for your hash map. This file includes all the typedefs
+     * and function signatures for this hash map.
+     *
+     * The generated header file includes "jacks_hash_map.h", and it's assumed to be in the
      * same directory as where this header file will live.
      *
      * If your type needs a custom hash function, it must have the function signature
@@ -692,12 +4191,678 @@
      * @param include_header_count Number of additional header files to include in the generated header.
      * @param include_header_count Number of additional header files to include in the generated header.
 
-    * @return JSLImmutableMemory containing the generated header file content
-    *
-    * @warning Ensure the arena has sufficient space (minimum 512KB recommended) to avoid
-    *          allocation failures during header generation.
-    */
-    GENERATE_ARRAY_DEF void write_array_header(
+    * @return JSLImmutableMemory containing the generated header file content
+    *
+    * @warning Ensure the arena has sufficient space (minimum 512KB recommended) to avoid
+    *          allocation failures during header generation.
+    */
+    GENERATE_ARRAY_DEF void write_array_header(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        ArrayImplementation impl,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    )
+    {
+        (void) impl;
+        srand((uint32_t) (time(NULL) % UINT32_MAX));
+
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#pragma once\n\n"));
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// DEFAULT INCLUDED HEADERS\n")
+        );
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#include <stdint.h>\n"));
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#include \"jsl/hash_map_common.h\"\n\n"));
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// USER INCLUDED HEADERS\n")
+        );
+
+        for (int32_t i = 0; i < include_header_count; ++i)
+        {
+            jsl_format_sink(sink, JSL_CSTR_EXPRESSION("#include \"%y\"\n"), include_header_array[i]);
+        }
+
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("\n"));
+        
+        jsl_format_sink(
+            sink,
+            JSL_CSTR_EXPRESSION("#define PRIVATE_SENTINEL_%y %" PRIu64 "U \n"),
+            array_type_name,
+            rand_u64()
+        );
+
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("\n"));
+
+        JSLStrToStrMap map;
+        jsl_str_to_str_map_init(&map, allocator, 0x123456789);
+
+        jsl_str_to_str_map_insert(
+            &map,
+            array_type_name_key,
+            JSL_STRING_LIFETIME_LONGER,
+            array_type_name,
+            JSL_STRING_LIFETIME_LONGER
+        );
+        jsl_str_to_str_map_insert(
+            &map,
+            value_type_name_key,
+            JSL_STRING_LIFETIME_LONGER,
+            value_type_name,
+            JSL_STRING_LIFETIME_LONGER
+        );
+        jsl_str_to_str_map_insert(
+            &map,
+            function_prefix_key,
+            JSL_STRING_LIFETIME_LONGER,
+            function_prefix,
+            JSL_STRING_LIFETIME_LONGER
+        );
+
+        // if (impl == IMPL_FIXED)
+        //     render_template(sink, fixed_header_template, &map);
+        // else if (impl == IMPL_DYNAMIC)
+            render_template(sink, dynamic_header_template, &map);
+        // else
+        //     assert(0);
+    }
+
+    GENERATE_ARRAY_DEF void write_array_source(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        ArrayImplementation impl,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    )
+    {
+        (void) impl;
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// DEFAULT INCLUDED HEADERS\n")
+        );
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("#include <stddef.h>\n")
+        );
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("#include <stdint.h>\n")
+        );
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("#include \"jsl/core.h\"\n")
+        );
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// USER INCLUDED HEADERS\n")
+        );
+
+        for (int32_t i = 0; i < include_header_count; ++i)
+        {
+            jsl_format_sink(sink, JSL_CSTR_EXPRESSION("#include \"%y\"\n"), include_header_array[i]);
+        }
+
+        jsl_format_sink(sink, JSL_CSTR_EXPRESSION("\n"));
+
+        JSLStrToStrMap map;
+        jsl_str_to_str_map_init(&map, allocator, 0x123456789);
+
+        jsl_str_to_str_map_insert(
+            &map,
+            array_type_name_key,
+            JSL_STRING_LIFETIME_LONGER,
+            array_type_name,
+            JSL_STRING_LIFETIME_LONGER
+        );
+        jsl_str_to_str_map_insert(
+            &map,
+            value_type_name_key,
+            JSL_STRING_LIFETIME_LONGER,
+            value_type_name,
+            JSL_STRING_LIFETIME_LONGER
+        );
+        jsl_str_to_str_map_insert(
+            &map,
+            function_prefix_key,
+            JSL_STRING_LIFETIME_LONGER,
+            function_prefix,
+            JSL_STRING_LIFETIME_LONGER
+        );
+
+        // if (impl == IMPL_FIXED)
+        //     render_template(sink, fixed_header_template, &map);
+        // else if (impl == IMPL_DYNAMIC)
+            render_template(sink, dynamic_source_template, &map);
+        // else
+        //     assert(0);
+    }
+
+    /**
+     * A per column piece of the structure of arrays templates. The template
+     * language has no loops, so each format is written once per field and
+     * the result is dropped into the template as a single variable.
+     */
+    typedef struct SoaFragment {
+        JSLImmutableMemory key;
+        JSLImmutableMemory format;
+    } SoaFragment;
+
+    static void write_soa_fragment(
+        JSLOutputSink sink,
+        JSLImmutableMemory format,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        ArrayField* field
+    )
+    {
+        // `$P` is the function prefix, `$A` the array type, `$N` the field
+        // name and `$T` the field type
+        static JSLImmutableMemory marker = JSL_CSTR_INITIALIZER("$");
+        JSLImmutableMemory reader = format;
+
+        while (reader.length > 0)
+        {
+            int64_t index_of_marker = jsl_substring_search(reader, marker);
+            if (index_of_marker == -1 || index_of_marker + marker.length >= reader.length)
+            {
+                jsl_output_sink_write(sink, reader);
+                break;
+            }
+
+            if (index_of_marker > 0)
+                jsl_output_sink_write(sink, jsl_slice(reader, 0, index_of_marker));
+
+            uint8_t tag = reader.data[index_of_marker + marker.length];
+            if (tag == 'P')
+                jsl_output_sink_write(sink, function_prefix);
+            else if (tag == 'A')
+                jsl_output_sink_write(sink, array_type_name);
+            else if (tag == 'N')
+                jsl_output_sink_write(sink, field->name);
+            else if (tag == 'T')
+                jsl_output_sink_write(sink, field->type_name);
+            else
+                assert(0);
+
+            JSL_MEMORY_ADVANCE(reader, index_of_marker + marker.length + 1);
+        }
+    }
+
+    static SoaFragment soa_fragments[] = {
+        {
+            JSL_CSTR_INITIALIZER("column_members"),
+            JSL_CSTR_INITIALIZER("    $T* $N;\n")
+        },
+        {
+            JSL_CSTR_INITIALIZER("column_span_list"),
+            JSL_CSTR_INITIALIZER(" *  * $P_$N_span\n")
+        },
+        {
+            JSL_CSTR_INITIALIZER("column_span_declarations"),
+            JSL_CSTR_INITIALIZER(
+                "\n"
+                "/**\n"
+                " * Get the `$N` column as a span of `array->length` values. The\n"
+                " * pointer is invalidated by anything which grows the array.\n"
+                " *\n"
+                " * @param array The pointer to the array\n"
+                " * @param out_values Set to the start of the column\n"
+                " * @param out_length Set to the number of values in the column\n"
+                " * @returns false on invalid parameters\n"
+                " */\n"
+                "bool $P_$N_span(\n"
+                "    $A* array,\n"
+                "    $T** out_values,\n"
+                "    int64_t* out_length\n"
+                ");\n"
+            )
+        },
+        {
+            JSL_CSTR_INITIALIZER("column_span_definitions"),
+            JSL_CSTR_INITIALIZER(
+                "\n"
+                "bool $P_$N_span(\n"
+                "    $A* array,\n"
+                "    $T** out_values,\n"
+                "    int64_t* out_length\n"
+                ")\n"
+                "{\n"
+                "    bool res = (\n"
+                "        array != NULL\n"
+                "        && array->sentinel == PRIVATE_SENTINEL_$A\n"
+                "        && out_values != NULL\n"
+                "        && out_length != NULL\n"
+                "    );\n"
+                "\n"
+                "    if (res)\n"
+                "    {\n"
+                "        *out_values = array->$N;\n"
+                "        *out_length = array->length;\n"
+                "    }\n"
+                "\n"
+                "    return res;\n"
+                "}\n"
+            )
+        },
+        {
+            JSL_CSTR_INITIALIZER("column_block_bytes"),
+            JSL_CSTR_INITIALIZER("    bytes += $P__column_bytes((int64_t) sizeof($T) * capacity);\n")
+        },
+        {
+            JSL_CSTR_INITIALIZER("column_relocate"),
+            JSL_CSTR_INITIALIZER(
+                "    $T* new_$N = ($T*) cursor;\n"
+                "    cursor += $P__column_bytes((int64_t) sizeof($T) * target_capacity);\n"
+                "    if (array->length > 0)\n"
+                "        JSL_MEMCPY(new_$N, array->$N, sizeof($T) * (size_t) array->length);\n"
+                "    array->$N = new_$N;\n"
+                "\n"
+            )
+        },
+        {
+            JSL_CSTR_INITIALIZER("column_store"),
+            JSL_CSTR_INITIALIZER("        array->$N[index] = value.$N;\n")
+        },
+        {
+            JSL_CSTR_INITIALIZER("column_store_multiple"),
+            JSL_CSTR_INITIALIZER(
+                "        for (int64_t i = 0; i < value_count; ++i)\n"
+                "            array->$N[array->length + i] = values[i].$N;\n"
+            )
+        },
+        {
+            JSL_CSTR_INITIALIZER("column_load"),
+            JSL_CSTR_INITIALIZER("        out_value->$N = array->$N[index];\n")
+        },
+        {
+            JSL_CSTR_INITIALIZER("column_move"),
+            JSL_CSTR_INITIALIZER(
+                "        JSL_MEMMOVE(\n"
+                "            array->$N + index,\n"
+                "            array->$N + index + 1,\n"
+                "            (size_t) items_to_move * sizeof($T)\n"
+                "        );\n"
+            )
+        }
+    };
+
+    static void insert_soa_variables(
+        JSLAllocatorInterface allocator,
+        JSLStrToStrMap* map,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        ArrayField* field_array,
+        int32_t field_count
+    )
+    {
+        jsl_str_to_str_map_insert(
+            map,
+            array_type_name_key,
+            JSL_STRING_LIFETIME_LONGER,
+            array_type_name,
+            JSL_STRING_LIFETIME_LONGER
+        );
+        jsl_str_to_str_map_insert(
+            map,
+            value_type_name_key,
+            JSL_STRING_LIFETIME_LONGER,
+            value_type_name,
+            JSL_STRING_LIFETIME_LONGER
+        );
+        jsl_str_to_str_map_insert(
+            map,
+            function_prefix_key,
+            JSL_STRING_LIFETIME_LONGER,
+            function_prefix,
+            JSL_STRING_LIFETIME_LONGER
+        );
+        jsl_str_to_str_map_insert(
+            map,
+            first_field_name_key,
+            JSL_STRING_LIFETIME_LONGER,
+            field_array[0].name,
+            JSL_STRING_LIFETIME_LONGER
+        );
+
+        int32_t fragment_count = (int32_t) (sizeof(soa_fragments) / sizeof(SoaFragment));
+        for (int32_t fragment_idx = 0; fragment_idx < fragment_count; ++fragment_idx)
+        {
+            JSLStringBuilder builder;
+            jsl_string_builder_init(&builder, allocator, 1024);
+            JSLOutputSink builder_sink = jsl_string_builder_output_sink(&builder);
+
+            for (int32_t field_idx = 0; field_idx < field_count; ++field_idx)
+            {
+                write_soa_fragment(
+                    builder_sink,
+                    soa_fragments[fragment_idx].format,
+                    array_type_name,
+                    function_prefix,
+                    &field_array[field_idx]
+                );
+            }
+
+            jsl_str_to_str_map_insert(
+                map,
+                soa_fragments[fragment_idx].key,
+                JSL_STRING_LIFETIME_LONGER,
+                jsl_string_builder_get_string(&builder),
+                JSL_STRING_LIFETIME_LONGER
+            );
+        }
+    }
+
+    GENERATE_ARRAY_DEF void write_soa_array_header(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        ArrayField* field_array,
+        int32_t field_count,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    )
+    {
+        assert(field_array != NULL && field_count > 0);
+        srand((uint32_t) (time(NULL) % UINT32_MAX));
+
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#pragma once\n\n"));
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// DEFAULT INCLUDED HEADERS\n")
+        );
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#include <stdint.h>\n"));
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#include \"jsl/hash_map_common.h\"\n\n"));
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// USER INCLUDED HEADERS\n")
+        );
+
+        for (int32_t i = 0; i < include_header_count; ++i)
+        {
+            jsl_format_sink(sink, JSL_CSTR_EXPRESSION("#include \"%y\"\n"), include_header_array[i]);
+        }
+
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("\n"));
+        
+        jsl_format_sink(
+            sink,
+            JSL_CSTR_EXPRESSION("#define PRIVATE_SENTINEL_%y %" PRIu64 "U \n"),
+            array_type_name,
+            rand_u64()
+        );
+
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("\n"));
+
+        JSLStrToStrMap map;
+        jsl_str_to_str_map_init(&map, allocator, 0x123456789);
+
+        insert_soa_variables(
+            allocator,
+            &map,
+            array_type_name,
+            function_prefix,
+            value_type_name,
+            field_array,
+            field_count
+        );
+
+        render_template(sink, soa_header_template, &map);
+    }
+
+    GENERATE_ARRAY_DEF void write_soa_array_source(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        ArrayField* field_array,
+        int32_t field_count,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    )
+    {
+        assert(field_array != NULL && field_count > 0);
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// DEFAULT INCLUDED HEADERS\n")
+        );
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("#include <stddef.h>\n")
+        );
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("#include <stdint.h>\n")
+        );
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("#include \"jsl/core.h\"\n")
+        );
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// USER INCLUDED HEADERS\n")
+        );
+
+        for (int32_t i = 0; i < include_header_count; ++i)
+        {
+            jsl_format_sink(sink, JSL_CSTR_EXPRESSION("#include \"%y\"\n"), include_header_array[i]);
+        }
+
+        jsl_format_sink(sink, JSL_CSTR_EXPRESSION("\n"));
+
+        JSLStrToStrMap map;
+        jsl_str_to_str_map_init(&map, allocator, 0x123456789);
+
+        insert_soa_variables(
+            allocator,
+            &map,
+            array_type_name,
+            function_prefix,
+            value_type_name,
+            field_array,
+            field_count
+        );
+
+        render_template(sink, soa_source_template, &map);
+    }
+
+    static void insert_segmented_variables(
+        JSLAllocatorInterface allocator,
+        JSLStrToStrMap* map,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        int64_t block_length
+    )
+    {
+        static JSLImmutableMemory block_shift_key = JSL_CSTR_INITIALIZER("block_shift");
+        static JSLImmutableMemory block_length_key = JSL_CSTR_INITIALIZER("block_length");
+
+        int32_t block_shift = 0;
+        while (((int64_t) 1 << block_shift) < block_length)
+            ++block_shift;
+
+        JSLImmutableMemory block_shift_str = jsl_format(
+            allocator,
+            JSL_CSTR_EXPRESSION("%d"),
+            block_shift
+        );
+        JSLImmutableMemory block_length_str = jsl_format(
+            allocator,
+            JSL_CSTR_EXPRESSION("%" PRId64),
+            block_length
+        );
+
+        jsl_str_to_str_map_insert(map, array_type_name_key, JSL_STRING_LIFETIME_LONGER, array_type_name, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(map, value_type_name_key, JSL_STRING_LIFETIME_LONGER, value_type_name, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(map, function_prefix_key, JSL_STRING_LIFETIME_LONGER, function_prefix, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(map, block_shift_key, JSL_STRING_LIFETIME_LONGER, block_shift_str, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(map, block_length_key, JSL_STRING_LIFETIME_LONGER, block_length_str, JSL_STRING_LIFETIME_LONGER);
+    }
+
+    GENERATE_ARRAY_DEF void write_segmented_array_header(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        int64_t block_length,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    )
+    {
+        assert(block_length > 0 && (block_length & (block_length - 1)) == 0);
+        srand((uint32_t) (time(NULL) % UINT32_MAX));
+
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#pragma once\n\n"));
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// DEFAULT INCLUDED HEADERS\n")
+        );
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#include <stdint.h>\n"));
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#include \"jsl/hash_map_common.h\"\n\n"));
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// USER INCLUDED HEADERS\n")
+        );
+
+        for (int32_t i = 0; i < include_header_count; ++i)
+        {
+            jsl_format_sink(sink, JSL_CSTR_EXPRESSION("#include \"%y\"\n"), include_header_array[i]);
+        }
+
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("\n"));
+        
+        jsl_format_sink(
+            sink,
+            JSL_CSTR_EXPRESSION("#define PRIVATE_SENTINEL_%y %" PRIu64 "U \n"),
+            array_type_name,
+            rand_u64()
+        );
+
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("\n"));
+
+        JSLStrToStrMap map;
+        jsl_str_to_str_map_init(&map, allocator, 0x123456789);
+
+        insert_segmented_variables(
+            allocator,
+            &map,
+            array_type_name,
+            function_prefix,
+            value_type_name,
+            block_length
+        );
+
+        render_template(sink, segmented_header_template, &map);
+    }
+
+    GENERATE_ARRAY_DEF void write_segmented_array_source(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        int64_t block_length,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    )
+    {
+        assert(block_length > 0 && (block_length & (block_length - 1)) == 0);
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// DEFAULT INCLUDED HEADERS\n")
+        );
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("#include <stddef.h>\n")
+        );
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("#include <stdint.h>\n")
+        );
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("#include \"jsl/core.h\"\n")
+        );
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// USER INCLUDED HEADERS\n")
+        );
+
+        for (int32_t i = 0; i < include_header_count; ++i)
+        {
+            jsl_format_sink(sink, JSL_CSTR_EXPRESSION("#include \"%y\"\n"), include_header_array[i]);
+        }
+
+        jsl_format_sink(sink, JSL_CSTR_EXPRESSION("\n"));
+
+        JSLStrToStrMap map;
+        jsl_str_to_str_map_init(&map, allocator, 0x123456789);
+
+        insert_segmented_variables(
+            allocator,
+            &map,
+            array_type_name,
+            function_prefix,
+            value_type_name,
+            block_length
+        );
+
+        render_template(sink, segmented_source_template, &map);
+    }
+
+    static void insert_ring_variables(
+        JSLStrToStrMap* map,
+        ArrayImplementation impl,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name
+    )
+    {
+        static JSLImmutableMemory can_grow_key = JSL_CSTR_INITIALIZER("can_grow");
+        static JSLImmutableMemory growth_description_key = JSL_CSTR_INITIALIZER("growth_description");
+
+        JSLImmutableMemory can_grow = impl == IMPL_DYNAMIC
+            ? JSL_CSTR_EXPRESSION("1")
+            : JSL_CSTR_EXPRESSION("0");
+        JSLImmutableMemory growth_description = impl == IMPL_DYNAMIC
+            ? JSL_CSTR_EXPRESSION("When the ring is full a push reallocates it at double the capacity.")
+            : JSL_CSTR_EXPRESSION("The ring never allocates after init, a push to a full ring fails.");
+
+        jsl_str_to_str_map_insert(map, array_type_name_key, JSL_STRING_LIFETIME_LONGER, array_type_name, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(map, value_type_name_key, JSL_STRING_LIFETIME_LONGER, value_type_name, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(map, function_prefix_key, JSL_STRING_LIFETIME_LONGER, function_prefix, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(map, can_grow_key, JSL_STRING_LIFETIME_LONGER, can_grow, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(map, growth_description_key, JSL_STRING_LIFETIME_LONGER, growth_description, JSL_STRING_LIFETIME_LONGER);
+    }
+
+    GENERATE_ARRAY_DEF void write_ring_array_header(
         JSLAllocatorInterface allocator,
         JSLOutputSink sink,
         ArrayImplementation impl,
@@ -708,7 +4873,7 @@
         int32_t include_header_count
     )
     {
-        (void) impl;
+        assert(impl == IMPL_FIXED || impl == IMPL_DYNAMIC);
         srand((uint32_t) (time(NULL) % UINT32_MAX));
 
         jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#pragma once\n\n"));
@@ -744,37 +4909,18 @@
         JSLStrToStrMap map;
         jsl_str_to_str_map_init(&map, allocator, 0x123456789);
 
-        jsl_str_to_str_map_insert(
+        insert_ring_variables(
             &map,
-            array_type_name_key,
-            JSL_STRING_LIFETIME_LONGER,
+            impl,
             array_type_name,
-            JSL_STRING_LIFETIME_LONGER
-        );
-        jsl_str_to_str_map_insert(
-            &map,
-            value_type_name_key,
-            JSL_STRING_LIFETIME_LONGER,
-            value_type_name,
-            JSL_STRING_LIFETIME_LONGER
-        );
-        jsl_str_to_str_map_insert(
-            &map,
-            function_prefix_key,
-            JSL_STRING_LIFETIME_LONGER,
             function_prefix,
-            JSL_STRING_LIFETIME_LONGER
+            value_type_name
         );
 
-        // if (impl == IMPL_FIXED)
-        //     render_template(sink, fixed_header_template, &map);
-        // else if (impl == IMPL_DYNAMIC)
-            render_template(sink, dynamic_header_template, &map);
-        // else
-        //     assert(0);
+        render_template(sink, ring_header_template, &map);
     }
 
-    GENERATE_ARRAY_DEF void write_array_source(
+    GENERATE_ARRAY_DEF void write_ring_array_source(
         JSLAllocatorInterface allocator,
         JSLOutputSink sink,
         ArrayImplementation impl,
@@ -785,7 +4931,7 @@
         int32_t include_header_count
     )
     {
-        (void) impl;
+        assert(impl == IMPL_FIXED || impl == IMPL_DYNAMIC);
 
         jsl_output_sink_write(
             sink,
@@ -820,34 +4966,373 @@
         JSLStrToStrMap map;
         jsl_str_to_str_map_init(&map, allocator, 0x123456789);
 
-        jsl_str_to_str_map_insert(
+        insert_ring_variables(
             &map,
-            array_type_name_key,
-            JSL_STRING_LIFETIME_LONGER,
+            impl,
             array_type_name,
-            JSL_STRING_LIFETIME_LONGER
+            function_prefix,
+            value_type_name
         );
-        jsl_str_to_str_map_insert(
-            &map,
-            value_type_name_key,
-            JSL_STRING_LIFETIME_LONGER,
-            value_type_name,
-            JSL_STRING_LIFETIME_LONGER
+
+        render_template(sink, ring_source_template, &map);
+    }
+
+    GENERATE_ARRAY_DEF void write_queue_header(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        ArrayQueueKind kind,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    )
+    {
+        assert(kind == QUEUE_SPSC || kind == QUEUE_MPMC);
+        srand((uint32_t) (time(NULL) % UINT32_MAX));
+
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#pragma once\n\n"));
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// DEFAULT INCLUDED HEADERS\n")
         );
-        jsl_str_to_str_map_insert(
-            &map,
-            function_prefix_key,
-            JSL_STRING_LIFETIME_LONGER,
-            function_prefix,
-            JSL_STRING_LIFETIME_LONGER
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#include <stdint.h>\n"));
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#include \"jsl/hash_map_common.h\"\n\n"));
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// USER INCLUDED HEADERS\n")
         );
 
-        // if (impl == IMPL_FIXED)
-        //     render_template(sink, fixed_header_template, &map);
-        // else if (impl == IMPL_DYNAMIC)
-            render_template(sink, dynamic_source_template, &map);
-        // else
-        //     assert(0);
+        for (int32_t i = 0; i < include_header_count; ++i)
+        {
+            jsl_format_sink(sink, JSL_CSTR_EXPRESSION("#include \"%y\"\n"), include_header_array[i]);
+        }
+
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("\n"));
+        
+        jsl_format_sink(
+            sink,
+            JSL_CSTR_EXPRESSION("#define PRIVATE_SENTINEL_%y %" PRIu64 "U \n"),
+            array_type_name,
+            rand_u64()
+        );
+
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("\n"));
+
+        JSLStrToStrMap map;
+        jsl_str_to_str_map_init(&map, allocator, 0x123456789);
+
+        jsl_str_to_str_map_insert(&map, array_type_name_key, JSL_STRING_LIFETIME_LONGER, array_type_name, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(&map, value_type_name_key, JSL_STRING_LIFETIME_LONGER, value_type_name, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(&map, function_prefix_key, JSL_STRING_LIFETIME_LONGER, function_prefix, JSL_STRING_LIFETIME_LONGER);
+
+        render_template(
+            sink,
+            kind == QUEUE_SPSC ? spsc_header_template : mpmc_header_template,
+            &map
+        );
+    }
+
+    GENERATE_ARRAY_DEF void write_queue_source(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        ArrayQueueKind kind,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        JSLImmutableMemory* include_header_array,
+        int32_t include_header_count
+    )
+    {
+        assert(kind == QUEUE_SPSC || kind == QUEUE_MPMC);
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// DEFAULT INCLUDED HEADERS\n")
+        );
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("#include <stddef.h>\n")
+        );
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("#include <stdint.h>\n")
+        );
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("#include \"jsl/core.h\"\n")
+        );
+
+        jsl_output_sink_write(
+            sink,
+            JSL_CSTR_EXPRESSION("// USER INCLUDED HEADERS\n")
+        );
+
+        for (int32_t i = 0; i < include_header_count; ++i)
+        {
+            jsl_format_sink(sink, JSL_CSTR_EXPRESSION("#include \"%y\"\n"), include_header_array[i]);
+        }
+
+        jsl_format_sink(sink, JSL_CSTR_EXPRESSION("\n"));
+
+        JSLStrToStrMap map;
+        jsl_str_to_str_map_init(&map, allocator, 0x123456789);
+
+        jsl_str_to_str_map_insert(&map, array_type_name_key, JSL_STRING_LIFETIME_LONGER, array_type_name, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(&map, value_type_name_key, JSL_STRING_LIFETIME_LONGER, value_type_name, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(&map, function_prefix_key, JSL_STRING_LIFETIME_LONGER, function_prefix, JSL_STRING_LIFETIME_LONGER);
+
+        render_template(
+            sink,
+            kind == QUEUE_SPSC ? spsc_source_template : mpmc_source_template,
+            &map
+        );
+    }
+
+
+    typedef struct RadixKeyInfo {
+        JSLImmutableMemory type_name;
+        JSLImmutableMemory unsigned_type_name;
+        JSLImmutableMemory body;
+    } RadixKeyInfo;
+
+    // The key types the radix sort knows how to turn into order preserving
+    // unsigned integers. Signed integers flip the sign bit so negative
+    // numbers come first, floats additionally flip every other bit of
+    // negative numbers since their magnitude bits count the wrong way.
+    static RadixKeyInfo radix_key_infos[] = {
+        {
+            JSL_CSTR_INITIALIZER("uint8_t"),
+            JSL_CSTR_INITIALIZER("uint32_t"),
+            JSL_CSTR_INITIALIZER("    return (uint32_t) key;\n")
+        },
+        {
+            JSL_CSTR_INITIALIZER("uint16_t"),
+            JSL_CSTR_INITIALIZER("uint32_t"),
+            JSL_CSTR_INITIALIZER("    return (uint32_t) key;\n")
+        },
+        {
+            JSL_CSTR_INITIALIZER("uint32_t"),
+            JSL_CSTR_INITIALIZER("uint32_t"),
+            JSL_CSTR_INITIALIZER("    return key;\n")
+        },
+        {
+            JSL_CSTR_INITIALIZER("uint64_t"),
+            JSL_CSTR_INITIALIZER("uint64_t"),
+            JSL_CSTR_INITIALIZER("    return key;\n")
+        },
+        {
+            JSL_CSTR_INITIALIZER("int8_t"),
+            JSL_CSTR_INITIALIZER("uint32_t"),
+            JSL_CSTR_INITIALIZER("    return (uint32_t) ((uint8_t) key ^ 0x80u);\n")
+        },
+        {
+            JSL_CSTR_INITIALIZER("int16_t"),
+            JSL_CSTR_INITIALIZER("uint32_t"),
+            JSL_CSTR_INITIALIZER("    return (uint32_t) ((uint16_t) key ^ 0x8000u);\n")
+        },
+        {
+            JSL_CSTR_INITIALIZER("int32_t"),
+            JSL_CSTR_INITIALIZER("uint32_t"),
+            JSL_CSTR_INITIALIZER("    return (uint32_t) key ^ 0x80000000u;\n")
+        },
+        {
+            JSL_CSTR_INITIALIZER("int64_t"),
+            JSL_CSTR_INITIALIZER("uint64_t"),
+            JSL_CSTR_INITIALIZER("    return (uint64_t) key ^ 0x8000000000000000u;\n")
+        },
+        {
+            JSL_CSTR_INITIALIZER("float"),
+            JSL_CSTR_INITIALIZER("uint32_t"),
+            JSL_CSTR_INITIALIZER(
+                "    uint32_t bits;\n"
+                "    JSL_MEMCPY(&bits, &key, sizeof(bits));\n"
+                "    return bits ^ ((uint32_t) -(int32_t) (bits >> 31) | 0x80000000u);\n"
+            )
+        },
+        {
+            JSL_CSTR_INITIALIZER("double"),
+            JSL_CSTR_INITIALIZER("uint64_t"),
+            JSL_CSTR_INITIALIZER(
+                "    uint64_t bits;\n"
+                "    JSL_MEMCPY(&bits, &key, sizeof(bits));\n"
+                "    return bits ^ ((uint64_t) -(int64_t) (bits >> 63) | 0x8000000000000000u);\n"
+            )
+        }
+    };
+
+    static RadixKeyInfo* find_radix_key_info(JSLImmutableMemory type_name)
+    {
+        int32_t info_count = (int32_t) (sizeof(radix_key_infos) / sizeof(RadixKeyInfo));
+        for (int32_t i = 0; i < info_count; ++i)
+        {
+            if (jsl_memory_compare(type_name, radix_key_infos[i].type_name))
+                return &radix_key_infos[i];
+        }
+        return NULL;
+    }
+
+    GENERATE_ARRAY_DEF bool array_sort_has_radix(
+        JSLImmutableMemory value_type_name,
+        ArraySortOptions* options
+    )
+    {
+        if (options != NULL && options->less_than_function.data != NULL)
+            return false;
+
+        JSLImmutableMemory key_type_name = value_type_name;
+        if (options != NULL && options->key_function.data != NULL)
+            key_type_name = options->key_type_name;
+
+        return find_radix_key_info(key_type_name) != NULL;
+    }
+
+    static void render_to_string(
+        JSLAllocatorInterface allocator,
+        JSLImmutableMemory template,
+        JSLStrToStrMap* variables,
+        JSLImmutableMemory* out_string
+    )
+    {
+        JSLStringBuilder builder;
+        jsl_string_builder_init(&builder, allocator, 4096);
+        render_template(jsl_string_builder_output_sink(&builder), template, variables);
+        *out_string = jsl_string_builder_get_string(&builder);
+    }
+
+    static void insert_sort_variables(
+        JSLAllocatorInterface allocator,
+        JSLStrToStrMap* map,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        ArraySortOptions* options
+    )
+    {
+        static JSLImmutableMemory less_than_expression_key = JSL_CSTR_INITIALIZER("less_than_expression");
+        static JSLImmutableMemory less_than_description_key = JSL_CSTR_INITIALIZER("less_than_description");
+        static JSLImmutableMemory key_type_name_key = JSL_CSTR_INITIALIZER("key_type_name");
+        static JSLImmutableMemory key_expression_key = JSL_CSTR_INITIALIZER("key_expression");
+        static JSLImmutableMemory key_description_key = JSL_CSTR_INITIALIZER("key_description");
+        static JSLImmutableMemory radix_unsigned_type_key = JSL_CSTR_INITIALIZER("radix_unsigned_type");
+        static JSLImmutableMemory radix_key_body_key = JSL_CSTR_INITIALIZER("radix_key_body");
+
+        bool has_less_than = options != NULL && options->less_than_function.data != NULL;
+        bool has_key_function = options != NULL && options->key_function.data != NULL;
+
+        JSLImmutableMemory less_than_expression;
+        JSLImmutableMemory less_than_description;
+        JSLImmutableMemory key_type_name = value_type_name;
+        JSLImmutableMemory key_expression = JSL_CSTR_EXPRESSION("*value");
+        JSLImmutableMemory key_description = JSL_CSTR_EXPRESSION("the element value");
+
+        if (has_less_than)
+        {
+            less_than_expression = jsl_format(
+                allocator,
+                JSL_CSTR_EXPRESSION("%y(a, b)"),
+                options->less_than_function
+            );
+            less_than_description = less_than_expression;
+        }
+        else if (has_key_function)
+        {
+            less_than_expression = jsl_format(
+                allocator,
+                JSL_CSTR_EXPRESSION("%y(a) < %y(b)"),
+                options->key_function,
+                options->key_function
+            );
+            less_than_description = less_than_expression;
+            key_type_name = options->key_type_name;
+            key_expression = jsl_format(
+                allocator,
+                JSL_CSTR_EXPRESSION("%y(value)"),
+                options->key_function
+            );
+            key_description = jsl_format(
+                allocator,
+                JSL_CSTR_EXPRESSION("`%y` keys from `%y`"),
+                options->key_type_name,
+                options->key_function
+            );
+        }
+        else
+        {
+            less_than_expression = JSL_CSTR_EXPRESSION("*a < *b");
+            less_than_description = less_than_expression;
+        }
+
+        jsl_str_to_str_map_insert(map, array_type_name_key, JSL_STRING_LIFETIME_LONGER, array_type_name, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(map, value_type_name_key, JSL_STRING_LIFETIME_LONGER, value_type_name, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(map, function_prefix_key, JSL_STRING_LIFETIME_LONGER, function_prefix, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(map, less_than_expression_key, JSL_STRING_LIFETIME_LONGER, less_than_expression, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(map, less_than_description_key, JSL_STRING_LIFETIME_LONGER, less_than_description, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(map, key_type_name_key, JSL_STRING_LIFETIME_LONGER, key_type_name, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(map, key_expression_key, JSL_STRING_LIFETIME_LONGER, key_expression, JSL_STRING_LIFETIME_LONGER);
+        jsl_str_to_str_map_insert(map, key_description_key, JSL_STRING_LIFETIME_LONGER, key_description, JSL_STRING_LIFETIME_LONGER);
+
+        RadixKeyInfo* radix_info = has_less_than ? NULL : find_radix_key_info(key_type_name);
+        if (radix_info != NULL)
+        {
+            jsl_str_to_str_map_insert(map, radix_unsigned_type_key, JSL_STRING_LIFETIME_LONGER, radix_info->unsigned_type_name, JSL_STRING_LIFETIME_LONGER);
+            jsl_str_to_str_map_insert(map, radix_key_body_key, JSL_STRING_LIFETIME_LONGER, radix_info->body, JSL_STRING_LIFETIME_LONGER);
+        }
+    }
+
+    GENERATE_ARRAY_DEF void write_array_sort_header(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        ArraySortOptions* options
+    )
+    {
+        static JSLImmutableMemory radix_declaration_key = JSL_CSTR_INITIALIZER("radix_declaration");
+
+        JSLStrToStrMap map;
+        jsl_str_to_str_map_init(&map, allocator, 0x123456789);
+
+        insert_sort_variables(allocator, &map, array_type_name, function_prefix, value_type_name, options);
+
+        if (array_sort_has_radix(value_type_name, options))
+        {
+            JSLImmutableMemory radix_declaration;
+            render_to_string(allocator, radix_sort_header_template, &map, &radix_declaration);
+            jsl_str_to_str_map_insert(&map, radix_declaration_key, JSL_STRING_LIFETIME_LONGER, radix_declaration, JSL_STRING_LIFETIME_LONGER);
+        }
+
+        render_template(sink, sort_header_template, &map);
+    }
+
+    GENERATE_ARRAY_DEF void write_array_sort_source(
+        JSLAllocatorInterface allocator,
+        JSLOutputSink sink,
+        JSLImmutableMemory array_type_name,
+        JSLImmutableMemory function_prefix,
+        JSLImmutableMemory value_type_name,
+        ArraySortOptions* options
+    )
+    {
+        static JSLImmutableMemory radix_definition_key = JSL_CSTR_INITIALIZER("radix_definition");
+
+        JSLStrToStrMap map;
+        jsl_str_to_str_map_init(&map, allocator, 0x123456789);
+
+        insert_sort_variables(allocator, &map, array_type_name, function_prefix, value_type_name, options);
+
+        if (array_sort_has_radix(value_type_name, options))
+        {
+            JSLImmutableMemory radix_definition;
+            render_to_string(allocator, radix_sort_source_template, &map, &radix_definition);
+            jsl_str_to_str_map_insert(&map, radix_definition_key, JSL_STRING_LIFETIME_LONGER, radix_definition, JSL_STRING_LIFETIME_LONGER);
+        }
+
+        render_template(sink, sort_source_template, &map);
     }
 
 #endif /* GENERATE_ARRAY_IMPLEMENTATION */
@@ -62,3 +62,17 @@ replace_var_block() {
 
 replace_var_block dynamic_header_template dynamic_array_header.txt
 replace_var_block dynamic_source_template dynamic_array_source.txt
+replace_var_block soa_header_template soa_array_header.txt
+replace_var_block soa_source_template soa_array_source.txt
+replace_var_block sort_header_template sort_header.txt
+replace_var_block sort_source_template sort_source.txt
+replace_var_block radix_sort_header_template radix_sort_header.txt
+replace_var_block radix_sort_source_template radix_sort_source.txt
+replace_var_block segmented_header_template segmented_array_header.txt
+replace_var_block segmented_source_template segmented_array_source.txt
+replace_var_block ring_header_template ring_array_header.txt
+replace_var_block ring_source_template ring_array_source.txt
+replace_var_block spsc_header_template spsc_queue_header.txt
+replace_var_block spsc_source_template spsc_queue_source.txt
+replace_var_block mpmc_header_template mpmc_queue_header.txt
+replace_var_block mpmc_source_template mpmc_queue_source.txt
@@ -59,7 +59,7 @@ JSLImmutableMemory help_message = JSL_CSTR_INITIALIZER(
     "This program generates both a C source and header file for a hash map with the given\n"
     "key and value types. More documentation is included in the source file.\n\n"
     "USAGE:\n\n"
-    "\tgenerate_hash_map --name TYPE_NAME --function-prefix PREFIX [--key-type TYPE | --key-is-string] [--value-type TYPE | --value-is-string] [--static | --dynamic] [--header | --source] [--add-header=FILE]...\n\n"
+    "\tgenerate_hash_map --name TYPE_NAME --function-prefix PREFIX [--key-type TYPE | --key-is-string] [--value-type TYPE | --value-is-string | --set] [--static | --dynamic | --concurrent | --cache] [--header | --source] [--robin-hood | --control-bytes] [--hash=NAME] [--add-header=FILE]...\n\n"
     "Required arguments:\n"
     "\t--name\t\t\tThe name to give the hash map container type\n"
     "\t--function-prefix\tThe prefix added to each of the functions for the hash map\n"
@@ -67,14 +67,21 @@ JSLImmutableMemory help_message = JSL_CSTR_INITIALIZER(
     "\t--key-is-string\t\tThe value of the hash map should be JSLImmutableMemory. This is special-cased for code gen\n\n"
     "\t--value_type\t\tThe C type name for the value\n\n"
     "\t--value-is-string\t\tThe value of the hash map should be JSLImmutableMemory. This is special-cased for code gen\n\n"
+    "\t--set\t\t\tGenerate a hash set of the key type instead of a map, fixed and dynamic only\n\n"
     "\t--key_type\t\tThe C type name for the key\n"
     "Optional arguments:\n"
     "\t--header\t\tWrite the header file to stdout\n"
     "\t--source\t\tWrite the source file to stdout\n"
     "\t--dynamic\t\tGenerate a hash map which grows dynamically\n"
     "\t--static\t\tGenerate a statically sized hash map\n"
+    "\t--concurrent\t\tGenerate a statically sized hash map which is safe to use from many threads, plain data keys and values only\n"
+    "\t--cache\t\t\tGenerate a fixed capacity cache which evicts entries with the CLOCK algorithm, plain data keys and values only\n"
     "\t--add-header\t\tPath to a C header which will be added with a #include directive at the top of the generated file\n"
     "\t--custom-hash\t\tOverride the included hash call with the given function name\n"
+    "\t--robin-hood\t\tUse Robin Hood probing, which keeps probe lengths short enough to use a 90% load factor, fixed maps only\n"
+    "\t--control-bytes\t\tProbe groups of one byte hash tags with SIMD, fixed maps only, must be passed for both --header and --source\n"
+    "\t--hash\t\t\tThe included hash to use, one of default, crc32c, or aes. crc32c and aes are much faster\n"
+    "\t\t\t\tfor short keys on CPUs with those instructions but are not flood resistant\n"
 );
 
 static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
@@ -88,7 +95,9 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
     JSLImmutableMemory value_type = {0};
     JSLImmutableMemory hash_function_name = {0};
     JSLImmutableMemory compare_function_name = {0};
+    JSLImmutableMemory hash_name = {0};
     HashMapImplementation impl = IMPL_ERROR;
+    HashMapHashFunction hash_function = HASH_FUNCTION_DEFAULT;
     JSLImmutableMemory* header_includes = NULL;
     int32_t header_includes_count = 0;
 
@@ -104,11 +113,20 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
     static JSLImmutableMemory value_is_string_flag_str = JSL_CSTR_INITIALIZER("value-is-string");
     static JSLImmutableMemory fixed_flag_str = JSL_CSTR_INITIALIZER("fixed");
     static JSLImmutableMemory dynamic_flag_str = JSL_CSTR_INITIALIZER("dynamic");
+    static JSLImmutableMemory concurrent_flag_str = JSL_CSTR_INITIALIZER("concurrent");
+    static JSLImmutableMemory cache_flag_str = JSL_CSTR_INITIALIZER("cache");
+    static JSLImmutableMemory set_flag_str = JSL_CSTR_INITIALIZER("set");
     static JSLImmutableMemory header_flag_str = JSL_CSTR_INITIALIZER("header");
     static JSLImmutableMemory source_flag_str = JSL_CSTR_INITIALIZER("source");
     static JSLImmutableMemory add_header_flag_str = JSL_CSTR_INITIALIZER("add-header");
     static JSLImmutableMemory custom_hash_flag_str = JSL_CSTR_INITIALIZER("custom-hash");
     static JSLImmutableMemory custom_compare_flag_str = JSL_CSTR_INITIALIZER("custom-compare");
+    static JSLImmutableMemory hash_flag_str = JSL_CSTR_INITIALIZER("hash");
+    static JSLImmutableMemory robin_hood_flag_str = JSL_CSTR_INITIALIZER("robin-hood");
+    static JSLImmutableMemory control_bytes_flag_str = JSL_CSTR_INITIALIZER("control-bytes");
+    static JSLImmutableMemory default_hash_str = JSL_CSTR_INITIALIZER("default");
+    static JSLImmutableMemory crc32c_str = JSL_CSTR_INITIALIZER("crc32c");
+    static JSLImmutableMemory aes_str = JSL_CSTR_INITIALIZER("aes");
 
     //
     // Parsing command line
@@ -124,6 +142,7 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
     jsl_cmd_line_args_pop_flag_with_value(cmd, value_type_flag_str, &value_type);
     jsl_cmd_line_args_pop_flag_with_value(cmd, custom_hash_flag_str, &hash_function_name);
     jsl_cmd_line_args_pop_flag_with_value(cmd, custom_compare_flag_str, &compare_function_name);
+    jsl_cmd_line_args_pop_flag_with_value(cmd, hash_flag_str, &hash_name);
 
     JSLImmutableMemory custom_header = {0};
     while (jsl_cmd_line_args_pop_flag_with_value(cmd, add_header_flag_str, &custom_header))
@@ -139,8 +158,13 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
 
     bool fixed_flag_set = jsl_cmd_line_args_has_flag(cmd, fixed_flag_str);
     bool dynamic_flag_set = jsl_cmd_line_args_has_flag(cmd, dynamic_flag_str);
+    bool concurrent_flag_set = jsl_cmd_line_args_has_flag(cmd, concurrent_flag_str);
+    bool cache_flag_set = jsl_cmd_line_args_has_flag(cmd, cache_flag_str);
+    bool set_flag_set = jsl_cmd_line_args_has_flag(cmd, set_flag_str);
     bool header_flag_set = jsl_cmd_line_args_has_flag(cmd, header_flag_str);
     bool source_flag_set = jsl_cmd_line_args_has_flag(cmd, source_flag_str);
+    bool robin_hood_flag_set = jsl_cmd_line_args_has_flag(cmd, robin_hood_flag_str);
+    bool control_bytes_flag_set = jsl_cmd_line_args_has_flag(cmd, control_bytes_flag_str);
 
     if (show_help)
     {
@@ -170,23 +194,27 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
         );
         return EXIT_FAILURE;
     }
-    if (fixed_flag_set && dynamic_flag_set)
+    if ((int32_t) fixed_flag_set + (int32_t) dynamic_flag_set + (int32_t) concurrent_flag_set + (int32_t) cache_flag_set > 1)
     {
         jsl_format_sink(
             stderr_sink,
-            JSL_CSTR_EXPRESSION("Error: cannot set both --%y and --%y\n"),
+            JSL_CSTR_EXPRESSION("Error: only one of --%y, --%y, --%y, or --%y can be set\n"),
             fixed_flag_str,
-            dynamic_flag_str
+            dynamic_flag_str,
+            concurrent_flag_str,
+            cache_flag_str
         );
         return EXIT_FAILURE;
     }
-    if (!fixed_flag_set && !dynamic_flag_set)
+    if (!fixed_flag_set && !dynamic_flag_set && !concurrent_flag_set && !cache_flag_set)
     {
         jsl_format_sink(
             stderr_sink,
-            JSL_CSTR_EXPRESSION("Error: you must provide either --%y or --%y\n"),
+            JSL_CSTR_EXPRESSION("Error: you must provide one of --%y, --%y, --%y, or --%y\n"),
             fixed_flag_str,
-            dynamic_flag_str
+            dynamic_flag_str,
+            concurrent_flag_str,
+            cache_flag_str
         );
         return EXIT_FAILURE;
     }
@@ -241,16 +269,39 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
         );
         return EXIT_FAILURE;
     }
-    if (!value_is_string && value_type.data == NULL)
+    if (set_flag_set && (value_is_string || value_type.data != NULL))
     {
         jsl_format_sink(
             stderr_sink,
-            JSL_CSTR_EXPRESSION("Error: either --%y or --%y must be set\n"),
+            JSL_CSTR_EXPRESSION("Error: --%y sets have no values, don't pass --%y or --%y\n"),
+            set_flag_str,
             value_is_string_flag_str,
             value_type_flag_str
         );
         return EXIT_FAILURE;
     }
+    if (!set_flag_set && !value_is_string && value_type.data == NULL)
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: one of --%y, --%y, or --%y must be set\n"),
+            value_is_string_flag_str,
+            value_type_flag_str,
+            set_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+    if (set_flag_set && (concurrent_flag_set || cache_flag_set))
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: --%y is only supported with --%y and --%y\n"),
+            set_flag_str,
+            fixed_flag_str,
+            dynamic_flag_str
+        );
+        return EXIT_FAILURE;
+    }
     if (key_is_string && value_is_string)
     {
         jsl_format_sink(
@@ -262,8 +313,76 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
         return EXIT_FAILURE;
     }
 
+    if (robin_hood_flag_set && control_bytes_flag_set)
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: cannot set both --%y and --%y\n"),
+            robin_hood_flag_str,
+            control_bytes_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+
+    if ((concurrent_flag_set || cache_flag_set) && (key_is_string || value_is_string))
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: --%y maps don't support --%y or --%y\n"),
+            concurrent_flag_set ? concurrent_flag_str : cache_flag_str,
+            key_is_string_flag_str,
+            value_is_string_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+
+    if ((dynamic_flag_set || concurrent_flag_set || cache_flag_set) && (robin_hood_flag_set || control_bytes_flag_set))
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: --%y and --%y are only supported with --%y\n"),
+            robin_hood_flag_str,
+            control_bytes_flag_str,
+            fixed_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+
+    if (hash_name.data != NULL && hash_function_name.data != NULL)
+    {
+        jsl_format_sink(
+            stderr_sink,
+            JSL_CSTR_EXPRESSION("Error: cannot set both --%y and --%y\n"),
+            hash_flag_str,
+            custom_hash_flag_str
+        );
+        return EXIT_FAILURE;
+    }
+    if (hash_name.data != NULL)
+    {
+        if (jsl_memory_compare(hash_name, crc32c_str))
+            hash_function = HASH_FUNCTION_CRC32C;
+        else if (jsl_memory_compare(hash_name, aes_str))
+            hash_function = HASH_FUNCTION_AES;
+        else if (!jsl_memory_compare(hash_name, default_hash_str))
+        {
+            jsl_format_sink(
+                stderr_sink,
+                JSL_CSTR_EXPRESSION("Error: unknown --%y value \"%y\", expected %y, %y, or %y\n"),
+                hash_flag_str,
+                hash_name,
+                default_hash_str,
+                crc32c_str,
+                aes_str
+            );
+            return EXIT_FAILURE;
+        }
+    }
+
     if (fixed_flag_set) impl = IMPL_FIXED;
     if (dynamic_flag_set) impl = IMPL_DYNAMIC;
+    if (concurrent_flag_set) impl = IMPL_CONCURRENT;
+    if (cache_flag_set) impl = IMPL_CACHE;
 
     if (header_flag_set)
     {
@@ -277,6 +396,7 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
             key_is_string,
             value_type,
             value_is_string,
+            control_bytes_flag_set,
             header_includes,
             header_includes_count
         );
@@ -293,6 +413,9 @@ static int32_t entrypoint(JSLAllocatorInterface allocator, JSLCmdLineArgs* cmd)
             key_is_string,
             value_type,
             value_is_string,
+            hash_function,
+            robin_hood_flag_set,
+            control_bytes_flag_set,
             hash_function_name,
             compare_function_name,
             header_includes,
@@ -10,12 +10,19 @@
  * accidentally create the combinatoric explosion of code that's so common in C++
  * projects. Sometimes, adding friction to things is good.
  * 
- * There are two implementations of hash map that this utility can generate.
+ * There are four implementations of hash map that this utility can generate.
  * 
  * 1. A fixed size hash map that cannot grow. You set the max item count at
  *    init. This reduces memory fragmentation in arenas and it reduces failure
  *    modes in later parts of the program
- * 2. A standard dynamic hash map.
+ * 2. A dynamic hash map which doubles its table when it reaches the load
+ *    factor, with optional incremental rehashing
+ * 3. A fixed size hash map which is safe to share between threads, for
+ *    plain data keys and values
+ * 4. A fixed capacity cache which evicts old entries to make room for new
+ *    ones, for plain data keys and values
+ * 
+ * The fixed and dynamic implementations can also generate typed hash sets.
  * 
  * ## Usage
  * 
@@ -72,6 +79,83 @@
  * 
  * The two relevent functions are write_hash_map_header and write_hash_map_source
  * 
+ * ## Hash Functions
+ * 
+ * By default string and struct keys are hashed with rapidhash and integer and
+ * pointer keys with the murmur3 finalizer. `--hash=crc32c` and `--hash=aes`
+ * switch to hashes built on the CRC32C and AES instructions, which are a few
+ * times cheaper for eight byte keys. Compile with `-msse4.2 -maes` or
+ * `-march=native` to get the instructions, otherwise a slower portable version
+ * is used. These are easy to collide on purpose, only use them when the keys
+ * don't come from an untrusted source.
+ * 
+ * ## Robin Hood Probing
+ * 
+ * `--robin-hood` keeps each run of occupied slots sorted by the key's ideal
+ * slot. Lookups for missing keys stop as soon as they pass where the key would
+ * have been instead of running to the next empty slot, and the longest probe
+ * stays close to the average. This lets the fixed map size its table for a 90%
+ * load factor instead of 75%. Inserts which land in the middle of a run shift
+ * the rest of the run down by one, so inserts cost a bit more.
+ * 
+ * ## Control Bytes
+ * 
+ * `--control-bytes` adds an array with one byte per slot holding seven bits
+ * of the slot's hash, the same layout as Abseil's SwissTable. Probing loads a
+ * group of 32 of these with AVX2 or 16 with SSE2, NEON, or wasm SIMD and
+ * compares them all against the key's tag at once, so a lookup usually
+ * compares exactly one key and never reads the stored hashes. Without any of
+ * those the groups are eight bytes in a `uint64_t`. This allows an 87.5% max
+ * load factor. It can't be combined with `--robin-hood`, and it costs one
+ * extra byte per slot.
+ * 
+ * ## Dynamic Maps
+ * 
+ * `--dynamic` maps use the same slot layout, probing, and backshift deletion
+ * as the fixed map, and double the table whenever an insert of a new key
+ * would go over the load factor. By default every entry is moved at once.
+ * After calling `PREFIX_enable_incremental_rehash` the old table is kept
+ * instead and each insert and delete moves a few of its slots, so no single
+ * insert pays for the whole move. `PREFIX_reserve` grows the table once
+ * for a known number of items and `PREFIX_shrink_to_fit` moves the items
+ * into the smallest table that holds them. `--robin-hood` and
+ * `--control-bytes` are only available for fixed maps.
+ * 
+ * ## Memory Use
+ * 
+ * Every map has `PREFIX_memory_footprint`, the bytes it currently holds from
+ * its allocator. Fixed and dynamic maps also have `PREFIX_memory_footprint_for`,
+ * the bytes of the table for a given number of items, which works without a
+ * map and can be used to size maps to a memory budget.
+ * 
+ * ## Hash Sets
+ * 
+ * `--set` in place of a value type generates a set of the key type with the
+ * fixed or dynamic implementation. It's the same table with the values array
+ * left out, and `PREFIX_has` in place of `PREFIX_get`. With the library pass
+ * neither a value type nor `value_is_str`.
+ * 
+ * ## Caches
+ * 
+ * `--cache` generates a map with a fixed capacity which evicts an entry
+ * whenever a new key is inserted while it's full. The entry is picked with the
+ * CLOCK algorithm, a hit sets one byte and eviction sweeps a hand over those
+ * bytes, so a hit never has to move anything around like a linked list LRU
+ * does. The entries are kept dense and the hash table refers to them with 32
+ * bit indices. `PREFIX_set_evict_function` registers a callback to release
+ * whatever an evicted value owns. The cache counts its hits, misses, and
+ * evictions. String keys and values aren't supported.
+ * 
+ * ## Concurrent Maps
+ * 
+ * `--concurrent` maps are split into shards, each a small fixed size table
+ * with its own spin lock, so threads touching different keys rarely wait on
+ * each other. Lookups copy the value out instead of returning a pointer, and
+ * `PREFIX_update` runs a callback on the stored value under the lock for
+ * read-modify-write updates like counters. Iterators work on a snapshot taken
+ * with every shard locked. String keys and values aren't supported, and
+ * neither are `--robin-hood` and `--control-bytes`.
+ * 
  * ## License
  *
  * Copyright (c) 2026 Jack Stouffer
@@ -128,9 +212,17 @@
     typedef enum {
         IMPL_ERROR,
         IMPL_FIXED,
-        IMPL_DYNAMIC
+        IMPL_DYNAMIC,
+        IMPL_CONCURRENT,
+        IMPL_CACHE
     } HashMapImplementation;
 
+    typedef enum {
+        HASH_FUNCTION_DEFAULT,
+        HASH_FUNCTION_CRC32C,
+        HASH_FUNCTION_AES
+    } HashMapHashFunction;
+
     /**
      * Generate the text of the C header and insert it into the string sink.
      * 
@@ -140,7 +232,8 @@
      * @param hash_map_name The name of the container type
      * @param function_prefix The prefix plus "_" for each function
      * @param key_type_name The type of the hash map key
-     * @param value_type_name The type of the hash map value
+     * @param value_type_name The type of the hash map value, pass an empty value and false for value_is_str to generate a set
+     * @param control_bytes Must match the value passed to write_hash_map_source
      * @param hash_function_name If you have a custom hash function, put it here, otherwise pass NULL
      * @param include_header_array If you need custom header includes then set this, otherwise pass NULL
      * @param include_header_count The length of the header array
@@ -155,6 +248,7 @@
         bool key_is_str,
         JSLImmutableMemory value_type_name,
         bool value_is_str,
+        bool control_bytes,
         JSLImmutableMemory* include_header_array,
         int32_t include_header_count
     );
@@ -168,7 +262,10 @@
      * @param hash_map_name The name of the container type
      * @param function_prefix The prefix plus "_" for each function
      * @param key_type_name The type of the hash map key
-     * @param value_type_name The type of the hash map value
+     * @param value_type_name The type of the hash map value, pass an empty value and false for value_is_str to generate a set
+     * @param hash_function Which built in hash to use when there's no custom hash function. CRC32C and AES are faster for short keys but are not flood resistant
+     * @param robin_hood Use Robin Hood ordering, which allows a 90% max load factor instead of 75%, IMPL_FIXED only
+     * @param control_bytes Probe groups of one byte hash tags with SIMD instead of single full hashes, IMPL_FIXED only and cannot be combined with robin_hood
      * @param hash_function_name If you have a custom hash function, put it here, otherwise pass NULL
      * @param include_header_array If you need custom header includes then set this, otherwise pass NULL
      * @param include_header_count The length of the header array
@@ -183,6 +280,9 @@
         bool key_is_str,
         JSLImmutableMemory value_type_name,
         bool value_is_str,
+        HashMapHashFunction hash_function,
+        bool robin_hood,
+        bool control_bytes,
         JSLImmutableMemory hash_function_name,
         JSLImmutableMemory compare_function_name,
         JSLImmutableMemory* include_header_array,
@@ -205,7 +305,13 @@
         "/**\r\n"
         " * AUTO GENERATED FILE\r\n"
         " *\r\n"
-        "{% if key_is_str %}\r\n"
+        "{% if is_set and key_is_str %}\r\n"
+        " * This file contains the header for a hash set `{{ hash_map_name }}` of\r\n"
+        " * `JSLImmutableMemory` values.\r\n"
+        "{% elif is_set %}\r\n"
+        " * This file contains the header for a hash set `{{ hash_map_name }}` of\r\n"
+        " * `{{ key_type_name }}` values.\r\n"
+        "{% elif key_is_str %}\r\n"
         " * This file contains the header for a hash map `{{ hash_map_name }}` which maps\r\n"
         " * `JSLImmutableMemory` keys to `{{ value_type_name }}` values.\r\n"
         "{% elif value_is_str %}\r\n"
@@ -262,11 +368,23 @@
         " */\r\n"
         "\r\n"
         "/**\r\n"
+        "{% if is_set %}\r\n"
+        " * A hash set of `{{ key_type_name }}` values. It's the same table as the\r\n"
+        " * generated hash maps with the values array left out, so a set costs only\r\n"
+        " * the keys and hashes.\r\n"
+        "{% else %}\r\n"
         " * A hash map which maps `{{ key_type_name }}` keys to `{{ value_type_name }}` values.\r\n"
+        "{% endif %}\r\n"
         " *\r\n"
         " * This hash map uses open addressing with linear probing. However, it never grows.\r\n"
         " * When initialized with the init function, all the memory this hash map will have\r\n"
         " * is allocated right away.\r\n"
+        "{% if control_bytes %}\r\n"
+        " *\r\n"
+        " * Lookups compare a whole group of one byte tags from `control_array` at once\r\n"
+        " * and only compare the keys whose tag matches. Full hashes aren't stored,\r\n"
+        " * deletion hashes the keys it has to move again instead.\r\n"
+        "{% endif %}\r\n"
         " */\r\n"
         "typedef struct {{ hash_map_name }} {\r\n"
         "    // putting the sentinel first means it's much more likely to get\r\n"
@@ -283,14 +401,20 @@
         "    {{ key_type_name }}* keys_array;\r\n"
         "    {% endif %}\r\n"
         "\r\n"
-        "    {% if value_is_str %}\r\n"
+        "    {% if is_set %}\r\n"
+        "    {% elif value_is_str %}\r\n"
         "    JSLImmutableMemory* values_array;\r\n"
         "    JSLStringLifeTime* value_lifetime_array;\r\n"
         "    {% else %}\r\n"
         "    {{ value_type_name }}* values_array;\r\n"
         "    {% endif %}\r\n"
         "\r\n"
+        "    {% if control_bytes %}\r\n"
+        "    /// @brief one tag per slot plus a copy of the first group at the end\r\n"
+        "    uint8_t* control_array;\r\n"
+        "    {% else %}\r\n"
         "    uint64_t* hashes_array;\r\n"
+        "    {% endif %}\r\n"
         "    int64_t arrays_length;\r\n"
         "\r\n"
         "    int64_t item_count;\r\n"
@@ -337,9 +461,15 @@
         ");\r\n"
         "\r\n"
         "/**\r\n"
+        "{% if is_set %}\r\n"
+        " * Insert the given value into the set. Inserting a value which is already\r\n"
+        " * in the set doesn't change anything. If the value type for this set is a\r\n"
+        " * pointer, then NULL is a valid value.\r\n"
+        "{% else %}\r\n"
         " * Insert the given value into the hash map. If the key already exists in \r\n"
         " * the map the value will be overwritten. If the key type for this hash map\r\n"
         " * is a pointer, then a NULL key is a valid key type.\r\n"
+        "{% endif %}\r\n"
         " *\r\n"
         "{% if key_is_struct %}\r\n"
         " * With struct keys, struct padding can be filled with random-ish, garbage bytes.\r\n"
@@ -352,6 +482,21 @@
         " *\r\n"
         " * @param hash_map The pointer to the hash map instance to initialize\r\n"
         " * @param key Hash map key\r\n"
+        "{% if is_set %}\r\n"
+        " * @returns A bool representing success or failure of insertion.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_insert(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key,\r\n"
+        "    JSLStringLifeTime key_lifetime\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ");\r\n"
+        "{% else %}\r\n"
         " * @param value Value to store\r\n"
         " * @returns A bool representing success or failure of insertion.\r\n"
         " */\r\n"
@@ -372,7 +517,27 @@
         "    {{ value_type_name }} value\r\n"
         "    {% endif %}\r\n"
         ");\r\n"
+        "{% endif %}\r\n"
         "\r\n"
+        "{% if is_set %}\r\n"
+        "/**\r\n"
+        " * Check if the value is in the set.\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash set instance\r\n"
+        " * @param key Value to look for\r\n"
+        " * @returns true if the value is in the set.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_has(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ");\r\n"
+        "{% else %}\r\n"
         "/**\r\n"
         " * Get a value from the hash map if it exists. If it does not NULL is returned\r\n"
         " *\r\n"
@@ -399,6 +564,7 @@
         "    {{ key_type_name }} key\r\n"
         "    {% endif %}\r\n"
         ");\r\n"
+        "{% endif %}\r\n"
         "\r\n"
         "/**\r\n"
         " * Remove a key/value pair from the hash map if it exists.\r\n"
@@ -428,6 +594,41 @@
         ");\r\n"
         "\r\n"
         "/**\r\n"
+        " * Get the number of bytes this hash map holds from its allocator, which is\r\n"
+        " * every array allocated by init plus the copies of keys and values inserted\r\n"
+        " * with `JSL_STRING_LIFETIME_SHORTER`. Allocator bookkeeping and alignment\r\n"
+        " * padding aren't included.\r\n"
+        "{% if key_is_str or value_is_str %}\r\n"
+        " *\r\n"
+        " * Counting the string copies walks the whole table, so avoid calling this\r\n"
+        " * after every insert.\r\n"
+        "{% endif %}\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance\r\n"
+        " * @returns The size in bytes, or -1 on invalid parameters.\r\n"
+        " */\r\n"
+        "int64_t {{ function_prefix }}_memory_footprint(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Get the number of bytes init allocates for the given `max_item_count`,\r\n"
+        " * without making a map. Use this to find the largest `max_item_count`\r\n"
+        " * which fits in a memory budget.\r\n"
+        "{% if key_is_str or value_is_str %}\r\n"
+        " *\r\n"
+        " * Copies of strings with `JSL_STRING_LIFETIME_SHORTER` are allocated on insert\r\n"
+        " * and aren't part of this number.\r\n"
+        "{% endif %}\r\n"
+        " *\r\n"
+        " * @param max_item_count The maximum amount of items the hash map would hold\r\n"
+        " * @returns The size in bytes, or -1 if `max_item_count` is negative or too large.\r\n"
+        " */\r\n"
+        "int64_t {{ function_prefix }}_memory_footprint_for(\r\n"
+        "    int64_t max_item_count\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
         " * Create a new iterator over this hash map.\r\n"
         " *\r\n"
         " * An iterator is a struct which holds enough state that it allows a loop to visit\r\n"
@@ -440,10 +641,16 @@
         " * Example usage:\r\n"
         " * @code\r\n"
         " * {{ key_type_name }} key;\r\n"
+        "{% if is_set %}\r\n"
+        " * {{ hash_map_name }}Iterator iterator;\r\n"
+        " * {{ function_prefix }}_iterator_start(hash_map, &iterator);\r\n"
+        " * while ({{ function_prefix }}_iterator_next(&iterator, &key))\r\n"
+        "{% else %}\r\n"
         " * {{ value_type_name }} value;\r\n"
         " * {{ hash_map_name }}Iterator iterator;\r\n"
         " * {{ function_prefix }}_iterator_start(hash_map, &iterator);\r\n"
         " * while ({{ function_prefix }}_iterator_next(&iterator, &key, &value))\r\n"
+        "{% endif %}\r\n"
         " * {\r\n"
         " *     ...\r\n"
         " * }\r\n"
@@ -460,10 +667,16 @@
         " * Example usage:\r\n"
         " * @code\r\n"
         " * {{ key_type_name }} key;\r\n"
+        "{% if is_set %}\r\n"
+        " * {{ hash_map_name }}Iterator iterator;\r\n"
+        " * {{ function_prefix }}_iterator_start(hash_map, &iterator);\r\n"
+        " * while ({{ function_prefix }}_iterator_next(&iterator, &key))\r\n"
+        "{% else %}\r\n"
         " * {{ value_type_name }} value;\r\n"
         " * {{ hash_map_name }}Iterator iterator;\r\n"
         " * {{ function_prefix }}_iterator_start(hash_map, &iterator);\r\n"
         " * while ({{ function_prefix }}_iterator_next(&iterator, &key, &value))\r\n"
+        "{% endif %}\r\n"
         " * {\r\n"
         " *     ...\r\n"
         " * }\r\n"
@@ -471,6 +684,15 @@
         " */\r\n"
         "bool {{ function_prefix }}_iterator_next(\r\n"
         "    {{ hash_map_name }}Iterator* iterator,\r\n"
+        "{% if is_set %}\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory* out_key\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}** out_key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }}* out_key\r\n"
+        "    {% endif %}\r\n"
+        "{% else %}\r\n"
         "    {% if key_is_str %}\r\n"
         "    JSLImmutableMemory* out_key,\r\n"
         "    {% elif key_is_struct %}\r\n"
@@ -483,6 +705,7 @@
         "    {% else %}\r\n"
         "    {{ value_type_name }}* out_value\r\n"
         "    {% endif %}\r\n"
+        "{% endif %}\r\n"
         ");\r\n"
         "\r\n"
     );
@@ -515,6 +738,58 @@
         " * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.\r\n"
         " */\r\n"
         "\r\n"
+        "static int64_t {{ function_prefix }}_arrays_length_for(\r\n"
+        "    int64_t max_item_count\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    {% if robin_hood %}\r\n"
+        "    // Robin Hood ordering keeps probe lengths short even when the table is\r\n"
+        "    // nearly full, so it can run much denser than plain linear probing\r\n"
+        "    int64_t max_with_load_factor = (int64_t) ((float) max_item_count / 0.9f);\r\n"
+        "    {% elif control_bytes %}\r\n"
+        "    // Checking a whole group of tags costs about the same as checking one\r\n"
+        "    // slot, so longer runs are cheap and the table can be denser\r\n"
+        "    int64_t max_with_load_factor = (int64_t) ((float) max_item_count / 0.875f);\r\n"
+        "    {% else %}\r\n"
+        "    int64_t max_with_load_factor = (int64_t) ((float) max_item_count / 0.75f);\r\n"
+        "    {% endif %}\r\n"
+        "\r\n"
+        "    return jsl_next_power_of_two_i64(JSL_MAX(max_with_load_factor, 32));\r\n"
+        "}\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Bytes of every array init allocates for a table of `arrays_length` slots,\r\n"
+        " * or -1 if that doesn't fit in an int64_t.\r\n"
+        " */\r\n"
+        "static int64_t {{ function_prefix }}_arrays_bytes(\r\n"
+        "    int64_t arrays_length\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    int64_t slot_bytes = (int64_t) (sizeof(JSLImmutableMemory) + sizeof(JSLStringLifeTime));\r\n"
+        "    {% else %}\r\n"
+        "    int64_t slot_bytes = (int64_t) sizeof({{ key_type_name }});\r\n"
+        "    {% endif %}\r\n"
+        "    {% if is_set %}\r\n"
+        "    {% elif value_is_str %}\r\n"
+        "    slot_bytes += (int64_t) (sizeof(JSLImmutableMemory) + sizeof(JSLStringLifeTime));\r\n"
+        "    {% else %}\r\n"
+        "    slot_bytes += (int64_t) sizeof({{ value_type_name }});\r\n"
+        "    {% endif %}\r\n"
+        "    {% if control_bytes %}\r\n"
+        "    slot_bytes += 1;\r\n"
+        "    int64_t extra_bytes = JSL__HASHMAP_GROUP_WIDTH;\r\n"
+        "    {% else %}\r\n"
+        "    slot_bytes += (int64_t) sizeof(uint64_t);\r\n"
+        "    int64_t extra_bytes = 0;\r\n"
+        "    {% endif %}\r\n"
+        "\r\n"
+        "    if (arrays_length > (INT64_MAX - extra_bytes) / slot_bytes)\r\n"
+        "        return -1;\r\n"
+        "\r\n"
+        "    return arrays_length * slot_bytes + extra_bytes;\r\n"
+        "}\r\n"
+        "\r\n"
         "bool {{ function_prefix }}_init(\r\n"
         "    {{ hash_map_name }}* hash_map,\r\n"
         "    JSLAllocatorInterface allocator,\r\n"
@@ -531,10 +806,7 @@
         "    hash_map->allocator = allocator;\r\n"
         "    hash_map->max_item_count = max_item_count;\r\n"
         "\r\n"
-        "    int64_t max_with_load_factor = (int64_t) ((float) max_item_count / 0.75f);\r\n"
-        "\r\n"
-        "    hash_map->arrays_length = jsl_next_power_of_two_i64(max_with_load_factor);\r\n"
-        "    hash_map->arrays_length = JSL_MAX(hash_map->arrays_length, 32);\r\n"
+        "    hash_map->arrays_length = {{ function_prefix }}_arrays_length_for(max_item_count);\r\n"
         "\r\n"
         "    {% if key_is_str %}\r\n"
         "    hash_map->keys_array = (JSLImmutableMemory*) jsl_allocator_interface_alloc(\r\n"
@@ -565,7 +837,8 @@
         "    {% endif %}\r\n"
         "\r\n"
         "\r\n"
-        "    {% if value_is_str %}\r\n"
+        "    {% if is_set %}\r\n"
+        "    {% elif value_is_str %}\r\n"
         "    hash_map->values_array = (JSLImmutableMemory*) jsl_allocator_interface_alloc(\r\n"
         "        allocator,\r\n"
         "        ((int64_t) sizeof(JSLImmutableMemory)) * hash_map->arrays_length,\r\n"
@@ -593,6 +866,18 @@
         "        return false;\r\n"
         "    {% endif %}\r\n"
         "\r\n"
+        "    {% if control_bytes %}\r\n"
+        "    int64_t control_length = hash_map->arrays_length + JSL__HASHMAP_GROUP_WIDTH;\r\n"
+        "    hash_map->control_array = (uint8_t*) jsl_allocator_interface_alloc(\r\n"
+        "        allocator,\r\n"
+        "        control_length,\r\n"
+        "        JSL_DEFAULT_ALLOCATION_ALIGNMENT,\r\n"
+        "        false\r\n"
+        "    );\r\n"
+        "    if (hash_map->control_array == NULL)\r\n"
+        "        return false;\r\n"
+        "    JSL_MEMSET(hash_map->control_array, JSL__HASHMAP_CONTROL_EMPTY, (size_t) control_length);\r\n"
+        "    {% else %}\r\n"
         "    hash_map->hashes_array = (uint64_t*) jsl_allocator_interface_alloc(\r\n"
         "        allocator,\r\n"
         "        ((int64_t) sizeof(uint64_t)) * hash_map->arrays_length,\r\n"
@@ -601,6 +886,7 @@
         "    );\r\n"
         "    if (hash_map->hashes_array == NULL)\r\n"
         "        return false;\r\n"
+        "    {% endif %}\r\n"
         "\r\n"
         "    hash_map->sentinel = PRIVATE_SENTINEL_{{ hash_map_name }};\r\n"
         "    return true;\r\n"
@@ -659,6 +945,51 @@
         "        *out_hash = (uint64_t) JSL__HASHMAP_VALUE_OK;\r\n"
         "    }\r\n"
         "\r\n"
+        "    {% if control_bytes %}\r\n"
+        "    uint64_t slot_mask = (uint64_t) hash_map->arrays_length - 1u;\r\n"
+        "    // The low bits become the tag, so the slot comes from the bits above them\r\n"
+        "    uint8_t tag = (uint8_t) (*out_hash & 0x7Fu);\r\n"
+        "    int64_t group_start = (int64_t) ((*out_hash >> 7) & slot_mask);\r\n"
+        "    int64_t total_checked = 0;\r\n"
+        "\r\n"
+        "    while (total_checked < hash_map->arrays_length)\r\n"
+        "    {\r\n"
+        "        const uint8_t* group = hash_map->control_array + group_start;\r\n"
+        "        uint64_t empty_mask = jsl__hash_map_group_match_empty(group);\r\n"
+        "        uint64_t match_mask = jsl__hash_map_group_match(group, tag);\r\n"
+        "\r\n"
+        "        // Same as plain linear probing, the key can't be past the first empty slot\r\n"
+        "        if (empty_mask != 0)\r\n"
+        "            match_mask &= (empty_mask & (~empty_mask + 1u)) - 1u;\r\n"
+        "\r\n"
+        "        while (match_mask != 0)\r\n"
+        "        {\r\n"
+        "            int64_t slot = (int64_t) (\r\n"
+        "                ((uint64_t) group_start + (uint64_t) jsl__hash_map_group_lane(match_mask)) & slot_mask\r\n"
+        "            );\r\n"
+        "\r\n"
+        "            if ({{ key_compare }})\r\n"
+        "            {\r\n"
+        "                *out_found = true;\r\n"
+        "                *out_slot = slot;\r\n"
+        "                return;\r\n"
+        "            }\r\n"
+        "\r\n"
+        "            match_mask &= match_mask - 1u;\r\n"
+        "        }\r\n"
+        "\r\n"
+        "        if (empty_mask != 0)\r\n"
+        "        {\r\n"
+        "            *out_slot = (int64_t) (\r\n"
+        "                ((uint64_t) group_start + (uint64_t) jsl__hash_map_group_lane(empty_mask)) & slot_mask\r\n"
+        "            );\r\n"
+        "            return;\r\n"
+        "        }\r\n"
+        "\r\n"
+        "        group_start = (int64_t) (((uint64_t) group_start + JSL__HASHMAP_GROUP_WIDTH) & slot_mask);\r\n"
+        "        total_checked += JSL__HASHMAP_GROUP_WIDTH;\r\n"
+        "    }\r\n"
+        "    {% else %}\r\n"
         "    int64_t total_checked = 0;\r\n"
         "    uint64_t slot_mask = (uint64_t) hash_map->arrays_length - 1u;\r\n"
         "    // Since our slot array length is always a pow 2, we can avoid a modulo\r\n"
@@ -681,6 +1012,19 @@
         "            break;\r\n"
         "        }\r\n"
         "\r\n"
+        "        {% if robin_hood %}\r\n"
+        "        // Every cluster is ordered by ideal slot. Reaching an entry which is\r\n"
+        "        // closer to its ideal slot than this key would be means the key isn't\r\n"
+        "        // in the table, and this is where it would be inserted.\r\n"
+        "        int64_t slot_distance = (int64_t) (((uint64_t) slot - (slot_hash_value & slot_mask)) & slot_mask);\r\n"
+        "        if (slot_distance < total_checked)\r\n"
+        "        {\r\n"
+        "            *out_slot = slot;\r\n"
+        "            break;\r\n"
+        "        }\r\n"
+        "\r\n"
+        "        {% endif %}\r\n"
+        "\r\n"
         "        slot = (int64_t) (((uint64_t) slot + 1u) & slot_mask);\r\n"
         "        ++total_checked;\r\n"
         "    }\r\n"
@@ -689,8 +1033,115 @@
         "    {\r\n"
         "        *out_slot = -1;\r\n"
         "    }\r\n"
+        "    {% endif %}\r\n"
+        "}\r\n"
+        "\r\n"
+        "{% if control_bytes %}\r\n"
+        "static inline void {{ function_prefix }}_set_control(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    int64_t slot,\r\n"
+        "    uint8_t control\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    hash_map->control_array[slot] = control;\r\n"
+        "    // Groups are loaded unaligned and can run off the end of the table, so\r\n"
+        "    // the first group is mirrored after the last slot\r\n"
+        "    if (slot < JSL__HASHMAP_GROUP_WIDTH)\r\n"
+        "        hash_map->control_array[hash_map->arrays_length + slot] = control;\r\n"
+        "}\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Only the tags are stored, so moving an entry during deletion has to hash\r\n"
+        " * its key again to find its ideal slot.\r\n"
+        " */\r\n"
+        "static inline uint64_t {{ function_prefix }}_hash_slot(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    int64_t slot\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    uint64_t hash = 0;\r\n"
+        "    uint64_t* out_hash = &hash;\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key = hash_map->keys_array[slot];\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key = &hash_map->keys_array[slot];\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key = hash_map->keys_array[slot];\r\n"
+        "    {% endif %}\r\n"
+        "\r\n"
+        "    {{ hash_function }};\r\n"
+        "\r\n"
+        "    // Matches the remapping in probe\r\n"
+        "    if (hash <= (uint64_t) JSL__HASHMAP_TOMBSTONE)\r\n"
+        "    {\r\n"
+        "        hash = (uint64_t) JSL__HASHMAP_VALUE_OK;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    return hash;\r\n"
+        "}\r\n"
+        "\r\n"
+        "{% endif %}\r\n"
+        "static inline void {{ function_prefix }}_move_slot(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    int64_t from,\r\n"
+        "    int64_t to\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    hash_map->keys_array[to] = hash_map->keys_array[from];\r\n"
+        "    {% if is_set %}\r\n"
+        "    {% else %}\r\n"
+        "    hash_map->values_array[to] = hash_map->values_array[from];\r\n"
+        "    {% endif %}\r\n"
+        "    {% if control_bytes %}\r\n"
+        "    {{ function_prefix }}_set_control(hash_map, to, hash_map->control_array[from]);\r\n"
+        "    {% else %}\r\n"
+        "    hash_map->hashes_array[to] = hash_map->hashes_array[from];\r\n"
+        "    {% endif %}\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    hash_map->key_lifetime_array[to] = hash_map->key_lifetime_array[from];\r\n"
+        "    {% endif %}\r\n"
+        "    {% if value_is_str %}\r\n"
+        "    hash_map->value_lifetime_array[to] = hash_map->value_lifetime_array[from];\r\n"
+        "    {% endif %}\r\n"
+        "}\r\n"
+        "\r\n"
+        "{% if robin_hood %}\r\n"
+        "/**\r\n"
+        " * Open up `slot` for a new entry by moving everything from it up to the next\r\n"
+        " * empty slot down by one, which keeps the cluster ordered by ideal slot.\r\n"
+        " */\r\n"
+        "static inline bool {{ function_prefix }}_make_room(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    int64_t slot\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    uint64_t slot_mask = (uint64_t) hash_map->arrays_length - 1u;\r\n"
+        "\r\n"
+        "    int64_t empty = slot;\r\n"
+        "    int64_t total_checked = 0;\r\n"
+        "    while (\r\n"
+        "        hash_map->hashes_array[empty] != JSL__HASHMAP_EMPTY\r\n"
+        "        && total_checked < hash_map->arrays_length\r\n"
+        "    )\r\n"
+        "    {\r\n"
+        "        empty = (int64_t) (((uint64_t) empty + 1u) & slot_mask);\r\n"
+        "        ++total_checked;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    if (total_checked >= hash_map->arrays_length)\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    while (empty != slot)\r\n"
+        "    {\r\n"
+        "        int64_t previous = (int64_t) (((uint64_t) empty - 1u) & slot_mask);\r\n"
+        "        {{ function_prefix }}_move_slot(hash_map, previous, empty);\r\n"
+        "        empty = previous;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    return true;\r\n"
         "}\r\n"
         "\r\n"
+        "{% endif %}\r\n"
         "static inline void {{ function_prefix }}_backshift(\r\n"
         "    {{ hash_map_name }}* hash_map,\r\n"
         "    int64_t start_slot\r\n"
@@ -704,6 +1155,15 @@
         "    int64_t loop_check = 0;\r\n"
         "    while (loop_check < hash_map->arrays_length)\r\n"
         "    {\r\n"
+        "        {% if control_bytes %}\r\n"
+        "        if (hash_map->control_array[current] == JSL__HASHMAP_CONTROL_EMPTY)\r\n"
+        "        {\r\n"
+        "            {{ function_prefix }}_set_control(hash_map, hole, JSL__HASHMAP_CONTROL_EMPTY);\r\n"
+        "            break;\r\n"
+        "        }\r\n"
+        "\r\n"
+        "        uint64_t hash_value = {{ function_prefix }}_hash_slot(hash_map, current);\r\n"
+        "        {% else %}\r\n"
         "        uint64_t hash_value = hash_map->hashes_array[current];\r\n"
         "\r\n"
         "        if (hash_value == JSL__HASHMAP_EMPTY)\r\n"
@@ -711,18 +1171,31 @@
         "            hash_map->hashes_array[hole] = JSL__HASHMAP_EMPTY;\r\n"
         "            break;\r\n"
         "        }\r\n"
+        "        {% endif %}\r\n"
         "\r\n"
+        "        {% if control_bytes %}\r\n"
+        "        int64_t ideal_slot = (int64_t) ((hash_value >> 7) & slot_mask);\r\n"
+        "        {% else %}\r\n"
         "        int64_t ideal_slot = (int64_t) (hash_value & slot_mask);\r\n"
+        "        {% endif %}\r\n"
+        "\r\n"
+        "        {% if robin_hood %}\r\n"
+        "        // Clusters are ordered by ideal slot, nothing after an entry which\r\n"
+        "        // is already in its ideal slot can move into the hole\r\n"
+        "        if (ideal_slot == current)\r\n"
+        "        {\r\n"
+        "            hash_map->hashes_array[hole] = JSL__HASHMAP_EMPTY;\r\n"
+        "            break;\r\n"
+        "        }\r\n"
         "\r\n"
+        "        {% endif %}\r\n"
         "        bool should_move = (current > hole)\r\n"
         "            ? (ideal_slot <= hole || ideal_slot > current)\r\n"
         "            : (ideal_slot <= hole && ideal_slot > current);\r\n"
         "\r\n"
         "        if (should_move)\r\n"
         "        {\r\n"
-        "            hash_map->keys_array[hole] = hash_map->keys_array[current];\r\n"
-        "            hash_map->values_array[hole] = hash_map->values_array[current];\r\n"
-        "            hash_map->hashes_array[hole] = hash_map->hashes_array[current];\r\n"
+        "            {{ function_prefix }}_move_slot(hash_map, current, hole);\r\n"
         "            hole = current;\r\n"
         "        }\r\n"
         "\r\n"
@@ -734,6 +1207,16 @@
         "\r\n"
         "bool {{ function_prefix }}_insert(\r\n"
         "    {{ hash_map_name }}* hash_map,\r\n"
+        "{% if is_set %}\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key,\r\n"
+        "    JSLStringLifeTime key_lifetime\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        "{% else %}\r\n"
         "    {% if key_is_str %}\r\n"
         "    JSLImmutableMemory key,\r\n"
         "    JSLStringLifeTime key_lifetime,\r\n"
@@ -748,6 +1231,7 @@
         "    {% else %}\r\n"
         "    {{ value_type_name }} value\r\n"
         "    {% endif %}\r\n"
+        "{% endif %}\r\n"
         ")\r\n"
         "{\r\n"
         "    bool insert_success = false;\r\n"
@@ -764,6 +1248,18 @@
         "    bool existing_found = false;\r\n"
         "    {{ function_prefix }}_probe(hash_map, key, &slot, &hash, &existing_found);\r\n"
         "\r\n"
+        "    {% if robin_hood %}\r\n"
+        "    if (\r\n"
+        "        slot > -1\r\n"
+        "        && !existing_found\r\n"
+        "        && hash_map->hashes_array[slot] != JSL__HASHMAP_EMPTY\r\n"
+        "        && !{{ function_prefix }}_make_room(hash_map, slot)\r\n"
+        "    )\r\n"
+        "    {\r\n"
+        "        slot = -1;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    {% endif %}\r\n"
         "    // new key\r\n"
         "    if (slot > -1 && !existing_found)\r\n"
         "    {\r\n"
@@ -780,7 +1276,8 @@
         "        hash_map->keys_array[slot] = key;\r\n"
         "        {% endif %}\r\n"
         "\r\n"
-        "        {% if value_is_str %}\r\n"
+        "        {% if is_set %}\r\n"
+        "        {% elif value_is_str %}\r\n"
         "        if (value_lifetime == JSL_STRING_LIFETIME_SHORTER)\r\n"
         "            hash_map->values_array[slot] = jsl_duplicate(hash_map->allocator, value);\r\n"
         "        else\r\n"
@@ -791,14 +1288,20 @@
         "        hash_map->values_array[slot] = value;\r\n"
         "        {% endif %}\r\n"
         "\r\n"
+        "        {% if control_bytes %}\r\n"
+        "        {{ function_prefix }}_set_control(hash_map, slot, (uint8_t) (hash & 0x7Fu));\r\n"
+        "        {% else %}\r\n"
         "        hash_map->hashes_array[slot] = hash;\r\n"
+        "        {% endif %}\r\n"
         "        ++hash_map->item_count;\r\n"
         "        insert_success = true;\r\n"
         "    }\r\n"
         "    // update\r\n"
         "    else if (slot > -1 && existing_found)\r\n"
         "    {\r\n"
-        "        {% if value_is_str %}\r\n"
+        "        {% if is_set %}\r\n"
+        "        // already in the set, nothing to change\r\n"
+        "        {% elif value_is_str %}\r\n"
         "        if (hash_map->value_lifetime_array[slot] == JSL_STRING_LIFETIME_SHORTER)\r\n"
         "            jsl_allocator_interface_free(hash_map->allocator, hash_map->values_array[slot].data);\r\n"
         "\r\n"
@@ -823,12 +1326,8 @@
         "    return insert_success;\r\n"
         "}\r\n"
         "\r\n"
-        "{% if value_is_str %}\r\n"
-        "JSLImmutableMemory {{ function_prefix }}_get(\r\n"
-        "{% else %}\r\n"
-        "{{ value_type_name }}* {{ function_prefix }}_get(\r\n"
-        "{% endif %}\r\n"
-        "\r\n"
+        "{% if is_set %}\r\n"
+        "bool {{ function_prefix }}_has(\r\n"
         "    {{ hash_map_name }}* hash_map,\r\n"
         "    {% if key_is_str %}\r\n"
         "    JSLImmutableMemory key\r\n"
@@ -839,18 +1338,59 @@
         "    {% endif %}\r\n"
         ")\r\n"
         "{\r\n"
-        "    {% if value_is_str %}\r\n"
-        "    JSLImmutableMemory res = {0};\r\n"
-        "    {% else %}\r\n"
-        "    {{ value_type_name }}* res = NULL;\r\n"
-        "    {% endif %}\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "        || hash_map->keys_array == NULL\r\n"
+        "        {% if control_bytes %}\r\n"
+        "        || hash_map->control_array == NULL\r\n"
+        "        {% else %}\r\n"
+        "        || hash_map->hashes_array == NULL\r\n"
+        "        {% endif %}\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    uint64_t hash = 0;\r\n"
+        "    int64_t slot = -1;\r\n"
+        "    bool existing_found = false;\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_probe(hash_map, key, &slot, &hash, &existing_found);\r\n"
+        "\r\n"
+        "    return slot > -1 && existing_found;\r\n"
+        "}\r\n"
+        "{% else %}\r\n"
+        "{% if value_is_str %}\r\n"
+        "JSLImmutableMemory {{ function_prefix }}_get(\r\n"
+        "{% else %}\r\n"
+        "{{ value_type_name }}* {{ function_prefix }}_get(\r\n"
+        "{% endif %}\r\n"
+        "\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    {% if value_is_str %}\r\n"
+        "    JSLImmutableMemory res = {0};\r\n"
+        "    {% else %}\r\n"
+        "    {{ value_type_name }}* res = NULL;\r\n"
+        "    {% endif %}\r\n"
         "\r\n"
         "    if (\r\n"
         "        hash_map == NULL\r\n"
         "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
         "        || hash_map->values_array == NULL\r\n"
         "        || hash_map->keys_array == NULL\r\n"
+        "        {% if control_bytes %}\r\n"
+        "        || hash_map->control_array == NULL\r\n"
+        "        {% else %}\r\n"
         "        || hash_map->hashes_array == NULL\r\n"
+        "        {% endif %}\r\n"
         "    )\r\n"
         "        return res;\r\n"
         "\r\n"
@@ -871,6 +1411,7 @@
         "\r\n"
         "    return res;\r\n"
         "}\r\n"
+        "{% endif %}\r\n"
         "\r\n"
         "bool {{ function_prefix }}_delete(\r\n"
         "    {{ hash_map_name }}* hash_map,\r\n"
@@ -888,9 +1429,16 @@
         "    if (\r\n"
         "        hash_map == NULL\r\n"
         "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "        {% if is_set %}\r\n"
+        "        {% else %}\r\n"
         "        || hash_map->values_array == NULL\r\n"
+        "        {% endif %}\r\n"
         "        || hash_map->keys_array == NULL\r\n"
+        "        {% if control_bytes %}\r\n"
+        "        || hash_map->control_array == NULL\r\n"
+        "        {% else %}\r\n"
         "        || hash_map->hashes_array == NULL\r\n"
+        "        {% endif %}\r\n"
         "    )\r\n"
         "        return success;\r\n"
         "\r\n"
@@ -901,6 +1449,15 @@
         "\r\n"
         "    if (slot > -1 && existing_found)\r\n"
         "    {\r\n"
+        "        {% if key_is_str %}\r\n"
+        "        if (hash_map->key_lifetime_array[slot] == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "            jsl_allocator_interface_free(hash_map->allocator, hash_map->keys_array[slot].data);\r\n"
+        "        {% endif %}\r\n"
+        "        {% if value_is_str %}\r\n"
+        "        if (hash_map->value_lifetime_array[slot] == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "            jsl_allocator_interface_free(hash_map->allocator, hash_map->values_array[slot].data);\r\n"
+        "        {% endif %}\r\n"
+        "\r\n"
         "        {{ function_prefix }}_backshift(hash_map, slot);\r\n"
         "        --hash_map->item_count;\r\n"
         "        ++hash_map->generational_id;\r\n"
@@ -923,16 +1480,20 @@
         "    {% if key_is_str or value_is_str %}\r\n"
         "    for (int64_t current_slot = 0; current_slot < hash_map->arrays_length; ++current_slot)\r\n"
         "    {\r\n"
-        "        uint64_t hash_value = hash_map->hashes_array[current_slot];\r\n"
+        "        {% if control_bytes %}\r\n"
+        "        bool occupied = hash_map->control_array[current_slot] != JSL__HASHMAP_CONTROL_EMPTY;\r\n"
+        "        {% else %}\r\n"
+        "        bool occupied = hash_map->hashes_array[current_slot] != JSL__HASHMAP_EMPTY;\r\n"
+        "        {% endif %}\r\n"
         "        {% if key_is_str %}\r\n"
         "        JSLStringLifeTime lifetime = hash_map->key_lifetime_array[current_slot];\r\n"
-        "        if (hash_value != JSL__HASHMAP_EMPTY && lifetime == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "        if (occupied && lifetime == JSL_STRING_LIFETIME_SHORTER)\r\n"
         "        {\r\n"
         "            jsl_allocator_interface_free(hash_map->allocator, hash_map->keys_array[current_slot].data);\r\n"
         "        }\r\n"
         "        {% elif value_is_str %}\r\n"
         "        JSLStringLifeTime lifetime = hash_map->value_lifetime_array[current_slot];\r\n"
-        "        if (hash_value != JSL__HASHMAP_EMPTY && lifetime == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "        if (occupied && lifetime == JSL_STRING_LIFETIME_SHORTER)\r\n"
         "        {\r\n"
         "            jsl_allocator_interface_free(hash_map->allocator, hash_map->values_array[current_slot].data);\r\n"
         "        }\r\n"
@@ -948,8 +1509,60 @@
         "    {% endif %}\r\n"
         "\r\n"
         "    jsl_allocator_interface_free(hash_map->allocator, hash_map->keys_array);\r\n"
+        "    {% if is_set %}\r\n"
+        "    {% else %}\r\n"
         "    jsl_allocator_interface_free(hash_map->allocator, hash_map->values_array);\r\n"
+        "    {% endif %}\r\n"
+        "    {% if control_bytes %}\r\n"
+        "    jsl_allocator_interface_free(hash_map->allocator, hash_map->control_array);\r\n"
+        "    {% else %}\r\n"
         "    jsl_allocator_interface_free(hash_map->allocator, hash_map->hashes_array);\r\n"
+        "    {% endif %}\r\n"
+        "}\r\n"
+        "\r\n"
+        "int64_t {{ function_prefix }}_memory_footprint(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return -1;\r\n"
+        "\r\n"
+        "    int64_t bytes = {{ function_prefix }}_arrays_bytes(hash_map->arrays_length);\r\n"
+        "\r\n"
+        "    {% if key_is_str or value_is_str %}\r\n"
+        "    for (int64_t current_slot = 0; current_slot < hash_map->arrays_length; ++current_slot)\r\n"
+        "    {\r\n"
+        "        {% if control_bytes %}\r\n"
+        "        bool occupied = hash_map->control_array[current_slot] != JSL__HASHMAP_CONTROL_EMPTY;\r\n"
+        "        {% else %}\r\n"
+        "        bool occupied = hash_map->hashes_array[current_slot] != JSL__HASHMAP_EMPTY;\r\n"
+        "        {% endif %}\r\n"
+        "        {% if key_is_str %}\r\n"
+        "        if (occupied && hash_map->key_lifetime_array[current_slot] == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "            bytes += hash_map->keys_array[current_slot].length;\r\n"
+        "        {% endif %}\r\n"
+        "        {% if value_is_str %}\r\n"
+        "        if (occupied && hash_map->value_lifetime_array[current_slot] == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "            bytes += hash_map->values_array[current_slot].length;\r\n"
+        "        {% endif %}\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    {% endif %}\r\n"
+        "    return bytes;\r\n"
+        "}\r\n"
+        "\r\n"
+        "int64_t {{ function_prefix }}_memory_footprint_for(\r\n"
+        "    int64_t max_item_count\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    // Keeps the float division and the power of two rounding well in range\r\n"
+        "    if (max_item_count < 0 || max_item_count > INT64_MAX / 8)\r\n"
+        "        return -1;\r\n"
+        "\r\n"
+        "    return {{ function_prefix }}_arrays_bytes({{ function_prefix }}_arrays_length_for(max_item_count));\r\n"
         "}\r\n"
         "\r\n"
         "bool {{ function_prefix }}_iterator_start(\r\n"
@@ -972,6 +1585,15 @@
         "\r\n"
         "bool {{ function_prefix }}_iterator_next(\r\n"
         "    {{ hash_map_name }}Iterator* iterator,\r\n"
+        "{% if is_set %}\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory* out_key\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}** out_key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }}* out_key\r\n"
+        "    {% endif %}\r\n"
+        "{% else %}\r\n"
         "    {% if key_is_str %}\r\n"
         "    JSLImmutableMemory* out_key,\r\n"
         "    {% elif key_is_struct %}\r\n"
@@ -984,6 +1606,7 @@
         "    {% else %}\r\n"
         "    {{ value_type_name }}* out_value\r\n"
         "    {% endif %}\r\n"
+        "{% endif %}\r\n"
         ")\r\n"
         "{\r\n"
         "    bool found = false;\r\n"
@@ -993,9 +1616,16 @@
         "        || iterator->hash_map == NULL\r\n"
         "        || iterator->hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
         "        || iterator->hash_map->generational_id != iterator->generational_id\r\n"
+        "        {% if is_set %}\r\n"
+        "        {% else %}\r\n"
         "        || iterator->hash_map->values_array == NULL\r\n"
+        "        {% endif %}\r\n"
         "        || iterator->hash_map->keys_array == NULL\r\n"
+        "        {% if control_bytes %}\r\n"
+        "        || iterator->hash_map->control_array == NULL\r\n"
+        "        {% else %}\r\n"
         "        || iterator->hash_map->hashes_array == NULL\r\n"
+        "        {% endif %}\r\n"
         "    )\r\n"
         "        return found;\r\n"
         "\r\n"
@@ -1003,9 +1633,13 @@
         "\r\n"
         "    while (iterator->current_slot < iterator->hash_map->arrays_length)\r\n"
         "    {\r\n"
+        "        {% if control_bytes %}\r\n"
+        "        bool occupied = iterator->hash_map->control_array[iterator->current_slot] != JSL__HASHMAP_CONTROL_EMPTY;\r\n"
+        "        {% else %}\r\n"
         "        uint64_t hash_value = iterator->hash_map->hashes_array[iterator->current_slot];\r\n"
         "\r\n"
         "        bool occupied = hash_value != JSL__HASHMAP_EMPTY;\r\n"
+        "        {% endif %}\r\n"
         "\r\n"
         "        if (occupied)\r\n"
         "        {\r\n"
@@ -1025,7 +1659,10 @@
         "        {% else %}\r\n"
         "        *out_key = iterator->hash_map->keys_array[iterator->current_slot];\r\n"
         "        {% endif %}\r\n"
+        "        {% if is_set %}\r\n"
+        "        {% else %}\r\n"
         "        *out_value = iterator->hash_map->values_array[iterator->current_slot];\r\n"
+        "        {% endif %}\r\n"
         "        ++iterator->current_slot;\r\n"
         "        found = true;\r\n"
         "    }\r\n"
@@ -1040,319 +1677,2962 @@
     );
 
     static JSLImmutableMemory dynamic_header_template = JSL_CSTR_INITIALIZER(
-        "#pragma once\r\n"
-        "\r\n"
-        "#include <stdint.h>\r\n"
-        "#include <stddef.h>\r\n"
-        "#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L\r\n"
-        "    #include <stdbool.h>\r\n"
-        "#endif\r\n"
-        "\r\n"
-        "#include \"jsl/core.h\"\r\n"
-        "#include \"jsl/hash_map_common.h\"\r\n"
-        "\r\n"
-        "#ifdef __cplusplus\r\n"
-        "extern \"C\" {\r\n"
-        "#endif\r\n"
-        "\r\n"
-        "struct {{ hash_map_name }}Entry {\r\n"
-        "    uint64_t hash;\r\n"
-        "    {{ key_type_name }} key;\r\n"
-        "    {{ value_type_name }} value;\r\n"
-        "};\r\n"
-        "\r\n"
-        "/**\r\n"
-        " * State tracking struct for iterating over all of the keys and values\r\n"
-        " * in the map.\r\n"
-        " * \r\n"
-        " * @note If you mutate the map this iterator is automatically invalidated\r\n"
-        " * and any operations on this iterator will terminate with failure return\r\n"
-        " * values.\r\n"
-        " * \r\n"
-        " * ## Functions\r\n"
-        " *\r\n"
-        " *  * jsl_str_to_str_map_key_value_iterator_init\r\n"
-        " *  * jsl_str_to_str_map_key_value_iterator_next\r\n"
-        " */\r\n"
-        "typedef struct {{ hash_map_name }}KeyValueIter {\r\n"
-        "    struct JSL__StrToStrMap* map;\r\n"
-        "    int64_t current_lut_index;\r\n"
-        "    int64_t generational_id;\r\n"
-        "    uint64_t sentinel;\r\n"
-        "} {{ hash_map_name }}KeyValueIter;\r\n"
-        "\r\n"
-        "/**\r\n"
-        " * This is an open addressed hash map with linear probing that maps\r\n"
-        " * {{ key_type_name }} keys to {{ value_type_name }} values. This map uses\r\n"
-        " * rapidhash, which is a avalanche hash with a configurable seed\r\n"
-        " * value for protection against hash flooding attacks.\r\n"
-        " * \r\n"
-        " * Example:\r\n"
+        "/**\r\n"
+        " * AUTO GENERATED FILE\r\n"
         " *\r\n"
-        " * ```\r\n"
-        " * uint8_t buffer[JSL_KILOBYTES(16)];\r\n"
-        " * JSLArena stack_arena = JSL_ARENA_FROM_STACK(buffer);\r\n"
-        " *\r\n"
-        " * {{ hash_map_name }} map;\r\n"
-        " * jsl_str_to_str_map_init(&map, &stack_arena, 0);\r\n"
-        " *\r\n"
-        " * JSLFatPtr key = JSL_FATPTR_INITIALIZER(\"hello-key\");\r\n"
-        " * \r\n"
-        " * jsl_str_to_str_multimap_insert(\r\n"
-        " *     &map,\r\n"
-        " *     key,\r\n"
-        " *     JSL_STRING_LIFETIME_LONGER,\r\n"
-        " *     JSL_FATPTR_EXPRESSION(\"hello-value\"),\r\n"
-        " *     JSL_STRING_LIFETIME_LONGER\r\n"
-        " * );\r\n"
-        " * \r\n"
-        " * {{ value_type_name }} value;\r\n"
-        " * jsl_str_to_str_map_get(&map, key, &value);\r\n"
-        " * ```\r\n"
-        " * \r\n"
-        " * ## Functions\r\n"
-        " *\r\n"
-        " *  * {{ function_prefix }}_init\r\n"
-        " *  * {{ function_prefix }}_init2\r\n"
-        " *  * {{ function_prefix }}_item_count\r\n"
-        " *  * {{ function_prefix }}_has_key\r\n"
-        " *  * {{ function_prefix }}_insert\r\n"
-        " *  * {{ function_prefix }}_get\r\n"
-        " *  * {{ function_prefix }}_key_value_iterator_init\r\n"
-        " *  * {{ function_prefix }}_key_value_iterator_next\r\n"
-        " *  * {{ function_prefix }}_delete\r\n"
-        " *  * {{ function_prefix }}_clear\r\n"
+        "{% if is_set and key_is_str %}\r\n"
+        " * This file contains the header for a hash set `{{ hash_map_name }}` of\r\n"
+        " * `JSLImmutableMemory` values.\r\n"
+        "{% elif is_set %}\r\n"
+        " * This file contains the header for a hash set `{{ hash_map_name }}` of\r\n"
+        " * `{{ key_type_name }}` values.\r\n"
+        "{% elif key_is_str %}\r\n"
+        " * This file contains the header for a hash map `{{ hash_map_name }}` which maps\r\n"
+        " * `JSLImmutableMemory` keys to `{{ value_type_name }}` values.\r\n"
+        "{% elif value_is_str %}\r\n"
+        " * This file contains the header for a hash map `{{ hash_map_name }}` which maps\r\n"
+        " * `{{ key_type_name }}` keys to `JSLImmutableMemory` values.\r\n"
+        "{% else %}\r\n"
+        " * This file contains the header for a hash map `{{ hash_map_name }}` which maps\r\n"
+        " * `{{ key_type_name }}` keys to `{{ value_type_name }}` values.\r\n"
+        "{% endif %}\r\n"
+        " *\r\n"
+        " * This hash map is for situations where there's no reasonable upper bound on the\r\n"
+        " * number of items. The table doubles in size whenever it goes over the load factor.\r\n"
+        " * If you do know the upper bound, use the fixed version of this map instead, it\r\n"
+        " * never has to rehash and has one less failure mode.\r\n"
+        " *\r\n"
+        " * By default all of the entries are moved into the bigger table at once, which makes\r\n"
+        " * that one insert much slower than the rest. Latency sensitive code can turn on\r\n"
+        " * incremental rehashing, which spreads the move out over the following inserts and\r\n"
+        " * deletes.\r\n"
+        " *\r\n"
+        " * This file was auto generated from the hash map generation utility that's part of\r\n"
+        " * the \"Jack's Standard Library\" project. The utility generates a header file and a\r\n"
+        " * C file for a type safe, open addressed, hash map. By generating the code rather\r\n"
+        " * than using macros, two benefits are gained. One, the code is much easier to debug.\r\n"
+        " * Two, it's much more obvious how much code you're generating, which means you are\r\n"
+        " * much less likely to accidentally create the combinatoric explosion of code that's\r\n"
+        " * so common in C++ projects. Adding friction to things is actually good sometimes.\r\n"
+        " *\r\n"
+        " * ## LICENSE\r\n"
+        " *\r\n"
+        " * Copyright (c) 2026 Jack Stouffer\r\n"
         " *\r\n"
+        " * Permission is hereby granted, free of charge, to any person obtaining a\r\n"
+        " * copy of this software and associated documentation files (the \"Software\"),\r\n"
+        " * to deal in the Software without restriction, including without limitation\r\n"
+        " * the rights to use, copy, modify, merge, publish, distribute, sublicense,\r\n"
+        " * and/or sell copies of the Software, and to permit persons to whom the Software\r\n"
+        " * is furnished to do so, subject to the following conditions:\r\n"
+        " *\r\n"
+        " * The above copyright notice and this permission notice shall be included in all\r\n"
+        " * copies or substantial portions of the Software.\r\n"
+        " *\r\n"
+        " * THE SOFTWARE IS PROVIDED \"AS IS\", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR\r\n"
+        " * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,\r\n"
+        " * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE\r\n"
+        " * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,\r\n"
+        " * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN\r\n"
+        " * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.\r\n"
+        " */\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * The slot arrays of one table. The keys, values, and hashes are each kept in\r\n"
+        " * their own array so probing only has to touch the hashes until it finds a match.\r\n"
+        " */\r\n"
+        "typedef struct {{ hash_map_name }}Table {\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory* keys_array;\r\n"
+        "    JSLStringLifeTime* key_lifetime_array;\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }}* keys_array;\r\n"
+        "    {% endif %}\r\n"
+        "\r\n"
+        "    {% if is_set %}\r\n"
+        "    {% elif value_is_str %}\r\n"
+        "    JSLImmutableMemory* values_array;\r\n"
+        "    JSLStringLifeTime* value_lifetime_array;\r\n"
+        "    {% else %}\r\n"
+        "    {{ value_type_name }}* values_array;\r\n"
+        "    {% endif %}\r\n"
+        "\r\n"
+        "    uint64_t* hashes_array;\r\n"
+        "    int64_t arrays_length;\r\n"
+        "} {{ hash_map_name }}Table;\r\n"
+        "\r\n"
+        "/**\r\n"
+        "{% if is_set %}\r\n"
+        " * A hash set of `{{ key_type_name }}` values. It's the same table as the\r\n"
+        " * generated hash maps with the values array left out.\r\n"
+        "{% else %}\r\n"
+        " * A hash map which maps `{{ key_type_name }}` keys to `{{ value_type_name }}` values.\r\n"
+        "{% endif %}\r\n"
+        " *\r\n"
+        " * This hash map uses open addressing with linear probing and backshift deletion,\r\n"
+        " * and grows by doubling the table when the load factor is reached.\r\n"
         " */\r\n"
         "typedef struct {{ hash_map_name }} {\r\n"
         "    // putting the sentinel first means it's much more likely to get\r\n"
         "    // corrupted from accidental overwrites, therefore making it\r\n"
         "    // more likely that memory bugs are caught.\r\n"
-        "    uint64_t sentinel;\r\n"
-        "\r\n"
-        "    JSLArena* arena;\r\n"
+        "    uint32_t sentinel;\r\n"
+        "    uint32_t generational_id;\r\n"
+        "    JSLAllocatorInterface allocator;\r\n"
         "\r\n"
-        "    {{ hash_map_name }}Entry* entry_array;\r\n"
-        "    int64_t entry_array_length;\r\n"
+        "    {{ hash_map_name }}Table table;\r\n"
+        "    /// @brief previous table while an incremental rehash is in progress, all NULL otherwise\r\n"
+        "    {{ hash_map_name }}Table old_table;\r\n"
+        "    /// @brief next slot of the old table to move into the current one\r\n"
+        "    int64_t rehash_migrate_index;\r\n"
+        "    /// @brief old table slots moved per insert or delete, zero when incremental rehashing is off\r\n"
+        "    int64_t rehash_step;\r\n"
         "\r\n"
+        "    /// @brief number of items in both tables\r\n"
         "    int64_t item_count;\r\n"
-        "    int64_t tombstone_count;\r\n"
-        "\r\n"
-        "    uint64_t seed;\r\n"
         "    float load_factor;\r\n"
-        "    int32_t generational_id;\r\n"
+        "    uint64_t seed;\r\n"
         "} {{ hash_map_name }};\r\n"
         "\r\n"
         "/**\r\n"
-        " * Initialize a map with default sizing parameters.\r\n"
+        " * Iterator type which is used by the iterator functions to\r\n"
+        " * allow you to loop over the hash map contents.\r\n"
+        " */\r\n"
+        "typedef struct {{ hash_map_name }}Iterator {\r\n"
+        "    {{ hash_map_name }}* hash_map;\r\n"
+        "    /// @brief slots of the old table come first, then the slots of the current table\r\n"
+        "    int64_t current_slot;\r\n"
+        "    uint64_t generational_id;\r\n"
+        "} {{ hash_map_name }}Iterator;\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Initialize a map with a 32 item initial capacity and a 0.75 load factor.\r\n"
         " *\r\n"
-        " * This sets up internal tables in the provided arena, using a 32 entry\r\n"
-        " * initial capacity guess and a 0.75 load factor. The `seed` value is to\r\n"
-        " * protect against hash flooding attacks. If you're absolutely sure this\r\n"
-        " * map cannot be attacked, then zero is valid seed value.\r\n"
+        " * @warning This hash map uses a well distributed hash. But in order to properly protect against\r\n"
+        " * hash flooding attacks you must do two things. One, provide good random data for the\r\n"
+        " * seed value. This means using your OS's secure random number generator, not `rand`.\r\n"
+        " * As this is very platform specific JSL does not come with a mechanism for getting these\r\n"
+        " * random numbers; you must do it yourself. Two, use a different seed value as often as\r\n"
+        " * possible, ideally every user interaction. This would make hash flooding attacks almost\r\n"
+        " * impossible. If you are absolutely sure that this hash map cannot be attacked with hash\r\n"
+        " * flooding then zero is a valid seed value.\r\n"
         " *\r\n"
-        " * @param map Pointer to the map to initialize.\r\n"
-        " * @param arena Arena used for all allocations.\r\n"
-        " * @param seed Arbitrary seed value for hashing.\r\n"
-        " * @return `true` on success, `false` if any parameter is invalid or out of memory.\r\n"
+        " * @param hash_map The pointer to the hash map instance to initialize\r\n"
+        " * @param allocator The allocator that this hash map will use\r\n"
+        " * @param seed Seed value for the hash function to protect against hash flooding attacks\r\n"
+        " * @returns `true` on success, `false` if any parameter is invalid or out of memory.\r\n"
         " */\r\n"
         "bool {{ function_prefix }}_init(\r\n"
-        "    {{ hash_map_name }}* map,\r\n"
-        "    JSLArena* arena,\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    JSLAllocatorInterface allocator,\r\n"
         "    uint64_t seed\r\n"
         ");\r\n"
         "\r\n"
         "/**\r\n"
         " * Initialize a map with explicit sizing parameters.\r\n"
         " *\r\n"
-        " * This is identical to `jsl_str_to_str_map_init`, but lets callers\r\n"
-        " * provide an initial `item_count_guess` and a `load_factor`. The initial\r\n"
-        " * lookup table is sized to the next power of two above `item_count_guess`,\r\n"
-        " * clamped to at least 32 entries. `load_factor` must be in the range\r\n"
-        " * `(0.0f, 1.0f)` and controls when the table rehashes. The `seed` value\r\n"
-        " * is to protect against hash flooding attacks. If you're absolutely sure \r\n"
-        " * this map cannot be attacked, then zero is valid seed value\r\n"
-        " *\r\n"
-        " * @param map Pointer to the map to initialize.\r\n"
-        " * @param arena Arena used for all allocations.\r\n"
-        " * @param seed Arbitrary seed value for hashing.\r\n"
-        " * @param item_count_guess Expected max number of keys\r\n"
-        " * @param load_factor Desired load factor before rehashing\r\n"
-        " * @return `true` on success, `false` if any parameter is invalid or out of memory.\r\n"
+        " * The table starts out big enough to hold `item_count_guess` items without\r\n"
+        " * growing, and never smaller than 32 slots. `load_factor` must be in the range\r\n"
+        " * `(0.0f, 1.0f)` and controls when the table grows.\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance to initialize\r\n"
+        " * @param allocator The allocator that this hash map will use\r\n"
+        " * @param seed Seed value for the hash function to protect against hash flooding attacks\r\n"
+        " * @param item_count_guess Expected max number of items\r\n"
+        " * @param load_factor Desired load factor before growing\r\n"
+        " * @returns `true` on success, `false` if any parameter is invalid or out of memory.\r\n"
         " */\r\n"
         "bool {{ function_prefix }}_init2(\r\n"
-        "    {{ hash_map_name }}* map,\r\n"
-        "    JSLArena* arena,\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    JSLAllocatorInterface allocator,\r\n"
         "    uint64_t seed,\r\n"
         "    int64_t item_count_guess,\r\n"
         "    float load_factor\r\n"
         ");\r\n"
         "\r\n"
         "/**\r\n"
-        " * Does the map have the given key.\r\n"
+        "{% if is_set %}\r\n"
+        " * Insert the given value into the set. Inserting a value which is already\r\n"
+        " * in the set doesn't change anything. If the value type for this set is a\r\n"
+        " * pointer, then NULL is a valid value.\r\n"
+        "{% else %}\r\n"
+        " * Insert the given value into the hash map. If the key already exists in\r\n"
+        " * the map the value will be overwritten. If the key type for this hash map\r\n"
+        " * is a pointer, then a NULL key is a valid key type.\r\n"
+        "{% endif %}\r\n"
+        " *\r\n"
+        "{% if key_is_struct %}\r\n"
+        " * With struct keys, struct padding can be filled with random-ish, garbage bytes.\r\n"
+        " * This will cause the hash probe to fail. It is *very* important to either\r\n"
+        " * 1, initialize the struct with memset to zero 2, use a canonicalization function\r\n"
+        " * before using the struct in the hash map or 3. use a custom comparison function\r\n"
+        " * (requires regenerating the source with the proper command line option). Do not\r\n"
+        " * rely on `{0}` init! The compiler is allowed to cheat and skip padding bytes.\r\n"
         " *\r\n"
-        " * @param map Pointer to the map.\r\n"
-        " * @return `true` if yes, `false` if no or error\r\n"
+        "{% endif %}\r\n"
+        " * @param hash_map The pointer to the hash map instance\r\n"
+        " * @param key Hash map key\r\n"
+        "{% if is_set %}\r\n"
+        " * @returns `true` on success, `false` on invalid parameters or out of memory.\r\n"
         " */\r\n"
-        "bool {{ function_prefix }}_has_key(\r\n"
-        "    {{ hash_map_name }}* map,\r\n"
+        "bool {{ function_prefix }}_insert(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key,\r\n"
+        "    JSLStringLifeTime key_lifetime\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
         "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
         ");\r\n"
-        "\r\n"
-        "/**\r\n"
-        " * Insert a key/value pair.\r\n"
-        " *\r\n"
-        " * @param map Map to mutate.\r\n"
-        " * @param key Key to insert.\r\n"
-        " * @param key_lifetime Lifetime semantics for the key data.\r\n"
-        " * @param value Value to insert.\r\n"
-        " * @param value_lifetime Lifetime semantics for the value data.\r\n"
-        " * @return `true` on success, `false` on invalid parameters or OOM.\r\n"
+        "{% else %}\r\n"
+        " * @param value Value to store\r\n"
+        " * @returns `true` on success, `false` on invalid parameters or out of memory.\r\n"
         " */\r\n"
         "bool {{ function_prefix }}_insert(\r\n"
-        "    {{ hash_map_name }}* map,\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key,\r\n"
+        "    JSLStringLifeTime key_lifetime,\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key,\r\n"
+        "    {% else %}\r\n"
         "    {{ key_type_name }} key,\r\n"
+        "    {% endif %}\r\n"
+        "    {% if value_is_str %}\r\n"
+        "    JSLImmutableMemory value,\r\n"
+        "    JSLStringLifeTime value_lifetime\r\n"
+        "    {% else %}\r\n"
         "    {{ value_type_name }} value\r\n"
+        "    {% endif %}\r\n"
         ");\r\n"
+        "{% endif %}\r\n"
         "\r\n"
+        "{% if is_set %}\r\n"
         "/**\r\n"
-        " * Get the value of the key.\r\n"
+        " * Check if the value is in the set.\r\n"
         " *\r\n"
-        " * @param map Map to search.\r\n"
-        " * @param key Key to search for.\r\n"
-        " * @param out_value Output parameter that will be filled with the value if successful\r\n"
-        " * @returns A bool indicating success or failure\r\n"
+        " * @param hash_map The pointer to the hash set instance\r\n"
+        " * @param key Value to look for\r\n"
+        " * @returns true if the value is in the set.\r\n"
         " */\r\n"
-        "bool {{ function_prefix }}_get(\r\n"
-        "    {{ hash_map_name }}* map,\r\n"
-        "    {{ key_type_name }} key,\r\n"
-        "    {{ value_type_name }}* out_value\r\n"
-        ");\r\n"
-        "\r\n"
-        "/**\r\n"
-        " * Initialize an iterator that visits every key/value pair in the map.\r\n"
-        " * \r\n"
-        " * Example:\r\n"
-        " *\r\n"
-        " * ```\r\n"
-        " * {{ hash_map_name }}KeyValueIter iter;\r\n"
-        " * {{ function_prefix }}_key_value_iterator_init(\r\n"
-        " *     &map, &iter\r\n"
-        " * );\r\n"
-        " * \r\n"
-        " * {{ key_type_name }} key;\r\n"
-        " * {{ value_type_name }} value;\r\n"
-        " * while ({{ function_prefix }}_key_value_iterator_next(&iter, &key, &value))\r\n"
+        "bool {{ function_prefix }}_has(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ");\r\n"
+        "{% else %}\r\n"
+        "/**\r\n"
+        " * Get a value from the hash map if it exists. If it does not NULL is returned\r\n"
+        " *\r\n"
+        " * The pointer returned actually points to value stored inside of hash map.\r\n"
+        " * You can change the value though the pointer. Entries move when the map\r\n"
+        " * is changed, so the pointer is only valid until the next insert or delete.\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance\r\n"
+        " * @param key Hash map key\r\n"
+        " * @returns The pointer to the value in the hash map, or null.\r\n"
+        " */\r\n"
+        "{% if value_is_str %}\r\n"
+        "JSLImmutableMemory {{ function_prefix }}_get(\r\n"
+        "{% else %}\r\n"
+        "{{ value_type_name }}* {{ function_prefix }}_get(\r\n"
+        "{% endif %}\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ");\r\n"
+        "{% endif %}\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Remove a key/value pair from the hash map if it exists.\r\n"
+        " * If it does not false is returned.\r\n"
+        " *\r\n"
+        " * Deletion uses backshift instead of tombstones, so a map with a lot\r\n"
+        " * of churn never gets slower or needs to be rebuilt.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_delete(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Get the number of items in the map.\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance\r\n"
+        " * @returns The item count, or -1 on invalid parameters.\r\n"
+        " */\r\n"
+        "int64_t {{ function_prefix }}_item_count(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Remove all keys and values from the map. The table keeps its current size.\r\n"
+        " * Iterators become invalid.\r\n"
+        " */\r\n"
+        "void {{ function_prefix }}_clear(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Spread future rehashes out over many operations instead of doing them all\r\n"
+        " * at once.\r\n"
+        " *\r\n"
+        " * When the map grows, the new table is allocated and the old one is kept.\r\n"
+        " * Each following insert or delete moves `slots_per_operation` slots of the\r\n"
+        " * old table into the new one until the old table is empty and freed.\r\n"
+        " * Lookups check both tables in the meantime and never move entries.\r\n"
+        " *\r\n"
+        " * This bounds the worst case insert time at the cost of slightly slower\r\n"
+        " * lookups, and the memory of both tables, while a rehash is in progress.\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance\r\n"
+        " * @param slots_per_operation Old table slots to move per operation, or zero\r\n"
+        " * to turn incremental rehashing off, which finishes any rehash in progress.\r\n"
+        " * @returns `true` on success, `false` on invalid parameters.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_enable_incremental_rehash(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    int64_t slots_per_operation\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Move every remaining entry of an in progress incremental rehash into the\r\n"
+        " * current table and free the old table. Does nothing if no rehash is in\r\n"
+        " * progress. Iterators become invalid.\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance\r\n"
+        " * @returns `true` on success, `false` on invalid parameters.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_finish_rehash(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Grow the table once so that `item_count` items fit without any more\r\n"
+        " * growth along the way. Does nothing if the table is already big enough.\r\n"
+        " * Any rehash in progress is finished first. Iterators become invalid.\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance\r\n"
+        " * @param item_count Number of items the map should hold\r\n"
+        " * @returns `true` on success, `false` on invalid parameters or out of memory.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_reserve(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    int64_t item_count\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Move the items into the smallest table that holds them at the configured\r\n"
+        " * load factor, never smaller than 32 slots, and free the old table. Any\r\n"
+        " * rehash in progress is finished first. Useful after a burst of deletes.\r\n"
+        " * Iterators become invalid.\r\n"
+        " *\r\n"
+        " * If the new table can't be allocated the map is left as it was.\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance\r\n"
+        " * @returns `true` on success, `false` on invalid parameters or out of memory.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_shrink_to_fit(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Get the number of bytes this hash map holds from its allocator, which is\r\n"
+        " * the arrays of the current table, the old table while a rehash is in\r\n"
+        " * progress, and the copies of keys and values inserted with\r\n"
+        " * `JSL_STRING_LIFETIME_SHORTER`. Allocator bookkeeping and alignment padding\r\n"
+        " * aren't included.\r\n"
+        "{% if key_is_str or value_is_str %}\r\n"
+        " *\r\n"
+        " * Counting the string copies walks the whole table, so avoid calling this\r\n"
+        " * after every insert.\r\n"
+        "{% endif %}\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance\r\n"
+        " * @returns The size in bytes, or -1 on invalid parameters.\r\n"
+        " */\r\n"
+        "int64_t {{ function_prefix }}_memory_footprint(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Get the number of bytes of the table a map needs to hold `item_count`\r\n"
+        " * items at `load_factor` without growing, which is what init2 or reserve\r\n"
+        " * allocate for them. Use this to size a map to a memory budget.\r\n"
+        "{% if key_is_str or value_is_str %}\r\n"
+        " *\r\n"
+        " * Copies of strings with `JSL_STRING_LIFETIME_SHORTER` are allocated on insert\r\n"
+        " * and aren't part of this number.\r\n"
+        "{% endif %}\r\n"
+        " *\r\n"
+        " * @param item_count Number of items\r\n"
+        " * @param load_factor Load factor in the range `(0.0f, 1.0f)`\r\n"
+        " * @returns The size in bytes, or -1 on invalid or too large parameters.\r\n"
+        " */\r\n"
+        "int64_t {{ function_prefix }}_memory_footprint_for(\r\n"
+        "    int64_t item_count,\r\n"
+        "    float load_factor\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Free all the underlying memory that was allocated by this hash map on the given\r\n"
+        " * allocator.\r\n"
+        " */\r\n"
+        "void {{ function_prefix }}_free(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Create a new iterator over this hash map.\r\n"
+        " *\r\n"
+        " * An iterator is a struct which holds enough state that it allows a loop to visit\r\n"
+        " * each key/value pair in the hash map.\r\n"
+        " *\r\n"
+        " * Iterating over a hash map while modifying it does not have guaranteed\r\n"
+        " * correctness. Any insertion or deletion after the iterator is created will\r\n"
+        " * invalidate the iteration.\r\n"
+        " *\r\n"
+        " * Example usage:\r\n"
+        " * @code\r\n"
+        " * {{ key_type_name }} key;\r\n"
+        "{% if is_set %}\r\n"
+        " * {{ hash_map_name }}Iterator iterator;\r\n"
+        " * {{ function_prefix }}_iterator_start(hash_map, &iterator);\r\n"
+        " * while ({{ function_prefix }}_iterator_next(&iterator, &key))\r\n"
+        "{% else %}\r\n"
+        " * {{ value_type_name }} value;\r\n"
+        " * {{ hash_map_name }}Iterator iterator;\r\n"
+        " * {{ function_prefix }}_iterator_start(hash_map, &iterator);\r\n"
+        " * while ({{ function_prefix }}_iterator_next(&iterator, &key, &value))\r\n"
+        "{% endif %}\r\n"
+        " * {\r\n"
+        " *     ...\r\n"
+        " * }\r\n"
+        " * @endcode\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_iterator_start(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {{ hash_map_name }}Iterator* iterator\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Iterate over the hash map. If a key/value was found then true is returned.\r\n"
+        " *\r\n"
+        " * Example usage:\r\n"
+        " * @code\r\n"
+        " * {{ key_type_name }} key;\r\n"
+        "{% if is_set %}\r\n"
+        " * {{ hash_map_name }}Iterator iterator;\r\n"
+        " * {{ function_prefix }}_iterator_start(hash_map, &iterator);\r\n"
+        " * while ({{ function_prefix }}_iterator_next(&iterator, &key))\r\n"
+        "{% else %}\r\n"
+        " * {{ value_type_name }} value;\r\n"
+        " * {{ hash_map_name }}Iterator iterator;\r\n"
+        " * {{ function_prefix }}_iterator_start(hash_map, &iterator);\r\n"
+        " * while ({{ function_prefix }}_iterator_next(&iterator, &key, &value))\r\n"
+        "{% endif %}\r\n"
         " * {\r\n"
-        " *    ...\r\n"
+        " *     ...\r\n"
         " * }\r\n"
-        " * ```\r\n"
+        " * @endcode\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_iterator_next(\r\n"
+        "    {{ hash_map_name }}Iterator* iterator,\r\n"
+        "{% if is_set %}\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory* out_key\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}** out_key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }}* out_key\r\n"
+        "    {% endif %}\r\n"
+        "{% else %}\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory* out_key,\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}** out_key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }}* out_key,\r\n"
+        "    {% endif %}\r\n"
+        "    {% if value_is_str %}\r\n"
+        "    JSLImmutableMemory* out_value\r\n"
+        "    {% else %}\r\n"
+        "    {{ value_type_name }}* out_value\r\n"
+        "    {% endif %}\r\n"
+        "{% endif %}\r\n"
+        ");\r\n"
+    );
+    static JSLImmutableMemory dynamic_source_template = JSL_CSTR_INITIALIZER(
+        "/**\r\n"
+        " * AUTO GENERATED FILE\r\n"
+        " *\r\n"
+        " * See the header for more information.\r\n"
+        " *\r\n"
+        " * ## LICENSE\r\n"
+        " *\r\n"
+        " * Copyright (c) 2026 Jack Stouffer\r\n"
         " *\r\n"
-        " * Overall traversal order is undefined. The iterator is invalidated\r\n"
-        " * if the map is mutated after initialization.\r\n"
+        " * Permission is hereby granted, free of charge, to any person obtaining a\r\n"
+        " * copy of this software and associated documentation files (the \"Software\"),\r\n"
+        " * to deal in the Software without restriction, including without limitation\r\n"
+        " * the rights to use, copy, modify, merge, publish, distribute, sublicense,\r\n"
+        " * and/or sell copies of the Software, and to permit persons to whom the Software\r\n"
+        " * is furnished to do so, subject to the following conditions:\r\n"
+        " *\r\n"
+        " * The above copyright notice and this permission notice shall be included in all\r\n"
+        " * copies or substantial portions of the Software.\r\n"
         " *\r\n"
-        " * @param map Map to iterate over; must be initialized.\r\n"
-        " * @param iterator Iterator instance to initialize.\r\n"
-        " * @return `true` on success, `false` if parameters are invalid.\r\n"
+        " * THE SOFTWARE IS PROVIDED \"AS IS\", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR\r\n"
+        " * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,\r\n"
+        " * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE\r\n"
+        " * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,\r\n"
+        " * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN\r\n"
+        " * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.\r\n"
+        " */\r\n"
+        "\r\n"
+        "static void {{ function_prefix }}_table_free(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {{ hash_map_name }}Table* table\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (table->keys_array != NULL)\r\n"
+        "        jsl_allocator_interface_free(hash_map->allocator, table->keys_array);\r\n"
+        "    {% if is_set %}\r\n"
+        "    {% else %}\r\n"
+        "    if (table->values_array != NULL)\r\n"
+        "        jsl_allocator_interface_free(hash_map->allocator, table->values_array);\r\n"
+        "    {% endif %}\r\n"
+        "    if (table->hashes_array != NULL)\r\n"
+        "        jsl_allocator_interface_free(hash_map->allocator, table->hashes_array);\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    if (table->key_lifetime_array != NULL)\r\n"
+        "        jsl_allocator_interface_free(hash_map->allocator, table->key_lifetime_array);\r\n"
+        "    {% endif %}\r\n"
+        "    {% if value_is_str %}\r\n"
+        "    if (table->value_lifetime_array != NULL)\r\n"
+        "        jsl_allocator_interface_free(hash_map->allocator, table->value_lifetime_array);\r\n"
+        "    {% endif %}\r\n"
+        "\r\n"
+        "    JSL_MEMSET(table, 0, sizeof({{ hash_map_name }}Table));\r\n"
+        "}\r\n"
+        "\r\n"
+        "static bool {{ function_prefix }}_table_alloc(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {{ hash_map_name }}Table* table,\r\n"
+        "    int64_t arrays_length\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    JSL_MEMSET(table, 0, sizeof({{ hash_map_name }}Table));\r\n"
+        "    table->arrays_length = arrays_length;\r\n"
+        "\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    table->keys_array = (JSLImmutableMemory*) jsl_allocator_interface_alloc(\r\n"
+        "        hash_map->allocator,\r\n"
+        "        ((int64_t) sizeof(JSLImmutableMemory)) * arrays_length,\r\n"
+        "        JSL_DEFAULT_ALLOCATION_ALIGNMENT,\r\n"
+        "        false\r\n"
+        "    );\r\n"
+        "    table->key_lifetime_array = (JSLStringLifeTime*) jsl_allocator_interface_alloc(\r\n"
+        "        hash_map->allocator,\r\n"
+        "        ((int64_t) sizeof(JSLStringLifeTime)) * arrays_length,\r\n"
+        "        JSL_DEFAULT_ALLOCATION_ALIGNMENT,\r\n"
+        "        false\r\n"
+        "    );\r\n"
+        "    {% else %}\r\n"
+        "    table->keys_array = ({{ key_type_name }}*) jsl_allocator_interface_alloc(\r\n"
+        "        hash_map->allocator,\r\n"
+        "        ((int64_t) sizeof({{ key_type_name }})) * arrays_length,\r\n"
+        "        (int32_t) _Alignof({{ key_type_name }}),\r\n"
+        "        false\r\n"
+        "    );\r\n"
+        "    {% endif %}\r\n"
+        "\r\n"
+        "    {% if is_set %}\r\n"
+        "    {% elif value_is_str %}\r\n"
+        "    table->values_array = (JSLImmutableMemory*) jsl_allocator_interface_alloc(\r\n"
+        "        hash_map->allocator,\r\n"
+        "        ((int64_t) sizeof(JSLImmutableMemory)) * arrays_length,\r\n"
+        "        JSL_DEFAULT_ALLOCATION_ALIGNMENT,\r\n"
+        "        false\r\n"
+        "    );\r\n"
+        "    table->value_lifetime_array = (JSLStringLifeTime*) jsl_allocator_interface_alloc(\r\n"
+        "        hash_map->allocator,\r\n"
+        "        ((int64_t) sizeof(JSLStringLifeTime)) * arrays_length,\r\n"
+        "        JSL_DEFAULT_ALLOCATION_ALIGNMENT,\r\n"
+        "        false\r\n"
+        "    );\r\n"
+        "    {% else %}\r\n"
+        "    table->values_array = ({{ value_type_name }}*) jsl_allocator_interface_alloc(\r\n"
+        "        hash_map->allocator,\r\n"
+        "        ((int64_t) sizeof({{ value_type_name }})) * arrays_length,\r\n"
+        "        (int32_t) _Alignof({{ value_type_name }}),\r\n"
+        "        false\r\n"
+        "    );\r\n"
+        "    {% endif %}\r\n"
+        "\r\n"
+        "    table->hashes_array = (uint64_t*) jsl_allocator_interface_alloc(\r\n"
+        "        hash_map->allocator,\r\n"
+        "        ((int64_t) sizeof(uint64_t)) * arrays_length,\r\n"
+        "        (int32_t) _Alignof(uint64_t),\r\n"
+        "        true\r\n"
+        "    );\r\n"
+        "\r\n"
+        "    bool res = table->keys_array != NULL\r\n"
+        "        {% if is_set %}\r\n"
+        "        {% else %}\r\n"
+        "        && table->values_array != NULL\r\n"
+        "        {% endif %}\r\n"
+        "        && table->hashes_array != NULL\r\n"
+        "        {% if key_is_str %}\r\n"
+        "        && table->key_lifetime_array != NULL\r\n"
+        "        {% endif %}\r\n"
+        "        {% if value_is_str %}\r\n"
+        "        && table->value_lifetime_array != NULL\r\n"
+        "        {% endif %}\r\n"
+        "        ;\r\n"
+        "\r\n"
+        "    if (!res)\r\n"
+        "        {{ function_prefix }}_table_free(hash_map, table);\r\n"
+        "\r\n"
+        "    return res;\r\n"
+        "}\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Smallest table which holds `item_count` items at `load_factor` without\r\n"
+        " * growing, or -1 on invalid or too large parameters.\r\n"
+        " */\r\n"
+        "static int64_t {{ function_prefix }}_arrays_length_for(\r\n"
+        "    int64_t item_count,\r\n"
+        "    float load_factor\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        item_count < 0\r\n"
+        "        || !(load_factor > 0.0f && load_factor < 1.0f)\r\n"
+        "    )\r\n"
+        "        return -1;\r\n"
+        "\r\n"
+        "    double min_length = (double) item_count / (double) load_factor;\r\n"
+        "    if (min_length >= (double) (INT64_MAX / 4))\r\n"
+        "        return -1;\r\n"
+        "\r\n"
+        "    // Plus one so truncating can't leave the table a slot short\r\n"
+        "    return jsl_next_power_of_two_i64(JSL_MAX((int64_t) min_length + 1, 32));\r\n"
+        "}\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Bytes of the arrays of a table with `arrays_length` slots, or -1 if that\r\n"
+        " * doesn't fit in an int64_t.\r\n"
+        " */\r\n"
+        "static int64_t {{ function_prefix }}_table_bytes(\r\n"
+        "    int64_t arrays_length\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    int64_t slot_bytes = (int64_t) (sizeof(JSLImmutableMemory) + sizeof(JSLStringLifeTime));\r\n"
+        "    {% else %}\r\n"
+        "    int64_t slot_bytes = (int64_t) sizeof({{ key_type_name }});\r\n"
+        "    {% endif %}\r\n"
+        "    {% if is_set %}\r\n"
+        "    {% elif value_is_str %}\r\n"
+        "    slot_bytes += (int64_t) (sizeof(JSLImmutableMemory) + sizeof(JSLStringLifeTime));\r\n"
+        "    {% else %}\r\n"
+        "    slot_bytes += (int64_t) sizeof({{ value_type_name }});\r\n"
+        "    {% endif %}\r\n"
+        "    slot_bytes += (int64_t) sizeof(uint64_t);\r\n"
+        "\r\n"
+        "    if (arrays_length > INT64_MAX / slot_bytes)\r\n"
+        "        return -1;\r\n"
+        "\r\n"
+        "    return arrays_length * slot_bytes;\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_init(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    JSLAllocatorInterface allocator,\r\n"
+        "    uint64_t seed\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    return {{ function_prefix }}_init2(hash_map, allocator, seed, 32, 0.75f);\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_init2(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    JSLAllocatorInterface allocator,\r\n"
+        "    uint64_t seed,\r\n"
+        "    int64_t item_count_guess,\r\n"
+        "    float load_factor\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    // Also rejects a negative guess or a load factor outside of (0, 1)\r\n"
+        "    int64_t arrays_length = {{ function_prefix }}_arrays_length_for(item_count_guess, load_factor);\r\n"
+        "\r\n"
+        "    if (hash_map == NULL || arrays_length < 0)\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    JSL_MEMSET(hash_map, 0, sizeof({{ hash_map_name }}));\r\n"
+        "\r\n"
+        "    hash_map->seed = seed;\r\n"
+        "    hash_map->allocator = allocator;\r\n"
+        "    hash_map->load_factor = load_factor;\r\n"
+        "\r\n"
+        "    if (!{{ function_prefix }}_table_alloc(hash_map, &hash_map->table, arrays_length))\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    hash_map->sentinel = PRIVATE_SENTINEL_{{ hash_map_name }};\r\n"
+        "    return true;\r\n"
+        "}\r\n"
+        "\r\n"
+        "static inline uint64_t {{ function_prefix }}_hash(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    uint64_t hash = 0;\r\n"
+        "    uint64_t* out_hash = &hash;\r\n"
+        "\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    // In JSL_DEBUG, check that the key has zeroed struct padding to help catch\r\n"
+        "    // garbage byte errors\r\n"
+        "    #if defined(JSL_DEBUG)\r\n"
+        "        #ifdef __clang__\r\n"
+        "            #if __has_builtin(__builtin_clear_padding)\r\n"
+        "                {\r\n"
+        "                    {{ key_type_name }} padding_check_copy = *key;\r\n"
+        "                    __builtin_clear_padding(&padding_check_copy);\r\n"
+        "                    JSL_ASSERT(\r\n"
+        "                        JSL_MEMCMP(key, &padding_check_copy, sizeof({{ key_type_name }})) == 0\r\n"
+        "                        && \"Hash map struct key has non-zero padding bytes. Initialize struct keys with JSL_MEMSET before setting fields.\"\r\n"
+        "                    );\r\n"
+        "                }\r\n"
+        "            #endif\r\n"
+        "        #elif defined(__GNUC__) && __GNUC__ >= 11\r\n"
+        "            {\r\n"
+        "                {{ key_type_name }} padding_check_copy = *key;\r\n"
+        "                __builtin_clear_padding(&padding_check_copy);\r\n"
+        "                JSL_ASSERT(\r\n"
+        "                    JSL_MEMCMP(key, &padding_check_copy, sizeof({{ key_type_name }})) == 0\r\n"
+        "                    && \"Hash map struct key has non-zero padding bytes. Initialize struct keys with JSL_MEMSET before setting fields.\"\r\n"
+        "                );\r\n"
+        "            }\r\n"
+        "        #endif\r\n"
+        "    #endif\r\n"
+        "    {% endif %}\r\n"
+        "\r\n"
+        "    {{ hash_function }};\r\n"
+        "\r\n"
+        "    // Avoid clashing with sentinel values\r\n"
+        "    if (hash <= (uint64_t) JSL__HASHMAP_TOMBSTONE)\r\n"
+        "    {\r\n"
+        "        hash = (uint64_t) JSL__HASHMAP_VALUE_OK;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    return hash;\r\n"
+        "}\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * The current table never has tombstones. The old table gets one for every entry\r\n"
+        " * moved out of it during an incremental rehash, which are skipped like any\r\n"
+        " * other non matching slot.\r\n"
+        " */\r\n"
+        "static inline void {{ function_prefix }}_probe(\r\n"
+        "    {{ hash_map_name }}Table* table,\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key,\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key,\r\n"
+        "    {% endif %}\r\n"
+        "    uint64_t hash,\r\n"
+        "    int64_t* out_slot,\r\n"
+        "    bool* out_found\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    *out_slot = -1;\r\n"
+        "    *out_found = false;\r\n"
+        "\r\n"
+        "    int64_t total_checked = 0;\r\n"
+        "    uint64_t slot_mask = (uint64_t) table->arrays_length - 1u;\r\n"
+        "    // Since our slot array length is always a pow 2, we can avoid a modulo\r\n"
+        "    int64_t slot = (int64_t) (hash & slot_mask);\r\n"
+        "\r\n"
+        "    while (total_checked < table->arrays_length)\r\n"
+        "    {\r\n"
+        "        uint64_t slot_hash_value = table->hashes_array[slot];\r\n"
+        "\r\n"
+        "        if (slot_hash_value == JSL__HASHMAP_EMPTY)\r\n"
+        "        {\r\n"
+        "            *out_slot = slot;\r\n"
+        "            break;\r\n"
+        "        }\r\n"
+        "\r\n"
+        "        if (slot_hash_value == hash && {{ key_compare }})\r\n"
+        "        {\r\n"
+        "            *out_found = true;\r\n"
+        "            *out_slot = slot;\r\n"
+        "            break;\r\n"
+        "        }\r\n"
+        "\r\n"
+        "        slot = (int64_t) (((uint64_t) slot + 1u) & slot_mask);\r\n"
+        "        ++total_checked;\r\n"
+        "    }\r\n"
+        "}\r\n"
+        "\r\n"
+        "static inline void {{ function_prefix }}_move_slot(\r\n"
+        "    {{ hash_map_name }}Table* to_table,\r\n"
+        "    int64_t to,\r\n"
+        "    {{ hash_map_name }}Table* from_table,\r\n"
+        "    int64_t from\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    to_table->keys_array[to] = from_table->keys_array[from];\r\n"
+        "    {% if is_set %}\r\n"
+        "    {% else %}\r\n"
+        "    to_table->values_array[to] = from_table->values_array[from];\r\n"
+        "    {% endif %}\r\n"
+        "    to_table->hashes_array[to] = from_table->hashes_array[from];\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    to_table->key_lifetime_array[to] = from_table->key_lifetime_array[from];\r\n"
+        "    {% endif %}\r\n"
+        "    {% if value_is_str %}\r\n"
+        "    to_table->value_lifetime_array[to] = from_table->value_lifetime_array[from];\r\n"
+        "    {% endif %}\r\n"
+        "}\r\n"
+        "\r\n"
+        "static inline void {{ function_prefix }}_backshift(\r\n"
+        "    {{ hash_map_name }}Table* table,\r\n"
+        "    int64_t start_slot\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    uint64_t slot_mask = (uint64_t) table->arrays_length - 1u;\r\n"
+        "\r\n"
+        "    int64_t hole = start_slot;\r\n"
+        "    int64_t current = (int64_t) (((uint64_t) start_slot + 1u) & slot_mask);\r\n"
+        "\r\n"
+        "    int64_t loop_check = 0;\r\n"
+        "    while (loop_check < table->arrays_length)\r\n"
+        "    {\r\n"
+        "        uint64_t hash_value = table->hashes_array[current];\r\n"
+        "\r\n"
+        "        if (hash_value == JSL__HASHMAP_EMPTY)\r\n"
+        "        {\r\n"
+        "            table->hashes_array[hole] = JSL__HASHMAP_EMPTY;\r\n"
+        "            break;\r\n"
+        "        }\r\n"
+        "\r\n"
+        "        int64_t ideal_slot = (int64_t) (hash_value & slot_mask);\r\n"
+        "\r\n"
+        "        bool should_move = (current > hole)\r\n"
+        "            ? (ideal_slot <= hole || ideal_slot > current)\r\n"
+        "            : (ideal_slot <= hole && ideal_slot > current);\r\n"
+        "\r\n"
+        "        if (should_move)\r\n"
+        "        {\r\n"
+        "            {{ function_prefix }}_move_slot(table, hole, table, current);\r\n"
+        "            hole = current;\r\n"
+        "        }\r\n"
+        "\r\n"
+        "        current = (int64_t) (((uint64_t) current + 1u) & slot_mask);\r\n"
+        "\r\n"
+        "        ++loop_check;\r\n"
+        "    }\r\n"
+        "}\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Move the entry in `from_slot` of the old table into the current one. Keys are\r\n"
+        " * already known to be unique and the stored hash is reused, so this only has\r\n"
+        " * to find the first empty slot.\r\n"
+        " */\r\n"
+        "static inline void {{ function_prefix }}_place(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    int64_t from_slot\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    {{ hash_map_name }}Table* table = &hash_map->table;\r\n"
+        "    uint64_t slot_mask = (uint64_t) table->arrays_length - 1u;\r\n"
+        "    int64_t slot = (int64_t) (hash_map->old_table.hashes_array[from_slot] & slot_mask);\r\n"
+        "\r\n"
+        "    while (table->hashes_array[slot] != JSL__HASHMAP_EMPTY)\r\n"
+        "    {\r\n"
+        "        slot = (int64_t) (((uint64_t) slot + 1u) & slot_mask);\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_move_slot(table, slot, &hash_map->old_table, from_slot);\r\n"
+        "}\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Move up to `slot_budget` slots of the old table into the current one, and free\r\n"
+        " * the old table once it's been drained. Moved slots become tombstones so the\r\n"
+        " * probe runs of the entries left in the old table stay intact.\r\n"
+        " *\r\n"
+        " * Moving an entry or freeing the old table changes what an iterator would walk,\r\n"
+        " * so either one invalidates iterators, even when the caller's own operation\r\n"
+        " * (e.g. deleting a missing key) changes nothing else.\r\n"
+        " */\r\n"
+        "static void {{ function_prefix }}_migrate(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    int64_t slot_budget\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    {{ hash_map_name }}Table* old_table = &hash_map->old_table;\r\n"
+        "    if (old_table->hashes_array == NULL)\r\n"
+        "        return;\r\n"
+        "\r\n"
+        "    int64_t end = old_table->arrays_length;\r\n"
+        "    if (slot_budget < end - hash_map->rehash_migrate_index)\r\n"
+        "        end = hash_map->rehash_migrate_index + slot_budget;\r\n"
+        "\r\n"
+        "    bool changed = false;\r\n"
+        "    for (int64_t slot = hash_map->rehash_migrate_index; slot < end; ++slot)\r\n"
+        "    {\r\n"
+        "        uint64_t hash_value = old_table->hashes_array[slot];\r\n"
+        "        if (hash_value != JSL__HASHMAP_EMPTY && hash_value != JSL__HASHMAP_TOMBSTONE)\r\n"
+        "        {\r\n"
+        "            {{ function_prefix }}_place(hash_map, slot);\r\n"
+        "            old_table->hashes_array[slot] = JSL__HASHMAP_TOMBSTONE;\r\n"
+        "            changed = true;\r\n"
+        "        }\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    hash_map->rehash_migrate_index = end;\r\n"
+        "\r\n"
+        "    if (hash_map->rehash_migrate_index >= old_table->arrays_length)\r\n"
+        "    {\r\n"
+        "        {{ function_prefix }}_table_free(hash_map, old_table);\r\n"
+        "        hash_map->rehash_migrate_index = 0;\r\n"
+        "        changed = true;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    if (changed)\r\n"
+        "        ++hash_map->generational_id;\r\n"
+        "}\r\n"
+        "\r\n"
+        "static bool {{ function_prefix }}_grow(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    // Only one old table at a time, finish off the previous rehash first\r\n"
+        "    {{ function_prefix }}_migrate(hash_map, INT64_MAX);\r\n"
+        "\r\n"
+        "    if (hash_map->table.arrays_length > INT64_MAX / 2)\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    {{ hash_map_name }}Table bigger_table;\r\n"
+        "    if (!{{ function_prefix }}_table_alloc(hash_map, &bigger_table, hash_map->table.arrays_length * 2))\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    hash_map->old_table = hash_map->table;\r\n"
+        "    hash_map->table = bigger_table;\r\n"
+        "    hash_map->rehash_migrate_index = 0;\r\n"
+        "\r\n"
+        "    if (hash_map->rehash_step < 1)\r\n"
+        "        {{ function_prefix }}_migrate(hash_map, INT64_MAX);\r\n"
+        "\r\n"
+        "    return true;\r\n"
+        "}\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Move every item into a new table of `arrays_length` slots in one go,\r\n"
+        " * which must have room for all of them. On allocation failure nothing changes.\r\n"
+        " */\r\n"
+        "static bool {{ function_prefix }}_resize(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    int64_t arrays_length\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    {{ function_prefix }}_migrate(hash_map, INT64_MAX);\r\n"
+        "\r\n"
+        "    {{ hash_map_name }}Table new_table;\r\n"
+        "    if (!{{ function_prefix }}_table_alloc(hash_map, &new_table, arrays_length))\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    hash_map->old_table = hash_map->table;\r\n"
+        "    hash_map->table = new_table;\r\n"
+        "    hash_map->rehash_migrate_index = 0;\r\n"
+        "    {{ function_prefix }}_migrate(hash_map, INT64_MAX);\r\n"
+        "\r\n"
+        "    ++hash_map->generational_id;\r\n"
+        "    return true;\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_insert(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "{% if is_set %}\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key,\r\n"
+        "    JSLStringLifeTime key_lifetime\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        "{% else %}\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key,\r\n"
+        "    JSLStringLifeTime key_lifetime,\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key,\r\n"
+        "    {% endif %}\r\n"
+        "    {% if value_is_str %}\r\n"
+        "    JSLImmutableMemory value,\r\n"
+        "    JSLStringLifeTime value_lifetime\r\n"
+        "    {% else %}\r\n"
+        "    {{ value_type_name }} value\r\n"
+        "    {% endif %}\r\n"
+        "{% endif %}\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    bool insert_success = false;\r\n"
+        "\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "        || hash_map->table.hashes_array == NULL\r\n"
+        "    )\r\n"
+        "        return insert_success;\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_migrate(hash_map, hash_map->rehash_step);\r\n"
+        "\r\n"
+        "    uint64_t hash = {{ function_prefix }}_hash(hash_map, key);\r\n"
+        "    {{ hash_map_name }}Table* table = &hash_map->table;\r\n"
+        "    int64_t slot = -1;\r\n"
+        "    bool existing_found = false;\r\n"
+        "    {{ function_prefix }}_probe(table, key, hash, &slot, &existing_found);\r\n"
+        "\r\n"
+        "    // Entries which haven't been migrated yet are updated where they are\r\n"
+        "    if (!existing_found && hash_map->old_table.hashes_array != NULL)\r\n"
+        "    {\r\n"
+        "        int64_t old_slot = -1;\r\n"
+        "        bool old_found = false;\r\n"
+        "        {{ function_prefix }}_probe(&hash_map->old_table, key, hash, &old_slot, &old_found);\r\n"
+        "\r\n"
+        "        if (old_found)\r\n"
+        "        {\r\n"
+        "            table = &hash_map->old_table;\r\n"
+        "            slot = old_slot;\r\n"
+        "            existing_found = true;\r\n"
+        "        }\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    // Only new keys can push the table over the load factor\r\n"
+        "    if (\r\n"
+        "        !existing_found\r\n"
+        "        && hash_map->item_count >= (int64_t) ((float) hash_map->table.arrays_length * hash_map->load_factor)\r\n"
+        "    )\r\n"
+        "    {\r\n"
+        "        slot = -1;\r\n"
+        "        if ({{ function_prefix }}_grow(hash_map))\r\n"
+        "        {\r\n"
+        "            table = &hash_map->table;\r\n"
+        "            {{ function_prefix }}_probe(table, key, hash, &slot, &existing_found);\r\n"
+        "        }\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    // new key\r\n"
+        "    if (slot > -1 && !existing_found)\r\n"
+        "    {\r\n"
+        "        {% if key_is_str %}\r\n"
+        "        if (key_lifetime == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "            table->keys_array[slot] = jsl_duplicate(hash_map->allocator, key);\r\n"
+        "        else\r\n"
+        "            table->keys_array[slot] = key;\r\n"
+        "\r\n"
+        "        table->key_lifetime_array[slot] = key_lifetime;\r\n"
+        "        {% elif key_is_struct %}\r\n"
+        "        table->keys_array[slot] = *key;\r\n"
+        "        {% else %}\r\n"
+        "        table->keys_array[slot] = key;\r\n"
+        "        {% endif %}\r\n"
+        "\r\n"
+        "        {% if is_set %}\r\n"
+        "        {% elif value_is_str %}\r\n"
+        "        if (value_lifetime == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "            table->values_array[slot] = jsl_duplicate(hash_map->allocator, value);\r\n"
+        "        else\r\n"
+        "            table->values_array[slot] = value;\r\n"
+        "\r\n"
+        "        table->value_lifetime_array[slot] = value_lifetime;\r\n"
+        "        {% else %}\r\n"
+        "        table->values_array[slot] = value;\r\n"
+        "        {% endif %}\r\n"
+        "\r\n"
+        "        table->hashes_array[slot] = hash;\r\n"
+        "        ++hash_map->item_count;\r\n"
+        "        insert_success = true;\r\n"
+        "    }\r\n"
+        "    // update\r\n"
+        "    else if (slot > -1 && existing_found)\r\n"
+        "    {\r\n"
+        "        {% if is_set %}\r\n"
+        "        // already in the set, nothing to change\r\n"
+        "        {% elif value_is_str %}\r\n"
+        "        if (table->value_lifetime_array[slot] == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "            jsl_allocator_interface_free(hash_map->allocator, table->values_array[slot].data);\r\n"
+        "\r\n"
+        "        if (value_lifetime == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "            table->values_array[slot] = jsl_duplicate(hash_map->allocator, value);\r\n"
+        "        else\r\n"
+        "            table->values_array[slot] = value;\r\n"
+        "\r\n"
+        "        table->value_lifetime_array[slot] = value_lifetime;\r\n"
+        "        {% else %}\r\n"
+        "        table->values_array[slot] = value;\r\n"
+        "        {% endif %}\r\n"
+        "\r\n"
+        "        insert_success = true;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    if (insert_success)\r\n"
+        "    {\r\n"
+        "        ++hash_map->generational_id;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    return insert_success;\r\n"
+        "}\r\n"
+        "\r\n"
+        "{% if is_set %}\r\n"
+        "bool {{ function_prefix }}_has(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "        || hash_map->table.hashes_array == NULL\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    uint64_t hash = {{ function_prefix }}_hash(hash_map, key);\r\n"
+        "    int64_t slot = -1;\r\n"
+        "    bool existing_found = false;\r\n"
+        "    {{ function_prefix }}_probe(&hash_map->table, key, hash, &slot, &existing_found);\r\n"
+        "\r\n"
+        "    if (!existing_found && hash_map->old_table.hashes_array != NULL)\r\n"
+        "        {{ function_prefix }}_probe(&hash_map->old_table, key, hash, &slot, &existing_found);\r\n"
+        "\r\n"
+        "    return slot > -1 && existing_found;\r\n"
+        "}\r\n"
+        "{% else %}\r\n"
+        "{% if value_is_str %}\r\n"
+        "JSLImmutableMemory {{ function_prefix }}_get(\r\n"
+        "{% else %}\r\n"
+        "{{ value_type_name }}* {{ function_prefix }}_get(\r\n"
+        "{% endif %}\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    {% if value_is_str %}\r\n"
+        "    JSLImmutableMemory res = {0};\r\n"
+        "    {% else %}\r\n"
+        "    {{ value_type_name }}* res = NULL;\r\n"
+        "    {% endif %}\r\n"
+        "\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "        || hash_map->table.hashes_array == NULL\r\n"
+        "    )\r\n"
+        "        return res;\r\n"
+        "\r\n"
+        "    uint64_t hash = {{ function_prefix }}_hash(hash_map, key);\r\n"
+        "    {{ hash_map_name }}Table* table = &hash_map->table;\r\n"
+        "    int64_t slot = -1;\r\n"
+        "    bool existing_found = false;\r\n"
+        "    {{ function_prefix }}_probe(table, key, hash, &slot, &existing_found);\r\n"
+        "\r\n"
+        "    if (!existing_found && hash_map->old_table.hashes_array != NULL)\r\n"
+        "    {\r\n"
+        "        table = &hash_map->old_table;\r\n"
+        "        {{ function_prefix }}_probe(table, key, hash, &slot, &existing_found);\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    if (slot > -1 && existing_found)\r\n"
+        "    {\r\n"
+        "        {% if value_is_str %}\r\n"
+        "        res = table->values_array[slot];\r\n"
+        "        {% else %}\r\n"
+        "        res = &table->values_array[slot];\r\n"
+        "        {% endif %}\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    return res;\r\n"
+        "}\r\n"
+        "{% endif %}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_delete(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory key\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    bool success = false;\r\n"
+        "\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "        || hash_map->table.hashes_array == NULL\r\n"
+        "    )\r\n"
+        "        return success;\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_migrate(hash_map, hash_map->rehash_step);\r\n"
+        "\r\n"
+        "    uint64_t hash = {{ function_prefix }}_hash(hash_map, key);\r\n"
+        "    {{ hash_map_name }}Table* table = &hash_map->table;\r\n"
+        "    int64_t slot = -1;\r\n"
+        "    bool existing_found = false;\r\n"
+        "    {{ function_prefix }}_probe(table, key, hash, &slot, &existing_found);\r\n"
+        "\r\n"
+        "    bool in_old_table = false;\r\n"
+        "    if (!existing_found && hash_map->old_table.hashes_array != NULL)\r\n"
+        "    {\r\n"
+        "        table = &hash_map->old_table;\r\n"
+        "        {{ function_prefix }}_probe(table, key, hash, &slot, &existing_found);\r\n"
+        "        in_old_table = true;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    if (slot > -1 && existing_found)\r\n"
+        "    {\r\n"
+        "        {% if key_is_str %}\r\n"
+        "        if (table->key_lifetime_array[slot] == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "            jsl_allocator_interface_free(hash_map->allocator, table->keys_array[slot].data);\r\n"
+        "        {% endif %}\r\n"
+        "        {% if value_is_str %}\r\n"
+        "        if (table->value_lifetime_array[slot] == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "            jsl_allocator_interface_free(hash_map->allocator, table->values_array[slot].data);\r\n"
+        "        {% endif %}\r\n"
+        "\r\n"
+        "        // The migration cursor may already be past the entries that backshift\r\n"
+        "        // would move, so the old table uses a tombstone instead\r\n"
+        "        if (in_old_table)\r\n"
+        "            table->hashes_array[slot] = JSL__HASHMAP_TOMBSTONE;\r\n"
+        "        else\r\n"
+        "            {{ function_prefix }}_backshift(table, slot);\r\n"
+        "\r\n"
+        "        --hash_map->item_count;\r\n"
+        "        ++hash_map->generational_id;\r\n"
+        "        success = true;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    return success;\r\n"
+        "}\r\n"
+        "\r\n"
+        "int64_t {{ function_prefix }}_item_count(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return -1;\r\n"
+        "\r\n"
+        "    return hash_map->item_count;\r\n"
+        "}\r\n"
+        "\r\n"
+        "{% if key_is_str or value_is_str %}\r\n"
+        "static void {{ function_prefix }}_free_strings(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {{ hash_map_name }}Table* table\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (table->hashes_array == NULL)\r\n"
+        "        return;\r\n"
+        "\r\n"
+        "    for (int64_t current_slot = 0; current_slot < table->arrays_length; ++current_slot)\r\n"
+        "    {\r\n"
+        "        uint64_t hash_value = table->hashes_array[current_slot];\r\n"
+        "        bool occupied = hash_value != JSL__HASHMAP_EMPTY && hash_value != JSL__HASHMAP_TOMBSTONE;\r\n"
+        "        {% if key_is_str %}\r\n"
+        "        JSLStringLifeTime lifetime = table->key_lifetime_array[current_slot];\r\n"
+        "        if (occupied && lifetime == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "        {\r\n"
+        "            jsl_allocator_interface_free(hash_map->allocator, table->keys_array[current_slot].data);\r\n"
+        "        }\r\n"
+        "        {% elif value_is_str %}\r\n"
+        "        JSLStringLifeTime lifetime = table->value_lifetime_array[current_slot];\r\n"
+        "        if (occupied && lifetime == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "        {\r\n"
+        "            jsl_allocator_interface_free(hash_map->allocator, table->values_array[current_slot].data);\r\n"
+        "        }\r\n"
+        "        {% endif %}\r\n"
+        "    }\r\n"
+        "}\r\n"
+        "\r\n"
+        "{% endif %}\r\n"
+        "void {{ function_prefix }}_clear(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "        || hash_map->table.hashes_array == NULL\r\n"
+        "    )\r\n"
+        "        return;\r\n"
+        "\r\n"
+        "    {% if key_is_str or value_is_str %}\r\n"
+        "    {{ function_prefix }}_free_strings(hash_map, &hash_map->table);\r\n"
+        "    {{ function_prefix }}_free_strings(hash_map, &hash_map->old_table);\r\n"
+        "    {% endif %}\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_table_free(hash_map, &hash_map->old_table);\r\n"
+        "    hash_map->rehash_migrate_index = 0;\r\n"
+        "\r\n"
+        "    JSL_MEMSET(\r\n"
+        "        hash_map->table.hashes_array,\r\n"
+        "        0,\r\n"
+        "        sizeof(uint64_t) * (size_t) hash_map->table.arrays_length\r\n"
+        "    );\r\n"
+        "\r\n"
+        "    hash_map->item_count = 0;\r\n"
+        "    ++hash_map->generational_id;\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_enable_incremental_rehash(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    int64_t slots_per_operation\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "        || slots_per_operation < 0\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    hash_map->rehash_step = slots_per_operation;\r\n"
+        "\r\n"
+        "    if (slots_per_operation == 0)\r\n"
+        "        return {{ function_prefix }}_finish_rehash(hash_map);\r\n"
+        "\r\n"
+        "    return true;\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_finish_rehash(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    if (hash_map->old_table.hashes_array != NULL)\r\n"
+        "    {\r\n"
+        "        {{ function_prefix }}_migrate(hash_map, INT64_MAX);\r\n"
+        "        ++hash_map->generational_id;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    return true;\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_reserve(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    int64_t item_count\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    int64_t arrays_length = {{ function_prefix }}_arrays_length_for(item_count, hash_map->load_factor);\r\n"
+        "    if (arrays_length < 0)\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    if (!{{ function_prefix }}_finish_rehash(hash_map))\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    if (arrays_length <= hash_map->table.arrays_length)\r\n"
+        "        return true;\r\n"
+        "\r\n"
+        "    return {{ function_prefix }}_resize(hash_map, arrays_length);\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_shrink_to_fit(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_finish_rehash(hash_map);\r\n"
+        "\r\n"
+        "    int64_t arrays_length = {{ function_prefix }}_arrays_length_for(\r\n"
+        "        hash_map->item_count,\r\n"
+        "        hash_map->load_factor\r\n"
+        "    );\r\n"
+        "\r\n"
+        "    if (arrays_length >= hash_map->table.arrays_length)\r\n"
+        "        return true;\r\n"
+        "\r\n"
+        "    return {{ function_prefix }}_resize(hash_map, arrays_length);\r\n"
+        "}\r\n"
+        "\r\n"
+        "{% if key_is_str or value_is_str %}\r\n"
+        "static int64_t {{ function_prefix }}_string_bytes(\r\n"
+        "    {{ hash_map_name }}Table* table\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    int64_t bytes = 0;\r\n"
+        "\r\n"
+        "    for (int64_t current_slot = 0; current_slot < table->arrays_length; ++current_slot)\r\n"
+        "    {\r\n"
+        "        uint64_t hash_value = table->hashes_array[current_slot];\r\n"
+        "        bool occupied = hash_value != JSL__HASHMAP_EMPTY && hash_value != JSL__HASHMAP_TOMBSTONE;\r\n"
+        "        {% if key_is_str %}\r\n"
+        "        if (occupied && table->key_lifetime_array[current_slot] == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "            bytes += table->keys_array[current_slot].length;\r\n"
+        "        {% endif %}\r\n"
+        "        {% if value_is_str %}\r\n"
+        "        if (occupied && table->value_lifetime_array[current_slot] == JSL_STRING_LIFETIME_SHORTER)\r\n"
+        "            bytes += table->values_array[current_slot].length;\r\n"
+        "        {% endif %}\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    return bytes;\r\n"
+        "}\r\n"
+        "\r\n"
+        "{% endif %}\r\n"
+        "int64_t {{ function_prefix }}_memory_footprint(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return -1;\r\n"
+        "\r\n"
+        "    // An empty old table has zero slots\r\n"
+        "    int64_t bytes = {{ function_prefix }}_table_bytes(hash_map->table.arrays_length)\r\n"
+        "        + {{ function_prefix }}_table_bytes(hash_map->old_table.arrays_length);\r\n"
+        "\r\n"
+        "    {% if key_is_str or value_is_str %}\r\n"
+        "    bytes += {{ function_prefix }}_string_bytes(&hash_map->table);\r\n"
+        "    bytes += {{ function_prefix }}_string_bytes(&hash_map->old_table);\r\n"
+        "\r\n"
+        "    {% endif %}\r\n"
+        "    return bytes;\r\n"
+        "}\r\n"
+        "\r\n"
+        "int64_t {{ function_prefix }}_memory_footprint_for(\r\n"
+        "    int64_t item_count,\r\n"
+        "    float load_factor\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    int64_t arrays_length = {{ function_prefix }}_arrays_length_for(item_count, load_factor);\r\n"
+        "    return arrays_length < 0 ? -1 : {{ function_prefix }}_table_bytes(arrays_length);\r\n"
+        "}\r\n"
+        "\r\n"
+        "void {{ function_prefix }}_free(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return;\r\n"
+        "\r\n"
+        "    {% if key_is_str or value_is_str %}\r\n"
+        "    {{ function_prefix }}_free_strings(hash_map, &hash_map->table);\r\n"
+        "    {{ function_prefix }}_free_strings(hash_map, &hash_map->old_table);\r\n"
+        "    {% endif %}\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_table_free(hash_map, &hash_map->table);\r\n"
+        "    {{ function_prefix }}_table_free(hash_map, &hash_map->old_table);\r\n"
+        "    hash_map->item_count = 0;\r\n"
+        "    hash_map->sentinel = 0;\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_iterator_start(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {{ hash_map_name }}Iterator* iterator\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || iterator == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    iterator->hash_map = hash_map;\r\n"
+        "    iterator->current_slot = 0;\r\n"
+        "    iterator->generational_id = hash_map->generational_id;\r\n"
+        "\r\n"
+        "    return true;\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_iterator_next(\r\n"
+        "    {{ hash_map_name }}Iterator* iterator,\r\n"
+        "{% if is_set %}\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory* out_key\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}** out_key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }}* out_key\r\n"
+        "    {% endif %}\r\n"
+        "{% else %}\r\n"
+        "    {% if key_is_str %}\r\n"
+        "    JSLImmutableMemory* out_key,\r\n"
+        "    {% elif key_is_struct %}\r\n"
+        "    const {{ key_type_name }}** out_key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }}* out_key,\r\n"
+        "    {% endif %}\r\n"
+        "    {% if value_is_str %}\r\n"
+        "    JSLImmutableMemory* out_value\r\n"
+        "    {% else %}\r\n"
+        "    {{ value_type_name }}* out_value\r\n"
+        "    {% endif %}\r\n"
+        "{% endif %}\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    bool found = false;\r\n"
+        "\r\n"
+        "    if (\r\n"
+        "        iterator == NULL\r\n"
+        "        || iterator->hash_map == NULL\r\n"
+        "        || iterator->hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "        || iterator->hash_map->generational_id != iterator->generational_id\r\n"
+        "        || iterator->hash_map->table.hashes_array == NULL\r\n"
+        "    )\r\n"
+        "        return found;\r\n"
+        "\r\n"
+        "    {{ hash_map_name }}* hash_map = iterator->hash_map;\r\n"
+        "    int64_t old_length = hash_map->old_table.arrays_length;\r\n"
+        "    int64_t total_length = old_length + hash_map->table.arrays_length;\r\n"
+        "\r\n"
+        "    while (iterator->current_slot < total_length)\r\n"
+        "    {\r\n"
+        "        {{ hash_map_name }}Table* table = &hash_map->table;\r\n"
+        "        int64_t slot = iterator->current_slot - old_length;\r\n"
+        "        if (iterator->current_slot < old_length)\r\n"
+        "        {\r\n"
+        "            table = &hash_map->old_table;\r\n"
+        "            slot = iterator->current_slot;\r\n"
+        "        }\r\n"
+        "\r\n"
+        "        ++iterator->current_slot;\r\n"
+        "\r\n"
+        "        uint64_t hash_value = table->hashes_array[slot];\r\n"
+        "        if (hash_value != JSL__HASHMAP_EMPTY && hash_value != JSL__HASHMAP_TOMBSTONE)\r\n"
+        "        {\r\n"
+        "            {% if key_is_struct %}\r\n"
+        "            *out_key = &table->keys_array[slot];\r\n"
+        "            {% else %}\r\n"
+        "            *out_key = table->keys_array[slot];\r\n"
+        "            {% endif %}\r\n"
+        "            {% if is_set %}\r\n"
+        "            {% else %}\r\n"
+        "            *out_value = table->values_array[slot];\r\n"
+        "            {% endif %}\r\n"
+        "            found = true;\r\n"
+        "            break;\r\n"
+        "        }\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    return found;\r\n"
+        "}\r\n"
+    );
+
+    static JSLImmutableMemory concurrent_header_template = JSL_CSTR_INITIALIZER(
+        "/**\r\n"
+        " * AUTO GENERATED FILE\r\n"
+        " *\r\n"
+        " * This file contains the header for a hash map `{{ hash_map_name }}` which maps\r\n"
+        " * `{{ key_type_name }}` keys to `{{ value_type_name }}` values and can be used\r\n"
+        " * from many threads at once.\r\n"
+        " *\r\n"
+        " * The map is split into shards, each one a small fixed size open addressed\r\n"
+        " * table with its own lock. The high bits of a key's hash pick the shard and\r\n"
+        " * the low bits the slot, so threads working on different keys almost never\r\n"
+        " * wait on each other. The locks are spin locks which are held for a single\r\n"
+        " * probe, the hash is computed before the lock is taken.\r\n"
+        " *\r\n"
+        " * Like the fixed map, the table never grows. Each shard has room for one and\r\n"
+        " * a half times its even share of `max_item_count`, so an insert only fails\r\n"
+        " * early if the hash is badly skewed.\r\n"
+        " *\r\n"
+        " * Iteration works on a snapshot, every shard is locked while the entries are\r\n"
+        " * copied out, so the iterator sees the map as it was at one point in time.\r\n"
+        " *\r\n"
+        " * This file was auto generated from the hash map generation utility that's part of\r\n"
+        " * the \"Jack's Standard Library\" project. The utility generates a header file and a\r\n"
+        " * C file for a type safe, open addressed, hash map. By generating the code rather\r\n"
+        " * than using macros, two benefits are gained. One, the code is much easier to debug.\r\n"
+        " * Two, it's much more obvious how much code you're generating, which means you are\r\n"
+        " * much less likely to accidentally create the combinatoric explosion of code that's\r\n"
+        " * so common in C++ projects. Adding friction to things is actually good sometimes.\r\n"
+        " *\r\n"
+        " * ## LICENSE\r\n"
+        " *\r\n"
+        " * Copyright (c) 2026 Jack Stouffer\r\n"
+        " *\r\n"
+        " * Permission is hereby granted, free of charge, to any person obtaining a\r\n"
+        " * copy of this software and associated documentation files (the \"Software\"),\r\n"
+        " * to deal in the Software without restriction, including without limitation\r\n"
+        " * the rights to use, copy, modify, merge, publish, distribute, sublicense,\r\n"
+        " * and/or sell copies of the Software, and to permit persons to whom the Software\r\n"
+        " * is furnished to do so, subject to the following conditions:\r\n"
+        " *\r\n"
+        " * The above copyright notice and this permission notice shall be included in all\r\n"
+        " * copies or substantial portions of the Software.\r\n"
+        " *\r\n"
+        " * THE SOFTWARE IS PROVIDED \"AS IS\", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR\r\n"
+        " * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,\r\n"
+        " * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE\r\n"
+        " * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,\r\n"
+        " * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN\r\n"
+        " * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.\r\n"
+        " */\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * One lock and the slot arrays it protects. The union pads it out to exactly\r\n"
+        " * one cache line whatever the pointer size, so that threads taking the locks\r\n"
+        " * of neighbouring shards don't contend.\r\n"
+        " */\r\n"
+        "typedef union {{ hash_map_name }}Shard {\r\n"
+        "    struct {\r\n"
+        "        /// @brief zero when unlocked\r\n"
+        "        uint64_t lock;\r\n"
+        "        /// @brief only written with the lock held, read atomically by item_count\r\n"
+        "        uint64_t item_count;\r\n"
+        "\r\n"
+        "        {{ key_type_name }}* keys_array;\r\n"
+        "        {{ value_type_name }}* values_array;\r\n"
+        "        uint64_t* hashes_array;\r\n"
+        "    };\r\n"
+        "\r\n"
+        "    uint8_t padding[JSL__CACHE_LINE_SIZE];\r\n"
+        "} {{ hash_map_name }}Shard;\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * A hash map which maps `{{ key_type_name }}` keys to `{{ value_type_name }}` values\r\n"
+        " * and is safe to use from multiple threads without outside locking.\r\n"
+        " *\r\n"
+        " * Init and free must not run at the same time as any other function.\r\n"
+        " */\r\n"
+        "typedef struct {{ hash_map_name }} {\r\n"
+        "    // putting the sentinel first means it's much more likely to get\r\n"
+        "    // corrupted from accidental overwrites, therefore making it\r\n"
+        "    // more likely that memory bugs are caught.\r\n"
+        "    uint32_t sentinel;\r\n"
+        "    /// @brief 64 minus the number of bits used to pick a shard\r\n"
+        "    uint32_t shard_shift;\r\n"
+        "    JSLAllocatorInterface allocator;\r\n"
+        "\r\n"
+        "    {{ hash_map_name }}Shard* shards;\r\n"
+        "    int64_t shard_count;\r\n"
+        "    /// @brief slots per shard, always a power of two\r\n"
+        "    int64_t arrays_length;\r\n"
+        "    /// @brief items per shard before inserts of new keys fail\r\n"
+        "    int64_t shard_max_item_count;\r\n"
+        "\r\n"
+        "    uint64_t seed;\r\n"
+        "} {{ hash_map_name }};\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Called by update with the shard lock held.\r\n"
+        " */\r\n"
+        "typedef void (*{{ hash_map_name }}UpdateFunction)({{ value_type_name }}* value, void* user_data);\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Iterator over a snapshot of the map. Holds its own copy of every entry,\r\n"
+        " * so the map can be freely changed, by any thread, while iterating.\r\n"
+        " */\r\n"
+        "typedef struct {{ hash_map_name }}Iterator {\r\n"
+        "    JSLAllocatorInterface allocator;\r\n"
+        "    {{ key_type_name }}* keys_array;\r\n"
+        "    {{ value_type_name }}* values_array;\r\n"
+        "    int64_t item_count;\r\n"
+        "    int64_t current_item;\r\n"
+        "} {{ hash_map_name }}Iterator;\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Initialize a map with 64 shards.\r\n"
+        " *\r\n"
+        " * The allocator is only used by this function and by free, so it doesn't\r\n"
+        " * need to be thread safe.\r\n"
+        " *\r\n"
+        " * @warning This hash map uses a well distributed hash. But in order to properly protect against\r\n"
+        " * hash flooding attacks you must do two things. One, provide good random data for the\r\n"
+        " * seed value. This means using your OS's secure random number generator, not `rand`.\r\n"
+        " * As this is very platform specific JSL does not come with a mechanism for getting these\r\n"
+        " * random numbers; you must do it yourself. Two, use a different seed value as often as\r\n"
+        " * possible, ideally every user interaction. This would make hash flooding attacks almost\r\n"
+        " * impossible. If you are absolutely sure that this hash map cannot be attacked with hash\r\n"
+        " * flooding then zero is a valid seed value.\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance to initialize\r\n"
+        " * @param allocator The allocator that this hash map will use\r\n"
+        " * @param max_item_count The number of items the map is sized for\r\n"
+        " * @param seed Seed value for the hash function to protect against hash flooding attacks\r\n"
+        " * @returns `true` on success, `false` if any parameter is invalid or out of memory.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_init(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    JSLAllocatorInterface allocator,\r\n"
+        "    int64_t max_item_count,\r\n"
+        "    uint64_t seed\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Initialize a map with an explicit number of shards. More shards means less\r\n"
+        " * waiting when many threads write at once, at the cost of more memory for\r\n"
+        " * small maps. A few times the number of writing threads is a good start.\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance to initialize\r\n"
+        " * @param allocator The allocator that this hash map will use\r\n"
+        " * @param max_item_count The number of items the map is sized for\r\n"
+        " * @param shard_count Number of shards, rounded up to a power of two and at least two\r\n"
+        " * @param seed Seed value for the hash function to protect against hash flooding attacks\r\n"
+        " * @returns `true` on success, `false` if any parameter is invalid or out of memory.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_init2(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    JSLAllocatorInterface allocator,\r\n"
+        "    int64_t max_item_count,\r\n"
+        "    int64_t shard_count,\r\n"
+        "    uint64_t seed\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Insert the given value into the hash map. If the key already exists in\r\n"
+        " * the map the value will be overwritten.\r\n"
+        " *\r\n"
+        "{% if key_is_struct %}\r\n"
+        " * With struct keys, struct padding can be filled with random-ish, garbage bytes.\r\n"
+        " * This will cause the hash probe to fail. It is *very* important to either\r\n"
+        " * 1, initialize the struct with memset to zero 2, use a canonicalization function\r\n"
+        " * before using the struct in the hash map or 3. use a custom comparison function\r\n"
+        " * (requires regenerating the source with the proper command line option). Do not\r\n"
+        " * rely on `{0}` init! The compiler is allowed to cheat and skip padding bytes.\r\n"
+        " *\r\n"
+        "{% endif %}\r\n"
+        " * @param hash_map The pointer to the hash map instance\r\n"
+        " * @param key Hash map key\r\n"
+        " * @param value Value to store\r\n"
+        " * @returns `true` on success, `false` on invalid parameters or if the key's shard is full.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_insert(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key,\r\n"
+        "    {% endif %}\r\n"
+        "    {{ value_type_name }} value\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Copy a value out of the hash map. Another thread can change the value\r\n"
+        " * right after this returns, so a pointer into the map is never handed out.\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance\r\n"
+        " * @param key Hash map key\r\n"
+        " * @param out_value Set to the value if the key was found\r\n"
+        " * @returns `true` if the key was found.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_get(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key,\r\n"
+        "    {% endif %}\r\n"
+        "    {{ value_type_name }}* out_value\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Read, modify, and write a value in one step. If the key isn't in the map\r\n"
+        " * it's inserted with `initial_value` first. `update_function` is then called\r\n"
+        " * with a pointer to the stored value while the shard is locked, so it must be\r\n"
+        " * short and must not call back into this map.\r\n"
+        " *\r\n"
+        " * This is the way to keep counters or other running totals in the map, doing\r\n"
+        " * a get followed by an insert would lose updates from other threads.\r\n"
+        " *\r\n"
+        " * Example:\r\n"
+        " * @code\r\n"
+        " * static void add_one({{ value_type_name }}* value, void* user_data)\r\n"
+        " * {\r\n"
+        " *     (void) user_data;\r\n"
+        " *     *value += 1;\r\n"
+        " * }\r\n"
+        " *\r\n"
+        " * {{ function_prefix }}_update(&map, key, 0, add_one, NULL);\r\n"
+        " * @endcode\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance\r\n"
+        " * @param key Hash map key\r\n"
+        " * @param initial_value Value to insert if the key is missing\r\n"
+        " * @param update_function Called with the stored value\r\n"
+        " * @param user_data Passed through to `update_function`\r\n"
+        " * @returns `true` on success, `false` on invalid parameters or if the key's shard is full.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_update(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key,\r\n"
+        "    {% endif %}\r\n"
+        "    {{ value_type_name }} initial_value,\r\n"
+        "    {{ hash_map_name }}UpdateFunction update_function,\r\n"
+        "    void* user_data\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Remove a key/value pair from the hash map if it exists.\r\n"
+        " * If it does not false is returned.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_delete(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Get the number of items in the map. While other threads are writing this\r\n"
+        " * is only an estimate, as each shard is counted at a slightly different time.\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance\r\n"
+        " * @returns The item count, or -1 on invalid parameters.\r\n"
+        " */\r\n"
+        "int64_t {{ function_prefix }}_item_count(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Get the number of bytes this hash map holds from its allocator, which is\r\n"
+        " * the shards and every shard's arrays. All of it is allocated by init, so\r\n"
+        " * the number doesn't change with the item count. Allocator bookkeeping and\r\n"
+        " * alignment padding aren't included.\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance\r\n"
+        " * @returns The size in bytes, or -1 on invalid parameters.\r\n"
+        " */\r\n"
+        "int64_t {{ function_prefix }}_memory_footprint(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Remove all keys and values from the map, one shard at a time.\r\n"
+        " */\r\n"
+        "void {{ function_prefix }}_clear(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Free all the underlying memory that was allocated by this hash map on the given\r\n"
+        " * allocator. No other thread may be using the map.\r\n"
+        " */\r\n"
+        "void {{ function_prefix }}_free(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Take a snapshot of the map for iteration. Every shard is locked while the\r\n"
+        " * entries are copied, so the snapshot is consistent, but writers on all\r\n"
+        " * threads are stalled for the duration.\r\n"
+        " *\r\n"
+        " * Example usage:\r\n"
+        " * @code\r\n"
+        " * {{ key_type_name }} key;\r\n"
+        " * {{ value_type_name }} value;\r\n"
+        " * {{ hash_map_name }}Iterator iterator;\r\n"
+        " * if ({{ function_prefix }}_iterator_start(hash_map, allocator, &iterator))\r\n"
+        " * {\r\n"
+        " *     while ({{ function_prefix }}_iterator_next(&iterator, &key, &value))\r\n"
+        " *     {\r\n"
+        " *         ...\r\n"
+        " *     }\r\n"
+        " *     {{ function_prefix }}_iterator_free(&iterator);\r\n"
+        " * }\r\n"
+        " * @endcode\r\n"
+        " *\r\n"
+        " * @param hash_map The pointer to the hash map instance\r\n"
+        " * @param allocator Allocates the copy of the entries, only used by the calling thread\r\n"
+        " * @param iterator The iterator to initialize\r\n"
+        " * @returns `true` on success, `false` on invalid parameters or out of memory.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_iterator_start(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    JSLAllocatorInterface allocator,\r\n"
+        "    {{ hash_map_name }}Iterator* iterator\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Get the next key/value pair of the snapshot. If one was left then true is returned.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_iterator_next(\r\n"
+        "    {{ hash_map_name }}Iterator* iterator,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}** out_key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }}* out_key,\r\n"
+        "    {% endif %}\r\n"
+        "    {{ value_type_name }}* out_value\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Free the snapshot owned by the iterator.\r\n"
+        " */\r\n"
+        "void {{ function_prefix }}_iterator_free(\r\n"
+        "    {{ hash_map_name }}Iterator* iterator\r\n"
+        ");\r\n"
+    );
+
+    static JSLImmutableMemory concurrent_source_template = JSL_CSTR_INITIALIZER(
+        "/**\r\n"
+        " * AUTO GENERATED FILE\r\n"
+        " *\r\n"
+        " * See the header for more information.\r\n"
+        " *\r\n"
+        " * ## LICENSE\r\n"
+        " *\r\n"
+        " * Copyright (c) 2026 Jack Stouffer\r\n"
+        " *\r\n"
+        " * Permission is hereby granted, free of charge, to any person obtaining a\r\n"
+        " * copy of this software and associated documentation files (the \"Software\"),\r\n"
+        " * to deal in the Software without restriction, including without limitation\r\n"
+        " * the rights to use, copy, modify, merge, publish, distribute, sublicense,\r\n"
+        " * and/or sell copies of the Software, and to permit persons to whom the Software\r\n"
+        " * is furnished to do so, subject to the following conditions:\r\n"
+        " *\r\n"
+        " * The above copyright notice and this permission notice shall be included in all\r\n"
+        " * copies or substantial portions of the Software.\r\n"
+        " *\r\n"
+        " * THE SOFTWARE IS PROVIDED \"AS IS\", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR\r\n"
+        " * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,\r\n"
+        " * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE\r\n"
+        " * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,\r\n"
+        " * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN\r\n"
+        " * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.\r\n"
+        " */\r\n"
+        "\r\n"
+        "_Static_assert(\r\n"
+        "    sizeof({{ hash_map_name }}Shard) == JSL__CACHE_LINE_SIZE,\r\n"
+        "    \"{{ hash_map_name }}Shard must fill exactly one cache line\"\r\n"
+        ");\r\n"
+        "\r\n"
+        "static void {{ function_prefix }}_release(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (hash_map->shards == NULL)\r\n"
+        "        return;\r\n"
+        "\r\n"
+        "    for (int64_t i = 0; i < hash_map->shard_count; ++i)\r\n"
+        "    {\r\n"
+        "        {{ hash_map_name }}Shard* shard = &hash_map->shards[i];\r\n"
+        "        if (shard->keys_array != NULL)\r\n"
+        "            jsl_allocator_interface_free(hash_map->allocator, shard->keys_array);\r\n"
+        "        if (shard->values_array != NULL)\r\n"
+        "            jsl_allocator_interface_free(hash_map->allocator, shard->values_array);\r\n"
+        "        if (shard->hashes_array != NULL)\r\n"
+        "            jsl_allocator_interface_free(hash_map->allocator, shard->hashes_array);\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    jsl_allocator_interface_free(hash_map->allocator, hash_map->shards);\r\n"
+        "    hash_map->shards = NULL;\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_init(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    JSLAllocatorInterface allocator,\r\n"
+        "    int64_t max_item_count,\r\n"
+        "    uint64_t seed\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    return {{ function_prefix }}_init2(hash_map, allocator, max_item_count, 64, seed);\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_init2(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    JSLAllocatorInterface allocator,\r\n"
+        "    int64_t max_item_count,\r\n"
+        "    int64_t shard_count,\r\n"
+        "    uint64_t seed\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || max_item_count < 0\r\n"
+        "        || shard_count < 1\r\n"
+        "        || shard_count > 65536\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    JSL_MEMSET(hash_map, 0, sizeof({{ hash_map_name }}));\r\n"
+        "\r\n"
+        "    hash_map->seed = seed;\r\n"
+        "    hash_map->allocator = allocator;\r\n"
+        "    hash_map->shard_count = jsl_next_power_of_two_i64(JSL_MAX(shard_count, 2));\r\n"
+        "    hash_map->shard_shift = (uint32_t) (\r\n"
+        "        64 - JSL_PLATFORM_COUNT_TRAILING_ZEROS64((uint64_t) hash_map->shard_count)\r\n"
+        "    );\r\n"
+        "\r\n"
+        "    // Keys don't spread perfectly evenly, so every shard gets some slack\r\n"
+        "    int64_t even_share = (max_item_count + hash_map->shard_count - 1) / hash_map->shard_count;\r\n"
+        "    hash_map->shard_max_item_count = even_share + even_share / 2 + 8;\r\n"
+        "\r\n"
+        "    int64_t max_with_load_factor = (int64_t) ((float) hash_map->shard_max_item_count / 0.75f) + 1;\r\n"
+        "    hash_map->arrays_length = jsl_next_power_of_two_i64(JSL_MAX(max_with_load_factor, 16));\r\n"
+        "\r\n"
+        "    hash_map->shards = ({{ hash_map_name }}Shard*) jsl_allocator_interface_alloc(\r\n"
+        "        allocator,\r\n"
+        "        ((int64_t) sizeof({{ hash_map_name }}Shard)) * hash_map->shard_count,\r\n"
+        "        JSL__CACHE_LINE_SIZE,\r\n"
+        "        true\r\n"
+        "    );\r\n"
+        "    if (hash_map->shards == NULL)\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    bool res = true;\r\n"
+        "    for (int64_t i = 0; res && i < hash_map->shard_count; ++i)\r\n"
+        "    {\r\n"
+        "        {{ hash_map_name }}Shard* shard = &hash_map->shards[i];\r\n"
+        "\r\n"
+        "        shard->keys_array = ({{ key_type_name }}*) jsl_allocator_interface_alloc(\r\n"
+        "            allocator,\r\n"
+        "            ((int64_t) sizeof({{ key_type_name }})) * hash_map->arrays_length,\r\n"
+        "            (int32_t) _Alignof({{ key_type_name }}),\r\n"
+        "            false\r\n"
+        "        );\r\n"
+        "        shard->values_array = ({{ value_type_name }}*) jsl_allocator_interface_alloc(\r\n"
+        "            allocator,\r\n"
+        "            ((int64_t) sizeof({{ value_type_name }})) * hash_map->arrays_length,\r\n"
+        "            (int32_t) _Alignof({{ value_type_name }}),\r\n"
+        "            false\r\n"
+        "        );\r\n"
+        "        shard->hashes_array = (uint64_t*) jsl_allocator_interface_alloc(\r\n"
+        "            allocator,\r\n"
+        "            ((int64_t) sizeof(uint64_t)) * hash_map->arrays_length,\r\n"
+        "            (int32_t) _Alignof(uint64_t),\r\n"
+        "            true\r\n"
+        "        );\r\n"
+        "\r\n"
+        "        res = shard->keys_array != NULL\r\n"
+        "            && shard->values_array != NULL\r\n"
+        "            && shard->hashes_array != NULL;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    if (!res)\r\n"
+        "    {\r\n"
+        "        {{ function_prefix }}_release(hash_map);\r\n"
+        "        return false;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    hash_map->sentinel = PRIVATE_SENTINEL_{{ hash_map_name }};\r\n"
+        "    return true;\r\n"
+        "}\r\n"
+        "\r\n"
+        "static inline void {{ function_prefix }}_lock(\r\n"
+        "    {{ hash_map_name }}Shard* shard\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    // Spin on a plain load so waiting threads don't keep stealing the\r\n"
+        "    // cache line from the owner\r\n"
+        "    while (!jsl__atomic_compare_exchange_u64(&shard->lock, 0, 1))\r\n"
+        "    {\r\n"
+        "        while (jsl__atomic_load_u64(&shard->lock) != 0)\r\n"
+        "            jsl__cpu_relax();\r\n"
+        "    }\r\n"
+        "}\r\n"
+        "\r\n"
+        "static inline void {{ function_prefix }}_unlock(\r\n"
+        "    {{ hash_map_name }}Shard* shard\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    jsl__atomic_store_u64(&shard->lock, 0);\r\n"
+        "}\r\n"
+        "\r\n"
+        "static inline uint64_t {{ function_prefix }}_hash(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    uint64_t hash = 0;\r\n"
+        "    uint64_t* out_hash = &hash;\r\n"
+        "\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    // In JSL_DEBUG, check that the key has zeroed struct padding to help catch\r\n"
+        "    // garbage byte errors\r\n"
+        "    #if defined(JSL_DEBUG)\r\n"
+        "        #ifdef __clang__\r\n"
+        "            #if __has_builtin(__builtin_clear_padding)\r\n"
+        "                {\r\n"
+        "                    {{ key_type_name }} padding_check_copy = *key;\r\n"
+        "                    __builtin_clear_padding(&padding_check_copy);\r\n"
+        "                    JSL_ASSERT(\r\n"
+        "                        JSL_MEMCMP(key, &padding_check_copy, sizeof({{ key_type_name }})) == 0\r\n"
+        "                        && \"Hash map struct key has non-zero padding bytes. Initialize struct keys with JSL_MEMSET before setting fields.\"\r\n"
+        "                    );\r\n"
+        "                }\r\n"
+        "            #endif\r\n"
+        "        #elif defined(__GNUC__) && __GNUC__ >= 11\r\n"
+        "            {\r\n"
+        "                {{ key_type_name }} padding_check_copy = *key;\r\n"
+        "                __builtin_clear_padding(&padding_check_copy);\r\n"
+        "                JSL_ASSERT(\r\n"
+        "                    JSL_MEMCMP(key, &padding_check_copy, sizeof({{ key_type_name }})) == 0\r\n"
+        "                    && \"Hash map struct key has non-zero padding bytes. Initialize struct keys with JSL_MEMSET before setting fields.\"\r\n"
+        "                );\r\n"
+        "            }\r\n"
+        "        #endif\r\n"
+        "    #endif\r\n"
+        "    {% endif %}\r\n"
+        "\r\n"
+        "    {{ hash_function }};\r\n"
+        "\r\n"
+        "    // Avoid clashing with sentinel values\r\n"
+        "    if (hash <= (uint64_t) JSL__HASHMAP_TOMBSTONE)\r\n"
+        "    {\r\n"
+        "        hash = (uint64_t) JSL__HASHMAP_VALUE_OK;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    return hash;\r\n"
+        "}\r\n"
+        "\r\n"
+        "static inline {{ hash_map_name }}Shard* {{ function_prefix }}_shard(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    uint64_t hash\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    // The slot comes from the low bits, so the shard is picked from the top\r\n"
+        "    // bits after a multiply, which also mixes in the low bits\r\n"
+        "    uint64_t index = (hash * 0x9E3779B97F4A7C15ULL) >> hash_map->shard_shift;\r\n"
+        "    return &hash_map->shards[index];\r\n"
+        "}\r\n"
+        "\r\n"
+        "static inline void {{ function_prefix }}_probe(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {{ hash_map_name }}Shard* shard,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key,\r\n"
+        "    {% endif %}\r\n"
+        "    uint64_t hash,\r\n"
+        "    int64_t* out_slot,\r\n"
+        "    bool* out_found\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    *out_slot = -1;\r\n"
+        "    *out_found = false;\r\n"
+        "\r\n"
+        "    int64_t total_checked = 0;\r\n"
+        "    uint64_t slot_mask = (uint64_t) hash_map->arrays_length - 1u;\r\n"
+        "    // Since our slot array length is always a pow 2, we can avoid a modulo\r\n"
+        "    int64_t slot = (int64_t) (hash & slot_mask);\r\n"
+        "\r\n"
+        "    while (total_checked < hash_map->arrays_length)\r\n"
+        "    {\r\n"
+        "        uint64_t slot_hash_value = shard->hashes_array[slot];\r\n"
+        "\r\n"
+        "        if (slot_hash_value == JSL__HASHMAP_EMPTY)\r\n"
+        "        {\r\n"
+        "            *out_slot = slot;\r\n"
+        "            break;\r\n"
+        "        }\r\n"
+        "\r\n"
+        "        if (slot_hash_value == hash && {{ key_compare }})\r\n"
+        "        {\r\n"
+        "            *out_found = true;\r\n"
+        "            *out_slot = slot;\r\n"
+        "            break;\r\n"
+        "        }\r\n"
+        "\r\n"
+        "        slot = (int64_t) (((uint64_t) slot + 1u) & slot_mask);\r\n"
+        "        ++total_checked;\r\n"
+        "    }\r\n"
+        "}\r\n"
+        "\r\n"
+        "static inline void {{ function_prefix }}_backshift(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {{ hash_map_name }}Shard* shard,\r\n"
+        "    int64_t start_slot\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    uint64_t slot_mask = (uint64_t) hash_map->arrays_length - 1u;\r\n"
+        "\r\n"
+        "    int64_t hole = start_slot;\r\n"
+        "    int64_t current = (int64_t) (((uint64_t) start_slot + 1u) & slot_mask);\r\n"
+        "\r\n"
+        "    int64_t loop_check = 0;\r\n"
+        "    while (loop_check < hash_map->arrays_length)\r\n"
+        "    {\r\n"
+        "        uint64_t hash_value = shard->hashes_array[current];\r\n"
+        "\r\n"
+        "        if (hash_value == JSL__HASHMAP_EMPTY)\r\n"
+        "        {\r\n"
+        "            shard->hashes_array[hole] = JSL__HASHMAP_EMPTY;\r\n"
+        "            break;\r\n"
+        "        }\r\n"
+        "\r\n"
+        "        int64_t ideal_slot = (int64_t) (hash_value & slot_mask);\r\n"
+        "\r\n"
+        "        bool should_move = (current > hole)\r\n"
+        "            ? (ideal_slot <= hole || ideal_slot > current)\r\n"
+        "            : (ideal_slot <= hole && ideal_slot > current);\r\n"
+        "\r\n"
+        "        if (should_move)\r\n"
+        "        {\r\n"
+        "            shard->keys_array[hole] = shard->keys_array[current];\r\n"
+        "            shard->values_array[hole] = shard->values_array[current];\r\n"
+        "            shard->hashes_array[hole] = hash_value;\r\n"
+        "            hole = current;\r\n"
+        "        }\r\n"
+        "\r\n"
+        "        current = (int64_t) (((uint64_t) current + 1u) & slot_mask);\r\n"
+        "\r\n"
+        "        ++loop_check;\r\n"
+        "    }\r\n"
+        "}\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Find the slot for the key in a locked shard, adding the key with `value` if\r\n"
+        " * it isn't there yet. Returns -1 if the key is new and the shard is full.\r\n"
+        " */\r\n"
+        "static inline int64_t {{ function_prefix }}_find_or_add(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {{ hash_map_name }}Shard* shard,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key,\r\n"
+        "    {% endif %}\r\n"
+        "    uint64_t hash,\r\n"
+        "    {{ value_type_name }} value,\r\n"
+        "    bool* out_added\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    int64_t slot = -1;\r\n"
+        "    bool existing_found = false;\r\n"
+        "    {{ function_prefix }}_probe(hash_map, shard, key, hash, &slot, &existing_found);\r\n"
+        "\r\n"
+        "    *out_added = false;\r\n"
+        "\r\n"
+        "    if (\r\n"
+        "        slot > -1\r\n"
+        "        && !existing_found\r\n"
+        "        && (int64_t) shard->item_count < hash_map->shard_max_item_count\r\n"
+        "    )\r\n"
+        "    {\r\n"
+        "        {% if key_is_struct %}\r\n"
+        "        shard->keys_array[slot] = *key;\r\n"
+        "        {% else %}\r\n"
+        "        shard->keys_array[slot] = key;\r\n"
+        "        {% endif %}\r\n"
+        "        shard->values_array[slot] = value;\r\n"
+        "        shard->hashes_array[slot] = hash;\r\n"
+        "        jsl__atomic_store_u64(&shard->item_count, shard->item_count + 1);\r\n"
+        "        *out_added = true;\r\n"
+        "    }\r\n"
+        "    else if (!existing_found)\r\n"
+        "    {\r\n"
+        "        slot = -1;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    return slot;\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_insert(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key,\r\n"
+        "    {% endif %}\r\n"
+        "    {{ value_type_name }} value\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    uint64_t hash = {{ function_prefix }}_hash(hash_map, key);\r\n"
+        "    {{ hash_map_name }}Shard* shard = {{ function_prefix }}_shard(hash_map, hash);\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_lock(shard);\r\n"
+        "\r\n"
+        "    bool added = false;\r\n"
+        "    int64_t slot = {{ function_prefix }}_find_or_add(hash_map, shard, key, hash, value, &added);\r\n"
+        "    if (slot > -1 && !added)\r\n"
+        "        shard->values_array[slot] = value;\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_unlock(shard);\r\n"
+        "\r\n"
+        "    return slot > -1;\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_get(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key,\r\n"
+        "    {% endif %}\r\n"
+        "    {{ value_type_name }}* out_value\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "        || out_value == NULL\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    uint64_t hash = {{ function_prefix }}_hash(hash_map, key);\r\n"
+        "    {{ hash_map_name }}Shard* shard = {{ function_prefix }}_shard(hash_map, hash);\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_lock(shard);\r\n"
+        "\r\n"
+        "    int64_t slot = -1;\r\n"
+        "    bool existing_found = false;\r\n"
+        "    {{ function_prefix }}_probe(hash_map, shard, key, hash, &slot, &existing_found);\r\n"
+        "    if (slot > -1 && existing_found)\r\n"
+        "        *out_value = shard->values_array[slot];\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_unlock(shard);\r\n"
+        "\r\n"
+        "    return existing_found;\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_update(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key,\r\n"
+        "    {% endif %}\r\n"
+        "    {{ value_type_name }} initial_value,\r\n"
+        "    {{ hash_map_name }}UpdateFunction update_function,\r\n"
+        "    void* user_data\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "        || update_function == NULL\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    uint64_t hash = {{ function_prefix }}_hash(hash_map, key);\r\n"
+        "    {{ hash_map_name }}Shard* shard = {{ function_prefix }}_shard(hash_map, hash);\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_lock(shard);\r\n"
+        "\r\n"
+        "    bool added = false;\r\n"
+        "    int64_t slot = {{ function_prefix }}_find_or_add(hash_map, shard, key, hash, initial_value, &added);\r\n"
+        "    if (slot > -1)\r\n"
+        "        update_function(&shard->values_array[slot], user_data);\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_unlock(shard);\r\n"
+        "\r\n"
+        "    return slot > -1;\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_delete(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    uint64_t hash = {{ function_prefix }}_hash(hash_map, key);\r\n"
+        "    {{ hash_map_name }}Shard* shard = {{ function_prefix }}_shard(hash_map, hash);\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_lock(shard);\r\n"
+        "\r\n"
+        "    int64_t slot = -1;\r\n"
+        "    bool existing_found = false;\r\n"
+        "    {{ function_prefix }}_probe(hash_map, shard, key, hash, &slot, &existing_found);\r\n"
+        "    if (slot > -1 && existing_found)\r\n"
+        "    {\r\n"
+        "        {{ function_prefix }}_backshift(hash_map, shard, slot);\r\n"
+        "        jsl__atomic_store_u64(&shard->item_count, shard->item_count - 1);\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_unlock(shard);\r\n"
+        "\r\n"
+        "    return existing_found;\r\n"
+        "}\r\n"
+        "\r\n"
+        "int64_t {{ function_prefix }}_item_count(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return -1;\r\n"
+        "\r\n"
+        "    uint64_t total = 0;\r\n"
+        "    for (int64_t i = 0; i < hash_map->shard_count; ++i)\r\n"
+        "    {\r\n"
+        "        total += jsl__atomic_load_u64(&hash_map->shards[i].item_count);\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    return (int64_t) total;\r\n"
+        "}\r\n"
+        "\r\n"
+        "int64_t {{ function_prefix }}_memory_footprint(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return -1;\r\n"
+        "\r\n"
+        "    // Nothing is allocated after init, so this never changes\r\n"
+        "    int64_t slot_bytes = (int64_t) (\r\n"
+        "        sizeof({{ key_type_name }}) + sizeof({{ value_type_name }}) + sizeof(uint64_t)\r\n"
+        "    );\r\n"
+        "    int64_t shard_bytes = (int64_t) sizeof({{ hash_map_name }}Shard) + slot_bytes * hash_map->arrays_length;\r\n"
+        "\r\n"
+        "    return shard_bytes * hash_map->shard_count;\r\n"
+        "}\r\n"
+        "\r\n"
+        "void {{ function_prefix }}_clear(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return;\r\n"
+        "\r\n"
+        "    for (int64_t i = 0; i < hash_map->shard_count; ++i)\r\n"
+        "    {\r\n"
+        "        {{ hash_map_name }}Shard* shard = &hash_map->shards[i];\r\n"
+        "\r\n"
+        "        {{ function_prefix }}_lock(shard);\r\n"
+        "        JSL_MEMSET(shard->hashes_array, 0, sizeof(uint64_t) * (size_t) hash_map->arrays_length);\r\n"
+        "        jsl__atomic_store_u64(&shard->item_count, 0);\r\n"
+        "        {{ function_prefix }}_unlock(shard);\r\n"
+        "    }\r\n"
+        "}\r\n"
+        "\r\n"
+        "void {{ function_prefix }}_free(\r\n"
+        "    {{ hash_map_name }}* hash_map\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return;\r\n"
+        "\r\n"
+        "    {{ function_prefix }}_release(hash_map);\r\n"
+        "    hash_map->sentinel = 0;\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_iterator_start(\r\n"
+        "    {{ hash_map_name }}* hash_map,\r\n"
+        "    JSLAllocatorInterface allocator,\r\n"
+        "    {{ hash_map_name }}Iterator* iterator\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        hash_map == NULL\r\n"
+        "        || iterator == NULL\r\n"
+        "        || hash_map->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    JSL_MEMSET(iterator, 0, sizeof({{ hash_map_name }}Iterator));\r\n"
+        "    iterator->allocator = allocator;\r\n"
+        "\r\n"
+        "    // Always in index order, so two snapshots at once can't deadlock and\r\n"
+        "    // every other function only ever holds one lock\r\n"
+        "    for (int64_t i = 0; i < hash_map->shard_count; ++i)\r\n"
+        "    {\r\n"
+        "        {{ function_prefix }}_lock(&hash_map->shards[i]);\r\n"
+        "        iterator->item_count += (int64_t) hash_map->shards[i].item_count;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    bool res = true;\r\n"
+        "    if (iterator->item_count > 0)\r\n"
+        "    {\r\n"
+        "        iterator->keys_array = ({{ key_type_name }}*) jsl_allocator_interface_alloc(\r\n"
+        "            allocator,\r\n"
+        "            ((int64_t) sizeof({{ key_type_name }})) * iterator->item_count,\r\n"
+        "            (int32_t) _Alignof({{ key_type_name }}),\r\n"
+        "            false\r\n"
+        "        );\r\n"
+        "        iterator->values_array = ({{ value_type_name }}*) jsl_allocator_interface_alloc(\r\n"
+        "            allocator,\r\n"
+        "            ((int64_t) sizeof({{ value_type_name }})) * iterator->item_count,\r\n"
+        "            (int32_t) _Alignof({{ value_type_name }}),\r\n"
+        "            false\r\n"
+        "        );\r\n"
+        "        res = iterator->keys_array != NULL && iterator->values_array != NULL;\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    int64_t copied = 0;\r\n"
+        "    for (int64_t i = 0; res && i < hash_map->shard_count; ++i)\r\n"
+        "    {\r\n"
+        "        {{ hash_map_name }}Shard* shard = &hash_map->shards[i];\r\n"
+        "        for (int64_t slot = 0; slot < hash_map->arrays_length; ++slot)\r\n"
+        "        {\r\n"
+        "            if (shard->hashes_array[slot] == JSL__HASHMAP_EMPTY)\r\n"
+        "                continue;\r\n"
+        "\r\n"
+        "            iterator->keys_array[copied] = shard->keys_array[slot];\r\n"
+        "            iterator->values_array[copied] = shard->values_array[slot];\r\n"
+        "            ++copied;\r\n"
+        "        }\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    for (int64_t i = 0; i < hash_map->shard_count; ++i)\r\n"
+        "    {\r\n"
+        "        {{ function_prefix }}_unlock(&hash_map->shards[i]);\r\n"
+        "    }\r\n"
+        "\r\n"
+        "    if (!res)\r\n"
+        "        {{ function_prefix }}_iterator_free(iterator);\r\n"
+        "\r\n"
+        "    return res;\r\n"
+        "}\r\n"
+        "\r\n"
+        "bool {{ function_prefix }}_iterator_next(\r\n"
+        "    {{ hash_map_name }}Iterator* iterator,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}** out_key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }}* out_key,\r\n"
+        "    {% endif %}\r\n"
+        "    {{ value_type_name }}* out_value\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        iterator == NULL\r\n"
+        "        || iterator->current_item >= iterator->item_count\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
+        "\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    *out_key = &iterator->keys_array[iterator->current_item];\r\n"
+        "    {% else %}\r\n"
+        "    *out_key = iterator->keys_array[iterator->current_item];\r\n"
+        "    {% endif %}\r\n"
+        "    *out_value = iterator->values_array[iterator->current_item];\r\n"
+        "    ++iterator->current_item;\r\n"
+        "\r\n"
+        "    return true;\r\n"
+        "}\r\n"
+        "\r\n"
+        "void {{ function_prefix }}_iterator_free(\r\n"
+        "    {{ hash_map_name }}Iterator* iterator\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (iterator == NULL)\r\n"
+        "        return;\r\n"
+        "\r\n"
+        "    if (iterator->keys_array != NULL)\r\n"
+        "        jsl_allocator_interface_free(iterator->allocator, iterator->keys_array);\r\n"
+        "    if (iterator->values_array != NULL)\r\n"
+        "        jsl_allocator_interface_free(iterator->allocator, iterator->values_array);\r\n"
+        "\r\n"
+        "    JSL_MEMSET(iterator, 0, sizeof({{ hash_map_name }}Iterator));\r\n"
+        "}\r\n"
+    );
+
+    static JSLImmutableMemory cache_header_template = JSL_CSTR_INITIALIZER(
+        "/**\r\n"
+        " * AUTO GENERATED FILE\r\n"
+        " *\r\n"
+        " * This file contains the header for a cache `{{ hash_map_name }}` which maps\r\n"
+        " * `{{ key_type_name }}` keys to `{{ value_type_name }}` values and holds at most\r\n"
+        " * a fixed number of them.\r\n"
+        " *\r\n"
+        " * Once the cache is full, inserting a new key evicts an old one, picked with\r\n"
+        " * the CLOCK algorithm. Every entry has a reference byte which a successful get\r\n"
+        " * sets. When room is needed the clock hand sweeps the entries in order, clearing\r\n"
+        " * the reference bytes it passes, and evicts the first entry which hasn't been\r\n"
+        " * used since the hand last went by. This approximates least recently used, but\r\n"
+        " * a hit is a single byte store instead of unlinking and relinking a list node.\r\n"
+        " *\r\n"
+        " * The entries live in one dense array which the hash table points into with\r\n"
+        " * 32 bit indices, so there are no pointers to fix up when entries move and\r\n"
+        " * the table is half the size of one holding full hashes. All memory is\r\n"
+        " * allocated once in init.\r\n"
+        " *\r\n"
+        " * The cache isn't thread safe, the intended use is one cache per thread.\r\n"
+        " *\r\n"
+        " * This file was auto generated from the hash map generation utility that's part of\r\n"
+        " * the \"Jack's Standard Library\" project. The utility generates a header file and a\r\n"
+        " * C file for a type safe, open addressed, hash map. By generating the code rather\r\n"
+        " * than using macros, two benefits are gained. One, the code is much easier to debug.\r\n"
+        " * Two, it's much more obvious how much code you're generating, which means you are\r\n"
+        " * much less likely to accidentally create the combinatoric explosion of code that's\r\n"
+        " * so common in C++ projects. Adding friction to things is actually good sometimes.\r\n"
+        " *\r\n"
+        " * ## LICENSE\r\n"
+        " *\r\n"
+        " * Copyright (c) 2026 Jack Stouffer\r\n"
+        " *\r\n"
+        " * Permission is hereby granted, free of charge, to any person obtaining a\r\n"
+        " * copy of this software and associated documentation files (the \"Software\"),\r\n"
+        " * to deal in the Software without restriction, including without limitation\r\n"
+        " * the rights to use, copy, modify, merge, publish, distribute, sublicense,\r\n"
+        " * and/or sell copies of the Software, and to permit persons to whom the Software\r\n"
+        " * is furnished to do so, subject to the following conditions:\r\n"
+        " *\r\n"
+        " * The above copyright notice and this permission notice shall be included in all\r\n"
+        " * copies or substantial portions of the Software.\r\n"
+        " *\r\n"
+        " * THE SOFTWARE IS PROVIDED \"AS IS\", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR\r\n"
+        " * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,\r\n"
+        " * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE\r\n"
+        " * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,\r\n"
+        " * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN\r\n"
+        " * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.\r\n"
+        " */\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Called by insert with the entry it's about to evict, so that anything the\r\n"
+        " * value owns can be released. The entry is overwritten after this returns.\r\n"
+        " */\r\n"
+        "typedef void (*{{ hash_map_name }}EvictFunction)(\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key,\r\n"
+        "    {% endif %}\r\n"
+        "    {{ value_type_name }}* value,\r\n"
+        "    void* user_data\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * A fixed capacity cache which maps `{{ key_type_name }}` keys to\r\n"
+        " * `{{ value_type_name }}` values with CLOCK eviction.\r\n"
+        " */\r\n"
+        "typedef struct {{ hash_map_name }} {\r\n"
+        "    // putting the sentinel first means it's much more likely to get\r\n"
+        "    // corrupted from accidental overwrites, therefore making it\r\n"
+        "    // more likely that memory bugs are caught.\r\n"
+        "    uint32_t sentinel;\r\n"
+        "    uint32_t generational_id;\r\n"
+        "    JSLAllocatorInterface allocator;\r\n"
+        "\r\n"
+        "    /// @brief entries, the first `item_count` are in use\r\n"
+        "    {{ key_type_name }}* keys_array;\r\n"
+        "    {{ value_type_name }}* values_array;\r\n"
+        "    /// @brief CLOCK reference byte per entry, set on a hit and cleared by the hand\r\n"
+        "    uint8_t* referenced_array;\r\n"
+        "\r\n"
+        "    /// @brief high 32 bits are the top of the key's hash, low 32 bits the entry index plus one, zero when empty\r\n"
+        "    uint64_t* slots_array;\r\n"
+        "    int64_t slots_length;\r\n"
+        "\r\n"
+        "    int64_t capacity;\r\n"
+        "    int64_t item_count;\r\n"
+        "    /// @brief next entry the CLOCK hand looks at when the cache is full\r\n"
+        "    int64_t clock_hand;\r\n"
+        "\r\n"
+        "    /// @brief number of gets which found the key\r\n"
+        "    int64_t hit_count;\r\n"
+        "    /// @brief number of gets which didn't\r\n"
+        "    int64_t miss_count;\r\n"
+        "    /// @brief number of entries insert has evicted\r\n"
+        "    int64_t eviction_count;\r\n"
+        "\r\n"
+        "    {{ hash_map_name }}EvictFunction evict_function;\r\n"
+        "    void* evict_user_data;\r\n"
+        "\r\n"
+        "    uint64_t seed;\r\n"
+        "} {{ hash_map_name }};\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Iterator type which is used by the iterator functions to\r\n"
+        " * allow you to loop over the cache contents.\r\n"
+        " */\r\n"
+        "typedef struct {{ hash_map_name }}Iterator {\r\n"
+        "    {{ hash_map_name }}* cache;\r\n"
+        "    int64_t current_entry;\r\n"
+        "    uint64_t generational_id;\r\n"
+        "} {{ hash_map_name }}Iterator;\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Initialize an instance of the cache.\r\n"
+        " *\r\n"
+        " * All of the memory that this cache will need is allocated from the passed\r\n"
+        " * in allocator right away.\r\n"
+        " *\r\n"
+        " * @warning This cache uses a well distributed hash. But in order to properly protect against\r\n"
+        " * hash flooding attacks you must do two things. One, provide good random data for the\r\n"
+        " * seed value. This means using your OS's secure random number generator, not `rand`.\r\n"
+        " * As this is very platform specific JSL does not come with a mechanism for getting these\r\n"
+        " * random numbers; you must do it yourself. Two, use a different seed value as often as\r\n"
+        " * possible, ideally every user interaction. This would make hash flooding attacks almost\r\n"
+        " * impossible. If you are absolutely sure that this cache cannot be attacked with hash\r\n"
+        " * flooding then zero is a valid seed value.\r\n"
+        " *\r\n"
+        " * @param cache The pointer to the cache instance to initialize\r\n"
+        " * @param allocator The allocator that this cache will use\r\n"
+        " * @param capacity The number of entries the cache holds before it starts evicting, at most `INT32_MAX`\r\n"
+        " * @param seed Seed value for the hash function to protect against hash flooding attacks\r\n"
+        " * @returns `true` on success, `false` if any parameter is invalid or out of memory.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_init(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    JSLAllocatorInterface allocator,\r\n"
+        "    int64_t capacity,\r\n"
+        "    uint64_t seed\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Set the function which insert calls with each entry it evicts. Pass NULL\r\n"
+        " * to stop calling it. Delete and clear don't call it.\r\n"
+        " *\r\n"
+        " * @param cache The pointer to the cache instance\r\n"
+        " * @param evict_function Called with each evicted entry\r\n"
+        " * @param user_data Passed through to `evict_function`\r\n"
+        " */\r\n"
+        "void {{ function_prefix }}_set_evict_function(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    {{ hash_map_name }}EvictFunction evict_function,\r\n"
+        "    void* user_data\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Insert the given value into the cache. If the key already exists in the\r\n"
+        " * cache the value will be overwritten. If the key is new and the cache is\r\n"
+        " * full, the entry picked by the CLOCK hand is evicted to make room.\r\n"
+        " *\r\n"
+        " * New entries start out unreferenced, so an entry which is never hit is\r\n"
+        " * evicted the next time the hand comes around. This keeps a scan over many\r\n"
+        " * keys which are each used once from pushing out the entries which are hit\r\n"
+        " * over and over.\r\n"
+        " *\r\n"
+        "{% if key_is_struct %}\r\n"
+        " * With struct keys, struct padding can be filled with random-ish, garbage bytes.\r\n"
+        " * This will cause the hash probe to fail. It is *very* important to either\r\n"
+        " * 1, initialize the struct with memset to zero 2, use a canonicalization function\r\n"
+        " * before using the struct in the cache or 3. use a custom comparison function\r\n"
+        " * (requires regenerating the source with the proper command line option). Do not\r\n"
+        " * rely on `{0}` init! The compiler is allowed to cheat and skip padding bytes.\r\n"
+        " *\r\n"
+        "{% endif %}\r\n"
+        " * @param cache The pointer to the cache instance\r\n"
+        " * @param key Cache key\r\n"
+        " * @param value Value to store\r\n"
+        " * @returns `true` on success, `false` on invalid parameters.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_insert(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key,\r\n"
+        "    {% endif %}\r\n"
+        "    {{ value_type_name }} value\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Get a value from the cache if it exists and mark the entry as recently\r\n"
+        " * used. If it does not NULL is returned.\r\n"
+        " *\r\n"
+        " * The pointer returned points to the value stored inside of the cache. It's\r\n"
+        " * only valid until the next insert or delete, which can evict or move it.\r\n"
+        " *\r\n"
+        " * @param cache The pointer to the cache instance\r\n"
+        " * @param key Cache key\r\n"
+        " * @returns The pointer to the value in the cache, or null.\r\n"
+        " */\r\n"
+        "{{ value_type_name }}* {{ function_prefix }}_get(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Remove a key/value pair from the cache if it exists. If it does not false\r\n"
+        " * is returned. The last entry is moved into the freed spot, so the entries\r\n"
+        " * stay dense.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_delete(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Remove all entries from the cache. The hit, miss, and eviction counts are\r\n"
+        " * kept. Iterators become invalid.\r\n"
         " */\r\n"
-        "bool {{ function_prefix }}_key_value_iterator_init(\r\n"
-        "    JSLStrToStrMap* map,\r\n"
-        "    JSLStrToStrMapKeyValueIter* iterator\r\n"
+        "void {{ function_prefix }}_clear(\r\n"
+        "    {{ hash_map_name }}* cache\r\n"
         ");\r\n"
         "\r\n"
         "/**\r\n"
-        " * Advance the key/value iterator.\r\n"
-        " * \r\n"
-        " * Example:\r\n"
-        " *\r\n"
-        " * ```\r\n"
-        " * {{ hash_map_name }}KeyValueIter iter;\r\n"
-        " * {{ function_prefix }}_key_value_iterator_init(\r\n"
-        " *     &map, &iter\r\n"
-        " * );\r\n"
-        " * \r\n"
-        " * {{ key_type_name }} key;\r\n"
-        " * {{ value_type_name }} value;\r\n"
-        " * while ({{ function_prefix }}_key_value_iterator_next(&iter, &key, &value))\r\n"
-        " * {\r\n"
-        " *    ...\r\n"
-        " * }\r\n"
-        " * ```\r\n"
-        " *\r\n"
-        " * Returns the next key/value pair for the map. The iterator must be\r\n"
-        " * initialized and is invalidated if the map is mutated; iteration order\r\n"
-        " * is undefined.\r\n"
-        " *\r\n"
-        " * @param iterator Iterator to advance.\r\n"
-        " * @param out_key Output for the current key.\r\n"
-        " * @param out_value Output for the current value.\r\n"
-        " * @return `true` if a pair was produced, `false` if exhausted or invalid.\r\n"
+        " * Free all the underlying memory that was allocated by this cache on the given\r\n"
+        " * allocator.\r\n"
         " */\r\n"
-        "bool {{ function_prefix }}_key_value_iterator_next(\r\n"
-        "    {{ hash_map_name }}KeyValueIter* iterator,\r\n"
-        "    {{ key_type_name }}* out_key,\r\n"
-        "    {{ value_type_name }}* out_value\r\n"
+        "void {{ function_prefix }}_free(\r\n"
+        "    {{ hash_map_name }}* cache\r\n"
         ");\r\n"
         "\r\n"
         "/**\r\n"
-        " * Remove a key/value.\r\n"
+        " * Get the number of bytes this cache holds from its allocator. All of it is\r\n"
+        " * allocated by init, so the number doesn't change with the item count.\r\n"
+        " * Allocator bookkeeping and alignment padding aren't included.\r\n"
         " *\r\n"
-        " * Iterators become invalid. If the key is not present or parameters are invalid,\r\n"
-        " * the map is unchanged and `false` is returned.\r\n"
+        " * @param cache The pointer to the cache instance\r\n"
+        " * @returns The size in bytes, or -1 on invalid parameters.\r\n"
+        " */\r\n"
+        "int64_t {{ function_prefix }}_memory_footprint(\r\n"
+        "    {{ hash_map_name }}* cache\r\n"
+        ");\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Get the number of bytes init allocates for the given `capacity`, without\r\n"
+        " * making a cache. Use this to find the largest `capacity` which fits in a\r\n"
+        " * memory budget.\r\n"
         " *\r\n"
-        " * @param map Map to mutate.\r\n"
-        " * @param key Key to remove.\r\n"
-        " * @return `true` if the key existed and was removed, `false` otherwise.\r\n"
+        " * @param capacity The number of entries the cache would hold\r\n"
+        " * @returns The size in bytes, or -1 if `capacity` is invalid.\r\n"
         " */\r\n"
-        "bool {{ function_prefix }}_delete(\r\n"
-        "    {{ hash_map_name }}* map,\r\n"
-        "    {{ key_type_name }} key\r\n"
+        "int64_t {{ function_prefix }}_memory_footprint_for(\r\n"
+        "    int64_t capacity\r\n"
         ");\r\n"
         "\r\n"
         "/**\r\n"
-        " * Remove all keys and values from the map.  Iterators become invalid.\r\n"
+        " * Create a new iterator over this cache. Entries are visited in the order\r\n"
+        " * they're stored in, which has nothing to do with how recently they were used.\r\n"
+        " * Iterating doesn't mark entries as used.\r\n"
         " *\r\n"
-        " * @param map Map to clear.\r\n"
+        " * Any insertion or deletion after the iterator is created will invalidate\r\n"
+        " * the iteration.\r\n"
+        " *\r\n"
+        " * Example usage:\r\n"
+        " * @code\r\n"
+        " * {{ key_type_name }} key;\r\n"
+        " * {{ value_type_name }} value;\r\n"
+        " * {{ hash_map_name }}Iterator iterator;\r\n"
+        " * {{ function_prefix }}_iterator_start(cache, &iterator);\r\n"
+        " * while ({{ function_prefix }}_iterator_next(&iterator, &key, &value))\r\n"
+        " * {\r\n"
+        " *     ...\r\n"
+        " * }\r\n"
+        " * @endcode\r\n"
         " */\r\n"
-        "void {{ function_prefix }}_clear(\r\n"
-        "    {{ hash_map_name }}* map\r\n"
+        "bool {{ function_prefix }}_iterator_start(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    {{ hash_map_name }}Iterator* iterator\r\n"
         ");\r\n"
         "\r\n"
-        "#ifdef __cplusplus\r\n"
-        "}\r\n"
-        "#endif\r\n"
+        "/**\r\n"
+        " * Iterate over the cache. If a key/value was found then true is returned.\r\n"
+        " */\r\n"
+        "bool {{ function_prefix }}_iterator_next(\r\n"
+        "    {{ hash_map_name }}Iterator* iterator,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}** out_key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }}* out_key,\r\n"
+        "    {% endif %}\r\n"
+        "    {{ value_type_name }}* out_value\r\n"
+        ");\r\n"
     );
-    static JSLImmutableMemory dynamic_source_template = JSL_CSTR_INITIALIZER(
+
+    static JSLImmutableMemory cache_source_template = JSL_CSTR_INITIALIZER(
         "/**\r\n"
-        " * # JSL String to String Map\r\n"
-        " * \r\n"
-        " * This file is a single header file library that implements a hash map data\r\n"
-        " * structure, which maps length based string keys to length based string values,\r\n"
-        " * and is optimized around the arena allocator design. This file is part of\r\n"
-        " * the Jack's Standard Library project.\r\n"
-        " * \r\n"
-        " * ## Documentation\r\n"
-        " * \r\n"
-        " * See `docs/jsl_str_to_str_map.md` for a formatted documentation page.\r\n"
-        " *\r\n"
-        " * ## Caveats\r\n"
-        " * \r\n"
-        " * This map uses arenas, so some wasted memory is indeveatble. Care has\r\n"
-        " * been taken to reuse as much allocated memory as possible. But if your\r\n"
-        " * map is long lived it's possible to start exhausting the arena with\r\n"
-        " * old memory.\r\n"
-        " * \r\n"
-        " * Remember to\r\n"
-        " * \r\n"
-        " * * have an initial item count guess as accurate as you can to reduce rehashes\r\n"
-        " * * have the arena have as short a lifetime as possible\r\n"
-        " * \r\n"
-        " * ## License\r\n"
-        " *\r\n"
-        " * Copyright (c) 2025 Jack Stouffer\r\n"
+        " * AUTO GENERATED FILE\r\n"
+        " *\r\n"
+        " * See the header for more information.\r\n"
+        " *\r\n"
+        " * ## LICENSE\r\n"
+        " *\r\n"
+        " * Copyright (c) 2026 Jack Stouffer\r\n"
         " *\r\n"
         " * Permission is hereby granted, free of charge, to any person obtaining a\r\n"
-        " * copy of this software and associated documentation files (the “Software”),\r\n"
+        " * copy of this software and associated documentation files (the \"Software\"),\r\n"
         " * to deal in the Software without restriction, including without limitation\r\n"
         " * the rights to use, copy, modify, merge, publish, distribute, sublicense,\r\n"
         " * and/or sell copies of the Software, and to permit persons to whom the Software\r\n"
@@ -1361,7 +4641,7 @@
         " * The above copyright notice and this permission notice shall be included in all\r\n"
         " * copies or substantial portions of the Software.\r\n"
         " *\r\n"
-        " * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR\r\n"
+        " * THE SOFTWARE IS PROVIDED \"AS IS\", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR\r\n"
         " * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,\r\n"
         " * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE\r\n"
         " * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,\r\n"
@@ -1369,712 +4649,618 @@
         " * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.\r\n"
         " */\r\n"
         "\r\n"
-        "#include <stdint.h>\r\n"
-        "#include <stddef.h>\r\n"
-        "#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 202311L\r\n"
-        "    #include <stdbool.h>\r\n"
-        "#endif\r\n"
-        "\r\n"
-        "#include \"jsl/core.h\"\r\n"
-        "#include \"jsl/hash_map_common.h\"\r\n"
-        "#include \"jsl/str_to_str_map.h\"\r\n"
-        "\r\n"
-        "#define JSL__MAP_PRIVATE_SENTINEL 8973815015742603881U\r\n"
-        "\r\n"
-        "JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_init(\r\n"
-        "    JSLStrToStrMap* map,\r\n"
-        "    JSLArena* arena,\r\n"
-        "    uint64_t seed\r\n"
+        "static int64_t {{ function_prefix }}_slots_length_for(\r\n"
+        "    int64_t capacity\r\n"
         ")\r\n"
         "{\r\n"
-        "    return jsl_str_to_str_map_init2(\r\n"
-        "        map,\r\n"
-        "        arena,\r\n"
-        "        seed,\r\n"
-        "        32,\r\n"
-        "        0.75f\r\n"
-        "    );\r\n"
+        "    int64_t max_with_load_factor = (int64_t) ((float) capacity / 0.75f) + 1;\r\n"
+        "    return jsl_next_power_of_two_i64(JSL_MAX(max_with_load_factor, 32));\r\n"
         "}\r\n"
         "\r\n"
-        "JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_init2(\r\n"
-        "    JSLStrToStrMap* map,\r\n"
-        "    JSLArena* arena,\r\n"
-        "    uint64_t seed,\r\n"
-        "    int64_t item_count_guess,\r\n"
-        "    float load_factor\r\n"
+        "static int64_t {{ function_prefix }}_bytes_for(\r\n"
+        "    int64_t capacity,\r\n"
+        "    int64_t slots_length\r\n"
         ")\r\n"
         "{\r\n"
-        "    bool res = true;\r\n"
-        "\r\n"
-        "    if (\r\n"
-        "        map == NULL\r\n"
-        "        || arena == NULL\r\n"
-        "        || item_count_guess <= 0\r\n"
-        "        || load_factor <= 0.0f\r\n"
-        "        || load_factor >= 1.0f\r\n"
-        "    )\r\n"
-        "        res = false;\r\n"
-        "\r\n"
-        "    if (res)\r\n"
-        "    {\r\n"
-        "        JSL_MEMSET(map, 0, sizeof(JSLStrToStrMap));\r\n"
-        "        map->arena = arena;\r\n"
-        "        map->load_factor = load_factor;\r\n"
-        "        map->hash_seed = seed;\r\n"
-        "\r\n"
-        "        item_count_guess = JSL_MAX(32L, item_count_guess);\r\n"
-        "        int64_t items = jsl_next_power_of_two_i64(item_count_guess + 1);\r\n"
-        "\r\n"
-        "        map->entry_lookup_table = (uintptr_t*) jsl_arena_allocate_aligned(\r\n"
-        "            arena,\r\n"
-        "            (int64_t) sizeof(uintptr_t) * items,\r\n"
-        "            _Alignof(uintptr_t),\r\n"
-        "            true\r\n"
-        "        ).data;\r\n"
-        "        \r\n"
-        "        map->entry_lookup_table_length = items;\r\n"
-        "\r\n"
-        "        map->sentinel = JSL__MAP_PRIVATE_SENTINEL;\r\n"
-        "    }\r\n"
-        "\r\n"
-        "    return res;\r\n"
+        "    int64_t entry_bytes = (int64_t) (sizeof({{ key_type_name }}) + sizeof({{ value_type_name }}) + sizeof(uint8_t));\r\n"
+        "    return capacity * entry_bytes + slots_length * (int64_t) sizeof(uint64_t);\r\n"
         "}\r\n"
         "\r\n"
-        "static bool jsl__str_to_str_map_rehash(\r\n"
-        "    JSLStrToStrMap* map\r\n"
+        "static void {{ function_prefix }}_release(\r\n"
+        "    {{ hash_map_name }}* cache\r\n"
         ")\r\n"
         "{\r\n"
-        "    bool res = false;\r\n"
+        "    if (cache->keys_array != NULL)\r\n"
+        "        jsl_allocator_interface_free(cache->allocator, cache->keys_array);\r\n"
+        "    if (cache->values_array != NULL)\r\n"
+        "        jsl_allocator_interface_free(cache->allocator, cache->values_array);\r\n"
+        "    if (cache->referenced_array != NULL)\r\n"
+        "        jsl_allocator_interface_free(cache->allocator, cache->referenced_array);\r\n"
+        "    if (cache->slots_array != NULL)\r\n"
+        "        jsl_allocator_interface_free(cache->allocator, cache->slots_array);\r\n"
+        "\r\n"
+        "    cache->keys_array = NULL;\r\n"
+        "    cache->values_array = NULL;\r\n"
+        "    cache->referenced_array = NULL;\r\n"
+        "    cache->slots_array = NULL;\r\n"
+        "}\r\n"
         "\r\n"
-        "    bool params_valid = (\r\n"
-        "        map != NULL\r\n"
-        "        && map->arena != NULL\r\n"
-        "        && map->sentinel == JSL__MAP_PRIVATE_SENTINEL\r\n"
-        "        && map->entry_lookup_table != NULL\r\n"
-        "        && map->entry_lookup_table_length > 0\r\n"
-        "    );\r\n"
+        "bool {{ function_prefix }}_init(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    JSLAllocatorInterface allocator,\r\n"
+        "    int64_t capacity,\r\n"
+        "    uint64_t seed\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (cache == NULL || capacity < 1 || capacity > INT32_MAX)\r\n"
+        "        return false;\r\n"
         "\r\n"
-        "    uintptr_t* old_table = params_valid ? map->entry_lookup_table : NULL;\r\n"
-        "    int64_t old_length = params_valid ? map->entry_lookup_table_length : 0;\r\n"
+        "    JSL_MEMSET(cache, 0, sizeof({{ hash_map_name }}));\r\n"
         "\r\n"
-        "    int64_t new_length = params_valid ? jsl_next_power_of_two_i64(old_length + 1) : 0;\r\n"
-        "    bool length_valid = params_valid && new_length > old_length && new_length > 0;\r\n"
+        "    cache->seed = seed;\r\n"
+        "    cache->allocator = allocator;\r\n"
+        "    cache->capacity = capacity;\r\n"
+        "    cache->slots_length = {{ function_prefix }}_slots_length_for(capacity);\r\n"
         "\r\n"
-        "    bool bytes_possible = length_valid\r\n"
-        "        && new_length <= (INT64_MAX / (int64_t) sizeof(uintptr_t));\r\n"
+        "    cache->keys_array = ({{ key_type_name }}*) jsl_allocator_interface_alloc(\r\n"
+        "        allocator,\r\n"
+        "        ((int64_t) sizeof({{ key_type_name }})) * capacity,\r\n"
+        "        (int32_t) _Alignof({{ key_type_name }}),\r\n"
+        "        false\r\n"
+        "    );\r\n"
+        "    cache->values_array = ({{ value_type_name }}*) jsl_allocator_interface_alloc(\r\n"
+        "        allocator,\r\n"
+        "        ((int64_t) sizeof({{ value_type_name }})) * capacity,\r\n"
+        "        (int32_t) _Alignof({{ value_type_name }}),\r\n"
+        "        false\r\n"
+        "    );\r\n"
+        "    cache->referenced_array = (uint8_t*) jsl_allocator_interface_alloc(\r\n"
+        "        allocator,\r\n"
+        "        capacity,\r\n"
+        "        JSL_DEFAULT_ALLOCATION_ALIGNMENT,\r\n"
+        "        false\r\n"
+        "    );\r\n"
+        "    cache->slots_array = (uint64_t*) jsl_allocator_interface_alloc(\r\n"
+        "        allocator,\r\n"
+        "        ((int64_t) sizeof(uint64_t)) * cache->slots_length,\r\n"
+        "        (int32_t) _Alignof(uint64_t),\r\n"
+        "        true\r\n"
+        "    );\r\n"
         "\r\n"
-        "    int64_t bytes_needed = bytes_possible\r\n"
-        "        ? (int64_t) sizeof(uintptr_t) * new_length\r\n"
-        "        : 0;\r\n"
+        "    bool res = cache->keys_array != NULL\r\n"
+        "        && cache->values_array != NULL\r\n"
+        "        && cache->referenced_array != NULL\r\n"
+        "        && cache->slots_array != NULL;\r\n"
         "\r\n"
-        "    JSLFatPtr new_table_mem = {0};\r\n"
-        "    if (bytes_possible)\r\n"
+        "    if (!res)\r\n"
         "    {\r\n"
-        "        new_table_mem = jsl_arena_allocate_aligned(\r\n"
-        "            map->arena,\r\n"
-        "            bytes_needed,\r\n"
-        "            _Alignof(uintptr_t),\r\n"
-        "            true\r\n"
-        "        );\r\n"
+        "        {{ function_prefix }}_release(cache);\r\n"
+        "        return false;\r\n"
         "    }\r\n"
         "\r\n"
-        "    uintptr_t* new_table = (bytes_possible && new_table_mem.data != NULL)\r\n"
-        "        ? (uintptr_t*) new_table_mem.data\r\n"
-        "        : NULL;\r\n"
-        "\r\n"
-        "    uint64_t lut_mask = new_length > 0 ? ((uint64_t) new_length - 1u) : 0;\r\n"
-        "    int64_t old_index = 0;\r\n"
-        "    bool migrate_ok = new_table != NULL;\r\n"
-        "\r\n"
-        "    while (migrate_ok && old_index < old_length)\r\n"
-        "    {\r\n"
-        "        uintptr_t lut_res = old_table[old_index];\r\n"
-        "\r\n"
-        "        bool occupied = (\r\n"
-        "            lut_res != 0\r\n"
-        "            && lut_res != JSL__MAP_EMPTY\r\n"
-        "            && lut_res != JSL__MAP_TOMBSTONE\r\n"
-        "        );\r\n"
-        "\r\n"
-        "        struct JSL__StrToStrMapEntry* entry = occupied\r\n"
-        "            ? (struct JSL__StrToStrMapEntry*) lut_res\r\n"
-        "            : NULL;\r\n"
+        "    cache->sentinel = PRIVATE_SENTINEL_{{ hash_map_name }};\r\n"
+        "    return true;\r\n"
+        "}\r\n"
         "\r\n"
-        "        int64_t probe_index = entry != NULL\r\n"
-        "            ? (int64_t) (entry->hash & lut_mask)\r\n"
-        "            : 0;\r\n"
+        "void {{ function_prefix }}_set_evict_function(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    {{ hash_map_name }}EvictFunction evict_function,\r\n"
+        "    void* user_data\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        cache == NULL\r\n"
+        "        || cache->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return;\r\n"
         "\r\n"
-        "        int64_t probes = 0;\r\n"
+        "    cache->evict_function = evict_function;\r\n"
+        "    cache->evict_user_data = user_data;\r\n"
+        "}\r\n"
         "\r\n"
-        "        bool insert_needed = entry != NULL;\r\n"
-        "        while (migrate_ok && insert_needed && probes < new_length)\r\n"
-        "        {\r\n"
-        "            uintptr_t probe_res = new_table[probe_index];\r\n"
-        "            bool slot_free = (\r\n"
-        "                probe_res == JSL__MAP_EMPTY\r\n"
-        "                || probe_res == JSL__MAP_TOMBSTONE\r\n"
-        "            );\r\n"
+        "static inline uint64_t {{ function_prefix }}_hash(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    uint64_t hash = 0;\r\n"
+        "    uint64_t* out_hash = &hash;\r\n"
         "\r\n"
-        "            if (slot_free)\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    // In JSL_DEBUG, check that the key has zeroed struct padding to help catch\r\n"
+        "    // garbage byte errors\r\n"
+        "    #if defined(JSL_DEBUG)\r\n"
+        "        #ifdef __clang__\r\n"
+        "            #if __has_builtin(__builtin_clear_padding)\r\n"
+        "                {\r\n"
+        "                    {{ key_type_name }} padding_check_copy = *key;\r\n"
+        "                    __builtin_clear_padding(&padding_check_copy);\r\n"
+        "                    JSL_ASSERT(\r\n"
+        "                        JSL_MEMCMP(key, &padding_check_copy, sizeof({{ key_type_name }})) == 0\r\n"
+        "                        && \"Hash map struct key has non-zero padding bytes. Initialize struct keys with JSL_MEMSET before setting fields.\"\r\n"
+        "                    );\r\n"
+        "                }\r\n"
+        "            #endif\r\n"
+        "        #elif defined(__GNUC__) && __GNUC__ >= 11\r\n"
         "            {\r\n"
-        "                new_table[probe_index] = (uintptr_t) entry;\r\n"
-        "                insert_needed = false;\r\n"
-        "                break;\r\n"
+        "                {{ key_type_name }} padding_check_copy = *key;\r\n"
+        "                __builtin_clear_padding(&padding_check_copy);\r\n"
+        "                JSL_ASSERT(\r\n"
+        "                    JSL_MEMCMP(key, &padding_check_copy, sizeof({{ key_type_name }})) == 0\r\n"
+        "                    && \"Hash map struct key has non-zero padding bytes. Initialize struct keys with JSL_MEMSET before setting fields.\"\r\n"
+        "                );\r\n"
         "            }\r\n"
+        "        #endif\r\n"
+        "    #endif\r\n"
+        "    {% endif %}\r\n"
         "\r\n"
-        "            probe_index = (int64_t) (((uint64_t) probe_index + 1u) & lut_mask);\r\n"
-        "            ++probes;\r\n"
-        "        }\r\n"
-        "\r\n"
-        "        bool placement_failed = insert_needed;\r\n"
-        "        if (placement_failed)\r\n"
-        "        {\r\n"
-        "            migrate_ok = false;\r\n"
-        "        }\r\n"
-        "\r\n"
-        "        ++old_index;\r\n"
-        "    }\r\n"
+        "    {{ hash_function }};\r\n"
         "\r\n"
-        "    bool should_commit = migrate_ok && new_table != NULL && length_valid;\r\n"
-        "    if (should_commit)\r\n"
-        "    {\r\n"
-        "        map->entry_lookup_table = new_table;\r\n"
-        "        map->entry_lookup_table_length = new_length;\r\n"
-        "        map->tombstone_count = 0;\r\n"
-        "        ++map->generational_id;\r\n"
-        "        res = true;\r\n"
-        "    }\r\n"
+        "    return hash;\r\n"
+        "}\r\n"
         "\r\n"
-        "    bool failed = !should_commit;\r\n"
-        "    if (failed)\r\n"
-        "    {\r\n"
-        "        res = false;\r\n"
-        "    }\r\n"
+        "static inline uint64_t {{ function_prefix }}_entry_hash(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    int64_t entry\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    return {{ function_prefix }}_hash(cache, &cache->keys_array[entry]);\r\n"
+        "    {% else %}\r\n"
+        "    return {{ function_prefix }}_hash(cache, cache->keys_array[entry]);\r\n"
+        "    {% endif %}\r\n"
+        "}\r\n"
         "\r\n"
-        "    return res;\r\n"
+        "/**\r\n"
+        " * Slots hold 32 bits of the hash in the top half and the entry index plus one\r\n"
+        " * in the bottom half, so zero is empty. The hash bits pick the slot and let\r\n"
+        " * most slots holding a different key be skipped without reading the entry.\r\n"
+        " * Both halves of the hash are folded in, the CRC32C hash only mixes the key's\r\n"
+        " * high bits into its top half.\r\n"
+        " */\r\n"
+        "static inline uint64_t {{ function_prefix }}_tag(\r\n"
+        "    uint64_t hash\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    return (hash ^ (hash >> 32)) & 0xFFFFFFFFu;\r\n"
         "}\r\n"
         "\r\n"
-        "static JSL__FORCE_INLINE void jsl__str_to_str_map_update_value(\r\n"
-        "    JSLStrToStrMap* map,\r\n"
-        "    JSLFatPtr value,\r\n"
-        "    JSLStringLifeTime value_lifetime,\r\n"
-        "    int64_t lut_index\r\n"
+        "static inline uint64_t {{ function_prefix }}_make_slot(\r\n"
+        "    uint64_t tag,\r\n"
+        "    int64_t entry\r\n"
         ")\r\n"
         "{\r\n"
-        "    uintptr_t lut_res = map->entry_lookup_table[lut_index];\r\n"
-        "    struct JSL__StrToStrMapEntry* entry = (struct JSL__StrToStrMapEntry*) lut_res;\r\n"
+        "    return (tag << 32) | (uint64_t) (entry + 1);\r\n"
+        "}\r\n"
         "\r\n"
-        "    if (value_lifetime == JSL_STRING_LIFETIME_LONGER)\r\n"
-        "    {\r\n"
-        "        entry->value = value;\r\n"
-        "    }\r\n"
-        "    else if (\r\n"
-        "        value_lifetime == JSL_STRING_LIFETIME_SHORTER\r\n"
-        "        && value.length <= JSL__MAP_SSO_LENGTH\r\n"
-        "    )\r\n"
-        "    {\r\n"
-        "        JSL_MEMCPY(entry->value_sso_buffer, value.data, (size_t) value.length);\r\n"
-        "        entry->value.data = entry->value_sso_buffer;\r\n"
-        "        entry->value.length = value.length;\r\n"
-        "    }\r\n"
-        "    else if (\r\n"
-        "        value_lifetime == JSL_STRING_LIFETIME_SHORTER\r\n"
-        "        && value.length > JSL__MAP_SSO_LENGTH\r\n"
-        "    )\r\n"
-        "    {\r\n"
-        "        entry->value = jsl_fatptr_duplicate(map->arena, value);\r\n"
-        "    }\r\n"
+        "static inline int64_t {{ function_prefix }}_slot_entry(\r\n"
+        "    uint64_t slot_value\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    return (int64_t) (slot_value & 0xFFFFFFFFu) - 1;\r\n"
         "}\r\n"
         "\r\n"
-        "static JSL__FORCE_INLINE bool jsl__str_to_str_map_add(\r\n"
-        "    JSLStrToStrMap* map,\r\n"
-        "    JSLFatPtr key,\r\n"
-        "    JSLStringLifeTime key_lifetime,\r\n"
-        "    JSLFatPtr value,\r\n"
-        "    JSLStringLifeTime value_lifetime,\r\n"
-        "    int64_t lut_index,\r\n"
-        "    uint64_t hash\r\n"
+        "static inline void {{ function_prefix }}_probe(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key,\r\n"
+        "    {% endif %}\r\n"
+        "    uint64_t hash,\r\n"
+        "    int64_t* out_slot,\r\n"
+        "    int64_t* out_entry,\r\n"
+        "    bool* out_found\r\n"
         ")\r\n"
         "{\r\n"
-        "    struct JSL__StrToStrMapEntry* entry = NULL;\r\n"
-        "    bool replacing_tombstone = map->entry_lookup_table[lut_index] == JSL__MAP_TOMBSTONE;\r\n"
+        "    *out_slot = -1;\r\n"
+        "    *out_entry = -1;\r\n"
+        "    *out_found = false;\r\n"
         "\r\n"
-        "    if (map->entry_free_list == NULL)\r\n"
-        "    {\r\n"
-        "        entry = JSL_ARENA_TYPED_ALLOCATE(struct JSL__StrToStrMapEntry, map->arena);\r\n"
-        "    }\r\n"
-        "    else\r\n"
-        "    {\r\n"
-        "        struct JSL__StrToStrMapEntry* next = map->entry_free_list->next;\r\n"
-        "        entry = map->entry_free_list;\r\n"
-        "        map->entry_free_list = next;\r\n"
-        "    }\r\n"
+        "    uint64_t tag = {{ function_prefix }}_tag(hash);\r\n"
+        "    uint64_t slot_mask = (uint64_t) cache->slots_length - 1u;\r\n"
+        "    int64_t slot = (int64_t) (tag & slot_mask);\r\n"
+        "    int64_t total_checked = 0;\r\n"
         "\r\n"
-        "    if (entry != NULL)\r\n"
+        "    while (total_checked < cache->slots_length)\r\n"
         "    {\r\n"
-        "        entry->hash = hash;\r\n"
-        "        \r\n"
-        "        map->entry_lookup_table[lut_index] = (uintptr_t) entry;\r\n"
-        "        ++map->item_count;\r\n"
-        "    }\r\n"
+        "        uint64_t slot_value = cache->slots_array[slot];\r\n"
         "\r\n"
-        "    if (entry != NULL && replacing_tombstone)\r\n"
-        "    {\r\n"
-        "        --map->tombstone_count;\r\n"
-        "    }\r\n"
+        "        if (slot_value == 0)\r\n"
+        "        {\r\n"
+        "            *out_slot = slot;\r\n"
+        "            break;\r\n"
+        "        }\r\n"
         "\r\n"
-        "    // \r\n"
-        "    // Copy the key\r\n"
-        "    // \r\n"
+        "        int64_t entry = {{ function_prefix }}_slot_entry(slot_value);\r\n"
+        "        if ((slot_value >> 32) == tag && {{ key_compare }})\r\n"
+        "        {\r\n"
+        "            *out_slot = slot;\r\n"
+        "            *out_entry = entry;\r\n"
+        "            *out_found = true;\r\n"
+        "            break;\r\n"
+        "        }\r\n"
         "\r\n"
-        "    if (entry != NULL && key_lifetime == JSL_STRING_LIFETIME_LONGER)\r\n"
-        "    {\r\n"
-        "        entry->key = key;\r\n"
-        "    }\r\n"
-        "    else if (\r\n"
-        "        entry != NULL\r\n"
-        "        && key_lifetime == JSL_STRING_LIFETIME_SHORTER\r\n"
-        "        && key.length <= JSL__MAP_SSO_LENGTH\r\n"
-        "    )\r\n"
-        "    {\r\n"
-        "        JSL_MEMCPY(entry->key_sso_buffer, key.data, (size_t) key.length);\r\n"
-        "        entry->key.data = entry->key_sso_buffer;\r\n"
-        "        entry->key.length = key.length;\r\n"
-        "    }\r\n"
-        "    else if (\r\n"
-        "        entry != NULL\r\n"
-        "        && key_lifetime == JSL_STRING_LIFETIME_SHORTER\r\n"
-        "        && key.length > JSL__MAP_SSO_LENGTH\r\n"
-        "    )\r\n"
-        "    {\r\n"
-        "        entry->key = jsl_fatptr_duplicate(map->arena, key);\r\n"
+        "        slot = (int64_t) (((uint64_t) slot + 1u) & slot_mask);\r\n"
+        "        ++total_checked;\r\n"
         "    }\r\n"
+        "}\r\n"
         "\r\n"
-        "    // \r\n"
-        "    // Copy the value\r\n"
-        "    // \r\n"
+        "/**\r\n"
+        " * Find the slot which points at `entry`, whose key hashes to `hash`.\r\n"
+        " */\r\n"
+        "static inline int64_t {{ function_prefix }}_find_entry_slot(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    uint64_t hash,\r\n"
+        "    int64_t entry\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    uint64_t slot_mask = (uint64_t) cache->slots_length - 1u;\r\n"
+        "    int64_t slot = (int64_t) ({{ function_prefix }}_tag(hash) & slot_mask);\r\n"
         "\r\n"
-        "    if (entry != NULL && value_lifetime == JSL_STRING_LIFETIME_LONGER)\r\n"
-        "    {\r\n"
-        "        entry->value = value;\r\n"
-        "    }\r\n"
-        "    else if (\r\n"
-        "        entry != NULL\r\n"
-        "        && value_lifetime == JSL_STRING_LIFETIME_SHORTER\r\n"
-        "        && value.length <= JSL__MAP_SSO_LENGTH\r\n"
-        "    )\r\n"
-        "    {\r\n"
-        "        JSL_MEMCPY(entry->value_sso_buffer, value.data, (size_t) value.length);\r\n"
-        "        entry->value.data = entry->value_sso_buffer;\r\n"
-        "        entry->value.length = value.length;\r\n"
-        "    }\r\n"
-        "    else if (\r\n"
-        "        entry != NULL\r\n"
-        "        && value_lifetime == JSL_STRING_LIFETIME_SHORTER\r\n"
-        "        && value.length > JSL__MAP_SSO_LENGTH\r\n"
-        "    )\r\n"
+        "    for (int64_t total_checked = 0; total_checked < cache->slots_length; ++total_checked)\r\n"
         "    {\r\n"
-        "        entry->value = jsl_fatptr_duplicate(map->arena, value);\r\n"
+        "        uint64_t slot_value = cache->slots_array[slot];\r\n"
+        "        if (slot_value == 0)\r\n"
+        "            break;\r\n"
+        "        if ({{ function_prefix }}_slot_entry(slot_value) == entry)\r\n"
+        "            return slot;\r\n"
+        "\r\n"
+        "        slot = (int64_t) (((uint64_t) slot + 1u) & slot_mask);\r\n"
         "    }\r\n"
         "\r\n"
-        "    return entry != NULL;\r\n"
+        "    return -1;\r\n"
         "}\r\n"
         "\r\n"
-        "static inline void jsl__str_to_str_map_probe(\r\n"
-        "    JSLStrToStrMap* map,\r\n"
-        "    JSLFatPtr key,\r\n"
-        "    int64_t* out_lut_index,\r\n"
-        "    uint64_t* out_hash,\r\n"
-        "    bool* out_found\r\n"
+        "static inline void {{ function_prefix }}_backshift(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    int64_t start_slot\r\n"
         ")\r\n"
         "{\r\n"
-        "    *out_lut_index = -1;\r\n"
-        "    *out_found = false;\r\n"
-        "\r\n"
-        "    int64_t first_tombstone = -1;\r\n"
-        "    bool tombstone_seen = false;\r\n"
-        "    bool searching = true;\r\n"
+        "    uint64_t slot_mask = (uint64_t) cache->slots_length - 1u;\r\n"
         "\r\n"
-        "    *out_hash = jsl__rapidhash_withSeed(key.data, (size_t) key.length, map->hash_seed);\r\n"
-        "\r\n"
-        "    int64_t lut_length = map->entry_lookup_table_length;\r\n"
-        "    uint64_t lut_mask = (uint64_t) lut_length - 1u;\r\n"
-        "    int64_t lut_index = (int64_t) (*out_hash & lut_mask);\r\n"
-        "    int64_t probes = 0;\r\n"
+        "    int64_t hole = start_slot;\r\n"
+        "    int64_t current = (int64_t) (((uint64_t) start_slot + 1u) & slot_mask);\r\n"
         "\r\n"
-        "    while (searching && probes < lut_length)\r\n"
+        "    int64_t loop_check = 0;\r\n"
+        "    while (loop_check < cache->slots_length)\r\n"
         "    {\r\n"
-        "        uintptr_t lut_res = map->entry_lookup_table[lut_index];\r\n"
+        "        uint64_t slot_value = cache->slots_array[current];\r\n"
         "\r\n"
-        "        bool is_empty = lut_res == JSL__MAP_EMPTY;\r\n"
-        "        bool is_tombstone = lut_res == JSL__MAP_TOMBSTONE;\r\n"
+        "        if (slot_value == 0)\r\n"
+        "            break;\r\n"
         "\r\n"
-        "        if (is_empty)\r\n"
-        "        {\r\n"
-        "            *out_lut_index = tombstone_seen ? first_tombstone : lut_index;\r\n"
-        "            searching = false;\r\n"
-        "        }\r\n"
+        "        int64_t ideal_slot = (int64_t) ((slot_value >> 32) & slot_mask);\r\n"
+        "\r\n"
+        "        bool should_move = (current > hole)\r\n"
+        "            ? (ideal_slot <= hole || ideal_slot > current)\r\n"
+        "            : (ideal_slot <= hole && ideal_slot > current);\r\n"
         "\r\n"
-        "        bool record_tombstone = searching && is_tombstone && !tombstone_seen;\r\n"
-        "        if (record_tombstone)\r\n"
+        "        if (should_move)\r\n"
         "        {\r\n"
-        "            first_tombstone = lut_index;\r\n"
-        "            tombstone_seen = true;\r\n"
+        "            cache->slots_array[hole] = slot_value;\r\n"
+        "            hole = current;\r\n"
         "        }\r\n"
         "\r\n"
-        "        bool slot_has_entry = searching && !is_empty && !is_tombstone;\r\n"
-        "        struct JSL__StrToStrMapEntry* entry = slot_has_entry\r\n"
-        "            ? (struct JSL__StrToStrMapEntry*) lut_res\r\n"
-        "            : NULL;\r\n"
+        "        current = (int64_t) (((uint64_t) current + 1u) & slot_mask);\r\n"
         "\r\n"
-        "        bool matches = entry != NULL\r\n"
-        "            && *out_hash == entry->hash\r\n"
-        "            && jsl_fatptr_memory_compare(key, entry->key);\r\n"
+        "        ++loop_check;\r\n"
+        "    }\r\n"
         "\r\n"
-        "        if (matches)\r\n"
-        "        {\r\n"
-        "            *out_found = true;\r\n"
-        "            *out_lut_index = lut_index;\r\n"
-        "            searching = false;\r\n"
-        "        }\r\n"
+        "    cache->slots_array[hole] = 0;\r\n"
+        "}\r\n"
         "\r\n"
-        "        if (entry == NULL)\r\n"
-        "        {\r\n"
-        "            ++map->tombstone_count;\r\n"
-        "            map->entry_lookup_table[lut_index] = JSL__MAP_TOMBSTONE;\r\n"
-        "        }\r\n"
+        "/**\r\n"
+        " * Take `entry` out of the table and fill its spot with the last entry.\r\n"
+        " */\r\n"
+        "static void {{ function_prefix }}_remove_entry(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    int64_t slot,\r\n"
+        "    int64_t entry\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    {{ function_prefix }}_backshift(cache, slot);\r\n"
         "\r\n"
-        "        if (entry == NULL && !tombstone_seen)\r\n"
-        "        {\r\n"
-        "            first_tombstone = lut_index;\r\n"
-        "            tombstone_seen = true;\r\n"
-        "        }\r\n"
+        "    int64_t last = cache->item_count - 1;\r\n"
+        "    if (entry != last)\r\n"
+        "    {\r\n"
+        "        int64_t last_slot = {{ function_prefix }}_find_entry_slot(\r\n"
+        "            cache,\r\n"
+        "            {{ function_prefix }}_entry_hash(cache, last),\r\n"
+        "            last\r\n"
+        "        );\r\n"
+        "        JSL_ASSERT(last_slot > -1);\r\n"
         "\r\n"
-        "        if (searching)\r\n"
-        "        {\r\n"
-        "            lut_index = (int64_t) (((uint64_t) lut_index + 1u) & lut_mask);\r\n"
-        "            ++probes;\r\n"
-        "        }\r\n"
+        "        cache->keys_array[entry] = cache->keys_array[last];\r\n"
+        "        cache->values_array[entry] = cache->values_array[last];\r\n"
+        "        cache->referenced_array[entry] = cache->referenced_array[last];\r\n"
+        "        cache->slots_array[last_slot] = {{ function_prefix }}_make_slot(cache->slots_array[last_slot] >> 32, entry);\r\n"
         "    }\r\n"
         "\r\n"
-        "    bool exhausted = searching && probes >= lut_length;\r\n"
-        "    if (exhausted)\r\n"
+        "    --cache->item_count;\r\n"
+        "}\r\n"
+        "\r\n"
+        "/**\r\n"
+        " * Move the hand until it reaches an entry which hasn't been used since the\r\n"
+        " * last time the hand passed it. Every entry passed gets its reference\r\n"
+        " * cleared, so this finishes in at most two trips around.\r\n"
+        " */\r\n"
+        "static inline int64_t {{ function_prefix }}_clock_victim(\r\n"
+        "    {{ hash_map_name }}* cache\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    while (true)\r\n"
         "    {\r\n"
-        "        *out_lut_index = tombstone_seen ? first_tombstone : -1;\r\n"
+        "        int64_t entry = cache->clock_hand;\r\n"
+        "\r\n"
+        "        ++cache->clock_hand;\r\n"
+        "        if (cache->clock_hand >= cache->item_count)\r\n"
+        "            cache->clock_hand = 0;\r\n"
+        "\r\n"
+        "        if (cache->referenced_array[entry] == 0)\r\n"
+        "            return entry;\r\n"
+        "\r\n"
+        "        cache->referenced_array[entry] = 0;\r\n"
         "    }\r\n"
         "}\r\n"
         "\r\n"
-        "JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_insert(\r\n"
-        "    JSLStrToStrMap* map,\r\n"
-        "    JSLFatPtr key,\r\n"
-        "    JSLStringLifeTime key_lifetime,\r\n"
-        "    JSLFatPtr value,\r\n"
-        "    JSLStringLifeTime value_lifetime\r\n"
+        "bool {{ function_prefix }}_insert(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key,\r\n"
+        "    {% endif %}\r\n"
+        "    {{ value_type_name }} value\r\n"
         ")\r\n"
         "{\r\n"
-        "    bool res = (\r\n"
-        "        map != NULL\r\n"
-        "        && map->sentinel == JSL__MAP_PRIVATE_SENTINEL\r\n"
-        "        && key.data != NULL \r\n"
-        "        && key.length > -1\r\n"
-        "        && value.data != NULL\r\n"
-        "        && value.length > -1\r\n"
-        "    );\r\n"
+        "    if (\r\n"
+        "        cache == NULL\r\n"
+        "        || cache->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
         "\r\n"
-        "    bool needs_rehash = false;\r\n"
-        "    if (res)\r\n"
-        "    {\r\n"
-        "        float occupied_count = (float) (map->item_count + map->tombstone_count);\r\n"
-        "        float current_load_factor =  occupied_count / (float) map->entry_lookup_table_length;\r\n"
-        "        bool too_many_tombstones = map->tombstone_count > (map->entry_lookup_table_length / 4);\r\n"
-        "        needs_rehash = current_load_factor >= map->load_factor || too_many_tombstones;\r\n"
-        "    }\r\n"
+        "    uint64_t hash = {{ function_prefix }}_hash(cache, key);\r\n"
+        "    int64_t slot = -1;\r\n"
+        "    int64_t entry = -1;\r\n"
+        "    bool existing_found = false;\r\n"
+        "    {{ function_prefix }}_probe(cache, key, hash, &slot, &entry, &existing_found);\r\n"
         "\r\n"
-        "    if (JSL__UNLIKELY(needs_rehash))\r\n"
+        "    if (existing_found)\r\n"
         "    {\r\n"
-        "        res = jsl__str_to_str_map_rehash(map);\r\n"
+        "        cache->values_array[entry] = value;\r\n"
+        "        ++cache->generational_id;\r\n"
+        "        return true;\r\n"
         "    }\r\n"
         "\r\n"
-        "    uint64_t hash = 0;\r\n"
-        "    int64_t lut_index = -1;\r\n"
-        "    bool existing_found = false;\r\n"
-        "    if (res)\r\n"
+        "    if (cache->item_count >= cache->capacity)\r\n"
         "    {\r\n"
-        "        jsl__str_to_str_map_probe(map, key, &lut_index, &hash, &existing_found);\r\n"
-        "    }\r\n"
-        "    \r\n"
-        "    // new key\r\n"
-        "    if (lut_index > -1 && !existing_found)\r\n"
-        "    {\r\n"
-        "        res = jsl__str_to_str_map_add(\r\n"
-        "            map,\r\n"
-        "            key, key_lifetime,\r\n"
-        "            value, value_lifetime,\r\n"
-        "            lut_index,\r\n"
-        "            hash\r\n"
+        "        int64_t victim = {{ function_prefix }}_clock_victim(cache);\r\n"
+        "        int64_t victim_slot = {{ function_prefix }}_find_entry_slot(\r\n"
+        "            cache,\r\n"
+        "            {{ function_prefix }}_entry_hash(cache, victim),\r\n"
+        "            victim\r\n"
         "        );\r\n"
+        "        JSL_ASSERT(victim_slot > -1);\r\n"
+        "\r\n"
+        "        if (cache->evict_function != NULL)\r\n"
+        "        {\r\n"
+        "            {% if key_is_struct %}\r\n"
+        "            cache->evict_function(&cache->keys_array[victim], &cache->values_array[victim], cache->evict_user_data);\r\n"
+        "            {% else %}\r\n"
+        "            cache->evict_function(cache->keys_array[victim], &cache->values_array[victim], cache->evict_user_data);\r\n"
+        "            {% endif %}\r\n"
+        "        }\r\n"
+        "\r\n"
+        "        // Reuse the victim's entry in place so the hand's position still\r\n"
+        "        // means the same thing, only its slot has to go\r\n"
+        "        {{ function_prefix }}_backshift(cache, victim_slot);\r\n"
+        "        ++cache->eviction_count;\r\n"
+        "        entry = victim;\r\n"
+        "\r\n"
+        "        // The backshift can move the empty slot the probe found\r\n"
+        "        int64_t unused_entry = -1;\r\n"
+        "        {{ function_prefix }}_probe(cache, key, hash, &slot, &unused_entry, &existing_found);\r\n"
         "    }\r\n"
-        "    // update\r\n"
-        "    else if (lut_index > -1 && existing_found)\r\n"
+        "    else\r\n"
         "    {\r\n"
-        "        jsl__str_to_str_map_update_value(map, value, value_lifetime, lut_index);\r\n"
+        "        entry = cache->item_count;\r\n"
+        "        ++cache->item_count;\r\n"
         "    }\r\n"
         "\r\n"
-        "    if (res)\r\n"
-        "    {\r\n"
-        "        ++map->generational_id;\r\n"
-        "    }\r\n"
+        "    if (slot < 0)\r\n"
+        "        return false;\r\n"
         "\r\n"
-        "    return res;\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    cache->keys_array[entry] = *key;\r\n"
+        "    {% else %}\r\n"
+        "    cache->keys_array[entry] = key;\r\n"
+        "    {% endif %}\r\n"
+        "    cache->values_array[entry] = value;\r\n"
+        "    cache->referenced_array[entry] = 0;\r\n"
+        "    cache->slots_array[slot] = {{ function_prefix }}_make_slot({{ function_prefix }}_tag(hash), entry);\r\n"
+        "\r\n"
+        "    ++cache->generational_id;\r\n"
+        "    return true;\r\n"
         "}\r\n"
         "\r\n"
-        "JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_has_key(\r\n"
-        "    JSLStrToStrMap* map,\r\n"
-        "    JSLFatPtr key\r\n"
+        "{{ value_type_name }}* {{ function_prefix }}_get(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
         ")\r\n"
         "{\r\n"
-        "    uint64_t hash = 0;\r\n"
-        "    int64_t lut_index = -1;\r\n"
-        "    bool existing_found = false;\r\n"
-        "\r\n"
         "    if (\r\n"
-        "        map != NULL\r\n"
-        "        && map->sentinel == JSL__MAP_PRIVATE_SENTINEL\r\n"
-        "        && key.data != NULL \r\n"
-        "        && key.length > -1\r\n"
+        "        cache == NULL\r\n"
+        "        || cache->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
         "    )\r\n"
+        "        return NULL;\r\n"
+        "\r\n"
+        "    uint64_t hash = {{ function_prefix }}_hash(cache, key);\r\n"
+        "    int64_t slot = -1;\r\n"
+        "    int64_t entry = -1;\r\n"
+        "    bool existing_found = false;\r\n"
+        "    {{ function_prefix }}_probe(cache, key, hash, &slot, &entry, &existing_found);\r\n"
+        "\r\n"
+        "    if (!existing_found)\r\n"
         "    {\r\n"
-        "        jsl__str_to_str_map_probe(map, key, &lut_index, &hash, &existing_found);\r\n"
+        "        ++cache->miss_count;\r\n"
+        "        return NULL;\r\n"
         "    }\r\n"
         "\r\n"
-        "    return lut_index > -1 && existing_found;\r\n"
+        "    // Only store when the byte changes, so hot entries don't dirty their\r\n"
+        "    // cache line on every hit\r\n"
+        "    if (cache->referenced_array[entry] == 0)\r\n"
+        "        cache->referenced_array[entry] = 1;\r\n"
+        "\r\n"
+        "    ++cache->hit_count;\r\n"
+        "    return &cache->values_array[entry];\r\n"
         "}\r\n"
         "\r\n"
-        "JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_get(\r\n"
-        "    JSLStrToStrMap* map,\r\n"
-        "    JSLFatPtr key,\r\n"
-        "    JSLFatPtr* out_value\r\n"
+        "bool {{ function_prefix }}_delete(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}* key\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }} key\r\n"
+        "    {% endif %}\r\n"
         ")\r\n"
         "{\r\n"
-        "    bool res = false;\r\n"
-        "\r\n"
-        "    bool params_valid = (\r\n"
-        "        map != NULL\r\n"
-        "        && map->sentinel == JSL__MAP_PRIVATE_SENTINEL\r\n"
-        "        && map->entry_lookup_table != NULL\r\n"
-        "        && out_value != NULL\r\n"
-        "        && key.data != NULL \r\n"
-        "        && key.length > -1\r\n"
-        "    );\r\n"
+        "    if (\r\n"
+        "        cache == NULL\r\n"
+        "        || cache->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
         "\r\n"
-        "    uint64_t hash = 0;\r\n"
-        "    int64_t lut_index = -1;\r\n"
+        "    uint64_t hash = {{ function_prefix }}_hash(cache, key);\r\n"
+        "    int64_t slot = -1;\r\n"
+        "    int64_t entry = -1;\r\n"
         "    bool existing_found = false;\r\n"
+        "    {{ function_prefix }}_probe(cache, key, hash, &slot, &entry, &existing_found);\r\n"
         "\r\n"
-        "    if (params_valid)\r\n"
-        "    {\r\n"
-        "        jsl__str_to_str_map_probe(map, key, &lut_index, &hash, &existing_found);\r\n"
-        "    }\r\n"
+        "    if (!existing_found)\r\n"
+        "        return false;\r\n"
         "\r\n"
-        "    if (params_valid && existing_found && lut_index > -1)\r\n"
-        "    {\r\n"
-        "        struct JSL__StrToStrMapEntry* entry =\r\n"
-        "            (struct JSL__StrToStrMapEntry*) map->entry_lookup_table[lut_index];\r\n"
-        "        *out_value = entry->value;\r\n"
-        "        res = true;\r\n"
-        "    }\r\n"
-        "    else if (out_value != NULL)\r\n"
-        "    {\r\n"
-        "        *out_value = (JSLFatPtr) {0};\r\n"
-        "    }\r\n"
+        "    {{ function_prefix }}_remove_entry(cache, slot, entry);\r\n"
         "\r\n"
-        "    return res;\r\n"
+        "    if (cache->clock_hand >= cache->item_count)\r\n"
+        "        cache->clock_hand = 0;\r\n"
+        "\r\n"
+        "    ++cache->generational_id;\r\n"
+        "    return true;\r\n"
         "}\r\n"
         "\r\n"
-        "JSL_STR_TO_STR_MAP_DEF int64_t jsl_str_to_str_map_item_count(\r\n"
-        "    JSLStrToStrMap* map\r\n"
+        "void {{ function_prefix }}_clear(\r\n"
+        "    {{ hash_map_name }}* cache\r\n"
         ")\r\n"
         "{\r\n"
-        "    int64_t res = -1;\r\n"
-        "\r\n"
         "    if (\r\n"
-        "        map != NULL\r\n"
-        "        && map->sentinel == JSL__MAP_PRIVATE_SENTINEL\r\n"
+        "        cache == NULL\r\n"
+        "        || cache->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
         "    )\r\n"
-        "    {\r\n"
-        "        res = map->item_count;\r\n"
-        "    }\r\n"
+        "        return;\r\n"
         "\r\n"
-        "    return res;\r\n"
+        "    JSL_MEMSET(cache->slots_array, 0, sizeof(uint64_t) * (size_t) cache->slots_length);\r\n"
+        "    cache->item_count = 0;\r\n"
+        "    cache->clock_hand = 0;\r\n"
+        "    ++cache->generational_id;\r\n"
         "}\r\n"
         "\r\n"
-        "JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_key_value_iterator_init(\r\n"
-        "    JSLStrToStrMap* map,\r\n"
-        "    JSLStrToStrMapKeyValueIter* iterator\r\n"
+        "void {{ function_prefix }}_free(\r\n"
+        "    {{ hash_map_name }}* cache\r\n"
         ")\r\n"
         "{\r\n"
-        "    bool res = false;\r\n"
-        "\r\n"
         "    if (\r\n"
-        "        map != NULL\r\n"
-        "        && map->sentinel == JSL__MAP_PRIVATE_SENTINEL\r\n"
-        "        && iterator != NULL\r\n"
+        "        cache == NULL\r\n"
+        "        || cache->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
         "    )\r\n"
-        "    {\r\n"
-        "        iterator->map = map;\r\n"
-        "        iterator->current_lut_index = 0;\r\n"
-        "        iterator->sentinel = JSL__MAP_PRIVATE_SENTINEL;\r\n"
-        "        iterator->generational_id = map->generational_id;\r\n"
-        "        res = true;\r\n"
-        "    }\r\n"
+        "        return;\r\n"
         "\r\n"
-        "    return res;\r\n"
+        "    {{ function_prefix }}_release(cache);\r\n"
+        "    cache->sentinel = 0;\r\n"
         "}\r\n"
         "\r\n"
-        "JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_key_value_iterator_next(\r\n"
-        "    JSLStrToStrMapKeyValueIter* iterator,\r\n"
-        "    JSLFatPtr* out_key,\r\n"
-        "    JSLFatPtr* out_value\r\n"
+        "int64_t {{ function_prefix }}_memory_footprint(\r\n"
+        "    {{ hash_map_name }}* cache\r\n"
         ")\r\n"
         "{\r\n"
-        "    bool found = false;\r\n"
-        "\r\n"
-        "    bool params_valid = (\r\n"
-        "        iterator != NULL\r\n"
-        "        && out_key != NULL\r\n"
-        "        && out_value != NULL\r\n"
-        "        && iterator->sentinel == JSL__MAP_PRIVATE_SENTINEL\r\n"
-        "        && iterator->map != NULL\r\n"
-        "        && iterator->map->sentinel == JSL__MAP_PRIVATE_SENTINEL\r\n"
-        "        && iterator->map->entry_lookup_table != NULL\r\n"
-        "        && iterator->generational_id == iterator->map->generational_id\r\n"
-        "    );\r\n"
-        "\r\n"
-        "    int64_t lut_length = params_valid ? iterator->map->entry_lookup_table_length : 0;\r\n"
-        "    int64_t lut_index = iterator->current_lut_index;\r\n"
-        "    struct JSL__StrToStrMapEntry* found_entry = NULL;\r\n"
-        "\r\n"
-        "    while (params_valid && lut_index < lut_length)\r\n"
-        "    {\r\n"
-        "        uintptr_t lut_res = iterator->map->entry_lookup_table[lut_index];\r\n"
-        "        bool occupied = lut_res != JSL__MAP_EMPTY && lut_res != JSL__MAP_TOMBSTONE;\r\n"
-        "\r\n"
-        "        if (occupied)\r\n"
-        "        {\r\n"
-        "            found_entry = (struct JSL__StrToStrMapEntry*) lut_res;\r\n"
-        "            break;\r\n"
-        "        }\r\n"
-        "        else\r\n"
-        "        {\r\n"
-        "            ++lut_index;\r\n"
-        "        }\r\n"
-        "    }\r\n"
-        "\r\n"
-        "    if (found_entry != NULL)\r\n"
-        "    {\r\n"
-        "        iterator->current_lut_index = lut_index + 1;\r\n"
-        "        *out_key = found_entry->key;\r\n"
-        "        *out_value = found_entry->value;\r\n"
-        "        found = true;\r\n"
-        "    }\r\n"
-        "\r\n"
-        "    bool exhausted = params_valid && found_entry == NULL;\r\n"
-        "    if (exhausted)\r\n"
-        "    {\r\n"
-        "        iterator->current_lut_index = lut_length;\r\n"
-        "        found = false;\r\n"
-        "    }\r\n"
+        "    if (\r\n"
+        "        cache == NULL\r\n"
+        "        || cache->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return -1;\r\n"
         "\r\n"
-        "    return found;\r\n"
+        "    return {{ function_prefix }}_bytes_for(cache->capacity, cache->slots_length);\r\n"
         "}\r\n"
         "\r\n"
-        "JSL_STR_TO_STR_MAP_DEF bool jsl_str_to_str_map_delete(\r\n"
-        "    JSLStrToStrMap* map,\r\n"
-        "    JSLFatPtr key\r\n"
+        "int64_t {{ function_prefix }}_memory_footprint_for(\r\n"
+        "    int64_t capacity\r\n"
         ")\r\n"
         "{\r\n"
-        "    bool res = false;\r\n"
-        "\r\n"
-        "    bool params_valid = (\r\n"
-        "        map != NULL\r\n"
-        "        && map->sentinel == JSL__MAP_PRIVATE_SENTINEL\r\n"
-        "        && map->entry_lookup_table != NULL\r\n"
-        "        && key.data != NULL\r\n"
-        "        && key.length > -1\r\n"
-        "    );\r\n"
-        "\r\n"
-        "    uint64_t hash = 0;\r\n"
-        "    int64_t lut_index = -1;\r\n"
-        "    bool existing_found = false;\r\n"
-        "    if (params_valid)\r\n"
-        "    {\r\n"
-        "        jsl__str_to_str_map_probe(map, key, &lut_index, &hash, &existing_found);\r\n"
-        "    }\r\n"
-        "\r\n"
-        "    if (existing_found && lut_index > -1)\r\n"
-        "    {\r\n"
-        "        struct JSL__StrToStrMapEntry* entry =\r\n"
-        "            (struct JSL__StrToStrMapEntry*) map->entry_lookup_table[lut_index];\r\n"
-        "\r\n"
-        "        entry->next = map->entry_free_list;\r\n"
-        "        map->entry_free_list = entry;\r\n"
-        "\r\n"
-        "        --map->item_count;\r\n"
-        "        ++map->generational_id;\r\n"
-        "\r\n"
-        "        map->entry_lookup_table[lut_index] = JSL__MAP_TOMBSTONE;\r\n"
-        "        ++map->tombstone_count;\r\n"
+        "    if (capacity < 1 || capacity > INT32_MAX)\r\n"
+        "        return -1;\r\n"
         "\r\n"
-        "        res = true;\r\n"
-        "    }\r\n"
-        "\r\n"
-        "    return res;\r\n"
+        "    return {{ function_prefix }}_bytes_for(capacity, {{ function_prefix }}_slots_length_for(capacity));\r\n"
         "}\r\n"
         "\r\n"
-        "JSL_STR_TO_STR_MAP_DEF void jsl_str_to_str_map_clear(\r\n"
-        "    JSLStrToStrMap* map\r\n"
+        "bool {{ function_prefix }}_iterator_start(\r\n"
+        "    {{ hash_map_name }}* cache,\r\n"
+        "    {{ hash_map_name }}Iterator* iterator\r\n"
         ")\r\n"
         "{\r\n"
-        "    bool params_valid = (\r\n"
-        "        map != NULL\r\n"
-        "        && map->sentinel == JSL__MAP_PRIVATE_SENTINEL\r\n"
-        "        && map->entry_lookup_table != NULL\r\n"
-        "    );\r\n"
+        "    if (\r\n"
+        "        cache == NULL\r\n"
+        "        || iterator == NULL\r\n"
+        "        || cache->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
         "\r\n"
-        "    int64_t lut_length = params_valid ? map->entry_lookup_table_length : 0;\r\n"
-        "    int64_t index = 0;\r\n"
+        "    iterator->cache = cache;\r\n"
+        "    iterator->current_entry = 0;\r\n"
+        "    iterator->generational_id = cache->generational_id;\r\n"
         "\r\n"
-        "    while (params_valid && index < lut_length)\r\n"
-        "    {\r\n"
-        "        uintptr_t lut_res = map->entry_lookup_table[index];\r\n"
+        "    return true;\r\n"
+        "}\r\n"
         "\r\n"
-        "        if (lut_res != JSL__MAP_EMPTY && lut_res != JSL__MAP_TOMBSTONE)\r\n"
-        "        {\r\n"
-        "            struct JSL__StrToStrMapEntry* entry = (struct JSL__StrToStrMapEntry*) lut_res;\r\n"
-        "            entry->next = map->entry_free_list;\r\n"
-        "            map->entry_free_list = entry;\r\n"
-        "            map->entry_lookup_table[index] = JSL__MAP_EMPTY;\r\n"
-        "        }\r\n"
-        "        else if (lut_res == JSL__MAP_TOMBSTONE)\r\n"
-        "        {\r\n"
-        "            map->entry_lookup_table[index] = JSL__MAP_EMPTY;\r\n"
-        "        }\r\n"
+        "bool {{ function_prefix }}_iterator_next(\r\n"
+        "    {{ hash_map_name }}Iterator* iterator,\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    const {{ key_type_name }}** out_key,\r\n"
+        "    {% else %}\r\n"
+        "    {{ key_type_name }}* out_key,\r\n"
+        "    {% endif %}\r\n"
+        "    {{ value_type_name }}* out_value\r\n"
+        ")\r\n"
+        "{\r\n"
+        "    if (\r\n"
+        "        iterator == NULL\r\n"
+        "        || iterator->cache == NULL\r\n"
+        "        || iterator->cache->sentinel != PRIVATE_SENTINEL_{{ hash_map_name }}\r\n"
+        "        || iterator->cache->generational_id != iterator->generational_id\r\n"
+        "        || iterator->current_entry >= iterator->cache->item_count\r\n"
+        "    )\r\n"
+        "        return false;\r\n"
         "\r\n"
-        "        ++index;\r\n"
-        "    }\r\n"
+        "    int64_t entry = iterator->current_entry;\r\n"
+        "    ++iterator->current_entry;\r\n"
         "\r\n"
-        "    if (params_valid)\r\n"
-        "    {\r\n"
-        "        map->item_count = 0;\r\n"
-        "        map->tombstone_count = 0;\r\n"
-        "        ++map->generational_id;\r\n"
-        "    }\r\n"
+        "    {% if key_is_struct %}\r\n"
+        "    *out_key = &iterator->cache->keys_array[entry];\r\n"
+        "    {% else %}\r\n"
+        "    *out_key = iterator->cache->keys_array[entry];\r\n"
+        "    {% endif %}\r\n"
+        "    *out_value = iterator->cache->values_array[entry];\r\n"
         "\r\n"
-        "    return;\r\n"
+        "    return true;\r\n"
         "}\r\n"
         "\r\n"
-        "#undef JSL__MAP_SSO_LENGTH\r\n"
-        "#undef JSL__MAP_PRIVATE_SENTINEL\r\n"
     );
 
     static JSLImmutableMemory hash_map_name_key = JSL_CSTR_INITIALIZER("hash_map_name");
@@ -2086,6 +5272,9 @@
     static JSLImmutableMemory function_prefix_key = JSL_CSTR_INITIALIZER("function_prefix");
     static JSLImmutableMemory hash_function_key = JSL_CSTR_INITIALIZER("hash_function");
     static JSLImmutableMemory key_compare_key = JSL_CSTR_INITIALIZER("key_compare");
+    static JSLImmutableMemory robin_hood_key = JSL_CSTR_INITIALIZER("robin_hood");
+    static JSLImmutableMemory control_bytes_key = JSL_CSTR_INITIALIZER("control_bytes");
+    static JSLImmutableMemory is_set_key = JSL_CSTR_INITIALIZER("is_set");
 
     static JSLImmutableMemory int32_t_str = JSL_CSTR_INITIALIZER("int32_t");
     static JSLImmutableMemory int_str = JSL_CSTR_INITIALIZER("int");
@@ -2485,6 +5674,7 @@
         bool key_is_str,
         JSLImmutableMemory value_type_name,
         bool value_is_str,
+        bool control_bytes,
         JSLImmutableMemory* include_header_array,
         int32_t include_header_count
     )
@@ -2493,9 +5683,12 @@
         assert(function_prefix.data != NULL && function_prefix.length > 0);
         assert(!(include_header_array != NULL && include_header_count < 1));
         assert(!(key_type_name.data == NULL && !key_is_str));
-        assert(!(value_type_name.data == NULL && !value_is_str));
         assert(!(key_is_str && value_is_str));
 
+        // No value type means a set
+        bool is_set = value_type_name.data == NULL && !value_is_str;
+        assert(!(is_set && (impl == IMPL_CONCURRENT || impl == IMPL_CACHE)));
+
         srand((uint32_t) (time(NULL) % UINT32_MAX));
 
         jsl_output_sink_write(
@@ -2507,6 +5700,9 @@
         jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#include <stdint.h>\n"));
         jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#include \"jsl/allocator.h\"\n"));
         jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#include \"jsl/hash_map_common.h\"\n"));
+        // The shard struct is padded to JSL__CACHE_LINE_SIZE
+        if (impl == IMPL_CONCURRENT)
+            jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#include \"jsl/atomic_common.h\"\n"));
         jsl_output_sink_write_u8(
             sink,
             '\n'
@@ -2588,7 +5784,15 @@
                 JSL_STRING_LIFETIME_LONGER
             );
 
-        if (value_is_str)
+        if (is_set)
+            jsl_str_to_str_map_insert(
+                &map,
+                is_set_key,
+                JSL_STRING_LIFETIME_LONGER,
+                JSL_CSTR_EXPRESSION(""),
+                JSL_STRING_LIFETIME_LONGER
+            );
+        else if (value_is_str)
             jsl_str_to_str_map_insert(
                 &map,
                 value_is_str_key,
@@ -2613,10 +5817,23 @@
             JSL_STRING_LIFETIME_LONGER
         );
 
+        if (control_bytes)
+            jsl_str_to_str_map_insert(
+                &map,
+                control_bytes_key,
+                JSL_STRING_LIFETIME_LONGER,
+                JSL_CSTR_EXPRESSION(""),
+                JSL_STRING_LIFETIME_LONGER
+            );
+
         if (impl == IMPL_FIXED)
             render_template(sink, fixed_header_template, &map);
         else if (impl == IMPL_DYNAMIC)
             render_template(sink, dynamic_header_template, &map);
+        else if (impl == IMPL_CONCURRENT)
+            render_template(sink, concurrent_header_template, &map);
+        else if (impl == IMPL_CACHE)
+            render_template(sink, cache_header_template, &map);
         else
             assert(0);
     }
@@ -2631,13 +5848,23 @@
         bool key_is_str,
         JSLImmutableMemory value_type_name,
         bool value_is_str,
+        HashMapHashFunction hash_function,
+        bool robin_hood,
+        bool control_bytes,
         JSLImmutableMemory hash_function_name,
         JSLImmutableMemory compare_function_name,
         JSLImmutableMemory* include_header_array,
         int32_t include_header_count
     )
     {
-        (void) impl;
+        assert(impl == IMPL_FIXED || impl == IMPL_DYNAMIC || impl == IMPL_CONCURRENT || impl == IMPL_CACHE);
+        assert(!(robin_hood && control_bytes));
+        assert(!(impl != IMPL_FIXED && (robin_hood || control_bytes)));
+        assert(!((impl == IMPL_CONCURRENT || impl == IMPL_CACHE) && (key_is_str || value_is_str)));
+
+        // No value type means a set
+        bool is_set = value_type_name.data == NULL && !value_is_str;
+        assert(!(is_set && (impl == IMPL_CONCURRENT || impl == IMPL_CACHE)));
 
         bool key_is_struct = !key_is_str
             && key_type_name.data != NULL
@@ -2677,8 +5904,11 @@
         jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#include \"jsl/allocator.h\"\n"));
         jsl_output_sink_write(
             sink,
-            JSL_CSTR_EXPRESSION("#include \"jsl/hash_map_common.h\"\n\n")
+            JSL_CSTR_EXPRESSION("#include \"jsl/hash_map_common.h\"\n")
         );
+        if (impl == IMPL_CONCURRENT)
+            jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("#include \"jsl/atomic_common.h\"\n"));
+        jsl_output_sink_write(sink, JSL_CSTR_EXPRESSION("\n"));
 
         jsl_output_sink_write(
             sink,
@@ -2730,7 +5960,15 @@
                 JSL_STRING_LIFETIME_LONGER
             );
 
-        if (value_is_str)
+        if (is_set)
+            jsl_str_to_str_map_insert(
+                &map,
+                is_set_key,
+                JSL_STRING_LIFETIME_LONGER,
+                JSL_CSTR_EXPRESSION(""),
+                JSL_STRING_LIFETIME_LONGER
+            );
+        else if (value_is_str)
             jsl_str_to_str_map_insert(
                 &map,
                 value_is_str_key,
@@ -2755,26 +5993,66 @@
             JSL_STRING_LIFETIME_LONGER
         );
 
+        if (robin_hood)
+            jsl_str_to_str_map_insert(
+                &map,
+                robin_hood_key,
+                JSL_STRING_LIFETIME_LONGER,
+                JSL_CSTR_EXPRESSION(""),
+                JSL_STRING_LIFETIME_LONGER
+            );
+
+        if (control_bytes)
+            jsl_str_to_str_map_insert(
+                &map,
+                control_bytes_key,
+                JSL_STRING_LIFETIME_LONGER,
+                JSL_CSTR_EXPRESSION(""),
+                JSL_STRING_LIFETIME_LONGER
+            );
+
+        // The cache's functions take a `cache` instead of a `hash_map`
+        JSLImmutableMemory container = impl == IMPL_CACHE
+            ? JSL_CSTR_EXPRESSION("cache")
+            : JSL_CSTR_EXPRESSION("hash_map");
+
         // hash and find slot
         {
-            uint8_t hash_function_call_buffer[JSL_KILOBYTES(4)];
-            JSLArena hash_function_scratch_arena = JSL_ARENA_FROM_STACK(hash_function_call_buffer);
-            JSLAllocatorInterface scratch_interface;
-            jsl_arena_get_allocator_interface(&scratch_interface, &hash_function_scratch_arena);
+            JSLImmutableMemory bytes_hash_name = JSL_CSTR_EXPRESSION("jsl__rapidhash_withSeed");
+            JSLImmutableMemory u64_hash_name = JSL_CSTR_EXPRESSION("jsl__murmur3_fmix_u64");
+
+            if (hash_function == HASH_FUNCTION_CRC32C)
+            {
+                bytes_hash_name = JSL_CSTR_EXPRESSION("jsl__crc32c_bytes");
+                u64_hash_name = JSL_CSTR_EXPRESSION("jsl__crc32c_u64");
+            }
+            else if (hash_function == HASH_FUNCTION_AES)
+            {
+                bytes_hash_name = JSL_CSTR_EXPRESSION("jsl__aes_bytes");
+                u64_hash_name = JSL_CSTR_EXPRESSION("jsl__aes_u64");
+            }
 
+            // Formatted with the caller's allocator as the map holds onto
+            // the result until the template is rendered
             JSLImmutableMemory resolved_hash_function_call;
             if (key_is_struct && hash_function_name.data != NULL && hash_function_name.length > 0)
             {
                 // Struct keys: custom hash signature is (const TYPE* key, uint64_t seed)
                 resolved_hash_function_call = jsl_format(
-                    scratch_interface,
-                    JSL_CSTR_EXPRESSION("*out_hash = %y(key, hash_map->seed)"),
-                    hash_function_name
+                    allocator,
+                    JSL_CSTR_EXPRESSION("*out_hash = %y(key, %y->seed)"),
+                    hash_function_name,
+                    container
                 );
             }
             else if (key_is_str)
             {
-                resolved_hash_function_call = JSL_CSTR_EXPRESSION("*out_hash = jsl__rapidhash_withSeed(key.data, (size_t) key.length, hash_map->seed)");
+                resolved_hash_function_call = jsl_format(
+                    allocator,
+                    JSL_CSTR_EXPRESSION("*out_hash = %y(key.data, (size_t) key.length, %y->seed)"),
+                    bytes_hash_name,
+                    container
+                );
             }
             else if (!key_is_struct
                 && key_type_name.data != NULL
@@ -2796,18 +6074,21 @@
             )
             {
                 resolved_hash_function_call = jsl_format(
-                    scratch_interface,
-                    JSL_CSTR_EXPRESSION("*out_hash = jsl__murmur3_fmix_u64((uint64_t) key, hash_map->seed)"),
-                    key_type_name
+                    allocator,
+                    JSL_CSTR_EXPRESSION("*out_hash = %y((uint64_t) key, %y->seed)"),
+                    u64_hash_name,
+                    container
                 );
             }
             else
             {
                 // Struct key (no custom hash): key is already const TYPE*, no & needed
                 resolved_hash_function_call = jsl_format(
-                    scratch_interface,
-                    JSL_CSTR_EXPRESSION("*out_hash = jsl__rapidhash_withSeed(key, sizeof(%y), hash_map->seed)"),
-                    key_type_name
+                    allocator,
+                    JSL_CSTR_EXPRESSION("*out_hash = %y(key, sizeof(%y), %y->seed)"),
+                    bytes_hash_name,
+                    key_type_name,
+                    container
                 );
             }
 
@@ -2822,12 +6103,20 @@
 
         // key comparison
         {
-            uint8_t resolved_key_buffer[JSL_KILOBYTES(4)];
-            JSLArena scratch_arena = JSL_ARENA_FROM_STACK(resolved_key_buffer);
-            JSLAllocatorInterface scratch_interface;
-            jsl_arena_get_allocator_interface(&scratch_interface, &scratch_arena);
-
             JSLImmutableMemory resolved_key_compare;
+            // The dynamic and concurrent maps probe one of their tables rather
+            // than the map itself, and the cache's slots point at entries
+            JSLImmutableMemory keys_array = JSL_CSTR_EXPRESSION("hash_map->keys_array");
+            JSLImmutableMemory key_index = JSL_CSTR_EXPRESSION("slot");
+            if (impl == IMPL_DYNAMIC)
+                keys_array = JSL_CSTR_EXPRESSION("table->keys_array");
+            else if (impl == IMPL_CONCURRENT)
+                keys_array = JSL_CSTR_EXPRESSION("shard->keys_array");
+            else if (impl == IMPL_CACHE)
+            {
+                keys_array = JSL_CSTR_EXPRESSION("cache->keys_array");
+                key_index = JSL_CSTR_EXPRESSION("entry");
+            }
 
             if (
                 !key_is_struct
@@ -2852,30 +6141,40 @@
             )
             {
                 resolved_key_compare = jsl_format(
-                    scratch_interface,
-                    JSL_CSTR_EXPRESSION("key == hash_map->keys_array[slot]"),
-                    key_type_name
+                    allocator,
+                    JSL_CSTR_EXPRESSION("key == %y[%y]"),
+                    keys_array,
+                    key_index
                 );
             }
             else if (key_is_str)
             {
-                resolved_key_compare = JSL_CSTR_EXPRESSION("jsl_memory_compare(key, hash_map->keys_array[slot])");
+                resolved_key_compare = jsl_format(
+                    allocator,
+                    JSL_CSTR_EXPRESSION("jsl_memory_compare(key, %y[%y])"),
+                    keys_array,
+                    key_index
+                );
             }
             else if (key_is_struct && compare_function_name.data != NULL && compare_function_name.length > 0)
             {
                 // Struct key with custom compare: fn(const TYPE* a, const TYPE* b) -> bool
                 resolved_key_compare = jsl_format(
-                    scratch_interface,
-                    JSL_CSTR_EXPRESSION("%y(key, &hash_map->keys_array[slot])"),
-                    compare_function_name
+                    allocator,
+                    JSL_CSTR_EXPRESSION("%y(key, &%y[%y])"),
+                    compare_function_name,
+                    keys_array,
+                    key_index
                 );
             }
             else
             {
                 // Struct key (no custom compare): key is already const TYPE*, no & needed
                 resolved_key_compare = jsl_format(
-                    scratch_interface,
-                    JSL_CSTR_EXPRESSION("JSL_MEMCMP(key, &hash_map->keys_array[slot], sizeof(%y)) == 0"),
+                    allocator,
+                    JSL_CSTR_EXPRESSION("JSL_MEMCMP(key, &%y[%y], sizeof(%y)) == 0"),
+                    keys_array,
+                    key_index,
                     key_type_name
                 );
             }
@@ -2889,7 +6188,14 @@
             );
         }
 
-        render_template(sink, fixed_source_template, &map);
+        if (impl == IMPL_FIXED)
+            render_template(sink, fixed_source_template, &map);
+        else if (impl == IMPL_DYNAMIC)
+            render_template(sink, dynamic_source_template, &map);
+        else if (impl == IMPL_CONCURRENT)
+            render_template(sink, concurrent_source_template, &map);
+        else
+            render_template(sink, cache_source_template, &map);
     }
 
 #endif /* GENERATE_HASH_MAP_IMPLEMENTATION */
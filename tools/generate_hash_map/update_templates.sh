@@ -64,3 +64,7 @@ replace_var_block fixed_header_template  fixed_hash_map_header.txt
 replace_var_block fixed_source_template  fixed_hash_map_source.txt
 replace_var_block dynamic_header_template dynamic_hash_map_header.txt
 replace_var_block dynamic_source_template dynamic_hash_map_source.txt
+replace_var_block concurrent_header_template concurrent_hash_map_header.txt
+replace_var_block concurrent_source_template concurrent_hash_map_source.txt
+replace_var_block cache_header_template cache_hash_map_header.txt
+replace_var_block cache_source_template cache_hash_map_source.txt